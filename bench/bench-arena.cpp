@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstdio>
+#include <cutil/arena.h>
+#include <cutil/hash.h>
+#include <cutil/memory.h>
+#include <cutil/vector.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// The shape of a request: short-lived containers, each holding a few values.
+static const size_t VECTORS = 24;
+static const size_t VECTOR_VALUES = 50;
+static const size_t HASHES = 8;
+static const size_t HASH_VALUES = 30;
+
+// The requests that are timed.
+static const size_t REQUESTS = 100000;
+
+// Spread the keys as a hash function would.
+static inline size_t key(size_t i) {
+  return i * 0x9E3779B97F4A7C15ull;
+}
+
+// Serve one request, with its containers in `arena` (or on the heap).
+static uint64_t serve(GCU_Arena * arena) {
+  GCU_Vector64 * vectors[VECTORS];
+  GCU_Hash64 * hashes[HASHES];
+  for (size_t i = 0; i < VECTORS; ++i) {
+    vectors[i] = arena
+      ? gcu_vector64_create_in_arena(arena, 0)
+      : gcu_vector64_create(0);
+    for (size_t j = 0; j < VECTOR_VALUES; ++j) {
+      gcu_vector64_append(vectors[i], gcu_type64_ui64(i + j));
+    }
+  }
+  for (size_t i = 0; i < HASHES; ++i) {
+    hashes[i] = arena
+      ? gcu_hash64_create_in_arena(arena, 0)
+      : gcu_hash64_create(0);
+    for (size_t j = 0; j < HASH_VALUES; ++j) {
+      gcu_hash64_set(hashes[i], key(j), gcu_type64_ui64(i + j));
+    }
+  }
+
+  uint64_t total = 0;
+  for (size_t i = 0; i < VECTORS; ++i) {
+    total += vectors[i]->data[VECTOR_VALUES - 1].ui64;
+    gcu_vector64_destroy(vectors[i]);
+  }
+  for (size_t i = 0; i < HASHES; ++i) {
+    total += gcu_hash64_count(hashes[i]);
+    gcu_hash64_destroy(hashes[i]);
+  }
+  if (arena) {
+    gcu_arena_reset(arena);
+  }
+  return total;
+}
+
+static void run(const char * name, GCU_Arena * arena) {
+  // Warm up, so that the arena has grown to the size of a request.
+  volatile uint64_t sink = serve(arena);
+
+  gcu_memory_reset_counts();
+  auto start = steady_clock::now();
+  for (size_t i = 0; i < REQUESTS; ++i) {
+    sink = serve(arena);
+  }
+  double seconds = duration<double>(steady_clock::now() - start).count();
+  (void)sink;
+  printf("  %-8s %8.2f us/request   %7.1f allocations/request   %7.1f frees/request\n",
+    name,
+    seconds * 1e6 / REQUESTS,
+    (double)gcu_get_alloc_count() / REQUESTS,
+    (double)gcu_get_free_count() / REQUESTS);
+}
+
+int main() {
+  printf("  %zu vectors of %zu values and %zu hash tables of %zu values per request\n", VECTORS, VECTOR_VALUES, HASHES, HASH_VALUES);
+  run("heap", nullptr);
+  GCU_Arena * arena = gcu_arena_create(0);
+  run("arena", arena);
+  printf("  arena size: %zu bytes\n", gcu_arena_size(arena));
+  gcu_arena_destroy(arena);
+  return 0;
+}
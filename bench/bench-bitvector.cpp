@@ -0,0 +1,96 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <cutil/bitvector.h>
+#include <cutil/vector.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// One flag per user.
+static const size_t COUNT = 50000000;
+static const int REPEAT = 5;
+
+// Time `func`, repeated to smooth out noise, in milliseconds per call.
+template <typename F>
+static double time(F func) {
+  auto start = steady_clock::now();
+  for (int i = 0; i < REPEAT; ++i) {
+    func();
+  }
+  return duration<double, milli>(steady_clock::now() - start).count() / REPEAT;
+}
+
+static void compare(const char * name, double bytes, double bits) {
+  printf("  %-24s vector8 %8.2f ms   bitvector %8.2f ms   %5.1fx\n", name, bytes, bits, bytes / bits);
+}
+
+int main() {
+  mt19937_64 rng{42};
+  GCU_Vector8 * bytesA = gcu_vector8_create(COUNT);
+  GCU_Vector8 * bytesB = gcu_vector8_create(COUNT);
+  GCU_BitVector * bitsA = gcu_bitvector_create(COUNT);
+  GCU_BitVector * bitsB = gcu_bitvector_create(COUNT);
+  for (size_t i = 0; i < COUNT; ++i) {
+    // Half of the users have feature A, and 1% have feature B.
+    bool a = rng() % 2;
+    bool b = rng() % 100 == 0;
+    gcu_vector8_append(bytesA, gcu_type8_b(a));
+    gcu_vector8_append(bytesB, gcu_type8_b(b));
+    gcu_bitvector_append(bitsA, a);
+    gcu_bitvector_append(bitsB, b);
+  }
+  volatile size_t sink;
+
+  printf("  n=%zu\n", COUNT);
+  printf("  %-24s vector8 %8.1f MB   bitvector %8.1f MB\n", "memory",
+    bytesA->capacity * sizeof(GCU_Type8_Union) / 1e6, bitsA->capacity / 8 / 1e6);
+
+  compare("popcount", time([&] {
+    size_t count = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      count += bytesA->data[i].b;
+    }
+    sink = count;
+  }), time([&] { sink = gcu_bitvector_popcount(bitsA); }));
+
+  // A filter: users with both features.
+  GCU_Vector8 * bytesC = gcu_vector8_create(COUNT);
+  bytesC->count = COUNT;
+  GCU_BitVector * bitsC = gcu_bitvector_create(COUNT);
+  compare("and", time([&] {
+    for (size_t i = 0; i < COUNT; ++i) {
+      bytesC->data[i].b = bytesA->data[i].b & bytesB->data[i].b;
+    }
+  }), time([&] {
+    gcu_bitvector_resize(bitsC, 0);
+    gcu_bitvector_resize(bitsC, COUNT);
+    gcu_bitvector_or(bitsC, bitsA);
+    gcu_bitvector_and(bitsC, bitsB);
+  }));
+
+  compare("iterate 1% set", time([&] {
+    size_t sum = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      if (bytesB->data[i].b) {
+        sum += i;
+      }
+    }
+    sink = sum;
+  }), time([&] {
+    size_t sum = 0;
+    for (size_t i = gcu_bitvector_find_next_set(bitsB, 0); i < COUNT; i = gcu_bitvector_find_next_set(bitsB, i + 1)) {
+      sum += i;
+    }
+    sink = sum;
+  }));
+
+  gcu_vector8_destroy(bytesA);
+  gcu_vector8_destroy(bytesB);
+  gcu_vector8_destroy(bytesC);
+  gcu_bitvector_destroy(bitsA);
+  gcu_bitvector_destroy(bitsB);
+  gcu_bitvector_destroy(bitsC);
+  (void)sink;
+  return 0;
+}
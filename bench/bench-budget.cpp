@@ -0,0 +1,62 @@
+#include <chrono>
+#include <cstdio>
+#include <cutil/budget.h>
+#include <cutil/hash.h>
+#include <cutil/memory.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// The blocks allocated and freed by each run.
+static const size_t COUNT = 1000000;
+
+// The entries set in each hash table.
+static const size_t ENTRIES = 1000;
+
+// Allocate and free a block at a time, as a container which grows and
+// shrinks does.
+static void runBlocks(const char * name, const GCU_Allocator * allocator) {
+  auto start = steady_clock::now();
+  for (size_t i = 0; i < COUNT; ++i) {
+    auto block = (volatile char *)gcu_allocator_allocate(allocator, 64 + (i & 1023));
+    block[0] = (char)i;
+    gcu_allocator_free(allocator, (void *)block);
+  }
+  double seconds = duration<double>(steady_clock::now() - start).count();
+  printf("  %-24s %7.1f ns/block\n", name, seconds * 1e9 / COUNT);
+}
+
+// Fill hash tables which grow under a growth policy.
+static void runHash(const char * name, GCU_Growth growth) {
+  auto start = steady_clock::now();
+  for (size_t round = 0; round < 100; ++round) {
+    auto table = gcu_hash64_create(0);
+    gcu_hash64_set_growth(table, growth);
+    for (size_t i = 0; i < ENTRIES; ++i) {
+      gcu_hash64_set(table, i * 2654435761u, gcu_type64_ui64(i));
+    }
+    gcu_hash64_destroy(table);
+  }
+  double seconds = duration<double>(steady_clock::now() - start).count();
+  printf("  %-24s %7.1f ns/entry\n", name, seconds * 1e9 / (100 * ENTRIES));
+}
+
+int main() {
+  auto budget = gcu_budget_create(nullptr, (size_t)1 << 30, (size_t)1 << 29);
+  auto group = gcu_budget_create(gcu_budget_allocator(budget), (size_t)1 << 30, 0);
+
+  printf("  %zu blocks of 64 to 1087 bytes\n", COUNT);
+  runBlocks("system", nullptr);
+  runBlocks("budget", gcu_budget_allocator(budget));
+  runBlocks("group within budget", gcu_budget_allocator(group));
+
+  printf("  hash tables of %zu entries\n", ENTRIES);
+  runHash("system", {0, 0, 0, 0, nullptr, 0, nullptr});
+  runHash("budget", {0, 0, 0, 0, nullptr, 0, gcu_budget_allocator(budget)});
+  runHash("group within budget", {0, 0, 0, 0, nullptr, 0, gcu_budget_allocator(group)});
+  printf("  budget peak: %zu bytes\n", gcu_budget_peak(budget));
+
+  gcu_budget_destroy(group);
+  gcu_budget_destroy(budget);
+  return 0;
+}
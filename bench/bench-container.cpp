@@ -0,0 +1,68 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include <cutil/hash.h>
+#include <cutil/vector.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// Number of containers created and destroyed per measurement.
+static const size_t ITERATIONS = 1000000;
+
+// Run `func` ITERATIONS times and report the throughput.
+template <typename F>
+static void measure(const char * name, F func) {
+  auto start = steady_clock::now();
+  for (size_t i = 0; i < ITERATIONS; ++i) {
+    func();
+  }
+  double seconds = duration<double>(steady_clock::now() - start).count();
+  printf("  %-32s %8.2f M create+destroy/s\n", name, ITERATIONS / seconds / 1e6);
+}
+
+int main() {
+#ifdef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  printf("Containers built WITHOUT a mutex member.\n");
+#else
+  printf("Containers built WITH a mutex member.\n");
+#endif
+
+  printf("Header size (bytes):\n");
+  printf("  GCU_Vector64 %zu, GCU_Vector32 %zu, GCU_Vector16 %zu, GCU_Vector8 %zu\n",
+    sizeof(GCU_Vector64), sizeof(GCU_Vector32), sizeof(GCU_Vector16), sizeof(GCU_Vector8));
+  printf("  GCU_Hash64 %zu, GCU_Hash32 %zu, GCU_Hash16 %zu, GCU_Hash8 %zu\n",
+    sizeof(GCU_Hash64), sizeof(GCU_Hash32), sizeof(GCU_Hash16), sizeof(GCU_Hash8));
+
+  printf("Throughput:\n");
+  measure("gcu_vector64_create(0)", []() {
+    gcu_vector64_destroy(gcu_vector64_create(0));
+  });
+  measure("gcu_vector64_create(8)", []() {
+    gcu_vector64_destroy(gcu_vector64_create(8));
+  });
+  measure("gcu_vector64_create_in_place(0)", []() {
+    GCU_Vector64 v;
+    gcu_vector64_create_in_place(&v, 0);
+    gcu_vector64_destroy_in_place(&v);
+  });
+  measure("gcu_hash64_create(0)", []() {
+    gcu_hash64_destroy(gcu_hash64_create(0));
+  });
+  measure("gcu_hash64_create(8)", []() {
+    gcu_hash64_destroy(gcu_hash64_create(8));
+  });
+
+  // Memory held by many small vectors, as seen by the header array alone.
+  const size_t many = 1000000;
+  vector<GCU_Vector64> vectors(many);
+  for (auto & v : vectors) {
+    gcu_vector64_create_in_place(&v, 0);
+  }
+  printf("Headers for %zu empty GCU_Vector64s: %.1f MiB\n", many, many * sizeof(GCU_Vector64) / 1048576.0);
+  for (auto & v : vectors) {
+    gcu_vector64_destroy_in_place(&v);
+  }
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include <cutil/deque.h>
+#include <cutil/vector.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// A work queue which holds up to DEPTH items, through which COUNT items pass.
+static const size_t COUNT = 20000000;
+static const size_t DEPTH = 1000;
+static const size_t BATCH = 64;
+
+// Time `func`, in nanoseconds per item.
+template <typename F>
+static double time(F func) {
+  auto start = steady_clock::now();
+  func();
+  return duration<double, nano>(steady_clock::now() - start).count() / COUNT;
+}
+
+int main() {
+  volatile uint64_t sink = 0;
+  printf("  %zu items through a queue of depth %zu\n", COUNT, DEPTH);
+
+  // The FIFO as a vector: append at the tail, and keep the head index by hand.
+  // The vector never reuses the space before the head.
+  GCU_Vector64 * fifo = gcu_vector64_create(0);
+  double vectorTime = time([&] {
+    size_t head = 0;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      gcu_vector64_append(fifo, gcu_type64_ui64(i));
+      if (fifo->count - head >= DEPTH) {
+        sum += fifo->data[head++].ui64;
+      }
+    }
+    sink = sum;
+  });
+  printf("  %-24s %6.2f ns/item %10zu bytes\n", "vector64 + head index", vectorTime, fifo->capacity * sizeof(GCU_Type64_Union));
+  gcu_vector64_destroy(fifo);
+
+  GCU_Deque64 * deque = gcu_deque64_create(0);
+  double dequeTime = time([&] {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      gcu_deque64_push_back(deque, gcu_type64_ui64(i));
+      if (deque->count >= DEPTH) {
+        sum += gcu_deque64_pop_front(deque).value.ui64;
+      }
+    }
+    sink = sum;
+  });
+  printf("  %-24s %6.2f ns/item %10zu bytes\n", "deque64", dequeTime, deque->capacity * sizeof(GCU_Type64_Union));
+  gcu_deque64_destroy(deque);
+
+  GCU_Ring64 * ring = gcu_ring64_create(DEPTH);
+  double ringTime = time([&] {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      gcu_ring64_push_back(ring, gcu_type64_ui64(i));
+      if (ring->count >= DEPTH) {
+        sum += gcu_ring64_pop_front(ring).value.ui64;
+      }
+    }
+    sink = sum;
+  });
+  printf("  %-24s %6.2f ns/item %10zu bytes\n", "ring64", ringTime, ring->capacity * sizeof(GCU_Type64_Union));
+
+  // The same stream, moved in batches.
+  vector<GCU_Type64_Union> in(BATCH);
+  vector<GCU_Type64_Union> out(BATCH);
+  double batchTime = time([&] {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < COUNT; i += BATCH) {
+      for (size_t j = 0; j < BATCH; ++j) {
+        in[j] = gcu_type64_ui64(i + j);
+      }
+      gcu_ring64_push_many(ring, in.data(), BATCH);
+      if (ring->count >= DEPTH - BATCH) {
+        size_t popped = gcu_ring64_pop_many(ring, out.data(), BATCH);
+        for (size_t j = 0; j < popped; ++j) {
+          sum += out[j].ui64;
+        }
+      }
+    }
+    sink = sum;
+  });
+  printf("  %-24s %6.2f ns/item %10zu bytes\n", "ring64 (batches of 64)", batchTime, ring->capacity * sizeof(GCU_Type64_Union));
+  gcu_ring64_destroy(ring);
+
+  (void)sink;
+  return 0;
+}
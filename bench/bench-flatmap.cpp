@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <cutil/flatmap.h>
+#include <cutil/hash.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// Number of lookups per measurement.
+static const size_t LOOKUPS = 10000000;
+
+// Time `func`, in nanoseconds per `count` operations.
+template <typename F>
+static double time(size_t count, F func) {
+  auto start = steady_clock::now();
+  func();
+  return duration<double, nano>(steady_clock::now() - start).count() / count;
+}
+
+int main() {
+  mt19937_64 rng{42};
+  volatile uint64_t sink = 0;
+
+  printf("  %8s %14s %14s %14s %14s %12s %12s\n", "n", "hash build", "flat build", "hash lookup", "flat lookup", "hash bytes", "flat bytes");
+  for (size_t size : {16, 256, 4096, 65536, 1048576}) {
+    vector<uint64_t> keys(size);
+    vector<GCU_Type64_Union> values(size);
+    for (size_t i = 0; i < size; ++i) {
+      keys[i] = rng();
+      values[i].ui64 = i;
+    }
+
+    // Lookups of keys which are present, in random order.
+    vector<uint64_t> probes(LOOKUPS);
+    for (auto & probe : probes) {
+      probe = keys[rng() % size];
+    }
+
+    // Build many small maps, so that the timing is not lost in the noise.
+    size_t rounds = 1048576 / size;
+    GCU_Hash64 * hash = 0;
+    double hashBuild = time(size * rounds, [&] {
+      for (size_t r = 0; r < rounds; ++r) {
+        gcu_hash64_destroy(hash);
+        hash = gcu_hash64_create(0);
+        for (size_t i = 0; i < size; ++i) {
+          gcu_hash64_set(hash, keys[i], values[i]);
+        }
+      }
+    });
+    GCU_FlatMap64 * flat = 0;
+    double flatBuild = time(size * rounds, [&] {
+      for (size_t r = 0; r < rounds; ++r) {
+        gcu_flatmap64_destroy(flat);
+        flat = gcu_flatmap64_create(0);
+        gcu_flatmap64_set_many(flat, keys.data(), values.data(), size);
+      }
+    });
+
+    // gcu_hash64_get() scans the whole table, so large tables are only given
+    // as many lookups as finish in a reasonable time.
+    size_t hashLookups = size > 64 ? LOOKUPS / (size / 64) : LOOKUPS;
+    double hashLookup = time(hashLookups, [&] {
+      uint64_t sum = 0;
+      for (size_t i = 0; i < hashLookups; ++i) {
+        sum += gcu_hash64_get(hash, probes[i]).value.ui64;
+      }
+      sink = sum;
+    });
+    double flatLookup = time(LOOKUPS, [&] {
+      uint64_t sum = 0;
+      for (auto probe : probes) {
+        sum += gcu_flatmap64_get(flat, probe).value.ui64;
+      }
+      sink = sum;
+    });
+
+    printf("  %8zu %11.1f ns %11.1f ns %11.1f ns %11.1f ns %12zu %12zu\n",
+      size, hashBuild, flatBuild, hashLookup, flatLookup,
+      hash->capacity * sizeof(GCU_Hash64_Cell),
+      (flat->keys.capacity + flat->values.capacity) * sizeof(GCU_Type64_Union));
+    gcu_hash64_destroy(hash);
+    gcu_flatmap64_destroy(flat);
+  }
+
+  (void)sink;
+  return 0;
+}
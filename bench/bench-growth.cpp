@@ -0,0 +1,108 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <cutil/vector.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace std::chrono;
+
+// The values appended to each vector (256 MiB of storage).
+static const size_t COUNT = 32 << 20;
+
+// The random reads made from each vector.
+static const size_t READS = 20000000;
+
+// Counts data TLB misses in this process, where the kernel allows it.
+class TlbMisses {
+  public:
+  TlbMisses() {
+#ifdef __linux__
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    file = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+  }
+  ~TlbMisses() {
+#ifdef __linux__
+    if (file >= 0) {
+      close(file);
+    }
+#endif
+  }
+  void start() {
+#ifdef __linux__
+    if (file >= 0) {
+      ioctl(file, PERF_EVENT_IOC_RESET, 0);
+      ioctl(file, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+  // The misses since start(), or -1 if they cannot be counted.
+  long long stop() {
+    long long misses = -1;
+#ifdef __linux__
+    if (file >= 0) {
+      ioctl(file, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(file, &misses, sizeof(misses)) != sizeof(misses)) {
+        misses = -1;
+      }
+    }
+#endif
+    return misses;
+  }
+  int file = -1;
+};
+
+static void run(const char * name, GCU_Growth growth, TlbMisses & tlb) {
+  auto v = gcu_vector64_create(0);
+  gcu_vector64_set_growth(v, growth);
+
+  auto start = steady_clock::now();
+  for (size_t i = 0; i < COUNT; ++i) {
+    gcu_vector64_append(v, gcu_type64_ui64(i));
+  }
+  double grow = duration<double>(steady_clock::now() - start).count();
+
+  mt19937_64 rng(1);
+  uint64_t total = 0;
+  tlb.start();
+  start = steady_clock::now();
+  for (size_t i = 0; i < READS; ++i) {
+    total += v->data[rng() % COUNT].ui64;
+  }
+  double scan = duration<double>(steady_clock::now() - start).count();
+  long long misses = tlb.stop();
+  volatile uint64_t sink = total;
+  (void)sink;
+
+  char missText[32] = "n/a";
+  if (misses >= 0) {
+    snprintf(missText, sizeof(missText), "%lld", misses);
+  }
+  printf("  %-24s grow %7.3f s   random reads %7.3f s   dTLB misses %s\n", name, grow, scan, missText);
+  gcu_vector64_destroy(v);
+}
+
+int main() {
+  printf("  %zu values, %zu random reads\n", COUNT, READS);
+  TlbMisses tlb;
+  run("malloc (default)", {}, tlb);
+  run("malloc, factor 2", {2, 0, 0, 0, nullptr, 0, nullptr}, tlb);
+  run("huge pages, factor 2", {2, 0, 0, GCU_GROWTH_HUGE_PAGE_SIZE, nullptr, 0, nullptr}, tlb);
+  run("huge pages, 64 MiB steps", {2, 0, (64 << 20) / sizeof(GCU_Type64_Union), GCU_GROWTH_HUGE_PAGE_SIZE, nullptr, 0, nullptr}, tlb);
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <cutil/heap.h>
+#include <cutil/vector.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// Values pushed into and popped from each heap.
+static const size_t COUNT = 10000000;
+
+// Values returned by the top-k comparison.
+static const size_t K = 100;
+
+// Time `func`, in nanoseconds per value.
+template <typename F>
+static double time(F func) {
+  auto start = steady_clock::now();
+  func();
+  return duration<double, nano>(steady_clock::now() - start).count() / COUNT;
+}
+
+int main() {
+  volatile uint64_t sink = 0;
+  mt19937_64 rng(1);
+  vector<GCU_Type64_Union> values(COUNT);
+  for (auto & value : values) {
+    value = gcu_type64_ui64(rng());
+  }
+
+  printf("  %zu random values\n", COUNT);
+  printf("  %-8s %14s %14s %14s %14s\n", "arity", "push", "heapify", "pop", "decrease-key");
+  for (size_t arity : {2, 4, 8}) {
+    GCU_Heap64 * heap = gcu_heap64_create(COUNT, arity, GCU_HEAP64_MIN_UI64, false);
+    double pushTime = time([&] {
+      for (auto value : values) {
+        gcu_heap64_push(heap, value);
+      }
+    });
+    heap->values.count = 0;
+    double heapifyTime = time([&] {
+      gcu_heap64_heapify(heap, values.data(), COUNT);
+    });
+    double popTime = time([&] {
+      uint64_t sum = 0;
+      for (size_t i = 0; i < COUNT; ++i) {
+        sum += gcu_heap64_pop(heap).value.ui64;
+      }
+      sink = sum;
+    });
+    gcu_heap64_destroy(heap);
+
+    // Every id starts at the largest value, and is then lowered at random, as
+    // in Dijkstra's algorithm.
+    heap = gcu_heap64_create(COUNT, arity, GCU_HEAP64_MIN_UI64, true);
+    for (size_t i = 0; i < COUNT; ++i) {
+      gcu_heap64_push_id(heap, gcu_type64_ui64(UINT64_MAX), i);
+    }
+    double updateTime = time([&] {
+      for (size_t i = 0; i < COUNT; ++i) {
+        gcu_heap64_update(heap, i, values[i]);
+      }
+    });
+    gcu_heap64_destroy(heap);
+    printf("  %-8zu %8.1f ns/op %8.1f ns/op %8.1f ns/op %8.1f ns/op\n", arity, pushTime, heapifyTime, popTime, updateTime);
+  }
+
+  // Selecting the top K from a vector, against sorting a copy of it.
+  GCU_Vector64 * input = gcu_vector64_create(COUNT);
+  for (auto value : values) {
+    gcu_vector64_append(input, value);
+  }
+  GCU_Vector64 * result = gcu_vector64_create(K);
+  double topTime = time([&] {
+    gcu_heap64_top_k(input, K, GCU_HEAP64_MAX_UI64, result);
+  });
+  double sortTime = time([&] {
+    auto copy = values;
+    partial_sort(copy.begin(), copy.begin() + K, copy.end(), [](auto a, auto b) { return a.ui64 > b.ui64; });
+    sink = copy[0].ui64;
+  });
+  printf("  top %zu: %.2f ns/value (heap64 top_k), %.2f ns/value (copy + std::partial_sort)\n", K, topTime, sortTime);
+  gcu_vector64_destroy(input);
+  gcu_vector64_destroy(result);
+  return 0;
+}
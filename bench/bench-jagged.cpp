@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <cutil/jagged.h>
+#include <cutil/reduce.h>
+#include <cutil/vector.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// The rows (nodes) and values (edges) of the adjacency lists.
+static const size_t ROWS = 1000000;
+static const size_t EDGES = 8000000;
+
+// Times that each traversal is repeated.
+static const size_t REPEAT = 10;
+
+// Time `func`, in seconds.
+template <typename F>
+static double time(F func) {
+  auto start = steady_clock::now();
+  func();
+  return duration<double>(steady_clock::now() - start).count();
+}
+
+int main() {
+  mt19937_64 rng(1);
+  vector<pair<size_t, uint64_t>> edges(EDGES);
+  for (auto & edge : edges) {
+    edge = {rng() % ROWS, rng() % ROWS};
+  }
+  printf("  %zu rows, %zu values\n", ROWS, EDGES);
+  volatile uint64_t sink = 0;
+
+  // A vector of pointers to vectors: one allocation, header, and mutex per row.
+  GCU_Vector64 * rows = gcu_vector64_create(ROWS);
+  double nestedBuild = time([&] {
+    for (size_t row = 0; row < ROWS; ++row) {
+      gcu_vector64_append(rows, gcu_type64_p(gcu_vector64_create(0)));
+    }
+    for (auto & edge : edges) {
+      gcu_vector64_append((GCU_Vector64 *)rows->data[edge.first].p, gcu_type64_ui64(edge.second));
+    }
+  });
+  size_t nestedBytes = rows->capacity * sizeof(GCU_Type64_Union);
+  for (size_t row = 0; row < ROWS; ++row) {
+    nestedBytes += sizeof(GCU_Vector64) + ((GCU_Vector64 *)rows->data[row].p)->capacity * sizeof(GCU_Type64_Union);
+  }
+  double nestedScan = time([&] {
+    for (size_t i = 0; i < REPEAT; ++i) {
+      uint64_t total = 0;
+      for (size_t row = 0; row < ROWS; ++row) {
+        auto v = (GCU_Vector64 *)rows->data[row].p;
+        total += gcu_sum64_ui64(v->data, v->count);
+      }
+      sink = total;
+    }
+  });
+
+  // Two-phase build: count, then fill.
+  GCU_Jagged64 * jagged = gcu_jagged64_create(ROWS, 0);
+  double twoPhaseBuild = time([&] {
+    for (auto & edge : edges) {
+      gcu_jagged64_add_row_size(jagged, edge.first, 1);
+    }
+    gcu_jagged64_allocate(jagged);
+    for (auto & edge : edges) {
+      gcu_jagged64_fill(jagged, edge.first, gcu_type64_ui64(edge.second));
+    }
+  });
+  size_t jaggedBytes = (jagged->offsets.count + jagged->values.count) * sizeof(GCU_Type64_Union);
+  double jaggedScan = time([&] {
+    for (size_t i = 0; i < REPEAT; ++i) {
+      uint64_t total = 0;
+      for (size_t row = 0; row < ROWS; ++row) {
+        total += gcu_sum64_ui64(GCU_VIEW_ARGS(gcu_jagged64_row(jagged, row)));
+      }
+      sink = total;
+    }
+  });
+  gcu_jagged64_destroy(jagged);
+
+  // Append, then compact once.
+  jagged = gcu_jagged64_create(ROWS, 0);
+  double appendBuild = time([&] {
+    for (auto & edge : edges) {
+      gcu_jagged64_append(jagged, edge.first, gcu_type64_ui64(edge.second));
+    }
+    gcu_jagged64_compact(jagged);
+  });
+  gcu_jagged64_destroy(jagged);
+
+  printf("    %-26s %10s %12s %12s\n", "", "build (ms)", "bytes/value", "scan (GB/s)");
+  printf("    %-26s %10.1f %12.2f %12.2f\n", "vector of vectors", nestedBuild * 1e3, (double)nestedBytes / EDGES, EDGES * sizeof(GCU_Type64_Union) * REPEAT / nestedScan / 1e9);
+  printf("    %-26s %10.1f %12.2f %12.2f\n", "jagged, count then fill", twoPhaseBuild * 1e3, (double)jaggedBytes / EDGES, EDGES * sizeof(GCU_Type64_Union) * REPEAT / jaggedScan / 1e9);
+  printf("    %-26s %10.1f\n", "jagged, append and compact", appendBuild * 1e3);
+
+  for (size_t row = 0; row < ROWS; ++row) {
+    gcu_vector64_destroy((GCU_Vector64 *)rows->data[row].p);
+  }
+  gcu_vector64_destroy(rows);
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+#include <cutil/mapped.h>
+#include <cutil/reduce.h>
+#include <cutil/vector.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// Values appended to each vector.
+static const size_t COUNT = 20000000;
+
+// Time `func`, in seconds.
+template <typename F>
+static double time(F func) {
+  auto start = steady_clock::now();
+  func();
+  return duration<double>(steady_clock::now() - start).count();
+}
+
+int main() {
+  string path = (filesystem::temp_directory_path() / ("bench-mapped-" + to_string(getpid()))).string();
+  filesystem::remove(path);
+  volatile uint64_t sink = 0;
+  double bytes = (double)COUNT * sizeof(GCU_Type64_Union);
+  printf("  %zu values\n", COUNT);
+
+  GCU_Vector64 * v = gcu_vector64_create(0);
+  double vectorAppend = time([&] {
+    for (size_t i = 0; i < COUNT; ++i) {
+      gcu_vector64_append(v, gcu_type64_ui64(i));
+    }
+  });
+  gcu_vector64_destroy(v);
+
+  GCU_Vector64 * mapped = gcu_mapped64_create(path.c_str(), 0);
+  double mappedAppend = time([&] {
+    for (size_t i = 0; i < COUNT; ++i) {
+      gcu_vector64_append(mapped, gcu_type64_ui64(i));
+    }
+  });
+  double syncTime = time([&] {
+    gcu_mapped64_sync(mapped);
+  });
+  gcu_vector64_destroy(mapped);
+
+  // Reopening maps the file as it is, however many values it holds.
+  double reopenTime = time([&] {
+    mapped = gcu_mapped64_open(path.c_str());
+  });
+  double scanTime = time([&] {
+    sink = gcu_sum64_ui64(mapped->data, mapped->count);
+  });
+  gcu_vector64_destroy(mapped);
+  filesystem::remove(path);
+
+  printf("    append to vector64   %8.1f ns/value\n", vectorAppend * 1e9 / COUNT);
+  printf("    append to mapped     %8.1f ns/value\n", mappedAppend * 1e9 / COUNT);
+  printf("    sync                 %8.1f ms\n", syncTime * 1e3);
+  printf("    reopen read-only     %8.1f us\n", reopenTime * 1e6);
+  printf("    first scan           %8.2f GB/s\n", bytes / scanTime / 1e9);
+  return 0;
+}
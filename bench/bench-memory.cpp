@@ -0,0 +1,57 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Every call below is intercepted, as it is when debugging memory.
+#define GHOTIIO_CUTIL_ENABLE_MEMORY_DEBUG
+#include <cutil/memory.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// The allocations made, and then freed, by each run.
+static const size_t COUNT = 200000;
+
+static void run(const char * name) {
+  void * blocks[64];
+  auto start = steady_clock::now();
+  for (size_t i = 0; i < COUNT; i += 64) {
+    for (size_t j = 0; j < 64; ++j) {
+      blocks[j] = gcu_malloc(16 + j);
+    }
+    for (size_t j = 0; j < 64; ++j) {
+      gcu_free(blocks[j]);
+    }
+  }
+  double seconds = duration<double>(steady_clock::now() - start).count();
+  printf("  %-24s %8.1f ns/call\n", name, seconds * 1e9 / (2 * COUNT));
+}
+
+int main() {
+  // Logging goes to a file, as it would when left on in staging.
+  string log = "bench-memory.log";
+  string trace = "bench-memory.trace";
+  if (!freopen(log.c_str(), "w", stderr)) {
+    return 1;
+  }
+  printf("  %zu allocations and frees\n", COUNT);
+
+  gcu_mem_stop();
+  run("not logged");
+  gcu_set_allocator(&gcu_system_allocator);
+  run("through an allocator");
+  gcu_set_allocator(nullptr);
+  gcu_mem_start();
+  run("logged to stderr");
+  gcu_mem_trace_start(trace.c_str());
+  run("traced");
+  gcu_mem_trace_stop();
+  gcu_mem_stop();
+  gcu_mem_profile_start(false);
+  run("profiled, not logged");
+  gcu_mem_profile_stop();
+
+  remove(log.c_str());
+  remove(trace.c_str());
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <cutil/packed.h>
+#include <cutil/reduce.h>
+#include <cutil/vector.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// Values in each series.
+static const size_t COUNT = 10000000;
+
+// Times that each scan is repeated.
+static const size_t REPEAT = 10;
+
+// Time `func`, in seconds.
+template <typename F>
+static double time(F func) {
+  auto start = steady_clock::now();
+  func();
+  return duration<double>(steady_clock::now() - start).count();
+}
+
+static void run(const char * name, const vector<GCU_Type64_Union> & values) {
+  volatile uint64_t sink = 0;
+  double bytes = (double)COUNT * sizeof(GCU_Type64_Union);
+
+  GCU_Packed64 * packed = gcu_packed64_create(COUNT);
+  double encodeTime = time([&] {
+    gcu_packed64_append_many(packed, values.data(), values.size());
+  });
+  printf("  %s: %.2f bytes/value, encode %.0f MB/s\n", name, (double)gcu_packed64_size(packed) / COUNT, bytes / encodeTime / 1e6);
+
+  GCU_Vector64 * decoded = gcu_vector64_create(COUNT);
+  double decodeTime = time([&] {
+    for (size_t i = 0; i < REPEAT; ++i) {
+      decoded->count = 0;
+      gcu_packed64_decode(packed, decoded);
+    }
+  });
+  double sumTime = time([&] {
+    for (size_t i = 0; i < REPEAT; ++i) {
+      sink = gcu_packed64_sum_ui64(packed);
+    }
+  });
+  double plainTime = time([&] {
+    for (size_t i = 0; i < REPEAT; ++i) {
+      sink = gcu_sum64_ui64(decoded->data, decoded->count);
+    }
+  });
+  mt19937_64 rng(1);
+  double getTime = time([&] {
+    uint64_t total = 0;
+    for (size_t i = 0; i < COUNT / 10; ++i) {
+      total += gcu_packed64_get(packed, rng() % COUNT).value.ui64;
+    }
+    sink = total;
+  });
+  printf("    decode to vector64  %8.2f GB/s\n", bytes * REPEAT / decodeTime / 1e9);
+  printf("    sum packed          %8.2f GB/s (of decoded values)\n", bytes * REPEAT / sumTime / 1e9);
+  printf("    sum vector64        %8.2f GB/s\n", bytes * REPEAT / plainTime / 1e9);
+  printf("    random get          %8.1f ns/value\n", getTime * 1e9 / (COUNT / 10));
+  gcu_vector64_destroy(decoded);
+  gcu_packed64_destroy(packed);
+}
+
+int main() {
+  mt19937_64 rng(1);
+  printf("  %zu values per series\n", COUNT);
+
+  // Nanosecond timestamps of an event every millisecond or so.
+  vector<GCU_Type64_Union> values(COUNT);
+  uint64_t now = 1700000000000000000ull;
+  for (auto & value : values) {
+    now += 1000000 + rng() % 4096;
+    value = gcu_type64_ui64(now);
+  }
+  run("timestamps (1 ms +- 4 us)", values);
+
+  // Small counters.
+  for (auto & value : values) {
+    value = gcu_type64_ui64(rng() % 1000);
+  }
+  run("counters (0-999)", values);
+
+  // Wide random values, which do not compress.
+  for (auto & value : values) {
+    value = gcu_type64_ui64(rng() >> 4);
+  }
+  run("random 60-bit", values);
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <cutil/parallel.h>
+#include <cutil/sort.h>
+#include <cutil/thread.h>
+
+using namespace std;
+using namespace std::chrono;
+
+static const size_t COUNT = 10000000;
+
+template <typename F>
+static double time(F func) {
+  auto start = steady_clock::now();
+  func();
+  return duration<double, milli>(steady_clock::now() - start).count();
+}
+
+static void sqrtChunk(const GCU_Type64_Union * source, GCU_Type64_Union * destination, size_t count, void *) {
+  for (size_t i = 0; i < count; ++i) {
+    destination[i].f64 = sqrt((double)source[i].ui64);
+  }
+}
+
+static void scaleChunk(GCU_Type64_Union * data, size_t count, void *) {
+  for (size_t i = 0; i < count; ++i) {
+    data[i].ui64 = data[i].ui64 * 3 + 1;
+  }
+}
+
+int main() {
+  mt19937_64 rng{42};
+  auto source = gcu_vector64_create(COUNT);
+  for (size_t i = 0; i < COUNT; ++i) {
+    gcu_vector64_append(source, gcu_type64_ui64(1700000000000000000ull + (rng() % 3600000000000ull)));
+  }
+  auto work = gcu_vector64_create(COUNT);
+  auto output = gcu_vector64_create(COUNT);
+
+  // Single-threaded baselines, without a pool.
+  vector<GCU_Type64_Union> copy(source->data, source->data + COUNT);
+  double sortBase = time([&] { gcu_sort64_ui64(copy.data(), COUNT); });
+  volatile uint64_t sink = 0;
+  double sumBase = time([&] {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      sum += source->data[i].ui64;
+    }
+    sink = sum;
+  });
+  printf("  n=%zu, serial: sort %.1f ms, sum %.2f ms\n", COUNT, sortBase, sumBase);
+  printf("  %-8s %12s %12s %12s %12s %12s\n", "threads", "par_sort", "par_sum", "par_max", "for_each", "transform");
+
+  // Double the thread count up to the number of processors, and always
+  // include the number of processors itself.
+  unsigned processors = gcu_thread_get_num_processors();
+  vector<size_t> threadCounts;
+  for (size_t threads = 1; threads < processors; threads *= 2) {
+    threadCounts.push_back(threads);
+  }
+  threadCounts.push_back(processors ? processors : 1);
+
+  for (auto threads : threadCounts) {
+    auto pool = gcu_thread_pool_create(threads);
+
+    for (size_t i = 0; i < COUNT; ++i) {
+      work->data[i] = source->data[i];
+    }
+    work->count = COUNT;
+    double sort = time([&] { gcu_vector64_par_sort_ui64(pool, work); });
+    double sum = time([&] { sink = gcu_vector64_par_sum_ui64(pool, source); });
+    double max = time([&] { sink = gcu_vector64_par_max_ui64(pool, source); });
+    double each = time([&] { gcu_vector64_par_for_each(pool, work, scaleChunk, NULL); });
+    double transform = time([&] { gcu_vector64_par_transform(pool, output, source, sqrtChunk, NULL); });
+    printf("  %-8zu %9.1f ms %9.2f ms %9.2f ms %9.2f ms %9.2f ms\n", threads, sort, sum, max, each, transform);
+
+    gcu_thread_pool_destroy(pool);
+  }
+  (void)sink;
+
+  gcu_vector64_destroy(source);
+  gcu_vector64_destroy(work);
+  gcu_vector64_destroy(output);
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cutil/memory.h>
+#include <cutil/pool.h>
+#include <cutil/thread.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// The size of each object, as for a small node or message.
+static const size_t SIZE = 48;
+
+// Each thread allocates a burst of objects, then frees them, this many times.
+static const size_t BURST = 256;
+static const size_t ROUNDS = 4000;
+
+enum Source {POOL, GCU_MALLOC, MALLOC};
+
+struct Worker {
+  Source source;
+  GCU_Pool * pool;
+};
+
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION work(GCU_THREAD_FUNC_ARG_T arg) {
+  auto worker = (Worker *)arg;
+  void * objects[BURST];
+  for (size_t round = 0; round < ROUNDS; ++round) {
+    for (size_t i = 0; i < BURST; ++i) {
+      objects[i] = worker->source == POOL
+        ? gcu_pool_allocate(worker->pool)
+        : worker->source == GCU_MALLOC
+          ? gcu_malloc(SIZE)
+          : malloc(SIZE);
+      *(volatile size_t *)objects[i] = i;
+    }
+    for (size_t i = 0; i < BURST; ++i) {
+      if (worker->source == POOL) {
+        gcu_pool_free(worker->pool, objects[i]);
+      }
+      else if (worker->source == GCU_MALLOC) {
+        gcu_free(objects[i]);
+      }
+      else {
+        free(objects[i]);
+      }
+    }
+  }
+  return 0;
+}
+
+static void run(const char * name, Source source, size_t threads) {
+  GCU_Pool * pool = gcu_pool_create(SIZE);
+  Worker worker = {source, pool};
+  GCU_Thread handles[16];
+
+  auto start = steady_clock::now();
+  for (size_t i = 0; i < threads; ++i) {
+    gcu_thread_create(&handles[i], work, &worker);
+  }
+  for (size_t i = 0; i < threads; ++i) {
+    gcu_thread_join(handles[i]);
+  }
+  double seconds = duration<double>(steady_clock::now() - start).count();
+
+  // Each operation is one allocation and one free.
+  printf("  %-12s %2zu threads   %7.2f ns/operation\n", name, threads, seconds * 1e9 / (threads * ROUNDS * BURST));
+  gcu_pool_destroy(pool);
+}
+
+int main() {
+  printf("  %zu-byte objects, bursts of %zu, %zu processors\n", SIZE, BURST, (size_t)gcu_thread_get_num_processors());
+  for (size_t threads : {1, 2, 4, 8}) {
+    run("pool", POOL, threads);
+    run("gcu_malloc", GCU_MALLOC, threads);
+    run("malloc", MALLOC, threads);
+  }
+  return 0;
+}
@@ -0,0 +1,190 @@
+#include <chrono>
+#include <cstdio>
+#include <cutil/mutex.h>
+#include <cutil/queue.h>
+#include <cutil/semaphore.h>
+#include <cutil/thread.h>
+#include <cutil/vector.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// Messages sent through each channel.
+static const size_t COUNT = 1000000;
+
+// Round trips for the latency test.
+static const size_t ROUND_TRIPS = 100000;
+
+static const size_t CAPACITY = 1024;
+static const size_t BATCH = 64;
+
+// The pattern being replaced: a vector guarded by a mutex, with a semaphore
+// counting the messages in it.
+struct LockedChannel {
+  GCU_Vector64 * vector;
+  size_t head;
+  GCU_MUTEX_T mutex;
+  GCU_Semaphore items;
+
+  LockedChannel() : vector{gcu_vector64_create(CAPACITY)}, head{0} {
+    GCU_MUTEX_CREATE(mutex);
+    gcu_semaphore_create(&items, 0);
+  }
+  ~LockedChannel() {
+    gcu_vector64_destroy(vector);
+    GCU_MUTEX_DESTROY(mutex);
+    gcu_semaphore_destroy(&items);
+  }
+  void push(GCU_Type64_Union value) {
+    GCU_MUTEX_LOCK(mutex);
+    gcu_vector64_append(vector, value);
+    GCU_MUTEX_UNLOCK(mutex);
+    gcu_semaphore_signal(&items);
+  }
+  GCU_Type64_Union pop() {
+    gcu_semaphore_wait(&items);
+    GCU_MUTEX_LOCK(mutex);
+    GCU_Type64_Union value = vector->data[head++];
+    if (head == vector->count) {
+      head = vector->count = 0;
+    }
+    GCU_MUTEX_UNLOCK(mutex);
+    return value;
+  }
+};
+
+struct SPSCChannel {
+  GCU_SPSC_Queue64 * queue = gcu_spsc_queue64_create(CAPACITY);
+  ~SPSCChannel() { gcu_spsc_queue64_destroy(queue); }
+  void push(GCU_Type64_Union value) { gcu_spsc_queue64_push(queue, value); }
+  GCU_Type64_Union pop() { return gcu_spsc_queue64_pop(queue); }
+};
+
+struct MPMCChannel {
+  GCU_MPMC_Queue64 * queue = gcu_mpmc_queue64_create(CAPACITY);
+  ~MPMCChannel() { gcu_mpmc_queue64_destroy(queue); }
+  void push(GCU_Type64_Union value) { gcu_mpmc_queue64_push(queue, value); }
+  GCU_Type64_Union pop() { return gcu_mpmc_queue64_pop(queue); }
+};
+
+// Send COUNT messages from another thread, one at a time or in batches.
+template <typename Channel, bool batched>
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION produce(GCU_THREAD_FUNC_ARG_T arg) {
+  auto channel = (Channel *)arg;
+  if constexpr (batched) {
+    GCU_Type64_Union batch[BATCH];
+    for (size_t i = 0; i < COUNT; i += BATCH) {
+      for (size_t j = 0; j < BATCH; ++j) {
+        batch[j] = gcu_type64_ui64(i + j);
+      }
+      size_t sent = 0;
+      while (sent < BATCH) {
+        sent += gcu_spsc_queue64_push_many(channel->queue, batch + sent, BATCH - sent);
+        if (sent < BATCH) {
+          gcu_spsc_queue64_push(channel->queue, batch[sent++]);
+        }
+      }
+    }
+  }
+  else {
+    for (size_t i = 0; i < COUNT; ++i) {
+      channel->push(gcu_type64_ui64(i));
+    }
+  }
+  return 0;
+}
+
+// Receive COUNT messages, in nanoseconds per message.
+template <typename Channel, bool batched = false>
+static double throughput() {
+  Channel channel;
+  auto start = steady_clock::now();
+  GCU_Thread producer;
+  gcu_thread_create(&producer, produce<Channel, batched>, &channel);
+  uint64_t sum = 0;
+  if constexpr (batched) {
+    GCU_Type64_Union batch[BATCH];
+    for (size_t received = 0; received < COUNT;) {
+      size_t count = gcu_spsc_queue64_pop_many(channel.queue, batch, BATCH);
+      if (!count) {
+        batch[0] = gcu_spsc_queue64_pop(channel.queue);
+        count = 1;
+      }
+      for (size_t j = 0; j < count; ++j) {
+        sum += batch[j].ui64;
+      }
+      received += count;
+    }
+  }
+  else {
+    for (size_t i = 0; i < COUNT; ++i) {
+      sum += channel.pop().ui64;
+    }
+  }
+  gcu_thread_join(producer);
+  double ns = duration<double, nano>(steady_clock::now() - start).count() / COUNT;
+  if (sum != (uint64_t)COUNT * (COUNT - 1) / 2) {
+    printf("  wrong sum\n");
+  }
+  return ns;
+}
+
+template <typename Channel>
+struct PingPong {
+  Channel ping;
+  Channel pong;
+};
+
+// Echo every message back.
+template <typename Channel>
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION echo(GCU_THREAD_FUNC_ARG_T arg) {
+  auto channels = (PingPong<Channel> *)arg;
+  for (size_t i = 0; i < ROUND_TRIPS; ++i) {
+    channels->pong.push(channels->ping.pop());
+  }
+  return 0;
+}
+
+// Bounce a message between two threads, in nanoseconds per round trip.
+template <typename Channel>
+static double latency() {
+  PingPong<Channel> channels;
+  GCU_Thread echoer;
+  gcu_thread_create(&echoer, echo<Channel>, &channels);
+  auto start = steady_clock::now();
+  for (size_t i = 0; i < ROUND_TRIPS; ++i) {
+    channels.ping.push(gcu_type64_ui64(i));
+    channels.pong.pop();
+  }
+  double ns = duration<double, nano>(steady_clock::now() - start).count() / ROUND_TRIPS;
+  gcu_thread_join(echoer);
+  return ns;
+}
+
+// Push and pop on a single thread, so that nobody ever waits, in nanoseconds
+// per message.  This is the cost that each side pays on its own.
+template <typename Channel>
+static double uncontended() {
+  Channel channel;
+  uint64_t sum = 0;
+  auto start = steady_clock::now();
+  for (size_t i = 0; i < COUNT; ++i) {
+    channel.push(gcu_type64_ui64(i));
+    sum += channel.pop().ui64;
+  }
+  double ns = duration<double, nano>(steady_clock::now() - start).count() / COUNT;
+  if (sum != (uint64_t)COUNT * (COUNT - 1) / 2) {
+    printf("  wrong sum\n");
+  }
+  return ns;
+}
+
+int main() {
+  printf("  %u processors, queue capacity %zu\n", gcu_thread_get_num_processors(), CAPACITY);
+  printf("  %-26s %16s %16s %16s\n", "channel", "uncontended", "throughput", "round trip");
+  printf("  %-26s %10.1f ns/msg %10.1f ns/msg %13.0f ns\n", "mutex + semaphore + vector", uncontended<LockedChannel>(), throughput<LockedChannel>(), latency<LockedChannel>());
+  printf("  %-26s %10.1f ns/msg %10.1f ns/msg %13.0f ns\n", "spsc queue", uncontended<SPSCChannel>(), throughput<SPSCChannel>(), latency<SPSCChannel>());
+  printf("  %-26s %17s %10.1f ns/msg %16s\n", "spsc queue (batches of 64)", "-", throughput<SPSCChannel, true>(), "-");
+  printf("  %-26s %10.1f ns/msg %10.1f ns/msg %13.0f ns\n", "mpmc queue", uncontended<MPMCChannel>(), throughput<MPMCChannel>(), latency<MPMCChannel>());
+  return 0;
+}
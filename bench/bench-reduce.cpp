@@ -0,0 +1,123 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <cutil/reduce.h>
+
+using namespace std;
+using namespace std::chrono;
+
+static const size_t COUNT = 10000000;
+static const int REPEAT = 10;
+
+// Time `func`, repeated to smooth out noise, in milliseconds per call.
+template <typename F>
+static double time(F func) {
+  auto start = steady_clock::now();
+  for (int i = 0; i < REPEAT; ++i) {
+    func();
+  }
+  return duration<double, milli>(steady_clock::now() - start).count() / REPEAT;
+}
+
+static void compare(const char * name, double scalar, double gcu) {
+  printf("  %-20s scalar %8.2f ms   gcu %8.2f ms   %5.1fx\n", name, scalar, gcu, scalar / gcu);
+}
+
+int main() {
+  mt19937_64 rng{42};
+  vector<GCU_Type32_Union> floats(COUNT);
+  vector<GCU_Type32_Union> ids(COUNT);
+  vector<GCU_Type64_Union> doubles(COUNT);
+  vector<GCU_Type8_Union> bytes(COUNT);
+  for (size_t i = 0; i < COUNT; ++i) {
+    floats[i].f32 = uniform_real_distribution<float>{-1000.0f, 1000.0f}(rng);
+    ids[i].ui32 = (uint32_t)(rng() % 1000000);
+    doubles[i].f64 = uniform_real_distribution<double>{0.0, 1.0}(rng);
+    bytes[i].ui8 = (uint8_t)rng();
+  }
+  // A value which only appears near the end.
+  uint32_t needle = 2000000;
+  ids[COUNT - 100].ui32 = needle;
+  volatile double fsink;
+  volatile size_t sink;
+
+  printf("  n=%zu\n", COUNT);
+
+  // The scalar loops below are written the way callers write them today.
+  compare("sum f32", time([&] {
+    double sum = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      sum += floats[i].f32;
+    }
+    fsink = sum;
+  }), time([&] { fsink = gcu_sum32_f32(floats.data(), COUNT); }));
+
+  compare("sum f64", time([&] {
+    double sum = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      sum += doubles[i].f64;
+    }
+    fsink = sum;
+  }), time([&] { fsink = gcu_sum64_f64(doubles.data(), COUNT); }));
+
+  compare("min f32", time([&] {
+    float minimum = floats[0].f32;
+    for (size_t i = 1; i < COUNT; ++i) {
+      minimum = floats[i].f32 < minimum ? floats[i].f32 : minimum;
+    }
+    fsink = minimum;
+  }), time([&] { fsink = gcu_min32_f32(floats.data(), COUNT); }));
+
+  compare("argmin f32", time([&] {
+    size_t best = 0;
+    for (size_t i = 1; i < COUNT; ++i) {
+      if (floats[i].f32 < floats[best].f32) {
+        best = i;
+      }
+    }
+    sink = best;
+  }), time([&] { sink = gcu_argmin32_f32(floats.data(), COUNT); }));
+
+  compare("find ui32", time([&] {
+    size_t i = 0;
+    while (i < COUNT && ids[i].ui32 != needle) {
+      ++i;
+    }
+    sink = i;
+  }), time([&] { sink = gcu_find32_ui32(ids.data(), COUNT, needle); }));
+
+  compare("count ui32", time([&] {
+    size_t count = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      if (ids[i].ui32 == 12345) {
+        ++count;
+      }
+    }
+    sink = count;
+  }), time([&] { sink = gcu_count32_ui32(ids.data(), COUNT, 12345); }));
+
+  compare("count_range ui32", time([&] {
+    size_t count = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      if (ids[i].ui32 >= 1000 && ids[i].ui32 <= 50000) {
+        ++count;
+      }
+    }
+    sink = count;
+  }), time([&] { sink = gcu_count_range32_ui32(ids.data(), COUNT, 1000, 50000); }));
+
+  compare("count ui8", time([&] {
+    size_t count = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      if (bytes[i].ui8 == 42) {
+        ++count;
+      }
+    }
+    sink = count;
+  }), time([&] { sink = gcu_count8_ui8(bytes.data(), COUNT, 42); }));
+
+  (void)fsink;
+  (void)sink;
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <cutil/hash.h>
+#include <cutil/roaring.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// Time `func`, in nanoseconds per `count` operations.
+template <typename F>
+static double time(size_t count, F func) {
+  auto start = steady_clock::now();
+  func();
+  return duration<double, nano>(steady_clock::now() - start).count() / count;
+}
+
+// Ids of the users in a segment: `count` ids out of `universe`.
+static vector<uint32_t> segment(mt19937_64 & rng, size_t count, uint32_t universe) {
+  vector<uint32_t> ids(count);
+  for (auto & id : ids) {
+    id = (uint32_t)(rng() % universe);
+  }
+  return ids;
+}
+
+int main() {
+  mt19937_64 rng{42};
+  volatile uint64_t sink = 0;
+
+  printf("  %-28s %12s %12s %12s %12s %12s %10s\n", "set", "hash add", "roar add", "hash has", "roar has", "hash bytes", "roar bytes");
+  struct Case {
+    const char * name;
+    size_t count;
+    uint32_t universe;
+  };
+  for (auto c : {Case{"1K of 4G (sparse)", 1000, UINT32_MAX}, Case{"100K of 4G (sparse)", 100000, UINT32_MAX}, Case{"100K of 1M (dense)", 100000, 1000000}, Case{"1M of 4G (sparse)", 1000000, UINT32_MAX}}) {
+    auto ids = segment(rng, c.count, c.universe);
+    auto probes = segment(rng, 1000000, c.universe);
+    for (size_t i = 0; i < probes.size(); i += 2) {
+      probes[i] = ids[i % ids.size()];
+    }
+
+    GCU_Hash32 * hash = gcu_hash32_create(0);
+    double hashAdd = time(ids.size(), [&] {
+      for (auto id : ids) {
+        gcu_hash32_set(hash, id, gcu_type32_b(true));
+      }
+    });
+    GCU_Roaring32 * roaring = gcu_roaring32_create();
+    double roaringAdd = time(ids.size(), [&] {
+      for (auto id : ids) {
+        gcu_roaring32_add(roaring, id);
+      }
+    });
+
+    // gcu_hash32_contains() scans the whole table, so large tables are only
+    // given as many lookups as finish in a reasonable time.
+    size_t hashProbes = ids.size() > 64 ? probes.size() / (ids.size() / 64) : probes.size();
+    hashProbes = hashProbes ? hashProbes : 1;
+    double hashHas = time(hashProbes, [&] {
+      uint64_t found = 0;
+      for (size_t i = 0; i < hashProbes; ++i) {
+        found += gcu_hash32_contains(hash, probes[i]);
+      }
+      sink = found;
+    });
+    double roaringHas = time(probes.size(), [&] {
+      uint64_t found = 0;
+      for (auto probe : probes) {
+        found += gcu_roaring32_contains(roaring, probe);
+      }
+      sink = found;
+    });
+
+    printf("  %-28s %9.1f ns %9.1f ns %9.1f ns %9.1f ns %12zu %10zu\n", c.name, hashAdd, roaringAdd, hashHas, roaringHas,
+      hash->capacity * sizeof(GCU_Hash32_Cell), gcu_roaring32_size_in_bytes(roaring));
+    gcu_hash32_destroy(hash);
+    gcu_roaring32_destroy(roaring);
+  }
+
+  // Set operations between two segments, in milliseconds per operation.
+  printf("\n  %-28s %12s %12s\n", "segments", "and", "or");
+  for (auto c : {Case{"1M + 1M of 4G (sparse)", 1000000, UINT32_MAX}, Case{"1M + 1M of 16M (arrays)", 1000000, 16000000}, Case{"5M + 5M of 10M (bitmaps)", 5000000, 10000000}}) {
+    GCU_Roaring32 * a = gcu_roaring32_create();
+    GCU_Roaring32 * b = gcu_roaring32_create();
+    for (auto id : segment(rng, c.count, c.universe)) {
+      gcu_roaring32_add(a, id);
+    }
+    for (auto id : segment(rng, c.count, c.universe)) {
+      gcu_roaring32_add(b, id);
+    }
+    const int repeat = 10;
+    vector<GCU_Roaring32 *> copies(repeat);
+    for (auto & copy : copies) {
+      copy = gcu_roaring32_create();
+      gcu_roaring32_or(copy, a);
+    }
+    double andTime = time(repeat, [&] {
+      for (auto copy : copies) {
+        gcu_roaring32_and(copy, b);
+      }
+    });
+    for (auto & copy : copies) {
+      gcu_roaring32_destroy(copy);
+      copy = gcu_roaring32_create();
+      gcu_roaring32_or(copy, a);
+    }
+    double orTime = time(repeat, [&] {
+      for (auto copy : copies) {
+        gcu_roaring32_or(copy, b);
+      }
+    });
+    printf("  %-28s %9.2f ms %9.2f ms\n", c.name, andTime / 1e6, orTime / 1e6);
+    for (auto copy : copies) {
+      gcu_roaring32_destroy(copy);
+    }
+    gcu_roaring32_destroy(a);
+    gcu_roaring32_destroy(b);
+  }
+
+  (void)sink;
+  return 0;
+}
@@ -0,0 +1,44 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cutil/memory.h>
+#include <cutil/scratch.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// The temporary buffers taken, used, and given back by each run.
+static const size_t COUNT = 200000;
+
+// Take a buffer, touch its first and last bytes as a caller would, and give
+// it back.
+static void run(const char * name, size_t size, bool scratch) {
+  auto start = steady_clock::now();
+  for (size_t i = 0; i < COUNT; ++i) {
+    if (scratch) {
+      auto mark = gcu_scratch_mark();
+      auto buffer = (volatile char *)gcu_scratch_allocate(size);
+      buffer[0] = (char)i;
+      buffer[size - 1] = (char)i;
+      gcu_scratch_rewind(mark);
+    }
+    else {
+      auto buffer = (volatile char *)gcu_malloc(size);
+      buffer[0] = (char)i;
+      buffer[size - 1] = (char)i;
+      gcu_free((void *)buffer);
+    }
+  }
+  double seconds = duration<double>(steady_clock::now() - start).count();
+  printf("  %-12s %8zu bytes   %7.1f ns/buffer\n", name, size, seconds * 1e9 / COUNT);
+}
+
+int main() {
+  printf("  %zu temporary buffers of each size\n", COUNT);
+  for (size_t size : {64, 4096, 60000, 1000000}) {
+    run("scratch", size, true);
+    run("gcu_malloc", size, false);
+  }
+  printf("  scratch high-water mark: %zu bytes\n", gcu_scratch_high_water());
+  return 0;
+}
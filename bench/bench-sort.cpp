@@ -0,0 +1,88 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <cutil/sort.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// qsort() comparators, as typically written by callers before this library
+// provided typed sorts.
+static int compare_ui64(const void * a, const void * b) {
+  uint64_t x = ((const GCU_Type64_Union *)a)->ui64;
+  uint64_t y = ((const GCU_Type64_Union *)b)->ui64;
+  return (x > y) - (x < y);
+}
+
+static int compare_i64(const void * a, const void * b) {
+  int64_t x = ((const GCU_Type64_Union *)a)->i64;
+  int64_t y = ((const GCU_Type64_Union *)b)->i64;
+  return (x > y) - (x < y);
+}
+
+static int compare_f64(const void * a, const void * b) {
+  double x = ((const GCU_Type64_Union *)a)->f64;
+  double y = ((const GCU_Type64_Union *)b)->f64;
+  return (x > y) - (x < y);
+}
+
+static int compare_ui32(const void * a, const void * b) {
+  uint32_t x = ((const GCU_Type32_Union *)a)->ui32;
+  uint32_t y = ((const GCU_Type32_Union *)b)->ui32;
+  return (x > y) - (x < y);
+}
+
+static int compare_f32(const void * a, const void * b) {
+  float x = ((const GCU_Type32_Union *)a)->f32;
+  float y = ((const GCU_Type32_Union *)b)->f32;
+  return (x > y) - (x < y);
+}
+
+// Time `func` on a fresh copy of `source`.
+template <typename T, typename F>
+static double timeSort(const vector<T> & source, F func) {
+  vector<T> data = source;
+  auto start = steady_clock::now();
+  func(data.data(), data.size());
+  return duration<double, milli>(steady_clock::now() - start).count();
+}
+
+template <typename T, typename F>
+static void compare(const char * name, const vector<T> & source, int (*comparator)(const void *, const void *), F func) {
+  double q = timeSort(source, [&](T * data, size_t count) {
+    qsort(data, count, sizeof(T), comparator);
+  });
+  double g = timeSort(source, func);
+  printf("  %-14s n=%-9zu qsort %9.2f ms   gcu %9.2f ms   %5.1fx\n", name, source.size(), q, g, q / g);
+}
+
+int main() {
+  mt19937_64 rng{42};
+
+  for (size_t count : {1000, 100000, 1000000, 10000000}) {
+    // Timestamps: increasing in the upper bits, noisy in the lower bits.
+    vector<GCU_Type64_Union> timestamps(count);
+    vector<GCU_Type64_Union> deltas(count);
+    vector<GCU_Type64_Union> prices(count);
+    vector<GCU_Type32_Union> ids(count);
+    vector<GCU_Type32_Union> floats(count);
+    for (size_t i = 0; i < count; ++i) {
+      timestamps[i].ui64 = 1700000000000000000ull + (rng() % 3600000000000ull);
+      deltas[i].i64 = (int64_t)(rng() % 2000001) - 1000000;
+      prices[i].f64 = uniform_real_distribution<double>{0.01, 10000.0}(rng);
+      ids[i].ui32 = (uint32_t)rng();
+      floats[i].f32 = uniform_real_distribution<float>{-1000.0f, 1000.0f}(rng);
+    }
+
+    compare("ui64 (time)", timestamps, compare_ui64, gcu_sort64_ui64);
+    compare("i64 (delta)", deltas, compare_i64, gcu_sort64_i64);
+    compare("f64 (price)", prices, compare_f64, gcu_sort64_f64);
+    compare("ui32", ids, compare_ui32, gcu_sort32_ui32);
+    compare("f32", floats, compare_f32, gcu_sort32_f32);
+  }
+
+  return 0;
+}
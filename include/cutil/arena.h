@@ -0,0 +1,229 @@
+/**
+ * @file
+ * An arena (bump) allocator.
+ *
+ * An arena hands out memory from large chunks, by moving a cursor forward, so
+ * an allocation costs a few instructions and nothing is freed one allocation
+ * at a time.  Instead, everything allocated from the arena is given back at
+ * once by gcu_arena_reset(), or everything allocated since a mark by
+ * gcu_arena_rewind().  The chunks themselves are kept for reuse until the
+ * arena is destroyed, so an arena which is reset after each unit of work
+ * (such as a request) stops calling `malloc()` once it has grown to the size
+ * of the largest unit.
+ *
+ * Vectors and hash tables can be created in an arena with
+ * gcu_vector64_create_in_arena(), gcu_hash64_create_in_arena(), and so on.
+ * Both the container and its data then come from the arena, and are given
+ * back when it is reset.  Such a container may still be destroyed (which
+ * calls its `cleanup` function and releases its mutex), but it need not be,
+ * except on Windows, where each mutex is a handle that must be closed (or the
+ * library built with `make CONTAINER_MUTEX=0`).
+ *
+ * Memory from an arena must not be passed to gcu_free(), and is not zeroed.
+ */
+
+#ifndef GHOTIIO_CUTIL_ARENA_H
+#define GHOTIIO_CUTIL_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <cutil/libver.h>
+#include <cutil/mutex.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_Arena_Chunk GHOTIIO_CUTIL(GCU_Arena_Chunk)
+#define GCU_Arena_Cleanup GHOTIIO_CUTIL(GCU_Arena_Cleanup)
+#define GCU_Arena_Mark GHOTIIO_CUTIL(GCU_Arena_Mark)
+#define GCU_Arena GHOTIIO_CUTIL(GCU_Arena)
+#define gcu_arena_create GHOTIIO_CUTIL(gcu_arena_create)
+#define gcu_arena_create_in_place GHOTIIO_CUTIL(gcu_arena_create_in_place)
+#define gcu_arena_destroy GHOTIIO_CUTIL(gcu_arena_destroy)
+#define gcu_arena_destroy_in_place GHOTIIO_CUTIL(gcu_arena_destroy_in_place)
+#define gcu_arena_allocate GHOTIIO_CUTIL(gcu_arena_allocate)
+#define gcu_arena_allocate_aligned GHOTIIO_CUTIL(gcu_arena_allocate_aligned)
+#define gcu_arena_reallocate GHOTIIO_CUTIL(gcu_arena_reallocate)
+#define gcu_arena_mark GHOTIIO_CUTIL(gcu_arena_mark)
+#define gcu_arena_rewind GHOTIIO_CUTIL(gcu_arena_rewind)
+#define gcu_arena_reset GHOTIIO_CUTIL(gcu_arena_reset)
+#define gcu_arena_size GHOTIIO_CUTIL(gcu_arena_size)
+/// @endcond
+
+/**
+ * The alignment of memory from gcu_arena_allocate(), which suits any type.
+ */
+#ifdef __cplusplus
+#define GCU_ARENA_ALIGNMENT alignof(max_align_t)
+#else
+#define GCU_ARENA_ALIGNMENT _Alignof(max_align_t)
+#endif
+
+/**
+ * The chunk size used when `0` is given to gcu_arena_create().
+ */
+#define GCU_ARENA_DEFAULT_CHUNK_SIZE ((size_t)64 << 10)
+
+typedef struct GCU_Arena GCU_Arena;
+
+/**
+ * A chunk of memory from which an arena allocates.  It is private to the
+ * arena.
+ */
+typedef struct GCU_Arena_Chunk GCU_Arena_Chunk;
+
+/**
+ * Pointer to a function which will be called when the arena destroy function
+ * is called.
+ *
+ * @ref gcu_arena_destroy
+ *
+ * @param arena The arena which is about to be destroyed.
+ */
+typedef void (* GCU_Arena_Cleanup)(GCU_Arena * arena);
+
+/**
+ * A position in an arena, to which it can be rewound.
+ */
+typedef struct {
+  GCU_Arena_Chunk * chunk;      ///< The chunk in use.
+  char * cursor;                ///< The next free byte of the chunk.
+} GCU_Arena_Mark;
+
+/**
+ * Container holding the information of the arena.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the arena is destroyed, the `cleanup`
+ * function will be called (if provided).
+ */
+typedef struct GCU_Arena {
+  size_t chunk_size;            ///< The size of a new chunk, in bytes.
+  GCU_Arena_Chunk * first;      ///< The chunks, in the order they are used.
+  GCU_Arena_Chunk * chunk;      ///< The chunk in use, or `NULL` before the first.
+  char * cursor;                ///< The next free byte of the chunk in use.
+  char * end;                   ///< The end of the chunk in use.
+  void * supplementary_data;    ///< User-defined.
+  GCU_Arena_Cleanup cleanup;    ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;            ///< Mutex for thread-safety.
+#endif
+} GCU_Arena;
+
+/**
+ * Create an arena.
+ *
+ * No memory is taken for chunks until the first allocation.
+ *
+ * All invocations of an arena must have a corresponding gcu_arena_destroy()
+ * call in order to clean up dynamically allocated memory.
+ *
+ * @param chunk_size The size of each chunk, in bytes, or `0` for
+ *   `GCU_ARENA_DEFAULT_CHUNK_SIZE`.  Allocations larger than this get a chunk
+ *   of their own.
+ * @return A pointer to the arena on success, `NULL` otherwise.
+ */
+GCU_Arena * gcu_arena_create(size_t chunk_size);
+
+/**
+ * Initialize an arena in memory owned by the programmer.
+ *
+ * @param arena The arena to initialize.
+ * @param chunk_size The size of each chunk, in bytes, or `0` for
+ *   `GCU_ARENA_DEFAULT_CHUNK_SIZE`.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_arena_create_in_place(GCU_Arena * arena, size_t chunk_size);
+
+/**
+ * Destroy an arena, freeing all of its chunks.
+ *
+ * @param arena The arena to destroy.
+ */
+void gcu_arena_destroy(GCU_Arena * arena);
+
+/**
+ * Destroy an arena which was initialized in place, without freeing the
+ * structure itself.
+ *
+ * @param arena The arena to destroy.
+ */
+void gcu_arena_destroy_in_place(GCU_Arena * arena);
+
+/**
+ * Allocate memory, aligned to `GCU_ARENA_ALIGNMENT`, from the arena.
+ *
+ * @param arena The arena from which to allocate.
+ * @param size The size of the memory, in bytes.
+ * @return The memory, or `NULL` on failure.
+ */
+void * gcu_arena_allocate(GCU_Arena * arena, size_t size);
+
+/**
+ * Allocate memory with a given alignment from the arena.
+ *
+ * @param arena The arena from which to allocate.
+ * @param size The size of the memory, in bytes.
+ * @param alignment The alignment, which must be a power of two.
+ * @return The memory, or `NULL` on failure.
+ */
+void * gcu_arena_allocate_aligned(GCU_Arena * arena, size_t size, size_t alignment);
+
+/**
+ * Grow (or shrink) memory from the arena, keeping its contents.
+ *
+ * If `pointer` is the most recent allocation, then it is grown in place when
+ * there is room.  Otherwise, the contents are copied to new memory, and the
+ * old memory is not reused until the arena is reset or rewound.
+ *
+ * @param arena The arena from which `pointer` was allocated.
+ * @param pointer The memory, or `NULL`.
+ * @param old_size The size with which the memory was allocated.
+ * @param new_size The size to which to grow the memory.
+ * @return The memory, or `NULL` on failure (in which case `pointer` is
+ *   unchanged).
+ */
+void * gcu_arena_reallocate(GCU_Arena * arena, void * pointer, size_t old_size, size_t new_size);
+
+/**
+ * Get the current position in the arena.
+ *
+ * @param arena The arena.
+ * @return A mark which may be passed to gcu_arena_rewind().
+ */
+GCU_Arena_Mark gcu_arena_mark(GCU_Arena * arena);
+
+/**
+ * Give back everything allocated from the arena since a mark was taken.
+ *
+ * The chunks are kept for reuse.  Marks taken after `mark` become invalid.
+ *
+ * @param arena The arena.
+ * @param mark A mark from gcu_arena_mark().
+ */
+void gcu_arena_rewind(GCU_Arena * arena, GCU_Arena_Mark mark);
+
+/**
+ * Give back everything allocated from the arena, in constant time.
+ *
+ * The chunks are kept for reuse.  All marks become invalid.
+ *
+ * @param arena The arena.
+ */
+void gcu_arena_reset(GCU_Arena * arena);
+
+/**
+ * Get the memory held by the arena's chunks.
+ *
+ * @param arena The arena.
+ * @return The total size of the chunks, in bytes.
+ */
+size_t gcu_arena_size(GCU_Arena * arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_ARENA_H
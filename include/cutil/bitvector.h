@@ -0,0 +1,243 @@
+/**
+ * @file
+ * A growable, bit-packed vector of booleans.
+ *
+ * Each boolean takes a single bit, packed into 64-bit words, so a bit vector
+ * is an eighth of the size of a GCU_Vector8 holding the same flags.  Whole
+ * bit vectors can be combined with AND, OR, XOR, and AND NOT a word (or, where
+ * the CPU supports it, a vector register) at a time, which makes them suitable
+ * for bitmap-index style filtering.
+ */
+
+#ifndef GHOTIIO_CUTIL_BITVECTOR_H
+#define GHOTIIO_CUTIL_BITVECTOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <cutil/libver.h>
+#include <cutil/mutex.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_BitVector_Cleanup GHOTIIO_CUTIL(GCU_BitVector_Cleanup)
+#define GCU_BitVector GHOTIIO_CUTIL(GCU_BitVector)
+#define gcu_bitvector_create GHOTIIO_CUTIL(gcu_bitvector_create)
+#define gcu_bitvector_create_in_place GHOTIIO_CUTIL(gcu_bitvector_create_in_place)
+#define gcu_bitvector_destroy GHOTIIO_CUTIL(gcu_bitvector_destroy)
+#define gcu_bitvector_destroy_in_place GHOTIIO_CUTIL(gcu_bitvector_destroy_in_place)
+#define gcu_bitvector_append GHOTIIO_CUTIL(gcu_bitvector_append)
+#define gcu_bitvector_count GHOTIIO_CUTIL(gcu_bitvector_count)
+#define gcu_bitvector_reserve GHOTIIO_CUTIL(gcu_bitvector_reserve)
+#define gcu_bitvector_resize GHOTIIO_CUTIL(gcu_bitvector_resize)
+#define gcu_bitvector_get GHOTIIO_CUTIL(gcu_bitvector_get)
+#define gcu_bitvector_set GHOTIIO_CUTIL(gcu_bitvector_set)
+#define gcu_bitvector_clear GHOTIIO_CUTIL(gcu_bitvector_clear)
+#define gcu_bitvector_popcount GHOTIIO_CUTIL(gcu_bitvector_popcount)
+#define gcu_bitvector_find_next_set GHOTIIO_CUTIL(gcu_bitvector_find_next_set)
+#define gcu_bitvector_and GHOTIIO_CUTIL(gcu_bitvector_and)
+#define gcu_bitvector_or GHOTIIO_CUTIL(gcu_bitvector_or)
+#define gcu_bitvector_xor GHOTIIO_CUTIL(gcu_bitvector_xor)
+#define gcu_bitvector_andnot GHOTIIO_CUTIL(gcu_bitvector_andnot)
+/// @endcond
+
+typedef struct GCU_BitVector GCU_BitVector;
+
+/**
+ * Pointer to a function which will be called when the bit vector destroy
+ * function is called.
+ *
+ * @ref gcu_bitvector_destroy
+ *
+ * @param vector The bit vector which is about to be destroyed.
+ */
+typedef void (* GCU_BitVector_Cleanup)(GCU_BitVector * vector);
+
+/**
+ * Container holding the information of the bit vector.
+ *
+ * Bit `i` is stored in `data[i / 64]`, at position `i % 64`.  Every bit of
+ * `data` past the first `count` bits is always zero.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the vector is destroyed, the `cleanup`
+ * function will be called (if provided).
+ */
+typedef struct GCU_BitVector {
+  size_t capacity;               ///< The total bit capacity of the vector.
+  size_t count;                  ///< The number of bits in the vector.
+  uint64_t * data;               ///< A pointer to the array of words.
+  void * supplementary_data;     ///< User-defined.
+  GCU_BitVector_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;             ///< Mutex for thread-safety.
+#endif
+} GCU_BitVector;
+
+/**
+ * Create a bit vector.
+ *
+ * All invocations of a bit vector must have a corresponding
+ * gcu_bitvector_destroy() call in order to clean up dynamically-allocated
+ * memory.
+ *
+ * @param count The number of bits anticipated to be stored in the vector.
+ * @return A pointer to the vector on success, `NULL` otherwise.
+ */
+GCU_BitVector * gcu_bitvector_create(size_t count);
+
+/**
+ * Initialize a bit vector in memory owned by the programmer.
+ *
+ * @param vector The vector to initialize.
+ * @param count The number of bits anticipated to be stored in the vector.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_bitvector_create_in_place(GCU_BitVector * vector, size_t count);
+
+/**
+ * Destroy a bit vector and free its memory.
+ *
+ * @param vector The vector to destroy.
+ */
+void gcu_bitvector_destroy(GCU_BitVector * vector);
+
+/**
+ * Destroy a bit vector which was initialized with
+ * gcu_bitvector_create_in_place(), without freeing the vector structure
+ * itself.
+ *
+ * @param vector The vector to destroy.
+ */
+void gcu_bitvector_destroy_in_place(GCU_BitVector * vector);
+
+/**
+ * Append a bit to the end of the vector.
+ *
+ * @param vector The vector on which to operate.
+ * @param value The value of the bit.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_bitvector_append(GCU_BitVector * vector, bool value);
+
+/**
+ * Get the number of bits in the vector.
+ *
+ * @param vector The vector on which to operate.
+ * @return The number of bits.
+ */
+size_t gcu_bitvector_count(GCU_BitVector * vector);
+
+/**
+ * Reserve room for a number of bits.
+ *
+ * @param vector The vector on which to operate.
+ * @param count The number of bits.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_bitvector_reserve(GCU_BitVector * vector, size_t count);
+
+/**
+ * Change the number of bits in the vector.  Bits added to the end are clear.
+ *
+ * @param vector The vector on which to operate.
+ * @param count The new number of bits.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_bitvector_resize(GCU_BitVector * vector, size_t count);
+
+/**
+ * Get the value of a bit.
+ *
+ * @param vector The vector on which to operate.
+ * @param index The position of the bit.
+ * @return The value of the bit, or `false` if `index` is out of range.
+ */
+bool gcu_bitvector_get(GCU_BitVector * vector, size_t index);
+
+/**
+ * Set a bit to `true`.
+ *
+ * @param vector The vector on which to operate.
+ * @param index The position of the bit.
+ * @return `true` on success, `false` if `index` is out of range.
+ */
+bool gcu_bitvector_set(GCU_BitVector * vector, size_t index);
+
+/**
+ * Set a bit to `false`.
+ *
+ * @param vector The vector on which to operate.
+ * @param index The position of the bit.
+ * @return `true` on success, `false` if `index` is out of range.
+ */
+bool gcu_bitvector_clear(GCU_BitVector * vector, size_t index);
+
+/**
+ * Count the bits which are set.
+ *
+ * @param vector The vector on which to operate.
+ * @return The number of bits which are `true`.
+ */
+size_t gcu_bitvector_popcount(GCU_BitVector * vector);
+
+/**
+ * Find the first bit which is set, at or after a position.
+ *
+ * All of the set bits can be visited with:
+ *
+ * ```C
+ * for (size_t i = gcu_bitvector_find_next_set(v, 0); i < v->count; i = gcu_bitvector_find_next_set(v, i + 1)) {}
+ * ```
+ *
+ * @param vector The vector on which to operate.
+ * @param index The position at which to start looking.
+ * @return The position of the bit, or the number of bits if there is none.
+ */
+size_t gcu_bitvector_find_next_set(GCU_BitVector * vector, size_t index);
+
+/**
+ * Replace `destination` with `destination AND source`.
+ *
+ * In this and the other bulk operations, `source` is treated as if it were
+ * padded with clear bits to the length of `destination`, and the length of
+ * `destination` does not change.
+ *
+ * @param destination The vector to modify.
+ * @param source The other operand.
+ */
+void gcu_bitvector_and(GCU_BitVector * destination, GCU_BitVector * source);
+
+/**
+ * Replace `destination` with `destination OR source`.
+ *
+ * @param destination The vector to modify.
+ * @param source The other operand.
+ */
+void gcu_bitvector_or(GCU_BitVector * destination, GCU_BitVector * source);
+
+/**
+ * Replace `destination` with `destination XOR source`.
+ *
+ * @param destination The vector to modify.
+ * @param source The other operand.
+ */
+void gcu_bitvector_xor(GCU_BitVector * destination, GCU_BitVector * source);
+
+/**
+ * Replace `destination` with `destination AND NOT source`, which clears every
+ * bit of `destination` that is set in `source`.
+ *
+ * @param destination The vector to modify.
+ * @param source The other operand.
+ */
+void gcu_bitvector_andnot(GCU_BitVector * destination, GCU_BitVector * source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_BITVECTOR_H
@@ -0,0 +1,177 @@
+/**
+ * @file
+ * Memory budgets, with callbacks for when memory runs short.
+ *
+ * A budget is an allocator (see memory.h) which passes each call on to
+ * another allocator, its parent, while keeping count of the bytes which it
+ * has handed out and not yet had back.  An allocation which would take the
+ * count past the budget's limit fails, returning `NULL`, so that a container
+ * which would grow past it fails cleanly (gcu_hash64_set() and
+ * gcu_vector64_append() return `false`, leaving the container as it was),
+ * rather than the process being killed for running out of memory.
+ *
+ * A budget may be applied to the whole process, or to a group of containers:
+ *
+ *     // Every call to gcu_malloc() and the other memory functions.
+ *     GCU_Budget * process = gcu_budget_create(0, 512 << 20, 384 << 20);
+ *     gcu_set_allocator(gcu_budget_allocator(process));
+ *
+ *     // Only the containers which are given it, through their growth policy.
+ *     // It is charged to the budget of the process too, as its parent.
+ *     GCU_Budget * cache = gcu_budget_create(gcu_budget_allocator(process), 64 << 20, 48 << 20);
+ *     GCU_Growth growth = {0};
+ *     growth.allocator = gcu_budget_allocator(cache);
+ *     gcu_hash64_set_growth(table, growth);
+ *
+ * Callbacks added with gcu_budget_add_pressure_callback() are called when
+ * the bytes in use first reach the soft limit, and again whenever an
+ * allocation would pass the hard limit, before it is refused, so that caches
+ * can evict or compact, and the allocation can go ahead if they free enough.
+ *
+ * Storage which does not come from an allocator is not charged: that of
+ * arenas (although their chunks are), of containers whose growth policy asks
+ * for an alignment or for huge pages, and of gcu_aligned_alloc().  Blocks
+ * allocated before a budget was installed with gcu_set_allocator() may be
+ * freed through it, but are not subtracted past zero.
+ *
+ * The budget is opaque, and must be created with gcu_budget_create().
+ */
+
+#ifndef GHOTIIO_CUTIL_BUDGET_H
+#define GHOTIIO_CUTIL_BUDGET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <cutil/libver.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_Allocator GHOTIIO_CUTIL(GCU_Allocator)
+#define GCU_Budget GHOTIIO_CUTIL(GCU_Budget)
+#define GCU_Budget_Pressure GHOTIIO_CUTIL(GCU_Budget_Pressure)
+#define gcu_budget_create GHOTIIO_CUTIL(gcu_budget_create)
+#define gcu_budget_destroy GHOTIIO_CUTIL(gcu_budget_destroy)
+#define gcu_budget_allocator GHOTIIO_CUTIL(gcu_budget_allocator)
+#define gcu_budget_set_limits GHOTIIO_CUTIL(gcu_budget_set_limits)
+#define gcu_budget_add_pressure_callback GHOTIIO_CUTIL(gcu_budget_add_pressure_callback)
+#define gcu_budget_used GHOTIIO_CUTIL(gcu_budget_used)
+#define gcu_budget_peak GHOTIIO_CUTIL(gcu_budget_peak)
+#define gcu_budget_failures GHOTIIO_CUTIL(gcu_budget_failures)
+/// @endcond
+
+/**
+ * The most pressure callbacks which one budget can have.
+ */
+#define GCU_BUDGET_CALLBACKS 8
+
+struct GCU_Allocator;
+typedef struct GCU_Budget GCU_Budget;
+
+/**
+ * Pointer to a function which will be called when a budget runs short of
+ * memory.
+ *
+ * It may free memory charged to the budget.  Any allocation it makes from the
+ * budget is refused if over the hard limit, without calling the callbacks
+ * again.
+ *
+ * @param budget The budget.
+ * @param used The bytes in use.
+ * @param context The context given to gcu_budget_add_pressure_callback().
+ */
+typedef void (* GCU_Budget_Pressure)(GCU_Budget * budget, size_t used, void * context);
+
+/**
+ * Create a memory budget.
+ *
+ * The budget itself is allocated from its parent, and is not charged to
+ * itself.
+ *
+ * @param parent The allocator from which to allocate, which must be able to
+ *   give the size of its blocks, or `NULL` for the system's.
+ * @param limit The most bytes which may be in use (the hard limit), or 0 for
+ *   no limit.
+ * @param soft_limit The bytes in use at which to call the pressure callbacks,
+ *   or 0 to call them only at the hard limit.
+ * @return A pointer to the budget on success, `NULL` otherwise.
+ */
+GCU_Budget * gcu_budget_create(const struct GCU_Allocator * parent, size_t limit, size_t soft_limit);
+
+/**
+ * Destroy a memory budget.
+ *
+ * Memory allocated from the budget must all have been freed, and the budget
+ * must no longer be the allocator of gcu_malloc() or of any container.
+ *
+ * @param budget The budget to destroy.
+ */
+void gcu_budget_destroy(GCU_Budget * budget);
+
+/**
+ * Get the allocator which charges a budget, to pass to gcu_set_allocator()
+ * or to set as the `allocator` of a growth policy.
+ *
+ * @param budget The budget.
+ * @return The allocator, which lasts as long as the budget.
+ */
+const struct GCU_Allocator * gcu_budget_allocator(GCU_Budget * budget);
+
+/**
+ * Change the limits of a budget, for instance when the memory limit of the
+ * process changes.
+ *
+ * Memory already in use is not affected, even if it is over the new limit.
+ *
+ * @param budget The budget.
+ * @param limit The most bytes which may be in use, or 0 for no limit.
+ * @param soft_limit The bytes in use at which to call the pressure
+ *   callbacks, or 0 to call them only at the hard limit.
+ */
+void gcu_budget_set_limits(GCU_Budget * budget, size_t limit, size_t soft_limit);
+
+/**
+ * Add a function to call when a budget runs short of memory.
+ *
+ * @param budget The budget.
+ * @param callback The function.
+ * @param context An argument to pass to the function.
+ * @return `true` on success, `false` if the budget has
+ *   `GCU_BUDGET_CALLBACKS` callbacks already.
+ */
+bool gcu_budget_add_pressure_callback(GCU_Budget * budget, GCU_Budget_Pressure callback, void * context);
+
+/**
+ * Get the number of bytes charged to a budget.
+ *
+ * Each block is charged at the size which the parent reports for it, which
+ * may be a little more than was requested.
+ *
+ * @param budget The budget.
+ * @return The bytes in use.
+ */
+size_t gcu_budget_used(GCU_Budget * budget);
+
+/**
+ * Get the most bytes which have been charged to a budget at once.
+ *
+ * @param budget The budget.
+ * @return The peak of gcu_budget_used().
+ */
+size_t gcu_budget_peak(GCU_Budget * budget);
+
+/**
+ * Get the number of allocations which a budget has refused.
+ *
+ * @param budget The budget.
+ * @return The allocations refused for passing the hard limit.
+ */
+size_t gcu_budget_failures(GCU_Budget * budget);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_BUDGET_H
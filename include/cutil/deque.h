@@ -0,0 +1,1481 @@
+/**
+ * @file
+ * A fixed-capacity ring buffer and a growable double-ended queue.
+ *
+ * Both containers store their values in a circular buffer whose capacity is a
+ * power of two, so that positions wrap around with a mask rather than a
+ * division.  Values can be pushed and popped at either end in constant time,
+ * and a block of values can be pushed or popped with at most two `memcpy()`
+ * calls (one on each side of the wrap).  Popping never moves the other values
+ * and never releases memory, so a queue that is filled and drained at the same
+ * rate does not allocate once it has reached its working size.
+ *
+ * A ring buffer (e.g., GCU_Ring64) never reallocates: pushing to a full ring
+ * fails.  A deque (e.g., GCU_Deque64) doubles its capacity when it is full.
+ *
+ * Like vectors, both are generated for `8`, `16`, `32`, and `64`-bit values,
+ * and have a `mutex` member unless the library was built with
+ * `GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX`.  It is the programmer's
+ * responsibility to use it when appropriate.
+ */
+
+#ifndef GHOTIIO_CUTIL_DEQUE_H
+#define GHOTIIO_CUTIL_DEQUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <cutil/mutex.h>
+#include <cutil/type.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_Ring64_Cleanup GHOTIIO_CUTIL(GCU_Ring64_Cleanup)
+#define GCU_Ring64_Value GHOTIIO_CUTIL(GCU_Ring64_Value)
+#define GCU_Ring64 GHOTIIO_CUTIL(GCU_Ring64)
+#define gcu_ring64_create GHOTIIO_CUTIL(gcu_ring64_create)
+#define gcu_ring64_create_in_place GHOTIIO_CUTIL(gcu_ring64_create_in_place)
+#define gcu_ring64_destroy GHOTIIO_CUTIL(gcu_ring64_destroy)
+#define gcu_ring64_destroy_in_place GHOTIIO_CUTIL(gcu_ring64_destroy_in_place)
+#define gcu_ring64_push_back GHOTIIO_CUTIL(gcu_ring64_push_back)
+#define gcu_ring64_push_front GHOTIIO_CUTIL(gcu_ring64_push_front)
+#define gcu_ring64_pop_back GHOTIIO_CUTIL(gcu_ring64_pop_back)
+#define gcu_ring64_pop_front GHOTIIO_CUTIL(gcu_ring64_pop_front)
+#define gcu_ring64_push_many GHOTIIO_CUTIL(gcu_ring64_push_many)
+#define gcu_ring64_pop_many GHOTIIO_CUTIL(gcu_ring64_pop_many)
+#define gcu_ring64_get GHOTIIO_CUTIL(gcu_ring64_get)
+#define gcu_ring64_count GHOTIIO_CUTIL(gcu_ring64_count)
+
+#define GCU_Ring32_Cleanup GHOTIIO_CUTIL(GCU_Ring32_Cleanup)
+#define GCU_Ring32_Value GHOTIIO_CUTIL(GCU_Ring32_Value)
+#define GCU_Ring32 GHOTIIO_CUTIL(GCU_Ring32)
+#define gcu_ring32_create GHOTIIO_CUTIL(gcu_ring32_create)
+#define gcu_ring32_create_in_place GHOTIIO_CUTIL(gcu_ring32_create_in_place)
+#define gcu_ring32_destroy GHOTIIO_CUTIL(gcu_ring32_destroy)
+#define gcu_ring32_destroy_in_place GHOTIIO_CUTIL(gcu_ring32_destroy_in_place)
+#define gcu_ring32_push_back GHOTIIO_CUTIL(gcu_ring32_push_back)
+#define gcu_ring32_push_front GHOTIIO_CUTIL(gcu_ring32_push_front)
+#define gcu_ring32_pop_back GHOTIIO_CUTIL(gcu_ring32_pop_back)
+#define gcu_ring32_pop_front GHOTIIO_CUTIL(gcu_ring32_pop_front)
+#define gcu_ring32_push_many GHOTIIO_CUTIL(gcu_ring32_push_many)
+#define gcu_ring32_pop_many GHOTIIO_CUTIL(gcu_ring32_pop_many)
+#define gcu_ring32_get GHOTIIO_CUTIL(gcu_ring32_get)
+#define gcu_ring32_count GHOTIIO_CUTIL(gcu_ring32_count)
+
+#define GCU_Ring16_Cleanup GHOTIIO_CUTIL(GCU_Ring16_Cleanup)
+#define GCU_Ring16_Value GHOTIIO_CUTIL(GCU_Ring16_Value)
+#define GCU_Ring16 GHOTIIO_CUTIL(GCU_Ring16)
+#define gcu_ring16_create GHOTIIO_CUTIL(gcu_ring16_create)
+#define gcu_ring16_create_in_place GHOTIIO_CUTIL(gcu_ring16_create_in_place)
+#define gcu_ring16_destroy GHOTIIO_CUTIL(gcu_ring16_destroy)
+#define gcu_ring16_destroy_in_place GHOTIIO_CUTIL(gcu_ring16_destroy_in_place)
+#define gcu_ring16_push_back GHOTIIO_CUTIL(gcu_ring16_push_back)
+#define gcu_ring16_push_front GHOTIIO_CUTIL(gcu_ring16_push_front)
+#define gcu_ring16_pop_back GHOTIIO_CUTIL(gcu_ring16_pop_back)
+#define gcu_ring16_pop_front GHOTIIO_CUTIL(gcu_ring16_pop_front)
+#define gcu_ring16_push_many GHOTIIO_CUTIL(gcu_ring16_push_many)
+#define gcu_ring16_pop_many GHOTIIO_CUTIL(gcu_ring16_pop_many)
+#define gcu_ring16_get GHOTIIO_CUTIL(gcu_ring16_get)
+#define gcu_ring16_count GHOTIIO_CUTIL(gcu_ring16_count)
+
+#define GCU_Ring8_Cleanup GHOTIIO_CUTIL(GCU_Ring8_Cleanup)
+#define GCU_Ring8_Value GHOTIIO_CUTIL(GCU_Ring8_Value)
+#define GCU_Ring8 GHOTIIO_CUTIL(GCU_Ring8)
+#define gcu_ring8_create GHOTIIO_CUTIL(gcu_ring8_create)
+#define gcu_ring8_create_in_place GHOTIIO_CUTIL(gcu_ring8_create_in_place)
+#define gcu_ring8_destroy GHOTIIO_CUTIL(gcu_ring8_destroy)
+#define gcu_ring8_destroy_in_place GHOTIIO_CUTIL(gcu_ring8_destroy_in_place)
+#define gcu_ring8_push_back GHOTIIO_CUTIL(gcu_ring8_push_back)
+#define gcu_ring8_push_front GHOTIIO_CUTIL(gcu_ring8_push_front)
+#define gcu_ring8_pop_back GHOTIIO_CUTIL(gcu_ring8_pop_back)
+#define gcu_ring8_pop_front GHOTIIO_CUTIL(gcu_ring8_pop_front)
+#define gcu_ring8_push_many GHOTIIO_CUTIL(gcu_ring8_push_many)
+#define gcu_ring8_pop_many GHOTIIO_CUTIL(gcu_ring8_pop_many)
+#define gcu_ring8_get GHOTIIO_CUTIL(gcu_ring8_get)
+#define gcu_ring8_count GHOTIIO_CUTIL(gcu_ring8_count)
+
+#define GCU_Deque64_Cleanup GHOTIIO_CUTIL(GCU_Deque64_Cleanup)
+#define GCU_Deque64_Value GHOTIIO_CUTIL(GCU_Deque64_Value)
+#define GCU_Deque64 GHOTIIO_CUTIL(GCU_Deque64)
+#define gcu_deque64_create GHOTIIO_CUTIL(gcu_deque64_create)
+#define gcu_deque64_create_in_place GHOTIIO_CUTIL(gcu_deque64_create_in_place)
+#define gcu_deque64_destroy GHOTIIO_CUTIL(gcu_deque64_destroy)
+#define gcu_deque64_destroy_in_place GHOTIIO_CUTIL(gcu_deque64_destroy_in_place)
+#define gcu_deque64_push_back GHOTIIO_CUTIL(gcu_deque64_push_back)
+#define gcu_deque64_push_front GHOTIIO_CUTIL(gcu_deque64_push_front)
+#define gcu_deque64_pop_back GHOTIIO_CUTIL(gcu_deque64_pop_back)
+#define gcu_deque64_pop_front GHOTIIO_CUTIL(gcu_deque64_pop_front)
+#define gcu_deque64_push_many GHOTIIO_CUTIL(gcu_deque64_push_many)
+#define gcu_deque64_pop_many GHOTIIO_CUTIL(gcu_deque64_pop_many)
+#define gcu_deque64_get GHOTIIO_CUTIL(gcu_deque64_get)
+#define gcu_deque64_count GHOTIIO_CUTIL(gcu_deque64_count)
+#define gcu_deque64_reserve GHOTIIO_CUTIL(gcu_deque64_reserve)
+
+#define GCU_Deque32_Cleanup GHOTIIO_CUTIL(GCU_Deque32_Cleanup)
+#define GCU_Deque32_Value GHOTIIO_CUTIL(GCU_Deque32_Value)
+#define GCU_Deque32 GHOTIIO_CUTIL(GCU_Deque32)
+#define gcu_deque32_create GHOTIIO_CUTIL(gcu_deque32_create)
+#define gcu_deque32_create_in_place GHOTIIO_CUTIL(gcu_deque32_create_in_place)
+#define gcu_deque32_destroy GHOTIIO_CUTIL(gcu_deque32_destroy)
+#define gcu_deque32_destroy_in_place GHOTIIO_CUTIL(gcu_deque32_destroy_in_place)
+#define gcu_deque32_push_back GHOTIIO_CUTIL(gcu_deque32_push_back)
+#define gcu_deque32_push_front GHOTIIO_CUTIL(gcu_deque32_push_front)
+#define gcu_deque32_pop_back GHOTIIO_CUTIL(gcu_deque32_pop_back)
+#define gcu_deque32_pop_front GHOTIIO_CUTIL(gcu_deque32_pop_front)
+#define gcu_deque32_push_many GHOTIIO_CUTIL(gcu_deque32_push_many)
+#define gcu_deque32_pop_many GHOTIIO_CUTIL(gcu_deque32_pop_many)
+#define gcu_deque32_get GHOTIIO_CUTIL(gcu_deque32_get)
+#define gcu_deque32_count GHOTIIO_CUTIL(gcu_deque32_count)
+#define gcu_deque32_reserve GHOTIIO_CUTIL(gcu_deque32_reserve)
+
+#define GCU_Deque16_Cleanup GHOTIIO_CUTIL(GCU_Deque16_Cleanup)
+#define GCU_Deque16_Value GHOTIIO_CUTIL(GCU_Deque16_Value)
+#define GCU_Deque16 GHOTIIO_CUTIL(GCU_Deque16)
+#define gcu_deque16_create GHOTIIO_CUTIL(gcu_deque16_create)
+#define gcu_deque16_create_in_place GHOTIIO_CUTIL(gcu_deque16_create_in_place)
+#define gcu_deque16_destroy GHOTIIO_CUTIL(gcu_deque16_destroy)
+#define gcu_deque16_destroy_in_place GHOTIIO_CUTIL(gcu_deque16_destroy_in_place)
+#define gcu_deque16_push_back GHOTIIO_CUTIL(gcu_deque16_push_back)
+#define gcu_deque16_push_front GHOTIIO_CUTIL(gcu_deque16_push_front)
+#define gcu_deque16_pop_back GHOTIIO_CUTIL(gcu_deque16_pop_back)
+#define gcu_deque16_pop_front GHOTIIO_CUTIL(gcu_deque16_pop_front)
+#define gcu_deque16_push_many GHOTIIO_CUTIL(gcu_deque16_push_many)
+#define gcu_deque16_pop_many GHOTIIO_CUTIL(gcu_deque16_pop_many)
+#define gcu_deque16_get GHOTIIO_CUTIL(gcu_deque16_get)
+#define gcu_deque16_count GHOTIIO_CUTIL(gcu_deque16_count)
+#define gcu_deque16_reserve GHOTIIO_CUTIL(gcu_deque16_reserve)
+
+#define GCU_Deque8_Cleanup GHOTIIO_CUTIL(GCU_Deque8_Cleanup)
+#define GCU_Deque8_Value GHOTIIO_CUTIL(GCU_Deque8_Value)
+#define GCU_Deque8 GHOTIIO_CUTIL(GCU_Deque8)
+#define gcu_deque8_create GHOTIIO_CUTIL(gcu_deque8_create)
+#define gcu_deque8_create_in_place GHOTIIO_CUTIL(gcu_deque8_create_in_place)
+#define gcu_deque8_destroy GHOTIIO_CUTIL(gcu_deque8_destroy)
+#define gcu_deque8_destroy_in_place GHOTIIO_CUTIL(gcu_deque8_destroy_in_place)
+#define gcu_deque8_push_back GHOTIIO_CUTIL(gcu_deque8_push_back)
+#define gcu_deque8_push_front GHOTIIO_CUTIL(gcu_deque8_push_front)
+#define gcu_deque8_pop_back GHOTIIO_CUTIL(gcu_deque8_pop_back)
+#define gcu_deque8_pop_front GHOTIIO_CUTIL(gcu_deque8_pop_front)
+#define gcu_deque8_push_many GHOTIIO_CUTIL(gcu_deque8_push_many)
+#define gcu_deque8_pop_many GHOTIIO_CUTIL(gcu_deque8_pop_many)
+#define gcu_deque8_get GHOTIIO_CUTIL(gcu_deque8_get)
+#define gcu_deque8_count GHOTIIO_CUTIL(gcu_deque8_count)
+#define gcu_deque8_reserve GHOTIIO_CUTIL(gcu_deque8_reserve)
+/// @endcond
+
+typedef struct GCU_Ring64 GCU_Ring64;
+typedef struct GCU_Ring32 GCU_Ring32;
+typedef struct GCU_Ring16 GCU_Ring16;
+typedef struct GCU_Ring8 GCU_Ring8;
+typedef struct GCU_Deque64 GCU_Deque64;
+typedef struct GCU_Deque32 GCU_Deque32;
+typedef struct GCU_Deque16 GCU_Deque16;
+typedef struct GCU_Deque8 GCU_Deque8;
+
+/**
+ * Pointer to a function which will be called when the ring buffer destroy
+ * function is called.
+ *
+ * @ref gcu_ring64_destroy
+ *
+ * @param ring The ring buffer which is about to be destroyed.
+ */
+typedef void (* GCU_Ring64_Cleanup)(GCU_Ring64 * ring);
+
+/**
+ * The result of reading or popping a value from a ring buffer.
+ */
+typedef struct {
+  bool exists;            ///< Whether or not there was a value.
+  GCU_Type64_Union value; ///< The value (if it exists).
+} GCU_Ring64_Value;
+
+/**
+ * Container holding the information of the 64-bit ring buffer.
+ *
+ * The values are `data[(head + i) & (capacity - 1)]` for `i` in
+ * `[0, count)`.  `capacity` is a power of two and never changes.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the ring buffer is destroyed, the
+ * `cleanup` function will be called (if provided).
+ */
+typedef struct GCU_Ring64 {
+  size_t capacity;            ///< The number of values that fit in `data`.
+  size_t head;                ///< The position of the first value in `data`.
+  size_t count;               ///< The number of values.
+  GCU_Type64_Union * data;    ///< The circular buffer of values.
+  void * supplementary_data;  ///< User-defined.
+  GCU_Ring64_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;          ///< Mutex for thread-safety.
+#endif
+} GCU_Ring64;
+
+/**
+ * Create a ring buffer.
+ *
+ * All invocations of a ring buffer must have a corresponding
+ * gcu_ring64_destroy() call in order to clean up dynamically-allocated memory.
+ *
+ * @param capacity The number of values that the ring buffer must hold.  It is
+ *   rounded up to a power of two.
+ * @return A pointer to the ring buffer on success, `NULL` otherwise.
+ */
+GCU_Ring64 * gcu_ring64_create(size_t capacity);
+
+/**
+ * Initialize a ring buffer in memory owned by the programmer.
+ *
+ * @param ring The ring buffer to initialize.
+ * @param capacity The number of values that the ring buffer must hold.  It is
+ *   rounded up to a power of two.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_ring64_create_in_place(GCU_Ring64 * ring, size_t capacity);
+
+/**
+ * Destroy a ring buffer and free its memory.
+ *
+ * @param ring The ring buffer to destroy.
+ */
+void gcu_ring64_destroy(GCU_Ring64 * ring);
+
+/**
+ * Destroy a ring buffer which was initialized with gcu_ring64_create_in_place(),
+ * without freeing the ring buffer structure itself.
+ *
+ * @param ring The ring buffer to destroy.
+ */
+void gcu_ring64_destroy_in_place(GCU_Ring64 * ring);
+
+/**
+ * Add a value after the last value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the ring buffer is full.
+ */
+bool gcu_ring64_push_back(GCU_Ring64 * ring, GCU_Type64_Union value);
+
+/**
+ * Add a value before the first value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the ring buffer is full.
+ */
+bool gcu_ring64_push_front(GCU_Ring64 * ring, GCU_Type64_Union value);
+
+/**
+ * Remove the last value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @return The value, if the ring buffer was not empty.
+ */
+GCU_Ring64_Value gcu_ring64_pop_back(GCU_Ring64 * ring);
+
+/**
+ * Remove the first value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @return The value, if the ring buffer was not empty.
+ */
+GCU_Ring64_Value gcu_ring64_pop_front(GCU_Ring64 * ring);
+
+/**
+ * Add a block of values after the last value.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param values The values, in order.
+ * @param count The number of values.
+ * @return `true` on success, `false` if there is not room for all of the
+ *   values (in which case none of them are added).
+ */
+bool gcu_ring64_push_many(GCU_Ring64 * ring, const GCU_Type64_Union * values, size_t count);
+
+/**
+ * Remove a block of values from the front.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param values The array which receives the values, in order.
+ * @param count The largest number of values to remove.
+ * @return The number of values removed, which is less than `count` if the
+ *   ring buffer holds fewer values.
+ */
+size_t gcu_ring64_pop_many(GCU_Ring64 * ring, GCU_Type64_Union * values, size_t count);
+
+/**
+ * Get a value by its position from the front.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param index The position, where `0` is the first value.
+ * @return The value, if the position is less than the count.
+ */
+GCU_Ring64_Value gcu_ring64_get(GCU_Ring64 * ring, size_t index);
+
+/**
+ * Get the number of values in the ring buffer.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @return The number of values.
+ */
+size_t gcu_ring64_count(GCU_Ring64 * ring);
+
+/**
+ * Pointer to a function which will be called when the ring buffer destroy
+ * function is called.
+ *
+ * @ref gcu_ring32_destroy
+ *
+ * @param ring The ring buffer which is about to be destroyed.
+ */
+typedef void (* GCU_Ring32_Cleanup)(GCU_Ring32 * ring);
+
+/**
+ * The result of reading or popping a value from a ring buffer.
+ */
+typedef struct {
+  bool exists;            ///< Whether or not there was a value.
+  GCU_Type32_Union value; ///< The value (if it exists).
+} GCU_Ring32_Value;
+
+/**
+ * Container holding the information of the 32-bit ring buffer.
+ *
+ * The values are `data[(head + i) & (capacity - 1)]` for `i` in
+ * `[0, count)`.  `capacity` is a power of two and never changes.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the ring buffer is destroyed, the
+ * `cleanup` function will be called (if provided).
+ */
+typedef struct GCU_Ring32 {
+  size_t capacity;            ///< The number of values that fit in `data`.
+  size_t head;                ///< The position of the first value in `data`.
+  size_t count;               ///< The number of values.
+  GCU_Type32_Union * data;    ///< The circular buffer of values.
+  void * supplementary_data;  ///< User-defined.
+  GCU_Ring32_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;          ///< Mutex for thread-safety.
+#endif
+} GCU_Ring32;
+
+/**
+ * Create a ring buffer.
+ *
+ * All invocations of a ring buffer must have a corresponding
+ * gcu_ring32_destroy() call in order to clean up dynamically-allocated memory.
+ *
+ * @param capacity The number of values that the ring buffer must hold.  It is
+ *   rounded up to a power of two.
+ * @return A pointer to the ring buffer on success, `NULL` otherwise.
+ */
+GCU_Ring32 * gcu_ring32_create(size_t capacity);
+
+/**
+ * Initialize a ring buffer in memory owned by the programmer.
+ *
+ * @param ring The ring buffer to initialize.
+ * @param capacity The number of values that the ring buffer must hold.  It is
+ *   rounded up to a power of two.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_ring32_create_in_place(GCU_Ring32 * ring, size_t capacity);
+
+/**
+ * Destroy a ring buffer and free its memory.
+ *
+ * @param ring The ring buffer to destroy.
+ */
+void gcu_ring32_destroy(GCU_Ring32 * ring);
+
+/**
+ * Destroy a ring buffer which was initialized with gcu_ring32_create_in_place(),
+ * without freeing the ring buffer structure itself.
+ *
+ * @param ring The ring buffer to destroy.
+ */
+void gcu_ring32_destroy_in_place(GCU_Ring32 * ring);
+
+/**
+ * Add a value after the last value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the ring buffer is full.
+ */
+bool gcu_ring32_push_back(GCU_Ring32 * ring, GCU_Type32_Union value);
+
+/**
+ * Add a value before the first value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the ring buffer is full.
+ */
+bool gcu_ring32_push_front(GCU_Ring32 * ring, GCU_Type32_Union value);
+
+/**
+ * Remove the last value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @return The value, if the ring buffer was not empty.
+ */
+GCU_Ring32_Value gcu_ring32_pop_back(GCU_Ring32 * ring);
+
+/**
+ * Remove the first value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @return The value, if the ring buffer was not empty.
+ */
+GCU_Ring32_Value gcu_ring32_pop_front(GCU_Ring32 * ring);
+
+/**
+ * Add a block of values after the last value.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param values The values, in order.
+ * @param count The number of values.
+ * @return `true` on success, `false` if there is not room for all of the
+ *   values (in which case none of them are added).
+ */
+bool gcu_ring32_push_many(GCU_Ring32 * ring, const GCU_Type32_Union * values, size_t count);
+
+/**
+ * Remove a block of values from the front.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param values The array which receives the values, in order.
+ * @param count The largest number of values to remove.
+ * @return The number of values removed, which is less than `count` if the
+ *   ring buffer holds fewer values.
+ */
+size_t gcu_ring32_pop_many(GCU_Ring32 * ring, GCU_Type32_Union * values, size_t count);
+
+/**
+ * Get a value by its position from the front.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param index The position, where `0` is the first value.
+ * @return The value, if the position is less than the count.
+ */
+GCU_Ring32_Value gcu_ring32_get(GCU_Ring32 * ring, size_t index);
+
+/**
+ * Get the number of values in the ring buffer.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @return The number of values.
+ */
+size_t gcu_ring32_count(GCU_Ring32 * ring);
+
+/**
+ * Pointer to a function which will be called when the ring buffer destroy
+ * function is called.
+ *
+ * @ref gcu_ring16_destroy
+ *
+ * @param ring The ring buffer which is about to be destroyed.
+ */
+typedef void (* GCU_Ring16_Cleanup)(GCU_Ring16 * ring);
+
+/**
+ * The result of reading or popping a value from a ring buffer.
+ */
+typedef struct {
+  bool exists;            ///< Whether or not there was a value.
+  GCU_Type16_Union value; ///< The value (if it exists).
+} GCU_Ring16_Value;
+
+/**
+ * Container holding the information of the 16-bit ring buffer.
+ *
+ * The values are `data[(head + i) & (capacity - 1)]` for `i` in
+ * `[0, count)`.  `capacity` is a power of two and never changes.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the ring buffer is destroyed, the
+ * `cleanup` function will be called (if provided).
+ */
+typedef struct GCU_Ring16 {
+  size_t capacity;            ///< The number of values that fit in `data`.
+  size_t head;                ///< The position of the first value in `data`.
+  size_t count;               ///< The number of values.
+  GCU_Type16_Union * data;    ///< The circular buffer of values.
+  void * supplementary_data;  ///< User-defined.
+  GCU_Ring16_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;          ///< Mutex for thread-safety.
+#endif
+} GCU_Ring16;
+
+/**
+ * Create a ring buffer.
+ *
+ * All invocations of a ring buffer must have a corresponding
+ * gcu_ring16_destroy() call in order to clean up dynamically-allocated memory.
+ *
+ * @param capacity The number of values that the ring buffer must hold.  It is
+ *   rounded up to a power of two.
+ * @return A pointer to the ring buffer on success, `NULL` otherwise.
+ */
+GCU_Ring16 * gcu_ring16_create(size_t capacity);
+
+/**
+ * Initialize a ring buffer in memory owned by the programmer.
+ *
+ * @param ring The ring buffer to initialize.
+ * @param capacity The number of values that the ring buffer must hold.  It is
+ *   rounded up to a power of two.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_ring16_create_in_place(GCU_Ring16 * ring, size_t capacity);
+
+/**
+ * Destroy a ring buffer and free its memory.
+ *
+ * @param ring The ring buffer to destroy.
+ */
+void gcu_ring16_destroy(GCU_Ring16 * ring);
+
+/**
+ * Destroy a ring buffer which was initialized with gcu_ring16_create_in_place(),
+ * without freeing the ring buffer structure itself.
+ *
+ * @param ring The ring buffer to destroy.
+ */
+void gcu_ring16_destroy_in_place(GCU_Ring16 * ring);
+
+/**
+ * Add a value after the last value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the ring buffer is full.
+ */
+bool gcu_ring16_push_back(GCU_Ring16 * ring, GCU_Type16_Union value);
+
+/**
+ * Add a value before the first value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the ring buffer is full.
+ */
+bool gcu_ring16_push_front(GCU_Ring16 * ring, GCU_Type16_Union value);
+
+/**
+ * Remove the last value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @return The value, if the ring buffer was not empty.
+ */
+GCU_Ring16_Value gcu_ring16_pop_back(GCU_Ring16 * ring);
+
+/**
+ * Remove the first value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @return The value, if the ring buffer was not empty.
+ */
+GCU_Ring16_Value gcu_ring16_pop_front(GCU_Ring16 * ring);
+
+/**
+ * Add a block of values after the last value.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param values The values, in order.
+ * @param count The number of values.
+ * @return `true` on success, `false` if there is not room for all of the
+ *   values (in which case none of them are added).
+ */
+bool gcu_ring16_push_many(GCU_Ring16 * ring, const GCU_Type16_Union * values, size_t count);
+
+/**
+ * Remove a block of values from the front.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param values The array which receives the values, in order.
+ * @param count The largest number of values to remove.
+ * @return The number of values removed, which is less than `count` if the
+ *   ring buffer holds fewer values.
+ */
+size_t gcu_ring16_pop_many(GCU_Ring16 * ring, GCU_Type16_Union * values, size_t count);
+
+/**
+ * Get a value by its position from the front.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param index The position, where `0` is the first value.
+ * @return The value, if the position is less than the count.
+ */
+GCU_Ring16_Value gcu_ring16_get(GCU_Ring16 * ring, size_t index);
+
+/**
+ * Get the number of values in the ring buffer.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @return The number of values.
+ */
+size_t gcu_ring16_count(GCU_Ring16 * ring);
+
+/**
+ * Pointer to a function which will be called when the ring buffer destroy
+ * function is called.
+ *
+ * @ref gcu_ring8_destroy
+ *
+ * @param ring The ring buffer which is about to be destroyed.
+ */
+typedef void (* GCU_Ring8_Cleanup)(GCU_Ring8 * ring);
+
+/**
+ * The result of reading or popping a value from a ring buffer.
+ */
+typedef struct {
+  bool exists;           ///< Whether or not there was a value.
+  GCU_Type8_Union value; ///< The value (if it exists).
+} GCU_Ring8_Value;
+
+/**
+ * Container holding the information of the 8-bit ring buffer.
+ *
+ * The values are `data[(head + i) & (capacity - 1)]` for `i` in
+ * `[0, count)`.  `capacity` is a power of two and never changes.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the ring buffer is destroyed, the
+ * `cleanup` function will be called (if provided).
+ */
+typedef struct GCU_Ring8 {
+  size_t capacity;           ///< The number of values that fit in `data`.
+  size_t head;               ///< The position of the first value in `data`.
+  size_t count;              ///< The number of values.
+  GCU_Type8_Union * data;    ///< The circular buffer of values.
+  void * supplementary_data; ///< User-defined.
+  GCU_Ring8_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;         ///< Mutex for thread-safety.
+#endif
+} GCU_Ring8;
+
+/**
+ * Create a ring buffer.
+ *
+ * All invocations of a ring buffer must have a corresponding
+ * gcu_ring8_destroy() call in order to clean up dynamically-allocated memory.
+ *
+ * @param capacity The number of values that the ring buffer must hold.  It is
+ *   rounded up to a power of two.
+ * @return A pointer to the ring buffer on success, `NULL` otherwise.
+ */
+GCU_Ring8 * gcu_ring8_create(size_t capacity);
+
+/**
+ * Initialize a ring buffer in memory owned by the programmer.
+ *
+ * @param ring The ring buffer to initialize.
+ * @param capacity The number of values that the ring buffer must hold.  It is
+ *   rounded up to a power of two.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_ring8_create_in_place(GCU_Ring8 * ring, size_t capacity);
+
+/**
+ * Destroy a ring buffer and free its memory.
+ *
+ * @param ring The ring buffer to destroy.
+ */
+void gcu_ring8_destroy(GCU_Ring8 * ring);
+
+/**
+ * Destroy a ring buffer which was initialized with gcu_ring8_create_in_place(),
+ * without freeing the ring buffer structure itself.
+ *
+ * @param ring The ring buffer to destroy.
+ */
+void gcu_ring8_destroy_in_place(GCU_Ring8 * ring);
+
+/**
+ * Add a value after the last value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the ring buffer is full.
+ */
+bool gcu_ring8_push_back(GCU_Ring8 * ring, GCU_Type8_Union value);
+
+/**
+ * Add a value before the first value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the ring buffer is full.
+ */
+bool gcu_ring8_push_front(GCU_Ring8 * ring, GCU_Type8_Union value);
+
+/**
+ * Remove the last value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @return The value, if the ring buffer was not empty.
+ */
+GCU_Ring8_Value gcu_ring8_pop_back(GCU_Ring8 * ring);
+
+/**
+ * Remove the first value.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @return The value, if the ring buffer was not empty.
+ */
+GCU_Ring8_Value gcu_ring8_pop_front(GCU_Ring8 * ring);
+
+/**
+ * Add a block of values after the last value.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param values The values, in order.
+ * @param count The number of values.
+ * @return `true` on success, `false` if there is not room for all of the
+ *   values (in which case none of them are added).
+ */
+bool gcu_ring8_push_many(GCU_Ring8 * ring, const GCU_Type8_Union * values, size_t count);
+
+/**
+ * Remove a block of values from the front.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param values The array which receives the values, in order.
+ * @param count The largest number of values to remove.
+ * @return The number of values removed, which is less than `count` if the
+ *   ring buffer holds fewer values.
+ */
+size_t gcu_ring8_pop_many(GCU_Ring8 * ring, GCU_Type8_Union * values, size_t count);
+
+/**
+ * Get a value by its position from the front.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @param index The position, where `0` is the first value.
+ * @return The value, if the position is less than the count.
+ */
+GCU_Ring8_Value gcu_ring8_get(GCU_Ring8 * ring, size_t index);
+
+/**
+ * Get the number of values in the ring buffer.
+ *
+ * @param ring The ring buffer on which to operate.
+ * @return The number of values.
+ */
+size_t gcu_ring8_count(GCU_Ring8 * ring);
+
+/**
+ * Pointer to a function which will be called when the deque destroy
+ * function is called.
+ *
+ * @ref gcu_deque64_destroy
+ *
+ * @param deque The deque which is about to be destroyed.
+ */
+typedef void (* GCU_Deque64_Cleanup)(GCU_Deque64 * deque);
+
+/**
+ * The result of reading or popping a value from a deque.
+ */
+typedef struct {
+  bool exists;            ///< Whether or not there was a value.
+  GCU_Type64_Union value; ///< The value (if it exists).
+} GCU_Deque64_Value;
+
+/**
+ * Container holding the information of the 64-bit deque.
+ *
+ * The values are `data[(head + i) & (capacity - 1)]` for `i` in
+ * `[0, count)`.  `capacity` is `0` or a power of two, and is doubled when a
+ * value is pushed onto a full deque.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the deque is destroyed, the
+ * `cleanup` function will be called (if provided).
+ */
+typedef struct GCU_Deque64 {
+  size_t capacity;             ///< The number of values that fit in `data`.
+  size_t head;                 ///< The position of the first value in `data`.
+  size_t count;                ///< The number of values.
+  GCU_Type64_Union * data;     ///< The circular buffer of values.
+  void * supplementary_data;   ///< User-defined.
+  GCU_Deque64_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;           ///< Mutex for thread-safety.
+#endif
+} GCU_Deque64;
+
+/**
+ * Create a deque.
+ *
+ * All invocations of a deque must have a corresponding gcu_deque64_destroy()
+ * call in order to clean up dynamically-allocated memory.
+ *
+ * @param count The number of values anticipated to be stored in the deque.
+ * @return A pointer to the deque on success, `NULL` otherwise.
+ */
+GCU_Deque64 * gcu_deque64_create(size_t count);
+
+/**
+ * Initialize a deque in memory owned by the programmer.
+ *
+ * @param deque The deque to initialize.
+ * @param count The number of values anticipated to be stored in the deque.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_deque64_create_in_place(GCU_Deque64 * deque, size_t count);
+
+/**
+ * Destroy a deque and free its memory.
+ *
+ * @param deque The deque to destroy.
+ */
+void gcu_deque64_destroy(GCU_Deque64 * deque);
+
+/**
+ * Destroy a deque which was initialized with gcu_deque64_create_in_place(),
+ * without freeing the deque structure itself.
+ *
+ * @param deque The deque to destroy.
+ */
+void gcu_deque64_destroy_in_place(GCU_Deque64 * deque);
+
+/**
+ * Add a value after the last value.
+ *
+ * If the deque is full, its capacity is doubled.  This may invalidate any
+ * pointers to the previous data locations.
+ *
+ * @param deque The deque on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the deque could not grow.
+ */
+bool gcu_deque64_push_back(GCU_Deque64 * deque, GCU_Type64_Union value);
+
+/**
+ * Add a value before the first value.
+ *
+ * If the deque is full, its capacity is doubled.  This may invalidate any
+ * pointers to the previous data locations.
+ *
+ * @param deque The deque on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the deque could not grow.
+ */
+bool gcu_deque64_push_front(GCU_Deque64 * deque, GCU_Type64_Union value);
+
+/**
+ * Remove the last value.
+ *
+ * @param deque The deque on which to operate.
+ * @return The value, if the deque was not empty.
+ */
+GCU_Deque64_Value gcu_deque64_pop_back(GCU_Deque64 * deque);
+
+/**
+ * Remove the first value.
+ *
+ * @param deque The deque on which to operate.
+ * @return The value, if the deque was not empty.
+ */
+GCU_Deque64_Value gcu_deque64_pop_front(GCU_Deque64 * deque);
+
+/**
+ * Add a block of values after the last value.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param deque The deque on which to operate.
+ * @param values The values, in order.
+ * @param count The number of values.
+ * @return `true` on success, `false` if the deque could not grow (in which
+ *   case none of the values are added).
+ */
+bool gcu_deque64_push_many(GCU_Deque64 * deque, const GCU_Type64_Union * values, size_t count);
+
+/**
+ * Remove a block of values from the front.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param deque The deque on which to operate.
+ * @param values The array which receives the values, in order.
+ * @param count The largest number of values to remove.
+ * @return The number of values removed, which is less than `count` if the
+ *   deque holds fewer values.
+ */
+size_t gcu_deque64_pop_many(GCU_Deque64 * deque, GCU_Type64_Union * values, size_t count);
+
+/**
+ * Get a value by its position from the front.
+ *
+ * @param deque The deque on which to operate.
+ * @param index The position, where `0` is the first value.
+ * @return The value, if the position is less than the count.
+ */
+GCU_Deque64_Value gcu_deque64_get(GCU_Deque64 * deque, size_t index);
+
+/**
+ * Get the number of values in the deque.
+ *
+ * @param deque The deque on which to operate.
+ * @return The number of values.
+ */
+size_t gcu_deque64_count(GCU_Deque64 * deque);
+
+/**
+ * Reserve space in the deque.
+ *
+ * If the capacity is less than `count`, then it is increased to the next
+ * power of two which is not less than `count` (if possible).
+ *
+ * @param deque The deque on which to operate.
+ * @param count The number of values to reserve.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_deque64_reserve(GCU_Deque64 * deque, size_t count);
+
+/**
+ * Pointer to a function which will be called when the deque destroy
+ * function is called.
+ *
+ * @ref gcu_deque32_destroy
+ *
+ * @param deque The deque which is about to be destroyed.
+ */
+typedef void (* GCU_Deque32_Cleanup)(GCU_Deque32 * deque);
+
+/**
+ * The result of reading or popping a value from a deque.
+ */
+typedef struct {
+  bool exists;            ///< Whether or not there was a value.
+  GCU_Type32_Union value; ///< The value (if it exists).
+} GCU_Deque32_Value;
+
+/**
+ * Container holding the information of the 32-bit deque.
+ *
+ * The values are `data[(head + i) & (capacity - 1)]` for `i` in
+ * `[0, count)`.  `capacity` is `0` or a power of two, and is doubled when a
+ * value is pushed onto a full deque.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the deque is destroyed, the
+ * `cleanup` function will be called (if provided).
+ */
+typedef struct GCU_Deque32 {
+  size_t capacity;             ///< The number of values that fit in `data`.
+  size_t head;                 ///< The position of the first value in `data`.
+  size_t count;                ///< The number of values.
+  GCU_Type32_Union * data;     ///< The circular buffer of values.
+  void * supplementary_data;   ///< User-defined.
+  GCU_Deque32_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;           ///< Mutex for thread-safety.
+#endif
+} GCU_Deque32;
+
+/**
+ * Create a deque.
+ *
+ * All invocations of a deque must have a corresponding gcu_deque32_destroy()
+ * call in order to clean up dynamically-allocated memory.
+ *
+ * @param count The number of values anticipated to be stored in the deque.
+ * @return A pointer to the deque on success, `NULL` otherwise.
+ */
+GCU_Deque32 * gcu_deque32_create(size_t count);
+
+/**
+ * Initialize a deque in memory owned by the programmer.
+ *
+ * @param deque The deque to initialize.
+ * @param count The number of values anticipated to be stored in the deque.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_deque32_create_in_place(GCU_Deque32 * deque, size_t count);
+
+/**
+ * Destroy a deque and free its memory.
+ *
+ * @param deque The deque to destroy.
+ */
+void gcu_deque32_destroy(GCU_Deque32 * deque);
+
+/**
+ * Destroy a deque which was initialized with gcu_deque32_create_in_place(),
+ * without freeing the deque structure itself.
+ *
+ * @param deque The deque to destroy.
+ */
+void gcu_deque32_destroy_in_place(GCU_Deque32 * deque);
+
+/**
+ * Add a value after the last value.
+ *
+ * If the deque is full, its capacity is doubled.  This may invalidate any
+ * pointers to the previous data locations.
+ *
+ * @param deque The deque on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the deque could not grow.
+ */
+bool gcu_deque32_push_back(GCU_Deque32 * deque, GCU_Type32_Union value);
+
+/**
+ * Add a value before the first value.
+ *
+ * If the deque is full, its capacity is doubled.  This may invalidate any
+ * pointers to the previous data locations.
+ *
+ * @param deque The deque on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the deque could not grow.
+ */
+bool gcu_deque32_push_front(GCU_Deque32 * deque, GCU_Type32_Union value);
+
+/**
+ * Remove the last value.
+ *
+ * @param deque The deque on which to operate.
+ * @return The value, if the deque was not empty.
+ */
+GCU_Deque32_Value gcu_deque32_pop_back(GCU_Deque32 * deque);
+
+/**
+ * Remove the first value.
+ *
+ * @param deque The deque on which to operate.
+ * @return The value, if the deque was not empty.
+ */
+GCU_Deque32_Value gcu_deque32_pop_front(GCU_Deque32 * deque);
+
+/**
+ * Add a block of values after the last value.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param deque The deque on which to operate.
+ * @param values The values, in order.
+ * @param count The number of values.
+ * @return `true` on success, `false` if the deque could not grow (in which
+ *   case none of the values are added).
+ */
+bool gcu_deque32_push_many(GCU_Deque32 * deque, const GCU_Type32_Union * values, size_t count);
+
+/**
+ * Remove a block of values from the front.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param deque The deque on which to operate.
+ * @param values The array which receives the values, in order.
+ * @param count The largest number of values to remove.
+ * @return The number of values removed, which is less than `count` if the
+ *   deque holds fewer values.
+ */
+size_t gcu_deque32_pop_many(GCU_Deque32 * deque, GCU_Type32_Union * values, size_t count);
+
+/**
+ * Get a value by its position from the front.
+ *
+ * @param deque The deque on which to operate.
+ * @param index The position, where `0` is the first value.
+ * @return The value, if the position is less than the count.
+ */
+GCU_Deque32_Value gcu_deque32_get(GCU_Deque32 * deque, size_t index);
+
+/**
+ * Get the number of values in the deque.
+ *
+ * @param deque The deque on which to operate.
+ * @return The number of values.
+ */
+size_t gcu_deque32_count(GCU_Deque32 * deque);
+
+/**
+ * Reserve space in the deque.
+ *
+ * If the capacity is less than `count`, then it is increased to the next
+ * power of two which is not less than `count` (if possible).
+ *
+ * @param deque The deque on which to operate.
+ * @param count The number of values to reserve.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_deque32_reserve(GCU_Deque32 * deque, size_t count);
+
+/**
+ * Pointer to a function which will be called when the deque destroy
+ * function is called.
+ *
+ * @ref gcu_deque16_destroy
+ *
+ * @param deque The deque which is about to be destroyed.
+ */
+typedef void (* GCU_Deque16_Cleanup)(GCU_Deque16 * deque);
+
+/**
+ * The result of reading or popping a value from a deque.
+ */
+typedef struct {
+  bool exists;            ///< Whether or not there was a value.
+  GCU_Type16_Union value; ///< The value (if it exists).
+} GCU_Deque16_Value;
+
+/**
+ * Container holding the information of the 16-bit deque.
+ *
+ * The values are `data[(head + i) & (capacity - 1)]` for `i` in
+ * `[0, count)`.  `capacity` is `0` or a power of two, and is doubled when a
+ * value is pushed onto a full deque.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the deque is destroyed, the
+ * `cleanup` function will be called (if provided).
+ */
+typedef struct GCU_Deque16 {
+  size_t capacity;             ///< The number of values that fit in `data`.
+  size_t head;                 ///< The position of the first value in `data`.
+  size_t count;                ///< The number of values.
+  GCU_Type16_Union * data;     ///< The circular buffer of values.
+  void * supplementary_data;   ///< User-defined.
+  GCU_Deque16_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;           ///< Mutex for thread-safety.
+#endif
+} GCU_Deque16;
+
+/**
+ * Create a deque.
+ *
+ * All invocations of a deque must have a corresponding gcu_deque16_destroy()
+ * call in order to clean up dynamically-allocated memory.
+ *
+ * @param count The number of values anticipated to be stored in the deque.
+ * @return A pointer to the deque on success, `NULL` otherwise.
+ */
+GCU_Deque16 * gcu_deque16_create(size_t count);
+
+/**
+ * Initialize a deque in memory owned by the programmer.
+ *
+ * @param deque The deque to initialize.
+ * @param count The number of values anticipated to be stored in the deque.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_deque16_create_in_place(GCU_Deque16 * deque, size_t count);
+
+/**
+ * Destroy a deque and free its memory.
+ *
+ * @param deque The deque to destroy.
+ */
+void gcu_deque16_destroy(GCU_Deque16 * deque);
+
+/**
+ * Destroy a deque which was initialized with gcu_deque16_create_in_place(),
+ * without freeing the deque structure itself.
+ *
+ * @param deque The deque to destroy.
+ */
+void gcu_deque16_destroy_in_place(GCU_Deque16 * deque);
+
+/**
+ * Add a value after the last value.
+ *
+ * If the deque is full, its capacity is doubled.  This may invalidate any
+ * pointers to the previous data locations.
+ *
+ * @param deque The deque on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the deque could not grow.
+ */
+bool gcu_deque16_push_back(GCU_Deque16 * deque, GCU_Type16_Union value);
+
+/**
+ * Add a value before the first value.
+ *
+ * If the deque is full, its capacity is doubled.  This may invalidate any
+ * pointers to the previous data locations.
+ *
+ * @param deque The deque on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the deque could not grow.
+ */
+bool gcu_deque16_push_front(GCU_Deque16 * deque, GCU_Type16_Union value);
+
+/**
+ * Remove the last value.
+ *
+ * @param deque The deque on which to operate.
+ * @return The value, if the deque was not empty.
+ */
+GCU_Deque16_Value gcu_deque16_pop_back(GCU_Deque16 * deque);
+
+/**
+ * Remove the first value.
+ *
+ * @param deque The deque on which to operate.
+ * @return The value, if the deque was not empty.
+ */
+GCU_Deque16_Value gcu_deque16_pop_front(GCU_Deque16 * deque);
+
+/**
+ * Add a block of values after the last value.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param deque The deque on which to operate.
+ * @param values The values, in order.
+ * @param count The number of values.
+ * @return `true` on success, `false` if the deque could not grow (in which
+ *   case none of the values are added).
+ */
+bool gcu_deque16_push_many(GCU_Deque16 * deque, const GCU_Type16_Union * values, size_t count);
+
+/**
+ * Remove a block of values from the front.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param deque The deque on which to operate.
+ * @param values The array which receives the values, in order.
+ * @param count The largest number of values to remove.
+ * @return The number of values removed, which is less than `count` if the
+ *   deque holds fewer values.
+ */
+size_t gcu_deque16_pop_many(GCU_Deque16 * deque, GCU_Type16_Union * values, size_t count);
+
+/**
+ * Get a value by its position from the front.
+ *
+ * @param deque The deque on which to operate.
+ * @param index The position, where `0` is the first value.
+ * @return The value, if the position is less than the count.
+ */
+GCU_Deque16_Value gcu_deque16_get(GCU_Deque16 * deque, size_t index);
+
+/**
+ * Get the number of values in the deque.
+ *
+ * @param deque The deque on which to operate.
+ * @return The number of values.
+ */
+size_t gcu_deque16_count(GCU_Deque16 * deque);
+
+/**
+ * Reserve space in the deque.
+ *
+ * If the capacity is less than `count`, then it is increased to the next
+ * power of two which is not less than `count` (if possible).
+ *
+ * @param deque The deque on which to operate.
+ * @param count The number of values to reserve.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_deque16_reserve(GCU_Deque16 * deque, size_t count);
+
+/**
+ * Pointer to a function which will be called when the deque destroy
+ * function is called.
+ *
+ * @ref gcu_deque8_destroy
+ *
+ * @param deque The deque which is about to be destroyed.
+ */
+typedef void (* GCU_Deque8_Cleanup)(GCU_Deque8 * deque);
+
+/**
+ * The result of reading or popping a value from a deque.
+ */
+typedef struct {
+  bool exists;           ///< Whether or not there was a value.
+  GCU_Type8_Union value; ///< The value (if it exists).
+} GCU_Deque8_Value;
+
+/**
+ * Container holding the information of the 8-bit deque.
+ *
+ * The values are `data[(head + i) & (capacity - 1)]` for `i` in
+ * `[0, count)`.  `capacity` is `0` or a power of two, and is doubled when a
+ * value is pushed onto a full deque.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the deque is destroyed, the
+ * `cleanup` function will be called (if provided).
+ */
+typedef struct GCU_Deque8 {
+  size_t capacity;            ///< The number of values that fit in `data`.
+  size_t head;                ///< The position of the first value in `data`.
+  size_t count;               ///< The number of values.
+  GCU_Type8_Union * data;     ///< The circular buffer of values.
+  void * supplementary_data;  ///< User-defined.
+  GCU_Deque8_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;          ///< Mutex for thread-safety.
+#endif
+} GCU_Deque8;
+
+/**
+ * Create a deque.
+ *
+ * All invocations of a deque must have a corresponding gcu_deque8_destroy()
+ * call in order to clean up dynamically-allocated memory.
+ *
+ * @param count The number of values anticipated to be stored in the deque.
+ * @return A pointer to the deque on success, `NULL` otherwise.
+ */
+GCU_Deque8 * gcu_deque8_create(size_t count);
+
+/**
+ * Initialize a deque in memory owned by the programmer.
+ *
+ * @param deque The deque to initialize.
+ * @param count The number of values anticipated to be stored in the deque.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_deque8_create_in_place(GCU_Deque8 * deque, size_t count);
+
+/**
+ * Destroy a deque and free its memory.
+ *
+ * @param deque The deque to destroy.
+ */
+void gcu_deque8_destroy(GCU_Deque8 * deque);
+
+/**
+ * Destroy a deque which was initialized with gcu_deque8_create_in_place(),
+ * without freeing the deque structure itself.
+ *
+ * @param deque The deque to destroy.
+ */
+void gcu_deque8_destroy_in_place(GCU_Deque8 * deque);
+
+/**
+ * Add a value after the last value.
+ *
+ * If the deque is full, its capacity is doubled.  This may invalidate any
+ * pointers to the previous data locations.
+ *
+ * @param deque The deque on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the deque could not grow.
+ */
+bool gcu_deque8_push_back(GCU_Deque8 * deque, GCU_Type8_Union value);
+
+/**
+ * Add a value before the first value.
+ *
+ * If the deque is full, its capacity is doubled.  This may invalidate any
+ * pointers to the previous data locations.
+ *
+ * @param deque The deque on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` if the deque could not grow.
+ */
+bool gcu_deque8_push_front(GCU_Deque8 * deque, GCU_Type8_Union value);
+
+/**
+ * Remove the last value.
+ *
+ * @param deque The deque on which to operate.
+ * @return The value, if the deque was not empty.
+ */
+GCU_Deque8_Value gcu_deque8_pop_back(GCU_Deque8 * deque);
+
+/**
+ * Remove the first value.
+ *
+ * @param deque The deque on which to operate.
+ * @return The value, if the deque was not empty.
+ */
+GCU_Deque8_Value gcu_deque8_pop_front(GCU_Deque8 * deque);
+
+/**
+ * Add a block of values after the last value.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param deque The deque on which to operate.
+ * @param values The values, in order.
+ * @param count The number of values.
+ * @return `true` on success, `false` if the deque could not grow (in which
+ *   case none of the values are added).
+ */
+bool gcu_deque8_push_many(GCU_Deque8 * deque, const GCU_Type8_Union * values, size_t count);
+
+/**
+ * Remove a block of values from the front.
+ *
+ * The values are copied with at most two `memcpy()` calls.
+ *
+ * @param deque The deque on which to operate.
+ * @param values The array which receives the values, in order.
+ * @param count The largest number of values to remove.
+ * @return The number of values removed, which is less than `count` if the
+ *   deque holds fewer values.
+ */
+size_t gcu_deque8_pop_many(GCU_Deque8 * deque, GCU_Type8_Union * values, size_t count);
+
+/**
+ * Get a value by its position from the front.
+ *
+ * @param deque The deque on which to operate.
+ * @param index The position, where `0` is the first value.
+ * @return The value, if the position is less than the count.
+ */
+GCU_Deque8_Value gcu_deque8_get(GCU_Deque8 * deque, size_t index);
+
+/**
+ * Get the number of values in the deque.
+ *
+ * @param deque The deque on which to operate.
+ * @return The number of values.
+ */
+size_t gcu_deque8_count(GCU_Deque8 * deque);
+
+/**
+ * Reserve space in the deque.
+ *
+ * If the capacity is less than `count`, then it is increased to the next
+ * power of two which is not less than `count` (if possible).
+ *
+ * @param deque The deque on which to operate.
+ * @param count The number of values to reserve.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_deque8_reserve(GCU_Deque8 * deque, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_DEQUE_H
@@ -0,0 +1,251 @@
+/**
+ * @file
+ * A sorted, flat map from 64-bit keys to 64-bit values.
+ *
+ * The map stores its keys and values in two parallel vectors, with the keys in
+ * ascending order.  Lookups are a branchless binary search over the contiguous
+ * keys, and entries can be visited in key order, or by key range.
+ *
+ * Compared to a hash table, a flat map uses less memory and, for small to
+ * medium sizes, looks keys up faster, but inserting or removing a single entry
+ * moves every entry after it.  Maps which are built in bulk and then mostly
+ * read should be filled with gcu_flatmap64_set_many(), which sorts the new
+ * entries and merges them in a single pass.
+ */
+
+#ifndef GHOTIIO_CUTIL_FLATMAP_H
+#define GHOTIIO_CUTIL_FLATMAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <cutil/mutex.h>
+#include <cutil/type.h>
+#include <cutil/vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_FlatMap64_Cleanup GHOTIIO_CUTIL(GCU_FlatMap64_Cleanup)
+#define GCU_FlatMap64_Value GHOTIIO_CUTIL(GCU_FlatMap64_Value)
+#define GCU_FlatMap64_Iterator GHOTIIO_CUTIL(GCU_FlatMap64_Iterator)
+#define GCU_FlatMap64 GHOTIIO_CUTIL(GCU_FlatMap64)
+#define gcu_flatmap64_create GHOTIIO_CUTIL(gcu_flatmap64_create)
+#define gcu_flatmap64_create_in_place GHOTIIO_CUTIL(gcu_flatmap64_create_in_place)
+#define gcu_flatmap64_destroy GHOTIIO_CUTIL(gcu_flatmap64_destroy)
+#define gcu_flatmap64_destroy_in_place GHOTIIO_CUTIL(gcu_flatmap64_destroy_in_place)
+#define gcu_flatmap64_set GHOTIIO_CUTIL(gcu_flatmap64_set)
+#define gcu_flatmap64_set_many GHOTIIO_CUTIL(gcu_flatmap64_set_many)
+#define gcu_flatmap64_get GHOTIIO_CUTIL(gcu_flatmap64_get)
+#define gcu_flatmap64_contains GHOTIIO_CUTIL(gcu_flatmap64_contains)
+#define gcu_flatmap64_remove GHOTIIO_CUTIL(gcu_flatmap64_remove)
+#define gcu_flatmap64_count GHOTIIO_CUTIL(gcu_flatmap64_count)
+#define gcu_flatmap64_lower_bound GHOTIIO_CUTIL(gcu_flatmap64_lower_bound)
+#define gcu_flatmap64_iterator_get GHOTIIO_CUTIL(gcu_flatmap64_iterator_get)
+#define gcu_flatmap64_iterator_range GHOTIIO_CUTIL(gcu_flatmap64_iterator_range)
+#define gcu_flatmap64_iterator_next GHOTIIO_CUTIL(gcu_flatmap64_iterator_next)
+/// @endcond
+
+typedef struct GCU_FlatMap64 GCU_FlatMap64;
+
+/**
+ * Pointer to a function which will be called when the flat map destroy
+ * function is called.
+ *
+ * @ref gcu_flatmap64_destroy
+ *
+ * @param map The flat map which is about to be destroyed.
+ */
+typedef void (* GCU_FlatMap64_Cleanup)(GCU_FlatMap64 * map);
+
+/**
+ * Container holding the result of a flat map lookup.
+ */
+typedef struct {
+  bool exists;            ///< Whether or not the key exists in the map.
+  GCU_Type64_Union value; ///< The value found in the map (if it exists).
+} GCU_FlatMap64_Value;
+
+/**
+ * Container holding the information of the flat map.
+ *
+ * The entries are stored in `keys` and `values`, where `values.data[i]` is
+ * the value of the key `keys.data[i].ui64`, and the keys are in strictly
+ * ascending order.  The programmer may read the vectors directly, but must
+ * only modify them through the flat map functions.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the map is destroyed, the `cleanup`
+ * function will be called (if provided).
+ */
+typedef struct GCU_FlatMap64 {
+  GCU_Vector64 keys;             ///< The keys, in ascending order.
+  GCU_Vector64 values;           ///< The values, parallel to `keys`.
+  void * supplementary_data;     ///< User-defined.
+  GCU_FlatMap64_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;             ///< Mutex for thread-safety.
+#endif
+} GCU_FlatMap64;
+
+/**
+ * A container used to hold the state of an iterator which traverses the
+ * entries of a flat map in ascending key order.
+ *
+ * Setting or removing entries invalidates any iterators of the map.
+ *
+ * The programmer is responsible for checking the `exists` field before using
+ * the `key` or `value`.
+ */
+typedef struct {
+  size_t current;         ///< The index of the entry in the map.
+  size_t end;             ///< The index one past the last entry to visit.
+  bool exists;            ///< Whether or not the iterator points to valid data.
+  uint64_t key;           ///< The key pointed to by the iterator.
+  GCU_Type64_Union value; ///< The value pointed to by the iterator.
+  GCU_FlatMap64 * map;    ///< The map that the iterator traverses.
+} GCU_FlatMap64_Iterator;
+
+/**
+ * Create a flat map.
+ *
+ * All invocations of a flat map must have a corresponding
+ * gcu_flatmap64_destroy() call in order to clean up dynamically-allocated
+ * memory.
+ *
+ * @param count The number of entries anticipated to be stored in the map.
+ * @return A pointer to the map on success, `NULL` otherwise.
+ */
+GCU_FlatMap64 * gcu_flatmap64_create(size_t count);
+
+/**
+ * Initialize a flat map in memory owned by the programmer.
+ *
+ * @param map The map to initialize.
+ * @param count The number of entries anticipated to be stored in the map.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_flatmap64_create_in_place(GCU_FlatMap64 * map, size_t count);
+
+/**
+ * Destroy a flat map and free its memory.
+ *
+ * @param map The map to destroy.
+ */
+void gcu_flatmap64_destroy(GCU_FlatMap64 * map);
+
+/**
+ * Destroy a flat map which was initialized with
+ * gcu_flatmap64_create_in_place(), without freeing the map structure itself.
+ *
+ * @param map The map to destroy.
+ */
+void gcu_flatmap64_destroy_in_place(GCU_FlatMap64 * map);
+
+/**
+ * Set the value of a key, replacing any existing value.
+ *
+ * A new key moves every entry with a larger key, so filling a map one key at
+ * a time is quadratic unless the keys arrive in ascending order.
+ *
+ * @param map The map on which to operate.
+ * @param key The key.
+ * @param value The value.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_flatmap64_set(GCU_FlatMap64 * map, uint64_t key, GCU_Type64_Union value);
+
+/**
+ * Set the values of many keys at once.
+ *
+ * The new entries are sorted and then merged with the existing entries in a
+ * single pass.  If a key appears more than once, then the last value given
+ * for it is kept.
+ *
+ * @param map The map on which to operate.
+ * @param keys The keys.
+ * @param values The values, parallel to `keys`.
+ * @param count The number of keys.
+ * @return `true` on success, `false` otherwise (in which case the map is
+ *   unchanged).
+ */
+bool gcu_flatmap64_set_many(GCU_FlatMap64 * map, const uint64_t * keys, const GCU_Type64_Union * values, size_t count);
+
+/**
+ * Get the value of a key.
+ *
+ * @param map The map on which to operate.
+ * @param key The key.
+ * @return The value, if the key exists.
+ */
+GCU_FlatMap64_Value gcu_flatmap64_get(GCU_FlatMap64 * map, uint64_t key);
+
+/**
+ * Check whether a key exists in the map.
+ *
+ * @param map The map on which to operate.
+ * @param key The key.
+ * @return `true` if the key exists, `false` otherwise.
+ */
+bool gcu_flatmap64_contains(GCU_FlatMap64 * map, uint64_t key);
+
+/**
+ * Remove a key from the map.
+ *
+ * @param map The map on which to operate.
+ * @param key The key.
+ * @return `true` if the key was removed, `false` if it did not exist.
+ */
+bool gcu_flatmap64_remove(GCU_FlatMap64 * map, uint64_t key);
+
+/**
+ * Get the number of entries in the map.
+ *
+ * @param map The map on which to operate.
+ * @return The number of entries.
+ */
+size_t gcu_flatmap64_count(GCU_FlatMap64 * map);
+
+/**
+ * Find the position of the first key which is not less than `key`.
+ *
+ * @param map The map on which to operate.
+ * @param key The key.
+ * @return The position in `keys` and `values`, which is the number of entries
+ *   if every key is less than `key`.
+ */
+size_t gcu_flatmap64_lower_bound(GCU_FlatMap64 * map, uint64_t key);
+
+/**
+ * Get an iterator to the entry with the smallest key.
+ *
+ * @param map The map on which to operate.
+ * @return An iterator pointing to the first entry (if it exists).
+ */
+GCU_FlatMap64_Iterator gcu_flatmap64_iterator_get(GCU_FlatMap64 * map);
+
+/**
+ * Get an iterator over the entries whose keys are in the range `[low, high]`.
+ *
+ * @param map The map on which to operate.
+ * @param low The smallest key to visit.
+ * @param high The largest key to visit.
+ * @return An iterator pointing to the first entry in the range (if it exists).
+ */
+GCU_FlatMap64_Iterator gcu_flatmap64_iterator_range(GCU_FlatMap64 * map, uint64_t low, uint64_t high);
+
+/**
+ * Get an iterator to the next entry (if it exists).
+ *
+ * @param iterator The current iterator.
+ * @return An iterator pointing to the next entry (if it exists).
+ */
+GCU_FlatMap64_Iterator gcu_flatmap64_iterator_next(GCU_FlatMap64_Iterator iterator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_FLATMAP_H
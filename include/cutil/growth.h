@@ -0,0 +1,166 @@
+/**
+ * @file
+ * Growth policies, and huge-page backing, for the storage of containers.
+ *
+ * A GCU_Growth describes how a container's storage grows when it is full, and
+ * where that storage comes from.  Vectors and hash tables each carry one,
+ * which is set with gcu_vector64_set_growth(), gcu_hash64_set_growth(), and
+ * so on.  A zeroed policy keeps the built-in behaviour of the container.
+ *
+ * Growth: when a container needs more room, its capacity is multiplied by
+ * `factor`, but grows by at least `minimum` and at most `maximum` elements.
+ * A small `maximum` trades more frequent growth for less unused room in very
+ * large containers.
+ *
+ * Huge pages: storage of at least `huge_threshold` bytes is mapped directly
+ * from the operating system instead of coming from `malloc()`.  The mapping
+ * is rounded up to a whole number of 2 MiB huge pages, and is marked with
+ * `madvise(MADV_HUGEPAGE)`, so that a multi-gigabyte table needs a fraction
+ * of the TLB entries that 4 KiB pages do.  When such storage grows, it is
+ * remapped with `mremap()` (on Linux), which moves the pages rather than
+ * copying the data.  Huge-page backing is only available on Linux; elsewhere
+ * `huge_threshold` is ignored.
+ *
+ * Arenas: a policy may instead name an arena (see arena.h), from which all of
+ * the storage is then allocated.  Growing such storage extends it in place
+ * when it is the arena's most recent allocation, and otherwise copies it;
+ * freeing it does nothing, since the arena gives it back when it is reset.
+ * The arena takes precedence over `huge_threshold`.  Containers are put in an
+ * arena when they are created (with gcu_vector64_create_in_arena() and so
+ * on), and keep it for their whole life.
+ *
+ * Alignment: storage may be aligned beyond what `malloc()` guarantees, such
+ * as to a cache line (`GCU_CACHELINE_SIZE`) or to the width of a SIMD
+ * register, by setting `alignment`.  Such storage comes from
+ * gcu_aligned_alloc() or, in an arena, from gcu_arena_allocate_aligned().
+ * Huge-page backed storage is always aligned to a page.
+ *
+ * Allocators: a policy may name an allocator (a GCU_Allocator, see memory.h)
+ * for the storage of just this container, such as a pool or a heap of its
+ * own, in place of the one used by gcu_malloc().  The arena, huge pages, and
+ * alignment each take precedence over the allocator.
+ *
+ * Whether storage is mapped is decided by its size alone, so the functions
+ * below must be given the same policy and size when the storage is grown or
+ * freed as when it was allocated.
+ */
+
+#ifndef GHOTIIO_CUTIL_GROWTH_H
+#define GHOTIIO_CUTIL_GROWTH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <cutil/arena.h>
+#include <cutil/libver.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_Growth GHOTIIO_CUTIL(GCU_Growth)
+#define GCU_Allocator GHOTIIO_CUTIL(GCU_Allocator)
+#define gcu_growth_next GHOTIIO_CUTIL(gcu_growth_next)
+#define gcu_growth_is_huge GHOTIIO_CUTIL(gcu_growth_is_huge)
+#define gcu_growth_allocate GHOTIIO_CUTIL(gcu_growth_allocate)
+#define gcu_growth_reallocate GHOTIIO_CUTIL(gcu_growth_reallocate)
+#define gcu_growth_free GHOTIIO_CUTIL(gcu_growth_free)
+#define gcu_growth_compatible GHOTIIO_CUTIL(gcu_growth_compatible)
+/// @endcond
+
+/**
+ * The size of a huge page, to which huge-page backed storage is rounded.
+ */
+#define GCU_GROWTH_HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+/**
+ * How the storage of a container grows.
+ */
+typedef struct {
+  double factor;          ///< The factor by which the capacity grows, or `0`
+                          ///<   for the container's built-in growth.
+  size_t minimum;         ///< The fewest elements by which to grow.
+  size_t maximum;         ///< The most elements by which to grow, or `0` for
+                          ///<   no limit.
+  size_t huge_threshold;  ///< The size, in bytes, from which storage is backed
+                          ///<   by huge pages, or `0` for never.
+  GCU_Arena * arena;      ///< The arena from which storage is allocated, or
+                          ///<   `NULL` for the heap.
+  size_t alignment;       ///< The alignment of the storage, in bytes (a power
+                          ///<   of two), or `0` for that of gcu_malloc().
+  const struct GCU_Allocator * allocator; ///< The allocator (see memory.h)
+                          ///<   from which storage is allocated, or `NULL`
+                          ///<   for that of gcu_malloc().
+} GCU_Growth;
+
+/**
+ * Get the capacity to which a container grows.
+ *
+ * @param growth The policy, whose `factor` is not `0`.
+ * @param capacity The current capacity, in elements.
+ * @return The new capacity, which is larger than `capacity` unless it would
+ *   overflow.
+ */
+size_t gcu_growth_next(const GCU_Growth * growth, size_t capacity);
+
+/**
+ * Determine whether storage of a given size is backed by huge pages.
+ *
+ * @param growth The policy.
+ * @param size The size of the storage, in bytes.
+ * @return `true` if the storage is mapped, `false` if it comes from
+ *   gcu_malloc().
+ */
+bool gcu_growth_is_huge(const GCU_Growth * growth, size_t size);
+
+/**
+ * Allocate storage.
+ *
+ * @param growth The policy.
+ * @param size The size of the storage, in bytes.
+ * @param zero Whether or not the storage must be zeroed.  Mapped storage
+ *   always is.
+ * @return The storage, or `NULL` on failure.
+ */
+void * gcu_growth_allocate(const GCU_Growth * growth, size_t size, bool zero);
+
+/**
+ * Grow (or shrink) storage, keeping its contents.
+ *
+ * @param growth The policy with which the storage was allocated.
+ * @param pointer The storage, or `NULL`.
+ * @param old_size The size with which the storage was allocated.
+ * @param new_size The size to which to grow the storage.
+ * @return The storage, or `NULL` on failure (in which case `pointer` is
+ *   unchanged).
+ */
+void * gcu_growth_reallocate(const GCU_Growth * growth, void * pointer, size_t old_size, size_t new_size);
+
+/**
+ * Free storage.
+ *
+ * @param growth The policy with which the storage was allocated.
+ * @param pointer The storage, or `NULL`.
+ * @param size The size with which the storage was allocated.
+ */
+void gcu_growth_free(const GCU_Growth * growth, void * pointer, size_t size);
+
+/**
+ * Determine whether storage allocated under one policy may be grown and freed
+ * under another, or must first be moved.
+ *
+ * The policies must share the same arena.  Storage is moved when the
+ * allocator changes, since it must be freed by the one which allocated it.
+ *
+ * @param from The policy with which the storage was allocated.
+ * @param to The policy to which the container is changing.
+ * @param size The size of the storage, in bytes.
+ * @return `true` if the storage may stay where it is.
+ */
+bool gcu_growth_compatible(const GCU_Growth * from, const GCU_Growth * to, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_GROWTH_H
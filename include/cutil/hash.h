@@ -1,6 +1,13 @@
 /**
  * @file
  * A simple hash table implementation.
+ *
+ * Each hash table carries a `mutex` member for use by the programmer.  If the
+ * library is built with `GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX` defined (e.g.,
+ * `make CONTAINER_MUTEX=0`), then the member is omitted and no mutex is
+ * initialized or destroyed by the create and destroy functions.  The same
+ * define must be visible to all code that includes this header, which the
+ * pkg-config file will provide automatically.
  */
 
 #ifndef GHOTIIO_CUTIL_HASH_H
@@ -8,6 +15,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <cutil/growth.h>
 #include <cutil/type.h>
 #include <cutil/mutex.h>
 
@@ -24,6 +32,8 @@ extern "C" {
 
 #define gcu_hash64_create GHOTIIO_CUTIL(gcu_hash64_create)
 #define gcu_hash64_create_in_place GHOTIIO_CUTIL(gcu_hash64_create_in_place)
+#define gcu_hash64_create_in_arena GHOTIIO_CUTIL(gcu_hash64_create_in_arena)
+#define gcu_hash64_create_embedded GHOTIIO_CUTIL(gcu_hash64_create_embedded)
 #define gcu_hash64_destroy GHOTIIO_CUTIL(gcu_hash64_destroy)
 #define gcu_hash64_destroy_in_place GHOTIIO_CUTIL(gcu_hash64_destroy_in_place)
 #define gcu_hash64_clone GHOTIIO_CUTIL(gcu_hash64_clone)
@@ -32,6 +42,8 @@ extern "C" {
 #define gcu_hash64_contains GHOTIIO_CUTIL(gcu_hash64_contains)
 #define gcu_hash64_remove GHOTIIO_CUTIL(gcu_hash64_remove)
 #define gcu_hash64_count GHOTIIO_CUTIL(gcu_hash64_count)
+#define gcu_hash64_bytes GHOTIIO_CUTIL(gcu_hash64_bytes)
+#define gcu_hash64_set_growth GHOTIIO_CUTIL(gcu_hash64_set_growth)
 #define gcu_hash64_iterator_get GHOTIIO_CUTIL(gcu_hash64_iterator_get)
 #define gcu_hash64_iterator_next GHOTIIO_CUTIL(gcu_hash64_iterator_next)
 
@@ -43,6 +55,8 @@ extern "C" {
 
 #define gcu_hash32_create GHOTIIO_CUTIL(gcu_hash32_create)
 #define gcu_hash32_create_in_place GHOTIIO_CUTIL(gcu_hash32_create_in_place)
+#define gcu_hash32_create_in_arena GHOTIIO_CUTIL(gcu_hash32_create_in_arena)
+#define gcu_hash32_create_embedded GHOTIIO_CUTIL(gcu_hash32_create_embedded)
 #define gcu_hash32_destroy GHOTIIO_CUTIL(gcu_hash32_destroy)
 #define gcu_hash32_destroy_in_place GHOTIIO_CUTIL(gcu_hash32_destroy_in_place)
 #define gcu_hash32_clone GHOTIIO_CUTIL(gcu_hash32_clone)
@@ -51,6 +65,8 @@ extern "C" {
 #define gcu_hash32_contains GHOTIIO_CUTIL(gcu_hash32_contains)
 #define gcu_hash32_remove GHOTIIO_CUTIL(gcu_hash32_remove)
 #define gcu_hash32_count GHOTIIO_CUTIL(gcu_hash32_count)
+#define gcu_hash32_bytes GHOTIIO_CUTIL(gcu_hash32_bytes)
+#define gcu_hash32_set_growth GHOTIIO_CUTIL(gcu_hash32_set_growth)
 #define gcu_hash32_iterator_get GHOTIIO_CUTIL(gcu_hash32_iterator_get)
 #define gcu_hash32_iterator_next GHOTIIO_CUTIL(gcu_hash32_iterator_next)
 
@@ -62,6 +78,8 @@ extern "C" {
 
 #define gcu_hash16_create GHOTIIO_CUTIL(gcu_hash16_create)
 #define gcu_hash16_create_in_place GHOTIIO_CUTIL(gcu_hash16_create_in_place)
+#define gcu_hash16_create_in_arena GHOTIIO_CUTIL(gcu_hash16_create_in_arena)
+#define gcu_hash16_create_embedded GHOTIIO_CUTIL(gcu_hash16_create_embedded)
 #define gcu_hash16_destroy GHOTIIO_CUTIL(gcu_hash16_destroy)
 #define gcu_hash16_destroy_in_place GHOTIIO_CUTIL(gcu_hash16_destroy_in_place)
 #define gcu_hash16_clone GHOTIIO_CUTIL(gcu_hash16_clone)
@@ -70,6 +88,8 @@ extern "C" {
 #define gcu_hash16_contains GHOTIIO_CUTIL(gcu_hash16_contains)
 #define gcu_hash16_remove GHOTIIO_CUTIL(gcu_hash16_remove)
 #define gcu_hash16_count GHOTIIO_CUTIL(gcu_hash16_count)
+#define gcu_hash16_bytes GHOTIIO_CUTIL(gcu_hash16_bytes)
+#define gcu_hash16_set_growth GHOTIIO_CUTIL(gcu_hash16_set_growth)
 #define gcu_hash16_iterator_get GHOTIIO_CUTIL(gcu_hash16_iterator_get)
 #define gcu_hash16_iterator_next GHOTIIO_CUTIL(gcu_hash16_iterator_next)
 
@@ -81,6 +101,8 @@ extern "C" {
 
 #define gcu_hash8_create GHOTIIO_CUTIL(gcu_hash8_create)
 #define gcu_hash8_create_in_place GHOTIIO_CUTIL(gcu_hash8_create_in_place)
+#define gcu_hash8_create_in_arena GHOTIIO_CUTIL(gcu_hash8_create_in_arena)
+#define gcu_hash8_create_embedded GHOTIIO_CUTIL(gcu_hash8_create_embedded)
 #define gcu_hash8_destroy GHOTIIO_CUTIL(gcu_hash8_destroy)
 #define gcu_hash8_destroy_in_place GHOTIIO_CUTIL(gcu_hash8_destroy_in_place)
 #define gcu_hash8_clone GHOTIIO_CUTIL(gcu_hash8_clone)
@@ -89,6 +111,8 @@ extern "C" {
 #define gcu_hash8_contains GHOTIIO_CUTIL(gcu_hash8_contains)
 #define gcu_hash8_remove GHOTIIO_CUTIL(gcu_hash8_remove)
 #define gcu_hash8_count GHOTIIO_CUTIL(gcu_hash8_count)
+#define gcu_hash8_bytes GHOTIIO_CUTIL(gcu_hash8_bytes)
+#define gcu_hash8_set_growth GHOTIIO_CUTIL(gcu_hash8_set_growth)
 #define gcu_hash8_iterator_get GHOTIIO_CUTIL(gcu_hash8_iterator_get)
 #define gcu_hash8_iterator_next GHOTIIO_CUTIL(gcu_hash8_iterator_next)
 /// @endcond
@@ -186,9 +210,13 @@ typedef struct GCU_Hash64 {
   size_t removed;             ///< The count of non-empty cells that represent
                               ///<   elements which have been removed.
   GCU_Hash64_Cell * data;     ///< A pointer to the array of data cells.
+  bool embedded;              ///< Whether `data` shares the hash table's allocation.
+  GCU_Growth growth;          ///< How the data grows (see gcu_hash64_set_growth()).
   void * supplementary_data;  ///< User-defined.
   GCU_Hash64_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
   GCU_MUTEX_T mutex;          ///< Mutex for thread-safety.
+#endif
 } GCU_Hash64;
 
 /**
@@ -242,6 +270,35 @@ GCU_Hash64 * gcu_hash64_create(size_t count);
  */
 bool gcu_hash64_create_in_place(GCU_Hash64 * hash, size_t count);
 
+/**
+ * Create a hash table structure in an arena.
+ *
+ * Both the structure and its data are allocated from the arena (see
+ * arena.h), and are given back when the arena is reset.  The hash table may
+ * still be passed to gcu_hash64_destroy(), which calls its `cleanup`
+ * function and releases its mutex, but frees no memory.
+ *
+ * @param arena The arena from which to allocate.
+ * @param count The number of items anticipated to be stored in the hash table.
+ * @return A pointer to the hash table on success, `NULL` otherwise.
+ */
+GCU_Hash64 * gcu_hash64_create_in_arena(GCU_Arena * arena, size_t count);
+
+/**
+ * Create a hash table structure with its initial data in the same allocation.
+ *
+ * The structure and room for `count` items are allocated as one block, which
+ * saves an allocation, and keeps the data next to the structure in memory.
+ * Should the hash table outgrow that room, its data moves to a block of its own
+ * (allocated according to its growth policy), and the room is left unused until
+ * the hash table is destroyed, so this suits hash tables whose size is known in
+ * advance.  Destroy it with gcu_hash64_destroy(), as usual.
+ *
+ * @param count The number of items anticipated to be stored in the hash table.
+ * @return A pointer to the hash table on success, `NULL` otherwise.
+ */
+GCU_Hash64 * gcu_hash64_create_embedded(size_t count);
+
 /**
  * Destroy a hash table structure and clean up memory allocations.
  *
@@ -325,6 +382,39 @@ bool gcu_hash64_remove(GCU_Hash64 * hashTable, size_t hash);
  */
 size_t gcu_hash64_count(GCU_Hash64 * hashTable);
 
+/**
+ * Get the bytes of storage which the hash table's data takes, whether or not
+ * all of it is in use.
+ *
+ * The structure itself takes `sizeof(GCU_Hash64)` more.  A hash table whose
+ * growth policy names a budget allocator (see budget.h) is also counted by
+ * the budget.
+ *
+ * @param hashTable The hash table structure on which to operate.
+ * @return The bytes of data storage.
+ */
+size_t gcu_hash64_bytes(GCU_Hash64 * hashTable);
+
+/**
+ * Set how the storage of the hash table grows, and whether it is backed by
+ * huge pages (see growth.h).
+ *
+ * The `factor` of the policy applies to the capacity of the table, which is
+ * kept at least twice the number of entries.  If the table already has
+ * storage which the new policy would allocate differently, then it is moved
+ * to new storage.
+ *
+ * The `arena` of the policy must be the one in which the hash table was
+ * created (or `NULL` if it was not), since storage cannot move between
+ * arenas.
+ *
+ * @param hashTable The hash table structure on which to operate.
+ * @param growth The growth policy.
+ * @return `true` on success, `false` otherwise (in which case the hash table
+ *   is unchanged).
+ */
+bool gcu_hash64_set_growth(GCU_Hash64 * hashTable, GCU_Growth growth);
+
 /**
  * Get an iterator which can be used to iterate through the entries of the
  * hash table.
@@ -398,9 +488,13 @@ typedef struct GCU_Hash32 {
   size_t removed;             ///< The count of non-empty cells that represent
                               ///<   elements which have been removed.
   GCU_Hash32_Cell * data;     ///< A pointer to the array of data cells.
+  bool embedded;              ///< Whether `data` shares the hash table's allocation.
+  GCU_Growth growth;          ///< How the data grows (see gcu_hash32_set_growth()).
   void * supplementary_data;  ///< User-defined.
   GCU_Hash32_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
   GCU_MUTEX_T mutex;          ///< Mutex for thread-safety.
+#endif
 } GCU_Hash32;
 
 /**
@@ -454,6 +548,35 @@ GCU_Hash32 * gcu_hash32_create(size_t count);
  */
 bool gcu_hash32_create_in_place(GCU_Hash32 * hash, size_t count);
 
+/**
+ * Create a hash table structure in an arena.
+ *
+ * Both the structure and its data are allocated from the arena (see
+ * arena.h), and are given back when the arena is reset.  The hash table may
+ * still be passed to gcu_hash32_destroy(), which calls its `cleanup`
+ * function and releases its mutex, but frees no memory.
+ *
+ * @param arena The arena from which to allocate.
+ * @param count The number of items anticipated to be stored in the hash table.
+ * @return A pointer to the hash table on success, `NULL` otherwise.
+ */
+GCU_Hash32 * gcu_hash32_create_in_arena(GCU_Arena * arena, size_t count);
+
+/**
+ * Create a hash table structure with its initial data in the same allocation.
+ *
+ * The structure and room for `count` items are allocated as one block, which
+ * saves an allocation, and keeps the data next to the structure in memory.
+ * Should the hash table outgrow that room, its data moves to a block of its own
+ * (allocated according to its growth policy), and the room is left unused until
+ * the hash table is destroyed, so this suits hash tables whose size is known in
+ * advance.  Destroy it with gcu_hash32_destroy(), as usual.
+ *
+ * @param count The number of items anticipated to be stored in the hash table.
+ * @return A pointer to the hash table on success, `NULL` otherwise.
+ */
+GCU_Hash32 * gcu_hash32_create_embedded(size_t count);
+
 /**
  * Destroy a hash table structure and clean up memory allocations.
  *
@@ -537,6 +660,39 @@ bool gcu_hash32_remove(GCU_Hash32 * hashTable, size_t hash);
  */
 size_t gcu_hash32_count(GCU_Hash32 * hashTable);
 
+/**
+ * Get the bytes of storage which the hash table's data takes, whether or not
+ * all of it is in use.
+ *
+ * The structure itself takes `sizeof(GCU_Hash32)` more.  A hash table whose
+ * growth policy names a budget allocator (see budget.h) is also counted by
+ * the budget.
+ *
+ * @param hashTable The hash table structure on which to operate.
+ * @return The bytes of data storage.
+ */
+size_t gcu_hash32_bytes(GCU_Hash32 * hashTable);
+
+/**
+ * Set how the storage of the hash table grows, and whether it is backed by
+ * huge pages (see growth.h).
+ *
+ * The `factor` of the policy applies to the capacity of the table, which is
+ * kept at least twice the number of entries.  If the table already has
+ * storage which the new policy would allocate differently, then it is moved
+ * to new storage.
+ *
+ * The `arena` of the policy must be the one in which the hash table was
+ * created (or `NULL` if it was not), since storage cannot move between
+ * arenas.
+ *
+ * @param hashTable The hash table structure on which to operate.
+ * @param growth The growth policy.
+ * @return `true` on success, `false` otherwise (in which case the hash table
+ *   is unchanged).
+ */
+bool gcu_hash32_set_growth(GCU_Hash32 * hashTable, GCU_Growth growth);
+
 /**
  * Get an iterator which can be used to iterate through the entries of the
  * hash table.
@@ -610,9 +766,13 @@ typedef struct GCU_Hash16 {
   size_t removed;             ///< The count of non-empty cells that represent
                               ///<   elements which have been removed.
   GCU_Hash16_Cell * data;     ///< A pointer to the array of data cells.
+  bool embedded;              ///< Whether `data` shares the hash table's allocation.
+  GCU_Growth growth;          ///< How the data grows (see gcu_hash16_set_growth()).
   void * supplementary_data;  ///< User-defined.
   GCU_Hash16_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
   GCU_MUTEX_T mutex;          ///< Mutex for thread-safety.
+#endif
 } GCU_Hash16;
 
 /**
@@ -665,6 +825,35 @@ GCU_Hash16 * gcu_hash16_create(size_t count);
  */
 bool gcu_hash16_create_in_place(GCU_Hash16 * hash, size_t count);
 
+/**
+ * Create a hash table structure in an arena.
+ *
+ * Both the structure and its data are allocated from the arena (see
+ * arena.h), and are given back when the arena is reset.  The hash table may
+ * still be passed to gcu_hash16_destroy(), which calls its `cleanup`
+ * function and releases its mutex, but frees no memory.
+ *
+ * @param arena The arena from which to allocate.
+ * @param count The number of items anticipated to be stored in the hash table.
+ * @return A pointer to the hash table on success, `NULL` otherwise.
+ */
+GCU_Hash16 * gcu_hash16_create_in_arena(GCU_Arena * arena, size_t count);
+
+/**
+ * Create a hash table structure with its initial data in the same allocation.
+ *
+ * The structure and room for `count` items are allocated as one block, which
+ * saves an allocation, and keeps the data next to the structure in memory.
+ * Should the hash table outgrow that room, its data moves to a block of its own
+ * (allocated according to its growth policy), and the room is left unused until
+ * the hash table is destroyed, so this suits hash tables whose size is known in
+ * advance.  Destroy it with gcu_hash16_destroy(), as usual.
+ *
+ * @param count The number of items anticipated to be stored in the hash table.
+ * @return A pointer to the hash table on success, `NULL` otherwise.
+ */
+GCU_Hash16 * gcu_hash16_create_embedded(size_t count);
+
 /**
  * Destroy a hash table structure and clean up memory allocations.
  *
@@ -748,6 +937,39 @@ bool gcu_hash16_remove(GCU_Hash16 * hashTable, size_t hash);
  */
 size_t gcu_hash16_count(GCU_Hash16 * hashTable);
 
+/**
+ * Get the bytes of storage which the hash table's data takes, whether or not
+ * all of it is in use.
+ *
+ * The structure itself takes `sizeof(GCU_Hash16)` more.  A hash table whose
+ * growth policy names a budget allocator (see budget.h) is also counted by
+ * the budget.
+ *
+ * @param hashTable The hash table structure on which to operate.
+ * @return The bytes of data storage.
+ */
+size_t gcu_hash16_bytes(GCU_Hash16 * hashTable);
+
+/**
+ * Set how the storage of the hash table grows, and whether it is backed by
+ * huge pages (see growth.h).
+ *
+ * The `factor` of the policy applies to the capacity of the table, which is
+ * kept at least twice the number of entries.  If the table already has
+ * storage which the new policy would allocate differently, then it is moved
+ * to new storage.
+ *
+ * The `arena` of the policy must be the one in which the hash table was
+ * created (or `NULL` if it was not), since storage cannot move between
+ * arenas.
+ *
+ * @param hashTable The hash table structure on which to operate.
+ * @param growth The growth policy.
+ * @return `true` on success, `false` otherwise (in which case the hash table
+ *   is unchanged).
+ */
+bool gcu_hash16_set_growth(GCU_Hash16 * hashTable, GCU_Growth growth);
+
 /**
  * Get an iterator which can be used to iterate through the entries of the
  * hash table.
@@ -820,9 +1042,13 @@ typedef struct GCU_Hash8 {
   size_t removed;            ///< The count of non-empty cells that represent
                              ///<   elements which have been removed.
   GCU_Hash8_Cell * data;     ///< A pointer to the array of data cells.
+  bool embedded;             ///< Whether `data` shares the hash table's allocation.
+  GCU_Growth growth;         ///< How the data grows (see gcu_hash8_set_growth()).
   void * supplementary_data; ///< User-defined.
   GCU_Hash8_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
   GCU_MUTEX_T mutex;         ///< Mutex for thread-safety.
+#endif
 } GCU_Hash8;
 
 /**
@@ -875,6 +1101,35 @@ GCU_Hash8 * gcu_hash8_create(size_t count);
  */
 bool gcu_hash8_create_in_place(GCU_Hash8 * hash, size_t count);
 
+/**
+ * Create a hash table structure in an arena.
+ *
+ * Both the structure and its data are allocated from the arena (see
+ * arena.h), and are given back when the arena is reset.  The hash table may
+ * still be passed to gcu_hash8_destroy(), which calls its `cleanup`
+ * function and releases its mutex, but frees no memory.
+ *
+ * @param arena The arena from which to allocate.
+ * @param count The number of items anticipated to be stored in the hash table.
+ * @return A pointer to the hash table on success, `NULL` otherwise.
+ */
+GCU_Hash8 * gcu_hash8_create_in_arena(GCU_Arena * arena, size_t count);
+
+/**
+ * Create a hash table structure with its initial data in the same allocation.
+ *
+ * The structure and room for `count` items are allocated as one block, which
+ * saves an allocation, and keeps the data next to the structure in memory.
+ * Should the hash table outgrow that room, its data moves to a block of its own
+ * (allocated according to its growth policy), and the room is left unused until
+ * the hash table is destroyed, so this suits hash tables whose size is known in
+ * advance.  Destroy it with gcu_hash8_destroy(), as usual.
+ *
+ * @param count The number of items anticipated to be stored in the hash table.
+ * @return A pointer to the hash table on success, `NULL` otherwise.
+ */
+GCU_Hash8 * gcu_hash8_create_embedded(size_t count);
+
 /**
  * Destroy a hash table structure and clean up memory allocations.
  *
@@ -958,6 +1213,39 @@ bool gcu_hash8_remove(GCU_Hash8 * hashTable, size_t hash);
  */
 size_t gcu_hash8_count(GCU_Hash8 * hashTable);
 
+/**
+ * Get the bytes of storage which the hash table's data takes, whether or not
+ * all of it is in use.
+ *
+ * The structure itself takes `sizeof(GCU_Hash8)` more.  A hash table whose
+ * growth policy names a budget allocator (see budget.h) is also counted by
+ * the budget.
+ *
+ * @param hashTable The hash table structure on which to operate.
+ * @return The bytes of data storage.
+ */
+size_t gcu_hash8_bytes(GCU_Hash8 * hashTable);
+
+/**
+ * Set how the storage of the hash table grows, and whether it is backed by
+ * huge pages (see growth.h).
+ *
+ * The `factor` of the policy applies to the capacity of the table, which is
+ * kept at least twice the number of entries.  If the table already has
+ * storage which the new policy would allocate differently, then it is moved
+ * to new storage.
+ *
+ * The `arena` of the policy must be the one in which the hash table was
+ * created (or `NULL` if it was not), since storage cannot move between
+ * arenas.
+ *
+ * @param hashTable The hash table structure on which to operate.
+ * @param growth The growth policy.
+ * @return `true` on success, `false` otherwise (in which case the hash table
+ *   is unchanged).
+ */
+bool gcu_hash8_set_growth(GCU_Hash8 * hashTable, GCU_Growth growth);
+
 /**
  * Get an iterator which can be used to iterate through the entries of the
  * hash table.
@@ -0,0 +1,286 @@
+/**
+ * @file
+ * A d-ary heap priority queue of 64-bit values.
+ *
+ * The heap is stored in a GCU_Vector64 in the usual implicit layout: the
+ * children of the value at position `i` are at positions `i * arity + 1`
+ * through `i * arity + arity`.  A 4-ary heap (the default) is half as deep as
+ * a binary heap, and the four children of a value are usually on the same
+ * cache line, so it moves less memory when popping from a large heap.
+ *
+ * The order of the heap is chosen when it is created: the smallest or largest
+ * first of the `ui64`, `i64`, or `f64` interpretation of the values, each of
+ * which has its own specialized code, or `GCU_HEAP64_CUSTOM`, in which case
+ * the programmer provides a comparison function.  The position of NaNs in an
+ * `f64` heap is unspecified.
+ *
+ * An indexed heap attaches an id to each value, and keeps a map from each id
+ * to its current position, so that the value of an id can be changed in place
+ * (e.g., decrease-key in Dijkstra's algorithm).  The map is a vector indexed
+ * by id, so ids should be small integers, such as the positions of the items
+ * in another array.
+ */
+
+#ifndef GHOTIIO_CUTIL_HEAP_H
+#define GHOTIIO_CUTIL_HEAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <cutil/mutex.h>
+#include <cutil/vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_Heap64_Cleanup GHOTIIO_CUTIL(GCU_Heap64_Cleanup)
+#define GCU_Heap64_Compare GHOTIIO_CUTIL(GCU_Heap64_Compare)
+#define GCU_Heap64_Order GHOTIIO_CUTIL(GCU_Heap64_Order)
+#define GCU_Heap64_Value GHOTIIO_CUTIL(GCU_Heap64_Value)
+#define GCU_Heap64 GHOTIIO_CUTIL(GCU_Heap64)
+#define gcu_heap64_create GHOTIIO_CUTIL(gcu_heap64_create)
+#define gcu_heap64_create_in_place GHOTIIO_CUTIL(gcu_heap64_create_in_place)
+#define gcu_heap64_destroy GHOTIIO_CUTIL(gcu_heap64_destroy)
+#define gcu_heap64_destroy_in_place GHOTIIO_CUTIL(gcu_heap64_destroy_in_place)
+#define gcu_heap64_push GHOTIIO_CUTIL(gcu_heap64_push)
+#define gcu_heap64_push_id GHOTIIO_CUTIL(gcu_heap64_push_id)
+#define gcu_heap64_heapify GHOTIIO_CUTIL(gcu_heap64_heapify)
+#define gcu_heap64_peek GHOTIIO_CUTIL(gcu_heap64_peek)
+#define gcu_heap64_pop GHOTIIO_CUTIL(gcu_heap64_pop)
+#define gcu_heap64_update GHOTIIO_CUTIL(gcu_heap64_update)
+#define gcu_heap64_contains_id GHOTIIO_CUTIL(gcu_heap64_contains_id)
+#define gcu_heap64_count GHOTIIO_CUTIL(gcu_heap64_count)
+#define gcu_heap64_top_k GHOTIIO_CUTIL(gcu_heap64_top_k)
+/// @endcond
+
+typedef struct GCU_Heap64 GCU_Heap64;
+
+/**
+ * The order in which values come out of a heap.
+ */
+typedef enum {
+  GCU_HEAP64_MIN_UI64, ///< Smallest `ui64` first.
+  GCU_HEAP64_MAX_UI64, ///< Largest `ui64` first.
+  GCU_HEAP64_MIN_I64,  ///< Smallest `i64` first.
+  GCU_HEAP64_MAX_I64,  ///< Largest `i64` first.
+  GCU_HEAP64_MIN_F64,  ///< Smallest `f64` first.
+  GCU_HEAP64_MAX_F64,  ///< Largest `f64` first.
+  GCU_HEAP64_CUSTOM,   ///< The order of the `compare` function of the heap.
+} GCU_Heap64_Order;
+
+/**
+ * Pointer to a function which will be called when the heap destroy function
+ * is called.
+ *
+ * @ref gcu_heap64_destroy
+ *
+ * @param heap The heap which is about to be destroyed.
+ */
+typedef void (* GCU_Heap64_Cleanup)(GCU_Heap64 * heap);
+
+/**
+ * Pointer to a function which orders the values of a `GCU_HEAP64_CUSTOM`
+ * heap.
+ *
+ * @param a The first value.
+ * @param b The second value.
+ * @param data The `compare_data` of the heap.
+ * @return `true` if `a` must come out of the heap before `b`, `false`
+ *   otherwise.
+ */
+typedef bool (* GCU_Heap64_Compare)(GCU_Type64_Union a, GCU_Type64_Union b, void * data);
+
+/**
+ * Container holding the information of the heap.
+ *
+ * `values` holds the values in heap order.  If the heap is indexed, then
+ * `ids.data[i].ui64` is the id of `values.data[i]`, and
+ * `positions.data[id].ui64` is one more than the position of `id` in
+ * `values` (or `0` if `id` is not in the heap).
+ *
+ * A `GCU_HEAP64_CUSTOM` heap calls `compare` (with `compare_data`) to order
+ * its values.  The programmer must set `compare` before adding any values.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the heap is destroyed, the `cleanup`
+ * function will be called (if provided).
+ */
+typedef struct GCU_Heap64 {
+  GCU_Vector64 values;          ///< The values, in heap order.
+  GCU_Vector64 ids;             ///< The id of each value (if indexed).
+  GCU_Vector64 positions;       ///< The position of each id (if indexed).
+  size_t arity;                 ///< The number of children of each value.
+  GCU_Heap64_Order order;       ///< The order of the values.
+  bool indexed;                 ///< Whether or not the values have ids.
+  GCU_Heap64_Compare compare;   ///< The order of a custom heap.
+  void * compare_data;          ///< Passed to `compare`.
+  void * supplementary_data;    ///< User-defined.
+  GCU_Heap64_Cleanup cleanup;   ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;            ///< Mutex for thread-safety.
+#endif
+} GCU_Heap64;
+
+/**
+ * The result of reading or popping the first value of a heap.
+ */
+typedef struct {
+  bool exists;            ///< Whether or not there was a value.
+  GCU_Type64_Union value; ///< The value (if it exists).
+  uint64_t id;            ///< The id of the value (if the heap is indexed).
+} GCU_Heap64_Value;
+
+/**
+ * Create a heap.
+ *
+ * All invocations of a heap must have a corresponding gcu_heap64_destroy()
+ * call in order to clean up dynamically-allocated memory.
+ *
+ * @param count The number of values anticipated to be stored in the heap.
+ * @param arity The number of children of each value, which must be at least
+ *   `2`.  `0` selects the default of `4`.
+ * @param order The order in which values come out of the heap.
+ * @param indexed Whether or not each value has an id, which allows
+ *   gcu_heap64_update() to change its value.
+ * @return A pointer to the heap on success, `NULL` otherwise.
+ */
+GCU_Heap64 * gcu_heap64_create(size_t count, size_t arity, GCU_Heap64_Order order, bool indexed);
+
+/**
+ * Initialize a heap in memory owned by the programmer.
+ *
+ * @param heap The heap to initialize.
+ * @param count The number of values anticipated to be stored in the heap.
+ * @param arity The number of children of each value, which must be at least
+ *   `2`.  `0` selects the default of `4`.
+ * @param order The order in which values come out of the heap.
+ * @param indexed Whether or not each value has an id.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_heap64_create_in_place(GCU_Heap64 * heap, size_t count, size_t arity, GCU_Heap64_Order order, bool indexed);
+
+/**
+ * Destroy a heap and free its memory.
+ *
+ * @param heap The heap to destroy.
+ */
+void gcu_heap64_destroy(GCU_Heap64 * heap);
+
+/**
+ * Destroy a heap which was initialized with gcu_heap64_create_in_place(),
+ * without freeing the heap structure itself.
+ *
+ * @param heap The heap to destroy.
+ */
+void gcu_heap64_destroy_in_place(GCU_Heap64 * heap);
+
+/**
+ * Add a value to a heap which is not indexed.
+ *
+ * @param heap The heap on which to operate.
+ * @param value The value.
+ * @return `true` on success, `false` otherwise (including if the heap is
+ *   indexed).
+ */
+bool gcu_heap64_push(GCU_Heap64 * heap, GCU_Type64_Union value);
+
+/**
+ * Add a value with an id to an indexed heap.
+ *
+ * If the id is already in the heap, then its value is replaced, as with
+ * gcu_heap64_update().
+ *
+ * @param heap The heap on which to operate.
+ * @param value The value.
+ * @param id The id of the value.
+ * @return `true` on success, `false` otherwise (including if the heap is not
+ *   indexed).
+ */
+bool gcu_heap64_push_id(GCU_Heap64 * heap, GCU_Type64_Union value, uint64_t id);
+
+/**
+ * Add many values to a heap which is not indexed.
+ *
+ * If the values are numerous compared to the heap, then they are appended and
+ * the whole heap is rebuilt bottom-up, in time linear in the size of the
+ * heap.  Otherwise, they are added one at a time.
+ *
+ * @param heap The heap on which to operate.
+ * @param values The values.
+ * @param count The number of values.
+ * @return `true` on success, `false` otherwise (in which case the heap is
+ *   unchanged).
+ */
+bool gcu_heap64_heapify(GCU_Heap64 * heap, const GCU_Type64_Union * values, size_t count);
+
+/**
+ * Get the first value of the heap, without removing it.
+ *
+ * @param heap The heap on which to operate.
+ * @return The first value, if the heap is not empty.
+ */
+GCU_Heap64_Value gcu_heap64_peek(GCU_Heap64 * heap);
+
+/**
+ * Remove the first value of the heap.
+ *
+ * @param heap The heap on which to operate.
+ * @return The first value, if the heap was not empty.
+ */
+GCU_Heap64_Value gcu_heap64_pop(GCU_Heap64 * heap);
+
+/**
+ * Change the value of an id in an indexed heap.
+ *
+ * The value may move in either direction, so this is both decrease-key and
+ * increase-key.
+ *
+ * @param heap The heap on which to operate.
+ * @param id The id.
+ * @param value The new value.
+ * @return `true` on success, `false` if the id is not in the heap.
+ */
+bool gcu_heap64_update(GCU_Heap64 * heap, uint64_t id, GCU_Type64_Union value);
+
+/**
+ * Check whether an id is in an indexed heap.
+ *
+ * @param heap The heap on which to operate.
+ * @param id The id.
+ * @return `true` if the id is in the heap, `false` otherwise.
+ */
+bool gcu_heap64_contains_id(GCU_Heap64 * heap, uint64_t id);
+
+/**
+ * Get the number of values in the heap.
+ *
+ * @param heap The heap on which to operate.
+ * @return The number of values.
+ */
+size_t gcu_heap64_count(GCU_Heap64 * heap);
+
+/**
+ * Find the `k` values of a vector which come first in `order`.
+ *
+ * For example, with `GCU_HEAP64_MAX_UI64`, `result` receives the `k` largest
+ * values, largest first.  This takes time proportional to
+ * `count * log(k)`, and memory proportional to `k`.
+ *
+ * @param vector The values to search.
+ * @param k The number of values to find.
+ * @param order The order of the values.  `GCU_HEAP64_CUSTOM` is not
+ *   supported.
+ * @param result The vector which receives the values, in order.  Its previous
+ *   contents are replaced.  If `vector` has fewer than `k` values, then all of
+ *   them are returned.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_heap64_top_k(GCU_Vector64 * vector, size_t k, GCU_Heap64_Order order, GCU_Vector64 * result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_HEAP_H
@@ -0,0 +1,231 @@
+/**
+ * @file
+ * A jagged array of 64-bit values, stored in compressed sparse row form.
+ *
+ * A jagged array is a list of rows, each of which is a list of values, such
+ * as the neighbours of each node of a graph or the postings of each key of an
+ * index.  Rather than one vector per row, every value is stored in a single
+ * `values` vector, row after row, and row `r` is the range from `offsets[r]`
+ * to `offsets[r + 1]`.  So the whole array is two allocations, and reading a
+ * row is two loads which return a view (see view.h) of its values.
+ *
+ * An array is built in one of two ways:
+ *   - In two phases, when the size of each row can be known first.  Each row
+ *     is given its size with gcu_jagged64_add_row_size(), then
+ *     gcu_jagged64_allocate() lays out the rows, and the values are written
+ *     with gcu_jagged64_fill() (or directly through the view returned by
+ *     gcu_jagged64_row()).  Neither phase moves any memory, so threads which
+ *     work on different rows may count and fill them at the same time without
+ *     locking.
+ *   - By appending values to any row in any order with gcu_jagged64_append(),
+ *     which only records them, and then calling gcu_jagged64_compact(), which
+ *     moves them into their rows in a single pass.  Appending and compacting
+ *     may be repeated; the values of each row stay in the order in which they
+ *     were added.
+ *
+ * Rows are numbered from `0`.  Appending to a row past the end adds rows, but
+ * the rows of a two-phase build are fixed when the array is created.
+ */
+
+#ifndef GHOTIIO_CUTIL_JAGGED_H
+#define GHOTIIO_CUTIL_JAGGED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <cutil/mutex.h>
+#include <cutil/vector.h>
+#include <cutil/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_Jagged64_Cleanup GHOTIIO_CUTIL(GCU_Jagged64_Cleanup)
+#define GCU_Jagged64 GHOTIIO_CUTIL(GCU_Jagged64)
+#define gcu_jagged64_create GHOTIIO_CUTIL(gcu_jagged64_create)
+#define gcu_jagged64_create_in_place GHOTIIO_CUTIL(gcu_jagged64_create_in_place)
+#define gcu_jagged64_destroy GHOTIIO_CUTIL(gcu_jagged64_destroy)
+#define gcu_jagged64_destroy_in_place GHOTIIO_CUTIL(gcu_jagged64_destroy_in_place)
+#define gcu_jagged64_add_row_size GHOTIIO_CUTIL(gcu_jagged64_add_row_size)
+#define gcu_jagged64_allocate GHOTIIO_CUTIL(gcu_jagged64_allocate)
+#define gcu_jagged64_fill GHOTIIO_CUTIL(gcu_jagged64_fill)
+#define gcu_jagged64_append GHOTIIO_CUTIL(gcu_jagged64_append)
+#define gcu_jagged64_compact GHOTIIO_CUTIL(gcu_jagged64_compact)
+#define gcu_jagged64_row GHOTIIO_CUTIL(gcu_jagged64_row)
+#define gcu_jagged64_row_count GHOTIIO_CUTIL(gcu_jagged64_row_count)
+#define gcu_jagged64_count GHOTIIO_CUTIL(gcu_jagged64_count)
+/// @endcond
+
+typedef struct GCU_Jagged64 GCU_Jagged64;
+
+/**
+ * Pointer to a function which will be called when the jagged array destroy
+ * function is called.
+ *
+ * @ref gcu_jagged64_destroy
+ *
+ * @param jagged The jagged array which is about to be destroyed.
+ */
+typedef void (* GCU_Jagged64_Cleanup)(GCU_Jagged64 * jagged);
+
+/**
+ * Container holding the information of the jagged array.
+ *
+ * Until gcu_jagged64_allocate() (or gcu_jagged64_compact()) is called,
+ * `offsets[r + 1]` holds the size given to row `r`.  Afterwards, `offsets`
+ * holds `row_count + 1` positions in `values`.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the array is destroyed, the `cleanup`
+ * function will be called (if provided).
+ */
+typedef struct GCU_Jagged64 {
+  size_t row_count;              ///< The number of rows.
+  bool allocated;                ///< Whether or not the rows have been laid out.
+  GCU_Vector64 offsets;          ///< The start of each row (`ui64`), and the end.
+  GCU_Vector64 values;           ///< The values of every row.
+  GCU_Vector64 cursors;          ///< The next position to fill in each row.
+  GCU_Vector64 pending_rows;     ///< The rows of the appended values.
+  GCU_Vector64 pending_values;   ///< The appended values.
+  void * supplementary_data;     ///< User-defined.
+  GCU_Jagged64_Cleanup cleanup;  ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;             ///< Mutex for thread-safety.
+#endif
+} GCU_Jagged64;
+
+/**
+ * Create a jagged array.
+ *
+ * All invocations of a jagged array must have a corresponding
+ * gcu_jagged64_destroy() call in order to clean up dynamically-allocated
+ * memory.
+ *
+ * @param rows The number of rows, each of which is empty.
+ * @param count The number of values anticipated to be stored.
+ * @return A pointer to the jagged array on success, `NULL` otherwise.
+ */
+GCU_Jagged64 * gcu_jagged64_create(size_t rows, size_t count);
+
+/**
+ * Initialize a jagged array in memory owned by the programmer.
+ *
+ * @param jagged The jagged array to initialize.
+ * @param rows The number of rows, each of which is empty.
+ * @param count The number of values anticipated to be stored.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_jagged64_create_in_place(GCU_Jagged64 * jagged, size_t rows, size_t count);
+
+/**
+ * Destroy a jagged array and free its memory.
+ *
+ * @param jagged The jagged array to destroy.
+ */
+void gcu_jagged64_destroy(GCU_Jagged64 * jagged);
+
+/**
+ * Destroy a jagged array which was initialized with
+ * gcu_jagged64_create_in_place(), without freeing the structure itself.
+ *
+ * @param jagged The jagged array to destroy.
+ */
+void gcu_jagged64_destroy_in_place(GCU_Jagged64 * jagged);
+
+/**
+ * Make a row larger, in the first phase of a two-phase build.
+ *
+ * @param jagged The jagged array on which to operate.
+ * @param row The row.
+ * @param count The number of values to add to the size of the row.
+ * @return `true` on success, `false` if the row does not exist or the rows
+ *   have already been laid out.
+ */
+bool gcu_jagged64_add_row_size(GCU_Jagged64 * jagged, size_t row, size_t count);
+
+/**
+ * Lay out the rows, ending the first phase of a two-phase build.
+ *
+ * Every row is filled with zeros, which gcu_jagged64_fill() then overwrites
+ * from the start of the row.
+ *
+ * @param jagged The jagged array on which to operate.
+ * @return `true` on success, `false` if the values could not be allocated
+ *   or the rows have already been laid out.
+ */
+bool gcu_jagged64_allocate(GCU_Jagged64 * jagged);
+
+/**
+ * Write the next value of a row, in the second phase of a two-phase build.
+ *
+ * @param jagged The jagged array on which to operate.
+ * @param row The row.
+ * @param value The value.
+ * @return `true` on success, `false` if the row is full, does not exist, or
+ *   is not being filled.
+ */
+bool gcu_jagged64_fill(GCU_Jagged64 * jagged, size_t row, GCU_Type64_Union value);
+
+/**
+ * Add a value to the end of a row, once the array is next compacted.
+ *
+ * @param jagged The jagged array on which to operate.
+ * @param row The row, which is created (along with any rows before it) if it
+ *   does not exist.
+ * @param value The value.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_jagged64_append(GCU_Jagged64 * jagged, size_t row, GCU_Type64_Union value);
+
+/**
+ * Move the appended values into their rows.
+ *
+ * The rows are laid out again in a new `values` vector, so compacting costs
+ * time proportional to the size of the whole array, and is best done once
+ * after appending a batch of values.  This also ends the filling phase of a
+ * two-phase build, if there is one.
+ *
+ * @param jagged The jagged array on which to operate.
+ * @return `true` on success, `false` otherwise (in which case the array is
+ *   unchanged).
+ */
+bool gcu_jagged64_compact(GCU_Jagged64 * jagged);
+
+/**
+ * Get the values of a row.
+ *
+ * The view is invalidated by the next call to gcu_jagged64_compact(), but its
+ * values may be written in place.
+ *
+ * @param jagged The jagged array on which to operate.
+ * @param row The row.
+ * @return The values, which are empty if the row does not exist or the rows
+ *   have not been laid out.
+ */
+GCU_Vector64_View gcu_jagged64_row(GCU_Jagged64 * jagged, size_t row);
+
+/**
+ * Get the number of rows.
+ *
+ * @param jagged The jagged array on which to operate.
+ * @return The number of rows, including those which only have appended
+ *   values.
+ */
+size_t gcu_jagged64_row_count(GCU_Jagged64 * jagged);
+
+/**
+ * Get the number of values in the rows.
+ *
+ * @param jagged The jagged array on which to operate.
+ * @return The number of values, not including those which have been appended
+ *   but not yet compacted.
+ */
+size_t gcu_jagged64_count(GCU_Jagged64 * jagged);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_JAGGED_H
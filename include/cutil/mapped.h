@@ -0,0 +1,143 @@
+/**
+ * @file
+ * Vectors of 64-bit values whose storage is a memory-mapped file.
+ *
+ * gcu_mapped64_create() returns an ordinary GCU_Vector64 (see vector.h)
+ * whose values live in a file, so code which builds a vector can switch to a
+ * file by changing its constructor, and the vector can be passed to any
+ * function which takes a GCU_Vector64 (the views, sorts, and reductions
+ * included).  The file holds a small header (which records the number of
+ * values) followed by the values themselves, in the byte order of the
+ * machine, so opening an existing file maps it as it is, with no parse step,
+ * however large it is.  Only the pages which are touched are read in, so the
+ * file may be much larger than memory.
+ *
+ * The mapping is the storage of the vector: its growth policy (see growth.h)
+ * names an allocator which grows the file with `ftruncate()` and then grows
+ * the mapping (with `mremap()` on Linux), so `data` may move when the vector
+ * grows, just as it does for any vector.  gcu_vector64_destroy() writes the
+ * count to the header, cuts the file back to the values it holds, and closes
+ * it.  gcu_mapped64_close() does the same, but reports whether it succeeded.
+ * Giving the vector a growth policy with a different allocator moves the
+ * values out of the file, and closes it.
+ *
+ * Another process may map the same file with gcu_mapped64_open().  The
+ * writer publishes its count with gcu_mapped64_publish() (or
+ * gcu_mapped64_sync(), which also waits for the operating system to write the
+ * pages back to the file, as a checkpoint), and a reader picks up what was
+ * published with gcu_mapped64_refresh().  Only one process may write to a
+ * file at a time.
+ *
+ * Mapped vectors are not available on Windows, where creating one fails.
+ */
+
+#ifndef GHOTIIO_CUTIL_MAPPED_H
+#define GHOTIIO_CUTIL_MAPPED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <cutil/vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define gcu_mapped64_create GHOTIIO_CUTIL(gcu_mapped64_create)
+#define gcu_mapped64_open GHOTIIO_CUTIL(gcu_mapped64_open)
+#define gcu_mapped64_is_mapped GHOTIIO_CUTIL(gcu_mapped64_is_mapped)
+#define gcu_mapped64_publish GHOTIIO_CUTIL(gcu_mapped64_publish)
+#define gcu_mapped64_sync GHOTIIO_CUTIL(gcu_mapped64_sync)
+#define gcu_mapped64_refresh GHOTIIO_CUTIL(gcu_mapped64_refresh)
+#define gcu_mapped64_close GHOTIIO_CUTIL(gcu_mapped64_close)
+/// @endcond
+
+/**
+ * Create a vector backed by a file, or reopen one, for reading and writing.
+ *
+ * If the file does not exist, or is empty, it is created with no values.  If
+ * it holds a mapped vector, then its values are kept.
+ *
+ * All invocations of a mapped vector must have a corresponding
+ * gcu_vector64_destroy() (or gcu_mapped64_close()) call in order to unmap
+ * and close the file.
+ *
+ * @param path The path of the file.
+ * @param count The number of values for which room is made in the file.
+ * @return A pointer to the vector on success, `NULL` otherwise (including
+ *   when the file exists but is not a mapped vector).
+ */
+GCU_Vector64 * gcu_mapped64_create(const char * path, size_t count);
+
+/**
+ * Open an existing mapped vector, for reading only.
+ *
+ * The file may be written by another process at the same time.  The vector
+ * cannot grow, and changes to its values stay in this process: they are
+ * never written to the file, and are replaced by the file's values when the
+ * vector is refreshed.
+ *
+ * @param path The path of the file.
+ * @return A pointer to the vector on success, `NULL` otherwise.
+ */
+GCU_Vector64 * gcu_mapped64_open(const char * path);
+
+/**
+ * Determine whether a vector's storage is a mapped file.
+ *
+ * @param vector The vector.
+ * @return `true` if the vector was made by gcu_mapped64_create() or
+ *   gcu_mapped64_open(), and its values are still in the file.
+ */
+bool gcu_mapped64_is_mapped(GCU_Vector64 * vector);
+
+/**
+ * Write the count of a mapped vector to the header of its file, so that
+ * readers in other processes see the values up to it when they refresh.
+ *
+ * The count is written with release ordering, after the values.
+ *
+ * @param vector The vector on which to operate.
+ * @return `true` on success, `false` otherwise (including when the vector is
+ *   not mapped, or is read-only).
+ */
+bool gcu_mapped64_publish(GCU_Vector64 * vector);
+
+/**
+ * Publish the count of a mapped vector, then write the values and the count
+ * back to the file, and wait until that is done.
+ *
+ * @param vector The vector on which to operate.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_mapped64_sync(GCU_Vector64 * vector);
+
+/**
+ * Pick up values which another process has published to the file since it
+ * was opened (or last refreshed).
+ *
+ * The file is mapped again, so `data` may move.
+ *
+ * @param vector The read-only vector on which to operate.
+ * @return `true` on success, `false` otherwise (in which case the vector is
+ *   unchanged).
+ */
+bool gcu_mapped64_refresh(GCU_Vector64 * vector);
+
+/**
+ * Destroy a mapped vector, as gcu_vector64_destroy() does, and report whether
+ * its count was written to the file, and the file cut back to its values.
+ *
+ * The vector is destroyed either way.  If the file could not be cut back, it
+ * keeps some unused room, but is still a valid mapped vector.
+ *
+ * @param vector The vector to destroy.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_mapped64_close(GCU_Vector64 * vector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_MAPPED_H
@@ -17,17 +17,48 @@
  * logging starts and stops externally.  Obviously, if this header is included,
  * then memory management will also be logged, but this feature can be modified
  * by the use of a `#define` *before* including the header.
+ *
+ * Writing a line to `stderr` for every call is slow enough to change how a
+ * program behaves.  gcu_mem_trace_start() instead records each call as a
+ * small binary record in a buffer of the calling thread, which a background
+ * thread writes to a file.  gcu_mem_trace_decode() turns the file back into
+ * the text that would have been logged, and gcu_mem_trace_report() lists the
+ * peak memory use and every leak, by calling location.  The `memtrace` tool
+ * does either from the command line.
+ *
+ * gcu_mem_profile_start() keeps totals in memory instead, for each calling
+ * location: allocations, frees, live and peak bytes, and a histogram of
+ * sizes.  gcu_mem_report() prints them, with the locations holding the most
+ * memory first.
+ *
+ * Every call is counted, along with the bytes allocated and freed.  The
+ * counts are kept per thread, in a cache line of their own, and are only
+ * added together when they are read, so that threads which allocate at the
+ * same time do not write to any shared memory.
  */
 
 #ifndef GHOTIIO_CUTIL_DEBUG_H
 #define GHOTIIO_CUTIL_DEBUG_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
 
 #ifdef _WIN32
 #include <windows.h>
+#elif defined(__APPLE__)
+#include <stdlib.h>
+#include <malloc/malloc.h>
 #else
 #include <stdlib.h>
+#include <malloc.h>
+#endif
+
+#ifdef __cplusplus
+#include <atomic>
+#else
+#include <stdatomic.h>
 #endif
 
 #include <cutil/libver.h>
@@ -39,12 +70,48 @@ extern "C" {
 /// @cond HIDDEN_SYMBOLS
 #define gcu_mem_start GHOTIIO_CUTIL(gcu_mem_start)
 #define gcu_mem_stop GHOTIIO_CUTIL(gcu_mem_stop)
+#define gcu_mem_trace_start GHOTIIO_CUTIL(gcu_mem_trace_start)
+#define gcu_mem_trace_stop GHOTIIO_CUTIL(gcu_mem_trace_stop)
+#define gcu_mem_trace_dropped GHOTIIO_CUTIL(gcu_mem_trace_dropped)
+#define gcu_mem_trace_decode GHOTIIO_CUTIL(gcu_mem_trace_decode)
+#define gcu_mem_trace_report GHOTIIO_CUTIL(gcu_mem_trace_report)
+#define gcu_mem_profile_start GHOTIIO_CUTIL(gcu_mem_profile_start)
+#define gcu_mem_profile_stop GHOTIIO_CUTIL(gcu_mem_profile_stop)
+#define gcu_mem_report GHOTIIO_CUTIL(gcu_mem_report)
 #define gcu_malloc_debug GHOTIIO_CUTIL(gcu_malloc_debug)
 #define gcu_calloc_debug GHOTIIO_CUTIL(gcu_calloc_debug)
 #define gcu_realloc_debug GHOTIIO_CUTIL(gcu_realloc_debug)
 #define gcu_free_debug GHOTIIO_CUTIL(gcu_free_debug)
 #define gcu_get_alloc_count GHOTIIO_CUTIL(gcu_get_alloc_count)
 #define gcu_get_free_count GHOTIIO_CUTIL(gcu_get_free_count)
+#define gcu_get_realloc_count GHOTIIO_CUTIL(gcu_get_realloc_count)
+#define gcu_get_live_bytes GHOTIIO_CUTIL(gcu_get_live_bytes)
+#define gcu_get_peak_bytes GHOTIIO_CUTIL(gcu_get_peak_bytes)
+#define gcu_memory_reset_counts GHOTIIO_CUTIL(gcu_memory_reset_counts)
+#define GCU_Memory_Count GHOTIIO_CUTIL(GCU_Memory_Count)
+#define GCU_Memory_Counters GHOTIIO_CUTIL(GCU_Memory_Counters)
+#define gcu_memory_count_get GHOTIIO_CUTIL(gcu_memory_count_get)
+#define gcu_memory_count_set GHOTIIO_CUTIL(gcu_memory_count_set)
+#define gcu_memory_count_add GHOTIIO_CUTIL(gcu_memory_count_add)
+#define gcu_memory_counters GHOTIIO_CUTIL(gcu_memory_counters)
+#define gcu_memory_counters_claim GHOTIIO_CUTIL(gcu_memory_counters_claim)
+#define gcu_memory_count_allocation GHOTIIO_CUTIL(gcu_memory_count_allocation)
+#define gcu_memory_count_reallocation GHOTIIO_CUTIL(gcu_memory_count_reallocation)
+#define gcu_memory_count_free GHOTIIO_CUTIL(gcu_memory_count_free)
+#define gcu_memory_usable_size GHOTIIO_CUTIL(gcu_memory_usable_size)
+#define gcu_aligned_alloc GHOTIIO_CUTIL(gcu_aligned_alloc)
+#define gcu_aligned_realloc GHOTIIO_CUTIL(gcu_aligned_realloc)
+#define gcu_aligned_free GHOTIIO_CUTIL(gcu_aligned_free)
+#define gcu_aligned_usable_size GHOTIIO_CUTIL(gcu_aligned_usable_size)
+#define GCU_Allocator GHOTIIO_CUTIL(GCU_Allocator)
+#define gcu_allocator GHOTIIO_CUTIL(gcu_allocator)
+#define gcu_system_allocator GHOTIIO_CUTIL(gcu_system_allocator)
+#define gcu_set_allocator GHOTIIO_CUTIL(gcu_set_allocator)
+#define gcu_allocator_allocate GHOTIIO_CUTIL(gcu_allocator_allocate)
+#define gcu_allocator_allocate_zeroed GHOTIIO_CUTIL(gcu_allocator_allocate_zeroed)
+#define gcu_allocator_reallocate GHOTIIO_CUTIL(gcu_allocator_reallocate)
+#define gcu_allocator_free GHOTIIO_CUTIL(gcu_allocator_free)
+#define gcu_allocator_usable_size GHOTIIO_CUTIL(gcu_allocator_usable_size)
 /// @endcond
 
 /**
@@ -59,6 +126,103 @@ void gcu_mem_start(void);
  */
 void gcu_mem_stop(void);
 
+/**
+ * Record intercepted memory management calls in a binary trace file, instead
+ * of logging them to stderr.
+ *
+ * Each thread appends to a buffer of its own, without taking a lock, and a
+ * background thread writes the buffers to the file every millisecond.  A
+ * thread only waits if its buffer is full.  A file name which cannot be
+ * remembered is recorded as "(unknown)".  Calls are still only recorded
+ * while logging is enabled (see gcu_mem_start() and gcu_mem_stop()).
+ *
+ * @param path The file to write, which is replaced if it exists.
+ * @returns True on success, false if the file could not be opened, the
+ *   writing thread could not be started, or a trace is already running.
+ */
+bool gcu_mem_trace_start(const char * path);
+
+/**
+ * Write any buffered records, and close the trace file.
+ *
+ * Calls made by other threads while the trace stops may not be recorded.
+ */
+void gcu_mem_trace_stop(void);
+
+/**
+ * Get the number of calls which were left out of the current (or last)
+ * trace, because the buffer of their thread was full when the trace stopped,
+ * so that nothing would ever have made room for them.
+ *
+ * @returns The number of calls dropped.
+ */
+size_t gcu_mem_trace_dropped(void);
+
+/**
+ * Decode a trace file into the text which would have been logged to stderr.
+ *
+ * Records are written in the order in which they were made, across all
+ * threads.
+ *
+ * @param trace The trace file, opened for binary reading.
+ * @param out Where to write the text.
+ * @returns True on success, false if the trace could not be read.
+ */
+bool gcu_mem_trace_decode(FILE * trace, FILE * out);
+
+/**
+ * Report the peak memory use in a trace file, and the memory which was never
+ * freed, grouped by the location which allocated it.
+ *
+ * Sizes are those requested by the caller.
+ *
+ * @param trace The trace file, opened for binary reading.
+ * @param out Where to write the report.
+ * @returns True on success, false if the trace could not be read.
+ */
+bool gcu_mem_trace_report(FILE * trace, FILE * out);
+
+/**
+ * Keep totals of the intercepted memory management calls for each calling
+ * location.
+ *
+ * Each allocation is remembered, by its address, in a table split into
+ * shards with a lock each, so that threads rarely wait for each other, and
+ * so that a free can be charged to the location of the allocation.  Memory
+ * which was allocated before the profile started is ignored when it is
+ * freed.  Profiling does not depend on logging being enabled, so it may be
+ * used with gcu_mem_stop().
+ *
+ * Any earlier totals are discarded.  Other threads may go on allocating and
+ * freeing memory meanwhile, but a block which they free while the totals are
+ * discarded may be left out of the new totals.
+ *
+ * @param report_leaks_at_exit Whether to print the locations which still
+ *   hold memory to stderr when the program exits.
+ * @returns True on success, false if the tables could not be allocated.
+ */
+bool gcu_mem_profile_start(bool report_leaks_at_exit);
+
+/**
+ * Stop adding to the profile.  The totals are kept for gcu_mem_report().
+ */
+void gcu_mem_profile_stop(void);
+
+/**
+ * Print the profile totals for each calling location, those holding the
+ * most live bytes first (then those with the highest peak).
+ *
+ * Each line reads:
+ *
+ *     file(line) | allocations | frees | live bytes | peak bytes | sizes
+ *
+ * where the sizes are a histogram of the sizes requested, as counts of sizes
+ * up to 16 bytes, 32 bytes, and so on.
+ *
+ * @param out Where to write the report.
+ */
+void gcu_mem_report(FILE * out);
+
 /**
  * Cross-platform wrapper for the standard malloc() function.
  *
@@ -112,7 +276,7 @@ void gcu_free_debug(void * pointer, const char * file, size_t line);
  * Get the number of times memory has been allocated.
  *
  * Calls to gcu_malloc() and gcu_calloc() are counted.  Calls to gcu_realloc()
- * are not counted.
+ * are counted separately, by gcu_get_realloc_count().
  *
  * @returns The number of times memory has been allocated.
  */
@@ -128,31 +292,384 @@ size_t gcu_get_alloc_count(void);
 size_t gcu_get_free_count(void);
 
 /**
- * Reset the memory allocation and free counts to zero.
+ * Get the number of times memory has been reallocated.
+ *
+ * Calls to gcu_realloc() are counted.
+ *
+ * @returns The number of times memory has been reallocated.
+ */
+size_t gcu_get_realloc_count(void);
+
+/**
+ * Get the number of bytes allocated and not yet freed.
+ *
+ * Sizes are those which the system allocator actually reserved for each
+ * block, which may be a little more than was requested.  Memory which was
+ * allocated before the last call to gcu_memory_reset_counts() is not
+ * counted, and neither is freeing it.
+ *
+ * @returns The number of bytes in use.
+ */
+size_t gcu_get_live_bytes(void);
+
+/**
+ * Get the largest number of bytes which have been in use at once.
+ *
+ * Each thread tracks the peak of what it has allocated less what it has
+ * freed, and the peaks are added together.  With one allocating thread the
+ * result is exact.  Otherwise it is an upper bound, as the threads may not
+ * have reached their peaks at the same time, and it is looser still when
+ * memory is freed by a thread other than the one which allocated it.
+ *
+ * @returns The peak number of bytes in use.
+ */
+size_t gcu_get_peak_bytes(void);
+
+/**
+ * Reset all of the memory counts to zero.
+ *
+ * This should only be called while no other thread is allocating memory,
+ * since it writes to the counts of every thread.
  */
 void gcu_memory_reset_counts(void);
 
 /**
- * The number of times memory has been allocated.
+ * One memory count, which is written by the thread which owns it, and read by
+ * any thread.
+ *
+ * Do not access it directly.  It is atomic so that it may be read while it
+ * is written, but since only its owner writes it, it is only ever loaded and
+ * stored, with relaxed ordering, which costs no more than a plain `size_t`.
+ */
+#ifdef __cplusplus
+typedef std::atomic<size_t> GCU_Memory_Count;
+#else
+typedef _Atomic size_t GCU_Memory_Count;
+#endif
+
+/**
+ * Read a memory count.
+ *
+ * Do not call this function directly.
+ *
+ * @param count The count.
+ * @returns The value of the count.
+ */
+static inline size_t gcu_memory_count_get(const GCU_Memory_Count * count) {
+#ifdef __cplusplus
+  return count->load(std::memory_order_relaxed);
+#else
+  return atomic_load_explicit(count, memory_order_relaxed);
+#endif
+}
+
+/**
+ * Write a memory count.
+ *
+ * Do not call this function directly.
+ *
+ * @param count The count.
+ * @param value The value to write.
+ */
+static inline void gcu_memory_count_set(GCU_Memory_Count * count, size_t value) {
+#ifdef __cplusplus
+  count->store(value, std::memory_order_relaxed);
+#else
+  atomic_store_explicit(count, value, memory_order_relaxed);
+#endif
+}
+
+/**
+ * Add to a memory count of the calling thread.
  *
- * Do not access this variable directly.  Use gcu_get_alloc_count() instead.
- * It appears here simply so that gcu_malloc() and gcu_calloc() can be inlined.
+ * Do not call this function directly.
+ *
+ * @param count The count, which belongs to the calling thread.
+ * @param value The value to add.
+ */
+static inline void gcu_memory_count_add(GCU_Memory_Count * count, size_t value) {
+  gcu_memory_count_set(count, gcu_memory_count_get(count) + value);
+}
+
+/**
+ * The memory counts of one thread.
+ *
+ * Do not access this structure directly.  Use the gcu_get_*() functions
+ * instead.  It appears here simply so that gcu_malloc() and the other memory
+ * functions can be inlined.
+ *
+ * Each thread writes only to its own counts.  When a thread exits, its
+ * counts are kept, and are added to by the next thread which is given them.
  */
-extern size_t gcu_memory_alloc_count;
+typedef struct GCU_Memory_Counters {
+  GCU_Memory_Count allocations;     ///< Calls to gcu_malloc() and
+                                    ///<   gcu_calloc().
+  GCU_Memory_Count frees;           ///< Calls to gcu_free().
+  GCU_Memory_Count reallocations;   ///< Calls to gcu_realloc().
+  GCU_Memory_Count allocated_bytes; ///< Bytes allocated, in total.
+  GCU_Memory_Count freed_bytes;     ///< Bytes freed, in total.
+  GCU_Memory_Count peak_bytes;      ///< The peak of allocated less freed
+                                    ///<   bytes.
+  struct GCU_Memory_Counters * next; ///< The next counts, of any thread.
+  bool in_use;            ///< Whether a thread is using the counts.
+} GCU_Memory_Counters;
 
 /**
- * The number of times memory has been freed.
+ * The memory counts of the calling thread, or `NULL` if it has not yet
+ * allocated memory.
+ *
+ * Do not access this variable directly.
+ */
+#ifdef __cplusplus
+extern thread_local GCU_Memory_Counters * gcu_memory_counters;
+#else
+extern _Thread_local GCU_Memory_Counters * gcu_memory_counters;
+#endif
+
+/**
+ * Give the calling thread its memory counts.
+ *
+ * Do not call this function directly.
  *
- * Do not access this variable directly.  Use gcu_get_free_count() instead.
- * It appears here simply so that gcu_free() can be inlined.
+ * @returns The counts of the calling thread.
  */
-extern size_t gcu_memory_free_count;
+GCU_Memory_Counters * gcu_memory_counters_claim(void);
+
+/**
+ * Count an allocation by the calling thread.
+ *
+ * This is for allocators built on something other than gcu_malloc(), such
+ * as memory-mapped storage, so that their memory is counted too.
+ *
+ * @param bytes The number of bytes allocated.
+ */
+static inline void gcu_memory_count_allocation(size_t bytes) {
+  GCU_Memory_Counters * counters = gcu_memory_counters
+    ? gcu_memory_counters
+    : gcu_memory_counters_claim();
+  gcu_memory_count_add(&counters->allocations, 1);
+  gcu_memory_count_add(&counters->allocated_bytes, bytes);
+  size_t live = gcu_memory_count_get(&counters->allocated_bytes) - gcu_memory_count_get(&counters->freed_bytes);
+  if ((ptrdiff_t)live > (ptrdiff_t)gcu_memory_count_get(&counters->peak_bytes)) {
+    gcu_memory_count_set(&counters->peak_bytes, live);
+  }
+}
+
+/**
+ * Count a reallocation by the calling thread.
+ *
+ * @param before The number of bytes before the reallocation.
+ * @param after The number of bytes after the reallocation.
+ */
+static inline void gcu_memory_count_reallocation(size_t before, size_t after) {
+  GCU_Memory_Counters * counters = gcu_memory_counters
+    ? gcu_memory_counters
+    : gcu_memory_counters_claim();
+  gcu_memory_count_add(&counters->reallocations, 1);
+  gcu_memory_count_add(&counters->allocated_bytes, after);
+  gcu_memory_count_add(&counters->freed_bytes, before);
+  size_t live = gcu_memory_count_get(&counters->allocated_bytes) - gcu_memory_count_get(&counters->freed_bytes);
+  if ((ptrdiff_t)live > (ptrdiff_t)gcu_memory_count_get(&counters->peak_bytes)) {
+    gcu_memory_count_set(&counters->peak_bytes, live);
+  }
+}
+
+/**
+ * Count a free by the calling thread.
+ *
+ * @param bytes The number of bytes freed.
+ */
+static inline void gcu_memory_count_free(size_t bytes) {
+  GCU_Memory_Counters * counters = gcu_memory_counters
+    ? gcu_memory_counters
+    : gcu_memory_counters_claim();
+  gcu_memory_count_add(&counters->frees, 1);
+  gcu_memory_count_add(&counters->freed_bytes, bytes);
+}
+
+/**
+ * Get the number of bytes which the system allocator reserved for a block.
+ *
+ * @param pointer The block, or `NULL`.
+ * @returns The size of the block, or 0 for `NULL`.
+ */
+static inline size_t gcu_memory_usable_size(void * pointer) {
+  if (!pointer) {
+    return 0;
+  }
+#ifdef _WIN32
+  return HeapSize(GetProcessHeap(), 0, pointer);
+#elif defined(__APPLE__)
+  return malloc_size(pointer);
+#else
+  return malloc_usable_size(pointer);
+#endif
+}
+
+/**
+ * An allocator, to which gcu_malloc() and the other memory functions, or the
+ * storage of a single container, can be directed.
+ *
+ * Each function is given `context`, so that one set of functions can serve
+ * several arenas, pools, or heaps.  Memory must be freed by the allocator
+ * which allocated it, so an allocator should be chosen before any memory is
+ * allocated from it, and kept until all of that memory is freed.
+ */
+typedef struct GCU_Allocator {
+  void * (*allocate)(void * context, size_t size); ///< As malloc().
+  void * (*allocate_zeroed)(void * context, size_t nitems, size_t size); ///<
+                          ///<   As calloc().
+  void * (*reallocate)(void * context, void * pointer, size_t size); ///< As
+                          ///<   realloc().
+  void (*free)(void * context, void * pointer); ///< As free().
+  size_t (*usable_size)(void * context, void * pointer); ///< The size of a
+                          ///<   block, or `NULL` if the allocator cannot
+                          ///<   tell, in which case its blocks are counted
+                          ///<   as empty.
+  void * context;         ///< The argument passed to each function.
+} GCU_Allocator;
+
+/**
+ * The allocator used by gcu_malloc() and the other memory functions, or
+ * `NULL` for the system's.
+ *
+ * Do not access this variable directly.  Use gcu_set_allocator() instead.
+ */
+extern const GCU_Allocator * gcu_allocator;
+
+/**
+ * An allocator which calls the system's functions directly, as gcu_malloc()
+ * does by default.  It is a starting point for allocators which pass most
+ * calls through.
+ */
+extern const GCU_Allocator gcu_system_allocator;
+
+/**
+ * Direct gcu_malloc() and the other memory functions, and so every container
+ * which does not have an allocator of its own, to an allocator.
+ *
+ * This should be called while no other thread is allocating memory, and
+ * memory must be freed by the allocator which was in use when it was
+ * allocated, so it is best called once, at startup.
+ *
+ * @param allocator The allocator, or `NULL` for the system's.
+ * @returns The allocator which was in use.
+ */
+const GCU_Allocator * gcu_set_allocator(const GCU_Allocator * allocator);
+
+/**
+ * Get the size of a block from an allocator, for counting.
+ *
+ * @param allocator The allocator, or `NULL` for the system's.
+ * @param pointer The block, or `NULL`.
+ * @returns The size of the block, or 0 if it is not known.
+ */
+static inline size_t gcu_allocator_usable_size(const GCU_Allocator * allocator, void * pointer) {
+  if (!allocator) {
+    return gcu_memory_usable_size(pointer);
+  }
+  return pointer && allocator->usable_size
+    ? allocator->usable_size(allocator->context, pointer)
+    : 0;
+}
+
+/**
+ * Allocate memory from an allocator, counting it as gcu_malloc() does.
+ *
+ * @param allocator The allocator, or `NULL` for the system's.
+ * @param size The number of bytes requested.
+ * @returns The memory, or `NULL` on failure.
+ */
+static inline void * gcu_allocator_allocate(const GCU_Allocator * allocator, size_t size) {
+#ifdef _WIN32
+  void * result = allocator
+    ? allocator->allocate(allocator->context, size)
+    : HeapAlloc(GetProcessHeap(), 0, size);
+#else
+  void * result = allocator
+    ? allocator->allocate(allocator->context, size)
+    : malloc(size);
+#endif
+  gcu_memory_count_allocation(gcu_allocator_usable_size(allocator, result));
+  return result;
+}
+
+/**
+ * Allocate zeroed memory from an allocator, counting it as gcu_calloc() does.
+ *
+ * @param allocator The allocator, or `NULL` for the system's.
+ * @param nitems The number of items to allocate.
+ * @param size The number of bytes in each item.
+ * @returns The memory, or `NULL` on failure.
+ */
+static inline void * gcu_allocator_allocate_zeroed(const GCU_Allocator * allocator, size_t nitems, size_t size) {
+#ifdef _WIN32
+  void * result = allocator
+    ? allocator->allocate_zeroed(allocator->context, nitems, size)
+    : HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, nitems * size);
+#else
+  void * result = allocator
+    ? allocator->allocate_zeroed(allocator->context, nitems, size)
+    : calloc(nitems, size);
+#endif
+  gcu_memory_count_allocation(gcu_allocator_usable_size(allocator, result));
+  return result;
+}
+
+/**
+ * Resize memory from an allocator, counting it as gcu_realloc() does.
+ *
+ * @param allocator The allocator which allocated the memory, or `NULL` for
+ *   the system's.
+ * @param pointer The memory.
+ * @param size The newly requested size.
+ * @returns The memory, or `NULL` on failure.
+ */
+static inline void * gcu_allocator_reallocate(const GCU_Allocator * allocator, void * pointer, size_t size) {
+  size_t before = gcu_allocator_usable_size(allocator, pointer);
+#ifdef _WIN32
+  void * result = allocator
+    ? allocator->reallocate(allocator->context, pointer, size)
+    : HeapReAlloc(GetProcessHeap(), 0, pointer, size);
+#else
+  void * result = allocator
+    ? allocator->reallocate(allocator->context, pointer, size)
+    : realloc(pointer, size);
+#endif
+  gcu_memory_count_reallocation(result || !size ? before : 0, gcu_allocator_usable_size(allocator, result));
+  return result;
+}
+
+/**
+ * Free memory from an allocator, counting it as gcu_free() does.
+ *
+ * @param allocator The allocator which allocated the memory, or `NULL` for
+ *   the system's.
+ * @param pointer The memory, or `NULL`.
+ */
+static inline void gcu_allocator_free(const GCU_Allocator * allocator, void * pointer) {
+  gcu_memory_count_free(gcu_allocator_usable_size(allocator, pointer));
+#ifdef _WIN32
+  if (!allocator) {
+    HeapFree(GetProcessHeap(), 0, pointer);
+    return;
+  }
+#else
+  if (!allocator) {
+    free(pointer);
+    return;
+  }
+#endif
+  allocator->free(allocator->context, pointer);
+}
 
 #if DOXYGEN
 
 /**
  * Cross-platform wrapper for the standard malloc() function.
  *
+ * The memory comes from the allocator set with gcu_set_allocator(), if any.
+ *
  * @param size The number of bytes requested.
  * @returns The beginning byte of the allocated memory.
  */
@@ -206,51 +723,178 @@ void gcu_free(void * pointer);
 // Since we aren't doing any debugging, define the functions here in the header
 // so that they can be inline-optimized.
 
-#ifdef _WIN32 // Windows target
-
 static inline void * gcu_malloc(size_t size) {
-  ++gcu_memory_alloc_count;
-  return HeapAlloc(GetProcessHeap(), 0, size);
+  return gcu_allocator_allocate(gcu_allocator, size);
 }
 
 static inline void * gcu_calloc(size_t nitems, size_t size) {
-  ++gcu_memory_alloc_count;
-  return HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, nitems * size);
+  return gcu_allocator_allocate_zeroed(gcu_allocator, nitems, size);
 }
 
 static inline void * gcu_realloc(void * pointer, size_t size) {
-  return HeapReAlloc(GetProcessHeap(), 0, pointer, size);
+  return gcu_allocator_reallocate(gcu_allocator, pointer, size);
 }
 
 static inline void gcu_free(void * pointer) {
-  ++gcu_memory_free_count;
-  HeapFree(GetProcessHeap(), 0, pointer);
+  gcu_allocator_free(gcu_allocator, pointer);
 }
 
-#else // Linux target
+#endif // GHOTIIO_CUTIL_ENABLE_MEMORY_DEBUG
 
-static inline void * gcu_malloc(size_t size) {
-  ++gcu_memory_alloc_count;
-  return malloc(size);
+/**
+ * The size of a cache line, assumed to be 64 bytes.
+ */
+#define GCU_CACHELINE_SIZE 64
+
+/**
+ * Align a structure member (or variable) to a cache line of its own.
+ *
+ * Data written by different threads should be kept on different cache lines,
+ * or each write by one thread evicts the line from the others' caches
+ * ("false sharing").  Placing `GCU_CACHELINE` before the first member of each
+ * such group pads the structure so that the groups never share a line:
+ *
+ *     typedef struct {
+ *       GCU_CACHELINE size_t head;
+ *       GCU_CACHELINE size_t tail;
+ *     } Indices;
+ *
+ * A structure containing such members must itself be allocated with at least
+ * that alignment, for example with gcu_aligned_alloc().
+ */
+#ifdef __cplusplus
+#define GCU_CACHELINE alignas(GCU_CACHELINE_SIZE)
+#else
+#define GCU_CACHELINE _Alignas(GCU_CACHELINE_SIZE)
+#endif
+
+/**
+ * Allocate memory with a given alignment.
+ *
+ * The memory is counted as an allocation, like that from gcu_malloc(), but
+ * calls are not logged, traced, or profiled.  It must be freed with
+ * gcu_aligned_free().
+ *
+ * @param alignment The alignment, in bytes, which must be a power of two.
+ * @param size The number of bytes requested.
+ * @returns The memory, or `NULL` on failure.
+ */
+static inline void * gcu_aligned_alloc(size_t alignment, size_t size);
+
+/**
+ * Change the size of memory from gcu_aligned_alloc(), keeping its contents
+ * and its alignment.
+ *
+ * The contents are always copied, since the system cannot be asked to keep
+ * the alignment when it grows a block.  The call is counted as a
+ * reallocation.
+ *
+ * @param pointer The memory, or `NULL`.
+ * @param alignment The alignment, in bytes, which must be a power of two.
+ * @param size The newly requested size.
+ * @returns The memory, or `NULL` on failure (in which case `pointer` is
+ *   unchanged).
+ */
+static inline void * gcu_aligned_realloc(void * pointer, size_t alignment, size_t size);
+
+/**
+ * Free memory from gcu_aligned_alloc() or gcu_aligned_realloc().
+ *
+ * @param pointer The memory, or `NULL`.
+ */
+static inline void gcu_aligned_free(void * pointer);
+
+/// @cond HIDDEN_SYMBOLS
+#ifdef _WIN32 // Windows target
+
+// The heap does not align beyond 16 bytes, so the block is over-allocated and
+// the pointer to its start is kept just before the aligned memory.
+
+static inline void * gcu_aligned_alloc(size_t alignment, size_t size) {
+  if (alignment < sizeof(void *)) {
+    alignment = sizeof(void *);
+  }
+  if (size > (size_t)-1 - alignment - sizeof(void *)) {
+    return NULL;
+  }
+  char * block = (char *)HeapAlloc(GetProcessHeap(), 0, size + alignment - 1 + sizeof(void *));
+  if (!block) {
+    return NULL;
+  }
+  void * result = (void *)(((size_t)(block + sizeof(void *)) + alignment - 1) & ~(alignment - 1));
+  ((void **)result)[-1] = block;
+  gcu_memory_count_allocation(HeapSize(GetProcessHeap(), 0, block));
+  return result;
 }
 
-static inline void * gcu_calloc(size_t nitems, size_t size) {
-  ++gcu_memory_alloc_count;
-  return calloc(nitems, size);
+static inline void gcu_aligned_free(void * pointer) {
+  void * block = pointer
+    ? ((void **)pointer)[-1]
+    : NULL;
+  gcu_memory_count_free(block ? HeapSize(GetProcessHeap(), 0, block) : 0);
+  HeapFree(GetProcessHeap(), 0, block);
 }
 
-static inline void * gcu_realloc(void * pointer, size_t size) {
-  return realloc(pointer, size);
+static inline size_t gcu_aligned_usable_size(void * pointer) {
+  char * block = (char *)((void **)pointer)[-1];
+  return HeapSize(GetProcessHeap(), 0, block) - (size_t)((char *)pointer - block);
 }
 
-static inline void gcu_free(void * pointer) {
-  ++gcu_memory_free_count;
+#else // Linux target
+
+static inline void * gcu_aligned_alloc(size_t alignment, size_t size) {
+  if (alignment < sizeof(void *)) {
+    alignment = sizeof(void *);
+  }
+
+  // aligned_alloc() may insist on a size which is a multiple of the alignment.
+  size_t rounded = (size + alignment - 1) & ~(alignment - 1);
+  if (rounded < size) {
+    return NULL;
+  }
+  void * result = aligned_alloc(alignment, rounded
+    ? rounded
+    : alignment);
+  gcu_memory_count_allocation(gcu_memory_usable_size(result));
+  return result;
+}
+
+static inline void gcu_aligned_free(void * pointer) {
+  gcu_memory_count_free(gcu_memory_usable_size(pointer));
   free(pointer);
 }
 
+static inline size_t gcu_aligned_usable_size(void * pointer) {
+  return gcu_memory_usable_size(pointer);
+}
+
 #endif // _WIN32/Linux
 
-#endif // GHOTIIO_CUTIL_ENABLE_MEMORY_DEBUG
+static inline void * gcu_aligned_realloc(void * pointer, size_t alignment, size_t size) {
+  if (!pointer) {
+    return gcu_aligned_alloc(alignment, size);
+  }
+  void * result = gcu_aligned_alloc(alignment, size);
+  if (!result) {
+    return NULL;
+  }
+  size_t before = gcu_aligned_usable_size(pointer);
+  memcpy(result, pointer, before < size
+    ? before
+    : size);
+  gcu_aligned_free(pointer);
+
+  // The new block and the freed one were each counted, so they are counted
+  // again as a single reallocation.
+  GCU_Memory_Counters * counters = gcu_memory_counters
+    ? gcu_memory_counters
+    : gcu_memory_counters_claim();
+  --counters->allocations;
+  --counters->frees;
+  ++counters->reallocations;
+  return result;
+}
+/// @endcond
 
 #ifdef __cplusplus
 }
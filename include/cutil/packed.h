@@ -0,0 +1,280 @@
+/**
+ * @file
+ * A compressed, append-only vector of 64-bit integers.
+ *
+ * Values are encoded in blocks of GCU_PACKED64_BLOCK_SIZE.  Each block is
+ * encoded in whichever of two ways needs fewer bits per value:
+ *   - Frame of reference: the smallest value of the block is stored once, and
+ *     each value is stored as its (unsigned) distance from it.
+ *   - Delta: the first value of the block is stored once, and each value is
+ *     stored as its (signed) difference from the previous value, less the
+ *     smallest such difference.  Subtracting the smallest difference makes the
+ *     packed differences unsigned, so this needs no zig-zag step, and a series
+ *     with a steady stride (such as timestamps) packs into almost nothing.
+ *
+ * The packed numbers of a block are all given the same width, which is the
+ * fewest bits that hold the largest of them.  A block of 128 equal values, or
+ * of 128 evenly spaced values, takes no space beyond its header.
+ *
+ * The numbers are interleaved across four lanes (number `i` is in lane
+ * `i % 4`), so that decoding shifts and masks four numbers at a time, which
+ * the compiler turns into vector instructions.  Every block can be decoded
+ * on its own, so values can be read at random by block, and the aggregation
+ * functions scan the blocks through a small buffer, without decoding the
+ * whole vector.
+ *
+ * The values are treated as `ui64`, but `i64` values round-trip unchanged,
+ * and series of small signed numbers pack well with the delta encoding.
+ */
+
+#ifndef GHOTIIO_CUTIL_PACKED_H
+#define GHOTIIO_CUTIL_PACKED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <cutil/mutex.h>
+#include <cutil/vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_Packed64_Cleanup GHOTIIO_CUTIL(GCU_Packed64_Cleanup)
+#define GCU_Packed64_Encoding GHOTIIO_CUTIL(GCU_Packed64_Encoding)
+#define GCU_Packed64_Block GHOTIIO_CUTIL(GCU_Packed64_Block)
+#define GCU_Packed64_Value GHOTIIO_CUTIL(GCU_Packed64_Value)
+#define GCU_Packed64 GHOTIIO_CUTIL(GCU_Packed64)
+#define gcu_packed64_create GHOTIIO_CUTIL(gcu_packed64_create)
+#define gcu_packed64_create_in_place GHOTIIO_CUTIL(gcu_packed64_create_in_place)
+#define gcu_packed64_destroy GHOTIIO_CUTIL(gcu_packed64_destroy)
+#define gcu_packed64_destroy_in_place GHOTIIO_CUTIL(gcu_packed64_destroy_in_place)
+#define gcu_packed64_append_many GHOTIIO_CUTIL(gcu_packed64_append_many)
+#define gcu_packed64_count GHOTIIO_CUTIL(gcu_packed64_count)
+#define gcu_packed64_size GHOTIIO_CUTIL(gcu_packed64_size)
+#define gcu_packed64_get GHOTIIO_CUTIL(gcu_packed64_get)
+#define gcu_packed64_decode_block GHOTIIO_CUTIL(gcu_packed64_decode_block)
+#define gcu_packed64_decode GHOTIIO_CUTIL(gcu_packed64_decode)
+#define gcu_packed64_sum_ui64 GHOTIIO_CUTIL(gcu_packed64_sum_ui64)
+#define gcu_packed64_min_ui64 GHOTIIO_CUTIL(gcu_packed64_min_ui64)
+#define gcu_packed64_max_ui64 GHOTIIO_CUTIL(gcu_packed64_max_ui64)
+#define gcu_packed64_count_range_ui64 GHOTIIO_CUTIL(gcu_packed64_count_range_ui64)
+/// @endcond
+
+/**
+ * The number of values in each block.
+ */
+#define GCU_PACKED64_BLOCK_SIZE 128
+
+typedef struct GCU_Packed64 GCU_Packed64;
+
+/**
+ * Pointer to a function which will be called when the packed vector destroy
+ * function is called.
+ *
+ * @ref gcu_packed64_destroy
+ *
+ * @param packed The packed vector which is about to be destroyed.
+ */
+typedef void (* GCU_Packed64_Cleanup)(GCU_Packed64 * packed);
+
+/**
+ * The ways in which a block may be encoded.
+ */
+typedef enum {
+  GCU_PACKED64_FRAME_OF_REFERENCE, ///< Distances from the smallest value.
+  GCU_PACKED64_DELTA,              ///< Differences from the previous value.
+} GCU_Packed64_Encoding;
+
+/**
+ * The header of a block of packed values.
+ */
+typedef struct {
+  uint64_t base;     ///< The smallest value (frame of reference), or the first value (delta).
+  uint64_t delta;    ///< The smallest difference between neighbours (delta only).
+  size_t start;      ///< The position of the first word of the block in `words`.
+  uint8_t bits;      ///< The width of each packed number.
+  uint8_t encoding;  ///< A GCU_Packed64_Encoding.
+} GCU_Packed64_Block;
+
+/**
+ * Container holding the information of the packed vector.
+ *
+ * Block `b` holds values `b * GCU_PACKED64_BLOCK_SIZE` onwards.  Only the
+ * last block may hold fewer than GCU_PACKED64_BLOCK_SIZE values.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the vector is destroyed, the `cleanup`
+ * function will be called (if provided).
+ */
+typedef struct GCU_Packed64 {
+  size_t count;                  ///< The number of values.
+  size_t block_count;            ///< The number of blocks.
+  size_t block_capacity;         ///< The number of blocks with room allocated.
+  GCU_Packed64_Block * blocks;   ///< The block headers.
+  size_t word_count;             ///< The number of words of packed numbers.
+  size_t word_capacity;          ///< The number of words with room allocated.
+  uint64_t * words;              ///< The packed numbers of every block.
+  void * supplementary_data;     ///< User-defined.
+  GCU_Packed64_Cleanup cleanup;  ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;             ///< Mutex for thread-safety.
+#endif
+} GCU_Packed64;
+
+/**
+ * The result of reading a value from a packed vector.
+ */
+typedef struct {
+  bool exists;            ///< Whether or not the index was in range.
+  GCU_Type64_Union value; ///< The value (if it exists).
+} GCU_Packed64_Value;
+
+/**
+ * Create a packed vector.
+ *
+ * All invocations of a packed vector must have a corresponding
+ * gcu_packed64_destroy() call in order to clean up dynamically-allocated
+ * memory.
+ *
+ * @param count The number of values anticipated to be stored, for which room
+ *   is made in the block headers.
+ * @return A pointer to the packed vector on success, `NULL` otherwise.
+ */
+GCU_Packed64 * gcu_packed64_create(size_t count);
+
+/**
+ * Initialize a packed vector in memory owned by the programmer.
+ *
+ * @param packed The packed vector to initialize.
+ * @param count The number of values anticipated to be stored.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_packed64_create_in_place(GCU_Packed64 * packed, size_t count);
+
+/**
+ * Destroy a packed vector and free its memory.
+ *
+ * @param packed The packed vector to destroy.
+ */
+void gcu_packed64_destroy(GCU_Packed64 * packed);
+
+/**
+ * Destroy a packed vector which was initialized with
+ * gcu_packed64_create_in_place(), without freeing the structure itself.
+ *
+ * @param packed The packed vector to destroy.
+ */
+void gcu_packed64_destroy_in_place(GCU_Packed64 * packed);
+
+/**
+ * Append values to the end of a packed vector.
+ *
+ * If the last block is not full, it is decoded and encoded again together
+ * with the new values, so appending in large batches is much cheaper than
+ * appending a few values at a time.
+ *
+ * @param packed The packed vector on which to operate.
+ * @param values The values to append.
+ * @param count The number of values.
+ * @return `true` on success, `false` otherwise (in which case none of the
+ *   values are appended).
+ */
+bool gcu_packed64_append_many(GCU_Packed64 * packed, const GCU_Type64_Union * values, size_t count);
+
+/**
+ * Get the number of values in a packed vector.
+ *
+ * @param packed The packed vector on which to operate.
+ * @return The number of values.
+ */
+size_t gcu_packed64_count(GCU_Packed64 * packed);
+
+/**
+ * Get the number of bytes used by the block headers and packed numbers.
+ *
+ * @param packed The packed vector on which to operate.
+ * @return The number of bytes.
+ */
+size_t gcu_packed64_size(GCU_Packed64 * packed);
+
+/**
+ * Get a single value.
+ *
+ * A value in a frame of reference block is read directly.  A value in a delta
+ * block requires decoding its block up to that value.
+ *
+ * @param packed The packed vector on which to operate.
+ * @param index The position of the value.
+ * @return The value, if the index is in range.
+ */
+GCU_Packed64_Value gcu_packed64_get(GCU_Packed64 * packed, size_t index);
+
+/**
+ * Decode one block.
+ *
+ * @param packed The packed vector on which to operate.
+ * @param block The block number.
+ * @param values The array which receives the values.  It must have room for
+ *   GCU_PACKED64_BLOCK_SIZE values.
+ * @return The number of values in the block, or `0` if there is no such
+ *   block.
+ */
+size_t gcu_packed64_decode_block(GCU_Packed64 * packed, size_t block, GCU_Type64_Union * values);
+
+/**
+ * Decode every value, appending them to a vector.
+ *
+ * @param packed The packed vector on which to operate.
+ * @param vector The vector which receives the values.
+ * @return `true` on success, `false` otherwise (in which case the vector is
+ *   unchanged).
+ */
+bool gcu_packed64_decode(GCU_Packed64 * packed, GCU_Vector64 * vector);
+
+/**
+ * Sum the `ui64` values, wrapping on overflow.
+ *
+ * @param packed The packed vector on which to operate.
+ * @return The sum, or `0` if the vector is empty.
+ */
+uint64_t gcu_packed64_sum_ui64(GCU_Packed64 * packed);
+
+/**
+ * Find the smallest `ui64` value.
+ *
+ * Frame of reference blocks store their smallest value, so they are not
+ * decoded.
+ *
+ * @param packed The packed vector on which to operate.
+ * @return The smallest value, or `UINT64_MAX` if the vector is empty.
+ */
+uint64_t gcu_packed64_min_ui64(GCU_Packed64 * packed);
+
+/**
+ * Find the largest `ui64` value.
+ *
+ * @param packed The packed vector on which to operate.
+ * @return The largest value, or `0` if the vector is empty.
+ */
+uint64_t gcu_packed64_max_ui64(GCU_Packed64 * packed);
+
+/**
+ * Count the values whose `ui64` value is in the range `[low, high]`.
+ *
+ * Frame of reference blocks which lie entirely inside or outside of the range
+ * are counted without being decoded.
+ *
+ * @param packed The packed vector on which to operate.
+ * @param low The smallest value to count.
+ * @param high The largest value to count.
+ * @return The number of matching values.
+ */
+size_t gcu_packed64_count_range_ui64(GCU_Packed64 * packed, uint64_t low, uint64_t high);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_PACKED_H
@@ -0,0 +1,298 @@
+/**
+ * @file
+ * A persistent worker pool, and parallel algorithms over vectors.
+ *
+ * A GCU_Thread_Pool owns a fixed set of worker threads (created with
+ * gcu_thread_create()) which sleep on a semaphore between jobs, so running a
+ * parallel algorithm does not pay for thread creation.  The thread which
+ * submits a job participates in it, so a pool of `n` threads has `n - 1`
+ * workers, and a pool of 1 thread runs everything on the calling thread.
+ *
+ * Every function which accepts a pool also accepts `NULL`, meaning the default
+ * pool.  The default pool is created on first use with one thread per
+ * processor and is destroyed automatically when the program exits.  Pools
+ * created with gcu_thread_pool_create() must be destroyed by the programmer
+ * before the program exits.
+ *
+ * Work is split into chunks which fit comfortably in a core's L2 cache (see
+ * gcu_thread_pool_get_chunk_size()), and the chunks are handed out
+ * dynamically, so uneven work is balanced across the threads.
+ *
+ * A task which itself runs a job on a pool (e.g., a gcu_vector64_par_*
+ * function called from inside gcu_vector64_par_for_each()) runs that job
+ * serially on its own thread rather than waiting on the busy pool.
+ */
+
+#ifndef GHOTIIO_CUTIL_PARALLEL_H
+#define GHOTIIO_CUTIL_PARALLEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <cutil/libver.h>
+#include <cutil/type.h>
+#include <cutil/vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_Thread_Pool GHOTIIO_CUTIL(GCU_Thread_Pool)
+#define GCU_Thread_Pool_Task GHOTIIO_CUTIL(GCU_Thread_Pool_Task)
+#define gcu_thread_pool_create GHOTIIO_CUTIL(gcu_thread_pool_create)
+#define gcu_thread_pool_destroy GHOTIIO_CUTIL(gcu_thread_pool_destroy)
+#define gcu_thread_pool_get_default GHOTIIO_CUTIL(gcu_thread_pool_get_default)
+#define gcu_thread_pool_get_num_threads GHOTIIO_CUTIL(gcu_thread_pool_get_num_threads)
+#define gcu_thread_pool_get_chunk_size GHOTIIO_CUTIL(gcu_thread_pool_get_chunk_size)
+#define gcu_thread_pool_run GHOTIIO_CUTIL(gcu_thread_pool_run)
+
+#define GCU_Vector64_Chunk_Func GHOTIIO_CUTIL(GCU_Vector64_Chunk_Func)
+#define GCU_Vector64_Transform_Func GHOTIIO_CUTIL(GCU_Vector64_Transform_Func)
+#define gcu_vector64_par_for_each GHOTIIO_CUTIL(gcu_vector64_par_for_each)
+#define gcu_vector64_par_transform GHOTIIO_CUTIL(gcu_vector64_par_transform)
+#define gcu_vector64_par_sum_ui64 GHOTIIO_CUTIL(gcu_vector64_par_sum_ui64)
+#define gcu_vector64_par_sum_i64 GHOTIIO_CUTIL(gcu_vector64_par_sum_i64)
+#define gcu_vector64_par_sum_f64 GHOTIIO_CUTIL(gcu_vector64_par_sum_f64)
+#define gcu_vector64_par_min_ui64 GHOTIIO_CUTIL(gcu_vector64_par_min_ui64)
+#define gcu_vector64_par_min_i64 GHOTIIO_CUTIL(gcu_vector64_par_min_i64)
+#define gcu_vector64_par_min_f64 GHOTIIO_CUTIL(gcu_vector64_par_min_f64)
+#define gcu_vector64_par_max_ui64 GHOTIIO_CUTIL(gcu_vector64_par_max_ui64)
+#define gcu_vector64_par_max_i64 GHOTIIO_CUTIL(gcu_vector64_par_max_i64)
+#define gcu_vector64_par_max_f64 GHOTIIO_CUTIL(gcu_vector64_par_max_f64)
+/// @endcond
+
+/**
+ * An opaque handle to a pool of worker threads.
+ */
+typedef struct GCU_Thread_Pool GCU_Thread_Pool;
+
+/**
+ * Pointer to a function which performs one task of a job.
+ *
+ * @ref gcu_thread_pool_run
+ *
+ * @param index The index of the task, from `0` to `num_tasks - 1`.
+ * @param arg The argument that was passed to gcu_thread_pool_run().
+ */
+typedef void (* GCU_Thread_Pool_Task)(size_t index, void * arg);
+
+/**
+ * Pointer to a function which processes a contiguous chunk of a vector.
+ *
+ * @ref gcu_vector64_par_for_each
+ *
+ * @param data The first element of the chunk.
+ * @param count The number of elements in the chunk.
+ * @param arg The user-supplied argument.
+ */
+typedef void (* GCU_Vector64_Chunk_Func)(GCU_Type64_Union * data, size_t count, void * arg);
+
+/**
+ * Pointer to a function which transforms a contiguous chunk of a vector.
+ *
+ * @ref gcu_vector64_par_transform
+ *
+ * @param source The first element of the source chunk.
+ * @param destination The first element of the destination chunk.
+ * @param count The number of elements in the chunk.
+ * @param arg The user-supplied argument.
+ */
+typedef void (* GCU_Vector64_Transform_Func)(const GCU_Type64_Union * source, GCU_Type64_Union * destination, size_t count, void * arg);
+
+/**
+ * Create a pool of threads.
+ *
+ * All pools created with this function must have a corresponding
+ * gcu_thread_pool_destroy() call before the program exits.
+ *
+ * @param num_threads The number of threads which will work on each job,
+ *   including the thread which submits the job.  If `0`, then the number of
+ *   processors is used.
+ * @return A pointer to the pool on success, `NULL` otherwise.
+ */
+GCU_Thread_Pool * gcu_thread_pool_create(size_t num_threads);
+
+/**
+ * Stop the worker threads of a pool and release its memory.
+ *
+ * The pool must not be running a job.
+ *
+ * @param pool The pool to destroy.
+ */
+void gcu_thread_pool_destroy(GCU_Thread_Pool * pool);
+
+/**
+ * Get the default pool, creating it if needed.
+ *
+ * @return A pointer to the default pool, or `NULL` if it could not be created.
+ */
+GCU_Thread_Pool * gcu_thread_pool_get_default(void);
+
+/**
+ * Get the number of threads which work on each job of a pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @return The number of threads, including the submitting thread.
+ */
+size_t gcu_thread_pool_get_num_threads(GCU_Thread_Pool * pool);
+
+/**
+ * Get the number of elements that each task should process.
+ *
+ * The chunk is at most 256 KiB, so that a task's input stays in the L2 cache,
+ * but it is reduced for smaller inputs so that there are several tasks per
+ * thread.  It is never less than 16 KiB (unless `count` is smaller), and it is
+ * always a whole number of 64-byte cache lines so that tasks writing to
+ * adjacent chunks do not share a line.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param count The total number of elements.
+ * @param element_size The size of each element, in bytes.
+ * @return The number of elements per task.
+ */
+size_t gcu_thread_pool_get_chunk_size(GCU_Thread_Pool * pool, size_t count, size_t element_size);
+
+/**
+ * Run `task` once for each index in `[0, num_tasks)` and wait for them all to
+ * finish.
+ *
+ * The tasks are distributed dynamically among the threads of the pool, and
+ * may run in any order.  Jobs submitted to the same pool by different threads
+ * are run one at a time.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param num_tasks The number of tasks.
+ * @param task The function to run for each task.
+ * @param arg The argument to pass to each task.
+ * @return `true` on success, `false` if `task` is `NULL`.
+ */
+bool gcu_thread_pool_run(GCU_Thread_Pool * pool, size_t num_tasks, GCU_Thread_Pool_Task task, void * arg);
+
+/**
+ * Call `func` on every chunk of the vector, in parallel.
+ *
+ * The chunks do not overlap, so `func` may modify the elements in place.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to process.
+ * @param func The function to call for each chunk.
+ * @param arg The argument to pass to `func`.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector64_par_for_each(GCU_Thread_Pool * pool, GCU_Vector64 * vector, GCU_Vector64_Chunk_Func func, void * arg);
+
+/**
+ * Fill `destination` with the result of calling `func` on every chunk of
+ * `source`, in parallel.
+ *
+ * The destination is resized to hold the same number of elements as the
+ * source.  The source and destination may be the same vector.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param destination The vector to fill.
+ * @param source The vector to read.
+ * @param func The function to call for each chunk.
+ * @param arg The argument to pass to `func`.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector64_par_transform(GCU_Thread_Pool * pool, GCU_Vector64 * destination, GCU_Vector64 * source, GCU_Vector64_Transform_Func func, void * arg);
+
+/**
+ * Sum the `ui64` values of a vector, in parallel.
+ *
+ * The sum wraps around on overflow.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to process.
+ * @return The sum, or `0` if the vector is empty.
+ */
+uint64_t gcu_vector64_par_sum_ui64(GCU_Thread_Pool * pool, GCU_Vector64 * vector);
+
+/**
+ * Sum the `i64` values of a vector, in parallel.
+ *
+ * The sum wraps around on overflow.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to process.
+ * @return The sum, or `0` if the vector is empty.
+ */
+int64_t gcu_vector64_par_sum_i64(GCU_Thread_Pool * pool, GCU_Vector64 * vector);
+
+/**
+ * Sum the `f64` values of a vector, in parallel.
+ *
+ * Each chunk is summed separately and the partial sums are added in order, so
+ * the result is repeatable for a given pool size, but may differ in the last
+ * bits from a sequential sum.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to process.
+ * @return The sum, or `0` if the vector is empty.
+ */
+double gcu_vector64_par_sum_f64(GCU_Thread_Pool * pool, GCU_Vector64 * vector);
+
+/**
+ * Find the smallest `ui64` value of a vector, in parallel.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to process.
+ * @return The smallest value, or `UINT64_MAX` if the vector is empty.
+ */
+uint64_t gcu_vector64_par_min_ui64(GCU_Thread_Pool * pool, GCU_Vector64 * vector);
+
+/**
+ * Find the smallest `i64` value of a vector, in parallel.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to process.
+ * @return The smallest value, or `INT64_MAX` if the vector is empty.
+ */
+int64_t gcu_vector64_par_min_i64(GCU_Thread_Pool * pool, GCU_Vector64 * vector);
+
+/**
+ * Find the smallest `f64` value of a vector, in parallel.
+ *
+ * NaNs are ignored.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to process.
+ * @return The smallest value, or `INFINITY` if the vector is empty.
+ */
+double gcu_vector64_par_min_f64(GCU_Thread_Pool * pool, GCU_Vector64 * vector);
+
+/**
+ * Find the largest `ui64` value of a vector, in parallel.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to process.
+ * @return The largest value, or `0` if the vector is empty.
+ */
+uint64_t gcu_vector64_par_max_ui64(GCU_Thread_Pool * pool, GCU_Vector64 * vector);
+
+/**
+ * Find the largest `i64` value of a vector, in parallel.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to process.
+ * @return The largest value, or `INT64_MIN` if the vector is empty.
+ */
+int64_t gcu_vector64_par_max_i64(GCU_Thread_Pool * pool, GCU_Vector64 * vector);
+
+/**
+ * Find the largest `f64` value of a vector, in parallel.
+ *
+ * NaNs are ignored.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to process.
+ * @return The largest value, or `-INFINITY` if the vector is empty.
+ */
+double gcu_vector64_par_max_f64(GCU_Thread_Pool * pool, GCU_Vector64 * vector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_PARALLEL_H
@@ -0,0 +1,152 @@
+/**
+ * @file
+ * Pools (slab allocators) of fixed-size objects, with per-thread caches.
+ *
+ * A pool hands out objects of one size, carved from large, cache-line
+ * aligned slabs.  A free object holds the link to the next free object
+ * itself, so the pool needs no memory of its own to track them.
+ *
+ * Each thread allocates from, and frees to, a cache (a "magazine" of object
+ * pointers) which no other thread normally touches, so that the common case
+ * takes no lock and touches no shared cache line.  When a cache runs dry, it
+ * is refilled with a whole batch of objects from the pool's shared depot, and
+ * when it overflows, it returns a whole batch at once, so the depot's lock is
+ * taken once per batch rather than once per object.  Objects may be freed by
+ * a different thread from the one which allocated them.
+ *
+ * A pool has a fixed number of caches, and threads are spread across them.
+ * If two threads share a cache and collide, the loser goes straight to the
+ * depot, so correctness never depends on how threads are assigned.  Objects
+ * left in the cache of a thread which exits are used by the next thread to
+ * be given that cache; gcu_pool_flush() returns them to the depot at once.
+ *
+ * For code which calls gcu_malloc() and gcu_free() for many small blocks,
+ * gcu_sized_malloc() and gcu_sized_free() serve small sizes from a shared
+ * pool for each size class, and larger ones from gcu_malloc(), given that the
+ * caller passes the size back when freeing, as it usually knows it.
+ *
+ * The pool is opaque, and must be created with gcu_pool_create().
+ */
+
+#ifndef GHOTIIO_CUTIL_POOL_H
+#define GHOTIIO_CUTIL_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <cutil/libver.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_Pool GHOTIIO_CUTIL(GCU_Pool)
+#define gcu_pool_create GHOTIIO_CUTIL(gcu_pool_create)
+#define gcu_pool_destroy GHOTIIO_CUTIL(gcu_pool_destroy)
+#define gcu_pool_allocate GHOTIIO_CUTIL(gcu_pool_allocate)
+#define gcu_pool_free GHOTIIO_CUTIL(gcu_pool_free)
+#define gcu_pool_flush GHOTIIO_CUTIL(gcu_pool_flush)
+#define gcu_pool_object_size GHOTIIO_CUTIL(gcu_pool_object_size)
+#define gcu_pool_capacity GHOTIIO_CUTIL(gcu_pool_capacity)
+#define gcu_sized_malloc GHOTIIO_CUTIL(gcu_sized_malloc)
+#define gcu_sized_free GHOTIIO_CUTIL(gcu_sized_free)
+/// @endcond
+
+/**
+ * The largest size which gcu_sized_malloc() serves from a pool.
+ */
+#define GCU_POOL_LARGEST_SIZE_CLASS 256
+
+typedef struct GCU_Pool GCU_Pool;
+
+/**
+ * Create a pool of fixed-size objects.
+ *
+ * Objects are aligned to 16 bytes.  No slab is allocated until the first
+ * object is.
+ *
+ * @param object_size The size of each object, in bytes.  It is rounded up to
+ *   a multiple of 16.
+ * @return A pointer to the pool on success, `NULL` otherwise.
+ */
+GCU_Pool * gcu_pool_create(size_t object_size);
+
+/**
+ * Destroy a pool, freeing all of its slabs.
+ *
+ * Every object allocated from the pool becomes invalid, whether or not it
+ * was freed.
+ *
+ * @param pool The pool to destroy.
+ */
+void gcu_pool_destroy(GCU_Pool * pool);
+
+/**
+ * Allocate an object from the pool.
+ *
+ * The object is not zeroed.
+ *
+ * @param pool The pool from which to allocate.
+ * @return The object, or `NULL` on failure.
+ */
+void * gcu_pool_allocate(GCU_Pool * pool);
+
+/**
+ * Give an object back to the pool.
+ *
+ * @param pool The pool from which the object was allocated.
+ * @param object The object, or `NULL`.
+ */
+void gcu_pool_free(GCU_Pool * pool, void * object);
+
+/**
+ * Return the objects in the calling thread's cache to the pool's depot, so
+ * that other threads may use them.
+ *
+ * @param pool The pool.
+ */
+void gcu_pool_flush(GCU_Pool * pool);
+
+/**
+ * Get the size of the pool's objects.
+ *
+ * @param pool The pool.
+ * @return The size of each object, in bytes, after rounding.
+ */
+size_t gcu_pool_object_size(GCU_Pool * pool);
+
+/**
+ * Get the number of objects which the pool's slabs hold, whether or not they
+ * are in use.
+ *
+ * @param pool The pool.
+ * @return The number of objects.
+ */
+size_t gcu_pool_capacity(GCU_Pool * pool);
+
+/**
+ * Allocate memory, from a shared pool if it is small.
+ *
+ * Sizes up to `GCU_POOL_LARGEST_SIZE_CLASS` are rounded up to a power of two
+ * (of at least 16) and served by the pool for that size, which is created on
+ * first use and lives as long as the process.  Larger sizes are passed to
+ * gcu_malloc().
+ *
+ * @param size The number of bytes requested.
+ * @return The memory, aligned to 16 bytes, or `NULL` on failure.
+ */
+void * gcu_sized_malloc(size_t size);
+
+/**
+ * Free memory from gcu_sized_malloc().
+ *
+ * @param pointer The memory, or `NULL`.
+ * @param size The size which was passed to gcu_sized_malloc().
+ */
+void gcu_sized_free(void * pointer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_POOL_H
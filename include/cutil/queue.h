@@ -0,0 +1,279 @@
+/**
+ * @file
+ * Bounded lock-free queues of 64-bit values, for handing work between threads.
+ *
+ * Two queues are provided:
+ *   - GCU_SPSC_Queue64: exactly one thread pushes and exactly one thread pops.
+ *     Neither side performs an atomic read-modify-write; each side owns one
+ *     index, and keeps a cached copy of the other side's index so that it
+ *     only reads the other side's cache line when the cached copy says that
+ *     the queue is full (or empty).
+ *   - GCU_MPMC_Queue64: any number of threads push and pop.  This is Dmitry
+ *     Vyukov's bounded queue, in which each cell carries a sequence number
+ *     that tells a thread whether the cell is ready to be written or read, so
+ *     that a push or pop costs a single compare-and-swap when uncontended.
+ *
+ * The capacity of both queues is rounded up to a power of two, and the
+ * indices written by the producers and by the consumers are kept on separate
+ * cache lines, so that the two sides do not slow each other down.
+ *
+ * The `try_` functions and the `_many` functions never block.  The batch
+ * functions move as many values as they can, and return how many they moved.
+ * gcu_spsc_queue64_push() and gcu_spsc_queue64_pop() (and their MPMC
+ * counterparts) block until they succeed: they spin briefly, and then park
+ * the thread on a semaphore until the other side makes progress.  A thread
+ * which is not waiting pays only for a fence and a load on each call, to check
+ * whether any thread on the other side needs to be woken.
+ *
+ * The queues are opaque, and must be created with their `create` function.
+ */
+
+#ifndef GHOTIIO_CUTIL_QUEUE_H
+#define GHOTIIO_CUTIL_QUEUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <cutil/libver.h>
+#include <cutil/type.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_Queue64_Value GHOTIIO_CUTIL(GCU_Queue64_Value)
+
+#define GCU_SPSC_Queue64 GHOTIIO_CUTIL(GCU_SPSC_Queue64)
+#define gcu_spsc_queue64_create GHOTIIO_CUTIL(gcu_spsc_queue64_create)
+#define gcu_spsc_queue64_destroy GHOTIIO_CUTIL(gcu_spsc_queue64_destroy)
+#define gcu_spsc_queue64_try_push GHOTIIO_CUTIL(gcu_spsc_queue64_try_push)
+#define gcu_spsc_queue64_try_pop GHOTIIO_CUTIL(gcu_spsc_queue64_try_pop)
+#define gcu_spsc_queue64_push GHOTIIO_CUTIL(gcu_spsc_queue64_push)
+#define gcu_spsc_queue64_pop GHOTIIO_CUTIL(gcu_spsc_queue64_pop)
+#define gcu_spsc_queue64_push_many GHOTIIO_CUTIL(gcu_spsc_queue64_push_many)
+#define gcu_spsc_queue64_pop_many GHOTIIO_CUTIL(gcu_spsc_queue64_pop_many)
+#define gcu_spsc_queue64_count GHOTIIO_CUTIL(gcu_spsc_queue64_count)
+
+#define GCU_MPMC_Queue64 GHOTIIO_CUTIL(GCU_MPMC_Queue64)
+#define gcu_mpmc_queue64_create GHOTIIO_CUTIL(gcu_mpmc_queue64_create)
+#define gcu_mpmc_queue64_destroy GHOTIIO_CUTIL(gcu_mpmc_queue64_destroy)
+#define gcu_mpmc_queue64_try_push GHOTIIO_CUTIL(gcu_mpmc_queue64_try_push)
+#define gcu_mpmc_queue64_try_pop GHOTIIO_CUTIL(gcu_mpmc_queue64_try_pop)
+#define gcu_mpmc_queue64_push GHOTIIO_CUTIL(gcu_mpmc_queue64_push)
+#define gcu_mpmc_queue64_pop GHOTIIO_CUTIL(gcu_mpmc_queue64_pop)
+#define gcu_mpmc_queue64_push_many GHOTIIO_CUTIL(gcu_mpmc_queue64_push_many)
+#define gcu_mpmc_queue64_pop_many GHOTIIO_CUTIL(gcu_mpmc_queue64_pop_many)
+#define gcu_mpmc_queue64_count GHOTIIO_CUTIL(gcu_mpmc_queue64_count)
+/// @endcond
+
+/**
+ * An opaque handle to a single-producer, single-consumer queue.
+ */
+typedef struct GCU_SPSC_Queue64 GCU_SPSC_Queue64;
+
+/**
+ * An opaque handle to a multi-producer, multi-consumer queue.
+ */
+typedef struct GCU_MPMC_Queue64 GCU_MPMC_Queue64;
+
+/**
+ * The result of popping a value from a queue without waiting.
+ */
+typedef struct {
+  bool exists;            ///< Whether or not a value was popped.
+  GCU_Type64_Union value; ///< The value (if it exists).
+} GCU_Queue64_Value;
+
+/**
+ * Create a single-producer, single-consumer queue.
+ *
+ * All invocations of a queue must have a corresponding
+ * gcu_spsc_queue64_destroy() call in order to clean up dynamically-allocated
+ * memory.
+ *
+ * @param capacity The number of values that the queue must hold.  It is
+ *   rounded up to a power of two.
+ * @return A pointer to the queue on success, `NULL` otherwise.
+ */
+GCU_SPSC_Queue64 * gcu_spsc_queue64_create(size_t capacity);
+
+/**
+ * Destroy a single-producer, single-consumer queue.
+ *
+ * No thread may be using the queue.
+ *
+ * @param queue The queue to destroy.
+ */
+void gcu_spsc_queue64_destroy(GCU_SPSC_Queue64 * queue);
+
+/**
+ * Push a value, if the queue is not full.
+ *
+ * Only the producer thread may call this function.
+ *
+ * @param queue The queue on which to operate.
+ * @param value The value.
+ * @return `true` if the value was pushed, `false` if the queue is full.
+ */
+bool gcu_spsc_queue64_try_push(GCU_SPSC_Queue64 * queue, GCU_Type64_Union value);
+
+/**
+ * Pop a value, if the queue is not empty.
+ *
+ * Only the consumer thread may call this function.
+ *
+ * @param queue The queue on which to operate.
+ * @return The value, if the queue was not empty.
+ */
+GCU_Queue64_Value gcu_spsc_queue64_try_pop(GCU_SPSC_Queue64 * queue);
+
+/**
+ * Push a value, waiting for room if the queue is full.
+ *
+ * Only the producer thread may call this function.
+ *
+ * @param queue The queue on which to operate.
+ * @param value The value.
+ */
+void gcu_spsc_queue64_push(GCU_SPSC_Queue64 * queue, GCU_Type64_Union value);
+
+/**
+ * Pop a value, waiting for one if the queue is empty.
+ *
+ * Only the consumer thread may call this function.
+ *
+ * @param queue The queue on which to operate.
+ * @return The value.
+ */
+GCU_Type64_Union gcu_spsc_queue64_pop(GCU_SPSC_Queue64 * queue);
+
+/**
+ * Push as many values from an array as there is room for.
+ *
+ * Only the producer thread may call this function.
+ *
+ * @param queue The queue on which to operate.
+ * @param values The values, in order.
+ * @param count The number of values.
+ * @return The number of values pushed, which are the first values of the
+ *   array.
+ */
+size_t gcu_spsc_queue64_push_many(GCU_SPSC_Queue64 * queue, const GCU_Type64_Union * values, size_t count);
+
+/**
+ * Pop as many values as are available, up to `count`.
+ *
+ * Only the consumer thread may call this function.
+ *
+ * @param queue The queue on which to operate.
+ * @param values The array which receives the values, in order.
+ * @param count The largest number of values to pop.
+ * @return The number of values popped.
+ */
+size_t gcu_spsc_queue64_pop_many(GCU_SPSC_Queue64 * queue, GCU_Type64_Union * values, size_t count);
+
+/**
+ * Get the number of values in the queue.
+ *
+ * If other threads are using the queue, then the count may be out of date by
+ * the time that it is returned.
+ *
+ * @param queue The queue on which to operate.
+ * @return The number of values.
+ */
+size_t gcu_spsc_queue64_count(GCU_SPSC_Queue64 * queue);
+
+/**
+ * Create a multi-producer, multi-consumer queue.
+ *
+ * All invocations of a queue must have a corresponding
+ * gcu_mpmc_queue64_destroy() call in order to clean up dynamically-allocated
+ * memory.
+ *
+ * @param capacity The number of values that the queue must hold.  It is
+ *   rounded up to a power of two, and is at least 2.
+ * @return A pointer to the queue on success, `NULL` otherwise.
+ */
+GCU_MPMC_Queue64 * gcu_mpmc_queue64_create(size_t capacity);
+
+/**
+ * Destroy a multi-producer, multi-consumer queue.
+ *
+ * No thread may be using the queue.
+ *
+ * @param queue The queue to destroy.
+ */
+void gcu_mpmc_queue64_destroy(GCU_MPMC_Queue64 * queue);
+
+/**
+ * Push a value, if the queue is not full.
+ *
+ * @param queue The queue on which to operate.
+ * @param value The value.
+ * @return `true` if the value was pushed, `false` if the queue is full.
+ */
+bool gcu_mpmc_queue64_try_push(GCU_MPMC_Queue64 * queue, GCU_Type64_Union value);
+
+/**
+ * Pop a value, if the queue is not empty.
+ *
+ * @param queue The queue on which to operate.
+ * @return The value, if the queue was not empty.
+ */
+GCU_Queue64_Value gcu_mpmc_queue64_try_pop(GCU_MPMC_Queue64 * queue);
+
+/**
+ * Push a value, waiting for room if the queue is full.
+ *
+ * @param queue The queue on which to operate.
+ * @param value The value.
+ */
+void gcu_mpmc_queue64_push(GCU_MPMC_Queue64 * queue, GCU_Type64_Union value);
+
+/**
+ * Pop a value, waiting for one if the queue is empty.
+ *
+ * @param queue The queue on which to operate.
+ * @return The value.
+ */
+GCU_Type64_Union gcu_mpmc_queue64_pop(GCU_MPMC_Queue64 * queue);
+
+/**
+ * Push as many values from an array as there is room for.
+ *
+ * The values which are pushed occupy consecutive positions in the queue, so
+ * no other producer's values are interleaved with them.
+ *
+ * @param queue The queue on which to operate.
+ * @param values The values, in order.
+ * @param count The number of values.
+ * @return The number of values pushed, which are the first values of the
+ *   array.
+ */
+size_t gcu_mpmc_queue64_push_many(GCU_MPMC_Queue64 * queue, const GCU_Type64_Union * values, size_t count);
+
+/**
+ * Pop as many consecutive values as are available, up to `count`.
+ *
+ * @param queue The queue on which to operate.
+ * @param values The array which receives the values, in order.
+ * @param count The largest number of values to pop.
+ * @return The number of values popped.
+ */
+size_t gcu_mpmc_queue64_pop_many(GCU_MPMC_Queue64 * queue, GCU_Type64_Union * values, size_t count);
+
+/**
+ * Get the number of values in the queue.
+ *
+ * If other threads are using the queue, then the count is approximate.
+ *
+ * @param queue The queue on which to operate.
+ * @return The number of values.
+ */
+size_t gcu_mpmc_queue64_count(GCU_MPMC_Queue64 * queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_QUEUE_H
@@ -0,0 +1,913 @@
+/**
+ * @file
+ * Vectorized reductions and searches over arrays of type unions.
+ *
+ * Like the sort functions, each function interprets every element of the
+ * array as a single lane type (e.g., `f32` or `ui32` for 32-bit unions).  They
+ * operate on raw arrays, so a vector is processed by passing `vector->data`
+ * and `vector->count`.
+ *
+ * The kernels are written so that the compiler vectorizes them.  When built
+ * with GCC for x86-64, each kernel is compiled for SSE2, AVX2, and AVX-512
+ * (x86-64-v4), and the best version for the running CPU is selected when the
+ * library is loaded.  Other platforms get a portable version.
+ *
+ * Integer sums are returned as 64-bit values and wrap around on overflow.
+ * Floating point sums are accumulated in double precision across several
+ * independent accumulators, so the result may differ in the last bits from a
+ * strictly sequential sum.  NaNs are ignored by the min and max functions, but
+ * propagate through sums.
+ *
+ * Functions which return a position return `count` if there is no such
+ * element.
+ */
+
+#ifndef GHOTIIO_CUTIL_REDUCE_H
+#define GHOTIIO_CUTIL_REDUCE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <cutil/type.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define gcu_sum64_ui64 GHOTIIO_CUTIL(gcu_sum64_ui64)
+#define gcu_min64_ui64 GHOTIIO_CUTIL(gcu_min64_ui64)
+#define gcu_max64_ui64 GHOTIIO_CUTIL(gcu_max64_ui64)
+#define gcu_argmin64_ui64 GHOTIIO_CUTIL(gcu_argmin64_ui64)
+#define gcu_argmax64_ui64 GHOTIIO_CUTIL(gcu_argmax64_ui64)
+#define gcu_find64_ui64 GHOTIIO_CUTIL(gcu_find64_ui64)
+#define gcu_count64_ui64 GHOTIIO_CUTIL(gcu_count64_ui64)
+#define gcu_count_range64_ui64 GHOTIIO_CUTIL(gcu_count_range64_ui64)
+
+#define gcu_sum64_i64 GHOTIIO_CUTIL(gcu_sum64_i64)
+#define gcu_min64_i64 GHOTIIO_CUTIL(gcu_min64_i64)
+#define gcu_max64_i64 GHOTIIO_CUTIL(gcu_max64_i64)
+#define gcu_argmin64_i64 GHOTIIO_CUTIL(gcu_argmin64_i64)
+#define gcu_argmax64_i64 GHOTIIO_CUTIL(gcu_argmax64_i64)
+#define gcu_find64_i64 GHOTIIO_CUTIL(gcu_find64_i64)
+#define gcu_count64_i64 GHOTIIO_CUTIL(gcu_count64_i64)
+#define gcu_count_range64_i64 GHOTIIO_CUTIL(gcu_count_range64_i64)
+
+#define gcu_sum64_f64 GHOTIIO_CUTIL(gcu_sum64_f64)
+#define gcu_min64_f64 GHOTIIO_CUTIL(gcu_min64_f64)
+#define gcu_max64_f64 GHOTIIO_CUTIL(gcu_max64_f64)
+#define gcu_argmin64_f64 GHOTIIO_CUTIL(gcu_argmin64_f64)
+#define gcu_argmax64_f64 GHOTIIO_CUTIL(gcu_argmax64_f64)
+#define gcu_find64_f64 GHOTIIO_CUTIL(gcu_find64_f64)
+#define gcu_count64_f64 GHOTIIO_CUTIL(gcu_count64_f64)
+#define gcu_count_range64_f64 GHOTIIO_CUTIL(gcu_count_range64_f64)
+
+#define gcu_sum32_ui32 GHOTIIO_CUTIL(gcu_sum32_ui32)
+#define gcu_min32_ui32 GHOTIIO_CUTIL(gcu_min32_ui32)
+#define gcu_max32_ui32 GHOTIIO_CUTIL(gcu_max32_ui32)
+#define gcu_argmin32_ui32 GHOTIIO_CUTIL(gcu_argmin32_ui32)
+#define gcu_argmax32_ui32 GHOTIIO_CUTIL(gcu_argmax32_ui32)
+#define gcu_find32_ui32 GHOTIIO_CUTIL(gcu_find32_ui32)
+#define gcu_count32_ui32 GHOTIIO_CUTIL(gcu_count32_ui32)
+#define gcu_count_range32_ui32 GHOTIIO_CUTIL(gcu_count_range32_ui32)
+
+#define gcu_sum32_i32 GHOTIIO_CUTIL(gcu_sum32_i32)
+#define gcu_min32_i32 GHOTIIO_CUTIL(gcu_min32_i32)
+#define gcu_max32_i32 GHOTIIO_CUTIL(gcu_max32_i32)
+#define gcu_argmin32_i32 GHOTIIO_CUTIL(gcu_argmin32_i32)
+#define gcu_argmax32_i32 GHOTIIO_CUTIL(gcu_argmax32_i32)
+#define gcu_find32_i32 GHOTIIO_CUTIL(gcu_find32_i32)
+#define gcu_count32_i32 GHOTIIO_CUTIL(gcu_count32_i32)
+#define gcu_count_range32_i32 GHOTIIO_CUTIL(gcu_count_range32_i32)
+
+#define gcu_sum32_f32 GHOTIIO_CUTIL(gcu_sum32_f32)
+#define gcu_min32_f32 GHOTIIO_CUTIL(gcu_min32_f32)
+#define gcu_max32_f32 GHOTIIO_CUTIL(gcu_max32_f32)
+#define gcu_argmin32_f32 GHOTIIO_CUTIL(gcu_argmin32_f32)
+#define gcu_argmax32_f32 GHOTIIO_CUTIL(gcu_argmax32_f32)
+#define gcu_find32_f32 GHOTIIO_CUTIL(gcu_find32_f32)
+#define gcu_count32_f32 GHOTIIO_CUTIL(gcu_count32_f32)
+#define gcu_count_range32_f32 GHOTIIO_CUTIL(gcu_count_range32_f32)
+
+#define gcu_sum16_ui16 GHOTIIO_CUTIL(gcu_sum16_ui16)
+#define gcu_min16_ui16 GHOTIIO_CUTIL(gcu_min16_ui16)
+#define gcu_max16_ui16 GHOTIIO_CUTIL(gcu_max16_ui16)
+#define gcu_argmin16_ui16 GHOTIIO_CUTIL(gcu_argmin16_ui16)
+#define gcu_argmax16_ui16 GHOTIIO_CUTIL(gcu_argmax16_ui16)
+#define gcu_find16_ui16 GHOTIIO_CUTIL(gcu_find16_ui16)
+#define gcu_count16_ui16 GHOTIIO_CUTIL(gcu_count16_ui16)
+#define gcu_count_range16_ui16 GHOTIIO_CUTIL(gcu_count_range16_ui16)
+
+#define gcu_sum16_i16 GHOTIIO_CUTIL(gcu_sum16_i16)
+#define gcu_min16_i16 GHOTIIO_CUTIL(gcu_min16_i16)
+#define gcu_max16_i16 GHOTIIO_CUTIL(gcu_max16_i16)
+#define gcu_argmin16_i16 GHOTIIO_CUTIL(gcu_argmin16_i16)
+#define gcu_argmax16_i16 GHOTIIO_CUTIL(gcu_argmax16_i16)
+#define gcu_find16_i16 GHOTIIO_CUTIL(gcu_find16_i16)
+#define gcu_count16_i16 GHOTIIO_CUTIL(gcu_count16_i16)
+#define gcu_count_range16_i16 GHOTIIO_CUTIL(gcu_count_range16_i16)
+
+#define gcu_sum8_ui8 GHOTIIO_CUTIL(gcu_sum8_ui8)
+#define gcu_min8_ui8 GHOTIIO_CUTIL(gcu_min8_ui8)
+#define gcu_max8_ui8 GHOTIIO_CUTIL(gcu_max8_ui8)
+#define gcu_argmin8_ui8 GHOTIIO_CUTIL(gcu_argmin8_ui8)
+#define gcu_argmax8_ui8 GHOTIIO_CUTIL(gcu_argmax8_ui8)
+#define gcu_find8_ui8 GHOTIIO_CUTIL(gcu_find8_ui8)
+#define gcu_count8_ui8 GHOTIIO_CUTIL(gcu_count8_ui8)
+#define gcu_count_range8_ui8 GHOTIIO_CUTIL(gcu_count_range8_ui8)
+
+#define gcu_sum8_i8 GHOTIIO_CUTIL(gcu_sum8_i8)
+#define gcu_min8_i8 GHOTIIO_CUTIL(gcu_min8_i8)
+#define gcu_max8_i8 GHOTIIO_CUTIL(gcu_max8_i8)
+#define gcu_argmin8_i8 GHOTIIO_CUTIL(gcu_argmin8_i8)
+#define gcu_argmax8_i8 GHOTIIO_CUTIL(gcu_argmax8_i8)
+#define gcu_find8_i8 GHOTIIO_CUTIL(gcu_find8_i8)
+#define gcu_count8_i8 GHOTIIO_CUTIL(gcu_count8_i8)
+#define gcu_count_range8_i8 GHOTIIO_CUTIL(gcu_count_range8_i8)
+/// @endcond
+
+/**
+ * Sum the `ui64` values of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The sum, or `0` if the array is empty.
+ */
+uint64_t gcu_sum64_ui64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the smallest `ui64` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The smallest value, or `UINT64_MAX` if the array is empty.
+ */
+uint64_t gcu_min64_ui64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the largest `ui64` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The largest value, or `0` if the array is empty.
+ */
+uint64_t gcu_max64_ui64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the smallest `ui64` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the smallest value.
+ */
+size_t gcu_argmin64_ui64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the largest `ui64` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the largest value.
+ */
+size_t gcu_argmax64_ui64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the position of the first element whose `ui64` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to search for.
+ * @return The position of the first match, or `count` if there is none.
+ */
+size_t gcu_find64_ui64(const GCU_Type64_Union * data, size_t count, uint64_t value);
+
+/**
+ * Count the elements whose `ui64` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count64_ui64(const GCU_Type64_Union * data, size_t count, uint64_t value);
+
+/**
+ * Count the elements whose `ui64` value is in the range `[low, high]`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param low The smallest value to count.
+ * @param high The largest value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count_range64_ui64(const GCU_Type64_Union * data, size_t count, uint64_t low, uint64_t high);
+
+/**
+ * Sum the `i64` values of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The sum, or `0` if the array is empty.
+ */
+int64_t gcu_sum64_i64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the smallest `i64` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The smallest value, or `INT64_MAX` if the array is empty.
+ */
+int64_t gcu_min64_i64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the largest `i64` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The largest value, or `INT64_MIN` if the array is empty.
+ */
+int64_t gcu_max64_i64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the smallest `i64` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the smallest value.
+ */
+size_t gcu_argmin64_i64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the largest `i64` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the largest value.
+ */
+size_t gcu_argmax64_i64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the position of the first element whose `i64` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to search for.
+ * @return The position of the first match, or `count` if there is none.
+ */
+size_t gcu_find64_i64(const GCU_Type64_Union * data, size_t count, int64_t value);
+
+/**
+ * Count the elements whose `i64` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count64_i64(const GCU_Type64_Union * data, size_t count, int64_t value);
+
+/**
+ * Count the elements whose `i64` value is in the range `[low, high]`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param low The smallest value to count.
+ * @param high The largest value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count_range64_i64(const GCU_Type64_Union * data, size_t count, int64_t low, int64_t high);
+
+/**
+ * Sum the `f64` values of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The sum, or `0` if the array is empty.
+ */
+double gcu_sum64_f64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the smallest `f64` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The smallest value, or `INFINITY` if the array is empty.
+ */
+GCU_float64_t gcu_min64_f64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the largest `f64` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The largest value, or `-INFINITY` if the array is empty.
+ */
+GCU_float64_t gcu_max64_f64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the smallest `f64` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the smallest value.
+ */
+size_t gcu_argmin64_f64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the largest `f64` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the largest value.
+ */
+size_t gcu_argmax64_f64(const GCU_Type64_Union * data, size_t count);
+
+/**
+ * Find the position of the first element whose `f64` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to search for.
+ * @return The position of the first match, or `count` if there is none.
+ */
+size_t gcu_find64_f64(const GCU_Type64_Union * data, size_t count, GCU_float64_t value);
+
+/**
+ * Count the elements whose `f64` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count64_f64(const GCU_Type64_Union * data, size_t count, GCU_float64_t value);
+
+/**
+ * Count the elements whose `f64` value is in the range `[low, high]`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param low The smallest value to count.
+ * @param high The largest value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count_range64_f64(const GCU_Type64_Union * data, size_t count, GCU_float64_t low, GCU_float64_t high);
+
+/**
+ * Sum the `ui32` values of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The sum, or `0` if the array is empty.
+ */
+uint64_t gcu_sum32_ui32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the smallest `ui32` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The smallest value, or `UINT32_MAX` if the array is empty.
+ */
+uint32_t gcu_min32_ui32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the largest `ui32` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The largest value, or `0` if the array is empty.
+ */
+uint32_t gcu_max32_ui32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the smallest `ui32` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the smallest value.
+ */
+size_t gcu_argmin32_ui32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the largest `ui32` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the largest value.
+ */
+size_t gcu_argmax32_ui32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the position of the first element whose `ui32` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to search for.
+ * @return The position of the first match, or `count` if there is none.
+ */
+size_t gcu_find32_ui32(const GCU_Type32_Union * data, size_t count, uint32_t value);
+
+/**
+ * Count the elements whose `ui32` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count32_ui32(const GCU_Type32_Union * data, size_t count, uint32_t value);
+
+/**
+ * Count the elements whose `ui32` value is in the range `[low, high]`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param low The smallest value to count.
+ * @param high The largest value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count_range32_ui32(const GCU_Type32_Union * data, size_t count, uint32_t low, uint32_t high);
+
+/**
+ * Sum the `i32` values of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The sum, or `0` if the array is empty.
+ */
+int64_t gcu_sum32_i32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the smallest `i32` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The smallest value, or `INT32_MAX` if the array is empty.
+ */
+int32_t gcu_min32_i32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the largest `i32` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The largest value, or `INT32_MIN` if the array is empty.
+ */
+int32_t gcu_max32_i32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the smallest `i32` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the smallest value.
+ */
+size_t gcu_argmin32_i32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the largest `i32` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the largest value.
+ */
+size_t gcu_argmax32_i32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the position of the first element whose `i32` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to search for.
+ * @return The position of the first match, or `count` if there is none.
+ */
+size_t gcu_find32_i32(const GCU_Type32_Union * data, size_t count, int32_t value);
+
+/**
+ * Count the elements whose `i32` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count32_i32(const GCU_Type32_Union * data, size_t count, int32_t value);
+
+/**
+ * Count the elements whose `i32` value is in the range `[low, high]`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param low The smallest value to count.
+ * @param high The largest value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count_range32_i32(const GCU_Type32_Union * data, size_t count, int32_t low, int32_t high);
+
+/**
+ * Sum the `f32` values of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The sum, or `0` if the array is empty.
+ */
+double gcu_sum32_f32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the smallest `f32` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The smallest value, or `INFINITY` if the array is empty.
+ */
+GCU_float32_t gcu_min32_f32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the largest `f32` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The largest value, or `-INFINITY` if the array is empty.
+ */
+GCU_float32_t gcu_max32_f32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the smallest `f32` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the smallest value.
+ */
+size_t gcu_argmin32_f32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the largest `f32` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the largest value.
+ */
+size_t gcu_argmax32_f32(const GCU_Type32_Union * data, size_t count);
+
+/**
+ * Find the position of the first element whose `f32` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to search for.
+ * @return The position of the first match, or `count` if there is none.
+ */
+size_t gcu_find32_f32(const GCU_Type32_Union * data, size_t count, GCU_float32_t value);
+
+/**
+ * Count the elements whose `f32` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count32_f32(const GCU_Type32_Union * data, size_t count, GCU_float32_t value);
+
+/**
+ * Count the elements whose `f32` value is in the range `[low, high]`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param low The smallest value to count.
+ * @param high The largest value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count_range32_f32(const GCU_Type32_Union * data, size_t count, GCU_float32_t low, GCU_float32_t high);
+
+/**
+ * Sum the `ui16` values of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The sum, or `0` if the array is empty.
+ */
+uint64_t gcu_sum16_ui16(const GCU_Type16_Union * data, size_t count);
+
+/**
+ * Find the smallest `ui16` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The smallest value, or `UINT16_MAX` if the array is empty.
+ */
+uint16_t gcu_min16_ui16(const GCU_Type16_Union * data, size_t count);
+
+/**
+ * Find the largest `ui16` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The largest value, or `0` if the array is empty.
+ */
+uint16_t gcu_max16_ui16(const GCU_Type16_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the smallest `ui16` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the smallest value.
+ */
+size_t gcu_argmin16_ui16(const GCU_Type16_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the largest `ui16` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the largest value.
+ */
+size_t gcu_argmax16_ui16(const GCU_Type16_Union * data, size_t count);
+
+/**
+ * Find the position of the first element whose `ui16` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to search for.
+ * @return The position of the first match, or `count` if there is none.
+ */
+size_t gcu_find16_ui16(const GCU_Type16_Union * data, size_t count, uint16_t value);
+
+/**
+ * Count the elements whose `ui16` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count16_ui16(const GCU_Type16_Union * data, size_t count, uint16_t value);
+
+/**
+ * Count the elements whose `ui16` value is in the range `[low, high]`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param low The smallest value to count.
+ * @param high The largest value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count_range16_ui16(const GCU_Type16_Union * data, size_t count, uint16_t low, uint16_t high);
+
+/**
+ * Sum the `i16` values of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The sum, or `0` if the array is empty.
+ */
+int64_t gcu_sum16_i16(const GCU_Type16_Union * data, size_t count);
+
+/**
+ * Find the smallest `i16` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The smallest value, or `INT16_MAX` if the array is empty.
+ */
+int16_t gcu_min16_i16(const GCU_Type16_Union * data, size_t count);
+
+/**
+ * Find the largest `i16` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The largest value, or `INT16_MIN` if the array is empty.
+ */
+int16_t gcu_max16_i16(const GCU_Type16_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the smallest `i16` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the smallest value.
+ */
+size_t gcu_argmin16_i16(const GCU_Type16_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the largest `i16` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the largest value.
+ */
+size_t gcu_argmax16_i16(const GCU_Type16_Union * data, size_t count);
+
+/**
+ * Find the position of the first element whose `i16` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to search for.
+ * @return The position of the first match, or `count` if there is none.
+ */
+size_t gcu_find16_i16(const GCU_Type16_Union * data, size_t count, int16_t value);
+
+/**
+ * Count the elements whose `i16` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count16_i16(const GCU_Type16_Union * data, size_t count, int16_t value);
+
+/**
+ * Count the elements whose `i16` value is in the range `[low, high]`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param low The smallest value to count.
+ * @param high The largest value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count_range16_i16(const GCU_Type16_Union * data, size_t count, int16_t low, int16_t high);
+
+/**
+ * Sum the `ui8` values of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The sum, or `0` if the array is empty.
+ */
+uint64_t gcu_sum8_ui8(const GCU_Type8_Union * data, size_t count);
+
+/**
+ * Find the smallest `ui8` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The smallest value, or `UINT8_MAX` if the array is empty.
+ */
+uint8_t gcu_min8_ui8(const GCU_Type8_Union * data, size_t count);
+
+/**
+ * Find the largest `ui8` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The largest value, or `0` if the array is empty.
+ */
+uint8_t gcu_max8_ui8(const GCU_Type8_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the smallest `ui8` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the smallest value.
+ */
+size_t gcu_argmin8_ui8(const GCU_Type8_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the largest `ui8` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the largest value.
+ */
+size_t gcu_argmax8_ui8(const GCU_Type8_Union * data, size_t count);
+
+/**
+ * Find the position of the first element whose `ui8` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to search for.
+ * @return The position of the first match, or `count` if there is none.
+ */
+size_t gcu_find8_ui8(const GCU_Type8_Union * data, size_t count, uint8_t value);
+
+/**
+ * Count the elements whose `ui8` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count8_ui8(const GCU_Type8_Union * data, size_t count, uint8_t value);
+
+/**
+ * Count the elements whose `ui8` value is in the range `[low, high]`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param low The smallest value to count.
+ * @param high The largest value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count_range8_ui8(const GCU_Type8_Union * data, size_t count, uint8_t low, uint8_t high);
+
+/**
+ * Sum the `i8` values of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The sum, or `0` if the array is empty.
+ */
+int64_t gcu_sum8_i8(const GCU_Type8_Union * data, size_t count);
+
+/**
+ * Find the smallest `i8` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The smallest value, or `INT8_MAX` if the array is empty.
+ */
+int8_t gcu_min8_i8(const GCU_Type8_Union * data, size_t count);
+
+/**
+ * Find the largest `i8` value of an array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The largest value, or `INT8_MIN` if the array is empty.
+ */
+int8_t gcu_max8_i8(const GCU_Type8_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the smallest `i8` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the smallest value.
+ */
+size_t gcu_argmin8_i8(const GCU_Type8_Union * data, size_t count);
+
+/**
+ * Find the position of the first occurrence of the largest `i8` value of an
+ * array.
+ *
+ * @param data The array to process.
+ * @param count The number of elements in the array.
+ * @return The position of the largest value.
+ */
+size_t gcu_argmax8_i8(const GCU_Type8_Union * data, size_t count);
+
+/**
+ * Find the position of the first element whose `i8` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to search for.
+ * @return The position of the first match, or `count` if there is none.
+ */
+size_t gcu_find8_i8(const GCU_Type8_Union * data, size_t count, int8_t value);
+
+/**
+ * Count the elements whose `i8` value equals `value`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param value The value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count8_i8(const GCU_Type8_Union * data, size_t count, int8_t value);
+
+/**
+ * Count the elements whose `i8` value is in the range `[low, high]`.
+ *
+ * @param data The array to search.
+ * @param count The number of elements in the array.
+ * @param low The smallest value to count.
+ * @param high The largest value to count.
+ * @return The number of matching elements.
+ */
+size_t gcu_count_range8_i8(const GCU_Type8_Union * data, size_t count, int8_t low, int8_t high);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_REDUCE_H
@@ -0,0 +1,240 @@
+/**
+ * @file
+ * A compressed bitmap of 32-bit integers, in the style of Roaring bitmaps.
+ *
+ * The 32-bit space is split into 65536 chunks of 65536 values, keyed by the
+ * high 16 bits of each value.  Each chunk which holds at least one value has
+ * a container for the low 16 bits, which is one of:
+ *   - an array: a sorted list of values, for chunks of up to 4096 values.
+ *   - a bitmap: 65536 bits (8 KiB), for denser chunks.
+ *   - runs: a sorted list of ranges, for chunks made of long ranges of
+ *     consecutive values.  Runs are only created by
+ *     gcu_roaring32_run_optimize().
+ *
+ * A set of sparse ids is therefore stored in little more than two bytes per
+ * id, a dense set in little more than one bit per id, and intersections and
+ * unions work a whole container at a time.
+ */
+
+#ifndef GHOTIIO_CUTIL_ROARING_H
+#define GHOTIIO_CUTIL_ROARING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <cutil/mutex.h>
+#include <cutil/vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_Roaring32_Cleanup GHOTIIO_CUTIL(GCU_Roaring32_Cleanup)
+#define GCU_Roaring32_Container GHOTIIO_CUTIL(GCU_Roaring32_Container)
+#define GCU_Roaring32_Iterator GHOTIIO_CUTIL(GCU_Roaring32_Iterator)
+#define GCU_Roaring32 GHOTIIO_CUTIL(GCU_Roaring32)
+#define gcu_roaring32_create GHOTIIO_CUTIL(gcu_roaring32_create)
+#define gcu_roaring32_create_in_place GHOTIIO_CUTIL(gcu_roaring32_create_in_place)
+#define gcu_roaring32_destroy GHOTIIO_CUTIL(gcu_roaring32_destroy)
+#define gcu_roaring32_destroy_in_place GHOTIIO_CUTIL(gcu_roaring32_destroy_in_place)
+#define gcu_roaring32_add GHOTIIO_CUTIL(gcu_roaring32_add)
+#define gcu_roaring32_remove GHOTIIO_CUTIL(gcu_roaring32_remove)
+#define gcu_roaring32_contains GHOTIIO_CUTIL(gcu_roaring32_contains)
+#define gcu_roaring32_cardinality GHOTIIO_CUTIL(gcu_roaring32_cardinality)
+#define gcu_roaring32_size_in_bytes GHOTIIO_CUTIL(gcu_roaring32_size_in_bytes)
+#define gcu_roaring32_run_optimize GHOTIIO_CUTIL(gcu_roaring32_run_optimize)
+#define gcu_roaring32_or GHOTIIO_CUTIL(gcu_roaring32_or)
+#define gcu_roaring32_and GHOTIIO_CUTIL(gcu_roaring32_and)
+#define gcu_roaring32_iterator_get GHOTIIO_CUTIL(gcu_roaring32_iterator_get)
+#define gcu_roaring32_iterator_next GHOTIIO_CUTIL(gcu_roaring32_iterator_next)
+/// @endcond
+
+typedef struct GCU_Roaring32 GCU_Roaring32;
+
+/**
+ * The container of one chunk of 65536 values.  Its layout is private.
+ */
+typedef struct GCU_Roaring32_Container GCU_Roaring32_Container;
+
+/**
+ * Pointer to a function which will be called when the bitmap destroy function
+ * is called.
+ *
+ * @ref gcu_roaring32_destroy
+ *
+ * @param roaring The bitmap which is about to be destroyed.
+ */
+typedef void (* GCU_Roaring32_Cleanup)(GCU_Roaring32 * roaring);
+
+/**
+ * Container holding the information of the compressed bitmap.
+ *
+ * `keys` holds the high 16 bits of each chunk which is not empty, in
+ * ascending order, and `containers.data[i].p` points to the
+ * GCU_Roaring32_Container of the chunk `keys.data[i].ui16`.
+ *
+ * The programmer may populate the `supplementary_data` data variable and
+ * the `cleanup` function pointer.  When the bitmap is destroyed, the `cleanup`
+ * function will be called (if provided).
+ */
+typedef struct GCU_Roaring32 {
+  GCU_Vector16 keys;             ///< The high 16 bits of each chunk.
+  GCU_Vector64 containers;       ///< The container of each chunk.
+  void * supplementary_data;     ///< User-defined.
+  GCU_Roaring32_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  GCU_MUTEX_T mutex;             ///< Mutex for thread-safety.
+#endif
+} GCU_Roaring32;
+
+/**
+ * A container used to hold the state of an iterator which visits the values
+ * of a bitmap in ascending order.
+ *
+ * Modifying the bitmap invalidates any iterators of the bitmap.
+ *
+ * The programmer is responsible for checking the `exists` field before using
+ * the `value`.
+ */
+typedef struct {
+  size_t container;        ///< The position of the container in the bitmap.
+  uint32_t index;          ///< The position within the container.
+  bool exists;             ///< Whether or not the iterator points to a value.
+  uint32_t value;          ///< The value pointed to by the iterator.
+  GCU_Roaring32 * roaring; ///< The bitmap that the iterator traverses.
+} GCU_Roaring32_Iterator;
+
+/**
+ * Create an empty compressed bitmap.
+ *
+ * All invocations of a bitmap must have a corresponding
+ * gcu_roaring32_destroy() call in order to clean up dynamically-allocated
+ * memory.
+ *
+ * @return A pointer to the bitmap on success, `NULL` otherwise.
+ */
+GCU_Roaring32 * gcu_roaring32_create(void);
+
+/**
+ * Initialize an empty compressed bitmap in memory owned by the programmer.
+ *
+ * @param roaring The bitmap to initialize.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_roaring32_create_in_place(GCU_Roaring32 * roaring);
+
+/**
+ * Destroy a compressed bitmap and free its memory.
+ *
+ * @param roaring The bitmap to destroy.
+ */
+void gcu_roaring32_destroy(GCU_Roaring32 * roaring);
+
+/**
+ * Destroy a compressed bitmap which was initialized with
+ * gcu_roaring32_create_in_place(), without freeing the bitmap structure
+ * itself.
+ *
+ * @param roaring The bitmap to destroy.
+ */
+void gcu_roaring32_destroy_in_place(GCU_Roaring32 * roaring);
+
+/**
+ * Add a value to the bitmap.
+ *
+ * @param roaring The bitmap on which to operate.
+ * @param value The value.
+ * @return `true` on success (including if the value was already present),
+ *   `false` otherwise.
+ */
+bool gcu_roaring32_add(GCU_Roaring32 * roaring, uint32_t value);
+
+/**
+ * Remove a value from the bitmap.
+ *
+ * @param roaring The bitmap on which to operate.
+ * @param value The value.
+ * @return `true` on success (including if the value was not present),
+ *   `false` otherwise.
+ */
+bool gcu_roaring32_remove(GCU_Roaring32 * roaring, uint32_t value);
+
+/**
+ * Check whether a value is in the bitmap.
+ *
+ * @param roaring The bitmap on which to operate.
+ * @param value The value.
+ * @return `true` if the value is present, `false` otherwise.
+ */
+bool gcu_roaring32_contains(GCU_Roaring32 * roaring, uint32_t value);
+
+/**
+ * Count the values in the bitmap.
+ *
+ * @param roaring The bitmap on which to operate.
+ * @return The number of values.
+ */
+uint64_t gcu_roaring32_cardinality(GCU_Roaring32 * roaring);
+
+/**
+ * Get the number of bytes of memory allocated by the bitmap, including the
+ * bitmap structure itself.
+ *
+ * @param roaring The bitmap on which to operate.
+ * @return The number of bytes.
+ */
+size_t gcu_roaring32_size_in_bytes(GCU_Roaring32 * roaring);
+
+/**
+ * Convert each container to runs, if runs take less memory.
+ *
+ * A container of runs is converted back to an array or a bitmap the next time
+ * that it is modified.
+ *
+ * @param roaring The bitmap on which to operate.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_roaring32_run_optimize(GCU_Roaring32 * roaring);
+
+/**
+ * Replace `destination` with the union of `destination` and `source`.
+ *
+ * @param destination The bitmap to modify.
+ * @param source The other operand.
+ * @return `true` on success, `false` if memory could not be allocated, in
+ *   which case `destination` holds a subset of the union.
+ */
+bool gcu_roaring32_or(GCU_Roaring32 * destination, GCU_Roaring32 * source);
+
+/**
+ * Replace `destination` with the intersection of `destination` and `source`.
+ *
+ * @param destination The bitmap to modify.
+ * @param source The other operand.
+ * @return `true` on success, `false` if memory could not be allocated, in
+ *   which case `destination` holds a superset of the intersection.
+ */
+bool gcu_roaring32_and(GCU_Roaring32 * destination, GCU_Roaring32 * source);
+
+/**
+ * Get an iterator to the smallest value of the bitmap.
+ *
+ * @param roaring The bitmap on which to operate.
+ * @return An iterator pointing to the first value (if it exists).
+ */
+GCU_Roaring32_Iterator gcu_roaring32_iterator_get(GCU_Roaring32 * roaring);
+
+/**
+ * Get an iterator to the next value (if it exists).
+ *
+ * @param iterator The current iterator.
+ * @return An iterator pointing to the next value (if it exists).
+ */
+GCU_Roaring32_Iterator gcu_roaring32_iterator_next(GCU_Roaring32_Iterator iterator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_ROARING_H
@@ -0,0 +1,231 @@
+/**
+ * @file
+ * A per-thread scratch stack, for temporary buffers.
+ *
+ * Code which needs a buffer only until it returns (to sort into, to gather
+ * keys in, to format into) can take it from the calling thread's scratch
+ * region instead of from the heap.  The region is an arena (see arena.h)
+ * owned by the thread, so taking a buffer moves a cursor, and no lock is
+ * ever taken.  Buffers are given back in the reverse of the order they were
+ * taken (last in, first out), by rewinding the region to a mark:
+ *
+ *     GCU_Scratch_Mark mark = gcu_scratch_mark();
+ *     uint64_t * keys = gcu_scratch_allocate(count * sizeof(uint64_t));
+ *     ...
+ *     gcu_scratch_rewind(mark);
+ *
+ * The region grows in chunks of `GCU_SCRATCH_CHUNK_SIZE` bytes as needed,
+ * and keeps them, so a thread stops calling `malloc()` once its region has
+ * grown to the most it uses at once.  Requests larger than
+ * `GCU_SCRATCH_LARGEST_SIZE` come from gcu_malloc() instead, so that one huge
+ * buffer is not kept for the life of the thread, and are freed by the rewind
+ * like any other.  The region is freed when its thread exits, or earlier by
+ * gcu_scratch_release().
+ *
+ * Scratch memory must not be passed to gcu_free(), nor to another thread
+ * which outlives the rewind, and is not zeroed.
+ */
+
+#ifndef GHOTIIO_CUTIL_SCRATCH_H
+#define GHOTIIO_CUTIL_SCRATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cutil/arena.h>
+#include <cutil/libver.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_Scratch GHOTIIO_CUTIL(GCU_Scratch)
+#define GCU_Scratch_Mark GHOTIIO_CUTIL(GCU_Scratch_Mark)
+#define gcu_scratch GHOTIIO_CUTIL(gcu_scratch)
+#define gcu_scratch_claim GHOTIIO_CUTIL(gcu_scratch_claim)
+#define gcu_scratch_allocate_slow GHOTIIO_CUTIL(gcu_scratch_allocate_slow)
+#define gcu_scratch_rewind_slow GHOTIIO_CUTIL(gcu_scratch_rewind_slow)
+#define gcu_scratch_mark GHOTIIO_CUTIL(gcu_scratch_mark)
+#define gcu_scratch_allocate GHOTIIO_CUTIL(gcu_scratch_allocate)
+#define gcu_scratch_rewind GHOTIIO_CUTIL(gcu_scratch_rewind)
+#define gcu_scratch_release GHOTIIO_CUTIL(gcu_scratch_release)
+#define gcu_scratch_in_use GHOTIIO_CUTIL(gcu_scratch_in_use)
+#define gcu_scratch_high_water GHOTIIO_CUTIL(gcu_scratch_high_water)
+/// @endcond
+
+/**
+ * The size of each chunk of a thread's scratch region.
+ */
+#define GCU_SCRATCH_CHUNK_SIZE ((size_t)256 << 10)
+
+/**
+ * The largest request served from the scratch region.  Larger ones come from
+ * gcu_malloc().
+ */
+#define GCU_SCRATCH_LARGEST_SIZE ((size_t)64 << 10)
+
+/**
+ * A position in the calling thread's scratch region, to which it can be
+ * rewound.
+ */
+typedef struct {
+  GCU_Arena_Mark arena;         ///< The position in the region.
+  void * heap;                  ///< The newest buffer from gcu_malloc().
+  size_t in_use;                ///< The bytes in use.
+} GCU_Scratch_Mark;
+
+/**
+ * The scratch region of one thread.
+ *
+ * Do not access this structure directly.  It appears here simply so that
+ * gcu_scratch_mark() and the other scratch functions can be inlined.
+ */
+typedef struct GCU_Scratch {
+  GCU_Arena arena;              ///< The chunks, which are kept for reuse.
+  void * heap;                  ///< The newest buffer from gcu_malloc().
+  size_t in_use;                ///< The bytes in use.
+  size_t high_water;            ///< The peak of `in_use`.
+} GCU_Scratch;
+
+/**
+ * The scratch region of the calling thread, or `NULL` if it has not yet
+ * used one.
+ *
+ * Do not access this variable directly.
+ */
+#ifdef __cplusplus
+extern thread_local GCU_Scratch * gcu_scratch;
+#else
+extern _Thread_local GCU_Scratch * gcu_scratch;
+#endif
+
+/**
+ * Give the calling thread its scratch region.
+ *
+ * Do not call this function directly.
+ *
+ * @returns The region, or `NULL` on failure.
+ */
+GCU_Scratch * gcu_scratch_claim(void);
+
+/**
+ * Allocate a buffer which does not fit in the chunk in use.
+ *
+ * Do not call this function directly.
+ *
+ * @param size The size of the buffer, in bytes.
+ * @returns The buffer, or `NULL` on failure.
+ */
+void * gcu_scratch_allocate_slow(size_t size);
+
+/**
+ * Rewind past buffers from gcu_malloc(), or to another chunk.
+ *
+ * Do not call this function directly.
+ *
+ * @param mark The mark.
+ */
+void gcu_scratch_rewind_slow(GCU_Scratch_Mark mark);
+
+/**
+ * Mark the calling thread's scratch region, so that everything allocated
+ * after it can be given back.
+ *
+ * @return The mark.
+ */
+static inline GCU_Scratch_Mark gcu_scratch_mark(void) {
+  // If the region cannot be created, rewinding to the mark empties it.
+  GCU_Scratch * scratch = gcu_scratch
+    ? gcu_scratch
+    : gcu_scratch_claim();
+  GCU_Scratch_Mark mark = {{0, 0}, 0, 0};
+  if (scratch) {
+    mark.arena.chunk = scratch->arena.chunk;
+    mark.arena.cursor = scratch->arena.cursor;
+    mark.heap = scratch->heap;
+    mark.in_use = scratch->in_use;
+  }
+  return mark;
+}
+
+/**
+ * Allocate a temporary buffer from the calling thread's scratch region.
+ *
+ * The buffer is aligned to `GCU_ARENA_ALIGNMENT`, and lasts until the region
+ * is rewound to a mark taken before it.
+ *
+ * @param size The size of the buffer, in bytes.
+ * @return The buffer, or `NULL` on failure.
+ */
+static inline void * gcu_scratch_allocate(size_t size) {
+  GCU_Scratch * scratch = gcu_scratch;
+  if (scratch && scratch->arena.cursor && size <= GCU_SCRATCH_LARGEST_SIZE) {
+    char * start = scratch->arena.cursor + (-(uintptr_t)scratch->arena.cursor & (GCU_ARENA_ALIGNMENT - 1));
+    if (start <= scratch->arena.end && size <= (size_t)(scratch->arena.end - start)) {
+      scratch->arena.cursor = start + size;
+      scratch->in_use += size;
+      if (scratch->in_use > scratch->high_water) {
+        scratch->high_water = scratch->in_use;
+      }
+      return start;
+    }
+  }
+  return gcu_scratch_allocate_slow(size);
+}
+
+/**
+ * Give back every buffer allocated by the calling thread since a mark.
+ *
+ * Marks must be rewound to in the reverse of the order they were taken, and
+ * rewinding to a mark gives back any marks taken after it.
+ *
+ * @param mark A mark taken by the calling thread.
+ */
+static inline void gcu_scratch_rewind(GCU_Scratch_Mark mark) {
+  // Within the chunk in use, only the cursor moves back.
+  GCU_Scratch * scratch = gcu_scratch;
+  if (scratch && mark.heap == scratch->heap && mark.arena.chunk == scratch->arena.chunk) {
+    scratch->arena.cursor = mark.arena.cursor;
+    scratch->in_use = mark.in_use;
+    return;
+  }
+  gcu_scratch_rewind_slow(mark);
+}
+
+/**
+ * Free the calling thread's scratch region, which must have nothing in use.
+ *
+ * The region is created again when it is next used, with its statistics
+ * starting again from zero.
+ */
+void gcu_scratch_release(void);
+
+/**
+ * Get the number of bytes of scratch memory which the calling thread is
+ * using.
+ *
+ * @return The bytes requested, and not yet given back.
+ */
+static inline size_t gcu_scratch_in_use(void) {
+  return gcu_scratch
+    ? gcu_scratch->in_use
+    : 0;
+}
+
+/**
+ * Get the most scratch memory which the calling thread has used at once,
+ * which is the size to which its region grows.
+ *
+ * @return The peak of gcu_scratch_in_use(), in bytes.
+ */
+static inline size_t gcu_scratch_high_water(void) {
+  return gcu_scratch
+    ? gcu_scratch->high_water
+    : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_SCRATCH_H
@@ -0,0 +1,665 @@
+/**
+ * @file
+ * Type-aware sorting of vectors and arrays of type unions.
+ *
+ * The sort functions interpret each element of the array as a single lane
+ * type (e.g., `ui64`, `i64`, or `f64` for 64-bit unions) and sort in ascending
+ * order.  Large arrays are sorted with an LSD radix sort on an order-preserving
+ * unsigned transform of the value, so signed integers and IEEE floats are
+ * handled without a comparison callback.  Small arrays (and small inputs in
+ * general) use a branchless quicksort.
+ *
+ * Floats are ordered by their bit patterns after the transform, which matches
+ * the numeric order for all non-NaN values and places `-0.0` before `0.0`.
+ * NaNs with the sign bit set sort before everything else, and all other NaNs
+ * sort after everything else.
+ *
+ * The radix sort requires a scratch buffer the same size as the input.  If the
+ * buffer cannot be allocated, then the functions return `false` and the data
+ * is left unmodified.
+ *
+ * The `par_sort` variants of the 64-bit and 32-bit sorts use a worker pool
+ * (see parallel.h).  They distribute the elements into 256 buckets by the
+ * highest digit which varies across the input, in parallel, and then sort the
+ * buckets in parallel.  Inputs of fewer than 65536 elements are sorted on the
+ * calling thread.
+ *
+ * Each sort also takes a view (see view.h), so that part of a vector can be
+ * sorted in place, and the `lower_bound` functions binary search a sorted
+ * view.
+ */
+
+#ifndef GHOTIIO_CUTIL_SORT_H
+#define GHOTIIO_CUTIL_SORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <cutil/parallel.h>
+#include <cutil/type.h>
+#include <cutil/vector.h>
+#include <cutil/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define gcu_sort64_ui64 GHOTIIO_CUTIL(gcu_sort64_ui64)
+#define gcu_sort64_i64 GHOTIIO_CUTIL(gcu_sort64_i64)
+#define gcu_sort64_f64 GHOTIIO_CUTIL(gcu_sort64_f64)
+#define gcu_sort32_ui32 GHOTIIO_CUTIL(gcu_sort32_ui32)
+#define gcu_sort32_i32 GHOTIIO_CUTIL(gcu_sort32_i32)
+#define gcu_sort32_f32 GHOTIIO_CUTIL(gcu_sort32_f32)
+#define gcu_sort16_ui16 GHOTIIO_CUTIL(gcu_sort16_ui16)
+#define gcu_sort16_i16 GHOTIIO_CUTIL(gcu_sort16_i16)
+#define gcu_sort8_ui8 GHOTIIO_CUTIL(gcu_sort8_ui8)
+#define gcu_sort8_i8 GHOTIIO_CUTIL(gcu_sort8_i8)
+
+#define gcu_vector64_sort_ui64 GHOTIIO_CUTIL(gcu_vector64_sort_ui64)
+#define gcu_vector64_sort_i64 GHOTIIO_CUTIL(gcu_vector64_sort_i64)
+#define gcu_vector64_sort_f64 GHOTIIO_CUTIL(gcu_vector64_sort_f64)
+#define gcu_vector32_sort_ui32 GHOTIIO_CUTIL(gcu_vector32_sort_ui32)
+#define gcu_vector32_sort_i32 GHOTIIO_CUTIL(gcu_vector32_sort_i32)
+#define gcu_vector32_sort_f32 GHOTIIO_CUTIL(gcu_vector32_sort_f32)
+#define gcu_vector16_sort_ui16 GHOTIIO_CUTIL(gcu_vector16_sort_ui16)
+#define gcu_vector16_sort_i16 GHOTIIO_CUTIL(gcu_vector16_sort_i16)
+#define gcu_vector8_sort_ui8 GHOTIIO_CUTIL(gcu_vector8_sort_ui8)
+#define gcu_vector8_sort_i8 GHOTIIO_CUTIL(gcu_vector8_sort_i8)
+
+#define gcu_par_sort64_ui64 GHOTIIO_CUTIL(gcu_par_sort64_ui64)
+#define gcu_par_sort64_i64 GHOTIIO_CUTIL(gcu_par_sort64_i64)
+#define gcu_par_sort64_f64 GHOTIIO_CUTIL(gcu_par_sort64_f64)
+#define gcu_par_sort32_ui32 GHOTIIO_CUTIL(gcu_par_sort32_ui32)
+#define gcu_par_sort32_i32 GHOTIIO_CUTIL(gcu_par_sort32_i32)
+#define gcu_par_sort32_f32 GHOTIIO_CUTIL(gcu_par_sort32_f32)
+
+#define gcu_vector64_par_sort_ui64 GHOTIIO_CUTIL(gcu_vector64_par_sort_ui64)
+#define gcu_vector64_par_sort_i64 GHOTIIO_CUTIL(gcu_vector64_par_sort_i64)
+#define gcu_vector64_par_sort_f64 GHOTIIO_CUTIL(gcu_vector64_par_sort_f64)
+#define gcu_vector32_par_sort_ui32 GHOTIIO_CUTIL(gcu_vector32_par_sort_ui32)
+#define gcu_vector32_par_sort_i32 GHOTIIO_CUTIL(gcu_vector32_par_sort_i32)
+#define gcu_vector32_par_sort_f32 GHOTIIO_CUTIL(gcu_vector32_par_sort_f32)
+
+#define gcu_view64_sort_ui64 GHOTIIO_CUTIL(gcu_view64_sort_ui64)
+#define gcu_view64_sort_i64 GHOTIIO_CUTIL(gcu_view64_sort_i64)
+#define gcu_view64_sort_f64 GHOTIIO_CUTIL(gcu_view64_sort_f64)
+#define gcu_view32_sort_ui32 GHOTIIO_CUTIL(gcu_view32_sort_ui32)
+#define gcu_view32_sort_i32 GHOTIIO_CUTIL(gcu_view32_sort_i32)
+#define gcu_view32_sort_f32 GHOTIIO_CUTIL(gcu_view32_sort_f32)
+#define gcu_view16_sort_ui16 GHOTIIO_CUTIL(gcu_view16_sort_ui16)
+#define gcu_view16_sort_i16 GHOTIIO_CUTIL(gcu_view16_sort_i16)
+#define gcu_view8_sort_ui8 GHOTIIO_CUTIL(gcu_view8_sort_ui8)
+#define gcu_view8_sort_i8 GHOTIIO_CUTIL(gcu_view8_sort_i8)
+
+#define gcu_view64_par_sort_ui64 GHOTIIO_CUTIL(gcu_view64_par_sort_ui64)
+#define gcu_view64_par_sort_i64 GHOTIIO_CUTIL(gcu_view64_par_sort_i64)
+#define gcu_view64_par_sort_f64 GHOTIIO_CUTIL(gcu_view64_par_sort_f64)
+#define gcu_view32_par_sort_ui32 GHOTIIO_CUTIL(gcu_view32_par_sort_ui32)
+#define gcu_view32_par_sort_i32 GHOTIIO_CUTIL(gcu_view32_par_sort_i32)
+#define gcu_view32_par_sort_f32 GHOTIIO_CUTIL(gcu_view32_par_sort_f32)
+
+#define gcu_view64_lower_bound_ui64 GHOTIIO_CUTIL(gcu_view64_lower_bound_ui64)
+#define gcu_view64_lower_bound_i64 GHOTIIO_CUTIL(gcu_view64_lower_bound_i64)
+#define gcu_view64_lower_bound_f64 GHOTIIO_CUTIL(gcu_view64_lower_bound_f64)
+#define gcu_view32_lower_bound_ui32 GHOTIIO_CUTIL(gcu_view32_lower_bound_ui32)
+#define gcu_view32_lower_bound_i32 GHOTIIO_CUTIL(gcu_view32_lower_bound_i32)
+#define gcu_view32_lower_bound_f32 GHOTIIO_CUTIL(gcu_view32_lower_bound_f32)
+#define gcu_view16_lower_bound_ui16 GHOTIIO_CUTIL(gcu_view16_lower_bound_ui16)
+#define gcu_view16_lower_bound_i16 GHOTIIO_CUTIL(gcu_view16_lower_bound_i16)
+#define gcu_view8_lower_bound_ui8 GHOTIIO_CUTIL(gcu_view8_lower_bound_ui8)
+#define gcu_view8_lower_bound_i8 GHOTIIO_CUTIL(gcu_view8_lower_bound_i8)
+/// @endcond
+
+/**
+ * Sort an array of 64-bit unions by their `ui64` value.
+ *
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_sort64_ui64(GCU_Type64_Union * data, size_t count);
+
+/**
+ * Sort an array of 64-bit unions by their `i64` value.
+ *
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_sort64_i64(GCU_Type64_Union * data, size_t count);
+
+/**
+ * Sort an array of 64-bit unions by their `f64` value.
+ *
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_sort64_f64(GCU_Type64_Union * data, size_t count);
+
+/**
+ * Sort an array of 32-bit unions by their `ui32` value.
+ *
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_sort32_ui32(GCU_Type32_Union * data, size_t count);
+
+/**
+ * Sort an array of 32-bit unions by their `i32` value.
+ *
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_sort32_i32(GCU_Type32_Union * data, size_t count);
+
+/**
+ * Sort an array of 32-bit unions by their `f32` value.
+ *
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_sort32_f32(GCU_Type32_Union * data, size_t count);
+
+/**
+ * Sort an array of 16-bit unions by their `ui16` value.
+ *
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_sort16_ui16(GCU_Type16_Union * data, size_t count);
+
+/**
+ * Sort an array of 16-bit unions by their `i16` value.
+ *
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_sort16_i16(GCU_Type16_Union * data, size_t count);
+
+/**
+ * Sort an array of 8-bit unions by their `ui8` value.
+ *
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_sort8_ui8(GCU_Type8_Union * data, size_t count);
+
+/**
+ * Sort an array of 8-bit unions by their `i8` value.
+ *
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_sort8_i8(GCU_Type8_Union * data, size_t count);
+
+/**
+ * Sort the contents of a vector by their `ui64` value.
+ *
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector64_sort_ui64(GCU_Vector64 * vector);
+
+/**
+ * Sort the contents of a vector by their `i64` value.
+ *
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector64_sort_i64(GCU_Vector64 * vector);
+
+/**
+ * Sort the contents of a vector by their `f64` value.
+ *
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector64_sort_f64(GCU_Vector64 * vector);
+
+/**
+ * Sort the contents of a vector by their `ui32` value.
+ *
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector32_sort_ui32(GCU_Vector32 * vector);
+
+/**
+ * Sort the contents of a vector by their `i32` value.
+ *
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector32_sort_i32(GCU_Vector32 * vector);
+
+/**
+ * Sort the contents of a vector by their `f32` value.
+ *
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector32_sort_f32(GCU_Vector32 * vector);
+
+/**
+ * Sort the contents of a vector by their `ui16` value.
+ *
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector16_sort_ui16(GCU_Vector16 * vector);
+
+/**
+ * Sort the contents of a vector by their `i16` value.
+ *
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector16_sort_i16(GCU_Vector16 * vector);
+
+/**
+ * Sort the contents of a vector by their `ui8` value.
+ *
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector8_sort_ui8(GCU_Vector8 * vector);
+
+/**
+ * Sort the contents of a vector by their `i8` value.
+ *
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector8_sort_i8(GCU_Vector8 * vector);
+
+/**
+ * Sort an array of 64-bit unions by their `ui64` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_par_sort64_ui64(GCU_Thread_Pool * pool, GCU_Type64_Union * data, size_t count);
+
+/**
+ * Sort an array of 64-bit unions by their `i64` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_par_sort64_i64(GCU_Thread_Pool * pool, GCU_Type64_Union * data, size_t count);
+
+/**
+ * Sort an array of 64-bit unions by their `f64` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_par_sort64_f64(GCU_Thread_Pool * pool, GCU_Type64_Union * data, size_t count);
+
+/**
+ * Sort an array of 32-bit unions by their `ui32` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_par_sort32_ui32(GCU_Thread_Pool * pool, GCU_Type32_Union * data, size_t count);
+
+/**
+ * Sort an array of 32-bit unions by their `i32` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_par_sort32_i32(GCU_Thread_Pool * pool, GCU_Type32_Union * data, size_t count);
+
+/**
+ * Sort an array of 32-bit unions by their `f32` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param data The array to sort.
+ * @param count The number of elements in the array.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_par_sort32_f32(GCU_Thread_Pool * pool, GCU_Type32_Union * data, size_t count);
+
+/**
+ * Sort the contents of a vector by their `ui64` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector64_par_sort_ui64(GCU_Thread_Pool * pool, GCU_Vector64 * vector);
+
+/**
+ * Sort the contents of a vector by their `i64` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector64_par_sort_i64(GCU_Thread_Pool * pool, GCU_Vector64 * vector);
+
+/**
+ * Sort the contents of a vector by their `f64` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector64_par_sort_f64(GCU_Thread_Pool * pool, GCU_Vector64 * vector);
+
+/**
+ * Sort the contents of a vector by their `ui32` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector32_par_sort_ui32(GCU_Thread_Pool * pool, GCU_Vector32 * vector);
+
+/**
+ * Sort the contents of a vector by their `i32` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector32_par_sort_i32(GCU_Thread_Pool * pool, GCU_Vector32 * vector);
+
+/**
+ * Sort the contents of a vector by their `f32` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param vector The vector to sort.
+ * @return `true` on success, `false` otherwise.
+ */
+bool gcu_vector32_par_sort_f32(GCU_Thread_Pool * pool, GCU_Vector32 * vector);
+
+/**
+ * Sort the contents of a view by their `ui64` value.
+ *
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view64_sort_ui64(GCU_Vector64_View view);
+
+/**
+ * Sort the contents of a view by their `i64` value.
+ *
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view64_sort_i64(GCU_Vector64_View view);
+
+/**
+ * Sort the contents of a view by their `f64` value.
+ *
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view64_sort_f64(GCU_Vector64_View view);
+
+/**
+ * Sort the contents of a view by their `ui32` value.
+ *
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view32_sort_ui32(GCU_Vector32_View view);
+
+/**
+ * Sort the contents of a view by their `i32` value.
+ *
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view32_sort_i32(GCU_Vector32_View view);
+
+/**
+ * Sort the contents of a view by their `f32` value.
+ *
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view32_sort_f32(GCU_Vector32_View view);
+
+/**
+ * Sort the contents of a view by their `ui16` value.
+ *
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view16_sort_ui16(GCU_Vector16_View view);
+
+/**
+ * Sort the contents of a view by their `i16` value.
+ *
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view16_sort_i16(GCU_Vector16_View view);
+
+/**
+ * Sort the contents of a view by their `ui8` value.
+ *
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view8_sort_ui8(GCU_Vector8_View view);
+
+/**
+ * Sort the contents of a view by their `i8` value.
+ *
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view8_sort_i8(GCU_Vector8_View view);
+
+/**
+ * Sort the contents of a view by their `ui64` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view64_par_sort_ui64(GCU_Thread_Pool * pool, GCU_Vector64_View view);
+
+/**
+ * Sort the contents of a view by their `i64` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view64_par_sort_i64(GCU_Thread_Pool * pool, GCU_Vector64_View view);
+
+/**
+ * Sort the contents of a view by their `f64` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view64_par_sort_f64(GCU_Thread_Pool * pool, GCU_Vector64_View view);
+
+/**
+ * Sort the contents of a view by their `ui32` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view32_par_sort_ui32(GCU_Thread_Pool * pool, GCU_Vector32_View view);
+
+/**
+ * Sort the contents of a view by their `i32` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view32_par_sort_i32(GCU_Thread_Pool * pool, GCU_Vector32_View view);
+
+/**
+ * Sort the contents of a view by their `f32` value, using a worker pool.
+ *
+ * @param pool The pool, or `NULL` for the default pool.
+ * @param view The view to sort.
+ * @return `true` on success, `false` if scratch memory could not be allocated.
+ */
+bool gcu_view32_par_sort_f32(GCU_Thread_Pool * pool, GCU_Vector32_View view);
+
+/**
+ * Find the first element of a view, sorted by its `ui64` value, which is not
+ * less than `value`.
+ *
+ * The order is that of gcu_view64_sort_ui64().
+ *
+ * @param view The sorted view to search.
+ * @param value The value to search for.
+ * @return The position of the element, or `view.count` if every element is
+ *   less than `value`.
+ */
+size_t gcu_view64_lower_bound_ui64(GCU_Vector64_View view, uint64_t value);
+
+/**
+ * Find the first element of a view, sorted by its `i64` value, which is not
+ * less than `value`.
+ *
+ * The order is that of gcu_view64_sort_i64().
+ *
+ * @param view The sorted view to search.
+ * @param value The value to search for.
+ * @return The position of the element, or `view.count` if every element is
+ *   less than `value`.
+ */
+size_t gcu_view64_lower_bound_i64(GCU_Vector64_View view, int64_t value);
+
+/**
+ * Find the first element of a view, sorted by its `f64` value, which is not
+ * less than `value`.
+ *
+ * The order is that of gcu_view64_sort_f64().
+ *
+ * @param view The sorted view to search.
+ * @param value The value to search for.
+ * @return The position of the element, or `view.count` if every element is
+ *   less than `value`.
+ */
+size_t gcu_view64_lower_bound_f64(GCU_Vector64_View view, double value);
+
+/**
+ * Find the first element of a view, sorted by its `ui32` value, which is not
+ * less than `value`.
+ *
+ * The order is that of gcu_view32_sort_ui32().
+ *
+ * @param view The sorted view to search.
+ * @param value The value to search for.
+ * @return The position of the element, or `view.count` if every element is
+ *   less than `value`.
+ */
+size_t gcu_view32_lower_bound_ui32(GCU_Vector32_View view, uint32_t value);
+
+/**
+ * Find the first element of a view, sorted by its `i32` value, which is not
+ * less than `value`.
+ *
+ * The order is that of gcu_view32_sort_i32().
+ *
+ * @param view The sorted view to search.
+ * @param value The value to search for.
+ * @return The position of the element, or `view.count` if every element is
+ *   less than `value`.
+ */
+size_t gcu_view32_lower_bound_i32(GCU_Vector32_View view, int32_t value);
+
+/**
+ * Find the first element of a view, sorted by its `f32` value, which is not
+ * less than `value`.
+ *
+ * The order is that of gcu_view32_sort_f32().
+ *
+ * @param view The sorted view to search.
+ * @param value The value to search for.
+ * @return The position of the element, or `view.count` if every element is
+ *   less than `value`.
+ */
+size_t gcu_view32_lower_bound_f32(GCU_Vector32_View view, float value);
+
+/**
+ * Find the first element of a view, sorted by its `ui16` value, which is not
+ * less than `value`.
+ *
+ * The order is that of gcu_view16_sort_ui16().
+ *
+ * @param view The sorted view to search.
+ * @param value The value to search for.
+ * @return The position of the element, or `view.count` if every element is
+ *   less than `value`.
+ */
+size_t gcu_view16_lower_bound_ui16(GCU_Vector16_View view, uint16_t value);
+
+/**
+ * Find the first element of a view, sorted by its `i16` value, which is not
+ * less than `value`.
+ *
+ * The order is that of gcu_view16_sort_i16().
+ *
+ * @param view The sorted view to search.
+ * @param value The value to search for.
+ * @return The position of the element, or `view.count` if every element is
+ *   less than `value`.
+ */
+size_t gcu_view16_lower_bound_i16(GCU_Vector16_View view, int16_t value);
+
+/**
+ * Find the first element of a view, sorted by its `ui8` value, which is not
+ * less than `value`.
+ *
+ * The order is that of gcu_view8_sort_ui8().
+ *
+ * @param view The sorted view to search.
+ * @param value The value to search for.
+ * @return The position of the element, or `view.count` if every element is
+ *   less than `value`.
+ */
+size_t gcu_view8_lower_bound_ui8(GCU_Vector8_View view, uint8_t value);
+
+/**
+ * Find the first element of a view, sorted by its `i8` value, which is not
+ * less than `value`.
+ *
+ * The order is that of gcu_view8_sort_i8().
+ *
+ * @param view The sorted view to search.
+ * @param value The value to search for.
+ * @return The position of the element, or `view.count` if every element is
+ *   less than `value`.
+ */
+size_t gcu_view8_lower_bound_i8(GCU_Vector8_View view, int8_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_SORT_H
@@ -1,12 +1,17 @@
 /**
  * @file
  * A simple vector implementation.
+ *
+ * Vectors have a `mutex` member unless the library was built with
+ * `GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX` (see hash.h for details), in which
+ * case creating and destroying a vector performs no mutex work at all.
  */
 
 #ifndef GHOTIIO_CUTIL_VECTOR_H
 #define GHOTIIO_CUTIL_VECTOR_H
 
 #include <stddef.h>
+#include <cutil/growth.h>
 #include <cutil/type.h>
 #include <cutil/mutex.h>
 
@@ -20,44 +25,60 @@ extern "C" {
 #define GCU_Vector64 GHOTIIO_CUTIL(GCU_Vector64)
 #define gcu_vector64_create GHOTIIO_CUTIL(gcu_vector64_create)
 #define gcu_vector64_create_in_place GHOTIIO_CUTIL(gcu_vector64_create_in_place)
+#define gcu_vector64_create_in_arena GHOTIIO_CUTIL(gcu_vector64_create_in_arena)
+#define gcu_vector64_create_embedded GHOTIIO_CUTIL(gcu_vector64_create_embedded)
 #define gcu_vector64_destroy GHOTIIO_CUTIL(gcu_vector64_destroy)
 #define gcu_vector64_destroy_in_place GHOTIIO_CUTIL(gcu_vector64_destroy_in_place)
 #define gcu_vector64_append GHOTIIO_CUTIL(gcu_vector64_append)
 #define gcu_vector64_count GHOTIIO_CUTIL(gcu_vector64_count)
+#define gcu_vector64_bytes GHOTIIO_CUTIL(gcu_vector64_bytes)
 #define gcu_vector64_reserve GHOTIIO_CUTIL(gcu_vector64_reserve)
+#define gcu_vector64_set_growth GHOTIIO_CUTIL(gcu_vector64_set_growth)
 
 #define GCU_Vector32_Cleanup GHOTIIO_CUTIL(GCU_Vector32_Cleanup)
 #define GCU_Vector32_Value GHOTIIO_CUTIL(GCU_Vector32_Value)
 #define GCU_Vector32 GHOTIIO_CUTIL(GCU_Vector32)
 #define gcu_vector32_create GHOTIIO_CUTIL(gcu_vector32_create)
 #define gcu_vector32_create_in_place GHOTIIO_CUTIL(gcu_vector32_create_in_place)
+#define gcu_vector32_create_in_arena GHOTIIO_CUTIL(gcu_vector32_create_in_arena)
+#define gcu_vector32_create_embedded GHOTIIO_CUTIL(gcu_vector32_create_embedded)
 #define gcu_vector32_destroy GHOTIIO_CUTIL(gcu_vector32_destroy)
 #define gcu_vector32_destroy_in_place GHOTIIO_CUTIL(gcu_vector32_destroy_in_place)
 #define gcu_vector32_append GHOTIIO_CUTIL(gcu_vector32_append)
 #define gcu_vector32_count GHOTIIO_CUTIL(gcu_vector32_count)
+#define gcu_vector32_bytes GHOTIIO_CUTIL(gcu_vector32_bytes)
 #define gcu_vector32_reserve GHOTIIO_CUTIL(gcu_vector32_reserve)
+#define gcu_vector32_set_growth GHOTIIO_CUTIL(gcu_vector32_set_growth)
 
 #define GCU_Vector16_Cleanup GHOTIIO_CUTIL(GCU_Vector16_Cleanup)
 #define GCU_Vector16_Value GHOTIIO_CUTIL(GCU_Vector16_Value)
 #define GCU_Vector16 GHOTIIO_CUTIL(GCU_Vector16)
 #define gcu_vector16_create GHOTIIO_CUTIL(gcu_vector16_create)
 #define gcu_vector16_create_in_place GHOTIIO_CUTIL(gcu_vector16_create_in_place)
+#define gcu_vector16_create_in_arena GHOTIIO_CUTIL(gcu_vector16_create_in_arena)
+#define gcu_vector16_create_embedded GHOTIIO_CUTIL(gcu_vector16_create_embedded)
 #define gcu_vector16_destroy GHOTIIO_CUTIL(gcu_vector16_destroy)
 #define gcu_vector16_destroy_in_place GHOTIIO_CUTIL(gcu_vector16_destroy_in_place)
 #define gcu_vector16_append GHOTIIO_CUTIL(gcu_vector16_append)
 #define gcu_vector16_count GHOTIIO_CUTIL(gcu_vector16_count)
+#define gcu_vector16_bytes GHOTIIO_CUTIL(gcu_vector16_bytes)
 #define gcu_vector16_reserve GHOTIIO_CUTIL(gcu_vector16_reserve)
+#define gcu_vector16_set_growth GHOTIIO_CUTIL(gcu_vector16_set_growth)
 
 #define GCU_Vector8_Cleanup GHOTIIO_CUTIL(GCU_Vector8_Cleanup)
 #define GCU_Vector8_Value GHOTIIO_CUTIL(GCU_Vector8_Value)
 #define GCU_Vector8 GHOTIIO_CUTIL(GCU_Vector8)
 #define gcu_vector8_create GHOTIIO_CUTIL(gcu_vector8_create)
 #define gcu_vector8_create_in_place GHOTIIO_CUTIL(gcu_vector8_create_in_place)
+#define gcu_vector8_create_in_arena GHOTIIO_CUTIL(gcu_vector8_create_in_arena)
+#define gcu_vector8_create_embedded GHOTIIO_CUTIL(gcu_vector8_create_embedded)
 #define gcu_vector8_destroy GHOTIIO_CUTIL(gcu_vector8_destroy)
 #define gcu_vector8_destroy_in_place GHOTIIO_CUTIL(gcu_vector8_destroy_in_place)
 #define gcu_vector8_append GHOTIIO_CUTIL(gcu_vector8_append)
 #define gcu_vector8_count GHOTIIO_CUTIL(gcu_vector8_count)
+#define gcu_vector8_bytes GHOTIIO_CUTIL(gcu_vector8_bytes)
 #define gcu_vector8_reserve GHOTIIO_CUTIL(gcu_vector8_reserve)
+#define gcu_vector8_set_growth GHOTIIO_CUTIL(gcu_vector8_set_growth)
 /// @endcond
 
 typedef struct GCU_Vector64 GCU_Vector64;
@@ -125,9 +146,13 @@ typedef struct GCU_Vector64 {
   size_t capacity;              ///< The total item capacity of the vector.
   size_t count;                 ///< The count of non-empty cells.
   GCU_Type64_Union * data;      ///< A pointer to the array of data cells.
+  bool embedded;                ///< Whether `data` shares the vector's allocation.
+  GCU_Growth growth;            ///< How the data grows (see gcu_vector64_set_growth()).
   void * supplementary_data;    ///< User-defined.
   GCU_Vector64_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
   GCU_MUTEX_T mutex;            ///< Mutex for thread-safety.
+#endif
 } GCU_Vector64;
 
 /**
@@ -159,6 +184,35 @@ GCU_Vector64 * gcu_vector64_create(size_t count);
  */
 bool gcu_vector64_create_in_place(GCU_Vector64 * vector, size_t count);
 
+/**
+ * Create a vector structure in an arena.
+ *
+ * Both the structure and its data are allocated from the arena (see
+ * arena.h), and are given back when the arena is reset.  The vector may
+ * still be passed to gcu_vector64_destroy(), which calls its `cleanup`
+ * function and releases its mutex, but frees no memory.
+ *
+ * @param arena The arena from which to allocate.
+ * @param count The number of items anticipated to be stored in the vector.
+ * @return A pointer to the vector on success, `NULL` otherwise.
+ */
+GCU_Vector64 * gcu_vector64_create_in_arena(GCU_Arena * arena, size_t count);
+
+/**
+ * Create a vector structure with its initial data in the same allocation.
+ *
+ * The structure and room for `count` items are allocated as one block, which
+ * saves an allocation, and keeps the data next to the structure in memory.
+ * Should the vector outgrow that room, its data moves to a block of its own
+ * (allocated according to its growth policy), and the room is left unused until
+ * the vector is destroyed, so this suits vectors whose size is known in
+ * advance.  Destroy it with gcu_vector64_destroy(), as usual.
+ *
+ * @param count The number of items anticipated to be stored in the vector.
+ * @return A pointer to the vector on success, `NULL` otherwise.
+ */
+GCU_Vector64 * gcu_vector64_create_embedded(size_t count);
+
 /**
  * Destroy a vector structure and clean up memory allocations.
  *
@@ -200,6 +254,19 @@ bool gcu_vector64_append(GCU_Vector64 * vector, GCU_Type64_Union value);
  */
 size_t gcu_vector64_count(GCU_Vector64 * vector);
 
+/**
+ * Get the bytes of storage which the vector's data takes, whether or not
+ * all of it is in use.
+ *
+ * The structure itself takes `sizeof(GCU_Vector64)` more.  A vector whose
+ * growth policy names a budget allocator (see budget.h) is also counted by
+ * the budget.
+ *
+ * @param vector The vector structure on which to operate.
+ * @return The bytes of data storage.
+ */
+size_t gcu_vector64_bytes(GCU_Vector64 * vector);
+
 /**
  * Reserve space in the vector.
  *
@@ -213,6 +280,24 @@ size_t gcu_vector64_count(GCU_Vector64 * vector);
  */
 bool gcu_vector64_reserve(GCU_Vector64 * vector, size_t count);
 
+/**
+ * Set how the storage of the vector grows, and whether it is backed by huge
+ * pages (see growth.h).
+ *
+ * If the vector already has storage which the new policy would allocate
+ * differently, then it is moved to new storage.
+ *
+ * The `arena` of the policy must be the one in which the vector was
+ * created (or `NULL` if it was not), since storage cannot move between
+ * arenas.
+ *
+ * @param vector The vector structure on which to operate.
+ * @param growth The growth policy.
+ * @return `true` on success, `false` otherwise (in which case the vector is
+ *   unchanged).
+ */
+bool gcu_vector64_set_growth(GCU_Vector64 * vector, GCU_Growth growth);
+
 /**
  * Container holding the information of the 32-bit vector.
  *
@@ -229,9 +314,13 @@ typedef struct GCU_Vector32 {
   size_t capacity;              ///< The total item capacity of the vector.
   size_t count;                 ///< The count of non-empty cells.
   GCU_Type32_Union * data;      ///< A pointer to the array of data cells.
+  bool embedded;                ///< Whether `data` shares the vector's allocation.
+  GCU_Growth growth;            ///< How the data grows (see gcu_vector32_set_growth()).
   void * supplementary_data;    ///< User-defined.
   GCU_Vector32_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
   GCU_MUTEX_T mutex;            ///< Mutex for thread-safety.
+#endif
 } GCU_Vector32;
 
 /**
@@ -263,6 +352,35 @@ GCU_Vector32 * gcu_vector32_create(size_t count);
  */
 bool gcu_vector32_create_in_place(GCU_Vector32 * vector, size_t count);
 
+/**
+ * Create a vector structure in an arena.
+ *
+ * Both the structure and its data are allocated from the arena (see
+ * arena.h), and are given back when the arena is reset.  The vector may
+ * still be passed to gcu_vector32_destroy(), which calls its `cleanup`
+ * function and releases its mutex, but frees no memory.
+ *
+ * @param arena The arena from which to allocate.
+ * @param count The number of items anticipated to be stored in the vector.
+ * @return A pointer to the vector on success, `NULL` otherwise.
+ */
+GCU_Vector32 * gcu_vector32_create_in_arena(GCU_Arena * arena, size_t count);
+
+/**
+ * Create a vector structure with its initial data in the same allocation.
+ *
+ * The structure and room for `count` items are allocated as one block, which
+ * saves an allocation, and keeps the data next to the structure in memory.
+ * Should the vector outgrow that room, its data moves to a block of its own
+ * (allocated according to its growth policy), and the room is left unused until
+ * the vector is destroyed, so this suits vectors whose size is known in
+ * advance.  Destroy it with gcu_vector32_destroy(), as usual.
+ *
+ * @param count The number of items anticipated to be stored in the vector.
+ * @return A pointer to the vector on success, `NULL` otherwise.
+ */
+GCU_Vector32 * gcu_vector32_create_embedded(size_t count);
+
 /**
  * Destroy a vector structure and clean up memory allocations.
  *
@@ -304,6 +422,19 @@ bool gcu_vector32_append(GCU_Vector32 * vector, GCU_Type32_Union value);
  */
 size_t gcu_vector32_count(GCU_Vector32 * vector);
 
+/**
+ * Get the bytes of storage which the vector's data takes, whether or not
+ * all of it is in use.
+ *
+ * The structure itself takes `sizeof(GCU_Vector32)` more.  A vector whose
+ * growth policy names a budget allocator (see budget.h) is also counted by
+ * the budget.
+ *
+ * @param vector The vector structure on which to operate.
+ * @return The bytes of data storage.
+ */
+size_t gcu_vector32_bytes(GCU_Vector32 * vector);
+
 /**
  * Reserve space in the vector.
  *
@@ -317,6 +448,24 @@ size_t gcu_vector32_count(GCU_Vector32 * vector);
  */
 bool gcu_vector32_reserve(GCU_Vector32 * vector, size_t count);
 
+/**
+ * Set how the storage of the vector grows, and whether it is backed by huge
+ * pages (see growth.h).
+ *
+ * If the vector already has storage which the new policy would allocate
+ * differently, then it is moved to new storage.
+ *
+ * The `arena` of the policy must be the one in which the vector was
+ * created (or `NULL` if it was not), since storage cannot move between
+ * arenas.
+ *
+ * @param vector The vector structure on which to operate.
+ * @param growth The growth policy.
+ * @return `true` on success, `false` otherwise (in which case the vector is
+ *   unchanged).
+ */
+bool gcu_vector32_set_growth(GCU_Vector32 * vector, GCU_Growth growth);
+
 /**
  * Container holding the information of the 16-bit vector.
  *
@@ -333,9 +482,13 @@ typedef struct GCU_Vector16 {
   size_t capacity;              ///< The total item capacity of the vector.
   size_t count;                 ///< The count of non-empty cells.
   GCU_Type16_Union * data;      ///< A pointer to the array of data cells.
+  bool embedded;                ///< Whether `data` shares the vector's allocation.
+  GCU_Growth growth;            ///< How the data grows (see gcu_vector16_set_growth()).
   void * supplementary_data;    ///< User-defined.
   GCU_Vector16_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
   GCU_MUTEX_T mutex;            ///< Mutex for thread-safety.
+#endif
 } GCU_Vector16;
 
 /**
@@ -367,6 +520,35 @@ GCU_Vector16 * gcu_vector16_create(size_t count);
  */
 bool gcu_vector16_create_in_place(GCU_Vector16 * vector, size_t count);
 
+/**
+ * Create a vector structure in an arena.
+ *
+ * Both the structure and its data are allocated from the arena (see
+ * arena.h), and are given back when the arena is reset.  The vector may
+ * still be passed to gcu_vector16_destroy(), which calls its `cleanup`
+ * function and releases its mutex, but frees no memory.
+ *
+ * @param arena The arena from which to allocate.
+ * @param count The number of items anticipated to be stored in the vector.
+ * @return A pointer to the vector on success, `NULL` otherwise.
+ */
+GCU_Vector16 * gcu_vector16_create_in_arena(GCU_Arena * arena, size_t count);
+
+/**
+ * Create a vector structure with its initial data in the same allocation.
+ *
+ * The structure and room for `count` items are allocated as one block, which
+ * saves an allocation, and keeps the data next to the structure in memory.
+ * Should the vector outgrow that room, its data moves to a block of its own
+ * (allocated according to its growth policy), and the room is left unused until
+ * the vector is destroyed, so this suits vectors whose size is known in
+ * advance.  Destroy it with gcu_vector16_destroy(), as usual.
+ *
+ * @param count The number of items anticipated to be stored in the vector.
+ * @return A pointer to the vector on success, `NULL` otherwise.
+ */
+GCU_Vector16 * gcu_vector16_create_embedded(size_t count);
+
 /**
  * Destroy a vector structure and clean up memory allocations.
  *
@@ -408,6 +590,19 @@ bool gcu_vector16_append(GCU_Vector16 * vector, GCU_Type16_Union value);
  */
 size_t gcu_vector16_count(GCU_Vector16 * vector);
 
+/**
+ * Get the bytes of storage which the vector's data takes, whether or not
+ * all of it is in use.
+ *
+ * The structure itself takes `sizeof(GCU_Vector16)` more.  A vector whose
+ * growth policy names a budget allocator (see budget.h) is also counted by
+ * the budget.
+ *
+ * @param vector The vector structure on which to operate.
+ * @return The bytes of data storage.
+ */
+size_t gcu_vector16_bytes(GCU_Vector16 * vector);
+
 /**
  * Reserve space in the vector.
  *
@@ -421,6 +616,24 @@ size_t gcu_vector16_count(GCU_Vector16 * vector);
  */
 bool gcu_vector16_reserve(GCU_Vector16 * vector, size_t count);
 
+/**
+ * Set how the storage of the vector grows, and whether it is backed by huge
+ * pages (see growth.h).
+ *
+ * If the vector already has storage which the new policy would allocate
+ * differently, then it is moved to new storage.
+ *
+ * The `arena` of the policy must be the one in which the vector was
+ * created (or `NULL` if it was not), since storage cannot move between
+ * arenas.
+ *
+ * @param vector The vector structure on which to operate.
+ * @param growth The growth policy.
+ * @return `true` on success, `false` otherwise (in which case the vector is
+ *   unchanged).
+ */
+bool gcu_vector16_set_growth(GCU_Vector16 * vector, GCU_Growth growth);
+
 /**
  * Container holding the information of the 8-bit vector.
  *
@@ -437,9 +650,13 @@ typedef struct GCU_Vector8 {
   size_t capacity;             ///< The total item capacity of the vector.
   size_t count;                ///< The count of non-empty cells.
   GCU_Type8_Union * data;      ///< A pointer to the array of data cells.
+  bool embedded;               ///< Whether `data` shares the vector's allocation.
+  GCU_Growth growth;           ///< How the data grows (see gcu_vector8_set_growth()).
   void * supplementary_data;   ///< User-defined.
   GCU_Vector8_Cleanup cleanup; ///< User-defined cleanup function.
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
   GCU_MUTEX_T mutex;           ///< Mutex for thread-safety.
+#endif
 } GCU_Vector8;
 
 /**
@@ -471,6 +688,35 @@ GCU_Vector8 * gcu_vector8_create(size_t count);
  */
 bool gcu_vector8_create_in_place(GCU_Vector8 * vector, size_t count);
 
+/**
+ * Create a vector structure in an arena.
+ *
+ * Both the structure and its data are allocated from the arena (see
+ * arena.h), and are given back when the arena is reset.  The vector may
+ * still be passed to gcu_vector8_destroy(), which calls its `cleanup`
+ * function and releases its mutex, but frees no memory.
+ *
+ * @param arena The arena from which to allocate.
+ * @param count The number of items anticipated to be stored in the vector.
+ * @return A pointer to the vector on success, `NULL` otherwise.
+ */
+GCU_Vector8 * gcu_vector8_create_in_arena(GCU_Arena * arena, size_t count);
+
+/**
+ * Create a vector structure with its initial data in the same allocation.
+ *
+ * The structure and room for `count` items are allocated as one block, which
+ * saves an allocation, and keeps the data next to the structure in memory.
+ * Should the vector outgrow that room, its data moves to a block of its own
+ * (allocated according to its growth policy), and the room is left unused until
+ * the vector is destroyed, so this suits vectors whose size is known in
+ * advance.  Destroy it with gcu_vector8_destroy(), as usual.
+ *
+ * @param count The number of items anticipated to be stored in the vector.
+ * @return A pointer to the vector on success, `NULL` otherwise.
+ */
+GCU_Vector8 * gcu_vector8_create_embedded(size_t count);
+
 /**
  * Destroy a vector structure and clean up memory allocations.
  *
@@ -512,6 +758,19 @@ bool gcu_vector8_append(GCU_Vector8 * vector, GCU_Type8_Union value);
  */
 size_t gcu_vector8_count(GCU_Vector8 * vector);
 
+/**
+ * Get the bytes of storage which the vector's data takes, whether or not
+ * all of it is in use.
+ *
+ * The structure itself takes `sizeof(GCU_Vector8)` more.  A vector whose
+ * growth policy names a budget allocator (see budget.h) is also counted by
+ * the budget.
+ *
+ * @param vector The vector structure on which to operate.
+ * @return The bytes of data storage.
+ */
+size_t gcu_vector8_bytes(GCU_Vector8 * vector);
+
 /**
  * Reserve space in the vector.
  *
@@ -525,6 +784,24 @@ size_t gcu_vector8_count(GCU_Vector8 * vector);
  */
 bool gcu_vector8_reserve(GCU_Vector8 * vector, size_t count);
 
+/**
+ * Set how the storage of the vector grows, and whether it is backed by huge
+ * pages (see growth.h).
+ *
+ * If the vector already has storage which the new policy would allocate
+ * differently, then it is moved to new storage.
+ *
+ * The `arena` of the policy must be the one in which the vector was
+ * created (or `NULL` if it was not), since storage cannot move between
+ * arenas.
+ *
+ * @param vector The vector structure on which to operate.
+ * @param growth The growth policy.
+ * @return `true` on success, `false` otherwise (in which case the vector is
+ *   unchanged).
+ */
+bool gcu_vector8_set_growth(GCU_Vector8 * vector, GCU_Growth growth);
+
 #ifdef __cplusplus
 }
 #endif
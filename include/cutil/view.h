@@ -0,0 +1,388 @@
+/**
+ * @file
+ * Non-owning views of contiguous ranges of type unions.
+ *
+ * A view is a pointer and a count, passed by value.  It can be taken of the
+ * whole or part of a vector, or of any buffer, and sliced or split into parts
+ * without copying or allocating anything, so handing a sub-range of a vector
+ * to a worker thread costs nothing.  The element width is part of the type:
+ * a GCU_Vector64_View is a view of GCU_Type64_Union cells, and so on.
+ *
+ * A view does not keep its memory alive.  It is invalidated by anything that
+ * invalidates a pointer into the underlying storage, such as appending to the
+ * vector that it was taken from.
+ *
+ * Every function which takes a pointer to an array of type unions and a count
+ * (such as those of reduce.h) accepts a view through GCU_VIEW_ARGS().  The
+ * sort functions have view variants in sort.h.
+ */
+
+#ifndef GHOTIIO_CUTIL_VIEW_H
+#define GHOTIIO_CUTIL_VIEW_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <cutil/vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond HIDDEN_SYMBOLS
+#define GCU_Vector64_View GHOTIIO_CUTIL(GCU_Vector64_View)
+#define gcu_vector64_view GHOTIIO_CUTIL(gcu_vector64_view)
+#define gcu_view64_of GHOTIIO_CUTIL(gcu_view64_of)
+#define gcu_view64_slice GHOTIIO_CUTIL(gcu_view64_slice)
+#define gcu_view64_split GHOTIIO_CUTIL(gcu_view64_split)
+#define gcu_view64_hash GHOTIIO_CUTIL(gcu_view64_hash)
+#define gcu_view64_copy GHOTIIO_CUTIL(gcu_view64_copy)
+
+#define GCU_Vector32_View GHOTIIO_CUTIL(GCU_Vector32_View)
+#define gcu_vector32_view GHOTIIO_CUTIL(gcu_vector32_view)
+#define gcu_view32_of GHOTIIO_CUTIL(gcu_view32_of)
+#define gcu_view32_slice GHOTIIO_CUTIL(gcu_view32_slice)
+#define gcu_view32_split GHOTIIO_CUTIL(gcu_view32_split)
+#define gcu_view32_hash GHOTIIO_CUTIL(gcu_view32_hash)
+#define gcu_view32_copy GHOTIIO_CUTIL(gcu_view32_copy)
+
+#define GCU_Vector16_View GHOTIIO_CUTIL(GCU_Vector16_View)
+#define gcu_vector16_view GHOTIIO_CUTIL(gcu_vector16_view)
+#define gcu_view16_of GHOTIIO_CUTIL(gcu_view16_of)
+#define gcu_view16_slice GHOTIIO_CUTIL(gcu_view16_slice)
+#define gcu_view16_split GHOTIIO_CUTIL(gcu_view16_split)
+#define gcu_view16_hash GHOTIIO_CUTIL(gcu_view16_hash)
+#define gcu_view16_copy GHOTIIO_CUTIL(gcu_view16_copy)
+
+#define GCU_Vector8_View GHOTIIO_CUTIL(GCU_Vector8_View)
+#define gcu_vector8_view GHOTIIO_CUTIL(gcu_vector8_view)
+#define gcu_view8_of GHOTIIO_CUTIL(gcu_view8_of)
+#define gcu_view8_slice GHOTIIO_CUTIL(gcu_view8_slice)
+#define gcu_view8_split GHOTIIO_CUTIL(gcu_view8_split)
+#define gcu_view8_hash GHOTIIO_CUTIL(gcu_view8_hash)
+#define gcu_view8_copy GHOTIIO_CUTIL(gcu_view8_copy)
+/// @endcond
+
+/**
+ * Expand a view into the pointer and count arguments of a function which
+ * takes an array of type unions.
+ *
+ * For example: `gcu_sum64_ui64(GCU_VIEW_ARGS(view))`.
+ *
+ * @param view The view.
+ */
+#define GCU_VIEW_ARGS(view) (view).data, (view).count
+
+/**
+ * A non-owning view of `count` consecutive 64-bit cells.
+ */
+typedef struct {
+  GCU_Type64_Union * data; ///< The first cell.
+  size_t count;            ///< The number of cells.
+} GCU_Vector64_View;
+
+/**
+ * Get a view of part of a vector.
+ *
+ * The range is clipped to the vector, so `gcu_vector64_view(vector, 0,
+ * SIZE_MAX)` is a view of the whole vector.
+ *
+ * @param vector The vector.
+ * @param start The position of the first cell of the view.
+ * @param count The largest number of cells in the view.
+ * @return The view.
+ */
+GCU_Vector64_View gcu_vector64_view(GCU_Vector64 * vector, size_t start, size_t count);
+
+/**
+ * Get a view of a buffer.
+ *
+ * @param data The first cell.
+ * @param count The number of cells.
+ * @return The view.
+ */
+GCU_Vector64_View gcu_view64_of(GCU_Type64_Union * data, size_t count);
+
+/**
+ * Get a view of part of a view.
+ *
+ * The range is clipped to the view.
+ *
+ * @param view The view.
+ * @param start The position of the first cell of the new view.
+ * @param count The largest number of cells in the new view.
+ * @return The new view.
+ */
+GCU_Vector64_View gcu_view64_slice(GCU_Vector64_View view, size_t start, size_t count);
+
+/**
+ * Get one of `parts` nearly equal, consecutive parts of a view.
+ *
+ * The sizes of the parts differ by at most one, and together they cover the
+ * whole view, so `parts` workers can each take the part of their own index.
+ *
+ * @param view The view.
+ * @param parts The number of parts.
+ * @param index The part, from `0` to `parts - 1`.
+ * @return The part, which is empty if `index >= parts`.
+ */
+GCU_Vector64_View gcu_view64_split(GCU_Vector64_View view, size_t parts, size_t index);
+
+/**
+ * Hash the contents of a view.
+ *
+ * Views with the same cells have the same hash, wherever they are in memory.
+ *
+ * @param view The view.
+ * @return The hash.
+ */
+uint64_t gcu_view64_hash(GCU_Vector64_View view);
+
+/**
+ * Append the contents of a view to a vector.
+ *
+ * The view must not be of the same vector.
+ *
+ * @param view The view.
+ * @param vector The vector which receives the cells.
+ * @return `true` on success, `false` otherwise (in which case the vector is
+ *   unchanged).
+ */
+bool gcu_view64_copy(GCU_Vector64_View view, GCU_Vector64 * vector);
+
+/**
+ * A non-owning view of `count` consecutive 32-bit cells.
+ */
+typedef struct {
+  GCU_Type32_Union * data; ///< The first cell.
+  size_t count;            ///< The number of cells.
+} GCU_Vector32_View;
+
+/**
+ * Get a view of part of a vector.
+ *
+ * The range is clipped to the vector, so `gcu_vector32_view(vector, 0,
+ * SIZE_MAX)` is a view of the whole vector.
+ *
+ * @param vector The vector.
+ * @param start The position of the first cell of the view.
+ * @param count The largest number of cells in the view.
+ * @return The view.
+ */
+GCU_Vector32_View gcu_vector32_view(GCU_Vector32 * vector, size_t start, size_t count);
+
+/**
+ * Get a view of a buffer.
+ *
+ * @param data The first cell.
+ * @param count The number of cells.
+ * @return The view.
+ */
+GCU_Vector32_View gcu_view32_of(GCU_Type32_Union * data, size_t count);
+
+/**
+ * Get a view of part of a view.
+ *
+ * The range is clipped to the view.
+ *
+ * @param view The view.
+ * @param start The position of the first cell of the new view.
+ * @param count The largest number of cells in the new view.
+ * @return The new view.
+ */
+GCU_Vector32_View gcu_view32_slice(GCU_Vector32_View view, size_t start, size_t count);
+
+/**
+ * Get one of `parts` nearly equal, consecutive parts of a view.
+ *
+ * The sizes of the parts differ by at most one, and together they cover the
+ * whole view, so `parts` workers can each take the part of their own index.
+ *
+ * @param view The view.
+ * @param parts The number of parts.
+ * @param index The part, from `0` to `parts - 1`.
+ * @return The part, which is empty if `index >= parts`.
+ */
+GCU_Vector32_View gcu_view32_split(GCU_Vector32_View view, size_t parts, size_t index);
+
+/**
+ * Hash the contents of a view.
+ *
+ * Views with the same cells have the same hash, wherever they are in memory.
+ *
+ * @param view The view.
+ * @return The hash.
+ */
+uint64_t gcu_view32_hash(GCU_Vector32_View view);
+
+/**
+ * Append the contents of a view to a vector.
+ *
+ * The view must not be of the same vector.
+ *
+ * @param view The view.
+ * @param vector The vector which receives the cells.
+ * @return `true` on success, `false` otherwise (in which case the vector is
+ *   unchanged).
+ */
+bool gcu_view32_copy(GCU_Vector32_View view, GCU_Vector32 * vector);
+
+/**
+ * A non-owning view of `count` consecutive 16-bit cells.
+ */
+typedef struct {
+  GCU_Type16_Union * data; ///< The first cell.
+  size_t count;            ///< The number of cells.
+} GCU_Vector16_View;
+
+/**
+ * Get a view of part of a vector.
+ *
+ * The range is clipped to the vector, so `gcu_vector16_view(vector, 0,
+ * SIZE_MAX)` is a view of the whole vector.
+ *
+ * @param vector The vector.
+ * @param start The position of the first cell of the view.
+ * @param count The largest number of cells in the view.
+ * @return The view.
+ */
+GCU_Vector16_View gcu_vector16_view(GCU_Vector16 * vector, size_t start, size_t count);
+
+/**
+ * Get a view of a buffer.
+ *
+ * @param data The first cell.
+ * @param count The number of cells.
+ * @return The view.
+ */
+GCU_Vector16_View gcu_view16_of(GCU_Type16_Union * data, size_t count);
+
+/**
+ * Get a view of part of a view.
+ *
+ * The range is clipped to the view.
+ *
+ * @param view The view.
+ * @param start The position of the first cell of the new view.
+ * @param count The largest number of cells in the new view.
+ * @return The new view.
+ */
+GCU_Vector16_View gcu_view16_slice(GCU_Vector16_View view, size_t start, size_t count);
+
+/**
+ * Get one of `parts` nearly equal, consecutive parts of a view.
+ *
+ * The sizes of the parts differ by at most one, and together they cover the
+ * whole view, so `parts` workers can each take the part of their own index.
+ *
+ * @param view The view.
+ * @param parts The number of parts.
+ * @param index The part, from `0` to `parts - 1`.
+ * @return The part, which is empty if `index >= parts`.
+ */
+GCU_Vector16_View gcu_view16_split(GCU_Vector16_View view, size_t parts, size_t index);
+
+/**
+ * Hash the contents of a view.
+ *
+ * Views with the same cells have the same hash, wherever they are in memory.
+ *
+ * @param view The view.
+ * @return The hash.
+ */
+uint64_t gcu_view16_hash(GCU_Vector16_View view);
+
+/**
+ * Append the contents of a view to a vector.
+ *
+ * The view must not be of the same vector.
+ *
+ * @param view The view.
+ * @param vector The vector which receives the cells.
+ * @return `true` on success, `false` otherwise (in which case the vector is
+ *   unchanged).
+ */
+bool gcu_view16_copy(GCU_Vector16_View view, GCU_Vector16 * vector);
+
+/**
+ * A non-owning view of `count` consecutive 8-bit cells.
+ */
+typedef struct {
+  GCU_Type8_Union * data; ///< The first cell.
+  size_t count;             ///< The number of cells.
+} GCU_Vector8_View;
+
+/**
+ * Get a view of part of a vector.
+ *
+ * The range is clipped to the vector, so `gcu_vector8_view(vector, 0,
+ * SIZE_MAX)` is a view of the whole vector.
+ *
+ * @param vector The vector.
+ * @param start The position of the first cell of the view.
+ * @param count The largest number of cells in the view.
+ * @return The view.
+ */
+GCU_Vector8_View gcu_vector8_view(GCU_Vector8 * vector, size_t start, size_t count);
+
+/**
+ * Get a view of a buffer.
+ *
+ * @param data The first cell.
+ * @param count The number of cells.
+ * @return The view.
+ */
+GCU_Vector8_View gcu_view8_of(GCU_Type8_Union * data, size_t count);
+
+/**
+ * Get a view of part of a view.
+ *
+ * The range is clipped to the view.
+ *
+ * @param view The view.
+ * @param start The position of the first cell of the new view.
+ * @param count The largest number of cells in the new view.
+ * @return The new view.
+ */
+GCU_Vector8_View gcu_view8_slice(GCU_Vector8_View view, size_t start, size_t count);
+
+/**
+ * Get one of `parts` nearly equal, consecutive parts of a view.
+ *
+ * The sizes of the parts differ by at most one, and together they cover the
+ * whole view, so `parts` workers can each take the part of their own index.
+ *
+ * @param view The view.
+ * @param parts The number of parts.
+ * @param index The part, from `0` to `parts - 1`.
+ * @return The part, which is empty if `index >= parts`.
+ */
+GCU_Vector8_View gcu_view8_split(GCU_Vector8_View view, size_t parts, size_t index);
+
+/**
+ * Hash the contents of a view.
+ *
+ * Views with the same cells have the same hash, wherever they are in memory.
+ *
+ * @param view The view.
+ * @return The hash.
+ */
+uint64_t gcu_view8_hash(GCU_Vector8_View view);
+
+/**
+ * Append the contents of a view to a vector.
+ *
+ * The view must not be of the same vector.
+ *
+ * @param view The view.
+ * @param vector The vector which receives the cells.
+ * @return `true` on success, `false` otherwise (in which case the vector is
+ *   unchanged).
+ */
+bool gcu_view8_copy(GCU_Vector8_View view, GCU_Vector8 * vector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOTIIO_CUTIL_VIEW_H
@@ -0,0 +1,211 @@
+/**
+ * @file
+ *
+ * This file implements arenas, which allocate by bumping a cursor through
+ * chunks of memory.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <cutil/arena.h>
+#include <cutil/memory.h>
+
+//
+// A chunk of memory.  The chunks of an arena form a list in the order that
+// they are used, so that a reset arena reuses them from the start.
+//
+struct GCU_Arena_Chunk {
+  GCU_Arena_Chunk * next;       // The next chunk, or NULL.
+  size_t size;                  // The bytes available after the header.
+  max_align_t data[];           // The memory handed out.
+};
+
+// Make `chunk` the one in use, from its start.
+static inline void use_chunk(GCU_Arena * arena, GCU_Arena_Chunk * chunk) {
+  arena->chunk = chunk;
+  arena->cursor = (char *)chunk->data;
+  arena->end = arena->cursor + chunk->size;
+}
+
+// Move to a chunk with room for `size` bytes at `alignment`, reusing a kept
+// chunk if one is large enough, and otherwise adding one after the chunk in
+// use.  Kept chunks which are too small are passed over until the next reset.
+static bool next_chunk(GCU_Arena * arena, size_t size, size_t alignment) {
+  if (size > SIZE_MAX - alignment - sizeof(GCU_Arena_Chunk)) {
+    return false;
+  }
+  size_t needed = size + alignment - 1;
+  GCU_Arena_Chunk * chunk = arena->chunk
+    ? arena->chunk->next
+    : arena->first;
+  GCU_Arena_Chunk * previous = arena->chunk;
+  while (chunk && chunk->size < needed) {
+    previous = chunk;
+    chunk = chunk->next;
+  }
+  if (!chunk) {
+    size_t bytes = needed > arena->chunk_size
+      ? needed
+      : arena->chunk_size;
+    chunk = gcu_malloc(sizeof(GCU_Arena_Chunk) + bytes);
+    if (!chunk) {
+      return false;
+    }
+    chunk->next = 0;
+    chunk->size = bytes;
+    if (previous) {
+      previous->next = chunk;
+    }
+    else {
+      arena->first = chunk;
+    }
+  }
+  use_chunk(arena, chunk);
+  return true;
+}
+
+GCU_Arena * gcu_arena_create(size_t chunk_size) {
+  // Malloc Zeroed-out memory.
+  GCU_Arena * arena = gcu_calloc(1, sizeof(GCU_Arena));
+
+  // If the allocation failed, return null.
+  if (!arena) {
+    return 0;
+  }
+
+  if (!gcu_arena_create_in_place(arena, chunk_size)) {
+    gcu_free(arena);
+    return 0;
+  }
+
+  return arena;
+}
+
+bool gcu_arena_create_in_place(GCU_Arena * arena, size_t chunk_size) {
+  *arena = (GCU_Arena) {
+    .chunk_size = chunk_size
+      ? chunk_size
+      : GCU_ARENA_DEFAULT_CHUNK_SIZE,
+    .first = 0,
+    .chunk = 0,
+    .cursor = 0,
+    .end = 0,
+    .cleanup = 0,
+  };
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  // Allocate the mutex.
+  bool failure = GCU_MUTEX_CREATE(arena->mutex);
+
+  // If the allocation failed, return false.
+  if (failure) {
+    return false;
+  }
+#endif
+
+  return true;
+}
+
+void gcu_arena_destroy(GCU_Arena * arena) {
+  if (arena) {
+    gcu_arena_destroy_in_place(arena);
+    gcu_free(arena);
+  }
+}
+
+void gcu_arena_destroy_in_place(GCU_Arena * arena) {
+  // Verify that the pointer actually points to something.
+  if (arena) {
+    // Call the `cleanup` function, if it exists.
+    if (arena->cleanup) {
+      arena->cleanup(arena);
+    }
+
+    GCU_Arena_Chunk * chunk = arena->first;
+    while (chunk) {
+      GCU_Arena_Chunk * next = chunk->next;
+      gcu_free(chunk);
+      chunk = next;
+    }
+    arena->first = 0;
+    arena->chunk = 0;
+    arena->cursor = 0;
+    arena->end = 0;
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+    GCU_MUTEX_DESTROY(arena->mutex);
+#endif
+  }
+}
+
+void * gcu_arena_allocate(GCU_Arena * arena, size_t size) {
+  return gcu_arena_allocate_aligned(arena, size, GCU_ARENA_ALIGNMENT);
+}
+
+void * gcu_arena_allocate_aligned(GCU_Arena * arena, size_t size, size_t alignment) {
+  // Round the cursor up to the alignment.  Before the first chunk, both the
+  // cursor and the end are NULL, so there is no room.
+  uintptr_t start = ((uintptr_t)arena->cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+  if (!arena->cursor || start > (uintptr_t)arena->end || size > (uintptr_t)arena->end - start) {
+    if (!next_chunk(arena, size, alignment)) {
+      return 0;
+    }
+    start = ((uintptr_t)arena->cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+  }
+  arena->cursor = (char *)start + size;
+  return (void *)start;
+}
+
+void * gcu_arena_reallocate(GCU_Arena * arena, void * pointer, size_t old_size, size_t new_size) {
+  if (!pointer) {
+    return gcu_arena_allocate(arena, new_size);
+  }
+
+  // The most recent allocation can grow or shrink in place.
+  if ((char *)pointer + old_size == arena->cursor && new_size <= (size_t)(arena->end - (char *)pointer)) {
+    arena->cursor = (char *)pointer + new_size;
+    return pointer;
+  }
+  if (new_size <= old_size) {
+    return pointer;
+  }
+
+  void * moved = gcu_arena_allocate(arena, new_size);
+  if (moved) {
+    memcpy(moved, pointer, old_size);
+  }
+  return moved;
+}
+
+GCU_Arena_Mark gcu_arena_mark(GCU_Arena * arena) {
+  return (GCU_Arena_Mark) {
+    .chunk = arena->chunk,
+    .cursor = arena->cursor,
+  };
+}
+
+void gcu_arena_rewind(GCU_Arena * arena, GCU_Arena_Mark mark) {
+  if (!mark.chunk) {
+    gcu_arena_reset(arena);
+    return;
+  }
+  arena->chunk = mark.chunk;
+  arena->cursor = mark.cursor;
+  arena->end = (char *)mark.chunk->data + mark.chunk->size;
+}
+
+void gcu_arena_reset(GCU_Arena * arena) {
+  // The next allocation starts again from the first chunk.
+  arena->chunk = 0;
+  arena->cursor = 0;
+  arena->end = 0;
+}
+
+size_t gcu_arena_size(GCU_Arena * arena) {
+  size_t size = 0;
+  for (GCU_Arena_Chunk * chunk = arena->first; chunk; chunk = chunk->next) {
+    size += chunk->size;
+  }
+  return size;
+}
@@ -0,0 +1,346 @@
+/**
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cutil/bitvector.h>
+#include <cutil/memory.h>
+
+#define GROWTH_FACTOR 1.3
+
+// The bulk operations are compiled several times, for increasingly wide
+// instruction sets, and the loader picks the widest one that the CPU supports.
+// The popcount clone adds the scalar POPCNT instruction.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__ELF__) && (__GNUC__ >= 11)
+#define SIMD_DISPATCH __attribute__((target_clones("default", "avx2", "arch=x86-64-v4")))
+#define POPCOUNT_DISPATCH __attribute__((target_clones("default", "popcnt")))
+#else
+#define SIMD_DISPATCH
+#define POPCOUNT_DISPATCH
+#endif
+
+#define WORD_BITS 64
+#define WORDS(bits) (((bits) + WORD_BITS - 1) / WORD_BITS)
+
+GCU_BitVector * gcu_bitvector_create(size_t count) {
+  // Malloc Zeroed-out memory.
+  GCU_BitVector * vector = gcu_calloc(1, sizeof(GCU_BitVector));
+
+  // If the allocation failed, return null.
+  if (!vector) {
+    return 0;
+  }
+
+  if (!gcu_bitvector_create_in_place(vector, count)) {
+    gcu_free(vector);
+    return 0;
+  }
+
+  return vector;
+}
+
+bool gcu_bitvector_create_in_place(GCU_BitVector * vector, size_t count) {
+  *vector = (GCU_BitVector) {
+    .count = 0,
+    .capacity = 0,
+    .data = 0,
+    .cleanup = 0,
+  };
+
+  // Reserve room for the data, if requested..
+  if (count) {
+    vector->data = gcu_calloc(WORDS(count), sizeof(uint64_t));
+    if (vector->data) {
+      vector->capacity = WORDS(count) * WORD_BITS;
+    }
+  }
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  // Allocate the mutex.
+  bool failure = GCU_MUTEX_CREATE(vector->mutex);
+
+  // If the allocation failed, clean up and return null.
+  if (failure) {
+    if (vector->data) {
+      gcu_free(vector->data);
+    }
+    return false;
+  }
+#endif
+
+  return true;
+}
+
+void gcu_bitvector_destroy(GCU_BitVector * vector) {
+  if (vector) {
+    gcu_bitvector_destroy_in_place(vector);
+    gcu_free(vector);
+  }
+}
+
+void gcu_bitvector_destroy_in_place(GCU_BitVector * vector) {
+  // Verify that the pointer actually points to something.
+  if (vector) {
+    // Call the `cleanup` function, if it exists.
+    if (vector->cleanup) {
+      vector->cleanup(vector);
+    }
+
+    // Clean up the data table if needed.
+    if (vector->data) {
+      gcu_free(vector->data);
+      vector->data = 0;
+    }
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+    GCU_MUTEX_DESTROY(vector->mutex);
+#endif
+  }
+}
+
+bool gcu_bitvector_append(GCU_BitVector * vector, bool value) {
+  // Verify that the pointer actually points to something.
+  if (!vector) {
+    return false;
+  }
+  if ((vector->count >= vector->capacity) && !gcu_bitvector_reserve(vector, vector->count < 1024
+      ? 1024
+      : vector->count < 65536
+        ? vector->count * 2
+        : vector->count * GROWTH_FACTOR)) {
+    return false;
+  }
+  // The bit is already clear, because every bit past `count` is clear.
+  vector->data[vector->count / WORD_BITS] |= (uint64_t)value << (vector->count % WORD_BITS);
+  ++vector->count;
+  return true;
+}
+
+size_t gcu_bitvector_count(GCU_BitVector * vector) {
+  // Verify that the pointer actually points to something.
+  return vector
+    ? vector->count
+    : 0;
+}
+
+bool gcu_bitvector_reserve(GCU_BitVector * vector, size_t count) {
+  // Verify that the pointer actually points to something.
+  if (!vector) {
+    return false;
+  }
+
+  // Verify that the requested size is larger than the current capacity.
+  if (count <= vector->capacity) {
+    return true;
+  }
+
+  // Attempt to allocate more memory.  The new words must be zeroed, so that
+  // the bits past `count` stay clear.
+  size_t words = WORDS(count);
+  size_t oldWords = vector->capacity / WORD_BITS;
+  uint64_t * newMem = vector->data
+    ? gcu_realloc(vector->data, words * sizeof(uint64_t))
+    : gcu_calloc(words, sizeof(uint64_t));
+  if (!newMem) {
+    return false;
+  }
+  if (vector->data) {
+    memset(newMem + oldWords, 0, (words - oldWords) * sizeof(uint64_t));
+  }
+
+  // Swap out the details.
+  vector->data = newMem;
+  vector->capacity = words * WORD_BITS;
+  return true;
+}
+
+bool gcu_bitvector_resize(GCU_BitVector * vector, size_t count) {
+  // Verify that the pointer actually points to something.
+  if (!vector) {
+    return false;
+  }
+  if (count > vector->count) {
+    if (!gcu_bitvector_reserve(vector, count)) {
+      return false;
+    }
+  }
+  else if (count < vector->count) {
+    // Clear the bits which are removed.
+    size_t first = WORDS(count);
+    memset(vector->data + first, 0, (WORDS(vector->count) - first) * sizeof(uint64_t));
+    if (count % WORD_BITS) {
+      vector->data[count / WORD_BITS] &= ((uint64_t)1 << (count % WORD_BITS)) - 1;
+    }
+  }
+  vector->count = count;
+  return true;
+}
+
+bool gcu_bitvector_get(GCU_BitVector * vector, size_t index) {
+  // Verify that the pointer actually points to something.
+  return vector
+    && index < vector->count
+    && ((vector->data[index / WORD_BITS] >> (index % WORD_BITS)) & 1);
+}
+
+bool gcu_bitvector_set(GCU_BitVector * vector, size_t index) {
+  // Verify that the pointer actually points to something.
+  if (!vector || index >= vector->count) {
+    return false;
+  }
+  vector->data[index / WORD_BITS] |= (uint64_t)1 << (index % WORD_BITS);
+  return true;
+}
+
+bool gcu_bitvector_clear(GCU_BitVector * vector, size_t index) {
+  // Verify that the pointer actually points to something.
+  if (!vector || index >= vector->count) {
+    return false;
+  }
+  vector->data[index / WORD_BITS] &= ~((uint64_t)1 << (index % WORD_BITS));
+  return true;
+}
+
+POPCOUNT_DISPATCH
+static size_t popcount(const uint64_t * data, size_t words) {
+  size_t total = 0;
+  for (size_t i = 0; i < words; ++i) {
+    total += (size_t)__builtin_popcountll(data[i]);
+  }
+  return total;
+}
+
+size_t gcu_bitvector_popcount(GCU_BitVector * vector) {
+  // Verify that the pointer actually points to something.
+  return vector
+    ? popcount(vector->data, WORDS(vector->count))
+    : 0;
+}
+
+size_t gcu_bitvector_find_next_set(GCU_BitVector * vector, size_t index) {
+  // Verify that the pointer actually points to something.
+  if (!vector) {
+    return 0;
+  }
+  if (index >= vector->count) {
+    return vector->count;
+  }
+
+  // Ignore the bits before `index` in its word, then skip clear words.
+  size_t words = WORDS(vector->count);
+  size_t word = index / WORD_BITS;
+  uint64_t bits = vector->data[word] & (~(uint64_t)0 << (index % WORD_BITS));
+  while (!bits) {
+    if (++word == words) {
+      return vector->count;
+    }
+    bits = vector->data[word];
+  }
+  return word * WORD_BITS + (size_t)__builtin_ctzll(bits);
+}
+
+// Each operation loops over plain words, which the compiler turns into the
+// widest vector instructions of each clone.
+SIMD_DISPATCH
+static void and_words(uint64_t * restrict destination, const uint64_t * restrict source, size_t words) {
+  for (size_t i = 0; i < words; ++i) {
+    destination[i] &= source[i];
+  }
+}
+
+SIMD_DISPATCH
+static void or_words(uint64_t * restrict destination, const uint64_t * restrict source, size_t words) {
+  for (size_t i = 0; i < words; ++i) {
+    destination[i] |= source[i];
+  }
+}
+
+SIMD_DISPATCH
+static void xor_words(uint64_t * restrict destination, const uint64_t * restrict source, size_t words) {
+  for (size_t i = 0; i < words; ++i) {
+    destination[i] ^= source[i];
+  }
+}
+
+SIMD_DISPATCH
+static void andnot_words(uint64_t * restrict destination, const uint64_t * restrict source, size_t words) {
+  for (size_t i = 0; i < words; ++i) {
+    destination[i] &= ~source[i];
+  }
+}
+
+// The number of words that both vectors have.
+static size_t shared_words(GCU_BitVector * destination, GCU_BitVector * source) {
+  return destination->count < source->count
+    ? WORDS(destination->count)
+    : WORDS(source->count);
+}
+
+// Clear the bits of the last word which are past the end of the vector, in
+// case the source was longer and set some of them.
+static void clear_tail(GCU_BitVector * vector) {
+  if (vector->count % WORD_BITS) {
+    vector->data[vector->count / WORD_BITS] &= ((uint64_t)1 << (vector->count % WORD_BITS)) - 1;
+  }
+}
+
+void gcu_bitvector_and(GCU_BitVector * destination, GCU_BitVector * source) {
+  // Verify that the pointers actually point to something.
+  if (!destination || !source) {
+    return;
+  }
+  if (destination == source) {
+    return;
+  }
+  size_t words = shared_words(destination, source);
+  and_words(destination->data, source->data, words);
+
+  // Anything AND a missing (clear) bit is clear.
+  if (WORDS(destination->count) > words) {
+    memset(destination->data + words, 0, (WORDS(destination->count) - words) * sizeof(uint64_t));
+  }
+  clear_tail(destination);
+}
+
+void gcu_bitvector_or(GCU_BitVector * destination, GCU_BitVector * source) {
+  // Verify that the pointers actually point to something.
+  if (!destination || !source) {
+    return;
+  }
+  if (destination == source) {
+    return;
+  }
+  or_words(destination->data, source->data, shared_words(destination, source));
+  clear_tail(destination);
+}
+
+void gcu_bitvector_xor(GCU_BitVector * destination, GCU_BitVector * source) {
+  // Verify that the pointers actually point to something.
+  if (!destination || !source) {
+    return;
+  }
+  if (destination == source) {
+    if (destination->count) {
+      memset(destination->data, 0, WORDS(destination->count) * sizeof(uint64_t));
+    }
+    return;
+  }
+  xor_words(destination->data, source->data, shared_words(destination, source));
+  clear_tail(destination);
+}
+
+void gcu_bitvector_andnot(GCU_BitVector * destination, GCU_BitVector * source) {
+  // Verify that the pointers actually point to something.
+  if (!destination || !source) {
+    return;
+  }
+  if (destination == source) {
+    if (destination->count) {
+      memset(destination->data, 0, WORDS(destination->count) * sizeof(uint64_t));
+    }
+    return;
+  }
+  andnot_words(destination->data, source->data, shared_words(destination, source));
+  clear_tail(destination);
+}
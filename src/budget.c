@@ -0,0 +1,260 @@
+/**
+ * @file
+ *
+ * This file implements memory budgets.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <cutil/budget.h>
+#include <cutil/memory.h>
+#include <cutil/mutex.h>
+
+//
+// A function to call when the budget runs short of memory.
+//
+typedef struct {
+  GCU_Budget_Pressure callback; // The function.
+  void * context;               // Its argument.
+} Callback;
+
+struct GCU_Budget {
+  GCU_Allocator allocator;      // The allocator handed out, whose context
+                                //   is the budget.
+  const GCU_Allocator * parent; // The allocator passed to.
+  atomic_size_t limit;          // The hard limit, or 0.
+  atomic_size_t soft_limit;     // The soft limit, or 0.
+  atomic_size_t used;           // The bytes charged.
+  atomic_size_t peak;           // The peak of `used`.
+  atomic_size_t failures;       // The allocations refused.
+
+  // Guarded by `mutex`.
+  GCU_MUTEX_T mutex;
+  Callback callbacks[GCU_BUDGET_CALLBACKS];
+  size_t callback_count;
+};
+
+// Whether the calling thread is running pressure callbacks, so that the
+// callbacks are not called again by their own allocations.
+static _Thread_local bool relieving = false;
+
+// Call the pressure callbacks of a budget.
+static void relieve(GCU_Budget * budget) {
+  if (relieving) {
+    return;
+  }
+
+  // The callbacks are copied, so that they run without the mutex held.
+  Callback callbacks[GCU_BUDGET_CALLBACKS];
+  GCU_MUTEX_LOCK(budget->mutex);
+  size_t count = budget->callback_count;
+  for (size_t i = 0; i < count; ++i) {
+    callbacks[i] = budget->callbacks[i];
+  }
+  GCU_MUTEX_UNLOCK(budget->mutex);
+
+  relieving = true;
+  for (size_t i = 0; i < count; ++i) {
+    callbacks[i].callback(budget, atomic_load_explicit(&budget->used, memory_order_relaxed), callbacks[i].context);
+  }
+  relieving = false;
+}
+
+// Charge `bytes` to a budget, if it has room for them.  `used` is set to the
+// bytes in use before the charge.
+static bool try_charge(GCU_Budget * budget, size_t bytes, size_t * used) {
+  size_t limit = atomic_load_explicit(&budget->limit, memory_order_relaxed);
+  *used = atomic_load_explicit(&budget->used, memory_order_relaxed);
+  do {
+    if (limit && (*used > limit || bytes > limit - *used)) {
+      return false;
+    }
+  } while (!atomic_compare_exchange_weak_explicit(&budget->used, used, *used + bytes, memory_order_relaxed, memory_order_relaxed));
+  return true;
+}
+
+// Charge `bytes` to a budget.  The pressure callbacks are called if the hard
+// limit is reached, after which the charge is tried once more, or if the
+// charge reaches the soft limit.
+static bool charge(GCU_Budget * budget, size_t bytes) {
+  size_t used;
+  if (!try_charge(budget, bytes, &used)) {
+    relieve(budget);
+    if (!try_charge(budget, bytes, &used)) {
+      atomic_fetch_add_explicit(&budget->failures, 1, memory_order_relaxed);
+      return false;
+    }
+  }
+  size_t soft_limit = atomic_load_explicit(&budget->soft_limit, memory_order_relaxed);
+  if (soft_limit && used < soft_limit && bytes >= soft_limit - used) {
+    relieve(budget);
+  }
+  return true;
+}
+
+// Give back `bytes` charged to a budget.  A block which the budget never
+// charged (one allocated before the budget was installed with
+// gcu_set_allocator(), for instance) may be freed through it, so the count
+// stops at zero rather than wrapping.
+static void uncharge(GCU_Budget * budget, size_t bytes) {
+  size_t used = atomic_load_explicit(&budget->used, memory_order_relaxed);
+  while (!atomic_compare_exchange_weak_explicit(&budget->used, &used, used > bytes ? used - bytes : 0, memory_order_relaxed, memory_order_relaxed)) {
+  }
+}
+
+// Correct a charge from `charged` bytes to the `actual` size of the block,
+// which may pass the hard limit by what the parent rounds sizes up by.
+static void settle(GCU_Budget * budget, size_t charged, size_t actual) {
+  if (actual < charged) {
+    uncharge(budget, charged - actual);
+    return;
+  }
+  size_t after = atomic_fetch_add_explicit(&budget->used, actual - charged, memory_order_relaxed) + (actual - charged);
+  size_t peak = atomic_load_explicit(&budget->peak, memory_order_relaxed);
+  while (after > peak && !atomic_compare_exchange_weak_explicit(&budget->peak, &peak, after, memory_order_relaxed, memory_order_relaxed)) {
+  }
+}
+
+static size_t budget_usable_size(void * context, void * pointer) {
+  GCU_Budget * budget = context;
+  return pointer
+    ? budget->parent->usable_size(budget->parent->context, pointer)
+    : 0;
+}
+
+static void * budget_allocate(void * context, size_t size) {
+  GCU_Budget * budget = context;
+  if (!charge(budget, size)) {
+    return 0;
+  }
+  void * pointer = budget->parent->allocate(budget->parent->context, size);
+  settle(budget, size, budget_usable_size(budget, pointer));
+  return pointer;
+}
+
+static void * budget_allocate_zeroed(void * context, size_t nitems, size_t size) {
+  GCU_Budget * budget = context;
+  if (size && nitems > SIZE_MAX / size) {
+    return 0;
+  }
+  if (!charge(budget, nitems * size)) {
+    return 0;
+  }
+  void * pointer = budget->parent->allocate_zeroed(budget->parent->context, nitems, size);
+  settle(budget, nitems * size, budget_usable_size(budget, pointer));
+  return pointer;
+}
+
+static void * budget_reallocate(void * context, void * pointer, size_t size) {
+  GCU_Budget * budget = context;
+  if (!pointer) {
+    return budget_allocate(context, size);
+  }
+
+  // Only growth is charged in advance, so that shrinking never fails.
+  size_t before = budget_usable_size(budget, pointer);
+  size_t growth = size > before
+    ? size - before
+    : 0;
+  if (growth && !charge(budget, growth)) {
+    return 0;
+  }
+  void * result = budget->parent->reallocate(budget->parent->context, pointer, size);
+  if (!result) {
+    // A failed reallocation leaves the block as it was, unless the size was
+    // zero, in which case the block was freed.
+    uncharge(budget, size
+      ? growth
+      : before);
+    return 0;
+  }
+  settle(budget, growth + before, budget_usable_size(budget, result));
+  return result;
+}
+
+static void budget_free(void * context, void * pointer) {
+  GCU_Budget * budget = context;
+  if (pointer) {
+    uncharge(budget, budget_usable_size(budget, pointer));
+    budget->parent->free(budget->parent->context, pointer);
+  }
+}
+
+GCU_Budget * gcu_budget_create(const GCU_Allocator * parent, size_t limit, size_t soft_limit) {
+  if (!parent) {
+    parent = &gcu_system_allocator;
+  }
+
+  // The size of each block must be known, to uncharge it when it is freed.
+  if (!parent->usable_size) {
+    return 0;
+  }
+
+  GCU_Budget * budget = parent->allocate(parent->context, sizeof(GCU_Budget));
+  if (!budget) {
+    return 0;
+  }
+  if (GCU_MUTEX_CREATE(budget->mutex)) {
+    parent->free(parent->context, budget);
+    return 0;
+  }
+  budget->allocator = (GCU_Allocator) {
+    .allocate = budget_allocate,
+    .allocate_zeroed = budget_allocate_zeroed,
+    .reallocate = budget_reallocate,
+    .free = budget_free,
+    .usable_size = budget_usable_size,
+    .context = budget,
+  };
+  budget->parent = parent;
+  atomic_init(&budget->limit, limit);
+  atomic_init(&budget->soft_limit, soft_limit);
+  atomic_init(&budget->used, 0);
+  atomic_init(&budget->peak, 0);
+  atomic_init(&budget->failures, 0);
+  budget->callback_count = 0;
+  return budget;
+}
+
+void gcu_budget_destroy(GCU_Budget * budget) {
+  if (budget) {
+    GCU_MUTEX_DESTROY(budget->mutex);
+    budget->parent->free(budget->parent->context, budget);
+  }
+}
+
+const GCU_Allocator * gcu_budget_allocator(GCU_Budget * budget) {
+  return &budget->allocator;
+}
+
+void gcu_budget_set_limits(GCU_Budget * budget, size_t limit, size_t soft_limit) {
+  atomic_store_explicit(&budget->limit, limit, memory_order_relaxed);
+  atomic_store_explicit(&budget->soft_limit, soft_limit, memory_order_relaxed);
+}
+
+bool gcu_budget_add_pressure_callback(GCU_Budget * budget, GCU_Budget_Pressure callback, void * context) {
+  bool added = false;
+  GCU_MUTEX_LOCK(budget->mutex);
+  if (budget->callback_count < GCU_BUDGET_CALLBACKS) {
+    budget->callbacks[budget->callback_count++] = (Callback) {
+      .callback = callback,
+      .context = context,
+    };
+    added = true;
+  }
+  GCU_MUTEX_UNLOCK(budget->mutex);
+  return added;
+}
+
+size_t gcu_budget_used(GCU_Budget * budget) {
+  return atomic_load_explicit(&budget->used, memory_order_relaxed);
+}
+
+size_t gcu_budget_peak(GCU_Budget * budget) {
+  return atomic_load_explicit(&budget->peak, memory_order_relaxed);
+}
+
+size_t gcu_budget_failures(GCU_Budget * budget) {
+  return atomic_load_explicit(&budget->failures, memory_order_relaxed);
+}
@@ -0,0 +1,121 @@
+/**
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <cutil/deque.h>
+#include <cutil/memory.h>
+
+// The capacity given to a deque the first time that it needs to grow.
+#define MINIMUM_CAPACITY 16
+
+// Get the smallest power of two which is not less than `count`, or `0` if
+// there is no such `size_t`.
+static size_t capacity_for(size_t count) {
+  if (count > ((size_t)1 << (sizeof(size_t) * 8 - 1))) {
+    return 0;
+  }
+  size_t capacity = 1;
+  while (capacity < count) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+// Copy `count` values of `size` bytes into the circular buffer `data`,
+// starting at position `start`.  The values are split in two at the end of the
+// buffer.
+static inline void copy_in(void * data, size_t capacity, size_t start, const void * values, size_t count, size_t size) {
+  size_t first = capacity - start < count
+    ? capacity - start
+    : count;
+  memcpy((char *)data + start * size, values, first * size);
+  if (count > first) {
+    memcpy(data, (const char *)values + first * size, (count - first) * size);
+  }
+}
+
+// Copy `count` values of `size` bytes out of the circular buffer `data`,
+// starting at position `start`.
+static inline void copy_out(const void * data, size_t capacity, size_t start, void * values, size_t count, size_t size) {
+  size_t first = capacity - start < count
+    ? capacity - start
+    : count;
+  memcpy(values, (const char *)data + start * size, first * size);
+  if (count > first) {
+    memcpy((char *)values + first * size, data, (count - first) * size);
+  }
+}
+
+#define BITDEPTH 64
+#define CONTAINER GCU_Ring
+#define PREFIX gcu_ring
+#define GROWABLE 0
+#include "deque.template.c"
+#undef CONTAINER
+#undef PREFIX
+#undef GROWABLE
+
+#define CONTAINER GCU_Deque
+#define PREFIX gcu_deque
+#define GROWABLE 1
+#include "deque.template.c"
+#undef CONTAINER
+#undef PREFIX
+#undef GROWABLE
+#undef BITDEPTH
+
+#define BITDEPTH 32
+#define CONTAINER GCU_Ring
+#define PREFIX gcu_ring
+#define GROWABLE 0
+#include "deque.template.c"
+#undef CONTAINER
+#undef PREFIX
+#undef GROWABLE
+
+#define CONTAINER GCU_Deque
+#define PREFIX gcu_deque
+#define GROWABLE 1
+#include "deque.template.c"
+#undef CONTAINER
+#undef PREFIX
+#undef GROWABLE
+#undef BITDEPTH
+
+#define BITDEPTH 16
+#define CONTAINER GCU_Ring
+#define PREFIX gcu_ring
+#define GROWABLE 0
+#include "deque.template.c"
+#undef CONTAINER
+#undef PREFIX
+#undef GROWABLE
+
+#define CONTAINER GCU_Deque
+#define PREFIX gcu_deque
+#define GROWABLE 1
+#include "deque.template.c"
+#undef CONTAINER
+#undef PREFIX
+#undef GROWABLE
+#undef BITDEPTH
+
+#define BITDEPTH 8
+#define CONTAINER GCU_Ring
+#define PREFIX gcu_ring
+#define GROWABLE 0
+#include "deque.template.c"
+#undef CONTAINER
+#undef PREFIX
+#undef GROWABLE
+
+#define CONTAINER GCU_Deque
+#define PREFIX gcu_deque
+#define GROWABLE 1
+#include "deque.template.c"
+#undef CONTAINER
+#undef PREFIX
+#undef GROWABLE
+#undef BITDEPTH
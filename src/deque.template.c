@@ -0,0 +1,274 @@
+#define TEMPLATE_GCU_TYPE_UNION         GHOTIIO_CUTIL_CONCAT3(GCU_Type, BITDEPTH, _Union)
+#define TEMPLATE_GCU_CONTAINER          GHOTIIO_CUTIL_CONCAT2(CONTAINER, BITDEPTH)
+#define TEMPLATE_GCU_CONTAINER_VALUE    GHOTIIO_CUTIL_CONCAT3(CONTAINER, BITDEPTH, _Value)
+#define TEMPLATE_CREATE                 GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _create)
+#define TEMPLATE_CREATE_IN_PLACE        GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _create_in_place)
+#define TEMPLATE_DESTROY                GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _destroy)
+#define TEMPLATE_DESTROY_IN_PLACE       GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _destroy_in_place)
+#define TEMPLATE_PUSH_BACK              GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _push_back)
+#define TEMPLATE_PUSH_FRONT             GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _push_front)
+#define TEMPLATE_POP_BACK               GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _pop_back)
+#define TEMPLATE_POP_FRONT              GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _pop_front)
+#define TEMPLATE_PUSH_MANY              GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _push_many)
+#define TEMPLATE_POP_MANY               GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _pop_many)
+#define TEMPLATE_GET                    GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _get)
+#define TEMPLATE_COUNT                  GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _count)
+#define TEMPLATE_RESERVE                GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _reserve)
+#define TEMPLATE_MAKE_ROOM              GHOTIIO_CUTIL_CONCAT3(PREFIX, BITDEPTH, _make_room)
+
+TEMPLATE_GCU_CONTAINER * TEMPLATE_CREATE(size_t count) {
+  // Malloc Zeroed-out memory.
+  TEMPLATE_GCU_CONTAINER * container = gcu_calloc(1, sizeof(TEMPLATE_GCU_CONTAINER));
+
+  // If the allocation failed, return null.
+  if (!container) {
+    return 0;
+  }
+
+  if (!TEMPLATE_CREATE_IN_PLACE(container, count)) {
+    gcu_free(container);
+    return 0;
+  }
+
+  return container;
+}
+
+bool TEMPLATE_CREATE_IN_PLACE(TEMPLATE_GCU_CONTAINER * container, size_t count) {
+  *container = (TEMPLATE_GCU_CONTAINER) {
+    .capacity = 0,
+    .head = 0,
+    .count = 0,
+    .data = 0,
+    .cleanup = 0,
+  };
+
+#if GROWABLE
+  // Reserve room for the data, if requested.
+  if (count) {
+    size_t capacity = capacity_for(count);
+    if (capacity && capacity <= SIZE_MAX / sizeof(TEMPLATE_GCU_TYPE_UNION)) {
+      container->data = gcu_malloc(capacity * sizeof(TEMPLATE_GCU_TYPE_UNION));
+      if (container->data) {
+        container->capacity = capacity;
+      }
+    }
+  }
+#else
+  // A ring buffer cannot grow, so its buffer must be allocated now.
+  size_t capacity = capacity_for(count ? count : 1);
+  if (!capacity || capacity > SIZE_MAX / sizeof(TEMPLATE_GCU_TYPE_UNION)) {
+    return false;
+  }
+  container->data = gcu_malloc(capacity * sizeof(TEMPLATE_GCU_TYPE_UNION));
+  if (!container->data) {
+    return false;
+  }
+  container->capacity = capacity;
+#endif
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  // Allocate the mutex.
+  bool failure = GCU_MUTEX_CREATE(container->mutex);
+
+  // If the allocation failed, clean up and return null.
+  if (failure) {
+    if (container->data) {
+      gcu_free(container->data);
+    }
+    return false;
+  }
+#endif
+
+  return true;
+}
+
+void TEMPLATE_DESTROY(TEMPLATE_GCU_CONTAINER * container) {
+  if (container) {
+    TEMPLATE_DESTROY_IN_PLACE(container);
+    gcu_free(container);
+  }
+}
+
+void TEMPLATE_DESTROY_IN_PLACE(TEMPLATE_GCU_CONTAINER * container) {
+  // Verify that the pointer actually points to something.
+  if (container) {
+    // Call the `cleanup` function, if it exists.
+    if (container->cleanup) {
+      container->cleanup(container);
+    }
+
+    // Clean up the data table if needed.
+    if (container->data) {
+      gcu_free(container->data);
+      container->data = 0;
+    }
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+    GCU_MUTEX_DESTROY(container->mutex);
+#endif
+  }
+}
+
+#if GROWABLE
+bool TEMPLATE_RESERVE(TEMPLATE_GCU_CONTAINER * container, size_t count) {
+  // Verify that the pointer actually points to something.
+  if (!container) {
+    return false;
+  }
+
+  // Verify that the requested size is larger than the current capacity.
+  if (count <= container->capacity) {
+    return true;
+  }
+
+  size_t capacity = capacity_for(count);
+  if (!capacity || capacity > SIZE_MAX / sizeof(TEMPLATE_GCU_TYPE_UNION)) {
+    return false;
+  }
+  TEMPLATE_GCU_TYPE_UNION * data = container->data
+    ? gcu_realloc(container->data, capacity * sizeof(TEMPLATE_GCU_TYPE_UNION))
+    : gcu_malloc(capacity * sizeof(TEMPLATE_GCU_TYPE_UNION));
+  if (!data) {
+    return false;
+  }
+
+  // If the values wrapped around the end of the old buffer, then make them
+  // contiguous again by moving whichever part is shorter: the values at the
+  // start of the buffer go just past the old end, or the values before the old
+  // end go to the new end.  The new capacity is at least double the old one,
+  // so neither move overlaps.
+  size_t old = container->capacity;
+  if (container->head + container->count > old) {
+    size_t wrapped = container->head + container->count - old;
+    size_t front = old - container->head;
+    if (wrapped <= front) {
+      memcpy(data + old, data, wrapped * sizeof(TEMPLATE_GCU_TYPE_UNION));
+    }
+    else {
+      memcpy(data + capacity - front, data + container->head, front * sizeof(TEMPLATE_GCU_TYPE_UNION));
+      container->head = capacity - front;
+    }
+  }
+
+  container->data = data;
+  container->capacity = capacity;
+  return true;
+}
+#endif
+
+// Make sure that `count` more values fit in the container.
+static inline bool TEMPLATE_MAKE_ROOM(TEMPLATE_GCU_CONTAINER * container, size_t count) {
+  if (count <= container->capacity - container->count) {
+    return true;
+  }
+#if GROWABLE
+  if (count > SIZE_MAX - container->count) {
+    return false;
+  }
+  return TEMPLATE_RESERVE(container, container->count + count < MINIMUM_CAPACITY
+    ? MINIMUM_CAPACITY
+    : container->count + count);
+#else
+  return false;
+#endif
+}
+
+bool TEMPLATE_PUSH_BACK(TEMPLATE_GCU_CONTAINER * container, TEMPLATE_GCU_TYPE_UNION value) {
+  if (!TEMPLATE_MAKE_ROOM(container, 1)) {
+    return false;
+  }
+  container->data[(container->head + container->count) & (container->capacity - 1)] = value;
+  ++container->count;
+  return true;
+}
+
+bool TEMPLATE_PUSH_FRONT(TEMPLATE_GCU_CONTAINER * container, TEMPLATE_GCU_TYPE_UNION value) {
+  if (!TEMPLATE_MAKE_ROOM(container, 1)) {
+    return false;
+  }
+  container->head = (container->head - 1) & (container->capacity - 1);
+  container->data[container->head] = value;
+  ++container->count;
+  return true;
+}
+
+TEMPLATE_GCU_CONTAINER_VALUE TEMPLATE_POP_BACK(TEMPLATE_GCU_CONTAINER * container) {
+  if (!container->count) {
+    return (TEMPLATE_GCU_CONTAINER_VALUE){0};
+  }
+  --container->count;
+  return (TEMPLATE_GCU_CONTAINER_VALUE){
+    .exists = true,
+    .value = container->data[(container->head + container->count) & (container->capacity - 1)],
+  };
+}
+
+TEMPLATE_GCU_CONTAINER_VALUE TEMPLATE_POP_FRONT(TEMPLATE_GCU_CONTAINER * container) {
+  if (!container->count) {
+    return (TEMPLATE_GCU_CONTAINER_VALUE){0};
+  }
+  TEMPLATE_GCU_CONTAINER_VALUE result = {
+    .exists = true,
+    .value = container->data[container->head],
+  };
+  container->head = (container->head + 1) & (container->capacity - 1);
+  --container->count;
+  return result;
+}
+
+bool TEMPLATE_PUSH_MANY(TEMPLATE_GCU_CONTAINER * container, const TEMPLATE_GCU_TYPE_UNION * values, size_t count) {
+  if (!count) {
+    return true;
+  }
+  if (!TEMPLATE_MAKE_ROOM(container, count)) {
+    return false;
+  }
+  copy_in(container->data, container->capacity, (container->head + container->count) & (container->capacity - 1), values, count, sizeof(TEMPLATE_GCU_TYPE_UNION));
+  container->count += count;
+  return true;
+}
+
+size_t TEMPLATE_POP_MANY(TEMPLATE_GCU_CONTAINER * container, TEMPLATE_GCU_TYPE_UNION * values, size_t count) {
+  if (count > container->count) {
+    count = container->count;
+  }
+  if (!count) {
+    return 0;
+  }
+  copy_out(container->data, container->capacity, container->head, values, count, sizeof(TEMPLATE_GCU_TYPE_UNION));
+  container->head = (container->head + count) & (container->capacity - 1);
+  container->count -= count;
+  return count;
+}
+
+TEMPLATE_GCU_CONTAINER_VALUE TEMPLATE_GET(TEMPLATE_GCU_CONTAINER * container, size_t index) {
+  if (index >= container->count) {
+    return (TEMPLATE_GCU_CONTAINER_VALUE){0};
+  }
+  return (TEMPLATE_GCU_CONTAINER_VALUE){
+    .exists = true,
+    .value = container->data[(container->head + index) & (container->capacity - 1)],
+  };
+}
+
+size_t TEMPLATE_COUNT(TEMPLATE_GCU_CONTAINER * container) {
+  return container->count;
+}
+
+#undef TEMPLATE_GCU_TYPE_UNION
+#undef TEMPLATE_GCU_CONTAINER
+#undef TEMPLATE_GCU_CONTAINER_VALUE
+#undef TEMPLATE_CREATE
+#undef TEMPLATE_CREATE_IN_PLACE
+#undef TEMPLATE_DESTROY
+#undef TEMPLATE_DESTROY_IN_PLACE
+#undef TEMPLATE_PUSH_BACK
+#undef TEMPLATE_PUSH_FRONT
+#undef TEMPLATE_POP_BACK
+#undef TEMPLATE_POP_FRONT
+#undef TEMPLATE_PUSH_MANY
+#undef TEMPLATE_POP_MANY
+#undef TEMPLATE_GET
+#undef TEMPLATE_COUNT
+#undef TEMPLATE_RESERVE
+#undef TEMPLATE_MAKE_ROOM
@@ -0,0 +1,359 @@
+/**
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cutil/flatmap.h>
+#include <cutil/memory.h>
+#include <cutil/scratch.h>
+
+// Runs shorter than this are sorted by insertion before they are merged.
+#define INSERTION_RUN 32
+
+typedef struct {
+  uint64_t key;
+  GCU_Type64_Union value;
+} Entry;
+
+// Find the position of the first key which is not less than `key`.
+//
+// The search halves the range without a data-dependent branch, so that the
+// compiler emits a conditional move and the loop runs the same number of times
+// for every key.  Mispredicted branches, not cache misses, dominate the cost of
+// searching the small maps that this container is meant for.
+static size_t lower_bound(const GCU_Type64_Union * keys, size_t count, uint64_t key) {
+  if (!count) {
+    return 0;
+  }
+  const GCU_Type64_Union * base = keys;
+  size_t n = count;
+  while (n > 1) {
+    size_t half = n / 2;
+    base = base[half].ui64 < key ? base + half : base;
+    n -= half;
+  }
+  return (size_t)(base - keys) + (base->ui64 < key);
+}
+
+// Stable merge sort of `entries` by key, using `buffer` as scratch space.
+// Returns whichever of the two arrays holds the result.
+static Entry * sort_entries(Entry * entries, Entry * buffer, size_t count) {
+  for (size_t start = 0; start < count; start += INSERTION_RUN) {
+    size_t end = start + INSERTION_RUN < count ? start + INSERTION_RUN : count;
+    for (size_t i = start + 1; i < end; ++i) {
+      Entry entry = entries[i];
+      size_t j = i;
+      while (j > start && entries[j - 1].key > entry.key) {
+        entries[j] = entries[j - 1];
+        --j;
+      }
+      entries[j] = entry;
+    }
+  }
+
+  Entry * from = entries;
+  Entry * to = buffer;
+  for (size_t width = INSERTION_RUN; width < count; width *= 2) {
+    for (size_t start = 0; start < count; start += 2 * width) {
+      size_t middle = start + width < count ? start + width : count;
+      size_t end = middle + width < count ? middle + width : count;
+      size_t i = start;
+      size_t j = middle;
+      size_t k = start;
+      while (i < middle && j < end) {
+        to[k++] = from[j].key < from[i].key ? from[j++] : from[i++];
+      }
+      while (i < middle) {
+        to[k++] = from[i++];
+      }
+      while (j < end) {
+        to[k++] = from[j++];
+      }
+    }
+    Entry * swap = from;
+    from = to;
+    to = swap;
+  }
+  return from;
+}
+
+GCU_FlatMap64 * gcu_flatmap64_create(size_t count) {
+  // Malloc Zeroed-out memory.
+  GCU_FlatMap64 * map = gcu_calloc(1, sizeof(GCU_FlatMap64));
+
+  // If the allocation failed, return null.
+  if (!map) {
+    return 0;
+  }
+
+  if (!gcu_flatmap64_create_in_place(map, count)) {
+    gcu_free(map);
+    return 0;
+  }
+
+  return map;
+}
+
+bool gcu_flatmap64_create_in_place(GCU_FlatMap64 * map, size_t count) {
+  *map = (GCU_FlatMap64) {
+    .supplementary_data = 0,
+    .cleanup = 0,
+  };
+
+  if (!gcu_vector64_create_in_place(&map->keys, count)) {
+    return false;
+  }
+  if (!gcu_vector64_create_in_place(&map->values, count)) {
+    gcu_vector64_destroy_in_place(&map->keys);
+    return false;
+  }
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  // Allocate the mutex.
+  bool failure = GCU_MUTEX_CREATE(map->mutex);
+
+  // If the allocation failed, clean up and return null.
+  if (failure) {
+    gcu_vector64_destroy_in_place(&map->values);
+    gcu_vector64_destroy_in_place(&map->keys);
+    return false;
+  }
+#endif
+
+  return true;
+}
+
+void gcu_flatmap64_destroy(GCU_FlatMap64 * map) {
+  // Verify that the pointer actually points to something.
+  if (map) {
+    gcu_flatmap64_destroy_in_place(map);
+    gcu_free(map);
+  }
+}
+
+void gcu_flatmap64_destroy_in_place(GCU_FlatMap64 * map) {
+  // Verify that the pointer actually points to something.
+  if (map) {
+    // Call the `cleanup` function, if it exists.
+    if (map->cleanup) {
+      map->cleanup(map);
+    }
+
+    gcu_vector64_destroy_in_place(&map->values);
+    gcu_vector64_destroy_in_place(&map->keys);
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+    GCU_MUTEX_DESTROY(map->mutex);
+#endif
+  }
+}
+
+bool gcu_flatmap64_set(GCU_FlatMap64 * map, uint64_t key, GCU_Type64_Union value) {
+  // Verify that the pointer actually points to something.
+  if (!map) {
+    return false;
+  }
+
+  size_t count = map->keys.count;
+  size_t position = lower_bound(map->keys.data, count, key);
+
+  // Replace the value of an existing key.
+  if (position < count && map->keys.data[position].ui64 == key) {
+    map->values.data[position] = value;
+    return true;
+  }
+
+  // Grow both vectors by one, using their usual growth policy, then open a
+  // gap at the insertion point.
+  if (!gcu_vector64_append(&map->keys, (GCU_Type64_Union){.ui64 = key})) {
+    return false;
+  }
+  if (!gcu_vector64_append(&map->values, value)) {
+    --map->keys.count;
+    return false;
+  }
+  if (position < count) {
+    memmove(&map->keys.data[position + 1], &map->keys.data[position], (count - position) * sizeof(GCU_Type64_Union));
+    memmove(&map->values.data[position + 1], &map->values.data[position], (count - position) * sizeof(GCU_Type64_Union));
+    map->keys.data[position].ui64 = key;
+    map->values.data[position] = value;
+  }
+  return true;
+}
+
+bool gcu_flatmap64_set_many(GCU_FlatMap64 * map, const uint64_t * keys, const GCU_Type64_Union * values, size_t count) {
+  // Verify that the pointer actually points to something.
+  if (!map) {
+    return false;
+  }
+  if (!count) {
+    return true;
+  }
+
+  size_t existing = map->keys.count;
+  if (!gcu_vector64_reserve(&map->keys, existing + count) || !gcu_vector64_reserve(&map->values, existing + count)) {
+    return false;
+  }
+
+  GCU_Scratch_Mark mark = gcu_scratch_mark();
+  Entry * entries = gcu_scratch_allocate(2 * count * sizeof(Entry));
+  if (!entries) {
+    return false;
+  }
+
+  // Gather the new entries, and sort them unless they are already in order,
+  // which is common when a map is loaded from sorted data.
+  bool sorted = true;
+  for (size_t i = 0; i < count; ++i) {
+    entries[i] = (Entry){.key = keys[i], .value = values[i]};
+    sorted &= !i || keys[i - 1] <= keys[i];
+  }
+  Entry * batch = sorted
+    ? entries
+    : sort_entries(entries, entries + count, count);
+
+  // Drop repeated keys.  The sort is stable, so the last of a run of equal
+  // keys is the last one that the caller gave.
+  size_t unique = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (i + 1 == count || batch[i].key != batch[i + 1].key) {
+      batch[unique++] = batch[i];
+    }
+  }
+
+  // Merge from the back, so that every existing entry moves at most once and
+  // never overwrites one which has not moved yet.  A new entry which replaces
+  // an existing one leaves a hole, and the holes are closed at the end.
+  GCU_Type64_Union * mapKeys = map->keys.data;
+  GCU_Type64_Union * mapValues = map->values.data;
+  size_t i = existing;
+  size_t j = unique;
+  size_t k = existing + unique;
+  while (j) {
+    if (i && mapKeys[i - 1].ui64 > batch[j - 1].key) {
+      --i;
+      --k;
+      mapKeys[k] = mapKeys[i];
+      mapValues[k] = mapValues[i];
+    }
+    else {
+      if (i && mapKeys[i - 1].ui64 == batch[j - 1].key) {
+        --i;
+      }
+      --j;
+      --k;
+      mapKeys[k].ui64 = batch[j].key;
+      mapValues[k] = batch[j].value;
+    }
+  }
+  if (k > i) {
+    memmove(&mapKeys[i], &mapKeys[k], (existing + unique - k) * sizeof(GCU_Type64_Union));
+    memmove(&mapValues[i], &mapValues[k], (existing + unique - k) * sizeof(GCU_Type64_Union));
+  }
+  map->keys.count = map->values.count = existing + unique - (k - i);
+
+  gcu_scratch_rewind(mark);
+  return true;
+}
+
+GCU_FlatMap64_Value gcu_flatmap64_get(GCU_FlatMap64 * map, uint64_t key) {
+  // Verify that the pointer actually points to something.
+  if (!map) {
+    return (GCU_FlatMap64_Value){.exists = false, .value = {.ui64 = 0}};
+  }
+  size_t position = lower_bound(map->keys.data, map->keys.count, key);
+  return position < map->keys.count && map->keys.data[position].ui64 == key
+    ? (GCU_FlatMap64_Value){.exists = true, .value = map->values.data[position]}
+    : (GCU_FlatMap64_Value){.exists = false, .value = {.ui64 = 0}};
+}
+
+bool gcu_flatmap64_contains(GCU_FlatMap64 * map, uint64_t key) {
+  // Verify that the pointer actually points to something.
+  if (!map) {
+    return false;
+  }
+  size_t position = lower_bound(map->keys.data, map->keys.count, key);
+  return position < map->keys.count && map->keys.data[position].ui64 == key;
+}
+
+bool gcu_flatmap64_remove(GCU_FlatMap64 * map, uint64_t key) {
+  // Verify that the pointer actually points to something.
+  if (!map) {
+    return false;
+  }
+  size_t count = map->keys.count;
+  size_t position = lower_bound(map->keys.data, count, key);
+  if (position >= count || map->keys.data[position].ui64 != key) {
+    return false;
+  }
+
+  memmove(&map->keys.data[position], &map->keys.data[position + 1], (count - position - 1) * sizeof(GCU_Type64_Union));
+  memmove(&map->values.data[position], &map->values.data[position + 1], (count - position - 1) * sizeof(GCU_Type64_Union));
+  --map->keys.count;
+  --map->values.count;
+  return true;
+}
+
+size_t gcu_flatmap64_count(GCU_FlatMap64 * map) {
+  // Verify that the pointer actually points to something.
+  return map
+    ? map->keys.count
+    : 0;
+}
+
+size_t gcu_flatmap64_lower_bound(GCU_FlatMap64 * map, uint64_t key) {
+  // Verify that the pointer actually points to something.
+  return map
+    ? lower_bound(map->keys.data, map->keys.count, key)
+    : 0;
+}
+
+// Fill in an iterator which points to `current`, if it is before `end`.
+static GCU_FlatMap64_Iterator iterator_at(GCU_FlatMap64 * map, size_t current, size_t end) {
+  return current < end
+    ? (GCU_FlatMap64_Iterator){
+      .current = current,
+      .end = end,
+      .exists = true,
+      .key = map->keys.data[current].ui64,
+      .value = map->values.data[current],
+      .map = map,
+    }
+    : (GCU_FlatMap64_Iterator){
+      .current = end,
+      .end = end,
+      .exists = false,
+      .key = 0,
+      .value = {.ui64 = 0},
+      .map = map,
+    };
+}
+
+GCU_FlatMap64_Iterator gcu_flatmap64_iterator_get(GCU_FlatMap64 * map) {
+  // Verify that the pointer actually points to something.
+  return iterator_at(map, 0, map
+    ? map->keys.count
+    : 0);
+}
+
+GCU_FlatMap64_Iterator gcu_flatmap64_iterator_range(GCU_FlatMap64 * map, uint64_t low, uint64_t high) {
+  // Verify that the pointer actually points to something, and that the range
+  // is not empty.
+  if (!map || low > high) {
+    return iterator_at(map, 0, 0);
+  }
+  size_t start = lower_bound(map->keys.data, map->keys.count, low);
+
+  // The end of the range is the first key greater than `high`.
+  size_t end = high == UINT64_MAX
+    ? map->keys.count
+    : lower_bound(map->keys.data, map->keys.count, high + 1);
+  return iterator_at(map, start, end);
+}
+
+GCU_FlatMap64_Iterator gcu_flatmap64_iterator_next(GCU_FlatMap64_Iterator iterator) {
+  return iterator.exists
+    ? iterator_at(iterator.map, iterator.current + 1, iterator.end)
+    : iterator;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file
+ *
+ * This file implements growth policies and huge-page backed storage.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <cutil/growth.h>
+#include <cutil/memory.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#define HUGE_PAGES 1
+#else
+#define HUGE_PAGES 0
+#endif
+
+#if HUGE_PAGES
+
+// Round a size up to a whole number of huge pages.
+static inline size_t huge_size(size_t size) {
+  return (size + GCU_GROWTH_HUGE_PAGE_SIZE - 1) & ~(GCU_GROWTH_HUGE_PAGE_SIZE - 1);
+}
+
+// Map `size` bytes of zeroed memory, preferring huge pages.
+static void * huge_map(size_t size) {
+  void * pointer = mmap(0, huge_size(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (pointer == MAP_FAILED) {
+    return 0;
+  }
+
+  // The advice is only a hint, so a kernel without transparent huge pages
+  // still provides the memory.
+  madvise(pointer, huge_size(size), MADV_HUGEPAGE);
+  gcu_memory_count_allocation(huge_size(size));
+  return pointer;
+}
+
+#endif // HUGE_PAGES
+
+size_t gcu_growth_next(const GCU_Growth * growth, size_t capacity) {
+  double grown = (double)capacity * growth->factor;
+  size_t step = grown >= (double)SIZE_MAX
+    ? SIZE_MAX
+    : grown > (double)capacity
+      ? (size_t)grown - capacity
+      : 0;
+  if (step < growth->minimum) {
+    step = growth->minimum;
+  }
+  if (growth->maximum && step > growth->maximum) {
+    step = growth->maximum;
+  }
+  if (!step) {
+    step = 1;
+  }
+  return capacity > SIZE_MAX - step
+    ? SIZE_MAX
+    : capacity + step;
+}
+
+bool gcu_growth_is_huge(const GCU_Growth * growth, size_t size) {
+#if HUGE_PAGES
+  return !growth->arena && growth->huge_threshold && size >= growth->huge_threshold;
+#else
+  (void)growth;
+  (void)size;
+  return false;
+#endif
+}
+
+void * gcu_growth_allocate(const GCU_Growth * growth, size_t size, bool zero) {
+  if (growth->arena) {
+    void * pointer = growth->alignment > GCU_ARENA_ALIGNMENT
+      ? gcu_arena_allocate_aligned(growth->arena, size, growth->alignment)
+      : gcu_arena_allocate(growth->arena, size);
+    if (pointer && zero) {
+      memset(pointer, 0, size);
+    }
+    return pointer;
+  }
+#if HUGE_PAGES
+  if (gcu_growth_is_huge(growth, size)) {
+    return huge_map(size);
+  }
+#endif
+  if (growth->alignment) {
+    void * pointer = gcu_aligned_alloc(growth->alignment, size);
+    if (pointer && zero) {
+      memset(pointer, 0, size);
+    }
+    return pointer;
+  }
+  if (growth->allocator) {
+    return zero
+      ? gcu_allocator_allocate_zeroed(growth->allocator, 1, size)
+      : gcu_allocator_allocate(growth->allocator, size);
+  }
+  return zero
+    ? gcu_calloc(1, size)
+    : gcu_malloc(size);
+}
+
+void * gcu_growth_reallocate(const GCU_Growth * growth, void * pointer, size_t old_size, size_t new_size) {
+  if (!pointer) {
+    return gcu_growth_allocate(growth, new_size, false);
+  }
+  if (growth->arena) {
+    if (growth->alignment <= GCU_ARENA_ALIGNMENT || new_size <= old_size) {
+      return gcu_arena_reallocate(growth->arena, pointer, old_size, new_size);
+    }
+
+    // Growing in place is not attempted, since the arena would not keep the
+    // alignment if it had to move the storage.
+    void * moved = gcu_arena_allocate_aligned(growth->arena, new_size, growth->alignment);
+    if (moved) {
+      memcpy(moved, pointer, old_size);
+    }
+    return moved;
+  }
+#if HUGE_PAGES
+  bool was_huge = gcu_growth_is_huge(growth, old_size);
+  bool is_huge = gcu_growth_is_huge(growth, new_size);
+  if (was_huge && is_huge) {
+    // Move the pages instead of copying their contents.
+    if (huge_size(old_size) == huge_size(new_size)) {
+      return pointer;
+    }
+    void * moved = mremap(pointer, huge_size(old_size), huge_size(new_size), MREMAP_MAYMOVE);
+    if (moved == MAP_FAILED) {
+      return 0;
+    }
+    madvise(moved, huge_size(new_size), MADV_HUGEPAGE);
+    gcu_memory_count_reallocation(huge_size(old_size), huge_size(new_size));
+    return moved;
+  }
+  if (was_huge != is_huge) {
+    // Crossing the threshold (in either direction) means a copy.
+    void * copy = gcu_growth_allocate(growth, new_size, false);
+    if (!copy) {
+      return 0;
+    }
+    memcpy(copy, pointer, old_size < new_size
+      ? old_size
+      : new_size);
+    gcu_growth_free(growth, pointer, old_size);
+    return copy;
+  }
+#else
+  (void)old_size;
+#endif
+  return growth->alignment
+    ? gcu_aligned_realloc(pointer, growth->alignment, new_size)
+    : growth->allocator
+      ? gcu_allocator_reallocate(growth->allocator, pointer, new_size)
+      : gcu_realloc(pointer, new_size);
+}
+
+void gcu_growth_free(const GCU_Growth * growth, void * pointer, size_t size) {
+  // Arena storage is given back when the arena is reset.
+  if (!pointer || growth->arena) {
+    return;
+  }
+#if HUGE_PAGES
+  if (gcu_growth_is_huge(growth, size)) {
+    munmap(pointer, huge_size(size));
+    gcu_memory_count_free(huge_size(size));
+    return;
+  }
+#else
+  (void)size;
+#endif
+  if (growth->alignment) {
+    gcu_aligned_free(pointer);
+  }
+  else if (growth->allocator) {
+    gcu_allocator_free(growth->allocator, pointer);
+  }
+  else {
+    gcu_free(pointer);
+  }
+}
+
+bool gcu_growth_compatible(const GCU_Growth * from, const GCU_Growth * to, size_t size) {
+  bool huge = gcu_growth_is_huge(from, size);
+  if (huge != gcu_growth_is_huge(to, size)) {
+    return false;
+  }
+  return huge || (from->alignment == to->alignment && (from->alignment || from->allocator == to->allocator));
+}
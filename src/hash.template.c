@@ -6,6 +6,8 @@
 #define TEMPLATE_GCU_TYPE_UNION    GHOTIIO_CUTIL_CONCAT3(GCU_Type, BITDEPTH, _Union)
 #define TEMPLATE_GCU_HASH_CREATE   GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _create)
 #define TEMPLATE_GCU_HASH_CREATE_IN_PLACE GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _create_in_place)
+#define TEMPLATE_GCU_HASH_CREATE_IN_ARENA GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _create_in_arena)
+#define TEMPLATE_GCU_HASH_CREATE_EMBEDDED GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _create_embedded)
 #define TEMPLATE_GCU_HASH_DESTROY  GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _destroy)
 #define TEMPLATE_GCU_HASH_DESTROY_IN_PLACE GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _destroy_in_place)
 #define TEMPLATE_GCU_HASH_CLONE    GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _clone)
@@ -14,6 +16,8 @@
 #define TEMPLATE_GCU_HASH_CONTAINS GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _contains)
 #define TEMPLATE_GCU_HASH_REMOVE   GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _remove)
 #define TEMPLATE_GCU_HASH_COUNT    GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _count)
+#define TEMPLATE_GCU_HASH_BYTES    GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _bytes)
+#define TEMPLATE_GCU_HASH_SET_GROWTH GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _set_growth)
 #define TEMPLATE_GCU_HASH_ITERATOR_GET  GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _iterator_get)
 #define TEMPLATE_GCU_HASH_ITERATOR_NEXT GHOTIIO_CUTIL_CONCAT3(gcu_hash, BITDEPTH, _iterator_next)
 
@@ -40,6 +44,8 @@ bool TEMPLATE_GCU_HASH_CREATE_IN_PLACE(TEMPLATE_GCU_HASH * hashTable, size_t cou
     .removed = 0,
     .capacity = 0,
     .data = 0,
+    .embedded = false,
+    .growth = {0},
     .cleanup = 0,
   };
 
@@ -53,6 +59,7 @@ bool TEMPLATE_GCU_HASH_CREATE_IN_PLACE(TEMPLATE_GCU_HASH * hashTable, size_t cou
     }
   }
 
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
   // Allocate the mutex.
   bool failure = GCU_MUTEX_CREATE(hashTable->mutex);
 
@@ -63,15 +70,73 @@ bool TEMPLATE_GCU_HASH_CREATE_IN_PLACE(TEMPLATE_GCU_HASH * hashTable, size_t cou
     }
     return false;
   }
+#endif
 
   return true;
 }
 
+TEMPLATE_GCU_HASH * TEMPLATE_GCU_HASH_CREATE_IN_ARENA(GCU_Arena * arena, size_t count) {
+  TEMPLATE_GCU_HASH * hashTable = gcu_arena_allocate(arena, sizeof(TEMPLATE_GCU_HASH));
+
+  // If the allocation failed, return null.
+  if (!hashTable || !TEMPLATE_GCU_HASH_CREATE_IN_PLACE(hashTable, 0)) {
+    return 0;
+  }
+  hashTable->growth.arena = arena;
+
+  // Reserve room for the data, if requested..
+  if (count) {
+    // We always want the capacity to be an odd number.
+    size_t capacity = (count * 2) + 1;
+    hashTable->data = gcu_growth_allocate(&hashTable->growth, capacity * sizeof(TEMPLATE_GCU_HASH_CELL), true);
+    if (hashTable->data) {
+      hashTable->capacity = capacity;
+    }
+  }
+
+  return hashTable;
+}
+
+TEMPLATE_GCU_HASH * TEMPLATE_GCU_HASH_CREATE_EMBEDDED(size_t count) {
+  // We always want the capacity to be an odd number.
+  if (count > (SIZE_MAX - sizeof(TEMPLATE_GCU_HASH)) / sizeof(TEMPLATE_GCU_HASH_CELL) / 2 - 1) {
+    return 0;
+  }
+  size_t capacity = count
+    ? (count * 2) + 1
+    : 0;
+
+  // The data follows the structure in the same zeroed-out block.
+  TEMPLATE_GCU_HASH * hashTable = gcu_calloc(1, sizeof(TEMPLATE_GCU_HASH) + capacity * sizeof(TEMPLATE_GCU_HASH_CELL));
+
+  // If the allocation failed, return null.
+  if (!hashTable) {
+    return 0;
+  }
+
+  if (!TEMPLATE_GCU_HASH_CREATE_IN_PLACE(hashTable, 0)) {
+    gcu_free(hashTable);
+    return 0;
+  }
+
+  if (capacity) {
+    hashTable->data = (TEMPLATE_GCU_HASH_CELL *)(hashTable + 1);
+    hashTable->capacity = capacity;
+    hashTable->embedded = true;
+  }
+
+  return hashTable;
+}
+
 void TEMPLATE_GCU_HASH_DESTROY(TEMPLATE_GCU_HASH * hashTable) {
   // Verify that the pointer actually points to something.
   if (hashTable) {
+    // A hash table in an arena is given back when the arena is reset.
+    bool inArena = hashTable->growth.arena;
     TEMPLATE_GCU_HASH_DESTROY_IN_PLACE(hashTable);
-    gcu_free(hashTable);
+    if (!inArena) {
+      gcu_free(hashTable);
+    }
   }
 }
 
@@ -83,13 +148,19 @@ void TEMPLATE_GCU_HASH_DESTROY_IN_PLACE(TEMPLATE_GCU_HASH * hashTable) {
       hashTable->cleanup(hashTable);
     }
 
-    // Clean up the data table if needed.
+    // Clean up the data table if needed.  Embedded data is freed with the
+    // hash table itself.
     if (hashTable->data) {
-      gcu_free(hashTable->data);
+      if (!hashTable->embedded) {
+        gcu_growth_free(&hashTable->growth, hashTable->data, hashTable->capacity * sizeof(TEMPLATE_GCU_HASH_CELL));
+      }
       hashTable->data = 0;
+      hashTable->embedded = false;
     }
 
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
     GCU_MUTEX_DESTROY(hashTable->mutex);
+#endif
   }
 }
 
@@ -100,29 +171,39 @@ TEMPLATE_GCU_HASH * TEMPLATE_GCU_HASH_CLONE(TEMPLATE_GCU_HASH * source) {
   }
 
   // Create a new hash table and copy all of the source information.
-  TEMPLATE_GCU_HASH * newTable = gcu_malloc(sizeof(TEMPLATE_GCU_HASH));
+  // A clone of a hash table in an arena is put in the same arena.
+  TEMPLATE_GCU_HASH * newTable = source->growth.arena
+    ? gcu_arena_allocate(source->growth.arena, sizeof(TEMPLATE_GCU_HASH))
+    : gcu_malloc(sizeof(TEMPLATE_GCU_HASH));
   if (!newTable) {
     return 0;
   }
   memcpy(newTable, source, sizeof(TEMPLATE_GCU_HASH));
+  newTable->embedded = false;
 
   // Copy the data from the source.
-  newTable->data = gcu_malloc(source->capacity * sizeof(TEMPLATE_GCU_HASH_CELL));
+  newTable->data = gcu_growth_allocate(&source->growth, source->capacity * sizeof(TEMPLATE_GCU_HASH_CELL), false);
   if (!newTable->data) {
-    gcu_free(newTable);
+    if (!source->growth.arena) {
+      gcu_free(newTable);
+    }
     return 0;
   }
   memcpy(newTable->data, source->data, source->capacity * sizeof(TEMPLATE_GCU_HASH_CELL));
 
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
   // Allocate the mutex.
   bool failure = GCU_MUTEX_CREATE(newTable->mutex);
 
   // If the allocation failed, clean up and return null.
   if (failure) {
-    gcu_free(newTable->data);
-    gcu_free(newTable);
+    gcu_growth_free(&newTable->growth, newTable->data, newTable->capacity * sizeof(TEMPLATE_GCU_HASH_CELL));
+    if (!source->growth.arena) {
+      gcu_free(newTable);
+    }
     return 0;
   }
+#endif
 
   return newTable;
 }
@@ -133,14 +214,26 @@ static bool TEMPLATE_GROW_HASH(TEMPLATE_GCU_HASH * hashTable, size_t size) {
     return false;
   }
 
-  if (size < hashTable->capacity) {
+  // We always want the capacity to be an odd number.
+  size_t capacity = (size * 2) + 1;
+  if (capacity <= hashTable->capacity) {
     return false;
   }
 
-  TEMPLATE_GCU_HASH * newTable = TEMPLATE_GCU_HASH_CREATE(size);
-  if (!newTable) {
+  // The new storage is allocated under the table's own growth policy.  The
+  // temporary table lives on the stack, since it may share an arena.
+  TEMPLATE_GCU_HASH temporary;
+  TEMPLATE_GCU_HASH * newTable = &temporary;
+  if (!TEMPLATE_GCU_HASH_CREATE_IN_PLACE(newTable, 0)) {
+    return false;
+  }
+  newTable->growth = hashTable->growth;
+  newTable->data = gcu_growth_allocate(&newTable->growth, capacity * sizeof(TEMPLATE_GCU_HASH_CELL), true);
+  if (!newTable->data) {
+    TEMPLATE_GCU_HASH_DESTROY_IN_PLACE(newTable);
     return false;
   }
+  newTable->capacity = capacity;
 
   TEMPLATE_GCU_HASH_CELL * cursor = hashTable->data;
   TEMPLATE_GCU_HASH_CELL * end = &hashTable->data[hashTable->capacity];
@@ -153,12 +246,21 @@ static bool TEMPLATE_GROW_HASH(TEMPLATE_GCU_HASH * hashTable, size_t size) {
     ++cursor;
   }
 
-  // Swap the data.
-  TEMPLATE_GCU_HASH temp = *newTable;
-  *newTable = *hashTable;
-  *hashTable = temp;
-
-  TEMPLATE_GCU_HASH_DESTROY(newTable);
+  // Swap the storage only.  The `supplementary_data`, `cleanup`, and `mutex`
+  // stay with the original table, so that the temporary table can be
+  // destroyed without invoking the user's cleanup function.
+  TEMPLATE_GCU_HASH_CELL * oldData = hashTable->data;
+  size_t oldCapacity = hashTable->capacity;
+  hashTable->data = newTable->data;
+  hashTable->capacity = newTable->capacity;
+  hashTable->entries = newTable->entries;
+  hashTable->removed = newTable->removed;
+  newTable->data = oldData;
+  newTable->capacity = oldCapacity;
+  newTable->embedded = hashTable->embedded;
+  hashTable->embedded = false;
+
+  TEMPLATE_GCU_HASH_DESTROY_IN_PLACE(newTable);
 
   return true;
 }
@@ -171,11 +273,17 @@ bool TEMPLATE_GCU_HASH_SET(TEMPLATE_GCU_HASH * hashTable, size_t hash, TEMPLATE_
 
   // Grow the hash table if needed.
   if (hashTable->capacity < ((hashTable->entries + 1) * 2)) {
-    if (!TEMPLATE_GROW_HASH(hashTable, hashTable->capacity < 64
-          ? 32
-          : hashTable->capacity < 1024
-            ? (hashTable->capacity * 2)
-            : (hashTable->capacity * GROWTH_FACTOR))) {
+    size_t needed = (hashTable->entries + 1) * 2;
+    size_t next = hashTable->growth.factor
+      ? gcu_growth_next(&hashTable->growth, hashTable->capacity)
+      : 0;
+    if (!TEMPLATE_GROW_HASH(hashTable, hashTable->growth.factor
+          ? (next > needed ? next : needed) / 2
+          : hashTable->capacity < 64
+            ? 32
+            : hashTable->capacity < 1024
+              ? (hashTable->capacity * 2)
+              : (hashTable->capacity * GROWTH_FACTOR))) {
       // The hash table could not grow for some reason.
       return false;
     }
@@ -308,6 +416,12 @@ size_t TEMPLATE_GCU_HASH_COUNT(TEMPLATE_GCU_HASH * hashTable) {
   return 0;
 }
 
+size_t TEMPLATE_GCU_HASH_BYTES(TEMPLATE_GCU_HASH * hashTable) {
+  return hashTable
+    ? hashTable->capacity * sizeof(TEMPLATE_GCU_HASH_CELL)
+    : 0;
+}
+
 TEMPLATE_GCU_HASH_ITERATOR TEMPLATE_GCU_HASH_ITERATOR_GET(TEMPLATE_GCU_HASH * hashTable) {
   // Verify that the pointer actually points to something and that there is an
   // entry in the hash table.
@@ -369,6 +483,33 @@ TEMPLATE_GCU_HASH_ITERATOR TEMPLATE_GCU_HASH_ITERATOR_NEXT(TEMPLATE_GCU_HASH_ITE
   };
 }
 
+bool TEMPLATE_GCU_HASH_SET_GROWTH(TEMPLATE_GCU_HASH * hashTable, GCU_Growth growth) {
+  // Verify that the pointer actually points to something.
+  if (!hashTable || growth.arena != hashTable->growth.arena) {
+    return false;
+  }
+
+  // Storage which both policies allocate in the same way stays where it is.
+  // Embedded data stays unless the new policy asks for an alignment.
+  size_t size = hashTable->capacity * sizeof(TEMPLATE_GCU_HASH_CELL);
+  if (hashTable->data && (hashTable->embedded
+      ? growth.alignment != 0
+      : !gcu_growth_compatible(&hashTable->growth, &growth, size))) {
+    void * data = gcu_growth_allocate(&growth, size, false);
+    if (!data) {
+      return false;
+    }
+    memcpy(data, hashTable->data, size);
+    if (!hashTable->embedded) {
+      gcu_growth_free(&hashTable->growth, hashTable->data, size);
+    }
+    hashTable->data = data;
+    hashTable->embedded = false;
+  }
+  hashTable->growth = growth;
+  return true;
+}
+
 #undef TEMPLATE_GROW_HASH
 #undef TEMPLATE_GCU_HASH
 #undef TEMPLATE_GCU_HASH_ITERATOR
@@ -377,6 +518,8 @@ TEMPLATE_GCU_HASH_ITERATOR TEMPLATE_GCU_HASH_ITERATOR_NEXT(TEMPLATE_GCU_HASH_ITE
 #undef TEMPLATE_GCU_TYPE_UNION
 #undef TEMPLATE_GCU_HASH_CREATE
 #undef TEMPLATE_GCU_HASH_CREATE_IN_PLACE
+#undef TEMPLATE_GCU_HASH_CREATE_IN_ARENA
+#undef TEMPLATE_GCU_HASH_CREATE_EMBEDDED
 #undef TEMPLATE_GCU_HASH_DESTROY
 #undef TEMPLATE_GCU_HASH_DESTROY_IN_PLACE
 #undef TEMPLATE_GCU_HASH_CLONE
@@ -385,6 +528,8 @@ TEMPLATE_GCU_HASH_ITERATOR TEMPLATE_GCU_HASH_ITERATOR_NEXT(TEMPLATE_GCU_HASH_ITE
 #undef TEMPLATE_GCU_HASH_CONTAINS
 #undef TEMPLATE_GCU_HASH_REMOVE
 #undef TEMPLATE_GCU_HASH_COUNT
+#undef TEMPLATE_GCU_HASH_BYTES
+#undef TEMPLATE_GCU_HASH_SET_GROWTH
 #undef TEMPLATE_GCU_HASH_ITERATOR_GET
 #undef TEMPLATE_GCU_HASH_ITERATOR_NEXT
 
@@ -0,0 +1,387 @@
+/**
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <cutil/heap.h>
+#include <cutil/memory.h>
+
+// The arity used when the programmer does not ask for one.
+#define DEFAULT_ARITY 4
+
+// The smallest number of ids for which room is made in the position map.
+#define MINIMUM_POSITIONS 32
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address)
+#endif
+
+// Move the value (and its id) at `from` to `to`.
+static inline void move_value(GCU_Heap64 * heap, size_t from, size_t to) {
+  heap->values.data[to] = heap->values.data[from];
+  if (heap->indexed) {
+    uint64_t id = heap->ids.data[from].ui64;
+    heap->ids.data[to].ui64 = id;
+    heap->positions.data[id].ui64 = to + 1;
+  }
+}
+
+// Store a value (and its id) at `pos`.
+static inline void place_value(GCU_Heap64 * heap, size_t pos, GCU_Type64_Union value, uint64_t id) {
+  heap->values.data[pos] = value;
+  if (heap->indexed) {
+    heap->ids.data[pos].ui64 = id;
+    heap->positions.data[id].ui64 = pos + 1;
+  }
+}
+
+#define ORDER min_ui64
+#define LESS(a, b) ((a).ui64 < (b).ui64)
+#define SELECTABLE 1
+#include "heap.template.c"
+#undef ORDER
+#undef LESS
+#undef SELECTABLE
+
+#define ORDER max_ui64
+#define LESS(a, b) ((a).ui64 > (b).ui64)
+#define SELECTABLE 1
+#include "heap.template.c"
+#undef ORDER
+#undef LESS
+#undef SELECTABLE
+
+#define ORDER min_i64
+#define LESS(a, b) ((a).i64 < (b).i64)
+#define SELECTABLE 1
+#include "heap.template.c"
+#undef ORDER
+#undef LESS
+#undef SELECTABLE
+
+#define ORDER max_i64
+#define LESS(a, b) ((a).i64 > (b).i64)
+#define SELECTABLE 1
+#include "heap.template.c"
+#undef ORDER
+#undef LESS
+#undef SELECTABLE
+
+#define ORDER min_f64
+#define LESS(a, b) ((a).f64 < (b).f64)
+#define SELECTABLE 1
+#include "heap.template.c"
+#undef ORDER
+#undef LESS
+#undef SELECTABLE
+
+#define ORDER max_f64
+#define LESS(a, b) ((a).f64 > (b).f64)
+#define SELECTABLE 1
+#include "heap.template.c"
+#undef ORDER
+#undef LESS
+#undef SELECTABLE
+
+#define ORDER custom
+#define LESS(a, b) (heap->compare((a), (b), heap->compare_data))
+#define SELECTABLE 0
+#include "heap.template.c"
+#undef ORDER
+#undef LESS
+#undef SELECTABLE
+
+// Call the specialization of `function` for the order of the heap.
+#define DISPATCH(heap, function, ...) \
+  switch ((heap)->order) { \
+    case GCU_HEAP64_MIN_UI64: function##_min_ui64(__VA_ARGS__); break; \
+    case GCU_HEAP64_MAX_UI64: function##_max_ui64(__VA_ARGS__); break; \
+    case GCU_HEAP64_MIN_I64: function##_min_i64(__VA_ARGS__); break; \
+    case GCU_HEAP64_MAX_I64: function##_max_i64(__VA_ARGS__); break; \
+    case GCU_HEAP64_MIN_F64: function##_min_f64(__VA_ARGS__); break; \
+    case GCU_HEAP64_MAX_F64: function##_max_f64(__VA_ARGS__); break; \
+    default: function##_custom(__VA_ARGS__); \
+  }
+
+GCU_Heap64 * gcu_heap64_create(size_t count, size_t arity, GCU_Heap64_Order order, bool indexed) {
+  // Malloc Zeroed-out memory.
+  GCU_Heap64 * heap = gcu_calloc(1, sizeof(GCU_Heap64));
+
+  // If the allocation failed, return null.
+  if (!heap) {
+    return 0;
+  }
+
+  if (!gcu_heap64_create_in_place(heap, count, arity, order, indexed)) {
+    gcu_free(heap);
+    return 0;
+  }
+
+  return heap;
+}
+
+bool gcu_heap64_create_in_place(GCU_Heap64 * heap, size_t count, size_t arity, GCU_Heap64_Order order, bool indexed) {
+  // A heap in which each value has a single child is a sorted list.
+  if (arity == 1 || (unsigned)order > GCU_HEAP64_CUSTOM) {
+    return false;
+  }
+
+  *heap = (GCU_Heap64) {
+    .arity = arity
+      ? arity
+      : DEFAULT_ARITY,
+    .order = order,
+    .indexed = indexed,
+    .compare = 0,
+    .compare_data = 0,
+    .cleanup = 0,
+  };
+
+  // Only an indexed heap reserves room for the ids.
+  if (!gcu_vector64_create_in_place(&heap->values, count)) {
+    return false;
+  }
+  if (!gcu_vector64_create_in_place(&heap->ids, indexed ? count : 0)) {
+    gcu_vector64_destroy_in_place(&heap->values);
+    return false;
+  }
+  if (!gcu_vector64_create_in_place(&heap->positions, 0)) {
+    gcu_vector64_destroy_in_place(&heap->ids);
+    gcu_vector64_destroy_in_place(&heap->values);
+    return false;
+  }
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  // Allocate the mutex.
+  bool failure = GCU_MUTEX_CREATE(heap->mutex);
+
+  // If the allocation failed, clean up and return null.
+  if (failure) {
+    gcu_vector64_destroy_in_place(&heap->positions);
+    gcu_vector64_destroy_in_place(&heap->ids);
+    gcu_vector64_destroy_in_place(&heap->values);
+    return false;
+  }
+#endif
+
+  return true;
+}
+
+void gcu_heap64_destroy(GCU_Heap64 * heap) {
+  if (heap) {
+    gcu_heap64_destroy_in_place(heap);
+    gcu_free(heap);
+  }
+}
+
+void gcu_heap64_destroy_in_place(GCU_Heap64 * heap) {
+  // Verify that the pointer actually points to something.
+  if (heap) {
+    // Call the `cleanup` function, if it exists.
+    if (heap->cleanup) {
+      heap->cleanup(heap);
+    }
+
+    gcu_vector64_destroy_in_place(&heap->positions);
+    gcu_vector64_destroy_in_place(&heap->ids);
+    gcu_vector64_destroy_in_place(&heap->values);
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+    GCU_MUTEX_DESTROY(heap->mutex);
+#endif
+  }
+}
+
+bool gcu_heap64_push(GCU_Heap64 * heap, GCU_Type64_Union value) {
+  if (heap->indexed || !gcu_vector64_append(&heap->values, value)) {
+    return false;
+  }
+  DISPATCH(heap, sift_up, heap, heap->values.count - 1);
+  return true;
+}
+
+// Make sure that the position map covers `id`.  Ids which were not covered
+// before are not in the heap.
+static bool cover_id(GCU_Heap64 * heap, uint64_t id) {
+  GCU_Vector64 * positions = &heap->positions;
+  if (id < positions->count) {
+    return true;
+  }
+  if (id >= SIZE_MAX / sizeof(GCU_Type64_Union)) {
+    return false;
+  }
+  size_t count = (size_t)id + 1;
+  if (count > positions->capacity) {
+    size_t capacity = positions->capacity * 2;
+    if (capacity < count) {
+      capacity = count;
+    }
+    if (capacity < MINIMUM_POSITIONS) {
+      capacity = MINIMUM_POSITIONS;
+    }
+    if (!gcu_vector64_reserve(positions, capacity)) {
+      return false;
+    }
+  }
+  memset(positions->data + positions->count, 0, (count - positions->count) * sizeof(GCU_Type64_Union));
+  positions->count = count;
+  return true;
+}
+
+bool gcu_heap64_push_id(GCU_Heap64 * heap, GCU_Type64_Union value, uint64_t id) {
+  if (!heap->indexed) {
+    return false;
+  }
+  if (gcu_heap64_contains_id(heap, id)) {
+    return gcu_heap64_update(heap, id, value);
+  }
+  if (!cover_id(heap, id)) {
+    return false;
+  }
+  if (!gcu_vector64_append(&heap->ids, gcu_type64_ui64(id))) {
+    return false;
+  }
+  if (!gcu_vector64_append(&heap->values, value)) {
+    --heap->ids.count;
+    return false;
+  }
+  heap->positions.data[id].ui64 = heap->values.count;
+  DISPATCH(heap, sift_up, heap, heap->values.count - 1);
+  return true;
+}
+
+bool gcu_heap64_heapify(GCU_Heap64 * heap, const GCU_Type64_Union * values, size_t count) {
+  if (heap->indexed) {
+    return false;
+  }
+  if (!count) {
+    return true;
+  }
+  size_t old = heap->values.count;
+  if (count > SIZE_MAX / sizeof(GCU_Type64_Union) - old) {
+    return false;
+  }
+  if (old + count > heap->values.capacity && !gcu_vector64_reserve(&heap->values, old + count)) {
+    return false;
+  }
+  memcpy(heap->values.data + old, values, count * sizeof(GCU_Type64_Union));
+  heap->values.count = old + count;
+
+  // Rebuilding costs time linear in the whole heap, while adding the values
+  // one at a time costs (on average) a small constant per new value, so only
+  // rebuild when the new values outnumber the old ones.
+  if (count > old) {
+    DISPATCH(heap, heapify, heap);
+  }
+  else {
+    for (size_t pos = old; pos < old + count; ++pos) {
+      DISPATCH(heap, sift_up, heap, pos);
+    }
+  }
+  return true;
+}
+
+GCU_Heap64_Value gcu_heap64_peek(GCU_Heap64 * heap) {
+  if (!heap->values.count) {
+    return (GCU_Heap64_Value){0};
+  }
+  return (GCU_Heap64_Value){
+    .exists = true,
+    .value = heap->values.data[0],
+    .id = heap->indexed
+      ? heap->ids.data[0].ui64
+      : 0,
+  };
+}
+
+GCU_Heap64_Value gcu_heap64_pop(GCU_Heap64 * heap) {
+  GCU_Heap64_Value first = gcu_heap64_peek(heap);
+  if (!first.exists) {
+    return first;
+  }
+
+  // Move the last value to the root, and let it sink.
+  size_t last = --heap->values.count;
+  if (heap->indexed) {
+    --heap->ids.count;
+    heap->positions.data[first.id].ui64 = 0;
+  }
+  if (last) {
+    place_value(heap, 0, heap->values.data[last], heap->indexed ? heap->ids.data[last].ui64 : 0);
+    DISPATCH(heap, sift_down, heap, 0);
+  }
+  return first;
+}
+
+bool gcu_heap64_update(GCU_Heap64 * heap, uint64_t id, GCU_Type64_Union value) {
+  if (!gcu_heap64_contains_id(heap, id)) {
+    return false;
+  }
+  size_t pos = heap->positions.data[id].ui64 - 1;
+  DISPATCH(heap, replace, heap, pos, value);
+  return true;
+}
+
+bool gcu_heap64_contains_id(GCU_Heap64 * heap, uint64_t id) {
+  return heap->indexed
+    && id < heap->positions.count
+    && heap->positions.data[id].ui64;
+}
+
+size_t gcu_heap64_count(GCU_Heap64 * heap) {
+  return heap->values.count;
+}
+
+bool gcu_heap64_top_k(GCU_Vector64 * vector, size_t k, GCU_Heap64_Order order, GCU_Vector64 * result) {
+  if (!vector || !result || (unsigned)order >= GCU_HEAP64_CUSTOM) {
+    return false;
+  }
+  size_t found = vector->count < k
+    ? vector->count
+    : k;
+  result->count = 0;
+  if (!found) {
+    return true;
+  }
+  if (found > result->capacity && !gcu_vector64_reserve(result, found)) {
+    return false;
+  }
+
+  // The candidates are kept in a heap of the opposite order, so that the
+  // worst of them is at the root, ready to be replaced.
+  static const GCU_Heap64_Order reverse[] = {
+    [GCU_HEAP64_MIN_UI64] = GCU_HEAP64_MAX_UI64,
+    [GCU_HEAP64_MAX_UI64] = GCU_HEAP64_MIN_UI64,
+    [GCU_HEAP64_MIN_I64] = GCU_HEAP64_MAX_I64,
+    [GCU_HEAP64_MAX_I64] = GCU_HEAP64_MIN_I64,
+    [GCU_HEAP64_MIN_F64] = GCU_HEAP64_MAX_F64,
+    [GCU_HEAP64_MAX_F64] = GCU_HEAP64_MIN_F64,
+  };
+  GCU_Heap64 heap;
+  if (!gcu_heap64_create_in_place(&heap, found, DEFAULT_ARITY, reverse[order], false)) {
+    return false;
+  }
+  if (heap.values.capacity < found) {
+    gcu_heap64_destroy_in_place(&heap);
+    return false;
+  }
+  switch (heap.order) {
+    case GCU_HEAP64_MIN_UI64: select_min_ui64(&heap, vector->data, vector->count, found); break;
+    case GCU_HEAP64_MAX_UI64: select_max_ui64(&heap, vector->data, vector->count, found); break;
+    case GCU_HEAP64_MIN_I64: select_min_i64(&heap, vector->data, vector->count, found); break;
+    case GCU_HEAP64_MAX_I64: select_max_i64(&heap, vector->data, vector->count, found); break;
+    case GCU_HEAP64_MIN_F64: select_min_f64(&heap, vector->data, vector->count, found); break;
+    default: select_max_f64(&heap, vector->data, vector->count, found);
+  }
+
+  // The heap gives up the worst candidate first.
+  for (size_t i = found; i--;) {
+    result->data[i] = gcu_heap64_pop(&heap).value;
+  }
+  result->count = found;
+  gcu_heap64_destroy_in_place(&heap);
+  return true;
+}
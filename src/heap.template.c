@@ -0,0 +1,152 @@
+#define TEMPLATE_SIFT_UP_ARITY      GHOTIIO_CUTIL_CONCAT2(sift_up_arity_, ORDER)
+#define TEMPLATE_SIFT_DOWN_ARITY    GHOTIIO_CUTIL_CONCAT2(sift_down_arity_, ORDER)
+#define TEMPLATE_HEAPIFY_ARITY      GHOTIIO_CUTIL_CONCAT2(heapify_arity_, ORDER)
+#define TEMPLATE_SIFT_UP            GHOTIIO_CUTIL_CONCAT2(sift_up_, ORDER)
+#define TEMPLATE_SIFT_DOWN          GHOTIIO_CUTIL_CONCAT2(sift_down_, ORDER)
+#define TEMPLATE_HEAPIFY            GHOTIIO_CUTIL_CONCAT2(heapify_, ORDER)
+#define TEMPLATE_REPLACE            GHOTIIO_CUTIL_CONCAT2(replace_, ORDER)
+#define TEMPLATE_SELECT             GHOTIIO_CUTIL_CONCAT2(select_, ORDER)
+
+// The `_ARITY` functions take the arity as an argument so that, once inlined
+// into the dispatchers below, the common arities are compile-time constants
+// and finding a parent or child is a shift rather than a division.
+
+// Move the value at `pos` towards the root until it does not come before its
+// parent.
+static inline void TEMPLATE_SIFT_UP_ARITY(GCU_Heap64 * heap, size_t pos, size_t arity) {
+  GCU_Type64_Union * values = heap->values.data;
+  GCU_Type64_Union value = values[pos];
+  uint64_t id = heap->indexed ? heap->ids.data[pos].ui64 : 0;
+  while (pos) {
+    size_t parent = (pos - 1) / arity;
+    if (!LESS(value, values[parent])) {
+      break;
+    }
+    move_value(heap, parent, pos);
+    pos = parent;
+  }
+  place_value(heap, pos, value, id);
+}
+
+// Move the value at `pos` away from the root until none of its children come
+// before it.
+static inline void TEMPLATE_SIFT_DOWN_ARITY(GCU_Heap64 * heap, size_t pos, size_t arity) {
+  GCU_Type64_Union * values = heap->values.data;
+  size_t count = heap->values.count;
+  GCU_Type64_Union value = values[pos];
+  uint64_t id = heap->indexed ? heap->ids.data[pos].ui64 : 0;
+  while (true) {
+    size_t first = pos * arity + 1;
+    if (first >= count) {
+      break;
+    }
+    size_t end = count - first > arity
+      ? first + arity
+      : count;
+    // Fetch the grandchildren while the children are compared, so that the
+    // next level is (at least partly) in cache.  Beyond an arity of 8 there
+    // are too many of them to be worth it.
+    size_t grandchild = first * arity + 1;
+    if (arity <= 8 && grandchild < count) {
+      for (size_t line = 0; line < arity * arity; line += 64 / sizeof(GCU_Type64_Union)) {
+        PREFETCH(values + grandchild + line);
+      }
+    }
+    size_t best = first;
+    for (size_t child = first + 1; child < end; ++child) {
+      if (LESS(values[child], values[best])) {
+        best = child;
+      }
+    }
+    if (!LESS(values[best], value)) {
+      break;
+    }
+    move_value(heap, best, pos);
+    pos = best;
+  }
+  place_value(heap, pos, value, id);
+}
+
+// Restore the heap property of the whole heap, bottom-up.
+static inline void TEMPLATE_HEAPIFY_ARITY(GCU_Heap64 * heap, size_t arity) {
+  size_t count = heap->values.count;
+  if (count < 2) {
+    return;
+  }
+  for (size_t pos = (count - 2) / arity + 1; pos--;) {
+    TEMPLATE_SIFT_DOWN_ARITY(heap, pos, arity);
+  }
+}
+
+static void TEMPLATE_SIFT_UP(GCU_Heap64 * heap, size_t pos) {
+  switch (heap->arity) {
+    case 2: TEMPLATE_SIFT_UP_ARITY(heap, pos, 2); break;
+    case 4: TEMPLATE_SIFT_UP_ARITY(heap, pos, 4); break;
+    case 8: TEMPLATE_SIFT_UP_ARITY(heap, pos, 8); break;
+    default: TEMPLATE_SIFT_UP_ARITY(heap, pos, heap->arity);
+  }
+}
+
+static void TEMPLATE_SIFT_DOWN(GCU_Heap64 * heap, size_t pos) {
+  switch (heap->arity) {
+    case 2: TEMPLATE_SIFT_DOWN_ARITY(heap, pos, 2); break;
+    case 4: TEMPLATE_SIFT_DOWN_ARITY(heap, pos, 4); break;
+    case 8: TEMPLATE_SIFT_DOWN_ARITY(heap, pos, 8); break;
+    default: TEMPLATE_SIFT_DOWN_ARITY(heap, pos, heap->arity);
+  }
+}
+
+static void TEMPLATE_HEAPIFY(GCU_Heap64 * heap) {
+  switch (heap->arity) {
+    case 2: TEMPLATE_HEAPIFY_ARITY(heap, 2); break;
+    case 4: TEMPLATE_HEAPIFY_ARITY(heap, 4); break;
+    case 8: TEMPLATE_HEAPIFY_ARITY(heap, 8); break;
+    default: TEMPLATE_HEAPIFY_ARITY(heap, heap->arity);
+  }
+}
+
+// Change the value at `pos`, and move it in whichever direction restores the
+// heap property.
+static void TEMPLATE_REPLACE(GCU_Heap64 * heap, size_t pos, GCU_Type64_Union value) {
+  GCU_Type64_Union old = heap->values.data[pos];
+  heap->values.data[pos] = value;
+  if (LESS(value, old)) {
+    TEMPLATE_SIFT_UP(heap, pos);
+  }
+  else {
+    TEMPLATE_SIFT_DOWN(heap, pos);
+  }
+}
+
+#if SELECTABLE
+// Keep the `k` values of `data` which come *last* in the order of the heap.
+// The heap must be empty, non-indexed, and have room for `k` values.  Its
+// first value is the one which the next candidate must beat.
+static void TEMPLATE_SELECT(GCU_Heap64 * heap, const GCU_Type64_Union * data, size_t count, size_t k) {
+  size_t fill = count < k
+    ? count
+    : k;
+  memcpy(heap->values.data, data, fill * sizeof(GCU_Type64_Union));
+  heap->values.count = fill;
+  TEMPLATE_HEAPIFY(heap);
+  if (!fill) {
+    return;
+  }
+  GCU_Type64_Union * values = heap->values.data;
+  for (size_t i = fill; i < count; ++i) {
+    if (LESS(values[0], data[i])) {
+      values[0] = data[i];
+      TEMPLATE_SIFT_DOWN(heap, 0);
+    }
+  }
+}
+#endif // SELECTABLE
+
+#undef TEMPLATE_SIFT_UP_ARITY
+#undef TEMPLATE_SIFT_DOWN_ARITY
+#undef TEMPLATE_HEAPIFY_ARITY
+#undef TEMPLATE_SIFT_UP
+#undef TEMPLATE_SIFT_DOWN
+#undef TEMPLATE_HEAPIFY
+#undef TEMPLATE_REPLACE
+#undef TEMPLATE_SELECT
@@ -0,0 +1,303 @@
+/**
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <cutil/jagged.h>
+#include <cutil/memory.h>
+
+// Exchange the contents of two vectors, leaving each with its own mutex.
+static void swap_data(GCU_Vector64 * a, GCU_Vector64 * b) {
+  GCU_Type64_Union * data = a->data;
+  size_t count = a->count;
+  size_t capacity = a->capacity;
+  a->data = b->data;
+  a->count = b->count;
+  a->capacity = b->capacity;
+  b->data = data;
+  b->count = count;
+  b->capacity = capacity;
+}
+
+GCU_Jagged64 * gcu_jagged64_create(size_t rows, size_t count) {
+  // Malloc Zeroed-out memory.
+  GCU_Jagged64 * jagged = gcu_calloc(1, sizeof(GCU_Jagged64));
+
+  // If the allocation failed, return null.
+  if (!jagged) {
+    return 0;
+  }
+
+  if (!gcu_jagged64_create_in_place(jagged, rows, count)) {
+    gcu_free(jagged);
+    return 0;
+  }
+
+  return jagged;
+}
+
+bool gcu_jagged64_create_in_place(GCU_Jagged64 * jagged, size_t rows, size_t count) {
+  if (rows >= SIZE_MAX / sizeof(GCU_Type64_Union)) {
+    return false;
+  }
+
+  *jagged = (GCU_Jagged64) {
+    .row_count = rows,
+    .allocated = false,
+    .cleanup = 0,
+  };
+
+  // The offsets start as the (zero) size of each row.  A new vector is
+  // reserved with `calloc()`, so its memory is already zeroed.
+  if (!gcu_vector64_create_in_place(&jagged->offsets, 0)) {
+    return false;
+  }
+  if (!gcu_vector64_reserve(&jagged->offsets, rows + 1)) {
+    gcu_vector64_destroy_in_place(&jagged->offsets);
+    return false;
+  }
+  jagged->offsets.count = rows + 1;
+
+  if (!gcu_vector64_create_in_place(&jagged->values, count)) {
+    gcu_vector64_destroy_in_place(&jagged->offsets);
+    return false;
+  }
+  if (!gcu_vector64_create_in_place(&jagged->cursors, 0)) {
+    gcu_vector64_destroy_in_place(&jagged->values);
+    gcu_vector64_destroy_in_place(&jagged->offsets);
+    return false;
+  }
+  if (!gcu_vector64_create_in_place(&jagged->pending_rows, 0)) {
+    gcu_vector64_destroy_in_place(&jagged->cursors);
+    gcu_vector64_destroy_in_place(&jagged->values);
+    gcu_vector64_destroy_in_place(&jagged->offsets);
+    return false;
+  }
+  if (!gcu_vector64_create_in_place(&jagged->pending_values, 0)) {
+    gcu_vector64_destroy_in_place(&jagged->pending_rows);
+    gcu_vector64_destroy_in_place(&jagged->cursors);
+    gcu_vector64_destroy_in_place(&jagged->values);
+    gcu_vector64_destroy_in_place(&jagged->offsets);
+    return false;
+  }
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  // Allocate the mutex.
+  bool failure = GCU_MUTEX_CREATE(jagged->mutex);
+
+  // If the allocation failed, clean up and return null.
+  if (failure) {
+    gcu_vector64_destroy_in_place(&jagged->pending_values);
+    gcu_vector64_destroy_in_place(&jagged->pending_rows);
+    gcu_vector64_destroy_in_place(&jagged->cursors);
+    gcu_vector64_destroy_in_place(&jagged->values);
+    gcu_vector64_destroy_in_place(&jagged->offsets);
+    return false;
+  }
+#endif
+
+  return true;
+}
+
+void gcu_jagged64_destroy(GCU_Jagged64 * jagged) {
+  if (jagged) {
+    gcu_jagged64_destroy_in_place(jagged);
+    gcu_free(jagged);
+  }
+}
+
+void gcu_jagged64_destroy_in_place(GCU_Jagged64 * jagged) {
+  // Verify that the pointer actually points to something.
+  if (jagged) {
+    // Call the `cleanup` function, if it exists.
+    if (jagged->cleanup) {
+      jagged->cleanup(jagged);
+    }
+
+    gcu_vector64_destroy_in_place(&jagged->pending_values);
+    gcu_vector64_destroy_in_place(&jagged->pending_rows);
+    gcu_vector64_destroy_in_place(&jagged->cursors);
+    gcu_vector64_destroy_in_place(&jagged->values);
+    gcu_vector64_destroy_in_place(&jagged->offsets);
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+    GCU_MUTEX_DESTROY(jagged->mutex);
+#endif
+  }
+}
+
+bool gcu_jagged64_add_row_size(GCU_Jagged64 * jagged, size_t row, size_t count) {
+  if (jagged->allocated || row + 1 >= jagged->offsets.count) {
+    return false;
+  }
+  jagged->offsets.data[row + 1].ui64 += count;
+  return true;
+}
+
+bool gcu_jagged64_allocate(GCU_Jagged64 * jagged) {
+  if (jagged->allocated) {
+    return false;
+  }
+
+  // Only the rows which existed when the array was created can have been
+  // given a size.
+  size_t rows = jagged->offsets.count - 1;
+  GCU_Type64_Union * offsets = jagged->offsets.data;
+  uint64_t total = 0;
+  for (size_t row = 0; row < rows; ++row) {
+    total += offsets[row + 1].ui64;
+    if (total < offsets[row + 1].ui64 || total >= SIZE_MAX / sizeof(GCU_Type64_Union)) {
+      return false;
+    }
+  }
+
+  // Make room for everything before changing anything, so that a failure
+  // leaves the sizes in place.
+  if (total && !gcu_vector64_reserve(&jagged->values, total)) {
+    return false;
+  }
+  if (rows && !gcu_vector64_reserve(&jagged->cursors, rows)) {
+    return false;
+  }
+
+  // Turn the sizes into positions, each row starting where the last ended.
+  offsets[0].ui64 = 0;
+  for (size_t row = 0; row < rows; ++row) {
+    offsets[row + 1].ui64 += offsets[row].ui64;
+    jagged->cursors.data[row].ui64 = offsets[row].ui64;
+  }
+  jagged->cursors.count = rows;
+  if (total) {
+    memset(jagged->values.data, 0, total * sizeof(GCU_Type64_Union));
+  }
+  jagged->values.count = total;
+  jagged->allocated = true;
+  return true;
+}
+
+bool gcu_jagged64_fill(GCU_Jagged64 * jagged, size_t row, GCU_Type64_Union value) {
+  if (row >= jagged->cursors.count) {
+    return false;
+  }
+  uint64_t position = jagged->cursors.data[row].ui64;
+  if (position >= jagged->offsets.data[row + 1].ui64) {
+    return false;
+  }
+  jagged->values.data[position] = value;
+  jagged->cursors.data[row].ui64 = position + 1;
+  return true;
+}
+
+bool gcu_jagged64_append(GCU_Jagged64 * jagged, size_t row, GCU_Type64_Union value) {
+  if (row >= SIZE_MAX / sizeof(GCU_Type64_Union) - 1) {
+    return false;
+  }
+  if (!gcu_vector64_append(&jagged->pending_rows, gcu_type64_ui64(row))) {
+    return false;
+  }
+  if (!gcu_vector64_append(&jagged->pending_values, value)) {
+    --jagged->pending_rows.count;
+    return false;
+  }
+  if (row >= jagged->row_count) {
+    jagged->row_count = row + 1;
+  }
+  return true;
+}
+
+bool gcu_jagged64_compact(GCU_Jagged64 * jagged) {
+  if (!jagged->allocated && !gcu_jagged64_allocate(jagged)) {
+    return false;
+  }
+
+  // Filling ends here, whether or not there is anything to move.
+  size_t pending = jagged->pending_rows.count;
+  if (!pending) {
+    jagged->cursors.count = 0;
+    return true;
+  }
+
+  size_t old_rows = jagged->offsets.count - 1;
+  size_t rows = jagged->row_count;
+  size_t total = jagged->values.count + pending;
+  GCU_Type64_Union * old_offsets = jagged->offsets.data;
+  GCU_Type64_Union * pending_rows = jagged->pending_rows.data;
+
+  // Lay out the new rows in vectors of their own, so that a failure leaves
+  // the array as it was.
+  GCU_Vector64 offsets;
+  GCU_Vector64 values;
+  if (!gcu_vector64_create_in_place(&offsets, 0)) {
+    return false;
+  }
+  if (!gcu_vector64_create_in_place(&values, 0)) {
+    gcu_vector64_destroy_in_place(&offsets);
+    return false;
+  }
+  if (!gcu_vector64_reserve(&offsets, rows + 1)
+    || !gcu_vector64_reserve(&values, total)
+    || !gcu_vector64_reserve(&jagged->cursors, rows)) {
+    gcu_vector64_destroy_in_place(&values);
+    gcu_vector64_destroy_in_place(&offsets);
+    return false;
+  }
+
+  // Count the values of each row: its old values, and its appended values.
+  GCU_Type64_Union * new_offsets = offsets.data;
+  memset(new_offsets, 0, (rows + 1) * sizeof(GCU_Type64_Union));
+  for (size_t row = 0; row < old_rows; ++row) {
+    new_offsets[row + 1].ui64 = old_offsets[row + 1].ui64 - old_offsets[row].ui64;
+  }
+  for (size_t i = 0; i < pending; ++i) {
+    ++new_offsets[pending_rows[i].ui64 + 1].ui64;
+  }
+  for (size_t row = 0; row < rows; ++row) {
+    new_offsets[row + 1].ui64 += new_offsets[row].ui64;
+  }
+
+  // Copy the old values of each row to its new start, then append the
+  // pending values after them, in the order in which they were added.
+  GCU_Type64_Union * cursors = jagged->cursors.data;
+  for (size_t row = 0; row < rows; ++row) {
+    size_t size = row < old_rows
+      ? old_offsets[row + 1].ui64 - old_offsets[row].ui64
+      : 0;
+    if (size) {
+      memcpy(values.data + new_offsets[row].ui64, jagged->values.data + old_offsets[row].ui64, size * sizeof(GCU_Type64_Union));
+    }
+    cursors[row].ui64 = new_offsets[row].ui64 + size;
+  }
+  GCU_Type64_Union * pending_values = jagged->pending_values.data;
+  for (size_t i = 0; i < pending; ++i) {
+    values.data[cursors[pending_rows[i].ui64].ui64++] = pending_values[i];
+  }
+  offsets.count = rows + 1;
+  values.count = total;
+
+  // Swap in the new rows, and free the old ones.
+  swap_data(&jagged->offsets, &offsets);
+  swap_data(&jagged->values, &values);
+  gcu_vector64_destroy_in_place(&values);
+  gcu_vector64_destroy_in_place(&offsets);
+  jagged->cursors.count = 0;
+  jagged->pending_rows.count = 0;
+  jagged->pending_values.count = 0;
+  return true;
+}
+
+GCU_Vector64_View gcu_jagged64_row(GCU_Jagged64 * jagged, size_t row) {
+  if (!jagged->allocated || row + 1 >= jagged->offsets.count) {
+    return (GCU_Vector64_View) {0};
+  }
+  uint64_t start = jagged->offsets.data[row].ui64;
+  return gcu_view64_of(jagged->values.data + start, jagged->offsets.data[row + 1].ui64 - start);
+}
+
+size_t gcu_jagged64_row_count(GCU_Jagged64 * jagged) {
+  return jagged->row_count;
+}
+
+size_t gcu_jagged64_count(GCU_Jagged64 * jagged) {
+  return jagged->values.count;
+}
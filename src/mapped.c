@@ -0,0 +1,408 @@
+/**
+ * @file
+ *
+ * This file implements file-backed vectors on top of `mmap()`.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <cutil/growth.h>
+#include <cutil/mapped.h>
+#include <cutil/memory.h>
+
+#ifdef _WIN32
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif // _WIN32
+
+// The smallest number of values by which the file grows, so that appending
+// one value at a time to a new file does not resize it for every page.
+#define MINIMUM_GROWTH 512
+
+// Identifies a file as a mapped vector, and the version of the layout.
+static const char MAGIC[8] = {'G', 'C', 'U', 'M', 'A', 'P', '6', '4'};
+#define VERSION 1
+
+//
+// The start of the file.  It fills a cache line, so the values which follow
+// it are aligned.
+//
+typedef struct {
+  char magic[8];            // MAGIC.
+  uint64_t version;         // VERSION.
+  uint64_t count;           // The number of values.
+  uint64_t reserved[5];     // Zero.
+} Header;
+
+//
+// A mapped file, which is the storage of one vector.  It is the context of
+// its own allocator, which the vector's growth policy names, so that the
+// vector grows the file, and frees the mapping when it is destroyed.
+//
+typedef struct {
+  GCU_Allocator allocator;  // The allocator of the vector's storage.
+  GCU_Vector64 * vector;    // The vector.
+  void * mapping;           // The start of the mapping (the header).
+  size_t mapping_size;      // The size of the mapping, in bytes.
+  size_t file_size;         // The size of the file, in bytes.
+  int file;                 // The file descriptor.
+  bool read_only;           // Whether or not the file was opened read-only.
+  bool * closed;            // Where to report whether the file was closed
+                            //   cleanly, or `NULL`.
+} Mapping;
+
+// Get the values of a mapping, which follow the header.
+static inline GCU_Type64_Union * values(Mapping * mapping) {
+  return (GCU_Type64_Union *)((Header *)mapping->mapping + 1);
+}
+
+// Get the number of values which fit in a mapping.
+static inline size_t capacity(Mapping * mapping) {
+  return (mapping->mapping_size - sizeof(Header)) / sizeof(GCU_Type64_Union);
+}
+
+// Get the size of the mapping which holds `count` values.
+static inline size_t mapping_size(size_t count) {
+  return sizeof(Header) + count * sizeof(GCU_Type64_Union);
+}
+
+#ifndef _WIN32
+
+// Map (or remap) the first `size` bytes of the file.  A read-only file is
+// mapped privately, so that changes to the vector stay in this process.
+static bool map_file(Mapping * mapping, size_t size) {
+  void * start;
+  int flags = mapping->read_only
+    ? MAP_PRIVATE
+    : MAP_SHARED;
+  if (mapping->mapping) {
+#ifdef __linux__
+    start = mremap(mapping->mapping, mapping->mapping_size, size, MREMAP_MAYMOVE);
+#else
+    start = mmap(0, size, PROT_READ | PROT_WRITE, flags, mapping->file, 0);
+    if (start != MAP_FAILED) {
+      munmap(mapping->mapping, mapping->mapping_size);
+    }
+#endif
+  }
+  else {
+    start = mmap(0, size, PROT_READ | PROT_WRITE, flags, mapping->file, 0);
+  }
+  if (start == MAP_FAILED) {
+    return false;
+  }
+  mapping->mapping = start;
+  mapping->mapping_size = size;
+  return true;
+}
+
+// Map an open file, checking (or, if it is empty and writable, writing) its
+// header.
+static bool map_header(Mapping * mapping) {
+  struct stat status;
+  if (fstat(mapping->file, &status)) {
+    return false;
+  }
+  size_t size = (size_t)status.st_size;
+  mapping->file_size = size;
+  if (!size && !mapping->read_only) {
+    size = mapping_size(0);
+    if (ftruncate(mapping->file, (off_t)size)) {
+      return false;
+    }
+    mapping->file_size = size;
+    if (!map_file(mapping, size)) {
+      return false;
+    }
+    Header * header = mapping->mapping;
+    memcpy(header->magic, MAGIC, sizeof(MAGIC));
+    header->version = VERSION;
+    return true;
+  }
+
+  // Only whole values count towards the capacity.
+  if (size < sizeof(Header)) {
+    return false;
+  }
+  size -= (size - sizeof(Header)) % sizeof(GCU_Type64_Union);
+  if (!map_file(mapping, size)) {
+    return false;
+  }
+  Header * header = mapping->mapping;
+  uint64_t count = __atomic_load_n(&header->count, __ATOMIC_ACQUIRE);
+  if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) || header->version != VERSION || count > capacity(mapping)) {
+    munmap(mapping->mapping, mapping->mapping_size);
+    return false;
+  }
+  return true;
+}
+
+// Write the count of the vector to the header.
+static void publish(Mapping * mapping) {
+  __atomic_store_n(&((Header *)mapping->mapping)->count, (uint64_t)mapping->vector->count, __ATOMIC_RELEASE);
+}
+
+// Publish the count, unmap the file, cut it back to the values, and close
+// it.  Returns whether every step succeeded.
+static bool release(Mapping * mapping) {
+  bool released = true;
+  size_t size = mapping->file_size;
+  if (!mapping->read_only) {
+    publish(mapping);
+    size = mapping_size(mapping->vector->count);
+  }
+  if (munmap(mapping->mapping, mapping->mapping_size)) {
+    released = false;
+  }
+  if (size != mapping->file_size && ftruncate(mapping->file, (off_t)size)) {
+    released = false;
+  }
+  if (close(mapping->file)) {
+    released = false;
+  }
+  return released;
+}
+
+#endif // _WIN32
+
+//
+// The allocator of a mapped vector's storage.  The mapping holds a single
+// block, the values, so only reallocation and freeing do anything.
+//
+
+static void * mapping_allocate(void * context, size_t size) {
+  (void)context;
+  (void)size;
+  return 0;
+}
+
+static void * mapping_allocate_zeroed(void * context, size_t nitems, size_t size) {
+  (void)context;
+  (void)nitems;
+  (void)size;
+  return 0;
+}
+
+static void * mapping_reallocate(void * context, void * pointer, size_t size) {
+  Mapping * mapping = context;
+  if (mapping->read_only || pointer != values(mapping) || size > SIZE_MAX - sizeof(Header)) {
+    return 0;
+  }
+
+#ifdef _WIN32
+  return 0;
+#else
+  // Grow the file first, so that the new part of the mapping is backed.  A
+  // file which shrinks keeps its room until it is closed.
+  size_t bytes = sizeof(Header) + size - size % sizeof(GCU_Type64_Union);
+  if (bytes > mapping->file_size) {
+    if (ftruncate(mapping->file, (off_t)bytes)) {
+      return 0;
+    }
+    mapping->file_size = bytes;
+  }
+  if (!map_file(mapping, bytes)) {
+    // Leave the file matching the mapping.  Should that fail too, the file
+    // keeps the room, which is given back when it is closed.
+    if (mapping->file_size > mapping->mapping_size && !ftruncate(mapping->file, (off_t)mapping->mapping_size)) {
+      mapping->file_size = mapping->mapping_size;
+    }
+    return 0;
+  }
+  return values(mapping);
+#endif // _WIN32
+}
+
+static void mapping_free(void * context, void * pointer) {
+  Mapping * mapping = context;
+  if (pointer) {
+#ifndef _WIN32
+    bool released = release(mapping);
+    if (mapping->closed) {
+      *mapping->closed = released;
+    }
+#endif // _WIN32
+    gcu_free(mapping);
+  }
+}
+
+static size_t mapping_usable_size(void * context, void * pointer) {
+  return pointer
+    ? capacity(context) * sizeof(GCU_Type64_Union)
+    : 0;
+}
+
+// Get the mapping which is the storage of a vector, or `NULL` if it has none.
+static Mapping * mapping_of(GCU_Vector64 * vector) {
+  return vector && vector->data && vector->growth.allocator && vector->growth.allocator->free == mapping_free
+    ? vector->growth.allocator->context
+    : 0;
+}
+
+// Open the file and map it as the storage of a new vector, for
+// `gcu_mapped64_create()` and `gcu_mapped64_open()`.
+static GCU_Vector64 * create(const char * path, size_t count, bool read_only) {
+#ifdef _WIN32
+  (void)path;
+  (void)count;
+  (void)read_only;
+  return 0;
+#else
+  // Malloc Zeroed-out memory.
+  Mapping * mapping = gcu_calloc(1, sizeof(Mapping));
+
+  // If the allocation failed, return null.
+  if (!mapping) {
+    return 0;
+  }
+
+  mapping->read_only = read_only;
+  mapping->file = read_only
+    ? open(path, O_RDONLY | O_CLOEXEC)
+    : open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (mapping->file < 0) {
+    gcu_free(mapping);
+    return 0;
+  }
+  if (!map_header(mapping)) {
+    close(mapping->file);
+    gcu_free(mapping);
+    return 0;
+  }
+
+  GCU_Vector64 * vector = gcu_vector64_create(0);
+  if (!vector) {
+    munmap(mapping->mapping, mapping->mapping_size);
+    close(mapping->file);
+    gcu_free(mapping);
+    return 0;
+  }
+  mapping->allocator = (GCU_Allocator) {
+    .allocate = mapping_allocate,
+    .allocate_zeroed = mapping_allocate_zeroed,
+    .reallocate = mapping_reallocate,
+    .free = mapping_free,
+    .usable_size = mapping_usable_size,
+    .context = mapping,
+  };
+  mapping->vector = vector;
+
+  // The vector has no storage yet, so setting the policy moves nothing.
+  GCU_Growth growth = {0};
+  growth.factor = 2;
+  growth.minimum = MINIMUM_GROWTH;
+  growth.allocator = &mapping->allocator;
+  gcu_vector64_set_growth(vector, growth);
+
+  // A reader's capacity is its count, so that it never writes past what was
+  // published.  From here on, destroying the vector releases the mapping.
+  vector->data = values(mapping);
+  vector->count = __atomic_load_n(&((Header *)mapping->mapping)->count, __ATOMIC_ACQUIRE);
+  vector->capacity = read_only
+    ? vector->count
+    : capacity(mapping);
+  if (count > vector->capacity && !gcu_vector64_reserve(vector, count)) {
+    gcu_vector64_destroy(vector);
+    return 0;
+  }
+  return vector;
+#endif // _WIN32
+}
+
+GCU_Vector64 * gcu_mapped64_create(const char * path, size_t count) {
+  return create(path, count, false);
+}
+
+GCU_Vector64 * gcu_mapped64_open(const char * path) {
+  return create(path, 0, true);
+}
+
+bool gcu_mapped64_is_mapped(GCU_Vector64 * vector) {
+  return mapping_of(vector);
+}
+
+bool gcu_mapped64_publish(GCU_Vector64 * vector) {
+  Mapping * mapping = mapping_of(vector);
+  if (!mapping || mapping->read_only) {
+    return false;
+  }
+
+#ifdef _WIN32
+  return false;
+#else
+  publish(mapping);
+  return true;
+#endif // _WIN32
+}
+
+bool gcu_mapped64_sync(GCU_Vector64 * vector) {
+  if (!gcu_mapped64_publish(vector)) {
+    return false;
+  }
+
+#ifdef _WIN32
+  return false;
+#else
+  Mapping * mapping = mapping_of(vector);
+  return !msync(mapping->mapping, mapping_size(vector->count), MS_SYNC);
+#endif // _WIN32
+}
+
+bool gcu_mapped64_refresh(GCU_Vector64 * vector) {
+  Mapping * mapping = mapping_of(vector);
+  if (!mapping) {
+    return false;
+  }
+  if (!mapping->read_only) {
+    return true;
+  }
+
+#ifdef _WIN32
+  return false;
+#else
+  // The file is mapped afresh, so that values changed in this process are
+  // replaced by those in the file.  The writer publishes the count after it
+  // has grown the file, so the file is large enough for any count that is
+  // read here.
+  struct stat status;
+  if (fstat(mapping->file, &status) || (size_t)status.st_size < sizeof(Header)) {
+    return false;
+  }
+  size_t size = (size_t)status.st_size;
+  size -= (size - sizeof(Header)) % sizeof(GCU_Type64_Union);
+  Mapping fresh = *mapping;
+  fresh.mapping = 0;
+  if (!map_file(&fresh, size)) {
+    return false;
+  }
+  uint64_t count = __atomic_load_n(&((Header *)fresh.mapping)->count, __ATOMIC_ACQUIRE);
+  if (count > capacity(&fresh)) {
+    munmap(fresh.mapping, fresh.mapping_size);
+    return false;
+  }
+  munmap(mapping->mapping, mapping->mapping_size);
+  mapping->mapping = fresh.mapping;
+  mapping->mapping_size = fresh.mapping_size;
+  mapping->file_size = (size_t)status.st_size;
+  vector->data = values(mapping);
+  vector->count = count;
+  vector->capacity = count;
+  return true;
+#endif // _WIN32
+}
+
+bool gcu_mapped64_close(GCU_Vector64 * vector) {
+  Mapping * mapping = mapping_of(vector);
+  bool closed = false;
+  if (mapping) {
+    mapping->closed = &closed;
+  }
+  gcu_vector64_destroy(vector);
+  return closed;
+}
@@ -1,31 +1,1260 @@
 /**
  */
 
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
-static bool capture = true;
+#ifndef _WIN32
+#include <pthread.h>
+#include <time.h>
+#endif
 
-size_t gcu_memory_alloc_count = 0;
-size_t gcu_memory_free_count = 0;
+static bool capture = true;
 
 #include <cutil/memory.h>
+#include <cutil/semaphore.h>
+#include <cutil/thread.h>
+
+#define CACHE_LINE_BYTES GCU_CACHELINE_SIZE
+
+_Thread_local GCU_Memory_Counters * gcu_memory_counters = 0;
+
+const GCU_Allocator * gcu_allocator = 0;
+
+// The system's functions, which are counted by the caller.
+#ifdef _WIN32
+
+static void * system_allocate(void * context, size_t size) {
+  (void)context;
+  return HeapAlloc(GetProcessHeap(), 0, size);
+}
+
+static void * system_allocate_zeroed(void * context, size_t nitems, size_t size) {
+  (void)context;
+  return HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, nitems * size);
+}
+
+static void * system_reallocate(void * context, void * pointer, size_t size) {
+  (void)context;
+  return HeapReAlloc(GetProcessHeap(), 0, pointer, size);
+}
+
+static void system_free(void * context, void * pointer) {
+  (void)context;
+  HeapFree(GetProcessHeap(), 0, pointer);
+}
+
+#else
+
+static void * system_allocate(void * context, size_t size) {
+  (void)context;
+  return malloc(size);
+}
+
+static void * system_allocate_zeroed(void * context, size_t nitems, size_t size) {
+  (void)context;
+  return calloc(nitems, size);
+}
+
+static void * system_reallocate(void * context, void * pointer, size_t size) {
+  (void)context;
+  return realloc(pointer, size);
+}
+
+static void system_free(void * context, void * pointer) {
+  (void)context;
+  free(pointer);
+}
+
+#endif
+
+static size_t system_usable_size(void * context, void * pointer) {
+  (void)context;
+  return gcu_memory_usable_size(pointer);
+}
+
+const GCU_Allocator gcu_system_allocator = {
+  .allocate = system_allocate,
+  .allocate_zeroed = system_allocate_zeroed,
+  .reallocate = system_reallocate,
+  .free = system_free,
+  .usable_size = system_usable_size,
+  .context = 0,
+};
+
+const GCU_Allocator * gcu_set_allocator(const GCU_Allocator * allocator) {
+  const GCU_Allocator * previous = gcu_allocator;
+  gcu_allocator = allocator;
+  return previous;
+}
+
+// The counts of every thread, which are never freed.  The list and the
+// `in_use` flags are guarded by `lock`, which is only taken when a thread
+// first allocates, when it exits, and when the counts are read.
+static GCU_Memory_Counters * all_counters = 0;
+static atomic_flag lock = ATOMIC_FLAG_INIT;
+
+// The counts used if no memory can be had for a thread's own counts.  They
+// may be shared, so they are not exact.
+static GCU_Memory_Counters fallback_counters;
+
+static void acquire(void) {
+  while (atomic_flag_test_and_set_explicit(&lock, memory_order_acquire)) {
+    // The lock is held only briefly.
+  }
+}
+
+static void release(void) {
+  atomic_flag_clear_explicit(&lock, memory_order_release);
+}
+
+static void release_ring(void);
+
+// Give a thread's counts (and trace buffer) to the next thread which needs
+// them.
+static void release_counters(void * counters) {
+  acquire();
+  ((GCU_Memory_Counters *)counters)->in_use = false;
+  release();
+  gcu_memory_counters = 0;
+  release_ring();
+}
+
+// The thread-exit hook which releases a thread's counts.
+#ifdef _WIN32
+static INIT_ONCE exit_hook_once = INIT_ONCE_STATIC_INIT;
+static DWORD exit_hook;
+
+static void NTAPI release_counters_at_exit(void * counters) {
+  if (counters) {
+    release_counters(counters);
+  }
+}
+
+static BOOL CALLBACK create_exit_hook(PINIT_ONCE once, void * parameter, void ** context) {
+  (void)once;
+  (void)parameter;
+  (void)context;
+  exit_hook = FlsAlloc(release_counters_at_exit);
+  return TRUE;
+}
+
+static void set_exit_hook(GCU_Memory_Counters * counters) {
+  InitOnceExecuteOnce(&exit_hook_once, create_exit_hook, 0, 0);
+  if (exit_hook != FLS_OUT_OF_INDEXES) {
+    FlsSetValue(exit_hook, counters);
+  }
+}
+#else
+static pthread_once_t exit_hook_once = PTHREAD_ONCE_INIT;
+static pthread_key_t exit_hook;
+static bool exit_hook_created = false;
+
+static void create_exit_hook(void) {
+  exit_hook_created = !pthread_key_create(&exit_hook, release_counters);
+}
+
+static void set_exit_hook(GCU_Memory_Counters * counters) {
+  pthread_once(&exit_hook_once, create_exit_hook);
+  if (exit_hook_created) {
+    pthread_setspecific(exit_hook, counters);
+  }
+}
+#endif // _WIN32
+
+GCU_Memory_Counters * gcu_memory_counters_claim(void) {
+  // Reuse the counts of a thread which has exited, if there are any.
+  acquire();
+  GCU_Memory_Counters * counters = all_counters;
+  while (counters && counters->in_use) {
+    counters = counters->next;
+  }
+  if (counters) {
+    counters->in_use = true;
+  }
+  release();
+
+  if (!counters) {
+    // The counts fill a cache line of their own.  They are allocated
+    // directly, since counting them would need counts already.
+    size_t bytes = (sizeof(GCU_Memory_Counters) + CACHE_LINE_BYTES - 1) & ~(size_t)(CACHE_LINE_BYTES - 1);
+    void * allocation = calloc(1, bytes + CACHE_LINE_BYTES - 1);
+    if (!allocation) {
+      return &fallback_counters;
+    }
+    counters = (GCU_Memory_Counters *)(((uintptr_t)allocation + CACHE_LINE_BYTES - 1) & ~(uintptr_t)(CACHE_LINE_BYTES - 1));
+    counters->in_use = true;
+    acquire();
+    counters->next = all_counters;
+    all_counters = counters;
+    release();
+  }
+
+  gcu_memory_counters = counters;
+  set_exit_hook(counters);
+  return counters;
+}
+
+// The counts of every thread, added together.
+typedef struct {
+  size_t allocations;
+  size_t frees;
+  size_t reallocations;
+  size_t allocated_bytes;
+  size_t freed_bytes;
+  size_t peak_bytes;
+} Totals;
+
+// Add one thread's counts to the totals.  The thread may be writing to its
+// counts meanwhile, so each is read only once.
+static void add_counters(Totals * totals, const GCU_Memory_Counters * counters) {
+  size_t peak = gcu_memory_count_get(&counters->peak_bytes);
+  totals->allocations += gcu_memory_count_get(&counters->allocations);
+  totals->frees += gcu_memory_count_get(&counters->frees);
+  totals->reallocations += gcu_memory_count_get(&counters->reallocations);
+  totals->allocated_bytes += gcu_memory_count_get(&counters->allocated_bytes);
+  totals->freed_bytes += gcu_memory_count_get(&counters->freed_bytes);
+  totals->peak_bytes += (ptrdiff_t)peak > 0
+    ? peak
+    : 0;
+}
+
+// Add up the counts of every thread.
+static Totals sum(void) {
+  Totals totals = {0};
+  acquire();
+  for (GCU_Memory_Counters * counters = all_counters; counters; counters = counters->next) {
+    add_counters(&totals, counters);
+  }
+  release();
+  add_counters(&totals, &fallback_counters);
+  return totals;
+}
+
+// Set one thread's counts to zero.
+static void reset_counters(GCU_Memory_Counters * counters) {
+  gcu_memory_count_set(&counters->allocations, 0);
+  gcu_memory_count_set(&counters->frees, 0);
+  gcu_memory_count_set(&counters->reallocations, 0);
+  gcu_memory_count_set(&counters->allocated_bytes, 0);
+  gcu_memory_count_set(&counters->freed_bytes, 0);
+  gcu_memory_count_set(&counters->peak_bytes, 0);
+}
+
+//
+// Tracing.
+//
+// A trace file starts with a header, followed by records.  A record which
+// names a file is followed by the name.  Every other record is one call.
+//
+
+// The operations which are recorded.
+enum {
+  OP_MALLOC = 1,
+  OP_CALLOC,
+  OP_REALLOC,
+  OP_FREE,
+  OP_NAME,
+};
+
+#define TRACE_MAGIC "GCUTRACE"
+#define TRACE_VERSION 1
+
+typedef struct {
+  char magic[8];               // TRACE_MAGIC.
+  uint32_t version;            // TRACE_VERSION.
+  uint32_t record_size;        // sizeof(Record).
+} Header;
+
+typedef struct {
+  uint64_t timestamp;          // Nanoseconds since the trace started.
+  uint64_t pointer;            // The memory returned, or freed.
+  uint64_t previous;           // The memory passed to realloc().
+  uint64_t size;               // The bytes requested (of each item, for
+                               //   calloc()), or the length of a name.
+  uint64_t nitems;             // The items requested from calloc().
+  uint64_t file;               // The calling file: its name while buffered,
+                               //   and its id in the trace file.
+  uint32_t line;               // The calling line.
+  uint32_t thread;             // The calling thread.
+  uint32_t sequence;           // The order of the record in its thread.
+  uint32_t op;                 // One of the OP_* values.
+} Record;
+
+// The records which each thread can buffer before it must wait for the
+// writer.  The writer empties every buffer once per millisecond, or sooner
+// when a buffer is half full.
+#define RING_RECORDS 16384
+
+//
+// A thread's buffer, which only that thread adds to and only the writer
+// takes from.
+//
+typedef struct Ring {
+  struct Ring * next;          // The next buffer, of any thread.
+  bool in_use;                 // Whether a thread owns the buffer.  Guarded
+                               //   by `lock`.
+  char pad1[CACHE_LINE_BYTES];
+  atomic_size_t head;          // The next record to write to the file.
+  char pad2[CACHE_LINE_BYTES];
+  atomic_size_t tail;          // The next record to fill.
+  char pad3[CACHE_LINE_BYTES];
+  Record records[RING_RECORDS];
+} Ring;
+
+static _Thread_local Ring * ring = 0;
+static _Thread_local uint32_t thread_id = 0;
+static atomic_uint next_thread_id = 1;
+static Ring * all_rings = 0;
+
+// The state of the running trace, which only the starting and stopping
+// threads and the writer touch.
+static atomic_bool tracing = false;
+static atomic_bool writing = false;
+static FILE * trace_file = 0;
+static GCU_Thread writer;
+static GCU_Semaphore wake_writer;
+static uint64_t trace_start;
+
+// The names written so far, by the address of their `__FILE__` string.  The
+// name with id `i + 1` is `names[i]`.  Id 0 is written when the trace starts,
+// for calls whose name could not be remembered.
+static const char ** names = 0;
+static size_t name_count = 0;
+#define UNKNOWN_NAME "(unknown)"
+
+// The calls which were not recorded, because the writer had stopped while
+// their buffer was full.
+static atomic_size_t dropped = 0;
+
+static uint64_t now(void) {
+#ifdef _WIN32
+  LARGE_INTEGER counter;
+  LARGE_INTEGER frequency;
+  QueryPerformanceCounter(&counter);
+  QueryPerformanceFrequency(&frequency);
+  return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (uint64_t)time.tv_sec * 1000000000u + (uint64_t)time.tv_nsec;
+#endif
+}
+
+static void release_ring(void) {
+  if (ring) {
+    acquire();
+    ring->in_use = false;
+    release();
+    ring = 0;
+  }
+}
+
+// Give the calling thread a buffer, reusing one whose thread has exited.
+static Ring * claim_ring(void) {
+  acquire();
+  Ring * claimed = all_rings;
+  while (claimed && claimed->in_use) {
+    claimed = claimed->next;
+  }
+  if (claimed) {
+    claimed->in_use = true;
+  }
+  release();
+
+  if (!claimed) {
+    claimed = calloc(1, sizeof(Ring));
+    if (!claimed) {
+      return 0;
+    }
+    claimed->in_use = true;
+    acquire();
+    claimed->next = all_rings;
+    all_rings = claimed;
+    release();
+  }
+  if (!thread_id) {
+    thread_id = atomic_fetch_add_explicit(&next_thread_id, 1, memory_order_relaxed);
+  }
+  ring = claimed;
+  return claimed;
+}
+
+// Add a record to the calling thread's buffer.
+static void record(uint32_t op, const void * pointer, uint64_t previous, size_t nitems, size_t size, const char * file, size_t line) {
+  Ring * buffer = ring
+    ? ring
+    : claim_ring();
+  if (!buffer) {
+    return;
+  }
+  size_t tail = atomic_load_explicit(&buffer->tail, memory_order_relaxed);
+  size_t used = tail - atomic_load_explicit(&buffer->head, memory_order_acquire);
+  if (used == RING_RECORDS / 2) {
+    gcu_semaphore_signal(&wake_writer);
+  }
+  while (used == RING_RECORDS) {
+    // The writer has fallen behind.  Once it has stopped, nothing will make
+    // room, so the call is dropped.
+    if (!atomic_load_explicit(&writing, memory_order_acquire)) {
+      atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+      return;
+    }
+    gcu_thread_yield();
+    used = tail - atomic_load_explicit(&buffer->head, memory_order_acquire);
+  }
+  buffer->records[tail % RING_RECORDS] = (Record){
+    .timestamp = now() - trace_start,
+    .pointer = (uint64_t)(uintptr_t)pointer,
+    .previous = previous,
+    .size = size,
+    .nitems = nitems,
+    .file = (uint64_t)(uintptr_t)file,
+    .line = (uint32_t)line,
+    .thread = thread_id,
+    .sequence = (uint32_t)tail,
+    .op = op,
+  };
+  atomic_store_explicit(&buffer->tail, tail + 1, memory_order_release);
+}
+
+// Write a file name to the trace, with the given id.
+static void write_name(const char * name, uint64_t id) {
+  Record record = {
+    .size = strlen(name),
+    .file = id,
+    .op = OP_NAME,
+  };
+  fwrite(&record, sizeof(record), 1, trace_file);
+  fwrite(name, 1, record.size, trace_file);
+}
+
+// Get the id of a file name, writing the name to the trace the first time
+// that it is seen.  If the name cannot be remembered, the call is kept, with
+// the unknown name.
+static uint64_t name_id(const char * name) {
+  // Calls tend to come from the same file as the call before.
+  static size_t last = 0;
+  if (last < name_count && names[last] == name) {
+    return last + 1;
+  }
+  for (size_t i = 0; i < name_count; ++i) {
+    if (names[i] == name) {
+      last = i;
+      return last + 1;
+    }
+  }
+  const char ** grown = realloc(names, (name_count + 1) * sizeof(const char *));
+  if (!grown) {
+    return 0;
+  }
+  names = grown;
+  names[name_count] = name;
+  write_name(name, name_count + 1);
+  last = name_count++;
+  return last + 1;
+}
+
+// Write everything which has been buffered to the trace file.
+static void drain_rings(void) {
+  acquire();
+  Ring * first = all_rings;
+  release();
+
+  // Buffers are only ever added to the front of the list, so the rest of
+  // the list may be walked without the lock.
+  for (Ring * buffer = first; buffer; buffer = buffer->next) {
+    size_t head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&buffer->tail, memory_order_acquire);
+    while (head != tail) {
+      // Write the records up to the end of the buffer (or the tail) at once,
+      // naming their files in place, since the thread will not touch them
+      // until `head` moves past them.
+      Record * records = &buffer->records[head % RING_RECORDS];
+      size_t count = RING_RECORDS - head % RING_RECORDS;
+      if (count > tail - head) {
+        count = tail - head;
+      }
+      for (size_t i = 0; i < count; ++i) {
+        records[i].file = name_id((const char *)(uintptr_t)records[i].file);
+      }
+      fwrite(records, sizeof(Record), count, trace_file);
+      head += count;
+    }
+    atomic_store_explicit(&buffer->head, head, memory_order_release);
+  }
+  fflush(trace_file);
+}
+
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION write_trace(GCU_THREAD_FUNC_ARG_T arg) {
+  (void)arg;
+  while (atomic_load_explicit(&writing, memory_order_acquire)) {
+    drain_rings();
+    gcu_semaphore_timedwait(&wake_writer, 1);
+  }
+  return 0;
+}
+
+bool gcu_mem_trace_start(const char * path) {
+  if (trace_file) {
+    return false;
+  }
+  trace_file = fopen(path, "wb");
+  if (!trace_file) {
+    return false;
+  }
+  Header header = {
+    .magic = TRACE_MAGIC,
+    .version = TRACE_VERSION,
+    .record_size = sizeof(Record),
+  };
+  fwrite(&header, sizeof(header), 1, trace_file);
+  write_name(UNKNOWN_NAME, 0);
+  atomic_store_explicit(&dropped, 0, memory_order_relaxed);
+
+  // Anything left from an earlier trace is dropped.
+  acquire();
+  for (Ring * buffer = all_rings; buffer; buffer = buffer->next) {
+    atomic_store_explicit(&buffer->head, atomic_load_explicit(&buffer->tail, memory_order_acquire), memory_order_release);
+  }
+  release();
+
+  trace_start = now();
+  atomic_store_explicit(&writing, true, memory_order_release);
+  if (gcu_semaphore_create(&wake_writer, 0)) {
+    fclose(trace_file);
+    trace_file = 0;
+    return false;
+  }
+  if (gcu_thread_create(&writer, write_trace, 0)) {
+    atomic_store_explicit(&writing, false, memory_order_release);
+    gcu_semaphore_destroy(&wake_writer);
+    fclose(trace_file);
+    trace_file = 0;
+    return false;
+  }
+  atomic_store_explicit(&tracing, true, memory_order_release);
+  return true;
+}
+
+void gcu_mem_trace_stop(void) {
+  if (!trace_file) {
+    return;
+  }
+  atomic_store_explicit(&tracing, false, memory_order_release);
+  atomic_store_explicit(&writing, false, memory_order_release);
+  gcu_semaphore_signal(&wake_writer);
+  gcu_thread_join(writer);
+  gcu_semaphore_destroy(&wake_writer);
+  drain_rings();
+  fclose(trace_file);
+  trace_file = 0;
+  free(names);
+  names = 0;
+  name_count = 0;
+}
+
+size_t gcu_mem_trace_dropped(void) {
+  return atomic_load_explicit(&dropped, memory_order_relaxed);
+}
+
+// A trace file, read into memory.
+typedef struct {
+  Record * records;            // The calls, in the order they were made.
+  size_t count;
+  char ** names;               // The file names, by id.
+  size_t name_count;
+} Trace;
+
+static void trace_destroy(Trace * trace) {
+  for (size_t i = 0; i < trace->name_count; ++i) {
+    gcu_free(trace->names[i]);
+  }
+  gcu_free(trace->names);
+  gcu_free(trace->records);
+}
+
+static int compare_records(const void * a, const void * b) {
+  const Record * left = a;
+  const Record * right = b;
+  if (left->timestamp != right->timestamp) {
+    return left->timestamp < right->timestamp ? -1 : 1;
+  }
+  if (left->thread != right->thread) {
+    return left->thread < right->thread ? -1 : 1;
+  }
+  return (int32_t)(left->sequence - right->sequence) < 0
+    ? -1
+    : left->sequence != right->sequence;
+}
+
+// Read a trace file, sorting its calls into the order they were made.
+static bool trace_read(FILE * file, Trace * trace) {
+  *trace = (Trace){0};
+  Header header;
+  if (fread(&header, sizeof(header), 1, file) != 1
+    || memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic))
+    || header.version != TRACE_VERSION
+    || header.record_size != sizeof(Record)) {
+    return false;
+  }
+  size_t capacity = 0;
+  Record record;
+  while (fread(&record, sizeof(record), 1, file) == 1) {
+    if (record.op == OP_NAME) {
+      if (record.file != trace->name_count) {
+        break;
+      }
+      char ** grown = gcu_realloc(trace->names, (trace->name_count + 1) * sizeof(char *));
+      char * name = gcu_malloc(record.size + 1);
+      if (grown) {
+        trace->names = grown;
+      }
+      if (!grown || !name || fread(name, 1, record.size, file) != record.size) {
+        gcu_free(name);
+        break;
+      }
+      name[record.size] = 0;
+      trace->names[trace->name_count++] = name;
+      continue;
+    }
+    if (record.file >= trace->name_count) {
+      break;
+    }
+    if (trace->count == capacity) {
+      capacity = capacity
+        ? capacity * 2
+        : 1024;
+      Record * grown = gcu_realloc(trace->records, capacity * sizeof(Record));
+      if (!grown) {
+        break;
+      }
+      trace->records = grown;
+    }
+    trace->records[trace->count++] = record;
+  }
+  if (!feof(file)) {
+    trace_destroy(trace);
+    return false;
+  }
+  if (trace->count) {
+    qsort(trace->records, trace->count, sizeof(Record), compare_records);
+  }
+  return true;
+}
+
+bool gcu_mem_trace_decode(FILE * file, FILE * out) {
+  Trace trace;
+  if (!trace_read(file, &trace)) {
+    return false;
+  }
+  size_t allocations = 0;
+  size_t frees = 0;
+  for (size_t i = 0; i < trace.count; ++i) {
+    Record * r = &trace.records[i];
+    void * pointer = (void *)(uintptr_t)r->pointer;
+    const char * name = trace.names[r->file];
+    switch (r->op) {
+      case OP_MALLOC:
+        fprintf(out, "malloc  | %zd | %p:%zu | %s(%zu)\n", ++allocations, pointer, (size_t)r->size, name, (size_t)r->line);
+        break;
+      case OP_CALLOC:
+        fprintf(out, "calloc  | %zd | %p:%zu:%zu | %s(%zu)\n", ++allocations, pointer, (size_t)r->nitems, (size_t)r->size, name, (size_t)r->line);
+        break;
+      case OP_REALLOC:
+        fprintf(out, "realloc | %p:%zu -> %p | %s(%zu)\n", (void *)(uintptr_t)r->previous, (size_t)r->size, pointer, name, (size_t)r->line);
+        break;
+      case OP_FREE:
+        fprintf(out, "free    | %zd | %p | %s(%zu)\n", ++frees, pointer, name, (size_t)r->line);
+        break;
+    }
+  }
+  trace_destroy(&trace);
+  return true;
+}
+
+// Order leaked blocks by the location which allocated them.
+static int compare_locations(const void * a, const void * b) {
+  const Record * left = *(const Record * const *)a;
+  const Record * right = *(const Record * const *)b;
+  if (left->file != right->file) {
+    return left->file < right->file ? -1 : 1;
+  }
+  return left->line < right->line
+    ? -1
+    : left->line != right->line;
+}
+
+//
+// The live blocks of a trace, by the index of the record which allocated
+// them, in a table which is open-addressed by address.  A block which is
+// removed has the blocks after it shifted back, so that no slot is left
+// marked as removed.
+//
+typedef struct {
+  uint64_t pointer;       // The address of the block, or 0 if the slot is
+                          //   empty.
+  size_t record;          // The index of the record which allocated it.
+} Live;
+
+typedef struct {
+  Live * slots;           // The slots.
+  size_t capacity;        // The number of slots, a power of two.
+  size_t count;           // The number of blocks.
+} Live_Table;
+
+// The slot at which to start looking for a block.
+static inline size_t live_home(const Live_Table * table, uint64_t pointer) {
+  uint64_t hash = pointer * 0x9E3779B97F4A7C15ull;
+  return (size_t)(hash ^ (hash >> 32)) & (table->capacity - 1);
+}
+
+// The slot which holds a block, or else the empty slot at which it would be
+// added.
+static size_t live_find(const Live_Table * table, uint64_t pointer) {
+  size_t i = live_home(table, pointer);
+  while (table->slots[i].pointer && table->slots[i].pointer != pointer) {
+    i = (i + 1) & (table->capacity - 1);
+  }
+  return i;
+}
+
+// Add a block, or replace the record of one already live at its address.
+static bool live_add(Live_Table * table, uint64_t pointer, size_t record) {
+  if ((table->count + 1) * 4 > table->capacity * 3) {
+    Live_Table grown = {
+      .slots = gcu_calloc(table->capacity * 2, sizeof(Live)),
+      .capacity = table->capacity * 2,
+      .count = table->count,
+    };
+    if (!grown.slots) {
+      return false;
+    }
+    for (size_t i = 0; i < table->capacity; ++i) {
+      if (table->slots[i].pointer) {
+        grown.slots[live_find(&grown, table->slots[i].pointer)] = table->slots[i];
+      }
+    }
+    gcu_free(table->slots);
+    *table = grown;
+  }
+  size_t i = live_find(table, pointer);
+  table->count += !table->slots[i].pointer;
+  table->slots[i] = (Live) {
+    .pointer = pointer,
+    .record = record,
+  };
+  return true;
+}
+
+// Remove the block in slot `i`.
+static void live_remove(Live_Table * table, size_t i) {
+  size_t mask = table->capacity - 1;
+  for (size_t j = (i + 1) & mask; table->slots[j].pointer; j = (j + 1) & mask) {
+    // The block in slot `j` moves into the gap unless its home lies
+    // cyclically after the gap, up to `j`.
+    size_t home = live_home(table, table->slots[j].pointer);
+    if (((j - home) & mask) >= ((j - i) & mask)) {
+      table->slots[i] = table->slots[j];
+      i = j;
+    }
+  }
+  table->slots[i].pointer = 0;
+  --table->count;
+}
+
+bool gcu_mem_trace_report(FILE * file, FILE * out) {
+  Trace trace;
+  if (!trace_read(file, &trace)) {
+    return false;
+  }
+
+  // Track the live blocks, by the index of the record which allocated them.
+  Live_Table live = {
+    .slots = gcu_calloc(64, sizeof(Live)),
+    .capacity = 64,
+    .count = 0,
+  };
+  if (!live.slots) {
+    trace_destroy(&trace);
+    return false;
+  }
+  size_t bytes = 0;
+  size_t peak = 0;
+  size_t peak_blocks = 0;
+  uint64_t peak_time = 0;
+  size_t allocations = 0;
+  size_t frees = 0;
+  for (size_t i = 0; i < trace.count; ++i) {
+    Record * r = &trace.records[i];
+    if (r->op == OP_REALLOC || r->op == OP_FREE) {
+      uint64_t freed = r->op == OP_FREE
+        ? r->pointer
+        : r->previous;
+      size_t slot = freed
+        ? live_find(&live, freed)
+        : 0;
+      if (freed && live.slots[slot].pointer) {
+        Record * allocated = &trace.records[live.slots[slot].record];
+        bytes -= allocated->size * (allocated->op == OP_CALLOC ? allocated->nitems : 1);
+        live_remove(&live, slot);
+      }
+      frees += r->op == OP_FREE;
+    }
+    if (r->op != OP_FREE && r->pointer) {
+      if (!live_add(&live, r->pointer, i)) {
+        gcu_free(live.slots);
+        trace_destroy(&trace);
+        return false;
+      }
+      bytes += r->size * (r->op == OP_CALLOC ? r->nitems : 1);
+      allocations += r->op != OP_REALLOC;
+      if (bytes > peak) {
+        peak = bytes;
+        peak_blocks = live.count;
+        peak_time = r->timestamp;
+      }
+    }
+  }
+  fprintf(out, "peak    | %zu bytes in %zu blocks | %.3f ms\n", peak, peak_blocks, (double)peak_time / 1e6);
+
+  // Group what was never freed by the location which allocated it.
+  Record ** leaks = gcu_malloc((live.count ? live.count : 1) * sizeof(Record *));
+  if (!leaks) {
+    gcu_free(live.slots);
+    trace_destroy(&trace);
+    return false;
+  }
+  size_t count = 0;
+  for (size_t i = 0; i < live.capacity; ++i) {
+    if (live.slots[i].pointer) {
+      leaks[count++] = &trace.records[live.slots[i].record];
+    }
+  }
+  qsort(leaks, count, sizeof(Record *), compare_locations);
+  for (size_t i = 0; i < count;) {
+    size_t blocks = 0;
+    size_t leaked_bytes = 0;
+    size_t j = i;
+    for (; j < count && !compare_locations(&leaks[i], &leaks[j]); ++j) {
+      ++blocks;
+      leaked_bytes += leaks[j]->size * (leaks[j]->op == OP_CALLOC ? leaks[j]->nitems : 1);
+    }
+    fprintf(out, "leak    | %zu bytes in %zu blocks | %s(%zu)\n", leaked_bytes, blocks, trace.names[leaks[i]->file], (size_t)leaks[i]->line);
+    i = j;
+  }
+  fprintf(out, "total   | %zu allocations | %zu frees | %zu bytes in %zu blocks not freed\n", allocations, frees, bytes, count);
+
+  gcu_free(leaks);
+  gcu_free(live.slots);
+  trace_destroy(&trace);
+  return true;
+}
+
+//
+// Profiling.
+//
+// Allocations are remembered by address in `blocks`, and their totals are
+// kept by calling location in `sites`.  Both are split into shards, each an
+// open-addressed table with its own lock.
+//
+
+// The number of size classes in a site's histogram: up to 16 bytes, up to
+// 32 bytes, and so on, with the last holding everything larger.
+#define SIZE_CLASSES 16
+
+// The totals for one calling location.  Restarting the profile frees every
+// site, so sites are only touched with their shard locked, and blocks name
+// theirs by location rather than pointing to it.
+typedef struct {
+  const char * file;
+  size_t line;
+  size_t allocations;
+  size_t frees;
+  size_t live_bytes;
+  size_t peak_bytes;
+  size_t sizes[SIZE_CLASSES];
+} Site;
+
+// A live allocation.
+typedef struct {
+  uintptr_t pointer;           // 0 if the slot is empty.
+  size_t size;
+  const char * file;           // The location of its site.
+  size_t line;
+} Block;
+
+#define SHARDS 64
+
+// One shard of a table.  `slots` is an array of `Block` or of `Site *`.
+typedef struct {
+  atomic_flag lock;
+  size_t count;
+  size_t capacity;             // A power of two, or 0.
+  void * slots;
+  char pad[CACHE_LINE_BYTES];
+} Shard;
+
+static Shard blocks[SHARDS];
+static Shard sites[SHARDS];
+static atomic_bool profiling = false;
+static bool report_at_exit = false;
+
+static void lock_shard(Shard * shard) {
+  while (atomic_flag_test_and_set_explicit(&shard->lock, memory_order_acquire)) {
+    // The holder may have been descheduled.
+    gcu_thread_yield();
+  }
+}
+
+static void unlock_shard(Shard * shard) {
+  atomic_flag_clear_explicit(&shard->lock, memory_order_release);
+}
+
+// Spread an address or a location across the shards and the slots.
+static inline uint64_t mix(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xFF51AFD7ED558CCDull;
+  key ^= key >> 33;
+  return key;
+}
+
+static inline uint64_t site_key(const char * file, size_t line) {
+  return mix((uint64_t)(uintptr_t)file ^ ((uint64_t)line << 40));
+}
+
+// Find a site, adding it if it is new and `add` is set.  The shard is locked.
+static Site * find_site(Shard * shard, uint64_t key, const char * file, size_t line, bool add) {
+  Site ** slots = shard->slots;
+  if (shard->capacity) {
+    for (size_t i = (key >> 6) & (shard->capacity - 1); slots[i]; i = (i + 1) & (shard->capacity - 1)) {
+      if (slots[i]->file == file && slots[i]->line == line) {
+        return slots[i];
+      }
+    }
+  }
+  if (!add) {
+    return 0;
+  }
+
+  if ((shard->count + 1) * 4 > shard->capacity * 3) {
+    size_t capacity = shard->capacity
+      ? shard->capacity * 2
+      : 16;
+    Site ** grown = calloc(capacity, sizeof(Site *));
+    if (!grown) {
+      return 0;
+    }
+    for (size_t i = 0; i < shard->capacity; ++i) {
+      if (slots[i]) {
+        size_t j = (site_key(slots[i]->file, slots[i]->line) >> 6) & (capacity - 1);
+        while (grown[j]) {
+          j = (j + 1) & (capacity - 1);
+        }
+        grown[j] = slots[i];
+      }
+    }
+    free(slots);
+    shard->slots = slots = grown;
+    shard->capacity = capacity;
+  }
+  Site * site = calloc(1, sizeof(Site));
+  if (!site) {
+    return 0;
+  }
+  site->file = file;
+  site->line = line;
+  size_t i = (key >> 6) & (shard->capacity - 1);
+  while (slots[i]) {
+    i = (i + 1) & (shard->capacity - 1);
+  }
+  slots[i] = site;
+  ++shard->count;
+  return site;
+}
+
+// Add a block.  The shard is locked.
+static bool add_block(Shard * shard, uint64_t key, Block block) {
+  if ((shard->count + 1) * 4 > shard->capacity * 3) {
+    size_t capacity = shard->capacity
+      ? shard->capacity * 2
+      : 256;
+    Block * grown = calloc(capacity, sizeof(Block));
+    if (!grown) {
+      return false;
+    }
+    Block * slots = shard->slots;
+    for (size_t i = 0; i < shard->capacity; ++i) {
+      if (slots[i].pointer) {
+        size_t j = (mix(slots[i].pointer) >> 6) & (capacity - 1);
+        while (grown[j].pointer) {
+          j = (j + 1) & (capacity - 1);
+        }
+        grown[j] = slots[i];
+      }
+    }
+    free(slots);
+    shard->slots = grown;
+    shard->capacity = capacity;
+  }
+  Block * slots = shard->slots;
+  size_t i = (key >> 6) & (shard->capacity - 1);
+  while (slots[i].pointer) {
+    i = (i + 1) & (shard->capacity - 1);
+  }
+  slots[i] = block;
+  ++shard->count;
+  return true;
+}
+
+// Remove a block, returning it (or an empty block if it is not known).  The
+// shard is locked.
+static Block remove_block(Shard * shard, uint64_t key, uintptr_t pointer) {
+  Block found = {0};
+  if (!shard->capacity) {
+    return found;
+  }
+  Block * slots = shard->slots;
+  size_t mask = shard->capacity - 1;
+  size_t i = (key >> 6) & mask;
+  while (slots[i].pointer != pointer) {
+    if (!slots[i].pointer) {
+      return found;
+    }
+    i = (i + 1) & mask;
+  }
+  found = slots[i];
+
+  // Shift later blocks back, so that no lookup stops early at the hole.
+  for (size_t j = (i + 1) & mask; slots[j].pointer; j = (j + 1) & mask) {
+    size_t home = (mix(slots[j].pointer) >> 6) & mask;
+    if (((j - home) & mask) >= ((j - i) & mask)) {
+      slots[i] = slots[j];
+      i = j;
+    }
+  }
+  slots[i] = (Block){0};
+  --shard->count;
+  return found;
+}
+
+static void profile_allocate(const void * pointer, size_t size, const char * file, size_t line) {
+  uint64_t key = site_key(file, line);
+  Shard * shard = &sites[key % SHARDS];
+  lock_shard(shard);
+  Site * site = find_site(shard, key, file, line, true);
+  if (site) {
+    size_t class = 0;
+    while (class < SIZE_CLASSES - 1 && ((size_t)16 << class) < size) {
+      ++class;
+    }
+    ++site->allocations;
+    ++site->sizes[class];
+    site->live_bytes += size;
+    if (site->live_bytes > site->peak_bytes) {
+      site->peak_bytes = site->live_bytes;
+    }
+  }
+  unlock_shard(shard);
+  if (!site) {
+    return;
+  }
+
+  uint64_t block_key = mix((uint64_t)(uintptr_t)pointer);
+  Shard * block_shard = &blocks[block_key % SHARDS];
+  lock_shard(block_shard);
+  bool added = add_block(block_shard, block_key, (Block){(uintptr_t)pointer, size, file, line});
+  unlock_shard(block_shard);
+
+  if (!added) {
+    // The block cannot be remembered, so do not count it as live.
+    lock_shard(shard);
+    site = find_site(shard, key, file, line, false);
+    if (site) {
+      site->live_bytes -= size;
+    }
+    unlock_shard(shard);
+  }
+}
+
+static void profile_free(uintptr_t pointer) {
+  uint64_t key = mix(pointer);
+  Shard * shard = &blocks[key % SHARDS];
+  lock_shard(shard);
+  Block block = remove_block(shard, key, pointer);
+  unlock_shard(shard);
+  if (!block.pointer) {
+    return;
+  }
+
+  // The site is looked up again, with its shard locked, since the profile
+  // may have been restarted since the block was allocated.  In that case the
+  // site is gone, or is a new one which never counted the block.
+  key = site_key(block.file, block.line);
+  shard = &sites[key % SHARDS];
+  lock_shard(shard);
+  Site * site = find_site(shard, key, block.file, block.line, false);
+  if (site && site->live_bytes >= block.size) {
+    ++site->frees;
+    site->live_bytes -= block.size;
+  }
+  unlock_shard(shard);
+}
+
+// Discard every site and block.
+static void profile_clear(void) {
+  for (size_t i = 0; i < SHARDS; ++i) {
+    lock_shard(&sites[i]);
+    Site ** slots = sites[i].slots;
+    for (size_t j = 0; j < sites[i].capacity; ++j) {
+      free(slots[j]);
+    }
+    free(slots);
+    sites[i].slots = 0;
+    sites[i].capacity = 0;
+    sites[i].count = 0;
+    unlock_shard(&sites[i]);
+
+    lock_shard(&blocks[i]);
+    free(blocks[i].slots);
+    blocks[i].slots = 0;
+    blocks[i].capacity = 0;
+    blocks[i].count = 0;
+    unlock_shard(&blocks[i]);
+  }
+}
+
+static int compare_sites(const void * a, const void * b) {
+  const Site * left = a;
+  const Site * right = b;
+  if (left->live_bytes != right->live_bytes) {
+    return left->live_bytes > right->live_bytes ? -1 : 1;
+  }
+  if (left->peak_bytes != right->peak_bytes) {
+    return left->peak_bytes > right->peak_bytes ? -1 : 1;
+  }
+  int name = strcmp(left->file, right->file);
+  return name
+    ? name
+    : (left->line > right->line) - (left->line < right->line);
+}
+
+// Copy every site, sorted for the report.
+static Site * copy_sites(size_t * count) {
+  *count = 0;
+  for (size_t i = 0; i < SHARDS; ++i) {
+    lock_shard(&sites[i]);
+    *count += sites[i].count;
+    unlock_shard(&sites[i]);
+  }
+  Site * copy = malloc((*count ? *count : 1) * sizeof(Site));
+  if (!copy) {
+    return 0;
+  }
+  size_t copied = 0;
+  for (size_t i = 0; i < SHARDS; ++i) {
+    lock_shard(&sites[i]);
+    Site ** slots = sites[i].slots;
+    for (size_t j = 0; j < sites[i].capacity && copied < *count; ++j) {
+      if (slots[j]) {
+        copy[copied++] = *slots[j];
+      }
+    }
+    unlock_shard(&sites[i]);
+  }
+  *count = copied;
+  qsort(copy, copied, sizeof(Site), compare_sites);
+  return copy;
+}
+
+static void report_leaks(void) {
+  if (!report_at_exit) {
+    return;
+  }
+  size_t count;
+  Site * copy = copy_sites(&count);
+  if (!copy) {
+    return;
+  }
+  for (size_t i = 0; i < count && copy[i].live_bytes; ++i) {
+    fprintf(stderr, "leak    | %zu bytes in %zu blocks | %s(%zu)\n", copy[i].live_bytes, copy[i].allocations - copy[i].frees, copy[i].file, copy[i].line);
+  }
+  free(copy);
+}
+
+bool gcu_mem_profile_start(bool report_leaks_at_exit) {
+  static bool registered = false;
+  atomic_store_explicit(&profiling, false, memory_order_release);
+  profile_clear();
+  if (report_leaks_at_exit && !registered) {
+    if (atexit(report_leaks)) {
+      return false;
+    }
+    registered = true;
+  }
+  report_at_exit = report_leaks_at_exit;
+  atomic_store_explicit(&profiling, true, memory_order_release);
+  return true;
+}
+
+void gcu_mem_profile_stop(void) {
+  atomic_store_explicit(&profiling, false, memory_order_release);
+}
+
+void gcu_mem_report(FILE * out) {
+  size_t count;
+  Site * copy = copy_sites(&count);
+  if (!copy) {
+    return;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    Site * site = &copy[i];
+    fprintf(out, "%s(%zu) | %zu allocations | %zu frees | %zu live bytes | %zu peak bytes | sizes", site->file, site->line, site->allocations, site->frees, site->live_bytes, site->peak_bytes);
+    for (size_t class = 0; class < SIZE_CLASSES; ++class) {
+      if (site->sizes[class]) {
+        if (class < SIZE_CLASSES - 1) {
+          fprintf(out, " <=%zu:%zu", (size_t)16 << class, site->sizes[class]);
+        }
+        else {
+          fprintf(out, " >%zu:%zu", (size_t)16 << (class - 1), site->sizes[class]);
+        }
+      }
+    }
+    fprintf(out, "\n");
+  }
+  free(copy);
+}
 
 /// @cond HIDDEN_SYMBOLS
 void * gcu_malloc_debug(size_t size, const char * file, size_t line) {
-  ++gcu_memory_alloc_count;
-  void * result = malloc(size);
-  if (capture) {
-    fprintf(stderr, "malloc  | %zd | %p:%zu | %s(%zu)\n", gcu_memory_alloc_count, result, size, file, line);
+  void * result = gcu_allocator_allocate(gcu_allocator, size);
+  if (result && atomic_load_explicit(&profiling, memory_order_relaxed)) {
+    profile_allocate(result, size, file, line);
+  }
+  if (capture && atomic_load_explicit(&tracing, memory_order_relaxed)) {
+    record(OP_MALLOC, result, 0, 1, size, file, line);
+  }
+  else if (capture) {
+    fprintf(stderr, "malloc  | %zd | %p:%zu | %s(%zu)\n", gcu_get_alloc_count(), result, size, file, line);
   }
   return result;
 }
 
 void * gcu_calloc_debug(size_t nitems, size_t size, const char * file, size_t line) {
-  ++gcu_memory_alloc_count;
-  void * result = calloc(nitems, size);
-  if (capture) {
-    fprintf(stderr, "calloc  | %zd | %p:%zu:%zu | %s(%zu)\n", gcu_memory_alloc_count, result, nitems, size, file, line);
+  void * result = gcu_allocator_allocate_zeroed(gcu_allocator, nitems, size);
+  if (result && atomic_load_explicit(&profiling, memory_order_relaxed)) {
+    profile_allocate(result, nitems * size, file, line);
+  }
+  if (capture && atomic_load_explicit(&tracing, memory_order_relaxed)) {
+    record(OP_CALLOC, result, 0, nitems, size, file, line);
+  }
+  else if (capture) {
+    fprintf(stderr, "calloc  | %zd | %p:%zu:%zu | %s(%zu)\n", gcu_get_alloc_count(), result, nitems, size, file, line);
   }
   return result;
 }
@@ -34,25 +1263,52 @@ void * gcu_realloc_debug(void * pointer, size_t size, const char * file, size_t
   // Note: This is a bit of a hack.  We're using sprintf() to convert a pointer
   // to a string, simply because some compilers were complaining about a
   // possible "use after free" error when we tried to use the pointer directly
-  // in the fprintf() call (which was after the realloc() call).
+  // in the fprintf() call (which was after the realloc() call).  The traced
+  // copy is volatile for the same reason.
   char buffer[32];
-  if (capture) {
+  bool traced = capture && atomic_load_explicit(&tracing, memory_order_relaxed);
+  volatile uint64_t previous = (uint64_t)(uintptr_t)pointer;
+  if (capture && !traced) {
     snprintf(buffer, 32, "%p", pointer);
   }
 
-  void * result = realloc(pointer, size);
-  if (capture) {
+  // The block is forgotten before realloc() may give its address to another
+  // thread, and is charged to the location of the reallocation from then on.
+  bool profiled = atomic_load_explicit(&profiling, memory_order_relaxed);
+  if (profiled && pointer) {
+    profile_free((uintptr_t)pointer);
+  }
+
+  size_t before = gcu_allocator_usable_size(gcu_allocator, pointer);
+  void * result = gcu_allocator_reallocate(gcu_allocator, pointer, size);
+  if (profiled && result) {
+    profile_allocate(result, size, file, line);
+  }
+  else if (profiled && size && previous) {
+    // The original block is still allocated.
+    profile_allocate((const void *)(uintptr_t)previous, before, file, line);
+  }
+  if (traced) {
+    record(OP_REALLOC, result, previous, 1, size, file, line);
+  }
+  else if (capture) {
     fprintf(stderr, "realloc | %s:%zu -> %p | %s(%zu)\n", buffer, size, result, file, line);
   }
   return result;
 }
 
 void gcu_free_debug(void * pointer, const char * file, size_t line) {
-  ++gcu_memory_free_count;
-  if (capture) {
-    fprintf(stderr, "free    | %zd | %p | %s(%zu)\n", gcu_memory_free_count, pointer, file, line);
+  if (pointer && atomic_load_explicit(&profiling, memory_order_relaxed)) {
+    profile_free((uintptr_t)pointer);
   }
-  free(pointer);
+  if (capture && atomic_load_explicit(&tracing, memory_order_relaxed)) {
+    record(OP_FREE, pointer, 0, 0, 0, file, line);
+  }
+  else if (capture) {
+    // The free is counted when the block is given back, below.
+    fprintf(stderr, "free    | %zd | %p | %s(%zu)\n", gcu_get_free_count() + 1, pointer, file, line);
+  }
+  gcu_allocator_free(gcu_allocator, pointer);
 }
 /// @endcond
 
@@ -65,14 +1321,40 @@ void gcu_mem_stop(void) {
 }
 
 size_t gcu_get_alloc_count(void) {
-  return gcu_memory_alloc_count;
+  return sum().allocations;
 }
 
 size_t gcu_get_free_count(void) {
-  return gcu_memory_free_count;
+  return sum().frees;
+}
+
+size_t gcu_get_realloc_count(void) {
+  return sum().reallocations;
+}
+
+size_t gcu_get_live_bytes(void) {
+  Totals counters = sum();
+  return counters.allocated_bytes > counters.freed_bytes
+    ? counters.allocated_bytes - counters.freed_bytes
+    : 0;
+}
+
+size_t gcu_get_peak_bytes(void) {
+  // The live total is reached at once, so the peak is at least that.
+  Totals counters = sum();
+  size_t live = counters.allocated_bytes > counters.freed_bytes
+    ? counters.allocated_bytes - counters.freed_bytes
+    : 0;
+  return counters.peak_bytes > live
+    ? counters.peak_bytes
+    : live;
 }
 
 void gcu_memory_reset_counts(void) {
-  gcu_memory_alloc_count = 0;
-  gcu_memory_free_count = 0;
-}
\ No newline at end of file
+  acquire();
+  for (GCU_Memory_Counters * counters = all_counters; counters; counters = counters->next) {
+    reset_counters(counters);
+  }
+  release();
+  reset_counters(&fallback_counters);
+}
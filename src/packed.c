@@ -0,0 +1,557 @@
+/**
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <cutil/memory.h>
+#include <cutil/packed.h>
+#include <cutil/reduce.h>
+
+// Decoding is compiled several times, for increasingly wide instruction sets,
+// and the loader picks the widest one that the CPU supports.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__ELF__) && (__GNUC__ >= 11)
+#define SIMD_DISPATCH __attribute__((target_clones("default", "avx2", "arch=x86-64-v4")))
+#else
+#define SIMD_DISPATCH
+#endif
+
+#define BLOCK_SIZE GCU_PACKED64_BLOCK_SIZE
+
+// Number `i` of a block is at position `i / LANES` of lane `i % LANES`.  Each
+// lane packs its numbers into its own words, and the words of the lanes are
+// interleaved, so that the same shift and mask decodes one number of every
+// lane.
+#define LANES 4
+#define POSITIONS (BLOCK_SIZE / LANES)
+
+// GCC and Clang only vectorize half of each step of the unpack on their own,
+// so it is written with their vector extensions: one register holds the same
+// number of every lane.
+#if defined(__GNUC__)
+#define UNPACK_VECTOR
+typedef uint64_t UnpackLanes __attribute__((vector_size(LANES * sizeof(uint64_t))));
+#endif
+
+// The smallest number of blocks for which room is made.
+#define MINIMUM_BLOCKS 8
+
+// Get the number of bits needed to hold `value`.
+static inline unsigned bit_width(uint64_t value) {
+  return value
+    ? 64 - (unsigned)__builtin_clzll(value)
+    : 0;
+}
+
+// Get the largest number which fits in `bits` bits.
+static inline uint64_t bit_mask(unsigned bits) {
+  return bits >= 64
+    ? UINT64_MAX
+    : ((uint64_t)1 << bits) - 1;
+}
+
+// Get the number of words used by a block whose numbers are `bits` wide.
+static inline size_t block_words(unsigned bits) {
+  return LANES * (((size_t)bits * POSITIONS + 63) / 64);
+}
+
+// Get the number of values in a block.
+static inline size_t block_values(GCU_Packed64 * packed, size_t block) {
+  return block + 1 < packed->block_count
+    ? BLOCK_SIZE
+    : packed->count - block * BLOCK_SIZE;
+}
+
+// Get the largest value that a frame of reference block could hold.
+static inline uint64_t block_upper_bound(const GCU_Packed64_Block * block) {
+  uint64_t mask = bit_mask(block->bits);
+  return block->base > UINT64_MAX - mask
+    ? UINT64_MAX
+    : block->base + mask;
+}
+
+// OR `BLOCK_SIZE` numbers of `bits` bits into the (zeroed) words of a block.
+static void pack(uint64_t * restrict words, unsigned bits, const uint64_t * restrict numbers) {
+  if (!bits) {
+    return;
+  }
+  for (size_t position = 0; position < POSITIONS; ++position) {
+    size_t bit = position * bits;
+    unsigned shift = bit % 64;
+    uint64_t * low = words + (bit / 64) * LANES;
+    const uint64_t * lane = numbers + position * LANES;
+    for (size_t j = 0; j < LANES; ++j) {
+      low[j] |= lane[j] << shift;
+    }
+    if (shift + bits > 64) {
+      uint64_t * high = low + LANES;
+      for (size_t j = 0; j < LANES; ++j) {
+        high[j] |= lane[j] >> (64 - shift);
+      }
+    }
+  }
+}
+
+// Extract the `BLOCK_SIZE` numbers of `bits` bits from the words of a block,
+// adding `base` to each.
+SIMD_DISPATCH
+static void unpack(const uint64_t * restrict words, unsigned bits, uint64_t base, GCU_Type64_Union * restrict values) {
+  if (!bits) {
+    for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+      values[i].ui64 = base;
+    }
+    return;
+  }
+  uint64_t mask = bit_mask(bits);
+  for (size_t position = 0; position < POSITIONS; ++position) {
+    size_t bit = position * bits;
+    unsigned shift = bit % 64;
+    const uint64_t * low = words + (bit / 64) * LANES;
+    GCU_Type64_Union * lane = values + position * LANES;
+#ifdef UNPACK_VECTOR
+    UnpackLanes numbers;
+    memcpy(&numbers, low, sizeof(numbers));
+    numbers >>= shift;
+    if (shift + bits > 64) {
+      UnpackLanes high;
+      memcpy(&high, low + LANES, sizeof(high));
+      numbers |= high << (64 - shift);
+    }
+    numbers = (numbers & mask) + base;
+    memcpy(lane, &numbers, sizeof(numbers));
+#else
+    if (shift + bits > 64) {
+      const uint64_t * high = low + LANES;
+      for (size_t j = 0; j < LANES; ++j) {
+        lane[j].ui64 = (((low[j] >> shift) | (high[j] << (64 - shift))) & mask) + base;
+      }
+    }
+    else {
+      for (size_t j = 0; j < LANES; ++j) {
+        lane[j].ui64 = ((low[j] >> shift) & mask) + base;
+      }
+    }
+#endif
+  }
+}
+
+// Decode a block into `values`, which must have room for `BLOCK_SIZE` values.
+// Returns the number of values in the block.
+static size_t decode_block(GCU_Packed64 * packed, size_t block, GCU_Type64_Union * values) {
+  const GCU_Packed64_Block * header = &packed->blocks[block];
+  size_t count = block_values(packed, block);
+  if (header->encoding == GCU_PACKED64_FRAME_OF_REFERENCE) {
+    unpack(packed->words + header->start, header->bits, header->base, values);
+    return count;
+  }
+
+  // Adding the smallest difference to every number is folded into the unpack,
+  // which leaves only the running sum.  The first number is always zero.
+  unpack(packed->words + header->start, header->bits, header->delta, values);
+  uint64_t value = header->base;
+  values[0].ui64 = value;
+  for (size_t i = 1; i < count; ++i) {
+    value += values[i].ui64;
+    values[i].ui64 = value;
+  }
+  return count;
+}
+
+// Make room for `count` block headers.
+static bool reserve_blocks(GCU_Packed64 * packed, size_t count) {
+  if (count <= packed->block_capacity) {
+    return true;
+  }
+  size_t capacity = packed->block_capacity * 2;
+  if (capacity < count) {
+    capacity = count;
+  }
+  if (capacity < MINIMUM_BLOCKS) {
+    capacity = MINIMUM_BLOCKS;
+  }
+  if (capacity > SIZE_MAX / sizeof(GCU_Packed64_Block)) {
+    return false;
+  }
+  GCU_Packed64_Block * blocks = gcu_realloc(packed->blocks, capacity * sizeof(GCU_Packed64_Block));
+  if (!blocks) {
+    return false;
+  }
+  packed->blocks = blocks;
+  packed->block_capacity = capacity;
+  return true;
+}
+
+// Make room for `count` words of packed numbers.
+static bool reserve_words(GCU_Packed64 * packed, size_t count) {
+  if (count <= packed->word_capacity) {
+    return true;
+  }
+  size_t capacity = packed->word_capacity * 2;
+  if (capacity < count) {
+    capacity = count;
+  }
+  if (capacity > SIZE_MAX / sizeof(uint64_t)) {
+    return false;
+  }
+  uint64_t * words = gcu_realloc(packed->words, capacity * sizeof(uint64_t));
+  if (!words) {
+    return false;
+  }
+  packed->words = words;
+  packed->word_capacity = capacity;
+  return true;
+}
+
+// Encode up to `BLOCK_SIZE` values as a new block at the end.  Nothing is
+// changed if there is not enough memory.
+static bool encode_block(GCU_Packed64 * packed, const GCU_Type64_Union * values, size_t count) {
+  uint64_t min = UINT64_MAX;
+  uint64_t max = 0;
+  int64_t smallest = INT64_MAX;
+  int64_t largest = INT64_MIN;
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t value = values[i].ui64;
+    min = value < min ? value : min;
+    max = value > max ? value : max;
+    if (i) {
+      int64_t difference = (int64_t)(value - values[i - 1].ui64);
+      smallest = difference < smallest ? difference : smallest;
+      largest = difference > largest ? difference : largest;
+    }
+  }
+  unsigned reference_bits = bit_width(max - min);
+  unsigned delta_bits = count > 1
+    ? bit_width((uint64_t)largest - (uint64_t)smallest)
+    : 64;
+
+  // Unused numbers of a short block are zero.
+  uint64_t numbers[BLOCK_SIZE] = {0};
+  GCU_Packed64_Block block = {
+    .start = packed->word_count,
+  };
+  if (delta_bits < reference_bits) {
+    block.base = values[0].ui64;
+    block.delta = (uint64_t)smallest;
+    block.bits = (uint8_t)delta_bits;
+    block.encoding = GCU_PACKED64_DELTA;
+    for (size_t i = 1; i < count; ++i) {
+      numbers[i] = values[i].ui64 - values[i - 1].ui64 - block.delta;
+    }
+  }
+  else {
+    block.base = min;
+    block.delta = 0;
+    block.bits = (uint8_t)reference_bits;
+    block.encoding = GCU_PACKED64_FRAME_OF_REFERENCE;
+    for (size_t i = 0; i < count; ++i) {
+      numbers[i] = values[i].ui64 - min;
+    }
+  }
+
+  size_t words = block_words(block.bits);
+  if (!reserve_blocks(packed, packed->block_count + 1) || !reserve_words(packed, packed->word_count + words)) {
+    return false;
+  }
+  memset(packed->words + block.start, 0, words * sizeof(uint64_t));
+  pack(packed->words + block.start, block.bits, numbers);
+  packed->blocks[packed->block_count++] = block;
+  packed->word_count += words;
+  packed->count += count;
+  return true;
+}
+
+GCU_Packed64 * gcu_packed64_create(size_t count) {
+  // Malloc Zeroed-out memory.
+  GCU_Packed64 * packed = gcu_calloc(1, sizeof(GCU_Packed64));
+
+  // If the allocation failed, return null.
+  if (!packed) {
+    return 0;
+  }
+
+  if (!gcu_packed64_create_in_place(packed, count)) {
+    gcu_free(packed);
+    return 0;
+  }
+
+  return packed;
+}
+
+bool gcu_packed64_create_in_place(GCU_Packed64 * packed, size_t count) {
+  *packed = (GCU_Packed64) {
+    .count = 0,
+    .block_count = 0,
+    .block_capacity = 0,
+    .blocks = 0,
+    .word_count = 0,
+    .word_capacity = 0,
+    .words = 0,
+    .cleanup = 0,
+  };
+
+  // Reserve room for the block headers, if requested.  The size of the packed
+  // numbers is not known until they are encoded.
+  if (count) {
+    reserve_blocks(packed, (count + BLOCK_SIZE - 1) / BLOCK_SIZE);
+  }
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  // Allocate the mutex.
+  bool failure = GCU_MUTEX_CREATE(packed->mutex);
+
+  // If the allocation failed, clean up and return null.
+  if (failure) {
+    if (packed->blocks) {
+      gcu_free(packed->blocks);
+    }
+    return false;
+  }
+#endif
+
+  return true;
+}
+
+void gcu_packed64_destroy(GCU_Packed64 * packed) {
+  if (packed) {
+    gcu_packed64_destroy_in_place(packed);
+    gcu_free(packed);
+  }
+}
+
+void gcu_packed64_destroy_in_place(GCU_Packed64 * packed) {
+  // Verify that the pointer actually points to something.
+  if (packed) {
+    // Call the `cleanup` function, if it exists.
+    if (packed->cleanup) {
+      packed->cleanup(packed);
+    }
+
+    // Clean up the data if needed.
+    if (packed->blocks) {
+      gcu_free(packed->blocks);
+      packed->blocks = 0;
+    }
+    if (packed->words) {
+      gcu_free(packed->words);
+      packed->words = 0;
+    }
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+    GCU_MUTEX_DESTROY(packed->mutex);
+#endif
+  }
+}
+
+bool gcu_packed64_append_many(GCU_Packed64 * packed, const GCU_Type64_Union * values, size_t count) {
+  // Verify that the pointers actually point to something.
+  if (!packed || (count && !values)) {
+    return false;
+  }
+  if (!count) {
+    return true;
+  }
+
+  // Remember where the vector ends, so that it can be put back if there is
+  // not enough memory part of the way through.  A short last block is
+  // re-encoded in place, so its words are kept too.  No block takes more than
+  // `BLOCK_SIZE` words.
+  size_t old_count = packed->count;
+  size_t old_block_count = packed->block_count;
+  size_t old_word_count = packed->word_count;
+  GCU_Packed64_Block last = {0};
+  uint64_t last_words[BLOCK_SIZE];
+
+  // The headers of every block are reserved first, since their number is
+  // known.  Only the room for the packed numbers can still run out.
+  size_t tail = packed->count % BLOCK_SIZE;
+  if (!reserve_blocks(packed, (packed->count - tail) / BLOCK_SIZE + (tail + count + BLOCK_SIZE - 1) / BLOCK_SIZE)) {
+    return false;
+  }
+
+  // A short last block is decoded, and encoded again with the first of the new
+  // values.
+  if (tail) {
+    GCU_Type64_Union buffer[BLOCK_SIZE];
+    decode_block(packed, packed->block_count - 1, buffer);
+    size_t taken = count < BLOCK_SIZE - tail
+      ? count
+      : BLOCK_SIZE - tail;
+    memcpy(buffer + tail, values, taken * sizeof(GCU_Type64_Union));
+
+    last = packed->blocks[--packed->block_count];
+    memcpy(last_words, packed->words + last.start, block_words(last.bits) * sizeof(uint64_t));
+    packed->word_count = last.start;
+    packed->count -= tail;
+    if (!encode_block(packed, buffer, tail + taken)) {
+      goto FAIL_WORDS;
+    }
+    values += taken;
+    count -= taken;
+  }
+
+  while (count) {
+    size_t taken = count < BLOCK_SIZE
+      ? count
+      : BLOCK_SIZE;
+    if (!encode_block(packed, values, taken)) {
+      goto FAIL_WORDS;
+    }
+    values += taken;
+    count -= taken;
+  }
+  return true;
+
+FAIL_WORDS:
+  packed->count = old_count;
+  packed->block_count = old_block_count;
+  packed->word_count = old_word_count;
+  if (tail) {
+    packed->blocks[old_block_count - 1] = last;
+    memcpy(packed->words + last.start, last_words, block_words(last.bits) * sizeof(uint64_t));
+  }
+  return false;
+}
+
+size_t gcu_packed64_count(GCU_Packed64 * packed) {
+  return packed->count;
+}
+
+size_t gcu_packed64_size(GCU_Packed64 * packed) {
+  return packed->block_count * sizeof(GCU_Packed64_Block) + packed->word_count * sizeof(uint64_t);
+}
+
+GCU_Packed64_Value gcu_packed64_get(GCU_Packed64 * packed, size_t index) {
+  if (index >= packed->count) {
+    return (GCU_Packed64_Value){0};
+  }
+  size_t block = index / BLOCK_SIZE;
+  size_t i = index % BLOCK_SIZE;
+  const GCU_Packed64_Block * header = &packed->blocks[block];
+
+  // A delta block has to be summed from its start.
+  if (header->encoding == GCU_PACKED64_DELTA) {
+    GCU_Type64_Union buffer[BLOCK_SIZE];
+    decode_block(packed, block, buffer);
+    return (GCU_Packed64_Value){
+      .exists = true,
+      .value = buffer[i],
+    };
+  }
+
+  uint64_t number = 0;
+  if (header->bits) {
+    size_t bit = (i / LANES) * header->bits;
+    unsigned shift = bit % 64;
+    const uint64_t * low = packed->words + header->start + (bit / 64) * LANES + i % LANES;
+    number = *low >> shift;
+    if (shift + header->bits > 64) {
+      number |= low[LANES] << (64 - shift);
+    }
+    number &= bit_mask(header->bits);
+  }
+  return (GCU_Packed64_Value){
+    .exists = true,
+    .value = gcu_type64_ui64(header->base + number),
+  };
+}
+
+size_t gcu_packed64_decode_block(GCU_Packed64 * packed, size_t block, GCU_Type64_Union * values) {
+  if (block >= packed->block_count) {
+    return 0;
+  }
+  return decode_block(packed, block, values);
+}
+
+bool gcu_packed64_decode(GCU_Packed64 * packed, GCU_Vector64 * vector) {
+  if (packed->count > SIZE_MAX - vector->count) {
+    return false;
+  }
+  size_t total = vector->count + packed->count;
+  if (total > vector->capacity && !gcu_vector64_reserve(vector, total)) {
+    return false;
+  }
+
+  // Whole blocks are decoded straight into the vector, and only a short last
+  // block goes through a buffer.
+  GCU_Type64_Union * destination = vector->data + vector->count;
+  for (size_t block = 0; block < packed->block_count; ++block) {
+    if (block_values(packed, block) == BLOCK_SIZE) {
+      decode_block(packed, block, destination);
+      destination += BLOCK_SIZE;
+    }
+    else {
+      GCU_Type64_Union buffer[BLOCK_SIZE];
+      size_t count = decode_block(packed, block, buffer);
+      memcpy(destination, buffer, count * sizeof(GCU_Type64_Union));
+    }
+  }
+  vector->count = total;
+  return true;
+}
+
+uint64_t gcu_packed64_sum_ui64(GCU_Packed64 * packed) {
+  GCU_Type64_Union buffer[BLOCK_SIZE];
+  uint64_t sum = 0;
+  for (size_t block = 0; block < packed->block_count; ++block) {
+    const GCU_Packed64_Block * header = &packed->blocks[block];
+    if (header->encoding == GCU_PACKED64_FRAME_OF_REFERENCE && !header->bits) {
+      sum += header->base * block_values(packed, block);
+      continue;
+    }
+    size_t count = decode_block(packed, block, buffer);
+    sum += gcu_sum64_ui64(buffer, count);
+  }
+  return sum;
+}
+
+uint64_t gcu_packed64_min_ui64(GCU_Packed64 * packed) {
+  GCU_Type64_Union buffer[BLOCK_SIZE];
+  uint64_t min = UINT64_MAX;
+  for (size_t block = 0; block < packed->block_count; ++block) {
+    const GCU_Packed64_Block * header = &packed->blocks[block];
+    uint64_t candidate = header->base;
+    if (header->encoding == GCU_PACKED64_DELTA) {
+      size_t count = decode_block(packed, block, buffer);
+      candidate = gcu_min64_ui64(buffer, count);
+    }
+    min = candidate < min ? candidate : min;
+  }
+  return min;
+}
+
+uint64_t gcu_packed64_max_ui64(GCU_Packed64 * packed) {
+  GCU_Type64_Union buffer[BLOCK_SIZE];
+  uint64_t max = 0;
+  for (size_t block = 0; block < packed->block_count; ++block) {
+    // Skip frame of reference blocks which cannot hold a larger value.
+    const GCU_Packed64_Block * header = &packed->blocks[block];
+    if (header->encoding == GCU_PACKED64_FRAME_OF_REFERENCE && block_upper_bound(header) <= max) {
+      continue;
+    }
+    size_t count = decode_block(packed, block, buffer);
+    uint64_t candidate = gcu_max64_ui64(buffer, count);
+    max = candidate > max ? candidate : max;
+  }
+  return max;
+}
+
+size_t gcu_packed64_count_range_ui64(GCU_Packed64 * packed, uint64_t low, uint64_t high) {
+  GCU_Type64_Union buffer[BLOCK_SIZE];
+  size_t total = 0;
+  for (size_t block = 0; block < packed->block_count; ++block) {
+    const GCU_Packed64_Block * header = &packed->blocks[block];
+    if (header->encoding == GCU_PACKED64_FRAME_OF_REFERENCE) {
+      uint64_t upper = block_upper_bound(header);
+      if (header->base > high || upper < low) {
+        continue;
+      }
+      if (header->base >= low && upper <= high) {
+        total += block_values(packed, block);
+        continue;
+      }
+    }
+    size_t count = decode_block(packed, block, buffer);
+    total += gcu_count_range64_ui64(buffer, count, low, high);
+  }
+  return total;
+}
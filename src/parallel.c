@@ -0,0 +1,500 @@
+/**
+ * @file
+ *
+ * This file implements the worker pool and the parallel vector algorithms.
+ */
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cutil/memory.h>
+#include <cutil/mutex.h>
+#include <cutil/parallel.h>
+#include <cutil/reduce.h>
+#include <cutil/semaphore.h>
+#include <cutil/thread.h>
+
+/// @cond HIDDEN_SYMBOLS
+#define gcu_parallel_constructor GHOTIIO_CUTIL(gcu_parallel_constructor)
+#define gcu_parallel_destructor GHOTIIO_CUTIL(gcu_parallel_destructor)
+/// @endcond
+
+// The largest chunk handed to a single task.  This is a conservative share of
+// a core's L2 cache, leaving room for the output of a transform.
+#define CHUNK_MAX_BYTES (256 * 1024)
+
+// The smallest chunk handed to a single task, below which the cost of
+// claiming the task becomes noticeable.
+#define CHUNK_MIN_BYTES (16 * 1024)
+
+// The number of tasks per thread to aim for when the input is small, so that
+// a slow thread does not hold up the whole job.
+#define TASKS_PER_THREAD 4
+
+#define CACHE_LINE_BYTES GCU_CACHELINE_SIZE
+
+struct GCU_Thread_Pool {
+  size_t num_threads;         // Threads working on each job, including the
+                              //   submitting thread.
+  GCU_Thread * workers;       // The `num_threads - 1` worker threads.
+  GCU_MUTEX_T mutex;          // Serializes jobs from different threads.
+  GCU_Semaphore start;        // Signaled once per worker to start a job.
+  GCU_Semaphore done;         // Signaled by each worker when it finishes.
+  GCU_Thread_Pool_Task task;  // The task of the current job.
+  void * arg;                 // The argument of the current job.
+  size_t num_tasks;           // The number of tasks in the current job.
+  atomic_size_t next_task;    // The next task to be claimed.
+  bool stop;                  // Tells the workers to exit.
+};
+
+// Whether the current thread is working on a job, in which case any nested
+// job is run serially rather than waiting on a pool which may be busy.
+static _Thread_local bool gcu_thread_pool_in_job = false;
+
+static GCU_Thread_Pool * gcu_thread_pool_default = NULL;
+static GCU_MUTEX_T gcu_thread_pool_default_mutex;
+
+//
+// Claim and run tasks until there are none left.
+//
+static void gcu_thread_pool_work(GCU_Thread_Pool * pool) {
+  size_t index;
+  while ((index = atomic_fetch_add_explicit(&pool->next_task, 1, memory_order_relaxed)) < pool->num_tasks) {
+    pool->task(index, pool->arg);
+  }
+}
+
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION gcu_thread_pool_worker(GCU_THREAD_FUNC_ARG_T arg) {
+  GCU_Thread_Pool * pool = arg;
+  gcu_thread_pool_in_job = true;
+
+  while (true) {
+    gcu_semaphore_wait(&pool->start);
+    if (pool->stop) {
+      break;
+    }
+    gcu_thread_pool_work(pool);
+    gcu_semaphore_signal(&pool->done);
+  }
+  return 0;
+}
+
+//
+// Stop and join the first `count` workers of the pool.
+//
+static void gcu_thread_pool_stop_workers(GCU_Thread_Pool * pool, size_t count) {
+  pool->stop = true;
+  for (size_t i = 0; i < count; ++i) {
+    gcu_semaphore_signal(&pool->start);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    gcu_thread_join(pool->workers[i]);
+  }
+}
+
+//
+// Destroy the default pool when the program exits.  This is registered with
+// `atexit()`, so it runs before the thread module's destructor, which would
+// otherwise wait forever on the idle workers.
+//
+static void gcu_thread_pool_destroy_default(void) {
+  GCU_MUTEX_LOCK(gcu_thread_pool_default_mutex);
+  gcu_thread_pool_destroy(gcu_thread_pool_default);
+  gcu_thread_pool_default = NULL;
+  GCU_MUTEX_UNLOCK(gcu_thread_pool_default_mutex);
+}
+
+/**
+ * Constructor for the parallel module.
+ *
+ * This is called automatically when the module is loaded.  It creates the
+ * mutex which guards the creation of the default pool.
+ */
+GCU_INIT_FUNCTION(gcu_parallel_constructor) {
+  GCU_MUTEX_CREATE(gcu_thread_pool_default_mutex);
+}
+
+/**
+ * Destructor for the parallel module.
+ *
+ * This is called automatically when the module is unloaded.
+ */
+GCU_CLEANUP_FUNCTION(gcu_parallel_destructor) {
+  GCU_MUTEX_DESTROY(gcu_thread_pool_default_mutex);
+}
+
+GCU_Thread_Pool * gcu_thread_pool_create(size_t num_threads) {
+  if (!num_threads) {
+    num_threads = gcu_thread_get_num_processors();
+    if (!num_threads) {
+      num_threads = 1;
+    }
+  }
+
+  GCU_Thread_Pool * pool = gcu_calloc(1, sizeof(GCU_Thread_Pool));
+  if (!pool) {
+    return NULL;
+  }
+  pool->num_threads = num_threads;
+  atomic_init(&pool->next_task, 0);
+
+  if (num_threads > 1) {
+    pool->workers = gcu_calloc(num_threads - 1, sizeof(GCU_Thread));
+    if (!pool->workers) {
+      goto FAIL_WORKERS;
+    }
+  }
+  if (GCU_MUTEX_CREATE(pool->mutex)) {
+    goto FAIL_MUTEX;
+  }
+  if (gcu_semaphore_create(&pool->start, 0)) {
+    goto FAIL_START;
+  }
+  if (gcu_semaphore_create(&pool->done, 0)) {
+    goto FAIL_DONE;
+  }
+
+  for (size_t i = 0; i < num_threads - 1; ++i) {
+    if (gcu_thread_create(&pool->workers[i], gcu_thread_pool_worker, pool)) {
+      gcu_thread_pool_stop_workers(pool, i);
+      goto FAIL_THREADS;
+    }
+  }
+  return pool;
+
+FAIL_THREADS:
+  gcu_semaphore_destroy(&pool->done);
+FAIL_DONE:
+  gcu_semaphore_destroy(&pool->start);
+FAIL_START:
+  GCU_MUTEX_DESTROY(pool->mutex);
+FAIL_MUTEX:
+  gcu_free(pool->workers);
+FAIL_WORKERS:
+  gcu_free(pool);
+  return NULL;
+}
+
+void gcu_thread_pool_destroy(GCU_Thread_Pool * pool) {
+  // Verify that the pointer actually points to something.
+  if (!pool) {
+    return;
+  }
+
+  gcu_thread_pool_stop_workers(pool, pool->num_threads - 1);
+  gcu_semaphore_destroy(&pool->done);
+  gcu_semaphore_destroy(&pool->start);
+  GCU_MUTEX_DESTROY(pool->mutex);
+  gcu_free(pool->workers);
+  gcu_free(pool);
+}
+
+GCU_Thread_Pool * gcu_thread_pool_get_default(void) {
+  GCU_MUTEX_LOCK(gcu_thread_pool_default_mutex);
+  if (!gcu_thread_pool_default) {
+    gcu_thread_pool_default = gcu_thread_pool_create(0);
+    if (gcu_thread_pool_default && atexit(gcu_thread_pool_destroy_default)) {
+      // Without the exit handler, the program could not exit cleanly.
+      gcu_thread_pool_destroy(gcu_thread_pool_default);
+      gcu_thread_pool_default = NULL;
+    }
+  }
+  GCU_Thread_Pool * pool = gcu_thread_pool_default;
+  GCU_MUTEX_UNLOCK(gcu_thread_pool_default_mutex);
+  return pool;
+}
+
+size_t gcu_thread_pool_get_num_threads(GCU_Thread_Pool * pool) {
+  if (!pool) {
+    pool = gcu_thread_pool_get_default();
+  }
+  return pool
+    ? pool->num_threads
+    : 1;
+}
+
+size_t gcu_thread_pool_get_chunk_size(GCU_Thread_Pool * pool, size_t count, size_t element_size) {
+  if (!element_size) {
+    element_size = 1;
+  }
+
+  size_t chunk = CHUNK_MAX_BYTES / element_size;
+  size_t balanced = count / (gcu_thread_pool_get_num_threads(pool) * TASKS_PER_THREAD);
+  if (balanced < chunk) {
+    chunk = balanced;
+  }
+  size_t minimum = CHUNK_MIN_BYTES / element_size;
+  if (chunk < minimum) {
+    chunk = minimum;
+  }
+
+  // Round up to a whole number of cache lines.
+  size_t line = element_size < CACHE_LINE_BYTES
+    ? CACHE_LINE_BYTES / element_size
+    : 1;
+  chunk = (chunk + line - 1) / line * line;
+
+  return chunk ? chunk : 1;
+}
+
+bool gcu_thread_pool_run(GCU_Thread_Pool * pool, size_t num_tasks, GCU_Thread_Pool_Task task, void * arg) {
+  if (!task) {
+    return false;
+  }
+  if (!pool && !gcu_thread_pool_in_job) {
+    pool = gcu_thread_pool_get_default();
+  }
+
+  // Run small jobs, nested jobs, and jobs without any workers on the current
+  // thread.
+  if (!pool || (pool->num_threads < 2) || (num_tasks < 2) || gcu_thread_pool_in_job) {
+    for (size_t i = 0; i < num_tasks; ++i) {
+      task(i, arg);
+    }
+    return true;
+  }
+
+  GCU_MUTEX_LOCK(pool->mutex);
+  pool->task = task;
+  pool->arg = arg;
+  pool->num_tasks = num_tasks;
+  atomic_store_explicit(&pool->next_task, 0, memory_order_relaxed);
+
+  // Only wake as many workers as there are tasks for.
+  size_t helpers = pool->num_threads - 1;
+  if (helpers > num_tasks - 1) {
+    helpers = num_tasks - 1;
+  }
+  for (size_t i = 0; i < helpers; ++i) {
+    gcu_semaphore_signal(&pool->start);
+  }
+
+  gcu_thread_pool_in_job = true;
+  gcu_thread_pool_work(pool);
+  gcu_thread_pool_in_job = false;
+
+  for (size_t i = 0; i < helpers; ++i) {
+    gcu_semaphore_wait(&pool->done);
+  }
+  GCU_MUTEX_UNLOCK(pool->mutex);
+  return true;
+}
+
+//
+// The shared state of the chunked vector algorithms.
+//
+typedef struct {
+  GCU_Type64_Union * source;        // The elements to read.
+  GCU_Type64_Union * destination;   // The elements to write, if any.
+  size_t count;                     // The number of elements.
+  size_t chunk;                     // The number of elements per task.
+  GCU_Vector64_Chunk_Func for_each; // The for-each callback, if any.
+  GCU_Vector64_Transform_Func transform; // The transform callback, if any.
+  void * arg;                       // The user-supplied argument.
+  void * partials;                  // One partial result per task, if any.
+} GCU_Parallel_Job;
+
+//
+// Get the bounds of the chunk for task `index`.
+//
+static inline size_t gcu_parallel_chunk(const GCU_Parallel_Job * job, size_t index, size_t * begin) {
+  *begin = index * job->chunk;
+  size_t remaining = job->count - *begin;
+  return remaining < job->chunk
+    ? remaining
+    : job->chunk;
+}
+
+static inline size_t gcu_parallel_num_tasks(const GCU_Parallel_Job * job) {
+  return (job->count + job->chunk - 1) / job->chunk;
+}
+
+static void gcu_parallel_for_each_task(size_t index, void * arg) {
+  GCU_Parallel_Job * job = arg;
+  size_t begin;
+  size_t count = gcu_parallel_chunk(job, index, &begin);
+  job->for_each(job->source + begin, count, job->arg);
+}
+
+static void gcu_parallel_transform_task(size_t index, void * arg) {
+  GCU_Parallel_Job * job = arg;
+  size_t begin;
+  size_t count = gcu_parallel_chunk(job, index, &begin);
+  job->transform(job->source + begin, job->destination + begin, count, job->arg);
+}
+
+bool gcu_vector64_par_for_each(GCU_Thread_Pool * pool, GCU_Vector64 * vector, GCU_Vector64_Chunk_Func func, void * arg) {
+  // Verify that the pointers actually point to something.
+  if (!vector || !func) {
+    return false;
+  }
+  if (!vector->count) {
+    return true;
+  }
+
+  GCU_Parallel_Job job = {
+    .source = vector->data,
+    .count = vector->count,
+    .chunk = gcu_thread_pool_get_chunk_size(pool, vector->count, sizeof(GCU_Type64_Union)),
+    .for_each = func,
+    .arg = arg,
+  };
+  return gcu_thread_pool_run(pool, gcu_parallel_num_tasks(&job), gcu_parallel_for_each_task, &job);
+}
+
+bool gcu_vector64_par_transform(GCU_Thread_Pool * pool, GCU_Vector64 * destination, GCU_Vector64 * source, GCU_Vector64_Transform_Func func, void * arg) {
+  // Verify that the pointers actually point to something.
+  if (!destination || !source || !func) {
+    return false;
+  }
+  if (!gcu_vector64_reserve(destination, source->count)) {
+    return false;
+  }
+  destination->count = source->count;
+  if (!source->count) {
+    return true;
+  }
+
+  GCU_Parallel_Job job = {
+    .source = source->data,
+    .destination = destination->data,
+    .count = source->count,
+    .chunk = gcu_thread_pool_get_chunk_size(pool, source->count, sizeof(GCU_Type64_Union)),
+    .transform = func,
+    .arg = arg,
+  };
+  return gcu_thread_pool_run(pool, gcu_parallel_num_tasks(&job), gcu_parallel_transform_task, &job);
+}
+
+//
+// Run a reduction `task` over the vector, which stores one partial result of
+// `partial_size` bytes per chunk.  If the partial results cannot be allocated,
+// then the vector is reduced serially as a single chunk into `fallback`.
+//
+// Returns the array of partial results, and sets `num_partials` to its length.
+//
+static void * gcu_parallel_reduce(GCU_Thread_Pool * pool, GCU_Vector64 * vector, GCU_Thread_Pool_Task task, size_t partial_size, void * fallback, size_t * num_partials) {
+  GCU_Parallel_Job job = {
+    .source = vector->data,
+    .count = vector->count,
+    .chunk = gcu_thread_pool_get_chunk_size(pool, vector->count, sizeof(GCU_Type64_Union)),
+  };
+  *num_partials = gcu_parallel_num_tasks(&job);
+  job.partials = *num_partials > 1
+    ? gcu_malloc(*num_partials * partial_size)
+    : NULL;
+
+  if (!job.partials) {
+    job.chunk = job.count;
+    job.partials = fallback;
+    *num_partials = 1;
+  }
+  gcu_thread_pool_run(pool, *num_partials, task, &job);
+  return job.partials;
+}
+
+#define SUM(a, b) ((a) + (b))
+#define MIN(a, b) ((b) < (a) ? (b) : (a))
+#define MAX(a, b) ((a) < (b) ? (b) : (a))
+
+#define LANE ui64
+#define RESULT_T uint64_t
+#define ACCUMULATOR_T uint64_t
+
+#define OPERATION sum
+#define COMBINE SUM
+#define IDENTITY 0
+#include "parallel.template.c"
+#undef OPERATION
+#undef COMBINE
+#undef IDENTITY
+
+#define OPERATION min
+#define COMBINE MIN
+#define IDENTITY UINT64_MAX
+#include "parallel.template.c"
+#undef OPERATION
+#undef COMBINE
+#undef IDENTITY
+
+#define OPERATION max
+#define COMBINE MAX
+#define IDENTITY 0
+#include "parallel.template.c"
+#undef OPERATION
+#undef COMBINE
+#undef IDENTITY
+
+#undef LANE
+#undef RESULT_T
+#undef ACCUMULATOR_T
+
+#define LANE i64
+#define RESULT_T int64_t
+
+// Signed sums are accumulated as unsigned so that overflow wraps around.
+#define ACCUMULATOR_T uint64_t
+#define OPERATION sum
+#define COMBINE SUM
+#define IDENTITY 0
+#include "parallel.template.c"
+#undef OPERATION
+#undef COMBINE
+#undef IDENTITY
+#undef ACCUMULATOR_T
+
+#define ACCUMULATOR_T int64_t
+#define OPERATION min
+#define COMBINE MIN
+#define IDENTITY INT64_MAX
+#include "parallel.template.c"
+#undef OPERATION
+#undef COMBINE
+#undef IDENTITY
+
+#define OPERATION max
+#define COMBINE MAX
+#define IDENTITY INT64_MIN
+#include "parallel.template.c"
+#undef OPERATION
+#undef COMBINE
+#undef IDENTITY
+
+#undef LANE
+#undef RESULT_T
+#undef ACCUMULATOR_T
+
+#define LANE f64
+#define RESULT_T double
+#define ACCUMULATOR_T double
+
+#define OPERATION sum
+#define COMBINE SUM
+#define IDENTITY 0
+#include "parallel.template.c"
+#undef OPERATION
+#undef COMBINE
+#undef IDENTITY
+
+#define OPERATION min
+#define COMBINE MIN
+#define IDENTITY INFINITY
+#include "parallel.template.c"
+#undef OPERATION
+#undef COMBINE
+#undef IDENTITY
+
+#define OPERATION max
+#define COMBINE MAX
+#define IDENTITY -INFINITY
+#include "parallel.template.c"
+#undef OPERATION
+#undef COMBINE
+#undef IDENTITY
+
+#undef LANE
+#undef RESULT_T
+#undef ACCUMULATOR_T
@@ -0,0 +1,36 @@
+#define TEMPLATE_TASK               GHOTIIO_CUTIL_CONCAT3(gcu_parallel_, OPERATION, GHOTIIO_CUTIL_CONCAT2(_task_, LANE))
+#define TEMPLATE_GCU_VECTOR_REDUCE  GHOTIIO_CUTIL_CONCAT3(gcu_vector64_par_, OPERATION, GHOTIIO_CUTIL_CONCAT2(_, LANE))
+#define TEMPLATE_GCU_KERNEL         GHOTIIO_CUTIL_CONCAT3(gcu_, OPERATION, GHOTIIO_CUTIL_CONCAT2(64_, LANE))
+
+static void TEMPLATE_TASK(size_t index, void * arg) {
+  GCU_Parallel_Job * job = arg;
+  size_t begin;
+  size_t count = gcu_parallel_chunk(job, index, &begin);
+  ((ACCUMULATOR_T *)job->partials)[index] = (ACCUMULATOR_T)TEMPLATE_GCU_KERNEL(job->source + begin, count);
+}
+
+RESULT_T TEMPLATE_GCU_VECTOR_REDUCE(GCU_Thread_Pool * pool, GCU_Vector64 * vector) {
+  // Verify that the pointer actually points to something.
+  if (!vector || !vector->count) {
+    return IDENTITY;
+  }
+
+  ACCUMULATOR_T fallback;
+  size_t num_partials;
+  ACCUMULATOR_T * partials = gcu_parallel_reduce(pool, vector, TEMPLATE_TASK, sizeof(ACCUMULATOR_T), &fallback, &num_partials);
+
+  // Combine the partial results in order, so that the result does not depend
+  // on which thread finished first.
+  ACCUMULATOR_T result = IDENTITY;
+  for (size_t i = 0; i < num_partials; ++i) {
+    result = COMBINE(result, partials[i]);
+  }
+  if (partials != &fallback) {
+    gcu_free(partials);
+  }
+  return (RESULT_T)result;
+}
+
+#undef TEMPLATE_TASK
+#undef TEMPLATE_GCU_VECTOR_REDUCE
+#undef TEMPLATE_GCU_KERNEL
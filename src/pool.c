@@ -0,0 +1,330 @@
+/**
+ * @file
+ *
+ * This file implements pools of fixed-size objects, with per-thread caches
+ * in front of a shared depot.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <cutil/memory.h>
+#include <cutil/mutex.h>
+#include <cutil/pool.h>
+
+#define CACHE_LINE_BYTES GCU_CACHELINE_SIZE
+
+// The alignment of (and smallest) object, which has room for the two links
+// that a free object holds.
+#define OBJECT_ALIGNMENT 16
+
+// The number of objects moved between a cache and the depot at once.  A
+// cache holds up to two batches, so that a thread which allocates and frees
+// around a batch boundary does not go to the depot on every call.
+#define BATCH 32
+
+// The number of caches in each pool.
+#define CACHES 64
+
+// The size of a slab, unless one batch of objects needs more.
+#define SLAB_BYTES ((size_t)64 << 10)
+
+//
+// A free object.  Objects in a batch are linked by `next`, and the first
+// object of each batch in the depot links to the next batch.
+//
+typedef struct Object {
+  struct Object * next;        // The next object in the batch (or list).
+  struct Object * next_batch;  // The next batch, in the first object only.
+} Object;
+
+//
+// The start of a slab, which is followed by its objects.  It fills a cache
+// line, so the objects are aligned to the cache line too.
+//
+typedef struct Slab {
+  struct Slab * next;          // The next slab of the pool.
+  char pad[CACHE_LINE_BYTES - sizeof(void *)];
+} Slab;
+
+//
+// A thread's cache.  It is locked only so that two threads which were given
+// the same cache cannot both use it; the owning thread finds it unlocked.
+//
+typedef struct {
+  atomic_flag busy;            // Set while a thread uses the cache.
+  size_t count;                // The objects in `objects`.
+  Object * objects[2 * BATCH]; // The free objects, most recently freed last.
+} Cache;
+
+//
+// The padded size of a cache, so that no two caches share a cache line.
+//
+#define CACHE_BYTES ((sizeof(Cache) + CACHE_LINE_BYTES - 1) & ~(size_t)(CACHE_LINE_BYTES - 1))
+
+struct GCU_Pool {
+  size_t object_size;          // The rounded size of each object.
+  size_t slab_objects;         // The objects in each slab.
+
+  // Guarded by `mutex`.
+  GCU_MUTEX_T mutex;
+  Object * batches;            // Full batches of free objects.
+  Object * loose;              // Free objects which are not in a batch.
+  Slab * slabs;                // Every slab of the pool.
+  size_t slab_count;           // The number of slabs.
+  char pad[CACHE_LINE_BYTES];
+
+  // The caches follow, each CACHE_BYTES long and cache-line aligned.
+};
+
+// The cache used by the calling thread, as an index.  Threads are numbered
+// in the order that they first use any pool.
+static atomic_size_t next_thread = 0;
+static _Thread_local size_t thread_index = SIZE_MAX;
+
+static inline Cache * cache_for(GCU_Pool * pool) {
+  if (thread_index == SIZE_MAX) {
+    thread_index = atomic_fetch_add_explicit(&next_thread, 1, memory_order_relaxed) % CACHES;
+  }
+  return (Cache *)((char *)pool + ((sizeof(GCU_Pool) + CACHE_LINE_BYTES - 1) & ~(size_t)(CACHE_LINE_BYTES - 1)) + thread_index * CACHE_BYTES);
+}
+
+// Carve a new slab into batches in the depot.  The mutex is held.
+static bool add_slab(GCU_Pool * pool) {
+  Slab * slab = gcu_aligned_alloc(CACHE_LINE_BYTES, sizeof(Slab) + pool->slab_objects * pool->object_size);
+  if (!slab) {
+    return false;
+  }
+  slab->next = pool->slabs;
+  pool->slabs = slab;
+  ++pool->slab_count;
+
+  // Link the objects into batches, pushing them in reverse so that the
+  // first batch handed out starts at the beginning of the slab.
+  char * objects = (char *)(slab + 1);
+  for (size_t batch = pool->slab_objects / BATCH; batch--;) {
+    char * first = objects + batch * BATCH * pool->object_size;
+    for (size_t i = 0; i < BATCH; ++i) {
+      ((Object *)(first + i * pool->object_size))->next = i + 1 < BATCH
+        ? (Object *)(first + (i + 1) * pool->object_size)
+        : 0;
+    }
+    ((Object *)first)->next_batch = pool->batches;
+    pool->batches = (Object *)first;
+  }
+  return true;
+}
+
+// Fill an empty cache with a batch of objects, or with what is loose.
+static bool refill(GCU_Pool * pool, Cache * cache) {
+  GCU_MUTEX_LOCK(pool->mutex);
+  if (!pool->batches && !pool->loose && !add_slab(pool)) {
+    GCU_MUTEX_UNLOCK(pool->mutex);
+    return false;
+  }
+  if (pool->batches) {
+    Object * object = pool->batches;
+    pool->batches = object->next_batch;
+    for (; object; object = object->next) {
+      cache->objects[cache->count++] = object;
+    }
+  }
+  else {
+    while (pool->loose && cache->count < BATCH) {
+      cache->objects[cache->count++] = pool->loose;
+      pool->loose = pool->loose->next;
+    }
+  }
+  GCU_MUTEX_UNLOCK(pool->mutex);
+  return true;
+}
+
+// Return `count` objects from the bottom of a cache to the depot as a batch.
+static void drain(GCU_Pool * pool, Cache * cache, size_t count) {
+  for (size_t i = 0; i + 1 < count; ++i) {
+    cache->objects[i]->next = cache->objects[i + 1];
+  }
+  cache->objects[count - 1]->next = 0;
+  Object * first = cache->objects[0];
+
+  GCU_MUTEX_LOCK(pool->mutex);
+  if (count == BATCH) {
+    first->next_batch = pool->batches;
+    pool->batches = first;
+  }
+  else {
+    cache->objects[count - 1]->next = pool->loose;
+    pool->loose = first;
+  }
+  GCU_MUTEX_UNLOCK(pool->mutex);
+
+  cache->count -= count;
+  memmove(cache->objects, cache->objects + count, cache->count * sizeof(Object *));
+}
+
+GCU_Pool * gcu_pool_create(size_t object_size) {
+  if (!object_size || object_size > SIZE_MAX / 2 / BATCH) {
+    return 0;
+  }
+  object_size = (object_size + OBJECT_ALIGNMENT - 1) & ~(size_t)(OBJECT_ALIGNMENT - 1);
+
+  // The pool and its caches are one cache-line aligned allocation.
+  size_t header = (sizeof(GCU_Pool) + CACHE_LINE_BYTES - 1) & ~(size_t)(CACHE_LINE_BYTES - 1);
+  GCU_Pool * pool = gcu_aligned_alloc(CACHE_LINE_BYTES, header + CACHES * CACHE_BYTES);
+  if (!pool) {
+    return 0;
+  }
+  memset(pool, 0, header + CACHES * CACHE_BYTES);
+  pool->object_size = object_size;
+  pool->slab_objects = SLAB_BYTES / object_size / BATCH * BATCH;
+  if (pool->slab_objects < BATCH) {
+    pool->slab_objects = BATCH;
+  }
+  for (size_t i = 0; i < CACHES; ++i) {
+    Cache * cache = (Cache *)((char *)pool + header + i * CACHE_BYTES);
+    atomic_flag_clear(&cache->busy);
+  }
+  if (GCU_MUTEX_CREATE(pool->mutex)) {
+    gcu_aligned_free(pool);
+    return 0;
+  }
+  return pool;
+}
+
+void gcu_pool_destroy(GCU_Pool * pool) {
+  if (pool) {
+    Slab * slab = pool->slabs;
+    while (slab) {
+      Slab * next = slab->next;
+      gcu_aligned_free(slab);
+      slab = next;
+    }
+    GCU_MUTEX_DESTROY(pool->mutex);
+    gcu_aligned_free(pool);
+  }
+}
+
+void * gcu_pool_allocate(GCU_Pool * pool) {
+  Cache * cache = cache_for(pool);
+  if (!atomic_flag_test_and_set_explicit(&cache->busy, memory_order_acquire)) {
+    Object * object = 0;
+    if (cache->count || refill(pool, cache)) {
+      object = cache->objects[--cache->count];
+    }
+    atomic_flag_clear_explicit(&cache->busy, memory_order_release);
+    return object;
+  }
+
+  // Another thread is using this cache, so take an object from the depot.
+  GCU_MUTEX_LOCK(pool->mutex);
+  if (!pool->loose && pool->batches) {
+    pool->loose = pool->batches;
+    pool->batches = pool->batches->next_batch;
+  }
+  if (!pool->loose && add_slab(pool)) {
+    pool->loose = pool->batches;
+    pool->batches = pool->batches->next_batch;
+  }
+  Object * object = pool->loose;
+  if (object) {
+    pool->loose = object->next;
+  }
+  GCU_MUTEX_UNLOCK(pool->mutex);
+  return object;
+}
+
+void gcu_pool_free(GCU_Pool * pool, void * object) {
+  if (!object) {
+    return;
+  }
+  Cache * cache = cache_for(pool);
+  if (!atomic_flag_test_and_set_explicit(&cache->busy, memory_order_acquire)) {
+    if (cache->count == 2 * BATCH) {
+      // Keep the most recently freed objects, which are likely to be hot.
+      drain(pool, cache, BATCH);
+    }
+    cache->objects[cache->count++] = object;
+    atomic_flag_clear_explicit(&cache->busy, memory_order_release);
+    return;
+  }
+
+  // Another thread is using this cache, so give the object to the depot.
+  GCU_MUTEX_LOCK(pool->mutex);
+  ((Object *)object)->next = pool->loose;
+  pool->loose = object;
+  GCU_MUTEX_UNLOCK(pool->mutex);
+}
+
+void gcu_pool_flush(GCU_Pool * pool) {
+  Cache * cache = cache_for(pool);
+  while (atomic_flag_test_and_set_explicit(&cache->busy, memory_order_acquire)) {
+    // Another thread shares the cache, and holds it only briefly.
+  }
+  while (cache->count) {
+    drain(pool, cache, cache->count < BATCH
+      ? cache->count
+      : BATCH);
+  }
+  atomic_flag_clear_explicit(&cache->busy, memory_order_release);
+}
+
+size_t gcu_pool_object_size(GCU_Pool * pool) {
+  return pool->object_size;
+}
+
+size_t gcu_pool_capacity(GCU_Pool * pool) {
+  GCU_MUTEX_LOCK(pool->mutex);
+  size_t capacity = pool->slab_count * pool->slab_objects;
+  GCU_MUTEX_UNLOCK(pool->mutex);
+  return capacity;
+}
+
+// The pools behind gcu_sized_malloc(), for 16, 32, ... 256 bytes.
+#define SIZE_CLASSES 5
+static _Atomic(GCU_Pool *) size_classes[SIZE_CLASSES];
+
+// Get the pool for a size which is at most GCU_POOL_LARGEST_SIZE_CLASS,
+// creating it if needed.
+static GCU_Pool * size_class(size_t size) {
+  size_t index = 0;
+  while (((size_t)OBJECT_ALIGNMENT << index) < size) {
+    ++index;
+  }
+  GCU_Pool * pool = atomic_load_explicit(&size_classes[index], memory_order_acquire);
+  if (!pool) {
+    // Threads which race to create the pool keep whichever was stored first.
+    GCU_Pool * created = gcu_pool_create((size_t)OBJECT_ALIGNMENT << index);
+    if (!created) {
+      return 0;
+    }
+    if (atomic_compare_exchange_strong_explicit(&size_classes[index], &pool, created, memory_order_acq_rel, memory_order_acquire)) {
+      pool = created;
+    }
+    else {
+      gcu_pool_destroy(created);
+    }
+  }
+  return pool;
+}
+
+void * gcu_sized_malloc(size_t size) {
+  if (size > GCU_POOL_LARGEST_SIZE_CLASS) {
+    return gcu_malloc(size);
+  }
+  GCU_Pool * pool = size_class(size);
+  return pool
+    ? gcu_pool_allocate(pool)
+    : 0;
+}
+
+void gcu_sized_free(void * pointer, size_t size) {
+  if (!pointer) {
+    return;
+  }
+  if (size > GCU_POOL_LARGEST_SIZE_CLASS) {
+    gcu_free(pointer);
+    return;
+  }
+  gcu_pool_free(size_class(size), pointer);
+}
@@ -0,0 +1,515 @@
+/**
+ * @file
+ *
+ * This file implements the lock-free SPSC and MPMC queues.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <cutil/memory.h>
+#include <cutil/queue.h>
+#include <cutil/semaphore.h>
+#include <cutil/thread.h>
+
+#define CACHE_LINE_BYTES GCU_CACHELINE_SIZE
+
+// The number of times that a blocking push or pop retries before it parks
+// the thread.  A handoff between two running threads takes well under this
+// many iterations, so the semaphore is only used when the other side is
+// really idle (or descheduled).  On a single processor, the other side cannot
+// make progress while this thread spins, so the thread parks after one try.
+#define SPIN_COUNT 256
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CPU_RELAX() __builtin_ia32_pause()
+#else
+#define CPU_RELAX()
+#endif
+
+struct GCU_SPSC_Queue64 {
+  // Written only when the queue is created.
+  size_t mask;                 // The capacity minus one.
+  GCU_Type64_Union * data;     // The circular buffer of values.
+  GCU_Semaphore items;         // Signaled when the consumer may pop.
+  GCU_Semaphore space;         // Signaled when the producer may push.
+  size_t spin;                 // Retries before a blocking call parks.
+
+  // Written only by a thread which is about to park.
+  atomic_size_t pop_waiters;   // 1 while the consumer is parked.
+  atomic_size_t push_waiters;  // 1 while the producer is parked.
+  char pad0[CACHE_LINE_BYTES];
+
+  // Owned by the producer.
+  atomic_size_t tail;          // The position of the next value pushed.
+  size_t head_cache;           // The last value of `head` seen.
+  char pad1[CACHE_LINE_BYTES];
+
+  // Owned by the consumer.
+  atomic_size_t head;          // The position of the next value popped.
+  size_t tail_cache;           // The last value of `tail` seen.
+  char pad2[CACHE_LINE_BYTES];
+};
+
+typedef struct {
+  atomic_size_t sequence;      // The position which may next use the cell.
+  GCU_Type64_Union value;
+} MPMC_Cell;
+
+struct GCU_MPMC_Queue64 {
+  // Written only when the queue is created.
+  size_t mask;                 // The capacity minus one.
+  MPMC_Cell * cells;           // The circular buffer of cells.
+  GCU_Semaphore items;         // Signaled when a consumer may pop.
+  GCU_Semaphore space;         // Signaled when a producer may push.
+  size_t spin;                 // Retries before a blocking call parks.
+
+  // Written only by threads which are about to park.
+  atomic_size_t pop_waiters;   // The number of parked consumers.
+  atomic_size_t push_waiters;  // The number of parked producers.
+  char pad0[CACHE_LINE_BYTES];
+
+  atomic_size_t enqueue_pos;   // The position of the next value pushed.
+  char pad1[CACHE_LINE_BYTES];
+
+  atomic_size_t dequeue_pos;   // The position of the next value popped.
+  char pad2[CACHE_LINE_BYTES];
+};
+
+//
+// Get the smallest power of two which is not less than `count`, or `0` if
+// there is no such `size_t`.
+//
+static size_t capacity_for(size_t count) {
+  if (count > ((size_t)1 << (sizeof(size_t) * 8 - 1))) {
+    return 0;
+  }
+  size_t capacity = 1;
+  while (capacity < count) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+//
+// Get the number of retries before a blocking call parks.
+//
+static size_t spin_count(void) {
+  return gcu_thread_get_num_processors() > 1
+    ? SPIN_COUNT
+    : 0;
+}
+
+//
+// Wake up to `count` threads which are parked on `semaphore`.
+//
+// The fence orders the caller's update of the queue before the load of
+// `waiters`, and pairs with the fence in park(): either the waker sees the
+// waiter, or the waiter sees the update.  When nobody is waiting, this is the
+// whole cost of supporting the blocking functions.
+//
+static inline void wake(atomic_size_t * waiters, GCU_Semaphore * semaphore, size_t count) {
+  atomic_thread_fence(memory_order_seq_cst);
+  size_t parked = atomic_load_explicit(waiters, memory_order_relaxed);
+  while (parked && count) {
+    if (atomic_compare_exchange_weak_explicit(waiters, &parked, parked - 1, memory_order_relaxed, memory_order_relaxed)) {
+      gcu_semaphore_signal(semaphore);
+      --count;
+    }
+  }
+}
+
+//
+// Announce that the calling thread is about to park on a semaphore.  The
+// caller must check the queue once more before calling gcu_semaphore_wait().
+//
+static inline void park(atomic_size_t * waiters) {
+  atomic_fetch_add_explicit(waiters, 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+}
+
+//
+// Withdraw from parking, because the final check of the queue succeeded.  If a
+// waker has already claimed this thread's place in `waiters`, then its signal
+// is on the way, and must be consumed.
+//
+static inline void unpark(atomic_size_t * waiters, GCU_Semaphore * semaphore) {
+  size_t parked = atomic_load_explicit(waiters, memory_order_relaxed);
+  while (parked) {
+    if (atomic_compare_exchange_weak_explicit(waiters, &parked, parked - 1, memory_order_relaxed, memory_order_relaxed)) {
+      return;
+    }
+  }
+  gcu_semaphore_wait(semaphore);
+}
+
+//
+// Copy `count` values into the circular buffer `data`, starting at position
+// `start`.
+//
+static inline void copy_in(GCU_Type64_Union * data, size_t mask, size_t start, const GCU_Type64_Union * values, size_t count) {
+  size_t offset = start & mask;
+  size_t first = mask + 1 - offset < count
+    ? mask + 1 - offset
+    : count;
+  memcpy(data + offset, values, first * sizeof(GCU_Type64_Union));
+  if (count > first) {
+    memcpy(data, values + first, (count - first) * sizeof(GCU_Type64_Union));
+  }
+}
+
+//
+// Copy `count` values out of the circular buffer `data`, starting at position
+// `start`.
+//
+static inline void copy_out(const GCU_Type64_Union * data, size_t mask, size_t start, GCU_Type64_Union * values, size_t count) {
+  size_t offset = start & mask;
+  size_t first = mask + 1 - offset < count
+    ? mask + 1 - offset
+    : count;
+  memcpy(values, data + offset, first * sizeof(GCU_Type64_Union));
+  if (count > first) {
+    memcpy(values + first, data, (count - first) * sizeof(GCU_Type64_Union));
+  }
+}
+
+GCU_SPSC_Queue64 * gcu_spsc_queue64_create(size_t capacity) {
+  capacity = capacity_for(capacity ? capacity : 1);
+  if (!capacity || capacity > SIZE_MAX / sizeof(GCU_Type64_Union)) {
+    return NULL;
+  }
+
+  GCU_SPSC_Queue64 * queue = gcu_calloc(1, sizeof(GCU_SPSC_Queue64));
+  if (!queue) {
+    return NULL;
+  }
+  queue->mask = capacity - 1;
+  queue->spin = spin_count();
+  queue->data = gcu_malloc(capacity * sizeof(GCU_Type64_Union));
+  if (!queue->data) {
+    goto FAIL_DATA;
+  }
+  if (gcu_semaphore_create(&queue->items, 0)) {
+    goto FAIL_ITEMS;
+  }
+  if (gcu_semaphore_create(&queue->space, 0)) {
+    goto FAIL_SPACE;
+  }
+  atomic_init(&queue->pop_waiters, 0);
+  atomic_init(&queue->push_waiters, 0);
+  atomic_init(&queue->tail, 0);
+  atomic_init(&queue->head, 0);
+  return queue;
+
+FAIL_SPACE:
+  gcu_semaphore_destroy(&queue->items);
+FAIL_ITEMS:
+  gcu_free(queue->data);
+FAIL_DATA:
+  gcu_free(queue);
+  return NULL;
+}
+
+void gcu_spsc_queue64_destroy(GCU_SPSC_Queue64 * queue) {
+  if (queue) {
+    gcu_semaphore_destroy(&queue->items);
+    gcu_semaphore_destroy(&queue->space);
+    gcu_free(queue->data);
+    gcu_free(queue);
+  }
+}
+
+bool gcu_spsc_queue64_try_push(GCU_SPSC_Queue64 * queue, GCU_Type64_Union value) {
+  size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  if (tail - queue->head_cache > queue->mask) {
+    queue->head_cache = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (tail - queue->head_cache > queue->mask) {
+      return false;
+    }
+  }
+  queue->data[tail & queue->mask] = value;
+  atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+  wake(&queue->pop_waiters, &queue->items, 1);
+  return true;
+}
+
+GCU_Queue64_Value gcu_spsc_queue64_try_pop(GCU_SPSC_Queue64 * queue) {
+  size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+  if (head == queue->tail_cache) {
+    queue->tail_cache = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    if (head == queue->tail_cache) {
+      return (GCU_Queue64_Value){0};
+    }
+  }
+  GCU_Queue64_Value result = {
+    .exists = true,
+    .value = queue->data[head & queue->mask],
+  };
+  atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+  wake(&queue->push_waiters, &queue->space, 1);
+  return result;
+}
+
+void gcu_spsc_queue64_push(GCU_SPSC_Queue64 * queue, GCU_Type64_Union value) {
+  size_t spin = 0;
+  while (!gcu_spsc_queue64_try_push(queue, value)) {
+    if (spin++ < queue->spin) {
+      CPU_RELAX();
+      continue;
+    }
+    park(&queue->push_waiters);
+    if (gcu_spsc_queue64_try_push(queue, value)) {
+      unpark(&queue->push_waiters, &queue->space);
+      return;
+    }
+    gcu_semaphore_wait(&queue->space);
+  }
+}
+
+GCU_Type64_Union gcu_spsc_queue64_pop(GCU_SPSC_Queue64 * queue) {
+  size_t spin = 0;
+  GCU_Queue64_Value result;
+  while (!(result = gcu_spsc_queue64_try_pop(queue)).exists) {
+    if (spin++ < queue->spin) {
+      CPU_RELAX();
+      continue;
+    }
+    park(&queue->pop_waiters);
+    result = gcu_spsc_queue64_try_pop(queue);
+    if (result.exists) {
+      unpark(&queue->pop_waiters, &queue->items);
+      break;
+    }
+    gcu_semaphore_wait(&queue->items);
+  }
+  return result.value;
+}
+
+size_t gcu_spsc_queue64_push_many(GCU_SPSC_Queue64 * queue, const GCU_Type64_Union * values, size_t count) {
+  size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  size_t room = queue->mask + 1 - (tail - queue->head_cache);
+  if (room < count) {
+    queue->head_cache = atomic_load_explicit(&queue->head, memory_order_acquire);
+    room = queue->mask + 1 - (tail - queue->head_cache);
+  }
+  if (count > room) {
+    count = room;
+  }
+  if (!count) {
+    return 0;
+  }
+  copy_in(queue->data, queue->mask, tail, values, count);
+  atomic_store_explicit(&queue->tail, tail + count, memory_order_release);
+  wake(&queue->pop_waiters, &queue->items, 1);
+  return count;
+}
+
+size_t gcu_spsc_queue64_pop_many(GCU_SPSC_Queue64 * queue, GCU_Type64_Union * values, size_t count) {
+  size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+  size_t available = queue->tail_cache - head;
+  if (available < count) {
+    queue->tail_cache = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    available = queue->tail_cache - head;
+  }
+  if (count > available) {
+    count = available;
+  }
+  if (!count) {
+    return 0;
+  }
+  copy_out(queue->data, queue->mask, head, values, count);
+  atomic_store_explicit(&queue->head, head + count, memory_order_release);
+  wake(&queue->push_waiters, &queue->space, 1);
+  return count;
+}
+
+size_t gcu_spsc_queue64_count(GCU_SPSC_Queue64 * queue) {
+  size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+  size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+  return tail - head;
+}
+
+GCU_MPMC_Queue64 * gcu_mpmc_queue64_create(size_t capacity) {
+  // A single cell cannot tell a full queue from an empty one.
+  capacity = capacity_for(capacity < 2 ? 2 : capacity);
+  if (!capacity || capacity > SIZE_MAX / sizeof(MPMC_Cell)) {
+    return NULL;
+  }
+
+  GCU_MPMC_Queue64 * queue = gcu_calloc(1, sizeof(GCU_MPMC_Queue64));
+  if (!queue) {
+    return NULL;
+  }
+  queue->mask = capacity - 1;
+  queue->spin = spin_count();
+  queue->cells = gcu_malloc(capacity * sizeof(MPMC_Cell));
+  if (!queue->cells) {
+    goto FAIL_CELLS;
+  }
+  if (gcu_semaphore_create(&queue->items, 0)) {
+    goto FAIL_ITEMS;
+  }
+  if (gcu_semaphore_create(&queue->space, 0)) {
+    goto FAIL_SPACE;
+  }
+  for (size_t i = 0; i < capacity; ++i) {
+    atomic_init(&queue->cells[i].sequence, i);
+  }
+  atomic_init(&queue->pop_waiters, 0);
+  atomic_init(&queue->push_waiters, 0);
+  atomic_init(&queue->enqueue_pos, 0);
+  atomic_init(&queue->dequeue_pos, 0);
+  return queue;
+
+FAIL_SPACE:
+  gcu_semaphore_destroy(&queue->items);
+FAIL_ITEMS:
+  gcu_free(queue->cells);
+FAIL_CELLS:
+  gcu_free(queue);
+  return NULL;
+}
+
+void gcu_mpmc_queue64_destroy(GCU_MPMC_Queue64 * queue) {
+  if (queue) {
+    gcu_semaphore_destroy(&queue->items);
+    gcu_semaphore_destroy(&queue->space);
+    gcu_free(queue->cells);
+    gcu_free(queue);
+  }
+}
+
+//
+// Claim up to `count` consecutive cells whose sequence is `offset` past their
+// position: `0` for cells which are free to push into, and `1` for cells which
+// hold a value to pop.  Returns the number of cells claimed, starting at
+// `*start`.
+//
+static inline size_t mpmc_claim(GCU_MPMC_Queue64 * queue, atomic_size_t * position, size_t offset, size_t count, size_t * start) {
+  if (!count) {
+    return 0;
+  }
+  size_t pos = atomic_load_explicit(position, memory_order_relaxed);
+  while (true) {
+    size_t claimed = 0;
+    while (claimed < count && atomic_load_explicit(&queue->cells[(pos + claimed) & queue->mask].sequence, memory_order_acquire) == pos + claimed + offset) {
+      ++claimed;
+    }
+    if (claimed) {
+      if (atomic_compare_exchange_weak_explicit(position, &pos, pos + claimed, memory_order_relaxed, memory_order_relaxed)) {
+        *start = pos;
+        return claimed;
+      }
+      // `pos` now holds the current position.
+      continue;
+    }
+
+    // The first cell is not ready.  If it is still in use by the previous lap,
+    // then the queue is full (or empty).  Otherwise another thread claimed it
+    // first, so try again from the new position.
+    size_t sequence = atomic_load_explicit(&queue->cells[pos & queue->mask].sequence, memory_order_acquire);
+    if ((intptr_t)(sequence - (pos + offset)) < 0) {
+      return 0;
+    }
+    pos = atomic_load_explicit(position, memory_order_relaxed);
+  }
+}
+
+bool gcu_mpmc_queue64_try_push(GCU_MPMC_Queue64 * queue, GCU_Type64_Union value) {
+  size_t pos;
+  if (!mpmc_claim(queue, &queue->enqueue_pos, 0, 1, &pos)) {
+    return false;
+  }
+  MPMC_Cell * cell = &queue->cells[pos & queue->mask];
+  cell->value = value;
+  atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+  wake(&queue->pop_waiters, &queue->items, 1);
+  return true;
+}
+
+GCU_Queue64_Value gcu_mpmc_queue64_try_pop(GCU_MPMC_Queue64 * queue) {
+  size_t pos;
+  if (!mpmc_claim(queue, &queue->dequeue_pos, 1, 1, &pos)) {
+    return (GCU_Queue64_Value){0};
+  }
+  MPMC_Cell * cell = &queue->cells[pos & queue->mask];
+  GCU_Queue64_Value result = {
+    .exists = true,
+    .value = cell->value,
+  };
+  atomic_store_explicit(&cell->sequence, pos + queue->mask + 1, memory_order_release);
+  wake(&queue->push_waiters, &queue->space, 1);
+  return result;
+}
+
+void gcu_mpmc_queue64_push(GCU_MPMC_Queue64 * queue, GCU_Type64_Union value) {
+  size_t spin = 0;
+  while (!gcu_mpmc_queue64_try_push(queue, value)) {
+    if (spin++ < queue->spin) {
+      CPU_RELAX();
+      continue;
+    }
+    park(&queue->push_waiters);
+    if (gcu_mpmc_queue64_try_push(queue, value)) {
+      unpark(&queue->push_waiters, &queue->space);
+      return;
+    }
+    gcu_semaphore_wait(&queue->space);
+  }
+}
+
+GCU_Type64_Union gcu_mpmc_queue64_pop(GCU_MPMC_Queue64 * queue) {
+  size_t spin = 0;
+  GCU_Queue64_Value result;
+  while (!(result = gcu_mpmc_queue64_try_pop(queue)).exists) {
+    if (spin++ < queue->spin) {
+      CPU_RELAX();
+      continue;
+    }
+    park(&queue->pop_waiters);
+    result = gcu_mpmc_queue64_try_pop(queue);
+    if (result.exists) {
+      unpark(&queue->pop_waiters, &queue->items);
+      break;
+    }
+    gcu_semaphore_wait(&queue->items);
+  }
+  return result.value;
+}
+
+size_t gcu_mpmc_queue64_push_many(GCU_MPMC_Queue64 * queue, const GCU_Type64_Union * values, size_t count) {
+  size_t pos;
+  count = mpmc_claim(queue, &queue->enqueue_pos, 0, count, &pos);
+  for (size_t i = 0; i < count; ++i) {
+    MPMC_Cell * cell = &queue->cells[(pos + i) & queue->mask];
+    cell->value = values[i];
+    atomic_store_explicit(&cell->sequence, pos + i + 1, memory_order_release);
+  }
+  if (count) {
+    wake(&queue->pop_waiters, &queue->items, count);
+  }
+  return count;
+}
+
+size_t gcu_mpmc_queue64_pop_many(GCU_MPMC_Queue64 * queue, GCU_Type64_Union * values, size_t count) {
+  size_t pos;
+  count = mpmc_claim(queue, &queue->dequeue_pos, 1, count, &pos);
+  for (size_t i = 0; i < count; ++i) {
+    MPMC_Cell * cell = &queue->cells[(pos + i) & queue->mask];
+    values[i] = cell->value;
+    atomic_store_explicit(&cell->sequence, pos + i + queue->mask + 1, memory_order_release);
+  }
+  if (count) {
+    wake(&queue->push_waiters, &queue->space, count);
+  }
+  return count;
+}
+
+size_t gcu_mpmc_queue64_count(GCU_MPMC_Queue64 * queue) {
+  size_t dequeue = atomic_load_explicit(&queue->dequeue_pos, memory_order_acquire);
+  size_t enqueue = atomic_load_explicit(&queue->enqueue_pos, memory_order_acquire);
+  return (intptr_t)(enqueue - dequeue) > 0
+    ? enqueue - dequeue
+    : 0;
+}
@@ -0,0 +1,192 @@
+/**
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <cutil/reduce.h>
+
+// Every kernel is compiled several times, for increasingly wide instruction
+// sets, and the loader picks the widest one that the CPU supports.  The
+// `default` clone uses the baseline of the target (SSE2 on x86-64).  On other
+// compilers and architectures, the kernels are plain C, which the optimizer is
+// still free to vectorize for the baseline instruction set.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__ELF__) && (__GNUC__ >= 11)
+#define SIMD_DISPATCH __attribute__((target_clones("default", "avx2", "arch=x86-64-v4")))
+#else
+#define SIMD_DISPATCH
+#endif
+
+// The number of sum accumulators: two 512-bit registers of 64-bit lanes, which
+// is enough to hide the latency of a floating point add.
+#define SUM_LANES 16
+
+// The number of elements tested for a match before branching.
+#define FIND_BLOCK (4 * TEMPLATE_LANES)
+
+#define BITDEPTH 64
+#define COUNTER_BLOCKS 65536
+
+#define LANE ui64
+#define TYPE uint64_t
+#define SUM_T uint64_t
+#define ACCUMULATOR_T uint64_t
+#define MINIMUM 0
+#define MAXIMUM UINT64_MAX
+#include "reduce.template.c"
+#undef LANE
+#undef TYPE
+#undef SUM_T
+#undef ACCUMULATOR_T
+#undef MINIMUM
+#undef MAXIMUM
+
+// Signed sums are accumulated as unsigned so that overflow wraps around.
+#define LANE i64
+#define TYPE int64_t
+#define SUM_T int64_t
+#define ACCUMULATOR_T uint64_t
+#define MINIMUM INT64_MIN
+#define MAXIMUM INT64_MAX
+#include "reduce.template.c"
+#undef LANE
+#undef TYPE
+#undef SUM_T
+#undef ACCUMULATOR_T
+#undef MINIMUM
+#undef MAXIMUM
+
+#define LANE f64
+#define TYPE GCU_float64_t
+#define SUM_T double
+#define ACCUMULATOR_T double
+#define MINIMUM (-INFINITY)
+#define MAXIMUM INFINITY
+#include "reduce.template.c"
+#undef LANE
+#undef TYPE
+#undef SUM_T
+#undef ACCUMULATOR_T
+#undef MINIMUM
+#undef MAXIMUM
+
+#undef COUNTER_BLOCKS
+#undef BITDEPTH
+
+#define BITDEPTH 32
+#define COUNTER_BLOCKS 65536
+
+#define LANE ui32
+#define TYPE uint32_t
+#define SUM_T uint64_t
+#define ACCUMULATOR_T uint64_t
+#define MINIMUM 0
+#define MAXIMUM UINT32_MAX
+#include "reduce.template.c"
+#undef LANE
+#undef TYPE
+#undef SUM_T
+#undef ACCUMULATOR_T
+#undef MINIMUM
+#undef MAXIMUM
+
+#define LANE i32
+#define TYPE int32_t
+#define SUM_T int64_t
+#define ACCUMULATOR_T uint64_t
+#define MINIMUM INT32_MIN
+#define MAXIMUM INT32_MAX
+#include "reduce.template.c"
+#undef LANE
+#undef TYPE
+#undef SUM_T
+#undef ACCUMULATOR_T
+#undef MINIMUM
+#undef MAXIMUM
+
+// Floats are summed in double precision, so that long inputs do not lose the
+// contribution of small values.
+#define LANE f32
+#define TYPE GCU_float32_t
+#define SUM_T double
+#define ACCUMULATOR_T double
+#define MINIMUM (-INFINITY)
+#define MAXIMUM INFINITY
+#include "reduce.template.c"
+#undef LANE
+#undef TYPE
+#undef SUM_T
+#undef ACCUMULATOR_T
+#undef MINIMUM
+#undef MAXIMUM
+
+#undef COUNTER_BLOCKS
+#undef BITDEPTH
+
+#define BITDEPTH 16
+#define COUNTER_BLOCKS UINT16_MAX
+
+#define LANE ui16
+#define TYPE uint16_t
+#define SUM_T uint64_t
+#define ACCUMULATOR_T uint64_t
+#define MINIMUM 0
+#define MAXIMUM UINT16_MAX
+#include "reduce.template.c"
+#undef LANE
+#undef TYPE
+#undef SUM_T
+#undef ACCUMULATOR_T
+#undef MINIMUM
+#undef MAXIMUM
+
+#define LANE i16
+#define TYPE int16_t
+#define SUM_T int64_t
+#define ACCUMULATOR_T uint64_t
+#define MINIMUM INT16_MIN
+#define MAXIMUM INT16_MAX
+#include "reduce.template.c"
+#undef LANE
+#undef TYPE
+#undef SUM_T
+#undef ACCUMULATOR_T
+#undef MINIMUM
+#undef MAXIMUM
+
+#undef COUNTER_BLOCKS
+#undef BITDEPTH
+
+#define BITDEPTH 8
+#define COUNTER_BLOCKS UINT8_MAX
+
+#define LANE ui8
+#define TYPE uint8_t
+#define SUM_T uint64_t
+#define ACCUMULATOR_T uint64_t
+#define MINIMUM 0
+#define MAXIMUM UINT8_MAX
+#include "reduce.template.c"
+#undef LANE
+#undef TYPE
+#undef SUM_T
+#undef ACCUMULATOR_T
+#undef MINIMUM
+#undef MAXIMUM
+
+#define LANE i8
+#define TYPE int8_t
+#define SUM_T int64_t
+#define ACCUMULATOR_T uint64_t
+#define MINIMUM INT8_MIN
+#define MAXIMUM INT8_MAX
+#include "reduce.template.c"
+#undef LANE
+#undef TYPE
+#undef SUM_T
+#undef ACCUMULATOR_T
+#undef MINIMUM
+#undef MAXIMUM
+
+#undef COUNTER_BLOCKS
+#undef BITDEPTH
@@ -0,0 +1,196 @@
+#define TEMPLATE_GCU_TYPE_UNION     GHOTIIO_CUTIL_CONCAT3(GCU_Type, BITDEPTH, _Union)
+#define TEMPLATE_COUNTER_T          GHOTIIO_CUTIL_CONCAT3(uint, BITDEPTH, _t)
+#define TEMPLATE_LANES              (64 / sizeof(TYPE))
+#define TEMPLATE_SUFFIX             GHOTIIO_CUTIL_CONCAT3(BITDEPTH, _, LANE)
+#define TEMPLATE_GCU_SUM            GHOTIIO_CUTIL_CONCAT2(gcu_sum, TEMPLATE_SUFFIX)
+#define TEMPLATE_GCU_MIN            GHOTIIO_CUTIL_CONCAT2(gcu_min, TEMPLATE_SUFFIX)
+#define TEMPLATE_GCU_MAX            GHOTIIO_CUTIL_CONCAT2(gcu_max, TEMPLATE_SUFFIX)
+#define TEMPLATE_GCU_ARGMIN         GHOTIIO_CUTIL_CONCAT2(gcu_argmin, TEMPLATE_SUFFIX)
+#define TEMPLATE_GCU_ARGMAX         GHOTIIO_CUTIL_CONCAT2(gcu_argmax, TEMPLATE_SUFFIX)
+#define TEMPLATE_GCU_FIND           GHOTIIO_CUTIL_CONCAT2(gcu_find, TEMPLATE_SUFFIX)
+#define TEMPLATE_GCU_COUNT          GHOTIIO_CUTIL_CONCAT2(gcu_count, TEMPLATE_SUFFIX)
+#define TEMPLATE_GCU_COUNT_RANGE    GHOTIIO_CUTIL_CONCAT2(gcu_count_range, TEMPLATE_SUFFIX)
+
+// Each kernel keeps one accumulator per lane of a 512-bit register, in a
+// small array that the compiler maps onto vector registers.  Lane `j` only
+// ever sees elements `j`, `j + LANES`, `j + 2 * LANES`, ..., so the loop has
+// no dependency between neighbouring elements and vectorizes at any width.
+//
+// The min and max lane loops must not be unrolled before the vectorizer sees
+// them: once unrolled, GCC can no longer turn the floating point comparisons
+// into packed min/max instructions.
+
+SIMD_DISPATCH
+SUM_T TEMPLATE_GCU_SUM(const TEMPLATE_GCU_TYPE_UNION * data, size_t count) {
+  ACCUMULATOR_T lanes[SUM_LANES] = {0};
+  size_t i = 0;
+  for (; i + SUM_LANES <= count; i += SUM_LANES) {
+    for (size_t j = 0; j < SUM_LANES; ++j) {
+      lanes[j] += (ACCUMULATOR_T)(SUM_T)data[i + j].LANE;
+    }
+  }
+
+  ACCUMULATOR_T sum = 0;
+  for (size_t j = 0; j < SUM_LANES; ++j) {
+    sum += lanes[j];
+  }
+  for (; i < count; ++i) {
+    sum += (ACCUMULATOR_T)(SUM_T)data[i].LANE;
+  }
+  return (SUM_T)sum;
+}
+
+SIMD_DISPATCH
+TYPE TEMPLATE_GCU_MIN(const TEMPLATE_GCU_TYPE_UNION * data, size_t count) {
+  TYPE lanes[TEMPLATE_LANES];
+  for (size_t j = 0; j < TEMPLATE_LANES; ++j) {
+    lanes[j] = MAXIMUM;
+  }
+  size_t i = 0;
+  for (; i + TEMPLATE_LANES <= count; i += TEMPLATE_LANES) {
+#pragma GCC unroll 0
+    for (size_t j = 0; j < TEMPLATE_LANES; ++j) {
+      TYPE value = data[i + j].LANE;
+      lanes[j] = value < lanes[j] ? value : lanes[j];
+    }
+  }
+
+  TYPE minimum = MAXIMUM;
+  for (size_t j = 0; j < TEMPLATE_LANES; ++j) {
+    minimum = lanes[j] < minimum ? lanes[j] : minimum;
+  }
+  for (; i < count; ++i) {
+    TYPE value = data[i].LANE;
+    minimum = value < minimum ? value : minimum;
+  }
+  return minimum;
+}
+
+SIMD_DISPATCH
+TYPE TEMPLATE_GCU_MAX(const TEMPLATE_GCU_TYPE_UNION * data, size_t count) {
+  TYPE lanes[TEMPLATE_LANES];
+  for (size_t j = 0; j < TEMPLATE_LANES; ++j) {
+    lanes[j] = MINIMUM;
+  }
+  size_t i = 0;
+  for (; i + TEMPLATE_LANES <= count; i += TEMPLATE_LANES) {
+#pragma GCC unroll 0
+    for (size_t j = 0; j < TEMPLATE_LANES; ++j) {
+      TYPE value = data[i + j].LANE;
+      lanes[j] = value > lanes[j] ? value : lanes[j];
+    }
+  }
+
+  TYPE maximum = MINIMUM;
+  for (size_t j = 0; j < TEMPLATE_LANES; ++j) {
+    maximum = lanes[j] > maximum ? lanes[j] : maximum;
+  }
+  for (; i < count; ++i) {
+    TYPE value = data[i].LANE;
+    maximum = value > maximum ? value : maximum;
+  }
+  return maximum;
+}
+
+SIMD_DISPATCH
+size_t TEMPLATE_GCU_FIND(const TEMPLATE_GCU_TYPE_UNION * data, size_t count, TYPE value) {
+  // Test a whole block for a match without branching, and only look for the
+  // position within the block once it is known to be there.
+  size_t i = 0;
+  for (; i + FIND_BLOCK <= count; i += FIND_BLOCK) {
+    unsigned found = 0;
+    for (size_t j = 0; j < FIND_BLOCK; ++j) {
+      found |= data[i + j].LANE == value;
+    }
+    if (found) {
+      break;
+    }
+  }
+  for (; i < count; ++i) {
+    if (data[i].LANE == value) {
+      return i;
+    }
+  }
+  return count;
+}
+
+SIMD_DISPATCH
+size_t TEMPLATE_GCU_COUNT(const TEMPLATE_GCU_TYPE_UNION * data, size_t count, TYPE value) {
+  // Count in lanes as wide as the elements, so that the comparison results
+  // need not be widened, and flush the lanes before they can overflow.
+  size_t total = 0;
+  size_t i = 0;
+  while (i + TEMPLATE_LANES <= count) {
+    TEMPLATE_COUNTER_T lanes[TEMPLATE_LANES] = {0};
+    size_t blocks = (count - i) / TEMPLATE_LANES;
+    if (blocks > COUNTER_BLOCKS) {
+      blocks = COUNTER_BLOCKS;
+    }
+    for (size_t end = i + blocks * TEMPLATE_LANES; i < end; i += TEMPLATE_LANES) {
+      for (size_t j = 0; j < TEMPLATE_LANES; ++j) {
+        lanes[j] += data[i + j].LANE == value;
+      }
+    }
+    for (size_t j = 0; j < TEMPLATE_LANES; ++j) {
+      total += lanes[j];
+    }
+  }
+  for (; i < count; ++i) {
+    total += data[i].LANE == value;
+  }
+  return total;
+}
+
+SIMD_DISPATCH
+size_t TEMPLATE_GCU_COUNT_RANGE(const TEMPLATE_GCU_TYPE_UNION * data, size_t count, TYPE low, TYPE high) {
+  size_t total = 0;
+  size_t i = 0;
+  while (i + TEMPLATE_LANES <= count) {
+    TEMPLATE_COUNTER_T lanes[TEMPLATE_LANES] = {0};
+    size_t blocks = (count - i) / TEMPLATE_LANES;
+    if (blocks > COUNTER_BLOCKS) {
+      blocks = COUNTER_BLOCKS;
+    }
+    for (size_t end = i + blocks * TEMPLATE_LANES; i < end; i += TEMPLATE_LANES) {
+      for (size_t j = 0; j < TEMPLATE_LANES; ++j) {
+        TYPE value = data[i + j].LANE;
+        lanes[j] += (value >= low) & (value <= high);
+      }
+    }
+    for (size_t j = 0; j < TEMPLATE_LANES; ++j) {
+      total += lanes[j];
+    }
+  }
+  for (; i < count; ++i) {
+    TYPE value = data[i].LANE;
+    total += (value >= low) & (value <= high);
+  }
+  return total;
+}
+
+size_t TEMPLATE_GCU_ARGMIN(const TEMPLATE_GCU_TYPE_UNION * data, size_t count) {
+  // Two vectorized passes are much faster than one pass which must track the
+  // position of the minimum in every lane.
+  return count
+    ? TEMPLATE_GCU_FIND(data, count, TEMPLATE_GCU_MIN(data, count))
+    : 0;
+}
+
+size_t TEMPLATE_GCU_ARGMAX(const TEMPLATE_GCU_TYPE_UNION * data, size_t count) {
+  return count
+    ? TEMPLATE_GCU_FIND(data, count, TEMPLATE_GCU_MAX(data, count))
+    : 0;
+}
+
+#undef TEMPLATE_GCU_TYPE_UNION
+#undef TEMPLATE_COUNTER_T
+#undef TEMPLATE_LANES
+#undef TEMPLATE_SUFFIX
+#undef TEMPLATE_GCU_SUM
+#undef TEMPLATE_GCU_MIN
+#undef TEMPLATE_GCU_MAX
+#undef TEMPLATE_GCU_ARGMIN
+#undef TEMPLATE_GCU_ARGMAX
+#undef TEMPLATE_GCU_FIND
+#undef TEMPLATE_GCU_COUNT
+#undef TEMPLATE_GCU_COUNT_RANGE
@@ -0,0 +1,1026 @@
+/**
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cutil/memory.h>
+#include <cutil/roaring.h>
+
+// The word and array kernels are compiled several times, for increasingly wide
+// instruction sets, and the loader picks the widest one that the CPU supports.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__ELF__) && (__GNUC__ >= 11)
+#define SIMD_DISPATCH __attribute__((target_clones("default", "avx2", "arch=x86-64-v4")))
+#define POPCOUNT_DISPATCH __attribute__((target_clones("default", "popcnt", "arch=icelake-server")))
+#else
+#define SIMD_DISPATCH
+#define POPCOUNT_DISPATCH
+#endif
+
+// The largest array container.  An array of 4096 values takes 8 KiB, the same
+// as a bitmap, so any larger chunk is stored as a bitmap.
+#define ARRAY_MAX 4096
+#define BITMAP_WORDS 1024
+#define BITMAP_BYTES (BITMAP_WORDS * sizeof(uint64_t))
+
+// The number of array values compared against each other at once when
+// intersecting two arrays: one 256-bit register of 16-bit values.
+#define INTERSECT_BLOCK 16
+
+// GCC and Clang do not vectorize the all-against-all comparison on their own,
+// so it is written with their vector extensions.
+#if defined(__GNUC__)
+#define INTERSECT_VECTOR
+typedef uint16_t IntersectBlock __attribute__((vector_size(INTERSECT_BLOCK * sizeof(uint16_t))));
+#endif
+
+enum {
+  CONTAINER_ARRAY,
+  CONTAINER_BITMAP,
+  CONTAINER_RUN,
+};
+
+// A range of `length + 1` consecutive values, starting at `start`.
+typedef struct {
+  uint16_t start;
+  uint16_t length;
+} Run;
+
+struct GCU_Roaring32_Container {
+  uint8_t type;
+  uint32_t cardinality; ///< The number of values in the container.
+  uint32_t count;       ///< The number of array values or runs.
+  uint32_t capacity;    ///< The allocated number of array values or runs.
+  union {
+    uint16_t * values;  ///< CONTAINER_ARRAY: the sorted values.
+    uint64_t * words;   ///< CONTAINER_BITMAP: BITMAP_WORDS words.
+    Run * runs;         ///< CONTAINER_RUN: the sorted runs.
+  };
+};
+
+typedef GCU_Roaring32_Container Container;
+
+////////////////////////////////////////////////////////////////////////////
+// Kernels
+////////////////////////////////////////////////////////////////////////////
+
+POPCOUNT_DISPATCH
+static uint32_t popcount_words(const uint64_t * words) {
+  uint32_t total = 0;
+  for (size_t i = 0; i < BITMAP_WORDS; ++i) {
+    total += (uint32_t)__builtin_popcountll(words[i]);
+  }
+  return total;
+}
+
+SIMD_DISPATCH
+static void or_words(uint64_t * restrict destination, const uint64_t * restrict source) {
+  for (size_t i = 0; i < BITMAP_WORDS; ++i) {
+    destination[i] |= source[i];
+  }
+}
+
+SIMD_DISPATCH
+static void and_words(uint64_t * restrict destination, const uint64_t * restrict source) {
+  for (size_t i = 0; i < BITMAP_WORDS; ++i) {
+    destination[i] &= source[i];
+  }
+}
+
+// Intersect two sorted arrays into `out`, which must not overlap either input.
+//
+// Blocks of both arrays are compared all against all, by comparing each value
+// of the `b` block against the whole `a` block in one vector comparison, and
+// the block with the smaller maximum is then replaced by the next one.  This avoids the
+// unpredictable branch of a scalar merge at every value.  Since both arrays
+// are strictly increasing, each value of `a` matches at most once, and only
+// within a pair of blocks that are both current at some point.
+SIMD_DISPATCH
+static uint32_t intersect_arrays(const uint16_t * a, uint32_t na, const uint16_t * b, uint32_t nb, uint16_t * restrict out) {
+  uint32_t i = 0;
+  uint32_t j = 0;
+  uint32_t k = 0;
+  while (i + INTERSECT_BLOCK <= na && j + INTERSECT_BLOCK <= nb) {
+#ifdef INTERSECT_VECTOR
+    IntersectBlock block;
+    IntersectBlock match = {0};
+    memcpy(&block, &a[i], sizeof(block));
+    for (uint32_t y = 0; y < INTERSECT_BLOCK; ++y) {
+      match |= (IntersectBlock)(block == b[j + y]);
+    }
+#else
+    uint16_t match[INTERSECT_BLOCK] = {0};
+    for (uint32_t y = 0; y < INTERSECT_BLOCK; ++y) {
+      for (uint32_t x = 0; x < INTERSECT_BLOCK; ++x) {
+        match[x] |= a[i + x] == b[j + y];
+      }
+    }
+#endif
+    for (uint32_t x = 0; x < INTERSECT_BLOCK; ++x) {
+      out[k] = a[i + x];
+      k += match[x] & 1;
+    }
+    uint16_t aLast = a[i + INTERSECT_BLOCK - 1];
+    uint16_t bLast = b[j + INTERSECT_BLOCK - 1];
+    i += aLast <= bLast ? INTERSECT_BLOCK : 0;
+    j += bLast <= aLast ? INTERSECT_BLOCK : 0;
+  }
+
+  // Merge whatever is left, which is less than a block of one of the arrays.
+  while (i < na && j < nb) {
+    if (a[i] < b[j]) {
+      ++i;
+    }
+    else if (b[j] < a[i]) {
+      ++j;
+    }
+    else {
+      out[k++] = a[i];
+      ++i;
+      ++j;
+    }
+  }
+  return k;
+}
+
+// Find the position of the first value which is not less than `value`.
+static uint32_t array_lower_bound(const uint16_t * values, uint32_t count, uint16_t value) {
+  if (!count) {
+    return 0;
+  }
+  const uint16_t * base = values;
+  uint32_t n = count;
+  while (n > 1) {
+    uint32_t half = n / 2;
+    base = base[half] < value ? base + half : base;
+    n -= half;
+  }
+  return (uint32_t)(base - values) + (*base < value);
+}
+
+// Find the position of the last run which starts at or before `value`, or
+// `count` if there is none.
+static uint32_t run_find(const Run * runs, uint32_t count, uint16_t value) {
+  uint32_t low = 0;
+  uint32_t high = count;
+  while (low < high) {
+    uint32_t middle = low + (high - low) / 2;
+    if (runs[middle].start <= value) {
+      low = middle + 1;
+    }
+    else {
+      high = middle;
+    }
+  }
+  return low ? low - 1 : count;
+}
+
+static void bitmap_set_range(uint64_t * words, uint32_t start, uint32_t end) {
+  // Set the bits [start, end].
+  uint32_t first = start / 64;
+  uint32_t last = end / 64;
+  uint64_t firstMask = ~(uint64_t)0 << (start % 64);
+  uint64_t lastMask = ~(uint64_t)0 >> (63 - end % 64);
+  if (first == last) {
+    words[first] |= firstMask & lastMask;
+    return;
+  }
+  words[first] |= firstMask;
+  for (uint32_t i = first + 1; i < last; ++i) {
+    words[i] = ~(uint64_t)0;
+  }
+  words[last] |= lastMask;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Containers
+////////////////////////////////////////////////////////////////////////////
+
+static Container * container_create_array(uint32_t capacity) {
+  Container * container = gcu_malloc(sizeof(Container));
+  if (!container) {
+    return 0;
+  }
+  *container = (Container) {
+    .type = CONTAINER_ARRAY,
+    .cardinality = 0,
+    .count = 0,
+    .capacity = capacity,
+    .values = gcu_malloc(capacity * sizeof(uint16_t)),
+  };
+  if (!container->values) {
+    gcu_free(container);
+    return 0;
+  }
+  return container;
+}
+
+static void container_destroy(Container * container) {
+  if (container) {
+    gcu_free(container->values);
+    gcu_free(container);
+  }
+}
+
+static Container * container_clone(const Container * source) {
+  size_t bytes = source->type == CONTAINER_BITMAP
+    ? BITMAP_BYTES
+    : source->type == CONTAINER_RUN
+      ? source->count * sizeof(Run)
+      : source->count * sizeof(uint16_t);
+  Container * container = gcu_malloc(sizeof(Container));
+  if (!container) {
+    return 0;
+  }
+  *container = *source;
+  container->capacity = source->count;
+  container->values = gcu_malloc(bytes ? bytes : 1);
+  if (!container->values) {
+    gcu_free(container);
+    return 0;
+  }
+  memcpy(container->values, source->values, bytes);
+  return container;
+}
+
+static size_t container_size_in_bytes(const Container * container) {
+  return sizeof(Container) + (container->type == CONTAINER_BITMAP
+    ? BITMAP_BYTES
+    : container->type == CONTAINER_RUN
+      ? container->capacity * sizeof(Run)
+      : container->capacity * sizeof(uint16_t));
+}
+
+static bool container_contains(const Container * container, uint16_t value) {
+  switch (container->type) {
+    case CONTAINER_ARRAY: {
+      uint32_t position = array_lower_bound(container->values, container->count, value);
+      return position < container->count && container->values[position] == value;
+    }
+    case CONTAINER_BITMAP:
+      return (container->words[value / 64] >> (value % 64)) & 1;
+    default: {
+      uint32_t position = run_find(container->runs, container->count, value);
+      return position < container->count
+        && (uint32_t)(value - container->runs[position].start) <= container->runs[position].length;
+    }
+  }
+}
+
+// Replace the contents of the container with a bitmap.
+static bool container_to_bitmap(Container * container) {
+  uint64_t * words = gcu_calloc(BITMAP_WORDS, sizeof(uint64_t));
+  if (!words) {
+    return false;
+  }
+  if (container->type == CONTAINER_ARRAY) {
+    for (uint32_t i = 0; i < container->count; ++i) {
+      words[container->values[i] / 64] |= (uint64_t)1 << (container->values[i] % 64);
+    }
+  }
+  else {
+    for (uint32_t i = 0; i < container->count; ++i) {
+      bitmap_set_range(words, container->runs[i].start, (uint32_t)container->runs[i].start + container->runs[i].length);
+    }
+  }
+  gcu_free(container->values);
+  container->type = CONTAINER_BITMAP;
+  container->words = words;
+  container->count = 0;
+  container->capacity = 0;
+  return true;
+}
+
+// Replace the contents of the container with an array.
+static bool container_to_array(Container * container) {
+  uint32_t capacity = container->cardinality ? container->cardinality : 1;
+  uint16_t * values = gcu_malloc(capacity * sizeof(uint16_t));
+  if (!values) {
+    return false;
+  }
+  uint32_t count = 0;
+  if (container->type == CONTAINER_BITMAP) {
+    for (uint32_t i = 0; i < BITMAP_WORDS; ++i) {
+      for (uint64_t word = container->words[i]; word; word &= word - 1) {
+        values[count++] = (uint16_t)(i * 64 + (uint32_t)__builtin_ctzll(word));
+      }
+    }
+  }
+  else {
+    for (uint32_t i = 0; i < container->count; ++i) {
+      for (uint32_t value = container->runs[i].start; value <= (uint32_t)container->runs[i].start + container->runs[i].length; ++value) {
+        values[count++] = (uint16_t)value;
+      }
+    }
+  }
+  gcu_free(container->values);
+  container->type = CONTAINER_ARRAY;
+  container->values = values;
+  container->count = count;
+  container->capacity = capacity;
+  return true;
+}
+
+// Make sure that the container is an array if it holds at most ARRAY_MAX
+// values, and a bitmap otherwise.
+static bool container_normalize(Container * container) {
+  bool small = container->cardinality <= ARRAY_MAX;
+  if (container->type == CONTAINER_RUN) {
+    return small
+      ? container_to_array(container)
+      : container_to_bitmap(container);
+  }
+  if (container->type == CONTAINER_BITMAP && small) {
+    return container_to_array(container);
+  }
+  if (container->type == CONTAINER_ARRAY && !small) {
+    return container_to_bitmap(container);
+  }
+  return true;
+}
+
+static bool container_add(Container * container, uint16_t value) {
+  if (container->type == CONTAINER_RUN) {
+    if (container_contains(container, value)) {
+      return true;
+    }
+    if (!container_normalize(container)) {
+      return false;
+    }
+  }
+
+  if (container->type == CONTAINER_ARRAY) {
+    uint32_t position = array_lower_bound(container->values, container->count, value);
+    if (position < container->count && container->values[position] == value) {
+      return true;
+    }
+    if (container->count == ARRAY_MAX) {
+      if (!container_to_bitmap(container)) {
+        return false;
+      }
+    }
+    else {
+      if (container->count == container->capacity) {
+        uint32_t capacity = container->capacity < 4
+          ? 4
+          : container->capacity < 64
+            ? container->capacity * 2
+            : container->capacity + container->capacity / 2;
+        capacity = capacity > ARRAY_MAX ? ARRAY_MAX : capacity;
+        uint16_t * values = gcu_realloc(container->values, capacity * sizeof(uint16_t));
+        if (!values) {
+          return false;
+        }
+        container->values = values;
+        container->capacity = capacity;
+      }
+      memmove(&container->values[position + 1], &container->values[position], (container->count - position) * sizeof(uint16_t));
+      container->values[position] = value;
+      ++container->count;
+      ++container->cardinality;
+      return true;
+    }
+  }
+
+  uint64_t bit = (uint64_t)1 << (value % 64);
+  container->cardinality += !(container->words[value / 64] & bit);
+  container->words[value / 64] |= bit;
+  return true;
+}
+
+static bool container_remove(Container * container, uint16_t value) {
+  if (!container_contains(container, value)) {
+    return true;
+  }
+  if (container->type == CONTAINER_RUN && !container_normalize(container)) {
+    return false;
+  }
+
+  if (container->type == CONTAINER_ARRAY) {
+    uint32_t position = array_lower_bound(container->values, container->count, value);
+    memmove(&container->values[position], &container->values[position + 1], (container->count - position - 1) * sizeof(uint16_t));
+    --container->count;
+    --container->cardinality;
+    return true;
+  }
+
+  container->words[value / 64] &= ~((uint64_t)1 << (value % 64));
+  --container->cardinality;
+
+  // A failure to shrink leaves a valid, if oversized, bitmap.
+  container_normalize(container);
+  return true;
+}
+
+// Count the runs of consecutive values in an array or bitmap container.
+static uint32_t container_count_runs(const Container * container) {
+  uint32_t runs = 0;
+  if (container->type == CONTAINER_ARRAY) {
+    for (uint32_t i = 0; i < container->count; ++i) {
+      runs += !i || container->values[i] != container->values[i - 1] + 1;
+    }
+  }
+  else {
+    // A run starts at every set bit whose lower neighbour is clear.
+    uint64_t carry = 0;
+    for (uint32_t i = 0; i < BITMAP_WORDS; ++i) {
+      uint64_t word = container->words[i];
+      runs += (uint32_t)__builtin_popcountll(word & ~((word << 1) | carry));
+      carry = word >> 63;
+    }
+  }
+  return runs;
+}
+
+static bool container_run_optimize(Container * container) {
+  if (container->type == CONTAINER_RUN) {
+    return true;
+  }
+  uint32_t count = container_count_runs(container);
+  size_t bytes = container->type == CONTAINER_BITMAP
+    ? BITMAP_BYTES
+    : container->count * sizeof(uint16_t);
+  if (count * sizeof(Run) >= bytes) {
+    return true;
+  }
+
+  Run * runs = gcu_malloc(count * sizeof(Run));
+  if (!runs) {
+    return false;
+  }
+  uint32_t n = 0;
+  uint32_t previous = 0;
+  bool first = true;
+  if (container->type == CONTAINER_ARRAY) {
+    for (uint32_t i = 0; i < container->count; ++i) {
+      uint32_t value = container->values[i];
+      if (first || value != previous + 1) {
+        runs[n++] = (Run){.start = (uint16_t)value, .length = 0};
+      }
+      else {
+        ++runs[n - 1].length;
+      }
+      previous = value;
+      first = false;
+    }
+  }
+  else {
+    for (uint32_t i = 0; i < BITMAP_WORDS; ++i) {
+      for (uint64_t word = container->words[i]; word; word &= word - 1) {
+        uint32_t value = i * 64 + (uint32_t)__builtin_ctzll(word);
+        if (first || value != previous + 1) {
+          runs[n++] = (Run){.start = (uint16_t)value, .length = 0};
+        }
+        else {
+          ++runs[n - 1].length;
+        }
+        previous = value;
+        first = false;
+      }
+    }
+  }
+  gcu_free(container->values);
+  container->type = CONTAINER_RUN;
+  container->runs = runs;
+  container->count = n;
+  container->capacity = n;
+  return true;
+}
+
+// Get a copy of a container which is not made of runs, or the container
+// itself if it is not.  The copy must be destroyed by the caller.
+static const Container * container_expanded(const Container * container, Container ** copy) {
+  *copy = 0;
+  if (container->type != CONTAINER_RUN) {
+    return container;
+  }
+  *copy = container_clone(container);
+  if (!*copy || !container_normalize(*copy)) {
+    container_destroy(*copy);
+    *copy = 0;
+    return 0;
+  }
+  return *copy;
+}
+
+static bool container_or(Container * destination, const Container * original) {
+  Container * copy;
+  const Container * source = container_expanded(original, &copy);
+  if (!source || !container_normalize(destination)) {
+    container_destroy(copy);
+    return false;
+  }
+
+  bool success = true;
+  if (destination->type == CONTAINER_ARRAY && source->type == CONTAINER_ARRAY
+      && destination->cardinality + source->cardinality <= ARRAY_MAX) {
+    // Merge the two arrays on the stack, then copy the result back, so that
+    // the destination only needs to be reallocated if it is too small.
+    uint16_t values[ARRAY_MAX];
+    const uint16_t * a = destination->values;
+    const uint16_t * b = source->values;
+    uint32_t i = 0;
+    uint32_t j = 0;
+    uint32_t k = 0;
+    while (i < destination->count && j < source->count) {
+      uint16_t x = a[i];
+      uint16_t y = b[j];
+      values[k++] = x < y ? x : y;
+      i += x <= y;
+      j += y <= x;
+    }
+    while (i < destination->count) {
+      values[k++] = a[i++];
+    }
+    while (j < source->count) {
+      values[k++] = b[j++];
+    }
+    if (k > destination->capacity) {
+      uint16_t * grown = gcu_realloc(destination->values, k * sizeof(uint16_t));
+      if (grown) {
+        destination->values = grown;
+        destination->capacity = k;
+      }
+    }
+    if (k <= destination->capacity) {
+      memcpy(destination->values, values, k * sizeof(uint16_t));
+      destination->count = destination->cardinality = k;
+    }
+    else {
+      success = false;
+    }
+  }
+  else if (destination->type == CONTAINER_BITMAP || container_to_bitmap(destination)) {
+    if (source->type == CONTAINER_BITMAP) {
+      or_words(destination->words, source->words);
+    }
+    else {
+      for (uint32_t i = 0; i < source->count; ++i) {
+        destination->words[source->values[i] / 64] |= (uint64_t)1 << (source->values[i] % 64);
+      }
+    }
+    destination->cardinality = popcount_words(destination->words);
+    success = container_normalize(destination);
+  }
+  else {
+    success = false;
+  }
+
+  container_destroy(copy);
+  return success;
+}
+
+static bool container_and(Container * destination, const Container * original) {
+  Container * copy;
+  const Container * source = container_expanded(original, &copy);
+  if (!source || !container_normalize(destination)) {
+    container_destroy(copy);
+    return false;
+  }
+
+  bool success = true;
+  if (destination->type == CONTAINER_ARRAY && source->type == CONTAINER_ARRAY) {
+    // The intersection is no larger than the destination, so it is copied
+    // back into the same storage.
+    uint16_t values[ARRAY_MAX];
+    uint32_t count = intersect_arrays(destination->values, destination->count, source->values, source->count, values);
+    memcpy(destination->values, values, count * sizeof(uint16_t));
+    destination->count = destination->cardinality = count;
+  }
+  else if (destination->type == CONTAINER_ARRAY) {
+    // Keep the values which are set in the bitmap.
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < destination->count; ++i) {
+      uint16_t value = destination->values[i];
+      destination->values[count] = value;
+      count += (source->words[value / 64] >> (value % 64)) & 1;
+    }
+    destination->count = destination->cardinality = count;
+  }
+  else if (source->type == CONTAINER_ARRAY) {
+    // The result is the values of the array which are set in the bitmap.
+    uint16_t * values = gcu_malloc((source->count ? source->count : 1) * sizeof(uint16_t));
+    if (!values) {
+      success = false;
+    }
+    else {
+      uint32_t count = 0;
+      for (uint32_t i = 0; i < source->count; ++i) {
+        uint16_t value = source->values[i];
+        values[count] = value;
+        count += (destination->words[value / 64] >> (value % 64)) & 1;
+      }
+      gcu_free(destination->words);
+      destination->type = CONTAINER_ARRAY;
+      destination->values = values;
+      destination->count = destination->cardinality = count;
+      destination->capacity = source->count ? source->count : 1;
+    }
+  }
+  else {
+    and_words(destination->words, source->words);
+    destination->cardinality = popcount_words(destination->words);
+    container_normalize(destination);
+  }
+
+  container_destroy(copy);
+  return success;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Bitmap
+////////////////////////////////////////////////////////////////////////////
+
+#define CONTAINER(roaring, i) ((Container *)(roaring)->containers.data[i].p)
+
+// Find the position of the first key which is not less than `key`.
+static size_t key_lower_bound(const GCU_Roaring32 * roaring, uint16_t key) {
+  size_t count = roaring->keys.count;
+  if (!count) {
+    return 0;
+  }
+  // Values are usually added in ascending order, so check the end first.
+  if (roaring->keys.data[count - 1].ui16 < key) {
+    return count;
+  }
+  const GCU_Type16_Union * base = roaring->keys.data;
+  size_t n = count;
+  while (n > 1) {
+    size_t half = n / 2;
+    base = base[half].ui16 < key ? base + half : base;
+    n -= half;
+  }
+  return (size_t)(base - roaring->keys.data) + (base->ui16 < key);
+}
+
+// Find the container of a key, or NULL if there is none.
+static Container * find_container(const GCU_Roaring32 * roaring, uint16_t key) {
+  size_t position = key_lower_bound(roaring, key);
+  return position < roaring->keys.count && roaring->keys.data[position].ui16 == key
+    ? CONTAINER(roaring, position)
+    : 0;
+}
+
+// Insert a container at a position, keeping the keys in order.
+static bool insert_container(GCU_Roaring32 * roaring, size_t position, uint16_t key, Container * container) {
+  size_t count = roaring->keys.count;
+  if (!gcu_vector16_append(&roaring->keys, gcu_type16_ui16(key))) {
+    return false;
+  }
+  if (!gcu_vector64_append(&roaring->containers, gcu_type64_p(container))) {
+    --roaring->keys.count;
+    return false;
+  }
+  if (position < count) {
+    memmove(&roaring->keys.data[position + 1], &roaring->keys.data[position], (count - position) * sizeof(GCU_Type16_Union));
+    memmove(&roaring->containers.data[position + 1], &roaring->containers.data[position], (count - position) * sizeof(GCU_Type64_Union));
+    roaring->keys.data[position] = gcu_type16_ui16(key);
+    roaring->containers.data[position] = gcu_type64_p(container);
+  }
+  return true;
+}
+
+static void remove_container(GCU_Roaring32 * roaring, size_t position) {
+  size_t count = roaring->keys.count;
+  container_destroy(CONTAINER(roaring, position));
+  memmove(&roaring->keys.data[position], &roaring->keys.data[position + 1], (count - position - 1) * sizeof(GCU_Type16_Union));
+  memmove(&roaring->containers.data[position], &roaring->containers.data[position + 1], (count - position - 1) * sizeof(GCU_Type64_Union));
+  --roaring->keys.count;
+  --roaring->containers.count;
+}
+
+GCU_Roaring32 * gcu_roaring32_create(void) {
+  // Malloc Zeroed-out memory.
+  GCU_Roaring32 * roaring = gcu_calloc(1, sizeof(GCU_Roaring32));
+
+  // If the allocation failed, return null.
+  if (!roaring) {
+    return 0;
+  }
+
+  if (!gcu_roaring32_create_in_place(roaring)) {
+    gcu_free(roaring);
+    return 0;
+  }
+
+  return roaring;
+}
+
+bool gcu_roaring32_create_in_place(GCU_Roaring32 * roaring) {
+  *roaring = (GCU_Roaring32) {
+    .supplementary_data = 0,
+    .cleanup = 0,
+  };
+
+  if (!gcu_vector16_create_in_place(&roaring->keys, 0)) {
+    return false;
+  }
+  if (!gcu_vector64_create_in_place(&roaring->containers, 0)) {
+    gcu_vector16_destroy_in_place(&roaring->keys);
+    return false;
+  }
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+  // Allocate the mutex.
+  bool failure = GCU_MUTEX_CREATE(roaring->mutex);
+
+  // If the allocation failed, clean up and return null.
+  if (failure) {
+    gcu_vector64_destroy_in_place(&roaring->containers);
+    gcu_vector16_destroy_in_place(&roaring->keys);
+    return false;
+  }
+#endif
+
+  return true;
+}
+
+void gcu_roaring32_destroy(GCU_Roaring32 * roaring) {
+  // Verify that the pointer actually points to something.
+  if (roaring) {
+    gcu_roaring32_destroy_in_place(roaring);
+    gcu_free(roaring);
+  }
+}
+
+void gcu_roaring32_destroy_in_place(GCU_Roaring32 * roaring) {
+  // Verify that the pointer actually points to something.
+  if (roaring) {
+    // Call the `cleanup` function, if it exists.
+    if (roaring->cleanup) {
+      roaring->cleanup(roaring);
+    }
+
+    for (size_t i = 0; i < roaring->containers.count; ++i) {
+      container_destroy(CONTAINER(roaring, i));
+    }
+    gcu_vector64_destroy_in_place(&roaring->containers);
+    gcu_vector16_destroy_in_place(&roaring->keys);
+
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
+    GCU_MUTEX_DESTROY(roaring->mutex);
+#endif
+  }
+}
+
+bool gcu_roaring32_add(GCU_Roaring32 * roaring, uint32_t value) {
+  uint16_t key = (uint16_t)(value >> 16);
+  size_t position = key_lower_bound(roaring, key);
+  if (position < roaring->keys.count && roaring->keys.data[position].ui16 == key) {
+    return container_add(CONTAINER(roaring, position), (uint16_t)value);
+  }
+
+  Container * container = container_create_array(4);
+  if (!container) {
+    return false;
+  }
+  if (!container_add(container, (uint16_t)value) || !insert_container(roaring, position, key, container)) {
+    container_destroy(container);
+    return false;
+  }
+  return true;
+}
+
+bool gcu_roaring32_remove(GCU_Roaring32 * roaring, uint32_t value) {
+  uint16_t key = (uint16_t)(value >> 16);
+  size_t position = key_lower_bound(roaring, key);
+  if (position >= roaring->keys.count || roaring->keys.data[position].ui16 != key) {
+    return true;
+  }
+  Container * container = CONTAINER(roaring, position);
+  if (!container_remove(container, (uint16_t)value)) {
+    return false;
+  }
+  if (!container->cardinality) {
+    remove_container(roaring, position);
+  }
+  return true;
+}
+
+bool gcu_roaring32_contains(GCU_Roaring32 * roaring, uint32_t value) {
+  Container * container = find_container(roaring, (uint16_t)(value >> 16));
+  return container && container_contains(container, (uint16_t)value);
+}
+
+uint64_t gcu_roaring32_cardinality(GCU_Roaring32 * roaring) {
+  uint64_t total = 0;
+  for (size_t i = 0; i < roaring->containers.count; ++i) {
+    total += CONTAINER(roaring, i)->cardinality;
+  }
+  return total;
+}
+
+size_t gcu_roaring32_size_in_bytes(GCU_Roaring32 * roaring) {
+  size_t total = sizeof(GCU_Roaring32)
+    + roaring->keys.capacity * sizeof(GCU_Type16_Union)
+    + roaring->containers.capacity * sizeof(GCU_Type64_Union);
+  for (size_t i = 0; i < roaring->containers.count; ++i) {
+    total += container_size_in_bytes(CONTAINER(roaring, i));
+  }
+  return total;
+}
+
+bool gcu_roaring32_run_optimize(GCU_Roaring32 * roaring) {
+  bool success = true;
+  for (size_t i = 0; i < roaring->containers.count; ++i) {
+    success &= container_run_optimize(CONTAINER(roaring, i));
+  }
+  return success;
+}
+
+bool gcu_roaring32_or(GCU_Roaring32 * destination, GCU_Roaring32 * source) {
+  if (destination == source) {
+    return true;
+  }
+
+  // Merge the containers into new vectors, so that every container is only
+  // moved once.
+  GCU_Vector16 keys;
+  GCU_Vector64 containers;
+  size_t capacity = destination->keys.count + source->keys.count;
+  if (!gcu_vector16_create_in_place(&keys, capacity)) {
+    return false;
+  }
+  if (!gcu_vector64_create_in_place(&containers, capacity)) {
+    gcu_vector16_destroy_in_place(&keys);
+    return false;
+  }
+  if (capacity && (!keys.data || !containers.data)) {
+    gcu_vector64_destroy_in_place(&containers);
+    gcu_vector16_destroy_in_place(&keys);
+    return false;
+  }
+
+  bool success = true;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < destination->keys.count || j < source->keys.count) {
+    uint16_t a = i < destination->keys.count ? destination->keys.data[i].ui16 : 0;
+    uint16_t b = j < source->keys.count ? source->keys.data[j].ui16 : 0;
+    if (j == source->keys.count || (i < destination->keys.count && a < b)) {
+      keys.data[keys.count++].ui16 = a;
+      containers.data[containers.count++] = destination->containers.data[i++];
+    }
+    else if (i == destination->keys.count || b < a) {
+      Container * clone = container_clone(CONTAINER(source, j));
+      if (clone) {
+        keys.data[keys.count++].ui16 = b;
+        containers.data[containers.count++] = gcu_type64_p(clone);
+      }
+      success &= clone != 0;
+      ++j;
+    }
+    else {
+      success &= container_or(CONTAINER(destination, i), CONTAINER(source, j));
+      keys.data[keys.count++].ui16 = a;
+      containers.data[containers.count++] = destination->containers.data[i++];
+      ++j;
+    }
+  }
+
+  // Swap in the new vectors.
+  GCU_Type16_Union * oldKeys = destination->keys.data;
+  GCU_Type64_Union * oldContainers = destination->containers.data;
+  size_t oldKeysCapacity = destination->keys.capacity;
+  size_t oldContainersCapacity = destination->containers.capacity;
+  destination->keys.data = keys.data;
+  destination->keys.count = keys.count;
+  destination->keys.capacity = keys.capacity;
+  destination->containers.data = containers.data;
+  destination->containers.count = containers.count;
+  destination->containers.capacity = containers.capacity;
+  keys.data = oldKeys;
+  keys.capacity = oldKeysCapacity;
+  containers.data = oldContainers;
+  containers.capacity = oldContainersCapacity;
+  gcu_vector64_destroy_in_place(&containers);
+  gcu_vector16_destroy_in_place(&keys);
+  return success;
+}
+
+bool gcu_roaring32_and(GCU_Roaring32 * destination, GCU_Roaring32 * source) {
+  if (destination == source) {
+    return true;
+  }
+
+  // Keep only the containers whose keys are in both bitmaps, compacting them
+  // towards the front.
+  bool success = true;
+  size_t count = 0;
+  size_t j = 0;
+  for (size_t i = 0; i < destination->keys.count; ++i) {
+    uint16_t key = destination->keys.data[i].ui16;
+    Container * container = CONTAINER(destination, i);
+    while (j < source->keys.count && source->keys.data[j].ui16 < key) {
+      ++j;
+    }
+    if (j < source->keys.count && source->keys.data[j].ui16 == key) {
+      if (!container_and(container, CONTAINER(source, j))) {
+        success = false;
+      }
+    }
+    else {
+      container->cardinality = 0;
+    }
+    if (container->cardinality) {
+      destination->keys.data[count] = destination->keys.data[i];
+      destination->containers.data[count] = destination->containers.data[i];
+      ++count;
+    }
+    else {
+      container_destroy(container);
+    }
+  }
+  destination->keys.count = count;
+  destination->containers.count = count;
+  return success;
+}
+
+// Point the iterator at the first value of the container at `position`, or
+// of the first container after it.
+static GCU_Roaring32_Iterator iterator_first(GCU_Roaring32 * roaring, size_t position) {
+  if (position >= roaring->containers.count) {
+    return (GCU_Roaring32_Iterator) {
+      .container = roaring->containers.count,
+      .index = 0,
+      .exists = false,
+      .value = 0,
+      .roaring = roaring,
+    };
+  }
+
+  // Containers are never empty.
+  Container * container = CONTAINER(roaring, position);
+  uint32_t low = 0;
+  switch (container->type) {
+    case CONTAINER_ARRAY:
+      low = container->values[0];
+      break;
+    case CONTAINER_BITMAP: {
+      uint32_t word = 0;
+      while (!container->words[word]) {
+        ++word;
+      }
+      low = word * 64 + (uint32_t)__builtin_ctzll(container->words[word]);
+      break;
+    }
+    default:
+      low = container->runs[0].start;
+  }
+  return (GCU_Roaring32_Iterator) {
+    .container = position,
+    .index = 0,
+    .exists = true,
+    .value = ((uint32_t)roaring->keys.data[position].ui16 << 16) | low,
+    .roaring = roaring,
+  };
+}
+
+GCU_Roaring32_Iterator gcu_roaring32_iterator_get(GCU_Roaring32 * roaring) {
+  return iterator_first(roaring, 0);
+}
+
+GCU_Roaring32_Iterator gcu_roaring32_iterator_next(GCU_Roaring32_Iterator iterator) {
+  if (!iterator.exists) {
+    return iterator;
+  }
+
+  Container * container = CONTAINER(iterator.roaring, iterator.container);
+  uint32_t high = iterator.value & 0xFFFF0000u;
+  uint32_t low = iterator.value & 0xFFFFu;
+  switch (container->type) {
+    case CONTAINER_ARRAY:
+      if (iterator.index + 1 < container->count) {
+        ++iterator.index;
+        iterator.value = high | container->values[iterator.index];
+        return iterator;
+      }
+      break;
+    case CONTAINER_BITMAP:
+      if (low < 0xFFFF) {
+        uint32_t word = (low + 1) / 64;
+        uint64_t bits = container->words[word] & (~(uint64_t)0 << ((low + 1) % 64));
+        while (!bits && ++word < BITMAP_WORDS) {
+          bits = container->words[word];
+        }
+        if (bits) {
+          iterator.value = high | (word * 64 + (uint32_t)__builtin_ctzll(bits));
+          return iterator;
+        }
+      }
+      break;
+    default: {
+      Run run = container->runs[iterator.index];
+      if (low < (uint32_t)run.start + run.length) {
+        ++iterator.value;
+        return iterator;
+      }
+      if (iterator.index + 1 < container->count) {
+        ++iterator.index;
+        iterator.value = high | container->runs[iterator.index].start;
+        return iterator;
+      }
+    }
+  }
+  return iterator_first(iterator.roaring, iterator.container + 1);
+}
@@ -0,0 +1,161 @@
+/**
+ * @file
+ *
+ * This file implements the per-thread scratch stack.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <cutil/memory.h>
+#include <cutil/scratch.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+//
+// A buffer too large for the region, which comes from gcu_malloc().  The
+// buffers of a thread form a list, newest first.
+//
+typedef struct Block {
+  struct Block * next;          // The next older buffer, or NULL.
+  max_align_t data[];           // The memory handed out.
+} Block;
+
+_Thread_local GCU_Scratch * gcu_scratch = 0;
+
+// Free a thread's region, and any buffers from gcu_malloc() still in use.
+static void free_region(void * pointer) {
+  GCU_Scratch * scratch = pointer;
+  Block * block = scratch->heap;
+  while (block) {
+    Block * next = block->next;
+    gcu_free(block);
+    block = next;
+  }
+  gcu_arena_destroy_in_place(&scratch->arena);
+  gcu_free(scratch);
+  gcu_scratch = 0;
+}
+
+// The thread-exit hook which frees a thread's region.
+#ifdef _WIN32
+static INIT_ONCE exit_hook_once = INIT_ONCE_STATIC_INIT;
+static DWORD exit_hook;
+
+static void NTAPI free_region_at_exit(void * pointer) {
+  if (pointer) {
+    free_region(pointer);
+  }
+}
+
+static BOOL CALLBACK create_exit_hook(PINIT_ONCE once, void * parameter, void ** context) {
+  (void)once;
+  (void)parameter;
+  (void)context;
+  exit_hook = FlsAlloc(free_region_at_exit);
+  return TRUE;
+}
+
+static void set_exit_hook(GCU_Scratch * pointer) {
+  InitOnceExecuteOnce(&exit_hook_once, create_exit_hook, 0, 0);
+  if (exit_hook != FLS_OUT_OF_INDEXES) {
+    FlsSetValue(exit_hook, pointer);
+  }
+}
+#else
+static pthread_once_t exit_hook_once = PTHREAD_ONCE_INIT;
+static pthread_key_t exit_hook;
+static bool exit_hook_created = false;
+
+static void create_exit_hook(void) {
+  exit_hook_created = !pthread_key_create(&exit_hook, free_region);
+}
+
+static void set_exit_hook(GCU_Scratch * pointer) {
+  pthread_once(&exit_hook_once, create_exit_hook);
+  if (exit_hook_created) {
+    pthread_setspecific(exit_hook, pointer);
+  }
+}
+#endif // _WIN32
+
+GCU_Scratch * gcu_scratch_claim(void) {
+  // The first chunk is put in use at once, so that marks always name a chunk
+  // and rewinding to them only moves the cursor.
+  GCU_Scratch * scratch = gcu_malloc(sizeof(GCU_Scratch));
+  if (!scratch) {
+    return 0;
+  }
+  if (!gcu_arena_create_in_place(&scratch->arena, GCU_SCRATCH_CHUNK_SIZE)) {
+    gcu_free(scratch);
+    return 0;
+  }
+  if (!gcu_arena_allocate(&scratch->arena, 0)) {
+    gcu_arena_destroy_in_place(&scratch->arena);
+    gcu_free(scratch);
+    return 0;
+  }
+  scratch->heap = 0;
+  scratch->in_use = 0;
+  scratch->high_water = 0;
+  gcu_scratch = scratch;
+  set_exit_hook(scratch);
+  return scratch;
+}
+
+void * gcu_scratch_allocate_slow(size_t size) {
+  GCU_Scratch * scratch = gcu_scratch
+    ? gcu_scratch
+    : gcu_scratch_claim();
+  if (!scratch) {
+    return 0;
+  }
+  void * pointer;
+  if (size > GCU_SCRATCH_LARGEST_SIZE) {
+    if (size > SIZE_MAX - sizeof(Block)) {
+      return 0;
+    }
+    Block * block = gcu_malloc(sizeof(Block) + size);
+    if (!block) {
+      return 0;
+    }
+    block->next = scratch->heap;
+    scratch->heap = block;
+    pointer = block->data;
+  }
+  else {
+    pointer = gcu_arena_allocate(&scratch->arena, size);
+    if (!pointer) {
+      return 0;
+    }
+  }
+  scratch->in_use += size;
+  if (scratch->in_use > scratch->high_water) {
+    scratch->high_water = scratch->in_use;
+  }
+  return pointer;
+}
+
+void gcu_scratch_rewind_slow(GCU_Scratch_Mark mark) {
+  GCU_Scratch * scratch = gcu_scratch;
+  if (!scratch) {
+    return;
+  }
+  while (scratch->heap != mark.heap) {
+    Block * next = ((Block *)scratch->heap)->next;
+    gcu_free(scratch->heap);
+    scratch->heap = next;
+  }
+  gcu_arena_rewind(&scratch->arena, mark.arena);
+  scratch->in_use = mark.in_use;
+}
+
+void gcu_scratch_release(void) {
+  if (gcu_scratch) {
+    set_exit_hook(0);
+    free_region(gcu_scratch);
+  }
+}
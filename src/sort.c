@@ -0,0 +1,118 @@
+/**
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <cutil/memory.h>
+#include <cutil/scratch.h>
+#include <cutil/sort.h>
+
+// Inputs smaller than this are sorted with the quicksort.  Below this size the
+// radix sort is dominated by the cost of clearing and scanning its histograms.
+#define RADIX_THRESHOLD 256
+
+// Quicksort partitions of this size or smaller are finished with an insertion
+// sort.
+#define INSERTION_THRESHOLD 16
+
+// Inputs smaller than this are not worth distributing across a pool, and are
+// sorted on the calling thread.
+#define PARALLEL_SORT_THRESHOLD (1 << 16)
+
+// Transforms from the raw bits of a value to an unsigned key which sorts in
+// the same order as the value itself.  `sign` is the most significant bit.
+#define UNSIGNED_KEY(bits, sign) (bits)
+#define SIGNED_KEY(bits, sign) ((bits) ^ (sign))
+#define FLOAT_KEY(bits, sign) ((bits) ^ ((0 - ((bits) >> (BITDEPTH - 1))) | (sign)))
+
+// Get the bounds of the chunk for task `index`.
+static inline size_t par_chunk(size_t index, size_t chunk, size_t count, size_t * begin) {
+  *begin = index * chunk;
+  size_t remaining = count - *begin;
+  return remaining < chunk
+    ? remaining
+    : chunk;
+}
+
+#define BITDEPTH 64
+#define LANE ui64
+#define TYPE uint64_t
+#define SORT_KEY UNSIGNED_KEY
+#include "sort.template.c"
+#undef LANE
+#undef TYPE
+#undef SORT_KEY
+#define LANE i64
+#define TYPE int64_t
+#define SORT_KEY SIGNED_KEY
+#include "sort.template.c"
+#undef LANE
+#undef TYPE
+#undef SORT_KEY
+#define LANE f64
+#define TYPE double
+#define SORT_KEY FLOAT_KEY
+#include "sort.template.c"
+#undef LANE
+#undef TYPE
+#undef SORT_KEY
+#undef BITDEPTH
+
+#define BITDEPTH 32
+#define LANE ui32
+#define TYPE uint32_t
+#define SORT_KEY UNSIGNED_KEY
+#include "sort.template.c"
+#undef LANE
+#undef TYPE
+#undef SORT_KEY
+#define LANE i32
+#define TYPE int32_t
+#define SORT_KEY SIGNED_KEY
+#include "sort.template.c"
+#undef LANE
+#undef TYPE
+#undef SORT_KEY
+#define LANE f32
+#define TYPE float
+#define SORT_KEY FLOAT_KEY
+#include "sort.template.c"
+#undef LANE
+#undef TYPE
+#undef SORT_KEY
+#undef BITDEPTH
+
+#define BITDEPTH 16
+#define LANE ui16
+#define TYPE uint16_t
+#define SORT_KEY UNSIGNED_KEY
+#include "sort.template.c"
+#undef LANE
+#undef TYPE
+#undef SORT_KEY
+#define LANE i16
+#define TYPE int16_t
+#define SORT_KEY SIGNED_KEY
+#include "sort.template.c"
+#undef LANE
+#undef TYPE
+#undef SORT_KEY
+#undef BITDEPTH
+
+#define BITDEPTH 8
+#define LANE ui8
+#define TYPE uint8_t
+#define SORT_KEY UNSIGNED_KEY
+#include "sort.template.c"
+#undef LANE
+#undef TYPE
+#undef SORT_KEY
+#define LANE i8
+#define TYPE int8_t
+#define SORT_KEY SIGNED_KEY
+#include "sort.template.c"
+#undef LANE
+#undef TYPE
+#undef SORT_KEY
+#undef BITDEPTH
@@ -0,0 +1,378 @@
+#define TEMPLATE_GCU_VECTOR         GHOTIIO_CUTIL_CONCAT2(GCU_Vector, BITDEPTH)
+#define TEMPLATE_GCU_TYPE_UNION     GHOTIIO_CUTIL_CONCAT3(GCU_Type, BITDEPTH, _Union)
+#define TEMPLATE_KEY_T              GHOTIIO_CUTIL_CONCAT3(uint, BITDEPTH, _t)
+#define TEMPLATE_BITS               GHOTIIO_CUTIL_CONCAT2(ui, BITDEPTH)
+#define TEMPLATE_SIGN               ((TEMPLATE_KEY_T)1 << (BITDEPTH - 1))
+#define TEMPLATE_SUFFIX             GHOTIIO_CUTIL_CONCAT2(_, LANE)
+#define TEMPLATE_KEY                GHOTIIO_CUTIL_CONCAT3(key, BITDEPTH, TEMPLATE_SUFFIX)
+#define TEMPLATE_SWAP               GHOTIIO_CUTIL_CONCAT3(swap, BITDEPTH, TEMPLATE_SUFFIX)
+#define TEMPLATE_INSERTION_SORT     GHOTIIO_CUTIL_CONCAT3(insertion_sort, BITDEPTH, TEMPLATE_SUFFIX)
+#define TEMPLATE_QUICKSORT          GHOTIIO_CUTIL_CONCAT3(quicksort, BITDEPTH, TEMPLATE_SUFFIX)
+#define TEMPLATE_RADIX_SORT         GHOTIIO_CUTIL_CONCAT3(radix_sort, BITDEPTH, TEMPLATE_SUFFIX)
+#define TEMPLATE_GCU_SORT           GHOTIIO_CUTIL_CONCAT3(gcu_sort, BITDEPTH, TEMPLATE_SUFFIX)
+#define TEMPLATE_GCU_VECTOR_SORT    GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, GHOTIIO_CUTIL_CONCAT2(_sort_, LANE))
+#define TEMPLATE_PAR_SORT_JOB       GHOTIIO_CUTIL_CONCAT3(Par_Sort_Job, BITDEPTH, TEMPLATE_SUFFIX)
+#define TEMPLATE_PAR_RANGE_TASK     GHOTIIO_CUTIL_CONCAT3(par_range_task, BITDEPTH, TEMPLATE_SUFFIX)
+#define TEMPLATE_PAR_COUNT_TASK     GHOTIIO_CUTIL_CONCAT3(par_count_task, BITDEPTH, TEMPLATE_SUFFIX)
+#define TEMPLATE_PAR_SCATTER_TASK   GHOTIIO_CUTIL_CONCAT3(par_scatter_task, BITDEPTH, TEMPLATE_SUFFIX)
+#define TEMPLATE_PAR_BUCKET_TASK    GHOTIIO_CUTIL_CONCAT3(par_bucket_task, BITDEPTH, TEMPLATE_SUFFIX)
+#define TEMPLATE_GCU_PAR_SORT       GHOTIIO_CUTIL_CONCAT3(gcu_par_sort, BITDEPTH, TEMPLATE_SUFFIX)
+#define TEMPLATE_GCU_VECTOR_PAR_SORT GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, GHOTIIO_CUTIL_CONCAT2(_par_sort_, LANE))
+#define TEMPLATE_GCU_VIEW           GHOTIIO_CUTIL_CONCAT3(GCU_Vector, BITDEPTH, _View)
+#define TEMPLATE_GCU_VIEW_SORT      GHOTIIO_CUTIL_CONCAT3(gcu_view, BITDEPTH, GHOTIIO_CUTIL_CONCAT2(_sort_, LANE))
+#define TEMPLATE_GCU_VIEW_PAR_SORT  GHOTIIO_CUTIL_CONCAT3(gcu_view, BITDEPTH, GHOTIIO_CUTIL_CONCAT2(_par_sort_, LANE))
+#define TEMPLATE_GCU_VIEW_LOWER_BOUND GHOTIIO_CUTIL_CONCAT3(gcu_view, BITDEPTH, GHOTIIO_CUTIL_CONCAT2(_lower_bound_, LANE))
+
+static inline TEMPLATE_KEY_T TEMPLATE_KEY(TEMPLATE_GCU_TYPE_UNION value) {
+  return (TEMPLATE_KEY_T)SORT_KEY(value.TEMPLATE_BITS, TEMPLATE_SIGN);
+}
+
+static inline void TEMPLATE_SWAP(TEMPLATE_GCU_TYPE_UNION * a, TEMPLATE_GCU_TYPE_UNION * b) {
+  TEMPLATE_GCU_TYPE_UNION temp = *a;
+  *a = *b;
+  *b = temp;
+}
+
+static void TEMPLATE_INSERTION_SORT(TEMPLATE_GCU_TYPE_UNION * data, size_t count) {
+  for (size_t i = 1; i < count; ++i) {
+    TEMPLATE_GCU_TYPE_UNION value = data[i];
+    TEMPLATE_KEY_T key = TEMPLATE_KEY(value);
+    size_t j = i;
+    while (j && (TEMPLATE_KEY(data[j - 1]) > key)) {
+      data[j] = data[j - 1];
+      --j;
+    }
+    data[j] = value;
+  }
+}
+
+static void TEMPLATE_QUICKSORT(TEMPLATE_GCU_TYPE_UNION * data, size_t count) {
+  while (count > INSERTION_THRESHOLD) {
+    // Choose the median of the first, middle, and last elements as the pivot,
+    // and move it to the end of the range.
+    size_t middle = count / 2;
+    size_t last = count - 1;
+    if (TEMPLATE_KEY(data[middle]) < TEMPLATE_KEY(data[0])) {
+      TEMPLATE_SWAP(&data[middle], &data[0]);
+    }
+    if (TEMPLATE_KEY(data[last]) < TEMPLATE_KEY(data[0])) {
+      TEMPLATE_SWAP(&data[last], &data[0]);
+    }
+    if (TEMPLATE_KEY(data[middle]) < TEMPLATE_KEY(data[last])) {
+      TEMPLATE_SWAP(&data[middle], &data[last]);
+    }
+    TEMPLATE_KEY_T pivot = TEMPLATE_KEY(data[last]);
+
+    // Branchless Lomuto partition.  Every element is swapped into the `store`
+    // position, but `store` only advances when the element is less than the
+    // pivot, so there is no data-dependent branch for the CPU to mispredict.
+    size_t store = 0;
+    for (size_t i = 0; i < last; ++i) {
+      TEMPLATE_GCU_TYPE_UNION value = data[i];
+      size_t less = TEMPLATE_KEY(value) < pivot;
+      data[i] = data[store];
+      data[store] = value;
+      store += less;
+    }
+    TEMPLATE_SWAP(&data[store], &data[last]);
+
+    // Recurse into the smaller partition and loop on the larger one, so that
+    // the stack depth is logarithmic.
+    size_t right = count - store - 1;
+    if (store < right) {
+      TEMPLATE_QUICKSORT(data, store);
+      data += store + 1;
+      count = right;
+    }
+    else {
+      TEMPLATE_QUICKSORT(data + store + 1, right);
+      count = store;
+    }
+  }
+  TEMPLATE_INSERTION_SORT(data, count);
+}
+
+//
+// Sort `data` using `buffer`, which must hold `count` elements, as scratch
+// space.  Returns whichever of the two arrays holds the sorted result.
+//
+static TEMPLATE_GCU_TYPE_UNION * TEMPLATE_RADIX_SORT(TEMPLATE_GCU_TYPE_UNION * data, TEMPLATE_GCU_TYPE_UNION * buffer, size_t count) {
+  enum { PASSES = BITDEPTH / 8 };
+  size_t histogram[PASSES][256];
+  memset(histogram, 0, sizeof(histogram));
+
+  // Build the histograms for every digit in a single read of the data.
+  for (size_t i = 0; i < count; ++i) {
+    TEMPLATE_KEY_T key = TEMPLATE_KEY(data[i]);
+    for (size_t pass = 0; pass < PASSES; ++pass) {
+      ++histogram[pass][(key >> (pass * 8)) & 0xFF];
+    }
+  }
+
+  // A pass can be skipped if every element has the same digit, which is common
+  // for the upper bytes of small integers and timestamps.
+  TEMPLATE_KEY_T first = TEMPLATE_KEY(data[0]);
+  TEMPLATE_GCU_TYPE_UNION * from = data;
+  TEMPLATE_GCU_TYPE_UNION * to = buffer;
+  for (size_t pass = 0; pass < PASSES; ++pass) {
+    if (histogram[pass][(first >> (pass * 8)) & 0xFF] == count) {
+      continue;
+    }
+
+    // Convert the counts into starting offsets.
+    size_t offset[256];
+    size_t total = 0;
+    for (size_t digit = 0; digit < 256; ++digit) {
+      offset[digit] = total;
+      total += histogram[pass][digit];
+    }
+
+    // Scatter the elements into their buckets.
+    for (size_t i = 0; i < count; ++i) {
+      size_t digit = (TEMPLATE_KEY(from[i]) >> (pass * 8)) & 0xFF;
+      to[offset[digit]++] = from[i];
+    }
+
+    TEMPLATE_GCU_TYPE_UNION * temp = from;
+    from = to;
+    to = temp;
+  }
+  return from;
+}
+
+bool TEMPLATE_GCU_SORT(TEMPLATE_GCU_TYPE_UNION * data, size_t count) {
+  if (count < 2) {
+    return true;
+  }
+  if (count < RADIX_THRESHOLD) {
+    TEMPLATE_QUICKSORT(data, count);
+    return true;
+  }
+
+  GCU_Scratch_Mark mark = gcu_scratch_mark();
+  TEMPLATE_GCU_TYPE_UNION * scratch = gcu_scratch_allocate(count * sizeof(TEMPLATE_GCU_TYPE_UNION));
+  if (!scratch) {
+    return false;
+  }
+
+  // After an odd number of passes, the sorted data is in the scratch buffer.
+  TEMPLATE_GCU_TYPE_UNION * sorted = TEMPLATE_RADIX_SORT(data, scratch, count);
+  if (sorted != data) {
+    memcpy(data, sorted, count * sizeof(TEMPLATE_GCU_TYPE_UNION));
+  }
+  gcu_scratch_rewind(mark);
+  return true;
+}
+
+bool TEMPLATE_GCU_VECTOR_SORT(TEMPLATE_GCU_VECTOR * vector) {
+  // Verify that the pointer actually points to something.
+  if (!vector) {
+    return false;
+  }
+  return TEMPLATE_GCU_SORT(vector->data, vector->count);
+}
+
+bool TEMPLATE_GCU_VIEW_SORT(TEMPLATE_GCU_VIEW view) {
+  return TEMPLATE_GCU_SORT(view.data, view.count);
+}
+
+size_t TEMPLATE_GCU_VIEW_LOWER_BOUND(TEMPLATE_GCU_VIEW view, TYPE value) {
+  TEMPLATE_KEY_T key = TEMPLATE_KEY((TEMPLATE_GCU_TYPE_UNION){.LANE = value});
+
+  // Halve the range without branching on the comparison, so that the search
+  // does not pay for a mispredicted branch at every step.
+  TEMPLATE_GCU_TYPE_UNION * base = view.data;
+  size_t count = view.count;
+  while (count > 1) {
+    size_t half = count / 2;
+    base = TEMPLATE_KEY(base[half]) < key
+      ? base + half
+      : base;
+    count -= half;
+  }
+  if (count && TEMPLATE_KEY(*base) < key) {
+    ++base;
+  }
+  return view.count
+    ? (size_t)(base - view.data)
+    : 0;
+}
+
+#if BITDEPTH >= 32
+
+//
+// The shared state of a parallel sort.
+//
+// The sort is a single most-significant-digit radix pass, done in parallel,
+// followed by an independent sort of each of the 256 buckets.  The digit is
+// taken from just below the highest bit that differs between the smallest and
+// largest keys, so that clustered keys (e.g., timestamps) still spread across
+// the buckets.
+//
+typedef struct {
+  TEMPLATE_GCU_TYPE_UNION * data;    // The array being sorted.
+  TEMPLATE_GCU_TYPE_UNION * scratch; // The buckets, `count` elements.
+  size_t count;                      // The number of elements.
+  size_t chunk;                      // The number of elements per task.
+  unsigned shift;                    // The position of the bucket digit.
+  TEMPLATE_KEY_T * minimums;         // The smallest key of each chunk.
+  TEMPLATE_KEY_T * maximums;         // The largest key of each chunk.
+  size_t (* offsets)[256];           // The digit counts of each chunk, which
+                                     //   become its scatter offsets.
+  size_t buckets[257];               // The bucket boundaries in `scratch`.
+} TEMPLATE_PAR_SORT_JOB;
+
+static void TEMPLATE_PAR_RANGE_TASK(size_t index, void * arg) {
+  TEMPLATE_PAR_SORT_JOB * job = arg;
+  size_t begin;
+  size_t count = par_chunk(index, job->chunk, job->count, &begin);
+  TEMPLATE_KEY_T minimum = (TEMPLATE_KEY_T)~(TEMPLATE_KEY_T)0;
+  TEMPLATE_KEY_T maximum = 0;
+  for (size_t i = begin; i < begin + count; ++i) {
+    TEMPLATE_KEY_T key = TEMPLATE_KEY(job->data[i]);
+    minimum = key < minimum ? key : minimum;
+    maximum = key > maximum ? key : maximum;
+  }
+  job->minimums[index] = minimum;
+  job->maximums[index] = maximum;
+}
+
+static void TEMPLATE_PAR_COUNT_TASK(size_t index, void * arg) {
+  TEMPLATE_PAR_SORT_JOB * job = arg;
+  size_t begin;
+  size_t count = par_chunk(index, job->chunk, job->count, &begin);
+  size_t * counts = job->offsets[index];
+  memset(counts, 0, sizeof(job->offsets[index]));
+  for (size_t i = begin; i < begin + count; ++i) {
+    ++counts[(TEMPLATE_KEY(job->data[i]) >> job->shift) & 0xFF];
+  }
+}
+
+static void TEMPLATE_PAR_SCATTER_TASK(size_t index, void * arg) {
+  TEMPLATE_PAR_SORT_JOB * job = arg;
+  size_t begin;
+  size_t count = par_chunk(index, job->chunk, job->count, &begin);
+  size_t * offsets = job->offsets[index];
+  for (size_t i = begin; i < begin + count; ++i) {
+    TEMPLATE_GCU_TYPE_UNION value = job->data[i];
+    job->scratch[offsets[(TEMPLATE_KEY(value) >> job->shift) & 0xFF]++] = value;
+  }
+}
+
+static void TEMPLATE_PAR_BUCKET_TASK(size_t index, void * arg) {
+  TEMPLATE_PAR_SORT_JOB * job = arg;
+  size_t begin = job->buckets[index];
+  size_t count = job->buckets[index + 1] - begin;
+  TEMPLATE_GCU_TYPE_UNION * bucket = job->scratch + begin;
+  TEMPLATE_GCU_TYPE_UNION * destination = job->data + begin;
+
+  // The bucket's range of `data` has already been scattered, so it serves as
+  // the radix sort's scratch space.
+  if (count < RADIX_THRESHOLD) {
+    TEMPLATE_QUICKSORT(bucket, count);
+  }
+  else {
+    bucket = TEMPLATE_RADIX_SORT(bucket, destination, count);
+  }
+  if (bucket != destination) {
+    memcpy(destination, bucket, count * sizeof(TEMPLATE_GCU_TYPE_UNION));
+  }
+}
+
+bool TEMPLATE_GCU_PAR_SORT(GCU_Thread_Pool * pool, TEMPLATE_GCU_TYPE_UNION * data, size_t count) {
+  if ((count < PARALLEL_SORT_THRESHOLD) || (gcu_thread_pool_get_num_threads(pool) < 2)) {
+    return TEMPLATE_GCU_SORT(data, count);
+  }
+
+  TEMPLATE_PAR_SORT_JOB job = {
+    .data = data,
+    .count = count,
+    .chunk = gcu_thread_pool_get_chunk_size(pool, count, sizeof(TEMPLATE_GCU_TYPE_UNION)),
+  };
+  size_t num_tasks = (count + job.chunk - 1) / job.chunk;
+
+  job.scratch = gcu_malloc(count * sizeof(TEMPLATE_GCU_TYPE_UNION));
+  job.offsets = gcu_malloc(num_tasks * (sizeof(job.offsets[0]) + 2 * sizeof(TEMPLATE_KEY_T)));
+  if (!job.scratch || !job.offsets) {
+    gcu_free(job.scratch);
+    gcu_free(job.offsets);
+    return false;
+  }
+  job.minimums = (TEMPLATE_KEY_T *)(job.offsets + num_tasks);
+  job.maximums = job.minimums + num_tasks;
+
+  // Find the range of the keys, and choose the bucket digit from it.
+  gcu_thread_pool_run(pool, num_tasks, TEMPLATE_PAR_RANGE_TASK, &job);
+  TEMPLATE_KEY_T minimum = job.minimums[0];
+  TEMPLATE_KEY_T maximum = job.maximums[0];
+  for (size_t i = 1; i < num_tasks; ++i) {
+    minimum = job.minimums[i] < minimum ? job.minimums[i] : minimum;
+    maximum = job.maximums[i] > maximum ? job.maximums[i] : maximum;
+  }
+  if (minimum != maximum) {
+    TEMPLATE_KEY_T difference = minimum ^ maximum;
+    while ((difference >> job.shift) > 0xFF) {
+      ++job.shift;
+    }
+
+    // Count the digits of each chunk, then convert the counts into the
+    // position of each chunk's share of each bucket.
+    gcu_thread_pool_run(pool, num_tasks, TEMPLATE_PAR_COUNT_TASK, &job);
+    size_t total = 0;
+    for (size_t digit = 0; digit < 256; ++digit) {
+      job.buckets[digit] = total;
+      for (size_t i = 0; i < num_tasks; ++i) {
+        size_t digit_count = job.offsets[i][digit];
+        job.offsets[i][digit] = total;
+        total += digit_count;
+      }
+    }
+    job.buckets[256] = total;
+
+    gcu_thread_pool_run(pool, num_tasks, TEMPLATE_PAR_SCATTER_TASK, &job);
+    gcu_thread_pool_run(pool, 256, TEMPLATE_PAR_BUCKET_TASK, &job);
+  }
+
+  gcu_free(job.scratch);
+  gcu_free(job.offsets);
+  return true;
+}
+
+bool TEMPLATE_GCU_VECTOR_PAR_SORT(GCU_Thread_Pool * pool, TEMPLATE_GCU_VECTOR * vector) {
+  // Verify that the pointer actually points to something.
+  if (!vector) {
+    return false;
+  }
+  return TEMPLATE_GCU_PAR_SORT(pool, vector->data, vector->count);
+}
+
+bool TEMPLATE_GCU_VIEW_PAR_SORT(GCU_Thread_Pool * pool, TEMPLATE_GCU_VIEW view) {
+  return TEMPLATE_GCU_PAR_SORT(pool, view.data, view.count);
+}
+
+#endif // BITDEPTH >= 32
+
+#undef TEMPLATE_GCU_VECTOR
+#undef TEMPLATE_GCU_TYPE_UNION
+#undef TEMPLATE_KEY_T
+#undef TEMPLATE_BITS
+#undef TEMPLATE_SIGN
+#undef TEMPLATE_SUFFIX
+#undef TEMPLATE_KEY
+#undef TEMPLATE_SWAP
+#undef TEMPLATE_INSERTION_SORT
+#undef TEMPLATE_QUICKSORT
+#undef TEMPLATE_RADIX_SORT
+#undef TEMPLATE_GCU_SORT
+#undef TEMPLATE_GCU_VECTOR_SORT
+#undef TEMPLATE_PAR_SORT_JOB
+#undef TEMPLATE_PAR_RANGE_TASK
+#undef TEMPLATE_PAR_COUNT_TASK
+#undef TEMPLATE_PAR_SCATTER_TASK
+#undef TEMPLATE_PAR_BUCKET_TASK
+#undef TEMPLATE_GCU_PAR_SORT
+#undef TEMPLATE_GCU_VECTOR_PAR_SORT
+#undef TEMPLATE_GCU_VIEW
+#undef TEMPLATE_GCU_VIEW_SORT
+#undef TEMPLATE_GCU_VIEW_PAR_SORT
+#undef TEMPLATE_GCU_VIEW_LOWER_BOUND
@@ -14,6 +14,7 @@
 #include <cutil/memory.h>
 #include <cutil/thread.h>
 #include <cutil/hash.h>
+#include <cutil/mutex.h>
 
 #ifdef _WIN32
 #else
@@ -34,6 +35,10 @@
 
 static GCU_Hash64 * gcu_thread_hash = NULL;
 
+// Guards `gcu_thread_hash`.  This is kept separate from the hash table so that
+// the module does not depend on containers carrying their own mutex.
+static GCU_MUTEX_T gcu_thread_mutex;
+
 // Forward declaration.
 typedef struct GCU_Thread_Internal GCU_Thread_Internal;
 
@@ -104,7 +109,7 @@ static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION gcu_thread_wr
 //
 static void gcu_thread_hash_cleanup(GCU_Hash64 * hash) {
   // Lock the hash table.
-  GCU_MUTEX_LOCK(hash->mutex);
+  GCU_MUTEX_LOCK(gcu_thread_mutex);
 
   uint32_t current_id = gcu_thread_get_current_id();
 
@@ -132,7 +137,7 @@ static void gcu_thread_hash_cleanup(GCU_Hash64 * hash) {
   }
 
   // Unlock the hash table.
-  GCU_MUTEX_UNLOCK(hash->mutex);
+  GCU_MUTEX_UNLOCK(gcu_thread_mutex);
 }
 
 /**
@@ -143,10 +148,16 @@ static void gcu_thread_hash_cleanup(GCU_Hash64 * hash) {
  * the module.
  */
 GCU_INIT_FUNCTION(gcu_thread_constructor) {
+  // Create the mutex which guards the thread hash table.
+  if (GCU_MUTEX_CREATE(gcu_thread_mutex)) {
+    return;
+  }
+
   gcu_thread_hash = gcu_hash64_create(gcu_thread_get_num_processors() * 3);
 
   // Verify that the thread hash table has been successfully allocated.
   if (gcu_thread_hash == NULL) {
+    GCU_MUTEX_DESTROY(gcu_thread_mutex);
     return;
   }
 
@@ -161,6 +172,7 @@ GCU_INIT_FUNCTION(gcu_thread_constructor) {
   if (!thread) {
     gcu_hash64_destroy(gcu_thread_hash);
     gcu_thread_hash = NULL;
+    GCU_MUTEX_DESTROY(gcu_thread_mutex);
     return;
   }
 
@@ -178,6 +190,7 @@ GCU_INIT_FUNCTION(gcu_thread_constructor) {
     gcu_free(thread);
     gcu_hash64_destroy(gcu_thread_hash);
     gcu_thread_hash = NULL;
+    GCU_MUTEX_DESTROY(gcu_thread_mutex);
   }
 }
 
@@ -196,6 +209,7 @@ GCU_CLEANUP_FUNCTION(gcu_thread_destructor) {
 
   gcu_hash64_destroy(gcu_thread_hash);
   gcu_thread_hash = NULL;
+  GCU_MUTEX_DESTROY(gcu_thread_mutex);
 }
 
 
@@ -205,7 +219,7 @@ int gcu_thread_create(GCU_Thread * thread, GCU_THREAD_FUNC func, void * arg) {
     return -1;
   }
 
-  GCU_MUTEX_LOCK(gcu_thread_hash->mutex);
+  GCU_MUTEX_LOCK(gcu_thread_mutex);
 
   // Allocate a new thread record.
   GCU_Thread_Internal * thread_internal = gcu_calloc(sizeof(GCU_Thread_Internal), 1);
@@ -241,7 +255,7 @@ int gcu_thread_create(GCU_Thread * thread, GCU_THREAD_FUNC func, void * arg) {
   // return.
   if (failed) {
     gcu_free(thread_internal);
-    GCU_MUTEX_UNLOCK(gcu_thread_hash->mutex);
+    GCU_MUTEX_UNLOCK(gcu_thread_mutex);
     return -1;
   }
 
@@ -267,7 +281,7 @@ int gcu_thread_create(GCU_Thread * thread, GCU_THREAD_FUNC func, void * arg) {
       // OS has reused a thread ID before the old thread has been joined.
       assert(false);
       gcu_free(thread_internal);
-      GCU_MUTEX_UNLOCK(gcu_thread_hash->mutex);
+      GCU_MUTEX_UNLOCK(gcu_thread_mutex);
       return -1;
     }
 
@@ -278,7 +292,7 @@ int gcu_thread_create(GCU_Thread * thread, GCU_THREAD_FUNC func, void * arg) {
   // Add the thread record to the hash.
   assert(gcu_hash64_set(gcu_thread_hash, *thread, GCU_TYPE64_P(thread_internal)));
 
-  GCU_MUTEX_UNLOCK(gcu_thread_hash->mutex);
+  GCU_MUTEX_UNLOCK(gcu_thread_mutex);
   return 0;
 }
 
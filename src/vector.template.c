@@ -2,11 +2,15 @@
 #define TEMPLATE_GCU_TYPE_UNION     GHOTIIO_CUTIL_CONCAT3(GCU_Type, BITDEPTH, _Union)
 #define TEMPLATE_GCU_VECTOR_CREATE  GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, _create)
 #define TEMPLATE_GCU_VECTOR_CREATE_IN_PLACE GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, _create_in_place)
+#define TEMPLATE_GCU_VECTOR_CREATE_IN_ARENA GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, _create_in_arena)
+#define TEMPLATE_GCU_VECTOR_CREATE_EMBEDDED GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, _create_embedded)
 #define TEMPLATE_GCU_VECTOR_DESTROY GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, _destroy)
 #define TEMPLATE_GCU_VECTOR_DESTROY_IN_PLACE GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, _destroy_in_place)
 #define TEMPLATE_GCU_VECTOR_APPEND  GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, _append)
 #define TEMPLATE_GCU_VECTOR_COUNT   GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, _count)
+#define TEMPLATE_GCU_VECTOR_BYTES   GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, _bytes)
 #define TEMPLATE_GCU_VECTOR_RESERVE GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, _reserve)
+#define TEMPLATE_GCU_VECTOR_SET_GROWTH GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, _set_growth)
 
 TEMPLATE_GCU_VECTOR * TEMPLATE_GCU_VECTOR_CREATE(size_t count) {
   // Malloc Zeroed-out memory.
@@ -30,6 +34,8 @@ bool TEMPLATE_GCU_VECTOR_CREATE_IN_PLACE(TEMPLATE_GCU_VECTOR * vector, size_t co
     .count = 0,
     .capacity = 0,
     .data = 0,
+    .embedded = false,
+    .growth = {0},
     .cleanup = 0,
   };
 
@@ -41,6 +47,7 @@ bool TEMPLATE_GCU_VECTOR_CREATE_IN_PLACE(TEMPLATE_GCU_VECTOR * vector, size_t co
     }
   }
 
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
   // Allocate the mutex.
   bool failure = GCU_MUTEX_CREATE(vector->mutex);
 
@@ -51,14 +58,63 @@ bool TEMPLATE_GCU_VECTOR_CREATE_IN_PLACE(TEMPLATE_GCU_VECTOR * vector, size_t co
     }
     return false;
   }
+#endif
 
   return true;
 }
 
+TEMPLATE_GCU_VECTOR * TEMPLATE_GCU_VECTOR_CREATE_IN_ARENA(GCU_Arena * arena, size_t count) {
+  TEMPLATE_GCU_VECTOR * vector = gcu_arena_allocate(arena, sizeof(TEMPLATE_GCU_VECTOR));
+
+  // If the allocation failed, return null.
+  if (!vector || !TEMPLATE_GCU_VECTOR_CREATE_IN_PLACE(vector, 0)) {
+    return 0;
+  }
+  vector->growth.arena = arena;
+
+  // Reserve room for the data, if requested..
+  if (count) {
+    TEMPLATE_GCU_VECTOR_RESERVE(vector, count);
+  }
+
+  return vector;
+}
+
+TEMPLATE_GCU_VECTOR * TEMPLATE_GCU_VECTOR_CREATE_EMBEDDED(size_t count) {
+  if (count > (SIZE_MAX - sizeof(TEMPLATE_GCU_VECTOR)) / sizeof(TEMPLATE_GCU_TYPE_UNION)) {
+    return 0;
+  }
+
+  // The data follows the structure in the same zeroed-out block.
+  TEMPLATE_GCU_VECTOR * vector = gcu_calloc(1, sizeof(TEMPLATE_GCU_VECTOR) + count * sizeof(TEMPLATE_GCU_TYPE_UNION));
+
+  // If the allocation failed, return null.
+  if (!vector) {
+    return 0;
+  }
+
+  if (!TEMPLATE_GCU_VECTOR_CREATE_IN_PLACE(vector, 0)) {
+    gcu_free(vector);
+    return 0;
+  }
+
+  if (count) {
+    vector->data = (TEMPLATE_GCU_TYPE_UNION *)(vector + 1);
+    vector->capacity = count;
+    vector->embedded = true;
+  }
+
+  return vector;
+}
+
 void TEMPLATE_GCU_VECTOR_DESTROY(TEMPLATE_GCU_VECTOR * vector) {
   if (vector) {
+    // A vector in an arena is given back when the arena is reset.
+    bool inArena = vector->growth.arena;
     TEMPLATE_GCU_VECTOR_DESTROY_IN_PLACE(vector);
-    gcu_free(vector);
+    if (!inArena) {
+      gcu_free(vector);
+    }
   }
 }
 
@@ -70,22 +126,30 @@ void TEMPLATE_GCU_VECTOR_DESTROY_IN_PLACE(TEMPLATE_GCU_VECTOR * vector) {
       vector->cleanup(vector);
     }
 
-    // Clean up the data table if needed.
+    // Clean up the data table if needed.  Embedded data is freed with the
+    // vector itself.
     if (vector->data) {
-      gcu_free(vector->data);
+      if (!vector->embedded) {
+        gcu_growth_free(&vector->growth, vector->data, vector->capacity * sizeof(TEMPLATE_GCU_TYPE_UNION));
+      }
       vector->data = 0;
+      vector->embedded = false;
     }
 
+#ifndef GHOTIIO_CUTIL_DISABLE_CONTAINER_MUTEX
     GCU_MUTEX_DESTROY(vector->mutex);
+#endif
   }
 }
 
 bool TEMPLATE_GCU_VECTOR_APPEND(TEMPLATE_GCU_VECTOR * vector, TEMPLATE_GCU_TYPE_UNION value) {
-  if ((vector->count >= vector->capacity) && !TEMPLATE_GCU_VECTOR_RESERVE(vector, vector->count < 32
-      ? 32
-      : vector->count < 1024
-        ? vector->count * 2
-        : vector->count * GROWTH_FACTOR)) {
+  if ((vector->count >= vector->capacity) && !TEMPLATE_GCU_VECTOR_RESERVE(vector, vector->growth.factor
+      ? gcu_growth_next(&vector->growth, vector->count)
+      : vector->count < 32
+        ? 32
+        : vector->count < 1024
+          ? vector->count * 2
+          : vector->count * GROWTH_FACTOR)) {
     return false;
   }
   vector->data[vector->count] = value;
@@ -97,6 +161,12 @@ size_t TEMPLATE_GCU_VECTOR_COUNT(TEMPLATE_GCU_VECTOR * vector) {
   return vector->count;
 }
 
+size_t TEMPLATE_GCU_VECTOR_BYTES(TEMPLATE_GCU_VECTOR * vector) {
+  return vector
+    ? vector->capacity * sizeof(TEMPLATE_GCU_TYPE_UNION)
+    : 0;
+}
+
 bool TEMPLATE_GCU_VECTOR_RESERVE(TEMPLATE_GCU_VECTOR * vector, size_t size) {
   // Verify that the pointer actually points to something.
   if (!vector) {
@@ -109,16 +179,28 @@ bool TEMPLATE_GCU_VECTOR_RESERVE(TEMPLATE_GCU_VECTOR * vector, size_t size) {
   }
 
   // Attempt to allocate more memory;
+  if (size > SIZE_MAX / sizeof(TEMPLATE_GCU_TYPE_UNION)) {
+    return false;
+  }
   if (!vector->data) {
-    vector->data = gcu_calloc(size, sizeof (TEMPLATE_GCU_TYPE_UNION));
+    vector->data = gcu_growth_allocate(&vector->growth, size * sizeof(TEMPLATE_GCU_TYPE_UNION), true);
     if (vector->data) {
       vector->capacity = size;
       return true;
     }
     return false;
   }
-  void * newMem = gcu_realloc(vector->data, size * (sizeof (TEMPLATE_GCU_TYPE_UNION)));
+
+  // Embedded data cannot be reallocated, so it is copied to its own block.
+  void * newMem = vector->embedded
+    ? gcu_growth_allocate(&vector->growth, size * sizeof(TEMPLATE_GCU_TYPE_UNION), false)
+    : gcu_growth_reallocate(&vector->growth, vector->data, vector->capacity * sizeof(TEMPLATE_GCU_TYPE_UNION), size * sizeof(TEMPLATE_GCU_TYPE_UNION));
   if (newMem) {
+    if (vector->embedded) {
+      memcpy(newMem, vector->data, vector->capacity * sizeof(TEMPLATE_GCU_TYPE_UNION));
+      vector->embedded = false;
+    }
+
     // Zero out the new memory.
 #ifdef DEBUG
     memset((TEMPLATE_GCU_TYPE_UNION *)newMem + vector->capacity, 0, (size - vector->capacity) * sizeof(TEMPLATE_GCU_TYPE_UNION));
@@ -132,13 +214,44 @@ bool TEMPLATE_GCU_VECTOR_RESERVE(TEMPLATE_GCU_VECTOR * vector, size_t size) {
   return false;
 }
 
+bool TEMPLATE_GCU_VECTOR_SET_GROWTH(TEMPLATE_GCU_VECTOR * vector, GCU_Growth growth) {
+  // Verify that the pointer actually points to something.
+  if (!vector || growth.arena != vector->growth.arena) {
+    return false;
+  }
+
+  // Storage which both policies allocate in the same way stays where it is.
+  // Embedded data stays unless the new policy asks for an alignment.
+  size_t size = vector->capacity * sizeof(TEMPLATE_GCU_TYPE_UNION);
+  if (vector->data && (vector->embedded
+      ? growth.alignment != 0
+      : !gcu_growth_compatible(&vector->growth, &growth, size))) {
+    void * data = gcu_growth_allocate(&growth, size, false);
+    if (!data) {
+      return false;
+    }
+    memcpy(data, vector->data, vector->count * sizeof(TEMPLATE_GCU_TYPE_UNION));
+    if (!vector->embedded) {
+      gcu_growth_free(&vector->growth, vector->data, size);
+    }
+    vector->data = data;
+    vector->embedded = false;
+  }
+  vector->growth = growth;
+  return true;
+}
+
 #undef TEMPLATE_GCU_VECTOR
 #undef TEMPLATE_GCU_TYPE_UNION
 #undef TEMPLATE_GCU_VECTOR_CREATE
 #undef TEMPLATE_GCU_VECTOR_CREATE_IN_PLACE
+#undef TEMPLATE_GCU_VECTOR_CREATE_IN_ARENA
+#undef TEMPLATE_GCU_VECTOR_CREATE_EMBEDDED
 #undef TEMPLATE_GCU_VECTOR_DESTROY
 #undef TEMPLATE_GCU_VECTOR_DESTROY_IN_PLACE
 #undef TEMPLATE_GCU_VECTOR_APPEND
 #undef TEMPLATE_GCU_VECTOR_COUNT
+#undef TEMPLATE_GCU_VECTOR_BYTES
 #undef TEMPLATE_GCU_VECTOR_RESERVE
+#undef TEMPLATE_GCU_VECTOR_SET_GROWTH
 
@@ -0,0 +1,25 @@
+/**
+ * @file
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <cutil/string.h>
+#include <cutil/view.h>
+
+#define BITDEPTH 64
+#include "view.template.c"
+#undef BITDEPTH
+
+#define BITDEPTH 32
+#include "view.template.c"
+#undef BITDEPTH
+
+#define BITDEPTH 16
+#include "view.template.c"
+#undef BITDEPTH
+
+#define BITDEPTH 8
+#include "view.template.c"
+#undef BITDEPTH
@@ -0,0 +1,93 @@
+#define TEMPLATE_GCU_VECTOR         GHOTIIO_CUTIL_CONCAT2(GCU_Vector, BITDEPTH)
+#define TEMPLATE_GCU_VIEW           GHOTIIO_CUTIL_CONCAT3(GCU_Vector, BITDEPTH, _View)
+#define TEMPLATE_GCU_TYPE_UNION     GHOTIIO_CUTIL_CONCAT3(GCU_Type, BITDEPTH, _Union)
+#define TEMPLATE_GCU_VECTOR_VIEW    GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, _view)
+#define TEMPLATE_GCU_VECTOR_RESERVE GHOTIIO_CUTIL_CONCAT3(gcu_vector, BITDEPTH, _reserve)
+#define TEMPLATE_GCU_VIEW_OF        GHOTIIO_CUTIL_CONCAT3(gcu_view, BITDEPTH, _of)
+#define TEMPLATE_GCU_VIEW_SLICE     GHOTIIO_CUTIL_CONCAT3(gcu_view, BITDEPTH, _slice)
+#define TEMPLATE_GCU_VIEW_SPLIT     GHOTIIO_CUTIL_CONCAT3(gcu_view, BITDEPTH, _split)
+#define TEMPLATE_GCU_VIEW_HASH      GHOTIIO_CUTIL_CONCAT3(gcu_view, BITDEPTH, _hash)
+#define TEMPLATE_GCU_VIEW_COPY      GHOTIIO_CUTIL_CONCAT3(gcu_view, BITDEPTH, _copy)
+
+TEMPLATE_GCU_VIEW TEMPLATE_GCU_VECTOR_VIEW(TEMPLATE_GCU_VECTOR * vector, size_t start, size_t count) {
+  // Verify that the pointer actually points to something.
+  if (!vector) {
+    return (TEMPLATE_GCU_VIEW) {0};
+  }
+  return TEMPLATE_GCU_VIEW_SLICE((TEMPLATE_GCU_VIEW) {
+    .data = vector->data,
+    .count = vector->count,
+  }, start, count);
+}
+
+TEMPLATE_GCU_VIEW TEMPLATE_GCU_VIEW_OF(TEMPLATE_GCU_TYPE_UNION * data, size_t count) {
+  return (TEMPLATE_GCU_VIEW) {
+    .data = data,
+    .count = data
+      ? count
+      : 0,
+  };
+}
+
+TEMPLATE_GCU_VIEW TEMPLATE_GCU_VIEW_SLICE(TEMPLATE_GCU_VIEW view, size_t start, size_t count) {
+  if (start >= view.count) {
+    return (TEMPLATE_GCU_VIEW) {
+      .data = view.data
+        ? view.data + view.count
+        : 0,
+      .count = 0,
+    };
+  }
+  size_t remaining = view.count - start;
+  return (TEMPLATE_GCU_VIEW) {
+    .data = view.data + start,
+    .count = count < remaining
+      ? count
+      : remaining,
+  };
+}
+
+TEMPLATE_GCU_VIEW TEMPLATE_GCU_VIEW_SPLIT(TEMPLATE_GCU_VIEW view, size_t parts, size_t index) {
+  if (index >= parts) {
+    return TEMPLATE_GCU_VIEW_SLICE(view, view.count, 0);
+  }
+
+  // The first `extra` parts take one more element than the rest.
+  size_t size = view.count / parts;
+  size_t extra = view.count % parts;
+  return TEMPLATE_GCU_VIEW_SLICE(view, index * size + (index < extra
+      ? index
+      : extra), size + (index < extra));
+}
+
+uint64_t TEMPLATE_GCU_VIEW_HASH(TEMPLATE_GCU_VIEW view) {
+  return gcu_string_hash_64((char const *)view.data, view.count * sizeof(TEMPLATE_GCU_TYPE_UNION));
+}
+
+bool TEMPLATE_GCU_VIEW_COPY(TEMPLATE_GCU_VIEW view, TEMPLATE_GCU_VECTOR * vector) {
+  // Verify that the pointer actually points to something.
+  if (!vector) {
+    return false;
+  }
+  if (!view.count) {
+    return true;
+  }
+  if (!TEMPLATE_GCU_VECTOR_RESERVE(vector, vector->count + view.count)) {
+    return false;
+  }
+  memcpy(vector->data + vector->count, view.data, view.count * sizeof(TEMPLATE_GCU_TYPE_UNION));
+  vector->count += view.count;
+  return true;
+}
+
+#undef TEMPLATE_GCU_VECTOR
+#undef TEMPLATE_GCU_VIEW
+#undef TEMPLATE_GCU_TYPE_UNION
+#undef TEMPLATE_GCU_VECTOR_VIEW
+#undef TEMPLATE_GCU_VECTOR_RESERVE
+#undef TEMPLATE_GCU_VIEW_OF
+#undef TEMPLATE_GCU_VIEW_SLICE
+#undef TEMPLATE_GCU_VIEW_SPLIT
+#undef TEMPLATE_GCU_VIEW_HASH
+#undef TEMPLATE_GCU_VIEW_COPY
+
@@ -0,0 +1,148 @@
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <cutil/arena.h>
+#include <cutil/hash.h>
+#include <cutil/memory.h>
+#include <cutil/vector.h>
+
+using namespace std;
+
+TEST(Arena, Allocate) {
+  auto arena = gcu_arena_create(1024);
+  ASSERT_NE(arena, nullptr);
+  ASSERT_EQ(gcu_arena_size(arena), 0);
+
+  // Allocations are aligned, and do not overlap.
+  char * a = (char *)gcu_arena_allocate(arena, 3);
+  char * b = (char *)gcu_arena_allocate(arena, 5);
+  ASSERT_EQ((uintptr_t)a % GCU_ARENA_ALIGNMENT, 0);
+  ASSERT_EQ((uintptr_t)b % GCU_ARENA_ALIGNMENT, 0);
+  ASSERT_GE(b, a + 3);
+  char * c = (char *)gcu_arena_allocate_aligned(arena, 10, 256);
+  ASSERT_EQ((uintptr_t)c % 256, 0);
+  memset(c, 1, 10);
+
+  // Filling a chunk moves to another, and large allocations get their own.
+  for (int i = 0; i < 100; ++i) {
+    memset(gcu_arena_allocate(arena, 100), i, 100);
+  }
+  char * large = (char *)gcu_arena_allocate(arena, 10000);
+  ASSERT_NE(large, nullptr);
+  memset(large, 2, 10000);
+  ASSERT_GE(gcu_arena_size(arena), 10000 + 100 * 100);
+  gcu_arena_destroy(arena);
+}
+
+TEST(Arena, ResetReusesChunks) {
+  gcu_memory_reset_counts();
+  auto arena = gcu_arena_create(4096);
+  for (int i = 0; i < 1000; ++i) {
+    gcu_arena_allocate(arena, 64);
+  }
+  size_t size = gcu_arena_size(arena);
+  size_t allocations = gcu_get_alloc_count();
+
+  // The same work after a reset takes no more memory from the heap.
+  for (int round = 0; round < 10; ++round) {
+    gcu_arena_reset(arena);
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_NE(gcu_arena_allocate(arena, 64), nullptr);
+    }
+  }
+  ASSERT_EQ(gcu_arena_size(arena), size);
+  ASSERT_EQ(gcu_get_alloc_count(), allocations);
+  gcu_arena_destroy(arena);
+  ASSERT_EQ(gcu_get_alloc_count(), gcu_get_free_count());
+}
+
+TEST(Arena, MarkRewind) {
+  auto arena = gcu_arena_create(256);
+  int * kept = (int *)gcu_arena_allocate(arena, sizeof(int));
+  *kept = 42;
+  auto mark = gcu_arena_mark(arena);
+  void * first = gcu_arena_allocate(arena, 100);
+  for (int i = 0; i < 20; ++i) {
+    gcu_arena_allocate(arena, 100);
+  }
+
+  // Rewinding gives back what came after the mark, across chunks.
+  gcu_arena_rewind(arena, mark);
+  ASSERT_EQ(gcu_arena_allocate(arena, 100), first);
+  ASSERT_EQ(*kept, 42);
+
+  // A mark taken before anything was allocated rewinds to the start.
+  auto empty = gcu_arena_create(256);
+  auto start = gcu_arena_mark(empty);
+  void * initial = gcu_arena_allocate(empty, 10);
+  gcu_arena_rewind(empty, start);
+  ASSERT_EQ(gcu_arena_allocate(empty, 10), initial);
+  gcu_arena_destroy(empty);
+  gcu_arena_destroy(arena);
+}
+
+TEST(Arena, Reallocate) {
+  auto arena = gcu_arena_create(1024);
+  char * a = (char *)gcu_arena_allocate(arena, 16);
+  memcpy(a, "0123456789abcdef", 16);
+
+  // The most recent allocation grows in place.
+  ASSERT_EQ(gcu_arena_reallocate(arena, a, 16, 64), a);
+
+  // Others are copied.
+  gcu_arena_allocate(arena, 8);
+  char * b = (char *)gcu_arena_reallocate(arena, a, 64, 128);
+  ASSERT_NE(b, a);
+  ASSERT_EQ(memcmp(b, "0123456789abcdef", 16), 0);
+
+  // Growing past the end of the chunk copies to a new one.
+  char * c = (char *)gcu_arena_reallocate(arena, b, 128, 4096);
+  ASSERT_NE(c, nullptr);
+  ASSERT_EQ(memcmp(c, "0123456789abcdef", 16), 0);
+  gcu_arena_destroy(arena);
+}
+
+TEST(Arena, Containers) {
+  gcu_memory_reset_counts();
+  auto arena = gcu_arena_create(0);
+
+  // Containers, and their data, come from the arena's chunks.
+  for (int round = 0; round < 3; ++round) {
+    auto v = gcu_vector64_create_in_arena(arena, 0);
+    auto reserved = gcu_vector32_create_in_arena(arena, 100);
+    auto hashTable = gcu_hash64_create_in_arena(arena, 0);
+    ASSERT_NE(v, nullptr);
+    ASSERT_NE(reserved, nullptr);
+    ASSERT_NE(hashTable, nullptr);
+    ASSERT_EQ(reserved->capacity, 100);
+    for (uint64_t i = 0; i < 2000; ++i) {
+      ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(i)));
+      ASSERT_TRUE(gcu_hash64_set(hashTable, i * 0x9E3779B97F4A7C15ull, gcu_type64_ui64(i)));
+    }
+    for (uint64_t i = 0; i < 2000; ++i) {
+      ASSERT_EQ(v->data[i].ui64, i);
+    }
+    ASSERT_EQ(gcu_hash64_get(hashTable, 1234 * 0x9E3779B97F4A7C15ull).value.ui64, 1234);
+
+    auto clone = gcu_hash64_clone(hashTable);
+    ASSERT_EQ(clone->growth.arena, arena);
+    ASSERT_EQ(gcu_hash64_count(clone), 2000);
+
+    // Storage cannot move out of the arena.
+    ASSERT_FALSE(gcu_vector64_set_growth(v, {}));
+
+    // Destroying a container in an arena frees nothing.
+    gcu_hash64_destroy(clone);
+    gcu_hash64_destroy(hashTable);
+    gcu_vector32_destroy(reserved);
+    gcu_vector64_destroy(v);
+    gcu_arena_reset(arena);
+  }
+  gcu_arena_destroy(arena);
+  ASSERT_EQ(gcu_get_alloc_count(), gcu_get_free_count());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,187 @@
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cutil/bitvector.h>
+
+using namespace std;
+
+// Build a bit vector with the same bits as `bits`.
+static GCU_BitVector * fromBools(const vector<bool> & bits) {
+  auto v = gcu_bitvector_create(0);
+  for (bool bit : bits) {
+    gcu_bitvector_append(v, bit);
+  }
+  return v;
+}
+
+// Verify that the bit vector holds exactly `bits`, and that the unused bits
+// of its last word are clear.
+static void expectBits(GCU_BitVector * v, const vector<bool> & bits) {
+  ASSERT_EQ(gcu_bitvector_count(v), bits.size());
+  size_t set = 0;
+  for (size_t i = 0; i < bits.size(); ++i) {
+    ASSERT_EQ(gcu_bitvector_get(v, i), bits[i]) << i;
+    set += bits[i];
+  }
+  ASSERT_EQ(gcu_bitvector_popcount(v), set);
+  if (bits.size() % 64) {
+    ASSERT_EQ(v->data[bits.size() / 64] >> (bits.size() % 64), 0);
+  }
+}
+
+static vector<bool> randomBools(size_t count, uint64_t seed, unsigned percent = 50) {
+  mt19937_64 rng{seed};
+  vector<bool> bits(count);
+  for (size_t i = 0; i < count; ++i) {
+    bits[i] = rng() % 100 < percent;
+  }
+  return bits;
+}
+
+TEST(BitVector, CreateEmpty) {
+  auto v = gcu_bitvector_create(0);
+  ASSERT_NE(v, nullptr);
+  ASSERT_EQ(gcu_bitvector_count(v), 0);
+  ASSERT_EQ(v->capacity, 0);
+  ASSERT_EQ(gcu_bitvector_popcount(v), 0);
+  ASSERT_EQ(gcu_bitvector_find_next_set(v, 0), 0);
+  ASSERT_FALSE(gcu_bitvector_get(v, 0));
+  ASSERT_FALSE(gcu_bitvector_set(v, 0));
+  gcu_bitvector_destroy(v);
+}
+
+TEST(BitVector, Null) {
+  ASSERT_FALSE(gcu_bitvector_append(nullptr, true));
+  ASSERT_FALSE(gcu_bitvector_resize(nullptr, 10));
+  ASSERT_EQ(gcu_bitvector_count(nullptr), 0);
+  ASSERT_EQ(gcu_bitvector_popcount(nullptr), 0);
+  ASSERT_EQ(gcu_bitvector_find_next_set(nullptr, 0), 0);
+  ASSERT_FALSE(gcu_bitvector_get(nullptr, 0));
+  ASSERT_FALSE(gcu_bitvector_set(nullptr, 0));
+  ASSERT_FALSE(gcu_bitvector_clear(nullptr, 0));
+
+  auto v = gcu_bitvector_create(0);
+  ASSERT_TRUE(gcu_bitvector_append(v, true));
+  gcu_bitvector_and(v, nullptr);
+  gcu_bitvector_or(nullptr, v);
+  gcu_bitvector_xor(v, nullptr);
+  gcu_bitvector_andnot(nullptr, v);
+  ASSERT_TRUE(gcu_bitvector_get(v, 0));
+  gcu_bitvector_destroy(v);
+}
+
+TEST(BitVector, Create) {
+  auto v = gcu_bitvector_create(100);
+  ASSERT_EQ(gcu_bitvector_count(v), 0);
+  ASSERT_EQ(v->capacity, 128);
+  gcu_bitvector_destroy(v);
+
+  GCU_BitVector inPlace;
+  ASSERT_TRUE(gcu_bitvector_create_in_place(&inPlace, 64));
+  ASSERT_EQ(inPlace.capacity, 64);
+  gcu_bitvector_destroy_in_place(&inPlace);
+}
+
+TEST(BitVector, AppendGetSetClear) {
+  auto bits = randomBools(10000, 1);
+  auto v = fromBools(bits);
+  expectBits(v, bits);
+
+  for (size_t i = 0; i < bits.size(); i += 7) {
+    ASSERT_TRUE(gcu_bitvector_set(v, i));
+    bits[i] = true;
+  }
+  for (size_t i = 0; i < bits.size(); i += 11) {
+    ASSERT_TRUE(gcu_bitvector_clear(v, i));
+    bits[i] = false;
+  }
+  expectBits(v, bits);
+
+  // Out of range.
+  ASSERT_FALSE(gcu_bitvector_set(v, bits.size()));
+  ASSERT_FALSE(gcu_bitvector_clear(v, bits.size()));
+  ASSERT_FALSE(gcu_bitvector_get(v, bits.size()));
+  gcu_bitvector_destroy(v);
+}
+
+TEST(BitVector, Resize) {
+  auto v = gcu_bitvector_create(0);
+  ASSERT_TRUE(gcu_bitvector_resize(v, 200));
+  ASSERT_EQ(gcu_bitvector_popcount(v), 0);
+  for (size_t i = 0; i < 200; ++i) {
+    gcu_bitvector_set(v, i);
+  }
+
+  // Shrinking clears the removed bits, so growing again exposes clear bits.
+  ASSERT_TRUE(gcu_bitvector_resize(v, 70));
+  ASSERT_EQ(gcu_bitvector_popcount(v), 70);
+  ASSERT_TRUE(gcu_bitvector_resize(v, 300));
+  ASSERT_EQ(gcu_bitvector_popcount(v), 70);
+  ASSERT_FALSE(gcu_bitvector_get(v, 70));
+  ASSERT_FALSE(gcu_bitvector_get(v, 150));
+  ASSERT_TRUE(gcu_bitvector_append(v, true));
+  ASSERT_TRUE(gcu_bitvector_get(v, 300));
+  ASSERT_EQ(gcu_bitvector_popcount(v), 71);
+  gcu_bitvector_destroy(v);
+}
+
+TEST(BitVector, FindNextSet) {
+  for (unsigned percent : {0, 1, 50, 100}) {
+    auto bits = randomBools(5000, percent, percent);
+    auto v = fromBools(bits);
+    vector<size_t> expected;
+    for (size_t i = 0; i < bits.size(); ++i) {
+      if (bits[i]) {
+        expected.push_back(i);
+      }
+    }
+    vector<size_t> found;
+    for (size_t i = gcu_bitvector_find_next_set(v, 0); i < v->count; i = gcu_bitvector_find_next_set(v, i + 1)) {
+      found.push_back(i);
+    }
+    ASSERT_EQ(found, expected) << percent;
+    ASSERT_EQ(gcu_bitvector_find_next_set(v, bits.size() + 10), bits.size());
+    gcu_bitvector_destroy(v);
+  }
+}
+
+TEST(BitVector, BulkOperations) {
+  // Lengths which do and do not end on a word boundary, in both orders.
+  for (auto [a, b] : vector<pair<size_t, size_t>>{{1000, 1000}, {1000, 333}, {333, 1000}, {640, 4096}, {4096, 70}, {0, 100}, {100, 0}}) {
+    auto x = randomBools(a, a + 1);
+    auto y = randomBools(b, b + 2);
+    auto apply = [&](void (*op)(GCU_BitVector *, GCU_BitVector *), bool (*f)(bool, bool)) {
+      auto dst = fromBools(x);
+      auto src = fromBools(y);
+      op(dst, src);
+      vector<bool> expected(x.size());
+      for (size_t i = 0; i < x.size(); ++i) {
+        expected[i] = f(x[i], i < y.size() && y[i]);
+      }
+      expectBits(dst, expected);
+      expectBits(src, y);
+      gcu_bitvector_destroy(dst);
+      gcu_bitvector_destroy(src);
+    };
+    apply(gcu_bitvector_and, [](bool p, bool q) { return p && q; });
+    apply(gcu_bitvector_or, [](bool p, bool q) { return p || q; });
+    apply(gcu_bitvector_xor, [](bool p, bool q) { return p != q; });
+    apply(gcu_bitvector_andnot, [](bool p, bool q) { return p && !q; });
+  }
+}
+
+TEST(BitVector, BulkOperationsWithItself) {
+  auto bits = randomBools(1000, 3);
+  auto v = fromBools(bits);
+  gcu_bitvector_and(v, v);
+  gcu_bitvector_or(v, v);
+  expectBits(v, bits);
+  gcu_bitvector_xor(v, v);
+  expectBits(v, vector<bool>(bits.size()));
+  gcu_bitvector_destroy(v);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
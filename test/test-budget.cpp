@@ -0,0 +1,231 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <cutil/budget.h>
+#include <cutil/hash.h>
+#include <cutil/memory.h>
+#include <cutil/vector.h>
+
+using namespace std;
+
+// A growth policy which charges a budget.
+static GCU_Growth budgeted(GCU_Budget * budget) {
+  GCU_Growth growth = {};
+  growth.allocator = gcu_budget_allocator(budget);
+  return growth;
+}
+
+TEST(Budget, Counts) {
+  auto budget = gcu_budget_create(nullptr, 0, 0);
+  ASSERT_NE(budget, nullptr);
+  auto allocator = gcu_budget_allocator(budget);
+  auto a = gcu_allocator_allocate(allocator, 1000);
+  ASSERT_NE(a, nullptr);
+  ASSERT_GE(gcu_budget_used(budget), 1000);
+  ASSERT_EQ(gcu_budget_used(budget), gcu_allocator_usable_size(allocator, a));
+  a = gcu_allocator_reallocate(allocator, a, 5000);
+  ASSERT_EQ(gcu_budget_used(budget), gcu_allocator_usable_size(allocator, a));
+  auto b = gcu_allocator_allocate_zeroed(allocator, 10, 100);
+  ASSERT_EQ(((char *)b)[999], 0);
+  gcu_allocator_free(allocator, a);
+  gcu_allocator_free(allocator, b);
+  ASSERT_EQ(gcu_budget_used(budget), 0);
+  ASSERT_GE(gcu_budget_peak(budget), 6000);
+  ASSERT_EQ(gcu_budget_failures(budget), 0);
+  gcu_budget_destroy(budget);
+}
+
+TEST(Budget, VectorStopsAtLimit) {
+  auto budget = gcu_budget_create(nullptr, 64 << 10, 0);
+  auto v = gcu_vector64_create(0);
+  ASSERT_TRUE(gcu_vector64_set_growth(v, budgeted(budget)));
+
+  // Growth fails cleanly at the hard limit, keeping what was appended.
+  size_t appended = 0;
+  while (gcu_vector64_append(v, gcu_type64_ui64(appended))) {
+    ++appended;
+  }
+  ASSERT_GT(appended, 1000);
+  ASSERT_EQ(gcu_vector64_count(v), appended);
+  ASSERT_EQ(gcu_budget_failures(budget), 1);
+  ASSERT_LE(gcu_budget_used(budget), 64 << 10);
+  ASSERT_EQ(gcu_vector64_bytes(v), v->capacity * sizeof(GCU_Type64_Union));
+  ASSERT_LE(gcu_vector64_bytes(v), gcu_budget_used(budget));
+  for (size_t i = 0; i < appended; ++i) {
+    ASSERT_EQ(v->data[i].ui64, i);
+  }
+
+  // Raising the limit lets it grow again.
+  gcu_budget_set_limits(budget, 1 << 20, 0);
+  ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(appended)));
+  gcu_vector64_destroy(v);
+  ASSERT_EQ(gcu_budget_used(budget), 0);
+  gcu_budget_destroy(budget);
+}
+
+TEST(Budget, HashStopsAtLimit) {
+  auto budget = gcu_budget_create(nullptr, 64 << 10, 0);
+  auto t = gcu_hash64_create(0);
+  ASSERT_TRUE(gcu_hash64_set_growth(t, budgeted(budget)));
+  size_t set = 0;
+  while (gcu_hash64_set(t, set, gcu_type64_ui64(set))) {
+    ++set;
+  }
+  ASSERT_GT(set, 100);
+  ASSERT_EQ(gcu_hash64_count(t), set);
+  ASSERT_GE(gcu_budget_failures(budget), 1);
+  ASSERT_LE(gcu_budget_used(budget), 64 << 10);
+  ASSERT_EQ(gcu_hash64_bytes(t), t->capacity * sizeof(GCU_Hash64_Cell));
+  for (size_t i = 0; i < set; ++i) {
+    ASSERT_EQ(gcu_hash64_get(t, i).value.ui64, i);
+  }
+  gcu_hash64_destroy(t);
+  ASSERT_EQ(gcu_budget_used(budget), 0);
+  gcu_budget_destroy(budget);
+}
+
+// A cache which gives back its memory when the budget runs short.
+struct Cache {
+  const GCU_Allocator * allocator;
+  void * blocks[16];
+  size_t count;
+  size_t calls;
+};
+
+static void evict(GCU_Budget *, size_t, void * context) {
+  auto cache = (Cache *)context;
+  ++cache->calls;
+  while (cache->count) {
+    gcu_allocator_free(cache->allocator, cache->blocks[--cache->count]);
+  }
+}
+
+TEST(Budget, Pressure) {
+  auto budget = gcu_budget_create(nullptr, 100000, 50000);
+  auto allocator = gcu_budget_allocator(budget);
+  Cache cache = {allocator, {}, 0, 0};
+  ASSERT_TRUE(gcu_budget_add_pressure_callback(budget, evict, &cache));
+
+  // Reaching the soft limit calls the callback once.
+  for (; cache.count < 4; ++cache.count) {
+    cache.blocks[cache.count] = gcu_allocator_allocate(allocator, 10000);
+  }
+  ASSERT_EQ(cache.calls, 0);
+  auto a = gcu_allocator_allocate(allocator, 20000);
+  ASSERT_EQ(cache.calls, 1);
+  ASSERT_EQ(cache.count, 0);
+  gcu_allocator_free(allocator, a);
+
+  // An allocation past the hard limit succeeds if the callback frees enough.
+  gcu_budget_set_limits(budget, 100000, 0);
+  for (; cache.count < 9; ++cache.count) {
+    cache.blocks[cache.count] = gcu_allocator_allocate(allocator, 10000);
+  }
+  size_t calls = cache.calls;
+  a = gcu_allocator_allocate(allocator, 30000);
+  ASSERT_NE(a, nullptr);
+  ASSERT_GT(cache.calls, calls);
+  ASSERT_EQ(gcu_budget_failures(budget), 0);
+
+  // Otherwise it fails.
+  ASSERT_EQ(gcu_allocator_allocate(allocator, 200000), nullptr);
+  ASSERT_EQ(gcu_budget_failures(budget), 1);
+  gcu_allocator_free(allocator, a);
+  ASSERT_EQ(gcu_budget_used(budget), 0);
+  gcu_budget_destroy(budget);
+}
+
+TEST(Budget, Callbacks) {
+  auto budget = gcu_budget_create(nullptr, 0, 0);
+  Cache cache = {};
+  for (size_t i = 0; i < GCU_BUDGET_CALLBACKS; ++i) {
+    ASSERT_TRUE(gcu_budget_add_pressure_callback(budget, evict, &cache));
+  }
+  ASSERT_FALSE(gcu_budget_add_pressure_callback(budget, evict, &cache));
+  gcu_budget_destroy(budget);
+}
+
+TEST(Budget, Groups) {
+  auto process = gcu_budget_create(nullptr, 1 << 20, 0);
+  auto group = gcu_budget_create(gcu_budget_allocator(process), 1 << 20, 0);
+  size_t overhead = gcu_budget_used(process);
+
+  // A group's memory is charged to its parent as well, whose limit applies
+  // to the whole group.
+  auto v = gcu_vector64_create(0);
+  ASSERT_TRUE(gcu_vector64_set_growth(v, budgeted(group)));
+  ASSERT_TRUE(gcu_vector64_reserve(v, 1000));
+  ASSERT_EQ(gcu_budget_used(process) - overhead, gcu_budget_used(group));
+  gcu_budget_set_limits(process, gcu_budget_used(process) + 1000, 0);
+  ASSERT_FALSE(gcu_vector64_reserve(v, 100000));
+  ASSERT_EQ(gcu_budget_failures(process), 1);
+  gcu_vector64_destroy(v);
+  ASSERT_EQ(gcu_budget_used(group), 0);
+  gcu_budget_destroy(group);
+  ASSERT_EQ(gcu_budget_used(process), 0);
+  gcu_budget_destroy(process);
+}
+
+TEST(Budget, Process) {
+  auto budget = gcu_budget_create(nullptr, 1 << 20, 0);
+  auto previous = gcu_set_allocator(gcu_budget_allocator(budget));
+
+  // gcu_malloc(), and so every container, is held to the budget.
+  auto t = gcu_hash64_create(10);
+  ASSERT_GT(gcu_budget_used(budget), gcu_hash64_bytes(t));
+  ASSERT_EQ(gcu_malloc(2 << 20), nullptr);
+  gcu_hash64_destroy(t);
+  gcu_set_allocator(previous);
+  ASSERT_EQ(gcu_budget_used(budget), 0);
+  ASSERT_EQ(gcu_budget_failures(budget), 1);
+  gcu_budget_destroy(budget);
+}
+
+TEST(Budget, ForeignBlocks) {
+  // A block allocated before the budget was installed is freed through it
+  // without taking the count below zero.
+  auto before = gcu_malloc(4000);
+  auto budget = gcu_budget_create(nullptr, 1 << 20, 0);
+  auto previous = gcu_set_allocator(gcu_budget_allocator(budget));
+  auto a = gcu_malloc(100);
+  gcu_free(before);
+  ASSERT_EQ(gcu_budget_used(budget), 0);
+  gcu_free(a);
+  ASSERT_EQ(gcu_budget_used(budget), 0);
+
+  // The budget still works afterwards.
+  a = gcu_malloc(1000);
+  ASSERT_NE(a, nullptr);
+  ASSERT_GE(gcu_budget_used(budget), 1000);
+  gcu_free(a);
+  gcu_set_allocator(previous);
+  ASSERT_EQ(gcu_budget_used(budget), 0);
+  ASSERT_EQ(gcu_budget_failures(budget), 0);
+  gcu_budget_destroy(budget);
+}
+
+TEST(Budget, ShrinkingNeverFails) {
+  // Rounding by the parent may leave a block over the hard limit, which
+  // must still be allowed to shrink.
+  auto budget = gcu_budget_create(nullptr, 100, 0);
+  auto allocator = gcu_budget_allocator(budget);
+  auto a = gcu_allocator_allocate(allocator, 100);
+  ASSERT_NE(a, nullptr);
+  a = gcu_allocator_reallocate(allocator, a, 50);
+  ASSERT_NE(a, nullptr);
+  ASSERT_EQ(gcu_budget_failures(budget), 0);
+  ASSERT_EQ(gcu_budget_used(budget), gcu_allocator_usable_size(allocator, a));
+  gcu_allocator_free(allocator, a);
+  ASSERT_EQ(gcu_budget_used(budget), 0);
+  gcu_budget_destroy(budget);
+}
+
+TEST(Budget, ParentMustKnowSizes) {
+  GCU_Allocator allocator = gcu_system_allocator;
+  allocator.usable_size = nullptr;
+  ASSERT_EQ(gcu_budget_create(&allocator, 0, 0), nullptr);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
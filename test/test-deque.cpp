@@ -0,0 +1,246 @@
+#include <deque>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cutil/deque.h>
+
+using namespace std;
+
+// Verify that the deque holds exactly the values of `expected`, in order.
+template <typename T>
+static void expectEqual(T * d, const deque<uint64_t> & expected) {
+  ASSERT_EQ(d->count, expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(d->data[(d->head + i) & (d->capacity - 1)].ui64, expected[i]) << i;
+  }
+}
+
+TEST(Ring64, CreateRoundsUp) {
+  auto r = gcu_ring64_create(100);
+  ASSERT_NE(r, nullptr);
+  ASSERT_EQ(r->capacity, 128);
+  ASSERT_EQ(gcu_ring64_count(r), 0);
+  ASSERT_FALSE(gcu_ring64_pop_front(r).exists);
+  ASSERT_FALSE(gcu_ring64_pop_back(r).exists);
+  ASSERT_FALSE(gcu_ring64_get(r, 0).exists);
+  gcu_ring64_destroy(r);
+
+  GCU_Ring64 inPlace;
+  ASSERT_TRUE(gcu_ring64_create_in_place(&inPlace, 0));
+  ASSERT_EQ(inPlace.capacity, 1);
+  ASSERT_TRUE(gcu_ring64_push_back(&inPlace, gcu_type64_ui64(7)));
+  ASSERT_FALSE(gcu_ring64_push_back(&inPlace, gcu_type64_ui64(8)));
+  ASSERT_EQ(gcu_ring64_pop_front(&inPlace).value.ui64, 7);
+  gcu_ring64_destroy_in_place(&inPlace);
+}
+
+TEST(Ring64, BothEnds) {
+  auto r = gcu_ring64_create(4);
+  ASSERT_TRUE(gcu_ring64_push_back(r, gcu_type64_ui64(2)));
+  ASSERT_TRUE(gcu_ring64_push_front(r, gcu_type64_ui64(1)));
+  ASSERT_TRUE(gcu_ring64_push_back(r, gcu_type64_ui64(3)));
+  ASSERT_TRUE(gcu_ring64_push_front(r, gcu_type64_ui64(0)));
+
+  // The ring is full, and stays unchanged.
+  ASSERT_FALSE(gcu_ring64_push_back(r, gcu_type64_ui64(4)));
+  ASSERT_FALSE(gcu_ring64_push_front(r, gcu_type64_ui64(4)));
+  GCU_Type64_Union extra[1] = {gcu_type64_ui64(4)};
+  ASSERT_FALSE(gcu_ring64_push_many(r, extra, 1));
+  expectEqual(r, {0, 1, 2, 3});
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_EQ(gcu_ring64_get(r, i).value.ui64, i);
+  }
+
+  ASSERT_EQ(gcu_ring64_pop_back(r).value.ui64, 3);
+  ASSERT_EQ(gcu_ring64_pop_front(r).value.ui64, 0);
+  ASSERT_EQ(gcu_ring64_pop_front(r).value.ui64, 1);
+  ASSERT_EQ(gcu_ring64_pop_back(r).value.ui64, 2);
+  ASSERT_FALSE(gcu_ring64_pop_back(r).exists);
+  gcu_ring64_destroy(r);
+}
+
+TEST(Ring64, ManyWrapsAround) {
+  auto r = gcu_ring64_create(16);
+  deque<uint64_t> expected;
+  uint64_t next = 0;
+  mt19937_64 rng{1};
+  for (int round = 0; round < 1000; ++round) {
+    // Push a block, if it fits.
+    vector<GCU_Type64_Union> in(rng() % 12);
+    for (auto & value : in) {
+      value = gcu_type64_ui64(next++);
+    }
+    bool fits = expected.size() + in.size() <= 16;
+    ASSERT_EQ(gcu_ring64_push_many(r, in.data(), in.size()), fits);
+    if (fits) {
+      for (auto & value : in) {
+        expected.push_back(value.ui64);
+      }
+    }
+    expectEqual(r, expected);
+
+    // Pop a block, which may be more than there is.
+    vector<GCU_Type64_Union> out(rng() % 12);
+    size_t popped = gcu_ring64_pop_many(r, out.data(), out.size());
+    ASSERT_EQ(popped, min(out.size(), expected.size()));
+    for (size_t i = 0; i < popped; ++i) {
+      ASSERT_EQ(out[i].ui64, expected.front());
+      expected.pop_front();
+    }
+    expectEqual(r, expected);
+  }
+  gcu_ring64_destroy(r);
+}
+
+// Helper function for next test.
+static void countValues(GCU_Ring64 * ring) {
+  *(size_t *)ring->supplementary_data = ring->count;
+}
+
+TEST(Ring64, Cleanup) {
+  auto r = gcu_ring64_create(8);
+  size_t count = 0;
+  r->supplementary_data = (void *)&count;
+  r->cleanup = countValues;
+  ASSERT_TRUE(gcu_ring64_push_back(r, gcu_type64_b(true)));
+  ASSERT_TRUE(gcu_ring64_push_back(r, gcu_type64_b(true)));
+  gcu_ring64_destroy(r);
+  ASSERT_EQ(count, 2);
+}
+
+TEST(Deque64, CreateEmpty) {
+  auto d = gcu_deque64_create(0);
+  ASSERT_NE(d, nullptr);
+  ASSERT_EQ(d->capacity, 0);
+  ASSERT_FALSE(gcu_deque64_pop_front(d).exists);
+  ASSERT_FALSE(gcu_deque64_pop_back(d).exists);
+  ASSERT_EQ(gcu_deque64_pop_many(d, nullptr, 10), 0);
+
+  // Verify that a push allocates the buffer.
+  ASSERT_TRUE(gcu_deque64_push_front(d, gcu_type64_ui64(42)));
+  ASSERT_EQ(d->capacity, 16);
+  ASSERT_EQ(gcu_deque64_get(d, 0).value.ui64, 42);
+  gcu_deque64_destroy(d);
+
+  GCU_Deque64 inPlace;
+  ASSERT_TRUE(gcu_deque64_create_in_place(&inPlace, 1000));
+  ASSERT_EQ(inPlace.capacity, 1024);
+  gcu_deque64_destroy_in_place(&inPlace);
+}
+
+TEST(Deque64, GrowKeepsOrder) {
+  // Wrap the values around the end of the buffer before it grows, with the
+  // wrapped part both shorter and longer than the rest.
+  for (size_t front : {3, 13}) {
+    auto d = gcu_deque64_create(16);
+    deque<uint64_t> expected;
+    for (size_t i = 0; i < 16; ++i) {
+      if (i < front) {
+        ASSERT_TRUE(gcu_deque64_push_front(d, gcu_type64_ui64(1000 - i)));
+        expected.push_front(1000 - i);
+      }
+      else {
+        ASSERT_TRUE(gcu_deque64_push_back(d, gcu_type64_ui64(i)));
+        expected.push_back(i);
+      }
+    }
+    ASSERT_EQ(d->capacity, 16);
+    expectEqual(d, expected);
+
+    ASSERT_TRUE(gcu_deque64_push_back(d, gcu_type64_ui64(99)));
+    expected.push_back(99);
+    ASSERT_EQ(d->capacity, 32);
+    expectEqual(d, expected);
+
+    // Grow through a bulk push, too.
+    vector<GCU_Type64_Union> in(100);
+    for (size_t i = 0; i < in.size(); ++i) {
+      in[i] = gcu_type64_ui64(2000 + i);
+      expected.push_back(2000 + i);
+    }
+    ASSERT_TRUE(gcu_deque64_push_many(d, in.data(), in.size()));
+    ASSERT_EQ(d->capacity, 128);
+    expectEqual(d, expected);
+    gcu_deque64_destroy(d);
+  }
+}
+
+TEST(Deque64, SteadyStateDoesNotGrow) {
+  auto d = gcu_deque64_create(0);
+  mt19937_64 rng{2};
+  deque<uint64_t> expected;
+  for (size_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(gcu_deque64_push_back(d, gcu_type64_ui64(i)));
+    expected.push_back(i);
+  }
+  size_t capacity = d->capacity;
+  auto data = d->data;
+
+  // Push and pop at random ends, never holding more than 100 values.
+  for (uint64_t i = 0; i < 100000; ++i) {
+    if (rng() % 2) {
+      ASSERT_TRUE(gcu_deque64_push_back(d, gcu_type64_ui64(i)));
+      expected.push_back(i);
+    }
+    else {
+      ASSERT_TRUE(gcu_deque64_push_front(d, gcu_type64_ui64(i)));
+      expected.push_front(i);
+    }
+    if (rng() % 2) {
+      ASSERT_EQ(gcu_deque64_pop_back(d).value.ui64, expected.back());
+      expected.pop_back();
+    }
+    else {
+      ASSERT_EQ(gcu_deque64_pop_front(d).value.ui64, expected.front());
+      expected.pop_front();
+    }
+  }
+  ASSERT_EQ(d->capacity, capacity);
+  ASSERT_EQ(d->data, data);
+  expectEqual(d, expected);
+
+  ASSERT_TRUE(gcu_deque64_reserve(d, 1000));
+  ASSERT_EQ(d->capacity, 1024);
+  expectEqual(d, expected);
+  gcu_deque64_destroy(d);
+}
+
+TEST(Deque, OtherBitDepths) {
+  auto d32 = gcu_deque32_create(0);
+  auto d16 = gcu_deque16_create(0);
+  auto d8 = gcu_deque8_create(0);
+  auto r32 = gcu_ring32_create(64);
+  auto r16 = gcu_ring16_create(64);
+  auto r8 = gcu_ring8_create(64);
+  for (uint8_t i = 0; i < 50; ++i) {
+    ASSERT_TRUE(gcu_deque32_push_front(d32, gcu_type32_ui32(i)));
+    ASSERT_TRUE(gcu_deque16_push_front(d16, gcu_type16_ui16(i)));
+    ASSERT_TRUE(gcu_deque8_push_front(d8, gcu_type8_ui8(i)));
+    ASSERT_TRUE(gcu_ring32_push_front(r32, gcu_type32_ui32(i)));
+    ASSERT_TRUE(gcu_ring16_push_front(r16, gcu_type16_ui16(i)));
+    ASSERT_TRUE(gcu_ring8_push_front(r8, gcu_type8_ui8(i)));
+  }
+  GCU_Type8_Union out[50];
+  ASSERT_EQ(gcu_deque8_pop_many(d8, out, 100), 50);
+  for (uint8_t i = 0; i < 50; ++i) {
+    ASSERT_EQ(out[i].ui8, 49 - i);
+    ASSERT_EQ(gcu_deque32_pop_back(d32).value.ui32, i);
+    ASSERT_EQ(gcu_deque16_pop_back(d16).value.ui16, i);
+    ASSERT_EQ(gcu_ring32_pop_back(r32).value.ui32, i);
+    ASSERT_EQ(gcu_ring16_pop_back(r16).value.ui16, i);
+    ASSERT_EQ(gcu_ring8_get(r8, i).value.ui8, 49 - i);
+  }
+  ASSERT_TRUE(gcu_ring8_push_many(r8, out, 14));
+  ASSERT_FALSE(gcu_ring8_push_many(r8, out, 1));
+  gcu_deque32_destroy(d32);
+  gcu_deque16_destroy(d16);
+  gcu_deque8_destroy(d8);
+  gcu_ring32_destroy(r32);
+  gcu_ring16_destroy(r16);
+  gcu_ring8_destroy(r8);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
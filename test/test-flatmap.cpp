@@ -0,0 +1,208 @@
+#include <map>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cutil/flatmap.h>
+
+using namespace std;
+
+// Verify that the map holds exactly the entries of `expected`, in order.
+static void expectEqual(GCU_FlatMap64 * m, const map<uint64_t, uint64_t> & expected) {
+  ASSERT_EQ(gcu_flatmap64_count(m), expected.size());
+  size_t i = 0;
+  for (auto & [key, value] : expected) {
+    ASSERT_EQ(m->keys.data[i].ui64, key);
+    ASSERT_EQ(m->values.data[i].ui64, value);
+    ++i;
+  }
+}
+
+TEST(FlatMap64, CreateEmpty) {
+  auto m = gcu_flatmap64_create(0);
+  ASSERT_NE(m, nullptr);
+  ASSERT_EQ(gcu_flatmap64_count(m), 0);
+  ASSERT_FALSE(gcu_flatmap64_contains(m, 5));
+  ASSERT_FALSE(gcu_flatmap64_get(m, 5).exists);
+  ASSERT_EQ(gcu_flatmap64_lower_bound(m, 5), 0);
+  ASSERT_FALSE(gcu_flatmap64_remove(m, 5));
+  ASSERT_FALSE(gcu_flatmap64_iterator_get(m).exists);
+  gcu_flatmap64_destroy(m);
+}
+
+TEST(FlatMap64, Null) {
+  ASSERT_FALSE(gcu_flatmap64_set(nullptr, 5, gcu_type64_ui64(1)));
+  ASSERT_EQ(gcu_flatmap64_count(nullptr), 0);
+  ASSERT_FALSE(gcu_flatmap64_contains(nullptr, 5));
+  ASSERT_FALSE(gcu_flatmap64_get(nullptr, 5).exists);
+  ASSERT_EQ(gcu_flatmap64_lower_bound(nullptr, 5), 0);
+  ASSERT_FALSE(gcu_flatmap64_remove(nullptr, 5));
+  ASSERT_FALSE(gcu_flatmap64_iterator_get(nullptr).exists);
+  ASSERT_FALSE(gcu_flatmap64_iterator_range(nullptr, 0, 10).exists);
+  ASSERT_FALSE(gcu_flatmap64_iterator_next(gcu_flatmap64_iterator_get(nullptr)).exists);
+}
+
+TEST(FlatMap64, CreateInPlace) {
+  GCU_FlatMap64 m;
+  ASSERT_TRUE(gcu_flatmap64_create_in_place(&m, 10));
+  ASSERT_GE(m.keys.capacity, 10);
+  ASSERT_TRUE(gcu_flatmap64_set(&m, 1, gcu_type64_ui64(2)));
+  ASSERT_EQ(gcu_flatmap64_get(&m, 1).value.ui64, 2);
+  gcu_flatmap64_destroy_in_place(&m);
+}
+
+TEST(FlatMap64, SetGetRemove) {
+  auto m = gcu_flatmap64_create(0);
+
+  // Insert out of order, so that every insertion position is exercised.
+  for (uint64_t key : {50, 10, 30, 70, 20, 60, 40}) {
+    ASSERT_TRUE(gcu_flatmap64_set(m, key, gcu_type64_ui64(key * 2)));
+  }
+  expectEqual(m, {{10, 20}, {20, 40}, {30, 60}, {40, 80}, {50, 100}, {60, 120}, {70, 140}});
+
+  // Replace a value.
+  ASSERT_TRUE(gcu_flatmap64_set(m, 30, gcu_type64_ui64(3)));
+  ASSERT_EQ(gcu_flatmap64_count(m), 7);
+  ASSERT_EQ(gcu_flatmap64_get(m, 30).value.ui64, 3);
+  ASSERT_FALSE(gcu_flatmap64_get(m, 31).exists);
+  ASSERT_TRUE(gcu_flatmap64_contains(m, 70));
+  ASSERT_FALSE(gcu_flatmap64_contains(m, 80));
+
+  // Remove the first, a middle, and the last entries.
+  ASSERT_TRUE(gcu_flatmap64_remove(m, 10));
+  ASSERT_TRUE(gcu_flatmap64_remove(m, 40));
+  ASSERT_TRUE(gcu_flatmap64_remove(m, 70));
+  ASSERT_FALSE(gcu_flatmap64_remove(m, 40));
+  expectEqual(m, {{20, 40}, {30, 3}, {50, 100}, {60, 120}});
+  gcu_flatmap64_destroy(m);
+}
+
+TEST(FlatMap64, LowerBound) {
+  auto m = gcu_flatmap64_create(0);
+  for (uint64_t key = 10; key <= 100; key += 10) {
+    gcu_flatmap64_set(m, key, gcu_type64_ui64(key));
+  }
+  ASSERT_EQ(gcu_flatmap64_lower_bound(m, 0), 0);
+  ASSERT_EQ(gcu_flatmap64_lower_bound(m, 10), 0);
+  ASSERT_EQ(gcu_flatmap64_lower_bound(m, 11), 1);
+  ASSERT_EQ(gcu_flatmap64_lower_bound(m, 50), 4);
+  ASSERT_EQ(gcu_flatmap64_lower_bound(m, 100), 9);
+  ASSERT_EQ(gcu_flatmap64_lower_bound(m, 101), 10);
+  ASSERT_EQ(gcu_flatmap64_lower_bound(m, UINT64_MAX), 10);
+  gcu_flatmap64_destroy(m);
+}
+
+TEST(FlatMap64, Iterator) {
+  auto m = gcu_flatmap64_create(0);
+  for (uint64_t key = 10; key <= 100; key += 10) {
+    gcu_flatmap64_set(m, key, gcu_type64_ui64(key + 1));
+  }
+
+  // Visit everything, in order.
+  vector<uint64_t> keys;
+  for (auto it = gcu_flatmap64_iterator_get(m); it.exists; it = gcu_flatmap64_iterator_next(it)) {
+    ASSERT_EQ(it.value.ui64, it.key + 1);
+    keys.push_back(it.key);
+  }
+  ASSERT_EQ(keys, vector<uint64_t>({10, 20, 30, 40, 50, 60, 70, 80, 90, 100}));
+
+  // Ranges are inclusive at both ends.
+  auto range = [&](uint64_t low, uint64_t high) {
+    vector<uint64_t> keys;
+    for (auto it = gcu_flatmap64_iterator_range(m, low, high); it.exists; it = gcu_flatmap64_iterator_next(it)) {
+      keys.push_back(it.key);
+    }
+    return keys;
+  };
+  ASSERT_EQ(range(30, 60), vector<uint64_t>({30, 40, 50, 60}));
+  ASSERT_EQ(range(25, 55), vector<uint64_t>({30, 40, 50}));
+  ASSERT_EQ(range(0, 15), vector<uint64_t>({10}));
+  ASSERT_EQ(range(95, UINT64_MAX), vector<uint64_t>({100}));
+  ASSERT_EQ(range(41, 49), vector<uint64_t>());
+  ASSERT_EQ(range(60, 30), vector<uint64_t>());
+  ASSERT_EQ(range(101, UINT64_MAX), vector<uint64_t>());
+
+  // Advancing past the end stays at the end.
+  auto it = gcu_flatmap64_iterator_range(m, 100, 100);
+  it = gcu_flatmap64_iterator_next(it);
+  ASSERT_FALSE(it.exists);
+  ASSERT_FALSE(gcu_flatmap64_iterator_next(it).exists);
+  gcu_flatmap64_destroy(m);
+}
+
+TEST(FlatMap64, SetMany) {
+  auto m = gcu_flatmap64_create(0);
+  map<uint64_t, uint64_t> expected;
+  mt19937_64 rng{1};
+
+  // Merge batches of different sizes, sorted and unsorted, with keys that
+  // repeat both within a batch and against the existing entries.
+  for (size_t size : {0, 1, 5, 31, 32, 33, 100, 1000, 10000}) {
+    for (bool sorted : {false, true}) {
+      vector<uint64_t> keys(size);
+      vector<GCU_Type64_Union> values(size);
+      for (size_t i = 0; i < size; ++i) {
+        keys[i] = rng() % 20000;
+      }
+      if (sorted) {
+        sort(keys.begin(), keys.end());
+      }
+      for (size_t i = 0; i < size; ++i) {
+        values[i].ui64 = rng();
+        expected[keys[i]] = values[i].ui64;
+      }
+      ASSERT_TRUE(gcu_flatmap64_set_many(m, keys.data(), values.data(), size));
+      expectEqual(m, expected);
+    }
+  }
+  gcu_flatmap64_destroy(m);
+}
+
+TEST(FlatMap64, SetManyKeepsLastDuplicate) {
+  auto m = gcu_flatmap64_create(0);
+  gcu_flatmap64_set(m, 5, gcu_type64_ui64(0));
+  gcu_flatmap64_set(m, 9, gcu_type64_ui64(0));
+
+  // Enough entries that the batch is merge sorted, not just insertion sorted.
+  vector<uint64_t> keys;
+  vector<GCU_Type64_Union> values;
+  for (uint64_t i = 0; i < 100; ++i) {
+    keys.push_back(100 - i % 10);
+    values.push_back(gcu_type64_ui64(i));
+  }
+  keys.push_back(5);
+  values.push_back(gcu_type64_ui64(555));
+  ASSERT_TRUE(gcu_flatmap64_set_many(m, keys.data(), values.data(), keys.size()));
+
+  map<uint64_t, uint64_t> expected{{5, 555}, {9, 0}};
+  for (uint64_t i = 0; i < 10; ++i) {
+    expected[100 - i] = 90 + i;
+  }
+  expectEqual(m, expected);
+  gcu_flatmap64_destroy(m);
+}
+
+TEST(FlatMap64, Random) {
+  // Interleave single sets and removes, and check against std::map.
+  auto m = gcu_flatmap64_create(0);
+  map<uint64_t, uint64_t> expected;
+  mt19937_64 rng{2};
+  for (size_t i = 0; i < 20000; ++i) {
+    uint64_t key = rng() % 2000;
+    if (rng() % 3) {
+      gcu_flatmap64_set(m, key, gcu_type64_ui64(i));
+      expected[key] = i;
+    }
+    else {
+      ASSERT_EQ(gcu_flatmap64_remove(m, key), expected.erase(key) == 1);
+    }
+    auto value = gcu_flatmap64_get(m, key);
+    ASSERT_EQ(value.exists, expected.count(key) == 1);
+  }
+  expectEqual(m, expected);
+  gcu_flatmap64_destroy(m);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
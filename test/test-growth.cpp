@@ -0,0 +1,239 @@
+#include <cstdlib>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <cutil/hash.h>
+#include <cutil/memory.h>
+#include <cutil/vector.h>
+
+using namespace std;
+
+// Storage of at least one megabyte is backed by huge pages.
+static const GCU_Growth HUGE_GROWTH = {2, 0, 0, 1 << 20, nullptr, 0, nullptr};
+
+TEST(Growth, Next) {
+  GCU_Growth growth = {1.5, 0, 0, 0, nullptr, 0, nullptr};
+  ASSERT_EQ(gcu_growth_next(&growth, 100), 150);
+
+  // The step never falls below the minimum, nor is it ever zero.
+  ASSERT_EQ(gcu_growth_next(&growth, 0), 1);
+  growth.minimum = 64;
+  ASSERT_EQ(gcu_growth_next(&growth, 0), 64);
+  ASSERT_EQ(gcu_growth_next(&growth, 100), 164);
+
+  // The step never rises above the maximum.
+  growth.maximum = 1000;
+  ASSERT_EQ(gcu_growth_next(&growth, 1000), 1500);
+  ASSERT_EQ(gcu_growth_next(&growth, 1000000), 1001000);
+
+  // A factor below one still grows.
+  growth = {0.5, 0, 0, 0, nullptr, 0, nullptr};
+  ASSERT_EQ(gcu_growth_next(&growth, 100), 101);
+  ASSERT_EQ(gcu_growth_next(&growth, SIZE_MAX), SIZE_MAX);
+}
+
+TEST(Growth, Vector) {
+  auto v = gcu_vector64_create(0);
+  ASSERT_TRUE(gcu_vector64_set_growth(v, {1.5, 10, 100, 0, nullptr, 0, nullptr}));
+  ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(0)));
+  ASSERT_EQ(v->capacity, 10);
+  for (uint64_t i = 1; i < 11; ++i) {
+    ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(i)));
+  }
+  ASSERT_EQ(v->capacity, 20);
+  for (uint64_t i = 11; i < 1000; ++i) {
+    ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(i)));
+  }
+
+  // Large vectors grow by the maximum step.
+  ASSERT_EQ(v->capacity, 1025);
+  for (uint64_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(v->data[i].ui64, i);
+  }
+  gcu_vector64_destroy(v);
+}
+
+TEST(Growth, HugeVector) {
+  gcu_memory_reset_counts();
+  auto v = gcu_vector64_create(0);
+  ASSERT_TRUE(gcu_vector64_set_growth(v, HUGE_GROWTH));
+
+  // The vector crosses the threshold, and is then remapped as it grows.
+  for (uint64_t i = 0; i < 1000000; ++i) {
+    ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(i * 7)));
+  }
+  ASSERT_TRUE(gcu_growth_is_huge(&v->growth, v->capacity * sizeof(GCU_Type64_Union)));
+  for (uint64_t i = 0; i < 1000000; ++i) {
+    ASSERT_EQ(v->data[i].ui64, i * 7);
+  }
+
+  // Going back to the default policy moves the data to the heap.
+  ASSERT_TRUE(gcu_vector64_set_growth(v, {}));
+  ASSERT_FALSE(gcu_growth_is_huge(&v->growth, v->capacity * sizeof(GCU_Type64_Union)));
+  ASSERT_EQ(v->data[999999].ui64, 999999 * 7);
+  ASSERT_TRUE(gcu_vector64_set_growth(v, HUGE_GROWTH));
+  ASSERT_EQ(v->data[123456].ui64, 123456 * 7);
+  gcu_vector64_destroy(v);
+
+  // Every allocation, mapped or not, was given back.
+  ASSERT_EQ(gcu_get_alloc_count(), gcu_get_free_count());
+}
+
+TEST(Growth, HugeVectorReserve) {
+  auto v = gcu_vector32_create(0);
+  ASSERT_TRUE(gcu_vector32_set_growth(v, HUGE_GROWTH));
+  ASSERT_TRUE(gcu_vector32_reserve(v, 1 << 20));
+  ASSERT_TRUE(gcu_growth_is_huge(&v->growth, v->capacity * sizeof(GCU_Type32_Union)));
+
+  // Mapped storage is zeroed.
+  for (size_t i = 0; i < v->capacity; ++i) {
+    ASSERT_EQ(v->data[i].ui32, 0);
+  }
+  gcu_vector32_destroy(v);
+}
+
+// Spread the keys as a hash function would.
+static size_t key(size_t i) {
+  return i * 0x9E3779B97F4A7C15ull;
+}
+
+TEST(Growth, Hash) {
+  gcu_memory_reset_counts();
+  auto hashTable = gcu_hash64_create(0);
+  ASSERT_TRUE(gcu_hash64_set_growth(hashTable, HUGE_GROWTH));
+  for (size_t i = 0; i < 20000; ++i) {
+    ASSERT_TRUE(gcu_hash64_set(hashTable, key(i), gcu_type64_ui64(i)));
+  }
+  ASSERT_EQ(gcu_hash64_count(hashTable), 20000);
+  ASSERT_TRUE(gcu_growth_is_huge(&hashTable->growth, hashTable->capacity * sizeof(GCU_Hash64_Cell)));
+  for (size_t i = 0; i < 20000; i += 7) {
+    auto value = gcu_hash64_get(hashTable, key(i));
+    ASSERT_TRUE(value.exists);
+    ASSERT_EQ(value.value.ui64, i);
+  }
+
+  // A clone is allocated the same way as its source.
+  auto clone = gcu_hash64_clone(hashTable);
+  ASSERT_NE(clone, nullptr);
+  ASSERT_EQ(gcu_hash64_get(clone, key(19999)).value.ui64, 19999);
+  gcu_hash64_destroy(clone);
+
+  ASSERT_TRUE(gcu_hash64_set_growth(hashTable, {}));
+  ASSERT_EQ(gcu_hash64_get(hashTable, key(4242)).value.ui64, 4242);
+  gcu_hash64_destroy(hashTable);
+  ASSERT_EQ(gcu_get_alloc_count(), gcu_get_free_count());
+}
+
+TEST(Growth, Aligned) {
+  gcu_memory_reset_counts();
+  GCU_Growth aligned = {2, 0, 0, 0, nullptr, 64, nullptr};
+  auto v = gcu_vector64_create(0);
+  ASSERT_TRUE(gcu_vector64_set_growth(v, aligned));
+  for (uint64_t i = 0; i < 10000; ++i) {
+    ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(i)));
+    ASSERT_EQ((uintptr_t)v->data % 64, 0);
+  }
+
+  // Changing the alignment moves the data.
+  aligned.alignment = 4096;
+  ASSERT_TRUE(gcu_vector64_set_growth(v, aligned));
+  ASSERT_EQ((uintptr_t)v->data % 4096, 0);
+  ASSERT_EQ(v->data[9999].ui64, 9999);
+  ASSERT_TRUE(gcu_vector64_set_growth(v, {}));
+  ASSERT_EQ(v->data[1234].ui64, 1234);
+  gcu_vector64_destroy(v);
+
+  auto hashTable = gcu_hash64_create(0);
+  aligned.alignment = 64;
+  ASSERT_TRUE(gcu_hash64_set_growth(hashTable, aligned));
+  for (size_t i = 0; i < 5000; ++i) {
+    ASSERT_TRUE(gcu_hash64_set(hashTable, key(i), gcu_type64_ui64(i)));
+  }
+  ASSERT_EQ((uintptr_t)hashTable->data % 64, 0);
+  ASSERT_EQ(gcu_hash64_get(hashTable, key(4321)).value.ui64, 4321);
+  gcu_hash64_destroy(hashTable);
+  ASSERT_EQ(gcu_get_alloc_count(), gcu_get_free_count());
+
+  // Storage in an arena is aligned too.
+  auto arena = gcu_arena_create(0);
+  v = gcu_vector64_create_in_arena(arena, 0);
+  aligned.arena = arena;
+  ASSERT_TRUE(gcu_vector64_set_growth(v, aligned));
+  for (uint64_t i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(i)));
+    ASSERT_EQ((uintptr_t)v->data % 64, 0);
+  }
+  ASSERT_EQ(v->data[999].ui64, 999);
+  gcu_vector64_destroy(v);
+  gcu_arena_destroy(arena);
+}
+
+// An allocator which counts the bytes it holds.
+static size_t held = 0;
+
+static void * heldAllocate(void *, size_t size) {
+  held += size;
+  auto block = (size_t *)malloc(size + 16);
+  *block = size;
+  return (char *)block + 16;
+}
+
+static void * heldAllocateZeroed(void * context, size_t nitems, size_t size) {
+  auto block = heldAllocate(context, nitems * size);
+  memset(block, 0, nitems * size);
+  return block;
+}
+
+static void * heldReallocate(void *, void * pointer, size_t size) {
+  auto block = (size_t *)((char *)pointer - 16);
+  held += size - *block;
+  block = (size_t *)realloc(block, size + 16);
+  *block = size;
+  return (char *)block + 16;
+}
+
+static void heldFree(void *, void * pointer) {
+  if (pointer) {
+    auto block = (size_t *)((char *)pointer - 16);
+    held -= *block;
+    free(block);
+  }
+}
+
+static size_t heldUsableSize(void *, void * pointer) {
+  return *(size_t *)((char *)pointer - 16);
+}
+
+static const GCU_Allocator HELD = {heldAllocate, heldAllocateZeroed, heldReallocate, heldFree, heldUsableSize, nullptr};
+
+TEST(Growth, Allocator) {
+  gcu_memory_reset_counts();
+  GCU_Growth growth = {2, 0, 0, 0, nullptr, 0, &HELD};
+  auto v = gcu_vector64_create(0);
+  ASSERT_TRUE(gcu_vector64_set_growth(v, growth));
+  for (uint64_t i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(i)));
+  }
+  ASSERT_EQ(held, v->capacity * sizeof(GCU_Type64_Union));
+
+  auto hashTable = gcu_hash64_create(0);
+  ASSERT_TRUE(gcu_hash64_set_growth(hashTable, growth));
+  for (size_t i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(gcu_hash64_set(hashTable, key(i), gcu_type64_ui64(i)));
+  }
+  ASSERT_EQ(held, v->capacity * sizeof(GCU_Type64_Union) + hashTable->capacity * sizeof(GCU_Hash64_Cell));
+  ASSERT_EQ(gcu_hash64_get(hashTable, key(567)).value.ui64, 567);
+  gcu_hash64_destroy(hashTable);
+
+  // Leaving the allocator moves the storage back to the heap.
+  ASSERT_TRUE(gcu_vector64_set_growth(v, {}));
+  ASSERT_EQ(held, 0);
+  ASSERT_EQ(v->data[999].ui64, 999);
+  gcu_vector64_destroy(v);
+  ASSERT_EQ(gcu_get_alloc_count(), gcu_get_free_count());
+  ASSERT_EQ(gcu_get_live_bytes(), 0);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,6 +1,7 @@
 #include <sstream>
 #include <gtest/gtest.h>
 #include <cutil/hash.h>
+#include <cutil/memory.h>
 
 using namespace std;
 
@@ -224,6 +225,56 @@ TEST(Hash64, InPlaceCleanup) {
   ASSERT_EQ(count, 3);
 }
 
+TEST(Hash64, CleanupSurvivesGrowth) {
+  auto t = gcu_hash64_create(0);
+  size_t count = 0;
+  t->supplementary_data = (void *)&count;
+  t->cleanup = addOne64;
+
+  // Force several resizes.  The cleanup function must not be called by them.
+  for (size_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(gcu_hash64_set(t, i, gcu_type64_b(true)));
+  }
+  ASSERT_EQ(count, 0);
+  ASSERT_EQ(t->supplementary_data, (void *)&count);
+  ASSERT_EQ(t->cleanup, addOne64);
+
+  gcu_hash64_destroy(t);
+  ASSERT_EQ(count, 100);
+}
+
+TEST(Hash64, Embedded) {
+  gcu_memory_reset_counts();
+  auto t = gcu_hash64_create_embedded(8);
+  ASSERT_NE(t, nullptr);
+  ASSERT_EQ(gcu_get_alloc_count(), 1);
+  ASSERT_TRUE(t->embedded);
+  ASSERT_EQ((void *)t->data, (void *)(t + 1));
+  ASSERT_EQ(t->capacity, 17);
+  for (size_t i = 0; i < 8; ++i) {
+    ASSERT_TRUE(gcu_hash64_set(t, i, gcu_type64_ui64(i)));
+  }
+  ASSERT_EQ(gcu_get_alloc_count(), 1);
+
+  // A clone has its data in a block of its own.
+  auto clone = gcu_hash64_clone(t);
+  ASSERT_FALSE(clone->embedded);
+  gcu_hash64_destroy(clone);
+
+  // Outgrowing the room moves the data to a block of its own.
+  for (size_t i = 8; i < 100; ++i) {
+    ASSERT_TRUE(gcu_hash64_set(t, i, gcu_type64_ui64(i)));
+  }
+  ASSERT_FALSE(t->embedded);
+  for (size_t i = 0; i < 100; ++i) {
+    auto value = gcu_hash64_get(t, i);
+    ASSERT_TRUE(value.exists);
+    ASSERT_EQ(value.value.ui64, i);
+  }
+  gcu_hash64_destroy(t);
+  ASSERT_EQ(gcu_get_alloc_count(), gcu_get_free_count());
+}
+
 TEST(Hash32, CreateEmpty) {
   auto t = gcu_hash32_create(0);
   ASSERT_EQ(gcu_hash32_count(t), 0);
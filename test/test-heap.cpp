@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cutil/heap.h>
+
+using namespace std;
+
+// Pop everything from a heap.
+static vector<GCU_Type64_Union> drain(GCU_Heap64 * heap) {
+  vector<GCU_Type64_Union> values;
+  while (gcu_heap64_count(heap)) {
+    auto first = gcu_heap64_pop(heap);
+    EXPECT_TRUE(first.exists);
+    values.push_back(first.value);
+  }
+  EXPECT_FALSE(gcu_heap64_pop(heap).exists);
+  return values;
+}
+
+TEST(Heap64, InvalidArguments) {
+  ASSERT_EQ(gcu_heap64_create(0, 1, GCU_HEAP64_MIN_UI64, false), nullptr);
+
+  auto heap = gcu_heap64_create(0, 0, GCU_HEAP64_MIN_UI64, false);
+  ASSERT_NE(heap, nullptr);
+  ASSERT_EQ(heap->arity, 4);
+  ASSERT_FALSE(gcu_heap64_peek(heap).exists);
+  ASSERT_FALSE(gcu_heap64_push_id(heap, gcu_type64_ui64(1), 0));
+  ASSERT_FALSE(gcu_heap64_update(heap, 0, gcu_type64_ui64(1)));
+  gcu_heap64_destroy(heap);
+
+  heap = gcu_heap64_create(0, 0, GCU_HEAP64_MIN_UI64, true);
+  ASSERT_FALSE(gcu_heap64_push(heap, gcu_type64_ui64(1)));
+  GCU_Type64_Union value = gcu_type64_ui64(1);
+  ASSERT_FALSE(gcu_heap64_heapify(heap, &value, 1));
+  gcu_heap64_destroy(heap);
+}
+
+TEST(Heap64, OrdersAndArities) {
+  mt19937_64 rng(1);
+  for (size_t arity : {2, 3, 4, 8, 11}) {
+    vector<uint64_t> bits(1000);
+    for (auto & b : bits) {
+      // Few distinct values, so that there are many ties.
+      b = rng() % 200;
+    }
+
+    // Each order, with the comparison that std::sort needs to match it.
+    vector<pair<GCU_Heap64_Order, function<bool(GCU_Type64_Union, GCU_Type64_Union)>>> orders{
+      {GCU_HEAP64_MIN_UI64, [](auto a, auto b) { return a.ui64 < b.ui64; }},
+      {GCU_HEAP64_MAX_UI64, [](auto a, auto b) { return a.ui64 > b.ui64; }},
+      {GCU_HEAP64_MIN_I64, [](auto a, auto b) { return a.i64 < b.i64; }},
+      {GCU_HEAP64_MAX_I64, [](auto a, auto b) { return a.i64 > b.i64; }},
+      {GCU_HEAP64_MIN_F64, [](auto a, auto b) { return a.f64 < b.f64; }},
+      {GCU_HEAP64_MAX_F64, [](auto a, auto b) { return a.f64 > b.f64; }},
+    };
+    for (auto & [order, less] : orders) {
+      vector<GCU_Type64_Union> values;
+      for (auto b : bits) {
+        // Spread the values across negative and positive numbers.
+        if (order == GCU_HEAP64_MIN_F64 || order == GCU_HEAP64_MAX_F64) {
+          values.push_back(gcu_type64_f64((double)b - 100.5));
+        }
+        else if (order == GCU_HEAP64_MIN_I64 || order == GCU_HEAP64_MAX_I64) {
+          values.push_back(gcu_type64_i64((int64_t)b - 100));
+        }
+        else {
+          values.push_back(gcu_type64_ui64(b));
+        }
+      }
+      auto heap = gcu_heap64_create(0, arity, order, false);
+      for (auto value : values) {
+        ASSERT_TRUE(gcu_heap64_push(heap, value));
+      }
+      ASSERT_EQ(gcu_heap64_count(heap), values.size());
+      auto popped = drain(heap);
+      sort(values.begin(), values.end(), less);
+      ASSERT_EQ(popped.size(), values.size());
+      for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(popped[i].ui64, values[i].ui64) << "arity " << arity << ", order " << order << ", position " << i;
+      }
+      gcu_heap64_destroy(heap);
+    }
+  }
+}
+
+TEST(Heap64, Heapify) {
+  mt19937_64 rng(2);
+  vector<GCU_Type64_Union> values(5000);
+  for (auto & value : values) {
+    value = gcu_type64_ui64(rng() % 100000);
+  }
+
+  for (size_t arity : {2, 4, 5}) {
+    // A large batch into an empty heap is rebuilt bottom-up, and a small batch
+    // into a large heap is added one value at a time.
+    auto heap = gcu_heap64_create(0, arity, GCU_HEAP64_MIN_UI64, false);
+    ASSERT_TRUE(gcu_heap64_heapify(heap, values.data(), 4000));
+    ASSERT_TRUE(gcu_heap64_heapify(heap, values.data() + 4000, 900));
+    ASSERT_TRUE(gcu_heap64_heapify(heap, values.data() + 4900, 100));
+    ASSERT_TRUE(gcu_heap64_heapify(heap, nullptr, 0));
+    ASSERT_EQ(gcu_heap64_count(heap), values.size());
+
+    auto sorted = values;
+    sort(sorted.begin(), sorted.end(), [](auto a, auto b) { return a.ui64 < b.ui64; });
+    auto popped = drain(heap);
+    for (size_t i = 0; i < sorted.size(); ++i) {
+      ASSERT_EQ(popped[i].ui64, sorted[i].ui64);
+    }
+    gcu_heap64_destroy(heap);
+  }
+}
+
+// Order by the low 32 bits, largest first.
+static bool lowBitsFirst(GCU_Type64_Union a, GCU_Type64_Union b, void * data) {
+  ++*(size_t *)data;
+  return (uint32_t)a.ui64 > (uint32_t)b.ui64;
+}
+
+TEST(Heap64, CustomCompare) {
+  size_t calls = 0;
+  auto heap = gcu_heap64_create(0, 3, GCU_HEAP64_CUSTOM, false);
+  heap->compare = lowBitsFirst;
+  heap->compare_data = &calls;
+  for (uint64_t i = 0; i < 100; ++i) {
+    // The high bits run in the opposite direction from the low bits.
+    ASSERT_TRUE(gcu_heap64_push(heap, gcu_type64_ui64(((100 - i) << 32) | ((i * 37) % 100))));
+  }
+  auto popped = drain(heap);
+  for (size_t i = 0; i < popped.size(); ++i) {
+    ASSERT_EQ((uint32_t)popped[i].ui64, 99 - i);
+  }
+  ASSERT_GT(calls, 0);
+  gcu_heap64_destroy(heap);
+}
+
+TEST(Heap64, IndexedUpdates) {
+  mt19937_64 rng(3);
+  const uint64_t ids = 500;
+  auto heap = gcu_heap64_create(0, 4, GCU_HEAP64_MIN_I64, true);
+  vector<int64_t> expected(ids);
+  vector<bool> present(ids, false);
+
+  // Insert in a scattered order, so that the position map grows several
+  // times.
+  for (uint64_t i = 0; i < ids; ++i) {
+    uint64_t id = (i * 7919) % ids;
+    expected[id] = (int64_t)(rng() % 10000) - 5000;
+    present[id] = true;
+    ASSERT_TRUE(gcu_heap64_push_id(heap, gcu_type64_i64(expected[id]), id));
+  }
+  ASSERT_FALSE(gcu_heap64_contains_id(heap, ids));
+  ASSERT_FALSE(gcu_heap64_update(heap, ids + 1000, gcu_type64_i64(0)));
+
+  // Move values in both directions, both with update and with push_id.
+  for (size_t i = 0; i < 2000; ++i) {
+    uint64_t id = rng() % ids;
+    int64_t value = (int64_t)(rng() % 20000) - 10000;
+    ASSERT_TRUE(gcu_heap64_contains_id(heap, id));
+    expected[id] = value;
+    if (i % 2) {
+      ASSERT_TRUE(gcu_heap64_update(heap, id, gcu_type64_i64(value)));
+    }
+    else {
+      ASSERT_TRUE(gcu_heap64_push_id(heap, gcu_type64_i64(value), id));
+    }
+  }
+  ASSERT_EQ(gcu_heap64_count(heap), ids);
+
+  // Each id comes out with its latest value, in order.
+  int64_t previous = INT64_MIN;
+  for (size_t i = 0; i < ids; ++i) {
+    auto peeked = gcu_heap64_peek(heap);
+    auto first = gcu_heap64_pop(heap);
+    ASSERT_EQ(peeked.id, first.id);
+    ASSERT_TRUE(first.exists);
+    ASSERT_TRUE(present[first.id]);
+    ASSERT_EQ(first.value.i64, expected[first.id]);
+    ASSERT_GE(first.value.i64, previous);
+    ASSERT_FALSE(gcu_heap64_contains_id(heap, first.id));
+    present[first.id] = false;
+    previous = first.value.i64;
+  }
+
+  // An id may be reused once it has been popped.
+  ASSERT_TRUE(gcu_heap64_push_id(heap, gcu_type64_i64(5), 3));
+  ASSERT_TRUE(gcu_heap64_contains_id(heap, 3));
+  ASSERT_EQ(gcu_heap64_pop(heap).id, 3);
+  gcu_heap64_destroy(heap);
+}
+
+TEST(Heap64, TopK) {
+  mt19937_64 rng(4);
+  auto input = gcu_vector64_create(0);
+  auto result = gcu_vector64_create(0);
+  vector<int64_t> values;
+  for (size_t i = 0; i < 10000; ++i) {
+    values.push_back((int64_t)(rng() % 1000000) - 500000);
+    gcu_vector64_append(input, gcu_type64_i64(values.back()));
+  }
+
+  // The largest values, largest first.
+  ASSERT_TRUE(gcu_heap64_top_k(input, 100, GCU_HEAP64_MAX_I64, result));
+  auto sorted = values;
+  sort(sorted.begin(), sorted.end(), greater<int64_t>());
+  ASSERT_EQ(result->count, 100);
+  for (size_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(result->data[i].i64, sorted[i]);
+  }
+
+  // The smallest values, smallest first.
+  ASSERT_TRUE(gcu_heap64_top_k(input, 10, GCU_HEAP64_MIN_I64, result));
+  ASSERT_EQ(result->count, 10);
+  for (size_t i = 0; i < 10; ++i) {
+    ASSERT_EQ(result->data[i].i64, sorted[sorted.size() - 1 - i]);
+  }
+
+  // Asking for more values than there are returns all of them.
+  ASSERT_TRUE(gcu_heap64_top_k(input, 20000, GCU_HEAP64_MAX_I64, result));
+  ASSERT_EQ(result->count, values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(result->data[i].i64, sorted[i]);
+  }
+
+  ASSERT_TRUE(gcu_heap64_top_k(input, 0, GCU_HEAP64_MAX_I64, result));
+  ASSERT_EQ(result->count, 0);
+  ASSERT_FALSE(gcu_heap64_top_k(input, 10, GCU_HEAP64_CUSTOM, result));
+  gcu_vector64_destroy(input);
+  gcu_vector64_destroy(result);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,134 @@
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cutil/jagged.h>
+
+using namespace std;
+
+// Check that every row of `jagged` holds the values of the matching row of
+// `expected`.
+static void checkRows(GCU_Jagged64 * jagged, const vector<vector<uint64_t>> & expected) {
+  ASSERT_EQ(gcu_jagged64_row_count(jagged), expected.size());
+  size_t total = 0;
+  for (size_t row = 0; row < expected.size(); ++row) {
+    auto view = gcu_jagged64_row(jagged, row);
+    ASSERT_EQ(view.count, expected[row].size()) << "row " << row;
+    for (size_t i = 0; i < view.count; ++i) {
+      ASSERT_EQ(view.data[i].ui64, expected[row][i]) << "row " << row;
+    }
+    total += view.count;
+  }
+  ASSERT_EQ(gcu_jagged64_count(jagged), total);
+  ASSERT_EQ(gcu_jagged64_row(jagged, expected.size()).count, 0);
+}
+
+TEST(Jagged64, TwoPhase) {
+  // Rows of sizes 0, 1, 2, ... 49, counted and then filled.
+  auto jagged = gcu_jagged64_create(50, 0);
+  ASSERT_NE(jagged, nullptr);
+  vector<vector<uint64_t>> expected(50);
+  for (size_t row = 0; row < 50; ++row) {
+    ASSERT_TRUE(gcu_jagged64_add_row_size(jagged, row, row));
+    for (size_t i = 0; i < row; ++i) {
+      expected[row].push_back(row * 1000 + i);
+    }
+  }
+  ASSERT_FALSE(gcu_jagged64_add_row_size(jagged, 50, 1));
+  ASSERT_FALSE(gcu_jagged64_fill(jagged, 1, gcu_type64_ui64(0)));
+  ASSERT_EQ(gcu_jagged64_row(jagged, 1).count, 0);
+
+  ASSERT_TRUE(gcu_jagged64_allocate(jagged));
+  ASSERT_FALSE(gcu_jagged64_allocate(jagged));
+  ASSERT_FALSE(gcu_jagged64_add_row_size(jagged, 1, 1));
+
+  // Unfilled slots are zero.
+  ASSERT_EQ(gcu_jagged64_row(jagged, 3).count, 3);
+  ASSERT_EQ(gcu_jagged64_row(jagged, 3).data[2].ui64, 0);
+
+  // Fill the rows in reverse, interleaved.
+  for (size_t i = 0; i < 50; ++i) {
+    for (size_t row = 50; row-- > 0;) {
+      if (i < row) {
+        ASSERT_TRUE(gcu_jagged64_fill(jagged, row, gcu_type64_ui64(row * 1000 + i)));
+      }
+    }
+  }
+  ASSERT_FALSE(gcu_jagged64_fill(jagged, 0, gcu_type64_ui64(0)));
+  ASSERT_FALSE(gcu_jagged64_fill(jagged, 49, gcu_type64_ui64(0)));
+  checkRows(jagged, expected);
+
+  // Compacting ends the filling.
+  ASSERT_TRUE(gcu_jagged64_compact(jagged));
+  ASSERT_FALSE(gcu_jagged64_fill(jagged, 49, gcu_type64_ui64(0)));
+  checkRows(jagged, expected);
+
+  // Values can be written through the view.
+  gcu_jagged64_row(jagged, 10).data[0].ui64 = 7;
+  expected[10][0] = 7;
+  checkRows(jagged, expected);
+  gcu_jagged64_destroy(jagged);
+}
+
+TEST(Jagged64, AppendAndCompact) {
+  mt19937_64 rng(1);
+  auto jagged = gcu_jagged64_create(0, 0);
+  vector<vector<uint64_t>> expected;
+  checkRows(jagged, expected);
+
+  // Several rounds of appending to random rows, some of them new.
+  for (size_t round = 0; round < 5; ++round) {
+    for (size_t i = 0; i < 1000; ++i) {
+      size_t row = rng() % (100 + round * 50);
+      uint64_t value = rng();
+      ASSERT_TRUE(gcu_jagged64_append(jagged, row, gcu_type64_ui64(value)));
+      if (row >= expected.size()) {
+        expected.resize(row + 1);
+      }
+      expected[row].push_back(value);
+    }
+    ASSERT_EQ(gcu_jagged64_row_count(jagged), expected.size());
+    ASSERT_TRUE(gcu_jagged64_compact(jagged));
+    checkRows(jagged, expected);
+  }
+
+  // Compacting with nothing appended changes nothing.
+  ASSERT_TRUE(gcu_jagged64_compact(jagged));
+  checkRows(jagged, expected);
+  gcu_jagged64_destroy(jagged);
+}
+
+TEST(Jagged64, MixedBuild) {
+  // Appended values follow the values of a two-phase build, and an appended
+  // row past the end adds the rows before it.
+  auto jagged = gcu_jagged64_create(3, 0);
+  ASSERT_TRUE(gcu_jagged64_add_row_size(jagged, 1, 2));
+  ASSERT_TRUE(gcu_jagged64_allocate(jagged));
+  ASSERT_TRUE(gcu_jagged64_fill(jagged, 1, gcu_type64_ui64(10)));
+  ASSERT_TRUE(gcu_jagged64_fill(jagged, 1, gcu_type64_ui64(11)));
+  ASSERT_TRUE(gcu_jagged64_append(jagged, 1, gcu_type64_ui64(12)));
+  ASSERT_TRUE(gcu_jagged64_append(jagged, 5, gcu_type64_ui64(50)));
+  ASSERT_TRUE(gcu_jagged64_append(jagged, 0, gcu_type64_ui64(0)));
+
+  // Until compacted, the appended values are not in the rows.
+  ASSERT_EQ(gcu_jagged64_row_count(jagged), 6);
+  ASSERT_EQ(gcu_jagged64_count(jagged), 2);
+  ASSERT_EQ(gcu_jagged64_row(jagged, 5).count, 0);
+
+  ASSERT_TRUE(gcu_jagged64_compact(jagged));
+  checkRows(jagged, {{0}, {10, 11, 12}, {}, {}, {}, {50}});
+  gcu_jagged64_destroy(jagged);
+
+  // Compacting an array whose rows were sized but never laid out lays them
+  // out, filled with zeros.
+  jagged = gcu_jagged64_create(2, 0);
+  ASSERT_TRUE(gcu_jagged64_add_row_size(jagged, 0, 2));
+  ASSERT_TRUE(gcu_jagged64_append(jagged, 0, gcu_type64_ui64(3)));
+  ASSERT_TRUE(gcu_jagged64_compact(jagged));
+  checkRows(jagged, {{0, 0, 3}, {}});
+  gcu_jagged64_destroy(jagged);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
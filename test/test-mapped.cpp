@@ -0,0 +1,158 @@
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <cutil/mapped.h>
+#include <cutil/reduce.h>
+#include <cutil/sort.h>
+#include <cutil/view.h>
+
+using namespace std;
+
+// A path in the temporary directory, which is removed when the test ends.
+class TempPath {
+  public:
+  TempPath(const char * name) : path{(filesystem::temp_directory_path() / (string{"test-mapped-"} + to_string(getpid()) + "-" + name)).string()} {
+    filesystem::remove(path);
+  }
+  ~TempPath() {
+    filesystem::remove(path);
+  }
+  const char * c_str() const {
+    return path.c_str();
+  }
+  string path;
+};
+
+TEST(Mapped64, Persist) {
+  TempPath path{"persist"};
+  auto mapped = gcu_mapped64_create(path.c_str(), 0);
+  ASSERT_NE(mapped, nullptr);
+  ASSERT_TRUE(gcu_mapped64_is_mapped(mapped));
+  ASSERT_EQ(gcu_vector64_count(mapped), 0);
+  for (uint64_t i = 0; i < 100000; ++i) {
+    ASSERT_TRUE(gcu_vector64_append(mapped, gcu_type64_ui64(i * 3)));
+  }
+  ASSERT_EQ(gcu_vector64_count(mapped), 100000);
+  ASSERT_GE(mapped->capacity, 100000);
+  ASSERT_TRUE(gcu_mapped64_sync(mapped));
+  ASSERT_TRUE(gcu_mapped64_close(mapped));
+
+  // The file is cut back to the values, and reopens as it was.
+  ASSERT_EQ(filesystem::file_size(path.path), 64 + 100000 * sizeof(GCU_Type64_Union));
+  mapped = gcu_mapped64_create(path.c_str(), 200000);
+  ASSERT_NE(mapped, nullptr);
+  ASSERT_EQ(gcu_vector64_count(mapped), 100000);
+  ASSERT_GE(mapped->capacity, 200000);
+  for (uint64_t i = 0; i < 100000; ++i) {
+    ASSERT_EQ(mapped->data[i].ui64, i * 3);
+  }
+  ASSERT_TRUE(gcu_vector64_append(mapped, gcu_type64_ui64(7)));
+  gcu_vector64_destroy(mapped);
+
+  mapped = gcu_mapped64_create(path.c_str(), 0);
+  ASSERT_EQ(gcu_vector64_count(mapped), 100001);
+  ASSERT_EQ(mapped->data[100000].ui64, 7);
+  gcu_vector64_destroy(mapped);
+}
+
+TEST(Mapped64, IsAVector) {
+  TempPath path{"vector"};
+  auto mapped = gcu_mapped64_create(path.c_str(), 0);
+  ASSERT_NE(mapped, nullptr);
+  for (uint64_t i = 0; i < 10000; ++i) {
+    ASSERT_TRUE(gcu_vector64_append(mapped, gcu_type64_ui64((i * 7919) % 10000)));
+  }
+
+  // The vector functions work on the values in the file.
+  ASSERT_TRUE(gcu_vector64_sort_ui64(mapped));
+  auto view = gcu_vector64_view(mapped, 100, 10);
+  ASSERT_EQ(view.data[0].ui64, 100);
+  ASSERT_EQ(gcu_sum64_ui64(GCU_VIEW_ARGS(gcu_vector64_view(mapped, 0, mapped->count))), 9999 * 10000 / 2);
+  mapped->data[0] = gcu_type64_ui64(42);
+  --mapped->count;
+  ASSERT_TRUE(gcu_mapped64_close(mapped));
+
+  mapped = gcu_mapped64_create(path.c_str(), 0);
+  ASSERT_EQ(gcu_vector64_count(mapped), 9999);
+  ASSERT_EQ(mapped->data[0].ui64, 42);
+  ASSERT_EQ(mapped->data[9998].ui64, 9998);
+
+  // Moving the values out of the file leaves an ordinary vector.
+  GCU_Growth growth = {};
+  ASSERT_TRUE(gcu_vector64_set_growth(mapped, growth));
+  ASSERT_FALSE(gcu_mapped64_is_mapped(mapped));
+  ASSERT_FALSE(gcu_mapped64_sync(mapped));
+  ASSERT_EQ(mapped->data[9998].ui64, 9998);
+  ASSERT_TRUE(gcu_vector64_append(mapped, gcu_type64_ui64(1)));
+  gcu_vector64_destroy(mapped);
+  ASSERT_EQ(filesystem::file_size(path.path), 64 + 9999 * sizeof(GCU_Type64_Union));
+
+  // Only mapped vectors can be published.
+  auto plain = gcu_vector64_create(0);
+  ASSERT_FALSE(gcu_mapped64_is_mapped(plain));
+  ASSERT_FALSE(gcu_mapped64_publish(plain));
+  ASSERT_FALSE(gcu_mapped64_refresh(plain));
+  gcu_vector64_destroy(plain);
+}
+
+TEST(Mapped64, ReadOnly) {
+  TempPath path{"read-only"};
+  ASSERT_EQ(gcu_mapped64_open(path.c_str()), nullptr);
+
+  auto writer = gcu_mapped64_create(path.c_str(), 0);
+  ASSERT_NE(writer, nullptr);
+  for (uint64_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(gcu_vector64_append(writer, gcu_type64_ui64(i)));
+  }
+  ASSERT_TRUE(gcu_mapped64_publish(writer));
+
+  // A reader sees what has been published so far, and cannot grow.
+  auto reader = gcu_mapped64_open(path.c_str());
+  ASSERT_NE(reader, nullptr);
+  ASSERT_EQ(gcu_vector64_count(reader), 100);
+  ASSERT_FALSE(gcu_vector64_append(reader, gcu_type64_ui64(0)));
+  ASSERT_FALSE(gcu_vector64_reserve(reader, 1000));
+  ASSERT_FALSE(gcu_mapped64_publish(reader));
+
+  // Its changes stay in this process.
+  reader->data[0] = gcu_type64_ui64(1000);
+  ASSERT_EQ(writer->data[0].ui64, 0);
+
+  // After the file grows, a refresh picks up the newly published values.
+  for (uint64_t i = 100; i < 50000; ++i) {
+    ASSERT_TRUE(gcu_vector64_append(writer, gcu_type64_ui64(i)));
+  }
+  ASSERT_TRUE(gcu_mapped64_refresh(reader));
+  ASSERT_EQ(gcu_vector64_count(reader), 100);
+  ASSERT_TRUE(gcu_mapped64_publish(writer));
+  ASSERT_TRUE(gcu_mapped64_refresh(reader));
+  ASSERT_EQ(gcu_vector64_count(reader), 50000);
+  for (uint64_t i = 0; i < 50000; ++i) {
+    ASSERT_EQ(reader->data[i].ui64, i);
+  }
+
+  // The writer's file shrinks to its values when it is destroyed, which the
+  // reader can still read.
+  gcu_vector64_destroy(writer);
+  ASSERT_TRUE(gcu_mapped64_refresh(reader));
+  ASSERT_EQ(reader->data[49999].ui64, 49999);
+  ASSERT_TRUE(gcu_mapped64_close(reader));
+}
+
+TEST(Mapped64, NotAMappedVector) {
+  TempPath path{"invalid"};
+  FILE * file = fopen(path.c_str(), "w");
+  ASSERT_NE(file, nullptr);
+  fputs("This is not a mapped vector, but it is long enough to have a header.", file);
+  fclose(file);
+  ASSERT_EQ(gcu_mapped64_create(path.c_str(), 0), nullptr);
+  ASSERT_EQ(gcu_mapped64_open(path.c_str()), nullptr);
+  ASSERT_EQ(gcu_mapped64_create("/nonexistent-directory/mapped", 0), nullptr);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,4 +1,9 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
 #include <sstream>
+#include <string>
+#include <vector>
 #include <gtest/gtest.h>
 
 // By defining GHOTIIO_CUTIL_ENABLE_MEMORY_DEBUG, we can intercept memory
@@ -6,6 +11,7 @@
 // for debugging memory leaks and other memory-related issues.
 #define GHOTIIO_CUTIL_ENABLE_MEMORY_DEBUG
 #include <cutil/memory.h>
+#include <cutil/thread.h>
 
 using namespace std;
 
@@ -289,6 +295,467 @@ TEST(Memory, StopStartCapture) {
   ASSERT_EQ(gcu_get_free_count(), previous_free_count + 3);
 }
 
+TEST(Memory, Counters) {
+  gcu_mem_stop();
+  gcu_memory_reset_counts();
+  ASSERT_EQ(gcu_get_live_bytes(), 0);
+  ASSERT_EQ(gcu_get_peak_bytes(), 0);
+
+  // Sizes are those reserved by the allocator, so at least those requested.
+  auto buffer = gcu_malloc(1000);
+  ASSERT_EQ(gcu_get_alloc_count(), 1);
+  ASSERT_GE(gcu_get_live_bytes(), 1000);
+  buffer = gcu_realloc(buffer, 50000);
+  ASSERT_EQ(gcu_get_alloc_count(), 1);
+  ASSERT_EQ(gcu_get_realloc_count(), 1);
+  ASSERT_GE(gcu_get_live_bytes(), 50000);
+  size_t live = gcu_get_live_bytes();
+  auto small = gcu_calloc(10, 10);
+  ASSERT_EQ(gcu_get_alloc_count(), 2);
+  ASSERT_GE(gcu_get_live_bytes(), live + 100);
+  size_t peak = gcu_get_live_bytes();
+  ASSERT_EQ(gcu_get_peak_bytes(), peak);
+
+  // Freeing lowers the live bytes, but not the peak.
+  gcu_free(buffer);
+  gcu_free(small);
+  ASSERT_EQ(gcu_get_free_count(), 2);
+  ASSERT_EQ(gcu_get_live_bytes(), 0);
+  ASSERT_EQ(gcu_get_peak_bytes(), peak);
+  gcu_memory_reset_counts();
+  ASSERT_EQ(gcu_get_peak_bytes(), 0);
+  gcu_mem_start();
+}
+
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION allocate(GCU_THREAD_FUNC_ARG_T arg) {
+  auto blocks = (void **)arg;
+  for (size_t i = 0; i < 100; ++i) {
+    blocks[i] = gcu_malloc(64);
+  }
+  for (size_t i = 0; i < 50; ++i) {
+    gcu_free(blocks[i]);
+  }
+  return 0;
+}
+
+TEST(Memory, CountersThreads) {
+  gcu_mem_stop();
+  gcu_memory_reset_counts();
+
+  // The counts of threads which have exited are kept.
+  const size_t THREADS = 4;
+  void * blocks[THREADS][100];
+  GCU_Thread threads[THREADS];
+  for (size_t i = 0; i < THREADS; ++i) {
+    ASSERT_EQ(0, gcu_thread_create(&threads[i], allocate, blocks[i]));
+  }
+  for (size_t i = 0; i < THREADS; ++i) {
+    gcu_thread_join(threads[i]);
+  }
+  ASSERT_GE(gcu_get_alloc_count(), THREADS * 100);
+  ASSERT_GE(gcu_get_free_count(), THREADS * 50);
+  ASSERT_GE(gcu_get_live_bytes(), THREADS * 50 * 64);
+  ASSERT_GE(gcu_get_peak_bytes(), gcu_get_live_bytes());
+
+  // Memory may be freed by another thread.
+  size_t frees = gcu_get_free_count();
+  size_t live = gcu_get_live_bytes();
+  for (size_t i = 0; i < THREADS; ++i) {
+    for (size_t j = 50; j < 100; ++j) {
+      gcu_free(blocks[i][j]);
+    }
+  }
+  ASSERT_EQ(gcu_get_free_count(), frees + THREADS * 50);
+  ASSERT_LE(gcu_get_live_bytes(), live - THREADS * 50 * 64);
+  gcu_mem_start();
+}
+
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION allocateTraced(GCU_THREAD_FUNC_ARG_T arg) {
+  gcu_free(gcu_malloc((size_t)arg));
+  return 0;
+}
+
+// Each counter is written by a different thread.
+struct Padded {
+  GCU_CACHELINE size_t first;
+  GCU_CACHELINE size_t second;
+};
+
+TEST(Memory, Aligned) {
+  ASSERT_GE(alignof(Padded), GCU_CACHELINE_SIZE);
+  ASSERT_GE(sizeof(Padded), 2 * GCU_CACHELINE_SIZE);
+  ASSERT_EQ(offsetof(Padded, second) % GCU_CACHELINE_SIZE, 0);
+
+  gcu_memory_reset_counts();
+  for (size_t alignment : {1, 16, 32, 64, 4096}) {
+    auto buffer = (char *)gcu_aligned_alloc(alignment, 100);
+    ASSERT_NE(buffer, nullptr);
+    ASSERT_EQ((uintptr_t)buffer % alignment, 0);
+    ASSERT_GE(gcu_get_live_bytes(), 100);
+    for (int i = 0; i < 100; ++i) {
+      buffer[i] = (char)i;
+    }
+
+    // Growing and shrinking keeps both the contents and the alignment.
+    buffer = (char *)gcu_aligned_realloc(buffer, alignment, 10000);
+    ASSERT_EQ((uintptr_t)buffer % alignment, 0);
+    ASSERT_EQ(buffer[99], 99);
+    buffer = (char *)gcu_aligned_realloc(buffer, alignment, 50);
+    ASSERT_EQ((uintptr_t)buffer % alignment, 0);
+    ASSERT_EQ(buffer[49], 49);
+    gcu_aligned_free(buffer);
+  }
+  ASSERT_EQ(gcu_get_alloc_count(), 5);
+  ASSERT_EQ(gcu_get_realloc_count(), 10);
+  ASSERT_EQ(gcu_get_free_count(), 5);
+  ASSERT_EQ(gcu_get_live_bytes(), 0);
+
+  // A padded structure can be allocated whole.
+  auto padded = (Padded *)gcu_aligned_alloc(alignof(Padded), 3 * sizeof(Padded));
+  ASSERT_EQ((uintptr_t)&padded[1].second % GCU_CACHELINE_SIZE, 0);
+  gcu_aligned_free(padded);
+  gcu_aligned_free(nullptr);
+}
+
+// An allocator which passes calls to the system's, counting them.
+struct Counted {
+  size_t allocations = 0;
+  size_t reallocations = 0;
+  size_t frees = 0;
+};
+
+static void * countedAllocate(void * context, size_t size) {
+  ++((Counted *)context)->allocations;
+  return gcu_system_allocator.allocate(nullptr, size);
+}
+
+static void * countedAllocateZeroed(void * context, size_t nitems, size_t size) {
+  ++((Counted *)context)->allocations;
+  return gcu_system_allocator.allocate_zeroed(nullptr, nitems, size);
+}
+
+static void * countedReallocate(void * context, void * pointer, size_t size) {
+  ++((Counted *)context)->reallocations;
+  return gcu_system_allocator.reallocate(nullptr, pointer, size);
+}
+
+static void countedFree(void * context, void * pointer) {
+  ++((Counted *)context)->frees;
+  gcu_system_allocator.free(nullptr, pointer);
+}
+
+TEST(Memory, Allocator) {
+  gcu_mem_stop();
+  gcu_memory_reset_counts();
+  Counted counted;
+  GCU_Allocator allocator = {countedAllocate, countedAllocateZeroed, countedReallocate, countedFree, nullptr, &counted};
+  ASSERT_EQ(gcu_set_allocator(&allocator), nullptr);
+
+  // Every call goes to the allocator, and is still counted.
+  auto buffer = (char *)gcu_malloc(10);
+  auto zeroed = (char *)gcu_calloc(10, 10);
+  ASSERT_EQ(zeroed[99], 0);
+  buffer = (char *)gcu_realloc(buffer, 1000);
+  gcu_free(buffer);
+  gcu_free(zeroed);
+  ASSERT_EQ(counted.allocations, 2);
+  ASSERT_EQ(counted.reallocations, 1);
+  ASSERT_EQ(counted.frees, 2);
+  ASSERT_EQ(gcu_get_alloc_count(), 2);
+  ASSERT_EQ(gcu_get_realloc_count(), 1);
+  ASSERT_EQ(gcu_get_free_count(), 2);
+
+  // Without usable_size(), the blocks are counted as empty.
+  ASSERT_EQ(gcu_get_peak_bytes(), 0);
+  ASSERT_EQ(gcu_set_allocator(nullptr), &allocator);
+
+  // The system's allocator counts bytes as gcu_malloc() does.
+  ASSERT_EQ(gcu_set_allocator(&gcu_system_allocator), nullptr);
+  buffer = (char *)gcu_malloc(100);
+  ASSERT_GE(gcu_get_live_bytes(), 100);
+  gcu_free(buffer);
+  ASSERT_EQ(gcu_get_live_bytes(), 0);
+  gcu_set_allocator(nullptr);
+  gcu_mem_start();
+}
+
+TEST(Memory, Trace) {
+  string path = testing::TempDir() + "cutil-memory-trace.bin";
+  ASSERT_TRUE(gcu_mem_trace_start(path.c_str()));
+  ASSERT_FALSE(gcu_mem_trace_start(path.c_str()));
+
+  // Nothing is logged to stderr while tracing.
+  testing::internal::CaptureStderr();
+  auto buffer = gcu_malloc(100);
+  size_t mallocLine = __LINE__ - 1;
+  auto items = gcu_calloc(3, 40);
+  size_t callocLine = __LINE__ - 1;
+  auto grown = gcu_realloc(buffer, 5000);
+  size_t reallocLine = __LINE__ - 1;
+  gcu_free(grown);
+  GCU_Thread thread;
+  ASSERT_EQ(0, gcu_thread_create(&thread, allocateTraced, (void *)777));
+  gcu_thread_join(thread);
+  auto leak = gcu_malloc(64);
+  size_t leakLine = __LINE__ - 1;
+  ASSERT_EQ(testing::internal::GetCapturedStderr(), "");
+  gcu_mem_trace_stop();
+  gcu_mem_stop();
+  gcu_free(items);
+  gcu_free(leak);
+  gcu_mem_start();
+
+  // The decoded trace is the text which would have been logged.
+  FILE * trace = fopen(path.c_str(), "rb");
+  ASSERT_NE(trace, nullptr);
+  char * text = nullptr;
+  size_t textSize = 0;
+  FILE * out = open_memstream(&text, &textSize);
+  ASSERT_TRUE(gcu_mem_trace_decode(trace, out));
+  fclose(out);
+  stringstream lines{string(text, textSize)};
+  free(text);
+  vector<string> decoded;
+  for (string line; getline(lines, line);) {
+    decoded.push_back(line);
+  }
+  ASSERT_EQ(decoded.size(), 7);
+  auto pMalloc = parseMalloc(decoded[0]);
+  ASSERT_EQ(pMalloc.type, "malloc");
+  ASSERT_EQ(pMalloc.count, 1);
+  ASSERT_EQ(pMalloc.pointer, buffer);
+  ASSERT_EQ(pMalloc.size, 100);
+  ASSERT_EQ(pMalloc.file, __FILE__);
+  ASSERT_EQ(pMalloc.line, mallocLine);
+  auto pCalloc = parseCalloc(decoded[1]);
+  ASSERT_EQ(pCalloc.type, "calloc");
+  ASSERT_EQ(pCalloc.pointer, items);
+  ASSERT_EQ(pCalloc.nitems, 3);
+  ASSERT_EQ(pCalloc.size, 40);
+  ASSERT_EQ(pCalloc.line, callocLine);
+  auto pRealloc = parseRealloc(decoded[2]);
+  ASSERT_EQ(pRealloc.type, "realloc");
+  ASSERT_EQ(pRealloc.pointerOld, buffer);
+  ASSERT_EQ(pRealloc.pointerNew, grown);
+  ASSERT_EQ(pRealloc.size, 5000);
+  ASSERT_EQ(pRealloc.line, reallocLine);
+  auto pFree = parseFree(decoded[3]);
+  ASSERT_EQ(pFree.type, "free");
+  ASSERT_EQ(pFree.pointer, grown);
+  ASSERT_EQ(parseMalloc(decoded[4]).size, 777);
+  ASSERT_EQ(parseFree(decoded[5]).type, "free");
+  ASSERT_EQ(parseMalloc(decoded[6]).pointer, leak);
+
+  // The report finds the peak, and what was not freed while tracing.
+  rewind(trace);
+  out = open_memstream(&text, &textSize);
+  ASSERT_TRUE(gcu_mem_trace_report(trace, out));
+  fclose(out);
+  string report(text, textSize);
+  free(text);
+  fclose(trace);
+  ASSERT_NE(report.find("peak    | 5120 bytes in 2 blocks"), string::npos) << report;
+  ASSERT_NE(report.find("leak    | 120 bytes in 1 blocks | " __FILE__ "(" + to_string(callocLine) + ")"), string::npos) << report;
+  ASSERT_NE(report.find("leak    | 64 bytes in 1 blocks | " __FILE__ "(" + to_string(leakLine) + ")"), string::npos) << report;
+  ASSERT_NE(report.find("total   | 4 allocations | 2 frees | 184 bytes in 2 blocks not freed"), string::npos) << report;
+
+  // Anything else is not a trace.
+  FILE * notTrace = fopen(__FILE__, "rb");
+  ASSERT_FALSE(gcu_mem_trace_decode(notTrace, stdout));
+  fclose(notTrace);
+  remove(path.c_str());
+}
+
+TEST(Memory, TraceReportManyBlocks) {
+  string path = testing::TempDir() + "cutil-memory-trace-many.bin";
+  constexpr size_t BLOCKS = 100000;
+  constexpr size_t LEAKS = 1000;
+  vector<void *> blocks(BLOCKS);
+  vector<void *> leaks(LEAKS);
+  ASSERT_TRUE(gcu_mem_trace_start(path.c_str()));
+  for (size_t round = 0; round < 2; ++round) {
+    for (size_t i = 0; i < BLOCKS; ++i) {
+      blocks[i] = gcu_malloc(16);
+    }
+
+    // Free the blocks in an order unrelated to their addresses.
+    for (size_t i = 1; i < BLOCKS; i += 2) {
+      gcu_free(blocks[i]);
+    }
+    for (size_t i = BLOCKS; i >= 2; i -= 2) {
+      gcu_free(blocks[i - 2]);
+    }
+  }
+  for (auto & leak : leaks) { leak = gcu_malloc(32); }
+  size_t leakLine = __LINE__ - 1;
+  gcu_mem_trace_stop();
+  ASSERT_EQ(gcu_mem_trace_dropped(), 0);
+  gcu_mem_stop();
+  for (auto leak : leaks) {
+    gcu_free(leak);
+  }
+  gcu_mem_start();
+
+  // Every block is matched with its free, while all of them are live at once.
+  FILE * trace = fopen(path.c_str(), "rb");
+  ASSERT_NE(trace, nullptr);
+  FILE * out = tmpfile();
+  ASSERT_NE(out, nullptr);
+  ASSERT_TRUE(gcu_mem_trace_report(trace, out));
+  fclose(trace);
+  rewind(out);
+  string report;
+  for (int c; (c = fgetc(out)) != EOF;) {
+    report += (char)c;
+  }
+  fclose(out);
+  ASSERT_NE(report.find("peak    | " + to_string(BLOCKS * 16) + " bytes in " + to_string(BLOCKS) + " blocks"), string::npos) << report;
+  ASSERT_NE(report.find("leak    | " + to_string(LEAKS * 32) + " bytes in " + to_string(LEAKS) + " blocks | " __FILE__ "(" + to_string(leakLine) + ")"), string::npos) << report;
+  ASSERT_NE(report.find("total   | " + to_string(2 * BLOCKS + LEAKS) + " allocations | " + to_string(2 * BLOCKS) + " frees | " + to_string(LEAKS * 32) + " bytes in " + to_string(LEAKS) + " blocks not freed"), string::npos) << report;
+  ASSERT_EQ(report.find("(unknown)"), string::npos) << report;
+  remove(path.c_str());
+}
+
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION allocateProfiled(GCU_THREAD_FUNC_ARG_T arg) {
+  auto blocks = (void **)arg;
+  for (size_t i = 0; i < 1000; ++i) {
+    blocks[i] = gcu_malloc(24);
+  }
+  return 0;
+}
+
+TEST(Memory, Profile) {
+  gcu_mem_stop();
+  ASSERT_TRUE(gcu_mem_profile_start(false));
+
+  void * loop[10];
+  for (auto & block : loop) {
+    block = gcu_malloc(100);
+  }
+  size_t loopLine = __LINE__ - 2;
+  for (size_t i = 0; i < 4; ++i) {
+    gcu_free(loop[i]);
+  }
+  auto items = gcu_calloc(2, 1000);
+  size_t callocLine = __LINE__ - 1;
+  auto grown = gcu_malloc(20);
+  size_t mallocLine = __LINE__ - 1;
+  grown = gcu_realloc(grown, 5000);
+  size_t reallocLine = __LINE__ - 1;
+
+  // Memory allocated by one thread may be freed by another.
+  const size_t THREADS = 4;
+  static void * threadBlocks[THREADS][1000];
+  GCU_Thread threads[THREADS];
+  for (size_t i = 0; i < THREADS; ++i) {
+    ASSERT_EQ(0, gcu_thread_create(&threads[i], allocateProfiled, threadBlocks[i]));
+  }
+  for (size_t i = 0; i < THREADS; ++i) {
+    gcu_thread_join(threads[i]);
+  }
+  for (auto & blocks : threadBlocks) {
+    for (auto block : blocks) {
+      gcu_free(block);
+    }
+  }
+
+  // Calls after the profile stops are not counted.
+  gcu_mem_profile_stop();
+  gcu_free(gcu_malloc(1));
+
+  char * text = nullptr;
+  size_t textSize = 0;
+  FILE * out = open_memstream(&text, &textSize);
+  gcu_mem_report(out);
+  fclose(out);
+  stringstream lines{string(text, textSize)};
+  free(text);
+  vector<string> report;
+  for (string line; getline(lines, line);) {
+    report.push_back(line);
+  }
+  auto site = [](size_t line) {
+    return string(__FILE__) + "(" + to_string(line) + ") | ";
+  };
+  ASSERT_EQ(report.size(), 5);
+  ASSERT_EQ(report[0], site(reallocLine) + "1 allocations | 0 frees | 5000 live bytes | 5000 peak bytes | sizes <=8192:1");
+  ASSERT_EQ(report[1], site(callocLine) + "1 allocations | 0 frees | 2000 live bytes | 2000 peak bytes | sizes <=2048:1");
+  ASSERT_EQ(report[2], site(loopLine) + "10 allocations | 4 frees | 600 live bytes | 1000 peak bytes | sizes <=128:10");
+  ASSERT_EQ(report[3].rfind(string(__FILE__) + "(", 0), 0);
+  ASSERT_NE(report[3].find("4000 allocations | 4000 frees | 0 live bytes |"), string::npos);
+  ASSERT_NE(report[3].find("sizes <=32:4000"), string::npos);
+  ASSERT_EQ(report[4], site(mallocLine) + "1 allocations | 1 frees | 0 live bytes | 20 peak bytes | sizes <=32:1");
+
+  for (size_t i = 4; i < 10; ++i) {
+    gcu_free(loop[i]);
+  }
+  gcu_free(items);
+  gcu_free(grown);
+  gcu_mem_start();
+}
+
+static atomic<bool> churning;
+
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION churnProfiled(GCU_THREAD_FUNC_ARG_T) {
+  void * blocks[64] = {};
+  while (churning.load()) {
+    for (auto & block : blocks) {
+      gcu_free(block);
+      block = gcu_malloc(48);
+    }
+  }
+  for (auto block : blocks) {
+    gcu_free(block);
+  }
+  return 0;
+}
+
+TEST(Memory, ProfileRestartWhileFreeing) {
+  // Restarting the profile discards the sites of blocks which other threads
+  // are freeing at the same time.
+  gcu_mem_stop();
+  ASSERT_TRUE(gcu_mem_profile_start(false));
+  churning = true;
+  const size_t THREADS = 4;
+  GCU_Thread threads[THREADS];
+  for (auto & thread : threads) {
+    ASSERT_EQ(0, gcu_thread_create(&thread, churnProfiled, nullptr));
+  }
+  for (size_t i = 0; i < 200; ++i) {
+    ASSERT_TRUE(gcu_mem_profile_start(false));
+  }
+  churning = false;
+  for (auto thread : threads) {
+    gcu_thread_join(thread);
+  }
+  gcu_mem_profile_stop();
+
+  // Every block has been freed, so no site may hold live bytes.
+  FILE * out = tmpfile();
+  ASSERT_NE(out, nullptr);
+  gcu_mem_report(out);
+  rewind(out);
+  string report;
+  for (int c; (c = fgetc(out)) != EOF;) {
+    report += (char)c;
+  }
+  fclose(out);
+  stringstream lines{report};
+  for (string line; getline(lines, line);) {
+    ASSERT_NE(line.find("| 0 live bytes |"), string::npos) << report;
+  }
+  gcu_mem_start();
+}
+
+TEST(Memory, ProfileLeaksAtExit) {
+  EXPECT_EXIT({
+    gcu_mem_stop();
+    gcu_mem_profile_start(true);
+    gcu_malloc(42);
+    exit(0);
+  }, testing::ExitedWithCode(0), "leak +\\| 42 bytes in 1 blocks \\| .*test-memory.cpp");
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cutil/memory.h>
+#include <cutil/packed.h>
+
+using namespace std;
+
+// Encode `values` (in batches of `batch`), and check every way of reading
+// them back.
+static void roundTrip(const vector<uint64_t> & values, size_t batch) {
+  auto packed = gcu_packed64_create(values.size());
+  ASSERT_NE(packed, nullptr);
+  vector<GCU_Type64_Union> input;
+  for (auto value : values) {
+    input.push_back(gcu_type64_ui64(value));
+  }
+  for (size_t i = 0; i < input.size(); i += batch) {
+    ASSERT_TRUE(gcu_packed64_append_many(packed, input.data() + i, min(batch, input.size() - i)));
+  }
+  ASSERT_EQ(gcu_packed64_count(packed), values.size());
+  ASSERT_EQ(packed->block_count, (values.size() + GCU_PACKED64_BLOCK_SIZE - 1) / GCU_PACKED64_BLOCK_SIZE);
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto value = gcu_packed64_get(packed, i);
+    ASSERT_TRUE(value.exists);
+    ASSERT_EQ(value.value.ui64, values[i]) << "index " << i;
+  }
+  ASSERT_FALSE(gcu_packed64_get(packed, values.size()).exists);
+
+  // Decoding appends to what is already in the vector.
+  auto decoded = gcu_vector64_create(0);
+  gcu_vector64_append(decoded, gcu_type64_ui64(42));
+  ASSERT_TRUE(gcu_packed64_decode(packed, decoded));
+  ASSERT_EQ(decoded->count, values.size() + 1);
+  ASSERT_EQ(decoded->data[0].ui64, 42);
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(decoded->data[i + 1].ui64, values[i]);
+  }
+  gcu_vector64_destroy(decoded);
+
+  GCU_Type64_Union block[GCU_PACKED64_BLOCK_SIZE];
+  for (size_t b = 0; b < packed->block_count; ++b) {
+    size_t count = gcu_packed64_decode_block(packed, b, block);
+    ASSERT_EQ(count, min<size_t>(GCU_PACKED64_BLOCK_SIZE, values.size() - b * GCU_PACKED64_BLOCK_SIZE));
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_EQ(block[i].ui64, values[b * GCU_PACKED64_BLOCK_SIZE + i]);
+    }
+  }
+  ASSERT_EQ(gcu_packed64_decode_block(packed, packed->block_count, block), 0);
+
+  // The aggregations match the plain values.
+  uint64_t sum = 0;
+  for (auto value : values) {
+    sum += value;
+  }
+  ASSERT_EQ(gcu_packed64_sum_ui64(packed), sum);
+  ASSERT_EQ(gcu_packed64_min_ui64(packed), values.empty() ? UINT64_MAX : *min_element(values.begin(), values.end()));
+  ASSERT_EQ(gcu_packed64_max_ui64(packed), values.empty() ? 0 : *max_element(values.begin(), values.end()));
+  if (!values.empty()) {
+    auto sorted = values;
+    sort(sorted.begin(), sorted.end());
+    uint64_t low = sorted[sorted.size() / 4];
+    uint64_t high = sorted[sorted.size() * 3 / 4];
+    size_t expected = count_if(values.begin(), values.end(), [&](uint64_t v) { return v >= low && v <= high; });
+    ASSERT_EQ(gcu_packed64_count_range_ui64(packed, low, high), expected);
+    ASSERT_EQ(gcu_packed64_count_range_ui64(packed, 0, UINT64_MAX), values.size());
+  }
+  gcu_packed64_destroy(packed);
+}
+
+TEST(Packed64, Empty) {
+  roundTrip({}, 1);
+  auto packed = gcu_packed64_create(0);
+  ASSERT_TRUE(gcu_packed64_append_many(packed, nullptr, 0));
+  ASSERT_EQ(gcu_packed64_size(packed), 0);
+  gcu_packed64_destroy(packed);
+}
+
+// An allocator which refuses to grow blocks once its reallocations run out.
+static size_t reallocations;
+
+static void * limitedAllocate(void *, size_t size) {
+  return gcu_system_allocator.allocate(gcu_system_allocator.context, size);
+}
+
+static void * limitedAllocateZeroed(void *, size_t nitems, size_t size) {
+  return gcu_system_allocator.allocate_zeroed(gcu_system_allocator.context, nitems, size);
+}
+
+static void * limitedReallocate(void *, void * pointer, size_t size) {
+  if (!reallocations) {
+    return nullptr;
+  }
+  --reallocations;
+  return gcu_system_allocator.reallocate(gcu_system_allocator.context, pointer, size);
+}
+
+static void limitedFree(void *, void * pointer) {
+  gcu_system_allocator.free(gcu_system_allocator.context, pointer);
+}
+
+static const GCU_Allocator LIMITED = {limitedAllocate, limitedAllocateZeroed, limitedReallocate, limitedFree, nullptr, nullptr};
+
+TEST(Packed64, AppendIsAllOrNothing) {
+  ASSERT_FALSE(gcu_packed64_append_many(nullptr, nullptr, 0));
+  auto packed = gcu_packed64_create(0);
+  ASSERT_FALSE(gcu_packed64_append_many(packed, nullptr, 1));
+
+  // Random values need every bit, so each block grows the packed numbers.
+  mt19937_64 random(7);
+  vector<GCU_Type64_Union> values;
+  for (size_t i = 0; i < 1100; ++i) {
+    values.push_back(gcu_type64_ui64(random()));
+  }
+  ASSERT_TRUE(gcu_packed64_append_many(packed, values.data(), 100));
+  size_t size = gcu_packed64_size(packed);
+
+  // The short last block is re-encoded before the memory runs out.
+  for (size_t allowed = 0; allowed < 3; ++allowed) {
+    reallocations = allowed;
+    auto previous = gcu_set_allocator(&LIMITED);
+    ASSERT_FALSE(gcu_packed64_append_many(packed, values.data() + 100, 1000));
+    gcu_set_allocator(previous);
+    ASSERT_EQ(gcu_packed64_count(packed), 100);
+    ASSERT_EQ(gcu_packed64_size(packed), size);
+    for (size_t i = 0; i < 100; ++i) {
+      ASSERT_EQ(gcu_packed64_get(packed, i).value.ui64, values[i].ui64);
+    }
+  }
+
+  ASSERT_TRUE(gcu_packed64_append_many(packed, values.data() + 100, 1000));
+  ASSERT_EQ(gcu_packed64_count(packed), 1100);
+  for (size_t i = 0; i < 1100; ++i) {
+    ASSERT_EQ(gcu_packed64_get(packed, i).value.ui64, values[i].ui64);
+  }
+  gcu_packed64_destroy(packed);
+}
+
+TEST(Packed64, Timestamps) {
+  // A steady clock with a little jitter, and the occasional gap.
+  mt19937_64 rng(1);
+  vector<uint64_t> values;
+  uint64_t now = 1700000000000000000ull;
+  for (size_t i = 0; i < 10000; ++i) {
+    now += 1000000 + rng() % 64;
+    if (rng() % 1000 == 0) {
+      now += 5000000000ull;
+    }
+    values.push_back(now);
+  }
+  roundTrip(values, values.size());
+  roundTrip(values, 1);
+  roundTrip(values, 77);
+
+  // Differences of about 2^20 with 6 bits of jitter take a byte or less
+  // each, once the stride is subtracted.
+  auto packed = gcu_packed64_create(0);
+  vector<GCU_Type64_Union> input;
+  for (auto value : values) {
+    input.push_back(gcu_type64_ui64(value));
+  }
+  gcu_packed64_append_many(packed, input.data(), input.size());
+  ASSERT_LT(gcu_packed64_size(packed), values.size() * 2);
+  ASSERT_EQ(packed->blocks[0].encoding, GCU_PACKED64_DELTA);
+  gcu_packed64_destroy(packed);
+}
+
+TEST(Packed64, EveryWidth) {
+  // Small counters next to a large base, at every width, including values
+  // which use all 64 bits.
+  mt19937_64 rng(2);
+  for (unsigned bits = 0; bits <= 64; ++bits) {
+    vector<uint64_t> values;
+    uint64_t mask = bits == 64 ? UINT64_MAX : ((uint64_t)1 << bits) - 1;
+    for (size_t i = 0; i < 300; ++i) {
+      values.push_back((bits == 64 ? 0 : 1000) + (rng() & mask));
+    }
+    roundTrip(values, 128);
+  }
+}
+
+TEST(Packed64, ConstantAndStrided) {
+  // Equal values and evenly spaced values take no room beyond the headers.
+  vector<uint64_t> constant(1000, 7);
+  vector<uint64_t> strided;
+  for (size_t i = 0; i < 1000; ++i) {
+    strided.push_back(500 + i * 3);
+  }
+  for (auto & values : {constant, strided}) {
+    roundTrip(values, 100);
+    auto packed = gcu_packed64_create(0);
+    vector<GCU_Type64_Union> input;
+    for (auto value : values) {
+      input.push_back(gcu_type64_ui64(value));
+    }
+    gcu_packed64_append_many(packed, input.data(), input.size());
+    ASSERT_EQ(packed->word_count, 0);
+    gcu_packed64_destroy(packed);
+  }
+}
+
+TEST(Packed64, SignedValues) {
+  // A series wandering across zero survives as i64.
+  mt19937_64 rng(3);
+  vector<uint64_t> values;
+  int64_t value = 0;
+  for (size_t i = 0; i < 5000; ++i) {
+    value += (int64_t)(rng() % 21) - 10;
+    values.push_back((uint64_t)value);
+  }
+  roundTrip(values, 1000);
+
+  // Extreme differences in both directions.
+  roundTrip({0, UINT64_MAX, 0, UINT64_MAX, 1, (uint64_t)INT64_MIN, (uint64_t)INT64_MAX}, 3);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
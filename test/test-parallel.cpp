@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cutil/parallel.h>
+#include <cutil/sort.h>
+#include <cutil/thread.h>
+
+using namespace std;
+
+// Thread counts which exercise the serial path, an odd number of workers, and
+// (with `0`) one thread per processor.
+static const size_t threadCounts[] = {1, 3, 0};
+
+// Large enough to be split into many chunks and to use the parallel sort.
+static const size_t COUNT = 300000;
+
+static GCU_Vector64 * randomVector(size_t count, mt19937_64 & rng) {
+  auto v = gcu_vector64_create(count);
+  for (size_t i = 0; i < count; ++i) {
+    gcu_vector64_append(v, gcu_type64_ui64(rng()));
+  }
+  return v;
+}
+
+static void countTask(size_t index, void * arg) {
+  (*(vector<atomic<int>> *)arg)[index]++;
+}
+
+TEST(Pool, RunsEveryTaskOnce) {
+  for (auto threads : threadCounts) {
+    auto pool = gcu_thread_pool_create(threads);
+    ASSERT_TRUE(pool);
+    EXPECT_EQ(gcu_thread_pool_get_num_threads(pool), threads ? threads : gcu_thread_get_num_processors());
+
+    // Run several jobs, so that the workers are reused.
+    for (size_t tasks : {0, 1, 2, 7, 1000}) {
+      vector<atomic<int>> counts(tasks);
+      ASSERT_TRUE(gcu_thread_pool_run(pool, tasks, countTask, &counts));
+      for (auto & count : counts) {
+        ASSERT_EQ(count, 1);
+      }
+    }
+    gcu_thread_pool_destroy(pool);
+  }
+}
+
+TEST(Pool, NullTask) {
+  EXPECT_FALSE(gcu_thread_pool_run(NULL, 10, NULL, NULL));
+}
+
+static void nestedTask(size_t, void * arg) {
+  // Running a job from inside a job must not wait on the busy pool.
+  auto pool = (GCU_Thread_Pool *)arg;
+  vector<atomic<int>> counts(4);
+  gcu_thread_pool_run(pool, counts.size(), countTask, &counts);
+}
+
+TEST(Pool, NestedJobs) {
+  auto pool = gcu_thread_pool_create(3);
+  ASSERT_TRUE(pool);
+  ASSERT_TRUE(gcu_thread_pool_run(pool, 16, nestedTask, pool));
+  gcu_thread_pool_destroy(pool);
+
+  // The default pool.
+  ASSERT_TRUE(gcu_thread_pool_run(NULL, 16, nestedTask, NULL));
+}
+
+TEST(Pool, ChunkSize) {
+  auto pool = gcu_thread_pool_create(4);
+  ASSERT_TRUE(pool);
+
+  // Large inputs are capped at 256 KiB per chunk.
+  EXPECT_EQ(gcu_thread_pool_get_chunk_size(pool, 100000000, 8), 32768);
+
+  // Medium inputs are split into several chunks per thread.
+  EXPECT_EQ(gcu_thread_pool_get_chunk_size(pool, 160000, 8), 10000);
+
+  // Small inputs are not split below 16 KiB.
+  EXPECT_EQ(gcu_thread_pool_get_chunk_size(pool, 100, 8), 2048);
+
+  // Chunks are whole cache lines.
+  EXPECT_EQ(gcu_thread_pool_get_chunk_size(pool, 160004, 8) % 8, 0);
+  gcu_thread_pool_destroy(pool);
+}
+
+static void incrementChunk(GCU_Type64_Union * data, size_t count, void *) {
+  for (size_t i = 0; i < count; ++i) {
+    ++data[i].ui64;
+  }
+}
+
+TEST(Parallel, ForEach) {
+  mt19937_64 rng{1};
+  for (auto threads : threadCounts) {
+    auto pool = gcu_thread_pool_create(threads);
+    auto v = randomVector(COUNT, rng);
+    vector<uint64_t> expected;
+    for (size_t i = 0; i < v->count; ++i) {
+      expected.push_back(v->data[i].ui64 + 1);
+    }
+    ASSERT_TRUE(gcu_vector64_par_for_each(pool, v, incrementChunk, NULL));
+    for (size_t i = 0; i < v->count; ++i) {
+      ASSERT_EQ(v->data[i].ui64, expected[i]);
+    }
+    gcu_vector64_destroy(v);
+    gcu_thread_pool_destroy(pool);
+  }
+  EXPECT_FALSE(gcu_vector64_par_for_each(NULL, NULL, incrementChunk, NULL));
+}
+
+static void scaleChunk(const GCU_Type64_Union * source, GCU_Type64_Union * destination, size_t count, void * arg) {
+  double factor = *(double *)arg;
+  for (size_t i = 0; i < count; ++i) {
+    destination[i].f64 = (double)source[i].ui64 * factor;
+  }
+}
+
+TEST(Parallel, Transform) {
+  mt19937_64 rng{2};
+  double factor = 0.5;
+  for (auto threads : threadCounts) {
+    auto pool = gcu_thread_pool_create(threads);
+    auto source = randomVector(COUNT, rng);
+    auto destination = gcu_vector64_create(0);
+    ASSERT_TRUE(gcu_vector64_par_transform(pool, destination, source, scaleChunk, &factor));
+    ASSERT_EQ(destination->count, source->count);
+    for (size_t i = 0; i < source->count; ++i) {
+      ASSERT_EQ(destination->data[i].f64, (double)source->data[i].ui64 * factor);
+    }
+
+    // In place.
+    vector<uint64_t> original;
+    for (size_t i = 0; i < source->count; ++i) {
+      original.push_back(source->data[i].ui64);
+    }
+    ASSERT_TRUE(gcu_vector64_par_transform(pool, source, source, scaleChunk, &factor));
+    for (size_t i = 0; i < source->count; ++i) {
+      ASSERT_EQ(source->data[i].f64, (double)original[i] * factor);
+    }
+
+    gcu_vector64_destroy(source);
+    gcu_vector64_destroy(destination);
+    gcu_thread_pool_destroy(pool);
+  }
+}
+
+TEST(Parallel, Reduce) {
+  mt19937_64 rng{3};
+  for (auto threads : threadCounts) {
+    auto pool = gcu_thread_pool_create(threads);
+    auto v = randomVector(COUNT, rng);
+
+    uint64_t sum = 0;
+    uint64_t minimum = numeric_limits<uint64_t>::max();
+    uint64_t maximum = 0;
+    int64_t isum = 0;
+    int64_t iminimum = numeric_limits<int64_t>::max();
+    int64_t imaximum = numeric_limits<int64_t>::min();
+    for (size_t i = 0; i < v->count; ++i) {
+      sum += v->data[i].ui64;
+      minimum = min(minimum, v->data[i].ui64);
+      maximum = max(maximum, v->data[i].ui64);
+      isum = (int64_t)((uint64_t)isum + (uint64_t)v->data[i].i64);
+      iminimum = min(iminimum, v->data[i].i64);
+      imaximum = max(imaximum, v->data[i].i64);
+    }
+    EXPECT_EQ(gcu_vector64_par_sum_ui64(pool, v), sum);
+    EXPECT_EQ(gcu_vector64_par_min_ui64(pool, v), minimum);
+    EXPECT_EQ(gcu_vector64_par_max_ui64(pool, v), maximum);
+    EXPECT_EQ(gcu_vector64_par_sum_i64(pool, v), isum);
+    EXPECT_EQ(gcu_vector64_par_min_i64(pool, v), iminimum);
+    EXPECT_EQ(gcu_vector64_par_max_i64(pool, v), imaximum);
+
+    // Doubles, with a NaN which must be ignored by min and max.
+    double dsum = 0;
+    for (size_t i = 0; i < v->count; ++i) {
+      v->data[i].f64 = (double)(i % 1000) - 500;
+      dsum += v->data[i].f64;
+    }
+    v->data[12345].f64 = NAN;
+    EXPECT_TRUE(isnan(gcu_vector64_par_sum_f64(pool, v)));
+    v->data[12345].f64 = -500;
+    EXPECT_DOUBLE_EQ(gcu_vector64_par_sum_f64(pool, v), dsum + (-500 - (double)(12345 % 1000 - 500)));
+    v->data[12345].f64 = NAN;
+    EXPECT_EQ(gcu_vector64_par_min_f64(pool, v), -500);
+    EXPECT_EQ(gcu_vector64_par_max_f64(pool, v), 499);
+
+    gcu_vector64_destroy(v);
+    gcu_thread_pool_destroy(pool);
+  }
+}
+
+TEST(Parallel, ReduceEmpty) {
+  auto v = gcu_vector64_create(0);
+  EXPECT_EQ(gcu_vector64_par_sum_ui64(NULL, v), 0);
+  EXPECT_EQ(gcu_vector64_par_min_ui64(NULL, v), numeric_limits<uint64_t>::max());
+  EXPECT_EQ(gcu_vector64_par_max_i64(NULL, v), numeric_limits<int64_t>::min());
+  EXPECT_EQ(gcu_vector64_par_min_f64(NULL, v), numeric_limits<double>::infinity());
+  EXPECT_EQ(gcu_vector64_par_max_f64(NULL, NULL), -numeric_limits<double>::infinity());
+  gcu_vector64_destroy(v);
+}
+
+TEST(Parallel, Sort64) {
+  mt19937_64 rng{4};
+  for (auto threads : threadCounts) {
+    auto pool = gcu_thread_pool_create(threads);
+
+    // Clustered timestamps, where only the low bits vary.
+    auto v = gcu_vector64_create(COUNT);
+    vector<uint64_t> expected;
+    for (size_t i = 0; i < COUNT; ++i) {
+      uint64_t value = 1700000000000000000ull + (rng() % 3600000000000ull);
+      gcu_vector64_append(v, gcu_type64_ui64(value));
+      expected.push_back(value);
+    }
+    ASSERT_TRUE(gcu_vector64_par_sort_ui64(pool, v));
+    sort(expected.begin(), expected.end());
+    for (size_t i = 0; i < COUNT; ++i) {
+      ASSERT_EQ(v->data[i].ui64, expected[i]);
+    }
+
+    // Signed values spanning zero.
+    vector<int64_t> iexpected;
+    for (size_t i = 0; i < COUNT; ++i) {
+      v->data[i].i64 = (int64_t)(rng() % 2000001) - 1000000;
+      iexpected.push_back(v->data[i].i64);
+    }
+    ASSERT_TRUE(gcu_vector64_par_sort_i64(pool, v));
+    sort(iexpected.begin(), iexpected.end());
+    for (size_t i = 0; i < COUNT; ++i) {
+      ASSERT_EQ(v->data[i].i64, iexpected[i]);
+    }
+
+    // Doubles of both signs.
+    vector<double> dexpected;
+    for (size_t i = 0; i < COUNT; ++i) {
+      v->data[i].f64 = uniform_real_distribution<double>{-1e6, 1e6}(rng);
+      dexpected.push_back(v->data[i].f64);
+    }
+    ASSERT_TRUE(gcu_vector64_par_sort_f64(pool, v));
+    sort(dexpected.begin(), dexpected.end());
+    for (size_t i = 0; i < COUNT; ++i) {
+      ASSERT_EQ(v->data[i].f64, dexpected[i]);
+    }
+
+    // All equal.
+    for (size_t i = 0; i < COUNT; ++i) {
+      v->data[i].ui64 = 42;
+    }
+    ASSERT_TRUE(gcu_vector64_par_sort_ui64(pool, v));
+    for (size_t i = 0; i < COUNT; ++i) {
+      ASSERT_EQ(v->data[i].ui64, 42);
+    }
+
+    gcu_vector64_destroy(v);
+    gcu_thread_pool_destroy(pool);
+  }
+}
+
+TEST(Parallel, Sort32) {
+  mt19937_64 rng{5};
+  for (auto threads : threadCounts) {
+    auto pool = gcu_thread_pool_create(threads);
+    vector<GCU_Type32_Union> data(COUNT);
+    vector<float> expected;
+    for (auto & value : data) {
+      value.f32 = uniform_real_distribution<float>{-1000.0f, 1000.0f}(rng);
+      expected.push_back(value.f32);
+    }
+    ASSERT_TRUE(gcu_par_sort32_f32(pool, data.data(), data.size()));
+    sort(expected.begin(), expected.end());
+    for (size_t i = 0; i < COUNT; ++i) {
+      ASSERT_EQ(data[i].f32, expected[i]);
+    }
+    gcu_thread_pool_destroy(pool);
+  }
+  EXPECT_FALSE(gcu_vector32_par_sort_ui32(NULL, NULL));
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,152 @@
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cutil/pool.h>
+#include <cutil/thread.h>
+
+using namespace std;
+
+TEST(Pool, AllocateAndFree) {
+  auto pool = gcu_pool_create(24);
+  ASSERT_NE(pool, nullptr);
+  ASSERT_EQ(gcu_pool_object_size(pool), 32);
+  ASSERT_EQ(gcu_pool_capacity(pool), 0);
+
+  // Objects are aligned, distinct, and usable.
+  set<void *> seen;
+  vector<void *> objects;
+  for (int i = 0; i < 10000; ++i) {
+    auto object = (uint64_t *)gcu_pool_allocate(pool);
+    ASSERT_NE(object, nullptr);
+    ASSERT_EQ((uintptr_t)object % 16, 0);
+    ASSERT_TRUE(seen.insert(object).second);
+    memset(object, 0xFF, 24);
+    object[0] = i;
+    objects.push_back(object);
+  }
+  for (int i = 0; i < 10000; ++i) {
+    ASSERT_EQ(*(uint64_t *)objects[i], (uint64_t)i);
+  }
+  size_t capacity = gcu_pool_capacity(pool);
+  ASSERT_GE(capacity, 10000);
+
+  // Freed objects are reused, so the pool does not grow.
+  for (int round = 0; round < 5; ++round) {
+    for (auto object : objects) {
+      gcu_pool_free(pool, object);
+    }
+    for (auto & object : objects) {
+      object = gcu_pool_allocate(pool);
+      ASSERT_EQ(seen.count(object), 1);
+    }
+  }
+  ASSERT_EQ(gcu_pool_capacity(pool), capacity);
+  gcu_pool_free(pool, nullptr);
+  gcu_pool_destroy(pool);
+}
+
+TEST(Pool, Flush) {
+  auto pool = gcu_pool_create(64);
+  vector<void *> objects;
+  for (int i = 0; i < 50; ++i) {
+    objects.push_back(gcu_pool_allocate(pool));
+  }
+  for (auto object : objects) {
+    gcu_pool_free(pool, object);
+  }
+  gcu_pool_flush(pool);
+
+  // Flushed objects come back from the depot.
+  set<void *> freed(objects.begin(), objects.end());
+  for (int i = 0; i < 50; ++i) {
+    ASSERT_EQ(freed.count(gcu_pool_allocate(pool)), 1);
+  }
+  gcu_pool_destroy(pool);
+  ASSERT_EQ(gcu_pool_create(0), nullptr);
+}
+
+// Allocates objects from a pool in rounds, freeing half of each round.
+struct Worker {
+  GCU_Pool * pool;
+  vector<void *> mine;
+  bool ok = true;
+};
+
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION work(GCU_THREAD_FUNC_ARG_T arg) {
+  auto worker = (Worker *)arg;
+  for (size_t round = 0; round < 50; ++round) {
+    for (size_t i = 0; i < 200; ++i) {
+      auto object = (size_t *)gcu_pool_allocate(worker->pool);
+      if (!object) {
+        worker->ok = false;
+        return 0;
+      }
+      *object = (size_t)worker;
+      worker->mine.push_back(object);
+    }
+    for (size_t i = 0; i < 100; ++i) {
+      if (*(size_t *)worker->mine.back() != (size_t)worker) {
+        worker->ok = false;
+      }
+      gcu_pool_free(worker->pool, worker->mine.back());
+      worker->mine.pop_back();
+    }
+  }
+  return 0;
+}
+
+TEST(Pool, Threads) {
+  auto pool = gcu_pool_create(16);
+  const size_t THREADS = 4;
+  Worker workers[THREADS];
+  GCU_Thread threads[THREADS];
+  for (size_t i = 0; i < THREADS; ++i) {
+    workers[i].pool = pool;
+    ASSERT_EQ(gcu_thread_create(&threads[i], work, &workers[i]), 0);
+  }
+  for (size_t i = 0; i < THREADS; ++i) {
+    gcu_thread_join(threads[i]);
+  }
+
+  // Every object still held is distinct, and still holds its owner.
+  set<void *> seen;
+  for (auto & worker : workers) {
+    ASSERT_TRUE(worker.ok);
+    for (auto object : worker.mine) {
+      ASSERT_TRUE(seen.insert(object).second);
+      ASSERT_EQ(*(size_t *)object, (size_t)&worker);
+    }
+  }
+  ASSERT_EQ(seen.size(), THREADS * 50 * 100);
+
+  // Objects can be freed by a thread which did not allocate them.
+  for (auto & worker : workers) {
+    for (auto object : worker.mine) {
+      gcu_pool_free(pool, object);
+    }
+  }
+  gcu_pool_destroy(pool);
+}
+
+TEST(Pool, Sized) {
+  for (size_t size : {1, 16, 17, 100, 256, 257, 5000}) {
+    auto a = (char *)gcu_sized_malloc(size);
+    auto b = (char *)gcu_sized_malloc(size);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    ASSERT_EQ((uintptr_t)a % 16, 0);
+    memset(a, 1, size);
+    memset(b, 2, size);
+    ASSERT_EQ(a[size - 1], 1);
+    gcu_sized_free(a, size);
+    gcu_sized_free(b, size);
+  }
+  gcu_sized_free(nullptr, 10);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
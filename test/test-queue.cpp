@@ -0,0 +1,202 @@
+#include <vector>
+#include <gtest/gtest.h>
+#include <cutil/queue.h>
+#include <cutil/thread.h>
+
+using namespace std;
+
+// Enough values to force the threads to park and wake many times through a
+// small queue.
+static const uint64_t COUNT = 100000;
+
+// A value which tells a consumer thread to stop.
+static const uint64_t STOP = UINT64_MAX;
+
+TEST(SPSCQueue64, SingleThread) {
+  auto q = gcu_spsc_queue64_create(5);
+  ASSERT_NE(q, nullptr);
+  ASSERT_FALSE(gcu_spsc_queue64_try_pop(q).exists);
+
+  // The capacity is rounded up to 8.
+  for (uint64_t i = 0; i < 8; ++i) {
+    ASSERT_TRUE(gcu_spsc_queue64_try_push(q, gcu_type64_ui64(i)));
+  }
+  ASSERT_FALSE(gcu_spsc_queue64_try_push(q, gcu_type64_ui64(8)));
+  ASSERT_EQ(gcu_spsc_queue64_count(q), 8);
+  for (uint64_t i = 0; i < 5; ++i) {
+    ASSERT_EQ(gcu_spsc_queue64_try_pop(q).value.ui64, i);
+  }
+
+  // Batches wrap around the end of the buffer, and are cut short when the
+  // queue is full or empty.
+  GCU_Type64_Union in[10];
+  for (uint64_t i = 0; i < 10; ++i) {
+    in[i] = gcu_type64_ui64(8 + i);
+  }
+  ASSERT_EQ(gcu_spsc_queue64_push_many(q, in, 10), 5);
+  GCU_Type64_Union out[10];
+  ASSERT_EQ(gcu_spsc_queue64_pop_many(q, out, 10), 8);
+  for (uint64_t i = 0; i < 8; ++i) {
+    ASSERT_EQ(out[i].ui64, 5 + i);
+  }
+  ASSERT_EQ(gcu_spsc_queue64_pop_many(q, out, 10), 0);
+  ASSERT_EQ(gcu_spsc_queue64_count(q), 0);
+  gcu_spsc_queue64_destroy(q);
+}
+
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION spscProducer(GCU_THREAD_FUNC_ARG_T arg) {
+  auto q = (GCU_SPSC_Queue64 *)arg;
+  GCU_Type64_Union batch[7];
+  for (uint64_t i = 0; i < COUNT;) {
+    // Alternate between single values and batches.
+    if (i % 3) {
+      gcu_spsc_queue64_push(q, gcu_type64_ui64(i++));
+      continue;
+    }
+    size_t count = COUNT - i < 7 ? COUNT - i : 7;
+    for (size_t j = 0; j < count; ++j) {
+      batch[j] = gcu_type64_ui64(i + j);
+    }
+    i += gcu_spsc_queue64_push_many(q, batch, count);
+  }
+  return 0;
+}
+
+TEST(SPSCQueue64, TwoThreadsKeepOrder) {
+  auto q = gcu_spsc_queue64_create(16);
+  GCU_Thread producer;
+  ASSERT_EQ(0, gcu_thread_create(&producer, spscProducer, q));
+
+  GCU_Type64_Union batch[5];
+  for (uint64_t i = 0; i < COUNT;) {
+    if (i % 2) {
+      ASSERT_EQ(gcu_spsc_queue64_pop(q).ui64, i++);
+      continue;
+    }
+    size_t count = gcu_spsc_queue64_pop_many(q, batch, 5);
+    for (size_t j = 0; j < count; ++j) {
+      ASSERT_EQ(batch[j].ui64, i++);
+    }
+  }
+  gcu_thread_join(producer);
+  ASSERT_EQ(gcu_spsc_queue64_count(q), 0);
+  gcu_spsc_queue64_destroy(q);
+}
+
+TEST(MPMCQueue64, SingleThread) {
+  auto q = gcu_mpmc_queue64_create(1);
+  ASSERT_NE(q, nullptr);
+
+  // The capacity is at least 2.
+  ASSERT_TRUE(gcu_mpmc_queue64_try_push(q, gcu_type64_ui64(1)));
+  ASSERT_TRUE(gcu_mpmc_queue64_try_push(q, gcu_type64_ui64(2)));
+  ASSERT_FALSE(gcu_mpmc_queue64_try_push(q, gcu_type64_ui64(3)));
+  ASSERT_EQ(gcu_mpmc_queue64_try_pop(q).value.ui64, 1);
+  ASSERT_EQ(gcu_mpmc_queue64_try_pop(q).value.ui64, 2);
+  ASSERT_FALSE(gcu_mpmc_queue64_try_pop(q).exists);
+  gcu_mpmc_queue64_destroy(q);
+
+  q = gcu_mpmc_queue64_create(8);
+  GCU_Type64_Union in[10];
+  for (uint64_t i = 0; i < 10; ++i) {
+    in[i] = gcu_type64_ui64(i);
+  }
+  ASSERT_EQ(gcu_mpmc_queue64_push_many(q, in, 3), 3);
+  GCU_Type64_Union out[10];
+  ASSERT_EQ(gcu_mpmc_queue64_pop_many(q, out, 2), 2);
+  ASSERT_EQ(gcu_mpmc_queue64_push_many(q, in + 3, 10), 7);
+  ASSERT_EQ(gcu_mpmc_queue64_count(q), 8);
+  ASSERT_EQ(gcu_mpmc_queue64_pop_many(q, out, 10), 8);
+  for (uint64_t i = 0; i < 8; ++i) {
+    ASSERT_EQ(out[i].ui64, i + 2);
+  }
+  ASSERT_EQ(gcu_mpmc_queue64_pop_many(q, out, 10), 0);
+  gcu_mpmc_queue64_destroy(q);
+}
+
+struct MPMCWorker {
+  GCU_MPMC_Queue64 * queue;
+  uint64_t id;
+  vector<uint64_t> last;  // The last value seen from each producer.
+  uint64_t count;
+  bool ordered;
+};
+
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION mpmcProducer(GCU_THREAD_FUNC_ARG_T arg) {
+  auto worker = (MPMCWorker *)arg;
+  GCU_Type64_Union batch[4];
+  // Each value holds the producer in its high bits, and a sequence number.
+  for (uint64_t i = 1; i <= COUNT;) {
+    if (i % 2) {
+      gcu_mpmc_queue64_push(worker->queue, gcu_type64_ui64((worker->id << 32) | i++));
+      continue;
+    }
+    size_t count = COUNT + 1 - i < 4 ? COUNT + 1 - i : 4;
+    for (size_t j = 0; j < count; ++j) {
+      batch[j] = gcu_type64_ui64((worker->id << 32) | (i + j));
+    }
+    i += gcu_mpmc_queue64_push_many(worker->queue, batch, count);
+  }
+  return 0;
+}
+
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION mpmcConsumer(GCU_THREAD_FUNC_ARG_T arg) {
+  auto worker = (MPMCWorker *)arg;
+  GCU_Type64_Union batch[4];
+  while (true) {
+    size_t count = gcu_mpmc_queue64_pop_many(worker->queue, batch, 4);
+    if (!count) {
+      batch[0] = gcu_mpmc_queue64_pop(worker->queue);
+      count = 1;
+    }
+    for (size_t j = 0; j < count; ++j) {
+      if (batch[j].ui64 == STOP) {
+        // Anything after it is another consumer's STOP, so hand it back.
+        gcu_mpmc_queue64_push_many(worker->queue, batch + j + 1, count - j - 1);
+        return 0;
+      }
+      // Each consumer sees the values of each producer in order.
+      uint64_t producer = batch[j].ui64 >> 32;
+      uint64_t sequence = batch[j].ui64 & 0xffffffff;
+      worker->ordered = worker->ordered && sequence > worker->last[producer];
+      worker->last[producer] = sequence;
+      ++worker->count;
+    }
+  }
+}
+
+TEST(MPMCQueue64, ManyThreads) {
+  const size_t threads = 3;
+  auto q = gcu_mpmc_queue64_create(16);
+  vector<MPMCWorker> producers(threads);
+  vector<MPMCWorker> consumers(threads);
+  vector<GCU_Thread> handles(threads * 2);
+  for (size_t i = 0; i < threads; ++i) {
+    consumers[i] = MPMCWorker{q, i, vector<uint64_t>(threads, 0), 0, true};
+    ASSERT_EQ(0, gcu_thread_create(&handles[threads + i], mpmcConsumer, &consumers[i]));
+  }
+  for (size_t i = 0; i < threads; ++i) {
+    producers[i] = MPMCWorker{q, i, {}, 0, true};
+    ASSERT_EQ(0, gcu_thread_create(&handles[i], mpmcProducer, &producers[i]));
+  }
+  for (size_t i = 0; i < threads; ++i) {
+    gcu_thread_join(handles[i]);
+  }
+  for (size_t i = 0; i < threads; ++i) {
+    gcu_mpmc_queue64_push(q, gcu_type64_ui64(STOP));
+  }
+  uint64_t total = 0;
+  for (size_t i = 0; i < threads; ++i) {
+    gcu_thread_join(handles[threads + i]);
+    ASSERT_TRUE(consumers[i].ordered);
+    total += consumers[i].count;
+  }
+  ASSERT_EQ(total, threads * COUNT);
+  ASSERT_EQ(gcu_mpmc_queue64_count(q), 0);
+  gcu_mpmc_queue64_destroy(q);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cutil/reduce.h>
+
+using namespace std;
+
+// Sizes which exercise the empty case, the scalar tails, and several full
+// blocks.  The largest is big enough to overflow the 8-bit and 16-bit
+// counting lanes if they were not flushed.
+static const size_t sizes[] = {0, 1, 7, 63, 64, 65, 129, 1000, 100003, 5000001};
+
+// The functions of one lane type.
+template <typename U, typename T, typename S>
+struct Kernels {
+  S (*sum)(const U *, size_t);
+  T (*min)(const U *, size_t);
+  T (*max)(const U *, size_t);
+  size_t (*argmin)(const U *, size_t);
+  size_t (*argmax)(const U *, size_t);
+  size_t (*find)(const U *, size_t, T);
+  size_t (*count)(const U *, size_t, T);
+  size_t (*countRange)(const U *, size_t, T, T);
+};
+
+// Compare every kernel against a straightforward scalar loop.  `get` and
+// `set` access the lane under test, and `values` draws from a small range so
+// that there are plenty of duplicates to count and find.
+template <typename U, typename T, typename S, typename Get, typename Set>
+static void check(const Kernels<U, T, S> & k, Get get, Set set, T low, T high, uint64_t seed) {
+  mt19937_64 rng{seed};
+  for (auto size : sizes) {
+    vector<U> data(size);
+    for (auto & u : data) {
+      if constexpr (is_floating_point_v<T>) {
+        set(u, (T)uniform_real_distribution<double>{(double)low, (double)high}(rng));
+      }
+      else {
+        set(u, (T)(low + (T)(rng() % ((uint64_t)high - (uint64_t)low + 1))));
+      }
+    }
+
+    S sum = 0;
+    T minimum = numeric_limits<T>::has_infinity ? numeric_limits<T>::infinity() : numeric_limits<T>::max();
+    T maximum = numeric_limits<T>::has_infinity ? -numeric_limits<T>::infinity() : numeric_limits<T>::lowest();
+    for (auto & u : data) {
+      if constexpr (is_floating_point_v<T>) {
+        sum += get(u);
+      }
+      else {
+        sum = (S)((uint64_t)sum + (uint64_t)(S)get(u));
+      }
+      minimum = min(minimum, get(u));
+      maximum = max(maximum, get(u));
+    }
+
+    if constexpr (is_floating_point_v<T>) {
+      EXPECT_NEAR(k.sum(data.data(), size), sum, fabs((double)sum) * 1e-9 + 1e-6) << size;
+    }
+    else {
+      EXPECT_EQ(k.sum(data.data(), size), sum) << size;
+    }
+    EXPECT_EQ(k.min(data.data(), size), minimum) << size;
+    EXPECT_EQ(k.max(data.data(), size), maximum) << size;
+
+    size_t argmin = 0;
+    size_t argmax = 0;
+    for (size_t i = 0; i < size; ++i) {
+      argmin = get(data[i]) < get(data[argmin]) ? i : argmin;
+      argmax = get(data[i]) > get(data[argmax]) ? i : argmax;
+    }
+    EXPECT_EQ(k.argmin(data.data(), size), argmin) << size;
+    EXPECT_EQ(k.argmax(data.data(), size), argmax) << size;
+
+    // Search for a value near the end, so that most blocks are skipped.
+    if (size) {
+      T needle = get(data[size - 1 - size / 10]);
+      size_t first = 0;
+      while (get(data[first]) != needle) {
+        ++first;
+      }
+      EXPECT_EQ(k.find(data.data(), size, needle), first) << size;
+      EXPECT_EQ(k.count(data.data(), size, needle), (size_t)count_if(data.begin(), data.end(), [&](const U & u) { return get(u) == needle; })) << size;
+    }
+
+    // A value which is not present.
+    T missing = high;
+    for (auto & u : data) {
+      if (get(u) == high) {
+        set(u, low);
+      }
+    }
+    EXPECT_EQ(k.find(data.data(), size, missing), size) << size;
+    EXPECT_EQ(k.count(data.data(), size, missing), 0) << size;
+
+    T from = (T)(low + (high - low) / 4);
+    T to = (T)(low + (high - low) / 2);
+    EXPECT_EQ(k.countRange(data.data(), size, from, to), (size_t)count_if(data.begin(), data.end(), [&](const U & u) { return get(u) >= from && get(u) <= to; })) << size;
+  }
+}
+
+TEST(Reduce64, ui64) {
+  Kernels<GCU_Type64_Union, uint64_t, uint64_t> k{gcu_sum64_ui64, gcu_min64_ui64, gcu_max64_ui64, gcu_argmin64_ui64, gcu_argmax64_ui64, gcu_find64_ui64, gcu_count64_ui64, gcu_count_range64_ui64};
+  check(k, [](const GCU_Type64_Union & u) { return u.ui64; }, [](GCU_Type64_Union & u, uint64_t v) { u.ui64 = v; }, (uint64_t)1 << 62, ((uint64_t)1 << 62) + 1000, 1);
+}
+
+TEST(Reduce64, i64) {
+  Kernels<GCU_Type64_Union, int64_t, int64_t> k{gcu_sum64_i64, gcu_min64_i64, gcu_max64_i64, gcu_argmin64_i64, gcu_argmax64_i64, gcu_find64_i64, gcu_count64_i64, gcu_count_range64_i64};
+  check(k, [](const GCU_Type64_Union & u) { return u.i64; }, [](GCU_Type64_Union & u, int64_t v) { u.i64 = v; }, (int64_t)-500, (int64_t)500, 2);
+}
+
+TEST(Reduce64, f64) {
+  Kernels<GCU_Type64_Union, GCU_float64_t, double> k{gcu_sum64_f64, gcu_min64_f64, gcu_max64_f64, gcu_argmin64_f64, gcu_argmax64_f64, gcu_find64_f64, gcu_count64_f64, gcu_count_range64_f64};
+  check(k, [](const GCU_Type64_Union & u) { return u.f64; }, [](GCU_Type64_Union & u, GCU_float64_t v) { u.f64 = v; }, -1000.0, 1000.0, 3);
+}
+
+TEST(Reduce32, ui32) {
+  Kernels<GCU_Type32_Union, uint32_t, uint64_t> k{gcu_sum32_ui32, gcu_min32_ui32, gcu_max32_ui32, gcu_argmin32_ui32, gcu_argmax32_ui32, gcu_find32_ui32, gcu_count32_ui32, gcu_count_range32_ui32};
+  check(k, [](const GCU_Type32_Union & u) { return u.ui32; }, [](GCU_Type32_Union & u, uint32_t v) { u.ui32 = v; }, (uint32_t)4000000000u, (uint32_t)4000001000u, 4);
+}
+
+TEST(Reduce32, i32) {
+  Kernels<GCU_Type32_Union, int32_t, int64_t> k{gcu_sum32_i32, gcu_min32_i32, gcu_max32_i32, gcu_argmin32_i32, gcu_argmax32_i32, gcu_find32_i32, gcu_count32_i32, gcu_count_range32_i32};
+  check(k, [](const GCU_Type32_Union & u) { return u.i32; }, [](GCU_Type32_Union & u, int32_t v) { u.i32 = v; }, (int32_t)-2000000000, (int32_t)-1999999000, 5);
+}
+
+TEST(Reduce32, f32) {
+  Kernels<GCU_Type32_Union, GCU_float32_t, double> k{gcu_sum32_f32, gcu_min32_f32, gcu_max32_f32, gcu_argmin32_f32, gcu_argmax32_f32, gcu_find32_f32, gcu_count32_f32, gcu_count_range32_f32};
+  check(k, [](const GCU_Type32_Union & u) { return u.f32; }, [](GCU_Type32_Union & u, GCU_float32_t v) { u.f32 = v; }, -100.0f, 100.0f, 6);
+}
+
+TEST(Reduce16, ui16) {
+  Kernels<GCU_Type16_Union, uint16_t, uint64_t> k{gcu_sum16_ui16, gcu_min16_ui16, gcu_max16_ui16, gcu_argmin16_ui16, gcu_argmax16_ui16, gcu_find16_ui16, gcu_count16_ui16, gcu_count_range16_ui16};
+  check(k, [](const GCU_Type16_Union & u) { return u.ui16; }, [](GCU_Type16_Union & u, uint16_t v) { u.ui16 = v; }, (uint16_t)0, (uint16_t)65535, 7);
+}
+
+TEST(Reduce16, i16) {
+  Kernels<GCU_Type16_Union, int16_t, int64_t> k{gcu_sum16_i16, gcu_min16_i16, gcu_max16_i16, gcu_argmin16_i16, gcu_argmax16_i16, gcu_find16_i16, gcu_count16_i16, gcu_count_range16_i16};
+  check(k, [](const GCU_Type16_Union & u) { return u.i16; }, [](GCU_Type16_Union & u, int16_t v) { u.i16 = v; }, (int16_t)-3, (int16_t)3, 8);
+}
+
+TEST(Reduce8, ui8) {
+  Kernels<GCU_Type8_Union, uint8_t, uint64_t> k{gcu_sum8_ui8, gcu_min8_ui8, gcu_max8_ui8, gcu_argmin8_ui8, gcu_argmax8_ui8, gcu_find8_ui8, gcu_count8_ui8, gcu_count_range8_ui8};
+  check(k, [](const GCU_Type8_Union & u) { return u.ui8; }, [](GCU_Type8_Union & u, uint8_t v) { u.ui8 = v; }, (uint8_t)0, (uint8_t)255, 9);
+}
+
+TEST(Reduce8, i8) {
+  Kernels<GCU_Type8_Union, int8_t, int64_t> k{gcu_sum8_i8, gcu_min8_i8, gcu_max8_i8, gcu_argmin8_i8, gcu_argmax8_i8, gcu_find8_i8, gcu_count8_i8, gcu_count_range8_i8};
+  check(k, [](const GCU_Type8_Union & u) { return u.i8; }, [](GCU_Type8_Union & u, int8_t v) { u.i8 = v; }, (int8_t)-2, (int8_t)2, 10);
+}
+
+TEST(Reduce, CountDoesNotOverflowLanes) {
+  // Every element matches, so each 8-bit counting lane would wrap after 255
+  // blocks if it were not flushed.
+  vector<GCU_Type8_Union> data(1000000);
+  for (auto & u : data) {
+    u.ui8 = 7;
+  }
+  EXPECT_EQ(gcu_count8_ui8(data.data(), data.size(), 7), data.size());
+  EXPECT_EQ(gcu_count_range8_ui8(data.data(), data.size(), 0, 255), data.size());
+  EXPECT_EQ(gcu_sum8_ui8(data.data(), data.size()), 7 * data.size());
+}
+
+TEST(Reduce, FloatSpecialValues) {
+  vector<GCU_Type32_Union> data(1000);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i].f32 = (float)i;
+  }
+  data[500].f32 = NAN;
+  data[501].f32 = -INFINITY;
+
+  // NaNs are ignored by min and max.
+  EXPECT_EQ(gcu_min32_f32(data.data(), data.size()), -INFINITY);
+  EXPECT_EQ(gcu_max32_f32(data.data(), data.size()), 999.0f);
+  EXPECT_EQ(gcu_argmin32_f32(data.data(), data.size()), 501);
+  EXPECT_TRUE(isnan(gcu_sum32_f32(data.data(), data.size())));
+
+  // NaN never compares equal.
+  EXPECT_EQ(gcu_find32_f32(data.data(), data.size(), NAN), data.size());
+  EXPECT_EQ(gcu_count32_f32(data.data(), data.size(), NAN), 0);
+
+  // Only NaNs.
+  for (auto & u : data) {
+    u.f32 = NAN;
+  }
+  EXPECT_EQ(gcu_min32_f32(data.data(), data.size()), INFINITY);
+  EXPECT_EQ(gcu_argmin32_f32(data.data(), data.size()), data.size());
+}
+
+TEST(Reduce, Empty) {
+  EXPECT_EQ(gcu_sum64_f64(NULL, 0), 0);
+  EXPECT_EQ(gcu_min64_ui64(NULL, 0), numeric_limits<uint64_t>::max());
+  EXPECT_EQ(gcu_max16_i16(NULL, 0), numeric_limits<int16_t>::min());
+  EXPECT_EQ(gcu_argmin8_ui8(NULL, 0), 0);
+  EXPECT_EQ(gcu_find32_ui32(NULL, 0, 5), 0);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cutil/roaring.h>
+
+using namespace std;
+
+// Build a bitmap with the same values as `values`.
+static GCU_Roaring32 * fromSet(const set<uint32_t> & values) {
+  auto r = gcu_roaring32_create();
+  for (auto value : values) {
+    gcu_roaring32_add(r, value);
+  }
+  return r;
+}
+
+// Verify that the bitmap holds exactly `values`, through every accessor.
+static void expectValues(GCU_Roaring32 * r, const set<uint32_t> & values) {
+  ASSERT_EQ(gcu_roaring32_cardinality(r), values.size());
+  vector<uint32_t> found;
+  for (auto it = gcu_roaring32_iterator_get(r); it.exists; it = gcu_roaring32_iterator_next(it)) {
+    found.push_back(it.value);
+  }
+  ASSERT_EQ(found, vector<uint32_t>(values.begin(), values.end()));
+  for (auto value : values) {
+    ASSERT_TRUE(gcu_roaring32_contains(r, value)) << value;
+    ASSERT_EQ(gcu_roaring32_contains(r, value + 1), values.count(value + 1) == 1) << value + 1;
+  }
+}
+
+// Values which exercise every kind of container: sparse values spread over
+// the whole space, a dense chunk, a chunk of long runs, and the edges of the
+// space.
+static set<uint32_t> mixedValues(uint64_t seed) {
+  mt19937_64 rng{seed};
+  set<uint32_t> values{0, 65535, 65536, UINT32_MAX};
+  for (int i = 0; i < 2000; ++i) {
+    values.insert((uint32_t)rng());
+  }
+  for (int i = 0; i < 20000; ++i) {
+    values.insert(0x00050000u | (uint32_t)(rng() % 65536));
+  }
+  for (uint32_t start = 0; start < 65536; start += 1000) {
+    for (uint32_t i = 0; i < 300; ++i) {
+      values.insert(0x00070000u | (start + i + (uint32_t)(seed % 7)));
+    }
+  }
+  return values;
+}
+
+TEST(Roaring32, CreateEmpty) {
+  auto r = gcu_roaring32_create();
+  ASSERT_NE(r, nullptr);
+  ASSERT_EQ(gcu_roaring32_cardinality(r), 0);
+  ASSERT_FALSE(gcu_roaring32_contains(r, 0));
+  ASSERT_FALSE(gcu_roaring32_iterator_get(r).exists);
+  ASSERT_TRUE(gcu_roaring32_remove(r, 5));
+  gcu_roaring32_destroy(r);
+
+  GCU_Roaring32 inPlace;
+  ASSERT_TRUE(gcu_roaring32_create_in_place(&inPlace));
+  ASSERT_TRUE(gcu_roaring32_add(&inPlace, 42));
+  ASSERT_TRUE(gcu_roaring32_contains(&inPlace, 42));
+  gcu_roaring32_destroy_in_place(&inPlace);
+}
+
+TEST(Roaring32, AddContains) {
+  auto values = mixedValues(1);
+  auto r = fromSet(values);
+  expectValues(r, values);
+
+  // Adding again changes nothing.
+  for (auto value : values) {
+    ASSERT_TRUE(gcu_roaring32_add(r, value));
+  }
+  ASSERT_EQ(gcu_roaring32_cardinality(r), values.size());
+  gcu_roaring32_destroy(r);
+}
+
+TEST(Roaring32, ArrayBecomesBitmapAndBack) {
+  auto r = gcu_roaring32_create();
+  set<uint32_t> values;
+  size_t small = 0;
+  for (uint32_t i = 0; i < 10000; ++i) {
+    values.insert(i * 3);
+    gcu_roaring32_add(r, i * 3);
+    if (i == 100) {
+      small = gcu_roaring32_size_in_bytes(r);
+    }
+  }
+  expectValues(r, values);
+
+  // A bitmap takes 8 KiB, regardless of how many values it holds.
+  ASSERT_GT(gcu_roaring32_size_in_bytes(r), 8192);
+  ASSERT_LT(small, 1024);
+
+  // Removing most of the values converts the container back to an array.
+  for (uint32_t i = 0; i < 10000; ++i) {
+    if (i % 10) {
+      values.erase(i * 3);
+      ASSERT_TRUE(gcu_roaring32_remove(r, i * 3));
+    }
+  }
+  expectValues(r, values);
+
+  // Removing everything removes the containers.
+  for (auto value : values) {
+    ASSERT_TRUE(gcu_roaring32_remove(r, value));
+  }
+  ASSERT_EQ(gcu_roaring32_cardinality(r), 0);
+  ASSERT_EQ(r->keys.count, 0);
+  gcu_roaring32_destroy(r);
+}
+
+TEST(Roaring32, RunOptimize) {
+  auto r = gcu_roaring32_create();
+  set<uint32_t> values;
+  for (uint32_t i = 100000; i < 300000; ++i) {
+    values.insert(i);
+    gcu_roaring32_add(r, i);
+  }
+  values.insert(7);
+  gcu_roaring32_add(r, 7);
+
+  size_t before = gcu_roaring32_size_in_bytes(r);
+  ASSERT_TRUE(gcu_roaring32_run_optimize(r));
+  ASSERT_LT(gcu_roaring32_size_in_bytes(r), before / 10);
+  expectValues(r, values);
+
+  // Modifying a container of runs still works.
+  for (uint32_t value : {99999u, 150000u, 150001u, 300000u, 8u}) {
+    values.insert(value);
+    gcu_roaring32_add(r, value);
+  }
+  values.erase(200000);
+  gcu_roaring32_remove(r, 200000);
+  expectValues(r, values);
+  gcu_roaring32_destroy(r);
+}
+
+TEST(Roaring32, SetOperations) {
+  for (bool optimize : {false, true}) {
+    auto x = mixedValues(2);
+    auto y = mixedValues(3);
+    // Share some of the sparse values, so that arrays intersect.
+    int shared = 0;
+    for (auto value : x) {
+      if (shared++ % 3 == 0) {
+        y.insert(value);
+      }
+    }
+
+    set<uint32_t> both;
+    set_intersection(x.begin(), x.end(), y.begin(), y.end(), inserter(both, both.begin()));
+    set<uint32_t> either = x;
+    either.insert(y.begin(), y.end());
+
+    auto a = fromSet(x);
+    auto b = fromSet(y);
+    if (optimize) {
+      gcu_roaring32_run_optimize(a);
+      gcu_roaring32_run_optimize(b);
+    }
+    auto c = fromSet(x);
+    if (optimize) {
+      gcu_roaring32_run_optimize(c);
+    }
+
+    ASSERT_TRUE(gcu_roaring32_and(a, b));
+    expectValues(a, both);
+    expectValues(b, y);
+    ASSERT_TRUE(gcu_roaring32_or(c, b));
+    expectValues(c, either);
+    expectValues(b, y);
+
+    // With an empty bitmap, and with itself.
+    auto empty = gcu_roaring32_create();
+    ASSERT_TRUE(gcu_roaring32_or(c, empty));
+    expectValues(c, either);
+    ASSERT_TRUE(gcu_roaring32_or(empty, b));
+    expectValues(empty, y);
+    ASSERT_TRUE(gcu_roaring32_and(c, c));
+    expectValues(c, either);
+
+    gcu_roaring32_destroy(a);
+    gcu_roaring32_destroy(b);
+    gcu_roaring32_destroy(c);
+    gcu_roaring32_destroy(empty);
+  }
+}
+
+TEST(Roaring32, IntersectArrays) {
+  // Arrays long enough to use the blocked kernel, with matches scattered
+  // across block boundaries.
+  mt19937_64 rng{4};
+  for (int round = 0; round < 50; ++round) {
+    set<uint32_t> x;
+    set<uint32_t> y;
+    size_t nx = rng() % 4000;
+    size_t ny = rng() % 4000;
+    for (size_t i = 0; i < nx; ++i) {
+      x.insert(0x00010000u | (uint32_t)(rng() % 20000));
+    }
+    for (size_t i = 0; i < ny; ++i) {
+      y.insert(0x00010000u | (uint32_t)(rng() % 20000));
+    }
+    set<uint32_t> both;
+    set_intersection(x.begin(), x.end(), y.begin(), y.end(), inserter(both, both.begin()));
+    auto a = fromSet(x);
+    auto b = fromSet(y);
+    ASSERT_TRUE(gcu_roaring32_and(a, b));
+    expectValues(a, both);
+    gcu_roaring32_destroy(a);
+    gcu_roaring32_destroy(b);
+  }
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
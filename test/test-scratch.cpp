@@ -0,0 +1,204 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <gtest/gtest.h>
+#include <cutil/arena.h>
+#include <cutil/memory.h>
+#include <cutil/scratch.h>
+#include <cutil/thread.h>
+
+using namespace std;
+
+TEST(Scratch, MarkAndRewind) {
+  auto outer = gcu_scratch_mark();
+  auto a = (char *)gcu_scratch_allocate(100);
+  ASSERT_NE(a, nullptr);
+  ASSERT_EQ((uintptr_t)a % GCU_ARENA_ALIGNMENT, 0);
+  memset(a, 1, 100);
+  ASSERT_EQ(gcu_scratch_in_use(), 100);
+
+  // Buffers taken after an inner mark are given back first, and their room
+  // is used again.
+  auto inner = gcu_scratch_mark();
+  auto b = (char *)gcu_scratch_allocate(200);
+  memset(b, 2, 200);
+  ASSERT_EQ(gcu_scratch_in_use(), 300);
+  gcu_scratch_rewind(inner);
+  ASSERT_EQ(gcu_scratch_in_use(), 100);
+  ASSERT_EQ(gcu_scratch_allocate(200), b);
+  ASSERT_EQ(a[99], 1);
+
+  gcu_scratch_rewind(outer);
+  ASSERT_EQ(gcu_scratch_in_use(), 0);
+  ASSERT_GE(gcu_scratch_high_water(), 300);
+}
+
+TEST(Scratch, ReusesChunks) {
+  gcu_scratch_release();
+  gcu_memory_reset_counts();
+  for (int round = 0; round < 10; ++round) {
+    auto mark = gcu_scratch_mark();
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_NE(gcu_scratch_allocate(GCU_SCRATCH_LARGEST_SIZE), nullptr);
+    }
+    gcu_scratch_rewind(mark);
+  }
+
+  // Only the first round took memory from the heap.
+  ASSERT_LE(gcu_get_alloc_count(), 100 * GCU_SCRATCH_LARGEST_SIZE / GCU_SCRATCH_CHUNK_SIZE + 2);
+  ASSERT_GE(gcu_scratch_high_water(), 100 * GCU_SCRATCH_LARGEST_SIZE);
+  gcu_scratch_release();
+  ASSERT_EQ(gcu_get_alloc_count(), gcu_get_free_count());
+}
+
+TEST(Scratch, Oversized) {
+  gcu_memory_reset_counts();
+  auto mark = gcu_scratch_mark();
+  auto small = (char *)gcu_scratch_allocate(10);
+  size_t allocations = gcu_get_alloc_count();
+
+  // Large buffers come from the heap, and are freed by the rewind.
+  auto large = (char *)gcu_scratch_allocate(GCU_SCRATCH_LARGEST_SIZE + 1);
+  ASSERT_NE(large, nullptr);
+  ASSERT_EQ((uintptr_t)large % GCU_ARENA_ALIGNMENT, 0);
+  memset(large, 3, GCU_SCRATCH_LARGEST_SIZE + 1);
+  auto inner = gcu_scratch_mark();
+  gcu_scratch_allocate(10 * GCU_SCRATCH_LARGEST_SIZE);
+  gcu_scratch_allocate(10 * GCU_SCRATCH_LARGEST_SIZE);
+  ASSERT_EQ(gcu_get_alloc_count(), allocations + 3);
+  gcu_scratch_rewind(inner);
+  ASSERT_EQ(gcu_get_free_count(), 2);
+  ASSERT_EQ(large[GCU_SCRATCH_LARGEST_SIZE], 3);
+  ASSERT_EQ(gcu_scratch_in_use(), 10 + GCU_SCRATCH_LARGEST_SIZE + 1);
+  gcu_scratch_rewind(mark);
+  ASSERT_EQ(gcu_get_free_count(), 3);
+  ASSERT_NE(small, nullptr);
+  gcu_scratch_release();
+  ASSERT_EQ(gcu_get_alloc_count(), gcu_get_free_count());
+
+  // The region is created again when needed.
+  ASSERT_NE(gcu_scratch_allocate(10), nullptr);
+  gcu_scratch_release();
+}
+
+// The blocks allocated by the worker threads below, and not yet freed.
+// Only the threads' own allocations are tracked, so that what the thread
+// library keeps does not count.
+static mutex trackedLock;
+static set<void *> tracked;
+static thread_local bool tracking = false;
+static thread_local size_t trackedHere = 0;
+
+static void * trackAllocate(void *, size_t size) {
+  void * pointer = malloc(size);
+  if (pointer && tracking) {
+    lock_guard<mutex> guard(trackedLock);
+    tracked.insert(pointer);
+    ++trackedHere;
+  }
+  return pointer;
+}
+
+static void * trackAllocateZeroed(void *, size_t nitems, size_t size) {
+  void * pointer = calloc(nitems, size);
+  if (pointer && tracking) {
+    lock_guard<mutex> guard(trackedLock);
+    tracked.insert(pointer);
+    ++trackedHere;
+  }
+  return pointer;
+}
+
+static void * trackReallocate(void *, void * pointer, size_t size) {
+  void * result = realloc(pointer, size);
+  if (result) {
+    lock_guard<mutex> guard(trackedLock);
+    if (tracked.erase(pointer)) {
+      tracked.insert(result);
+    }
+  }
+  return result;
+}
+
+static void trackFree(void *, void * pointer) {
+  {
+    lock_guard<mutex> guard(trackedLock);
+    tracked.erase(pointer);
+  }
+  free(pointer);
+}
+
+static size_t trackUsableSize(void *, void * pointer) {
+  return gcu_memory_usable_size(pointer);
+}
+
+static const GCU_Allocator TRACKING = {trackAllocate, trackAllocateZeroed, trackReallocate, trackFree, trackUsableSize, nullptr};
+
+// What a worker thread saw of its own scratch region.
+struct Seen {
+  size_t inUse;
+  size_t highWater;
+  size_t blocks;                // Blocks allocated by the thread.
+};
+
+// Uses the scratch stack of its own thread, leaving a buffer in use.
+static GCU_THREAD_FUNC_RETURN_T GCU_THREAD_FUNC_CALLING_CONVENTION work(GCU_THREAD_FUNC_ARG_T arg) {
+  auto seen = (Seen *)arg;
+  tracking = true;
+  auto mark = gcu_scratch_mark();
+  gcu_scratch_allocate(1000);
+  gcu_scratch_rewind(mark);
+  gcu_scratch_allocate(GCU_SCRATCH_LARGEST_SIZE + 1);
+  seen->inUse = gcu_scratch_in_use();
+  seen->highWater = gcu_scratch_high_water();
+  seen->blocks = trackedHere;
+  tracking = false;
+  return 0;
+}
+
+// Run four threads, each with its own region.
+static bool runThreads(Seen * seen) {
+  GCU_Thread threads[4];
+  for (size_t i = 0; i < 4; ++i) {
+    if (gcu_thread_create(&threads[i], work, &seen[i])) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < 4; ++i) {
+    gcu_thread_join(threads[i]);
+  }
+  return true;
+}
+
+TEST(Scratch, Threads) {
+  Seen seen[4];
+  auto previous = gcu_set_allocator(&TRACKING);
+  bool warmedUp = runThreads(seen);
+  {
+    lock_guard<mutex> guard(trackedLock);
+    tracked.clear();
+  }
+  bool ran = runThreads(seen);
+  gcu_set_allocator(previous);
+  ASSERT_TRUE(warmedUp);
+  ASSERT_TRUE(ran);
+
+  // Each thread has its own region and statistics.
+  for (auto & s : seen) {
+    ASSERT_EQ(s.inUse, GCU_SCRATCH_LARGEST_SIZE + 1);
+    ASSERT_EQ(s.highWater, GCU_SCRATCH_LARGEST_SIZE + 1);
+    ASSERT_GE(s.blocks, 3);
+  }
+  ASSERT_EQ(gcu_scratch_in_use(), 0);
+
+  // The region of each thread, along with the buffer left in use, is freed
+  // when it exits.
+  ASSERT_TRUE(tracked.empty());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cutil/sort.h>
+
+using namespace std;
+
+// Sizes which exercise the insertion sort, the quicksort, and the radix sort.
+static const size_t sizes[] = {0, 1, 2, 3, 16, 17, 100, 255, 256, 1000, 100000};
+
+// Fill `values` with `count` random values of type T.
+template <typename T>
+static vector<T> randomValues(size_t count, mt19937_64 & rng) {
+  vector<T> values(count);
+  for (auto & value : values) {
+    if constexpr (is_floating_point_v<T>) {
+      value = (T)uniform_real_distribution<double>{-1e6, 1e6}(rng);
+    }
+    else {
+      value = (T)rng();
+    }
+  }
+  return values;
+}
+
+TEST(Sort64, ui64) {
+  mt19937_64 rng{1};
+  for (auto size : sizes) {
+    auto values = randomValues<uint64_t>(size, rng);
+    auto v = gcu_vector64_create(size);
+    for (auto value : values) {
+      ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(value)));
+    }
+    ASSERT_TRUE(gcu_vector64_sort_ui64(v));
+    sort(values.begin(), values.end());
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(v->data[i].ui64, values[i]);
+    }
+    gcu_vector64_destroy(v);
+  }
+}
+
+TEST(Sort64, i64) {
+  mt19937_64 rng{2};
+  for (auto size : sizes) {
+    auto values = randomValues<int64_t>(size, rng);
+    auto v = gcu_vector64_create(size);
+    for (auto value : values) {
+      ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_i64(value)));
+    }
+    ASSERT_TRUE(gcu_vector64_sort_i64(v));
+    sort(values.begin(), values.end());
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(v->data[i].i64, values[i]);
+    }
+    gcu_vector64_destroy(v);
+  }
+}
+
+TEST(Sort64, f64) {
+  mt19937_64 rng{3};
+  for (auto size : sizes) {
+    auto values = randomValues<double>(size, rng);
+    if (size > 8) {
+      values[0] = -0.0;
+      values[1] = 0.0;
+      values[2] = numeric_limits<double>::infinity();
+      values[3] = -numeric_limits<double>::infinity();
+      values[4] = numeric_limits<double>::lowest();
+      values[5] = numeric_limits<double>::denorm_min();
+    }
+    vector<GCU_Type64_Union> data;
+    for (auto value : values) {
+      GCU_Type64_Union u;
+      u.f64 = value;
+      data.push_back(u);
+    }
+    ASSERT_TRUE(gcu_sort64_f64(data.data(), data.size()));
+    sort(values.begin(), values.end());
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(data[i].f64, values[i]);
+    }
+  }
+}
+
+TEST(Sort64, SortedAndReversed) {
+  // Already-sorted and reverse-sorted input must not degrade the quicksort.
+  for (size_t size : {200, 5000}) {
+    vector<GCU_Type64_Union> data(size);
+    for (size_t i = 0; i < size; ++i) {
+      data[i].i64 = (int64_t)(size - i) - 100;
+    }
+    ASSERT_TRUE(gcu_sort64_i64(data.data(), size));
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(data[i].i64, (int64_t)i - 99);
+    }
+    ASSERT_TRUE(gcu_sort64_i64(data.data(), size));
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(data[i].i64, (int64_t)i - 99);
+    }
+  }
+}
+
+TEST(Sort32, ui32) {
+  mt19937_64 rng{4};
+  for (auto size : sizes) {
+    auto values = randomValues<uint32_t>(size, rng);
+    auto v = gcu_vector32_create(size);
+    for (auto value : values) {
+      ASSERT_TRUE(gcu_vector32_append(v, gcu_type32_ui32(value)));
+    }
+    ASSERT_TRUE(gcu_vector32_sort_ui32(v));
+    sort(values.begin(), values.end());
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(v->data[i].ui32, values[i]);
+    }
+    gcu_vector32_destroy(v);
+  }
+}
+
+TEST(Sort32, i32) {
+  mt19937_64 rng{5};
+  for (auto size : sizes) {
+    auto values = randomValues<int32_t>(size, rng);
+    auto v = gcu_vector32_create(size);
+    for (auto value : values) {
+      ASSERT_TRUE(gcu_vector32_append(v, gcu_type32_i32(value)));
+    }
+    ASSERT_TRUE(gcu_vector32_sort_i32(v));
+    sort(values.begin(), values.end());
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(v->data[i].i32, values[i]);
+    }
+    gcu_vector32_destroy(v);
+  }
+}
+
+TEST(Sort32, f32) {
+  mt19937_64 rng{6};
+  for (auto size : sizes) {
+    auto values = randomValues<float>(size, rng);
+    if (size > 4) {
+      values[0] = -0.0f;
+      values[1] = numeric_limits<float>::infinity();
+      values[2] = -numeric_limits<float>::infinity();
+    }
+    vector<GCU_Type32_Union> data;
+    for (auto value : values) {
+      GCU_Type32_Union u;
+      u.f32 = value;
+      data.push_back(u);
+    }
+    ASSERT_TRUE(gcu_sort32_f32(data.data(), data.size()));
+    sort(values.begin(), values.end());
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(data[i].f32, values[i]);
+    }
+  }
+}
+
+TEST(Sort16, ui16) {
+  mt19937_64 rng{7};
+  for (auto size : sizes) {
+    auto values = randomValues<uint16_t>(size, rng);
+    auto v = gcu_vector16_create(size);
+    for (auto value : values) {
+      ASSERT_TRUE(gcu_vector16_append(v, gcu_type16_ui16(value)));
+    }
+    ASSERT_TRUE(gcu_vector16_sort_ui16(v));
+    sort(values.begin(), values.end());
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(v->data[i].ui16, values[i]);
+    }
+    gcu_vector16_destroy(v);
+  }
+}
+
+TEST(Sort16, i16) {
+  mt19937_64 rng{8};
+  for (auto size : sizes) {
+    auto values = randomValues<int16_t>(size, rng);
+    auto v = gcu_vector16_create(size);
+    for (auto value : values) {
+      ASSERT_TRUE(gcu_vector16_append(v, gcu_type16_i16(value)));
+    }
+    ASSERT_TRUE(gcu_vector16_sort_i16(v));
+    sort(values.begin(), values.end());
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(v->data[i].i16, values[i]);
+    }
+    gcu_vector16_destroy(v);
+  }
+}
+
+TEST(Sort8, ui8) {
+  mt19937_64 rng{9};
+  for (auto size : sizes) {
+    auto values = randomValues<uint8_t>(size, rng);
+    auto v = gcu_vector8_create(size);
+    for (auto value : values) {
+      ASSERT_TRUE(gcu_vector8_append(v, gcu_type8_ui8(value)));
+    }
+    ASSERT_TRUE(gcu_vector8_sort_ui8(v));
+    sort(values.begin(), values.end());
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(v->data[i].ui8, values[i]);
+    }
+    gcu_vector8_destroy(v);
+  }
+}
+
+TEST(Sort8, i8) {
+  mt19937_64 rng{10};
+  for (auto size : sizes) {
+    auto values = randomValues<int8_t>(size, rng);
+    auto v = gcu_vector8_create(size);
+    for (auto value : values) {
+      ASSERT_TRUE(gcu_vector8_append(v, gcu_type8_i8(value)));
+    }
+    ASSERT_TRUE(gcu_vector8_sort_i8(v));
+    sort(values.begin(), values.end());
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(v->data[i].i8, values[i]);
+    }
+    gcu_vector8_destroy(v);
+  }
+}
+
+TEST(Sort64, View) {
+  // Sort the middle of a vector in place, leaving the ends alone.
+  mt19937_64 rng{11};
+  auto values = randomValues<uint64_t>(300000, rng);
+  auto v = gcu_vector64_create(values.size());
+  for (auto value : values) {
+    ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(value)));
+  }
+  auto view = gcu_vector64_view(v, 1000, 100000);
+  ASSERT_TRUE(gcu_view64_sort_ui64(view));
+  sort(values.begin() + 1000, values.begin() + 101000);
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(v->data[i].ui64, values[i]);
+  }
+
+  // The parallel sort takes a view too.
+  view = gcu_vector64_view(v, 150000, 100000);
+  ASSERT_TRUE(gcu_view64_par_sort_ui64(nullptr, view));
+  sort(values.begin() + 150000, values.begin() + 250000);
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(v->data[i].ui64, values[i]);
+  }
+  gcu_vector64_destroy(v);
+}
+
+TEST(Sort64, LowerBound) {
+  mt19937_64 rng{12};
+  for (auto size : sizes) {
+    vector<GCU_Type64_Union> data;
+    vector<int64_t> values;
+    for (size_t i = 0; i < size; ++i) {
+      values.push_back((int64_t)(rng() % 200) - 100);
+      data.push_back(gcu_type64_i64(values.back()));
+    }
+    auto view = gcu_view64_of(data.data(), data.size());
+    ASSERT_TRUE(gcu_view64_sort_i64(view));
+    sort(values.begin(), values.end());
+    for (int64_t value = -102; value <= 102; ++value) {
+      ASSERT_EQ(gcu_view64_lower_bound_i64(view, value), (size_t)(lower_bound(values.begin(), values.end(), value) - values.begin())) << "size " << size << ", value " << value;
+    }
+  }
+}
+
+TEST(Sort32, LowerBound) {
+  mt19937_64 rng{13};
+  auto values = randomValues<float>(1000, rng);
+  vector<GCU_Type32_Union> data;
+  for (auto value : values) {
+    data.push_back(gcu_type32_f32(value));
+  }
+  auto view = gcu_view32_of(data.data(), data.size());
+  ASSERT_TRUE(gcu_view32_sort_f32(view));
+  sort(values.begin(), values.end());
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(gcu_view32_lower_bound_f32(view, values[i]), (size_t)(lower_bound(values.begin(), values.end(), values[i]) - values.begin()));
+  }
+  ASSERT_EQ(gcu_view32_lower_bound_f32(view, -1e7f), 0);
+  ASSERT_EQ(gcu_view32_lower_bound_f32(view, 1e7f), values.size());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,6 @@
 #include <sstream>
 #include <gtest/gtest.h>
+#include <cutil/memory.h>
 #include <cutil/vector.h>
 #include <stdio.h>
 
@@ -70,6 +71,44 @@ TEST(Vector64, InPlace64) {
   gcu_vector64_destroy_in_place(&v);
 }
 
+TEST(Vector64, Embedded) {
+  gcu_memory_reset_counts();
+  auto v = gcu_vector64_create_embedded(4);
+  ASSERT_NE(v, nullptr);
+  ASSERT_EQ(gcu_get_alloc_count(), 1);
+  ASSERT_TRUE(v->embedded);
+  ASSERT_EQ((void *)v->data, (void *)(v + 1));
+  ASSERT_EQ(v->capacity, 4);
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(i)));
+  }
+  ASSERT_EQ(gcu_get_alloc_count(), 1);
+
+  // Outgrowing the room moves the data to a block of its own.
+  ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(4)));
+  ASSERT_FALSE(v->embedded);
+  ASSERT_EQ(gcu_get_alloc_count(), 2);
+  for (size_t i = 0; i < 5; ++i) {
+    ASSERT_EQ(v->data[i].ui64, i);
+  }
+  gcu_vector64_destroy(v);
+  ASSERT_EQ(gcu_get_free_count(), 2);
+
+  // Embedded data moves out only for a policy with an alignment.
+  v = gcu_vector64_create_embedded(4);
+  ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(42)));
+  GCU_Growth growth = {2, 0, 0, 0, nullptr, 0, nullptr};
+  ASSERT_TRUE(gcu_vector64_set_growth(v, growth));
+  ASSERT_TRUE(v->embedded);
+  growth.alignment = 64;
+  ASSERT_TRUE(gcu_vector64_set_growth(v, growth));
+  ASSERT_FALSE(v->embedded);
+  ASSERT_EQ((uintptr_t)v->data % 64, 0);
+  ASSERT_EQ(v->data[0].ui64, 42);
+  gcu_vector64_destroy(v);
+  ASSERT_EQ(gcu_get_alloc_count(), gcu_get_free_count());
+}
+
 TEST(Vector32, CreateEmpty) {
   auto v = gcu_vector32_create(0);
   ASSERT_EQ(gcu_vector32_count(v), 0);
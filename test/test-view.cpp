@@ -0,0 +1,118 @@
+#include <numeric>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cutil/reduce.h>
+#include <cutil/view.h>
+
+using namespace std;
+
+TEST(View64, OfVector) {
+  auto v = gcu_vector64_create(0);
+  for (uint64_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(i)));
+  }
+
+  // A view shares the memory of the vector.
+  auto view = gcu_vector64_view(v, 10, 20);
+  ASSERT_EQ(view.data, v->data + 10);
+  ASSERT_EQ(view.count, 20);
+  view.data[0].ui64 = 1000;
+  ASSERT_EQ(v->data[10].ui64, 1000);
+
+  // Ranges are clipped to the vector.
+  ASSERT_EQ(gcu_vector64_view(v, 0, SIZE_MAX).count, 100);
+  ASSERT_EQ(gcu_vector64_view(v, 90, 20).count, 10);
+  ASSERT_EQ(gcu_vector64_view(v, 100, 1).count, 0);
+  ASSERT_EQ(gcu_vector64_view(v, 500, 1).count, 0);
+  ASSERT_EQ(gcu_vector64_view(nullptr, 0, 1).count, 0);
+
+  // The reductions take a view through GCU_VIEW_ARGS().
+  ASSERT_EQ(gcu_sum64_ui64(GCU_VIEW_ARGS(gcu_vector64_view(v, 20, 5))), 20 + 21 + 22 + 23 + 24);
+  gcu_vector64_destroy(v);
+}
+
+TEST(View64, Slice) {
+  vector<GCU_Type64_Union> data;
+  for (uint64_t i = 0; i < 50; ++i) {
+    data.push_back(gcu_type64_ui64(i));
+  }
+  auto view = gcu_view64_of(data.data(), data.size());
+  auto slice = gcu_view64_slice(view, 5, 10);
+  ASSERT_EQ(slice.data[0].ui64, 5);
+  ASSERT_EQ(slice.count, 10);
+  auto inner = gcu_view64_slice(slice, 8, 10);
+  ASSERT_EQ(inner.data[0].ui64, 13);
+  ASSERT_EQ(inner.count, 2);
+  ASSERT_EQ(gcu_view64_slice(slice, 10, 1).count, 0);
+  ASSERT_EQ(gcu_view64_of(nullptr, 10).count, 0);
+}
+
+TEST(View64, Split) {
+  vector<GCU_Type64_Union> data(103);
+  auto view = gcu_view64_of(data.data(), data.size());
+
+  // Every part is consecutive, the sizes differ by at most one, and together
+  // the parts cover the view.
+  for (size_t parts : {1, 2, 7, 103, 200}) {
+    size_t total = 0;
+    auto next = data.data();
+    for (size_t i = 0; i < parts; ++i) {
+      auto part = gcu_view64_split(view, parts, i);
+      ASSERT_EQ(part.data, next);
+      ASSERT_GE(part.count, data.size() / parts);
+      ASSERT_LE(part.count, data.size() / parts + 1);
+      next += part.count;
+      total += part.count;
+    }
+    ASSERT_EQ(total, data.size());
+    ASSERT_EQ(gcu_view64_split(view, parts, parts).count, 0);
+  }
+  ASSERT_EQ(gcu_view64_split(view, 0, 0).count, 0);
+}
+
+TEST(View64, HashAndCopy) {
+  vector<GCU_Type64_Union> data;
+  for (uint64_t i = 0; i < 64; ++i) {
+    data.push_back(gcu_type64_ui64(i % 16));
+  }
+  auto view = gcu_view64_of(data.data(), data.size());
+
+  // Equal contents hash equally, wherever they are.
+  ASSERT_EQ(gcu_view64_hash(gcu_view64_slice(view, 0, 16)), gcu_view64_hash(gcu_view64_slice(view, 32, 16)));
+  ASSERT_NE(gcu_view64_hash(gcu_view64_slice(view, 0, 16)), gcu_view64_hash(gcu_view64_slice(view, 1, 16)));
+
+  // Copying appends to the vector.
+  auto v = gcu_vector64_create(0);
+  ASSERT_TRUE(gcu_vector64_append(v, gcu_type64_ui64(99)));
+  ASSERT_TRUE(gcu_view64_copy(gcu_view64_slice(view, 3, 20), v));
+  ASSERT_TRUE(gcu_view64_copy(gcu_view64_slice(view, 0, 0), v));
+  ASSERT_EQ(v->count, 21);
+  ASSERT_EQ(v->data[0].ui64, 99);
+  for (size_t i = 0; i < 20; ++i) {
+    ASSERT_EQ(v->data[i + 1].ui64, (i + 3) % 16);
+  }
+  ASSERT_EQ(gcu_view64_hash(gcu_vector64_view(v, 1, 20)), gcu_view64_hash(gcu_view64_slice(view, 3, 20)));
+  ASSERT_FALSE(gcu_view64_copy(view, nullptr));
+  gcu_vector64_destroy(v);
+}
+
+TEST(View8, Widths) {
+  auto v = gcu_vector8_create(0);
+  for (uint8_t i = 0; i < 200; ++i) {
+    ASSERT_TRUE(gcu_vector8_append(v, gcu_type8_ui8(i)));
+  }
+  auto part = gcu_view8_split(gcu_vector8_view(v, 0, SIZE_MAX), 3, 2);
+  ASSERT_EQ(part.count, 66);
+  ASSERT_EQ(part.data[0].ui8, 134);
+
+  auto copy = gcu_vector8_create(0);
+  ASSERT_TRUE(gcu_view8_copy(part, copy));
+  ASSERT_EQ(gcu_view8_hash(gcu_vector8_view(copy, 0, SIZE_MAX)), gcu_view8_hash(part));
+  gcu_vector8_destroy(copy);
+  gcu_vector8_destroy(v);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,34 @@
+/**
+ * @file
+ *
+ * Decode a memory trace written by gcu_mem_trace_start(), or report the peak
+ * memory use and the leaks that it records.
+ *
+ * Usage: memtrace [--report] <trace file>
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <cutil/memory.h>
+
+int main(int argc, char ** argv) {
+  bool report = argc == 3 && !strcmp(argv[1], "--report");
+  if (argc != 2 && !report) {
+    fprintf(stderr, "Usage: %s [--report] <trace file>\n", argv[0]);
+    return 2;
+  }
+  FILE * trace = fopen(argv[argc - 1], "rb");
+  if (!trace) {
+    fprintf(stderr, "Cannot open %s\n", argv[argc - 1]);
+    return 1;
+  }
+  bool success = report
+    ? gcu_mem_trace_report(trace, stdout)
+    : gcu_mem_trace_decode(trace, stdout);
+  fclose(trace);
+  if (!success) {
+    fprintf(stderr, "%s is not a valid memory trace\n", argv[argc - 1]);
+    return 1;
+  }
+  return 0;
+}